@@ -0,0 +1,354 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : edma_graph_test.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					edma_graph 在PC上的单元测试. 一块1MB数组模拟 0x20000000 起的SRAM,
+					一个模拟的SPI数据寄存器记录发出的数据、按固定序列返回收到的数据.
+					每条链构建后用 EDG_Simulate 执行, 同时在影子内存上用 memcpy
+					做同样的操作, 最后整块比较, 多写、少写、写错位置都能发现:
+					  1. 内存<->外设: 字节/半字/字宽度, 超过65535个数据自动拆成多个描述符;
+					  2. 汇集: 各种对齐的多段拼到一起, 以及多段依次送给外设;
+					  3. 2D子矩形: RGB565帧缓冲之间拷贝, 空链用2D模式, 超长或
+					     一维链上按行拆开;
+					  4. 构建时拒绝: 地址/长度不对齐、宽度非法、长度为0、外设请求不同、
+					     2D参数不同、2D块超过65535个数据、描述符不够; 出错的链不能执行;
+					  5. 改坏的描述符(个数超过65535、链表成环)被 EDG_Simulate 发现.
+					在本目录下编译运行:
+					  gcc -O2 -Wall -I../User/BSP edma_graph_test.c ../User/BSP/edma_graph.c -o edma_graph_test
+					  ./edma_graph_test
+					全部通过返回0, 否则打印失败的检查并返回1.
+  * Function List:
+  *		main
+  **********************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "edma_graph.h"
+
+#define BUS_BASE            0x20000000u
+#define BUS_SIZE            (1024 * 1024)
+#define SPI_DT              0x4001300Cu		//模拟的外设数据寄存器, 不在SRAM中
+#define SPI_REQ             10
+#define UART_REQ            11
+
+#define DESC_MAX            512
+#define TX_MAX              (512 * 1024)
+
+//帧缓冲 RGB565 320x240
+#define FB_W                320
+#define FB_H                240
+#define FB_PITCH            (FB_W * 2)
+
+#define A(off)              (BUS_BASE + (uint32_t)(off))
+
+static uint8_t ram[BUS_SIZE];       //EDG_Simulate 通过总线访问的SRAM
+static uint8_t shadow[BUS_SIZE];    //memcpy 得到的期望结果
+static uint8_t tx[TX_MAX];
+static uint32_t tx_len, rx_pos;
+static uint8_t periph_width;        //本次期望的外设宽度
+static EDG_Desc desc[DESC_MAX];
+static int failed;
+
+#define CHECK(c)    do { if(!(c)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #c); failed = 1; } } while(0)
+
+static uint32_t rnd_state = 12345;
+
+static uint32_t rnd(void) {
+    rnd_state ^= rnd_state << 13;
+    rnd_state ^= rnd_state >> 17;
+    rnd_state ^= rnd_state << 5;
+    return rnd_state;
+}
+
+//外设收到的第 k 个字节
+static uint8_t rx_byte(uint32_t k) {
+    return (uint8_t)(k * 7 + 3);
+}
+
+static uint8_t *bus_map(uint32_t addr, uint32_t len) {
+    if((addr < BUS_BASE) || (addr - BUS_BASE > BUS_SIZE) || (len > BUS_SIZE - (addr - BUS_BASE))) return NULL;
+
+    return &ram[addr - BUS_BASE];
+}
+
+static uint32_t bus_read(uint32_t addr, uint8_t width) {
+    uint32_t data = 0, i;
+
+    CHECK(addr == SPI_DT);
+    CHECK(width == periph_width);
+
+    for(i = 0; i < (1u << width); i++) data |= (uint32_t)rx_byte(rx_pos++) << (8 * i);
+
+    return data;
+}
+
+static void bus_write(uint32_t addr, uint32_t data, uint8_t width) {
+    uint32_t i;
+
+    CHECK(addr == SPI_DT);
+    CHECK(width == periph_width);
+
+    for(i = 0; i < (1u << width) && tx_len < TX_MAX; i++) tx[tx_len++] = (uint8_t)(data >> (8 * i));
+}
+
+static const EDG_HostBus bus = { bus_map, bus_read, bus_write };
+
+//两块内存内容相同, 同时清空外设记录
+static void reset_bus(void) {
+    uint32_t i;
+
+    for(i = 0; i < BUS_SIZE; i++) ram[i] = (uint8_t)rnd();
+
+    memcpy(shadow, ram, BUS_SIZE);
+    tx_len = 0;
+    rx_pos = 0;
+}
+
+//执行一条链, 检查搬运的字节数和链上每个描述符的个数
+static void run_chain(const EDG_Chain *chain) {
+    uint32_t bytes = 0;
+    uint16_t i;
+
+    CHECK(chain->Error == EDG_OK);
+
+    for(i = 0; i < chain->Num; i++) CHECK(chain->Desc[i].Count > 0 && chain->Desc[i].Count <= EDG_COUNT_MAX);
+
+    CHECK(EDG_Simulate(chain, &bus, &bytes) == EDG_OK);
+    CHECK(bytes == chain->Bytes);
+    CHECK(memcmp(ram, shadow, BUS_SIZE) == 0);
+}
+
+static void test_periph(void) {
+    static const uint8_t widths[] = { EDG_WIDTH_BYTE, EDG_WIDTH_HALFWORD, EDG_WIDTH_WORD };
+    EDG_Chain chain;
+    uint32_t w, k, src, dst, len, n;
+
+    for(w = 0; w < 3; w++) {
+        reset_bus();
+        periph_width = widths[w];
+        EDG_Init(&chain, desc, DESC_MAX);
+
+        //70000个数据, 超过 EDG_COUNT_MAX 要拆成两个描述符
+        src = 0x1000;
+        len = 70000u << widths[w];
+        dst = 0x60000;
+        CHECK(EDG_AddToPeriph(&chain, SPI_DT, SPI_REQ, A(src), len, widths[w]) == EDG_OK);
+        CHECK(EDG_AddFromPeriph(&chain, SPI_DT, SPI_REQ, A(dst), 4096, widths[w]) == EDG_OK);
+        CHECK(chain.Num == 3);
+        CHECK(chain.Desc[0].Count == EDG_COUNT_MAX && chain.Desc[1].Count == 70000 - EDG_COUNT_MAX);
+
+        for(k = 0; k < 4096; k++) shadow[dst + k] = rx_byte(k);
+
+        run_chain(&chain);
+        CHECK(tx_len == len);
+        CHECK(memcmp(tx, &ram[src], len) == 0);
+        CHECK(rx_pos == 4096);
+
+        //只有最后一个描述符打开完成中断
+        for(n = 0; n < chain.Num; n++) CHECK(((chain.Desc[n].Ctrl & EDG_CTRL_FDTIEN) != 0) == (n == chain.Num - 1u));
+    }
+}
+
+static void test_gather(void) {
+    //长度和地址对4取余各不相同, 覆盖字节头/字主体/字节尾和只能按字节/半字搬运的情况
+    static const EDG_Vec vec_off[] = {
+        { 0x20001, 1 }, { 0x20103, 3 }, { 0x20200, 100 }, { 0x21002, 4097 }, { 0x23005, 70000 }, { 0x40000, 8 }
+    };
+    static const EDG_Vec tx_off[] = { { 0x50000, 64 }, { 0x50402, 2 }, { 0x50806, 300 } };
+    EDG_Vec vec[6];
+    EDG_Chain chain;
+    uint32_t dst, pos, i;
+
+    for(dst = 0x80000; dst < 0x80004; dst++) {
+        reset_bus();
+        EDG_Init(&chain, desc, DESC_MAX);
+
+        for(i = 0; i < 6; i++) {
+            vec[i].Addr = A(vec_off[i].Addr);
+            vec[i].Len = vec_off[i].Len;
+        }
+
+        CHECK(EDG_AddGather(&chain, A(dst), vec, 6) == EDG_OK);
+
+        for(i = 0, pos = dst; i < 6; i++) {
+            memcpy(&shadow[pos], &shadow[vec_off[i].Addr], vec_off[i].Len);
+            pos += vec_off[i].Len;
+        }
+
+        run_chain(&chain);
+    }
+
+    //多段依次送给外设, 半字宽度
+    reset_bus();
+    periph_width = EDG_WIDTH_HALFWORD;
+    EDG_Init(&chain, desc, DESC_MAX);
+
+    for(i = 0; i < 3; i++) {
+        vec[i].Addr = A(tx_off[i].Addr);
+        vec[i].Len = tx_off[i].Len;
+    }
+
+    CHECK(EDG_AddGatherToPeriph(&chain, SPI_DT, SPI_REQ, vec, 3, EDG_WIDTH_HALFWORD) == EDG_OK);
+    run_chain(&chain);
+    CHECK(tx_len == 64 + 2 + 300);
+
+    for(i = 0, pos = 0; i < 3; i++) {
+        CHECK(memcmp(&tx[pos], &ram[tx_off[i].Addr], tx_off[i].Len) == 0);
+        pos += tx_off[i].Len;
+    }
+}
+
+//帧缓冲 (x, y) 处 w x h 的矩形拷贝到另一帧缓冲的 (dx, dy)
+static EDG_Result add_rect(EDG_Chain *chain, uint32_t src_fb, uint32_t dst_fb, uint32_t x, uint32_t y,
+                           uint32_t w, uint32_t h, uint32_t dx, uint32_t dy) {
+    uint32_t r;
+    EDG_Result res;
+
+    res = EDG_AddRect(chain, A(dst_fb + dy * FB_PITCH + dx * 2), FB_PITCH, A(src_fb + y * FB_PITCH + x * 2), FB_PITCH,
+                      w * 2, (uint16_t)h);
+
+    if(res == EDG_OK) {
+        for(r = 0; r < h; r++)
+            memcpy(&shadow[dst_fb + (dy + r) * FB_PITCH + dx * 2], &shadow[src_fb + (y + r) * FB_PITCH + x * 2], w * 2);
+    }
+
+    return res;
+}
+
+static void test_rect(void) {
+    const uint32_t fb0 = 0x00000, fb1 = 0x40000;
+    EDG_Chain chain;
+
+    //空链: 2D模式, 同尺寸的第二块还在同一条2D链上
+    reset_bus();
+    EDG_Init(&chain, desc, DESC_MAX);
+    CHECK(add_rect(&chain, fb0, fb1, 13, 7, 50, 30, 101, 55) == EDG_OK);
+    CHECK(add_rect(&chain, fb0, fb1, 200, 100, 50, 30, 3, 190) == EDG_OK);
+    CHECK(chain.Is2D && chain.Num == 2);
+    CHECK(chain.XCnt == 50 && chain.YCnt == 30);
+    run_chain(&chain);
+
+    //从第1列开始只能按半字搬运, 319x240 超过一个2D描述符的 EDG_COUNT_MAX, 按行拆开
+    reset_bus();
+    EDG_Init(&chain, desc, DESC_MAX);
+    CHECK(add_rect(&chain, fb0, fb1, 1, 0, FB_W - 1, FB_H, 1, 0) == EDG_OK);
+    CHECK(!chain.Is2D && chain.Num >= FB_H);
+    run_chain(&chain);
+
+    //一维链上的矩形按行拆开, 奇数像素宽度和起点
+    reset_bus();
+    EDG_Init(&chain, desc, DESC_MAX);
+    CHECK(EDG_AddCopy(&chain, A(0x90001), A(0x98003), 777) == EDG_OK);
+    memcpy(&shadow[0x90001], &shadow[0x98003], 777);
+    CHECK(add_rect(&chain, fb0, fb1, 1, 2, 33, 17, 5, 9) == EDG_OK);
+    CHECK(!chain.Is2D);
+    run_chain(&chain);
+}
+
+static void test_reject(void) {
+    static EDG_Desc small[3];
+    EDG_Desc *odd = (EDG_Desc *)((uint8_t *)desc + 2);
+    EDG_Chain chain;
+    EDG_Vec vec[2];
+
+    reset_bus();
+
+    //字宽度的外设传输, 地址不对齐; 错误保留在链上, 后面的操作和执行都失败, 内存不变
+    EDG_Init(&chain, desc, DESC_MAX);
+    CHECK(EDG_AddToPeriph(&chain, SPI_DT, SPI_REQ, A(0x1002), 64, EDG_WIDTH_WORD) == EDG_ERR_ALIGN);
+    CHECK(EDG_AddCopy(&chain, A(0x2000), A(0x3000), 64) == EDG_ERR_ALIGN);
+    CHECK(EDG_Simulate(&chain, &bus, NULL) == EDG_ERR_ALIGN);
+    CHECK(memcmp(ram, shadow, BUS_SIZE) == 0 && tx_len == 0);
+
+    //长度不是宽度的整数倍, 外设地址不对齐, 宽度非法
+    EDG_Init(&chain, desc, DESC_MAX);
+    CHECK(EDG_AddFromPeriph(&chain, SPI_DT, SPI_REQ, A(0x1000), 63, EDG_WIDTH_HALFWORD) == EDG_ERR_ALIGN);
+    EDG_Init(&chain, desc, DESC_MAX);
+    CHECK(EDG_AddToPeriph(&chain, SPI_DT + 1, SPI_REQ, A(0x1000), 64, EDG_WIDTH_HALFWORD) == EDG_ERR_ALIGN);
+    EDG_Init(&chain, desc, DESC_MAX);
+    CHECK(EDG_AddToPeriph(&chain, SPI_DT, SPI_REQ, A(0x1000), 64, 3) == EDG_ERR_ALIGN);
+
+    //汇集到外设时其中一段不对齐
+    EDG_Init(&chain, desc, DESC_MAX);
+    vec[0].Addr = A(0x1000);
+    vec[0].Len = 16;
+    vec[1].Addr = A(0x2001);
+    vec[1].Len = 16;
+    CHECK(EDG_AddGatherToPeriph(&chain, SPI_DT, SPI_REQ, vec, 2, EDG_WIDTH_WORD) == EDG_ERR_ALIGN);
+    CHECK(chain.Error == EDG_ERR_ALIGN);
+
+    //描述符数组不对齐
+    EDG_Init(&chain, odd, DESC_MAX - 1);
+    CHECK(chain.Error == EDG_ERR_ALIGN);
+    CHECK(EDG_AddCopy(&chain, A(0x2000), A(0x3000), 64) == EDG_ERR_ALIGN);
+
+    //长度为0
+    EDG_Init(&chain, desc, DESC_MAX);
+    CHECK(EDG_AddCopy(&chain, A(0x2000), A(0x3000), 0) == EDG_ERR_LENGTH);
+    EDG_Init(&chain, desc, DESC_MAX);
+    CHECK(EDG_AddRect(&chain, A(0x2000), 64, A(0x3000), 64, 32, 0) == EDG_ERR_LENGTH);
+    EDG_Init(&chain, desc, DESC_MAX);
+    CHECK(EDG_Simulate(&chain, &bus, NULL) == EDG_ERR_LENGTH);
+
+    //一条链只能有一个外设请求
+    EDG_Init(&chain, desc, DESC_MAX);
+    CHECK(EDG_AddToPeriph(&chain, SPI_DT, SPI_REQ, A(0x1000), 64, EDG_WIDTH_BYTE) == EDG_OK);
+    CHECK(EDG_AddFromPeriph(&chain, SPI_DT, UART_REQ, A(0x2000), 64, EDG_WIDTH_BYTE) == EDG_ERR_REQ);
+
+    //2D链: 尺寸不同、加一维描述符、块超过 EDG_COUNT_MAX 都不行
+    EDG_Init(&chain, desc, DESC_MAX);
+    CHECK(EDG_AddRect(&chain, A(0x40000), FB_PITCH, A(0), FB_PITCH, 100, 30) == EDG_OK);
+    CHECK(EDG_AddRect(&chain, A(0x40000), FB_PITCH, A(0), FB_PITCH, 100, 31) == EDG_ERR_2D);
+    EDG_Init(&chain, desc, DESC_MAX);
+    CHECK(EDG_AddRect(&chain, A(0x40000), FB_PITCH, A(0), FB_PITCH, 100, 30) == EDG_OK);
+    CHECK(EDG_AddToPeriph(&chain, SPI_DT, SPI_REQ, A(0x1000), 64, EDG_WIDTH_BYTE) == EDG_ERR_2D);
+    EDG_Init(&chain, desc, DESC_MAX);
+    CHECK(EDG_AddRect(&chain, A(0x40000), FB_PITCH, A(0), FB_PITCH, 100, 30) == EDG_OK);
+    CHECK(EDG_AddRect(&chain, A(0x40000), 65536 * 4, A(0), 65536 * 4, 65536 * 4, 1) == EDG_ERR_LENGTH);
+
+    //描述符不够: 不对齐的拷贝要头/主体/尾三段
+    EDG_Init(&chain, small, 2);
+    CHECK(EDG_AddCopy(&chain, A(0x2001), A(0x3001), 64) == EDG_ERR_FULL);
+    CHECK(EDG_Simulate(&chain, &bus, NULL) == EDG_ERR_FULL);
+    EDG_Init(&chain, small, 3);
+    CHECK(EDG_AddCopy(&chain, A(0x2001), A(0x3001), 64) == EDG_OK);
+    CHECK(chain.Num == 3);
+
+    //构建后改坏的描述符: 个数超过16位, 链表成环, 地址不在总线上
+    EDG_Init(&chain, desc, DESC_MAX);
+    CHECK(EDG_AddCopy(&chain, A(0x2000), A(0x3000), 1024) == EDG_OK);
+    CHECK(EDG_AddCopy(&chain, A(0x5000), A(0x6000), 1024) == EDG_OK);
+    desc[1].Count = EDG_COUNT_MAX + 1;
+    CHECK(EDG_Simulate(&chain, &bus, NULL) == EDG_ERR_LENGTH);
+    desc[1].Count = 256;
+    desc[1].Next = chain.DescBus;
+    desc[1].Ctrl &= ~EDG_CTRL_FDTIEN;
+    CHECK(EDG_Simulate(&chain, &bus, NULL) == EDG_ERR_CHAIN);
+
+    EDG_Init(&chain, desc, DESC_MAX);
+    CHECK(EDG_AddCopy(&chain, A(BUS_SIZE - 64), A(0x3000), 128) == EDG_OK);
+    CHECK(EDG_Simulate(&chain, &bus, NULL) == EDG_ERR_CHAIN);
+}
+
+int main(void) {
+    test_periph();
+    test_gather();
+    test_rect();
+    test_reject();
+
+    printf("%s\n", failed ? "edma_graph_test: FAILED" : "edma_graph_test: OK");
+    return failed;
+}
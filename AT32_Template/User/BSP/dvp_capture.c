@@ -0,0 +1,334 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : dvp_capture.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					三个帧缓冲分别处于三种状态: DMA正在写, 最新完成(等待取走), 使用者
+					正在读. 每帧结束(DVP CFD中断)时停下DMA, 检查长度, 把刚写完的缓冲
+					和"最新完成"交换, 再让DMA去写换出来的那个. 使用者用 LDREX/STREX
+					把自己手中的缓冲和"最新完成"交换, 双方都不需要等待对方, 也不会读到
+					正在写的帧. 使用者处理慢时中间的帧被覆盖, 计入 Dropped.
+					裁剪, 缩放(只能缩小)和Y8二值化都在DVP内部完成, 写入存储器的已是
+					最终图像, 不占CPU也少占总线.
+  * Function List:
+  *		DVP_Cap_Default_Para_Init
+  *		DVP_Cap_Init
+  *		DVP_Cap_Start
+  *		DVP_Cap_Stop
+  *		DVP_Cap_Snapshot
+  *		DVP_Cap_Acquire
+  *		DVP_Cap_GetStats
+  *		DVP_IRQHandler
+  **********************************************************
+ */
+#include "dvp_capture.h"
+
+/* triple buffer state */
+#define DVP_CAP_FRESH		0x80	//"最新完成"中的帧还没被取走
+#define DVP_CAP_INDEX		0x03
+
+typedef struct {
+    DVP_Cap_Frame frame[DVP_CAP_BUF_NUM];
+    uint32_t size;
+    uint8_t  jpeg;
+    uint8_t  snapshot;
+    uint8_t  write;					//DMA正在写的缓冲, 只有中断修改
+    uint8_t  read;					//使用者手中的缓冲, 只有使用者修改
+    __IO uint32_t latest;			//最新完成的缓冲 | DVP_CAP_FRESH, 双方交换
+    __IO uint8_t bad;				//本帧发生过溢出/同步错误
+    __IO uint8_t running;
+    uint32_t seq;
+} DVP_Cap_Handle;
+
+static DVP_Cap_Handle cap;
+static DVP_Cap_Stats cap_stats;
+
+/**
+  * @brief  让DMA从头写 cap.write 指向的缓冲
+  * @param  无
+  * @retval 无
+  */
+static void DVP_Cap_Arm(void) {
+    DMA_Flag_Clear(DVP_CAP_DMA_FLAGS);
+    DVP_CAP_DMA_CHANNEL->maddr = (uint32_t)cap.frame[cap.write].Data;
+    DMA_Data_Number_Set(DVP_CAP_DMA_CHANNEL, cap.size / 4);
+    DMA_Channel_Enable(DVP_CAP_DMA_CHANNEL, TRUE);
+    cap.bad = 0;
+}
+
+/**
+  * @brief  停下DMA, 计算本帧写入的字节数
+  * @param  无
+  * @retval 字节数
+  */
+static uint32_t DVP_Cap_Halt(void) {
+    DMA_Channel_Enable(DVP_CAP_DMA_CHANNEL, FALSE);
+
+    return cap.size - DMA_Data_Number_Get(DVP_CAP_DMA_CHANNEL) * 4;
+}
+
+/**
+  * @brief  一帧结束: 检查后与"最新完成"交换, 被换下的未取走帧计为丢弃
+  * @param  无
+  * @retval 无
+  */
+static void DVP_Cap_Frame_Done(void) {
+    uint32_t len = DVP_Cap_Halt();
+    uint32_t old;
+
+    if(cap.bad || len == 0 || (cap.jpeg ? len == cap.size : len != cap.size)) {
+        cap_stats.Errors++;
+    } else {
+        cap.frame[cap.write].Length = len;
+        cap.frame[cap.write].Seq = ++cap.seq;
+
+        old = cap.latest;
+        cap.latest = cap.write | DVP_CAP_FRESH;
+        cap.write = old & DVP_CAP_INDEX;
+        cap_stats.Frames++;
+
+        if(old & DVP_CAP_FRESH) cap_stats.Dropped++;
+    }
+
+    if(cap.snapshot) cap.running = 0;
+    else DVP_Cap_Arm();
+}
+
+/**
+  * @brief  填充缺省参数
+  * @param  init_struct: 采集参数
+  * @retval 无
+  */
+void DVP_Cap_Default_Para_Init(DVP_Cap_Init_Type *init_struct) {
+    uint8_t i;
+
+    for(i = 0; i < DVP_CAP_BUF_NUM; i++) init_struct->Buffer[i] = 0;
+
+    init_struct->BufSize = 0;
+    init_struct->PCLK_Polarity = DVP_CLK_Polarity_RISING;
+    init_struct->HSync_Polarity = DVP_HSync_Polarity_HIGH;
+    init_struct->VSync_Polarity = DVP_VSync_Polarity_LOW;
+    init_struct->Frame_Rate = DVP_BFRC_ALL;
+    init_struct->Jpeg = FALSE;
+    init_struct->Snapshot = FALSE;
+    init_struct->Crop_X = 0;
+    init_struct->Crop_Y = 0;
+    init_struct->Crop_W = 0;
+    init_struct->Crop_H = 0;
+    init_struct->Bytes_Per_Pixel = 2;
+    init_struct->Data_Format = DVP_EFDF_ByPass;
+    init_struct->Src_W = 0;
+    init_struct->Src_H = 0;
+    init_struct->Scale_W = 0;
+    init_struct->Scale_H = 0;
+    init_struct->Binarization = FALSE;
+    init_struct->Threshold = 0x80;
+    init_struct->NVIC_Preempt_Priority = 1;
+    init_struct->NVIC_Sub_Priority = 0;
+}
+
+/**
+  * @brief  配置DVP/DMA/中断, GPIO和摄像头寄存器由调用者配置
+  * @param  init_struct: 采集参数
+  * @retval ERROR: 参数非法
+  */
+error_status DVP_Cap_Init(DVP_Cap_Init_Type *init_struct) {
+    DMA_Init_Type DMA_Init_struct;
+    uint32_t size = init_struct->BufSize;
+    uint16_t src_w, src_h;
+    uint8_t i;
+
+    if(size == 0 || (size & 3) != 0 || size > DVP_CAP_BUF_MAX) return ERROR;
+
+    for(i = 0; i < DVP_CAP_BUF_NUM; i++) {
+        if(init_struct->Buffer[i] == 0 || ((uint32_t)init_struct->Buffer[i] & 3) != 0) return ERROR;
+
+        cap.frame[i].Data = init_struct->Buffer[i];
+        cap.frame[i].Length = 0;
+        cap.frame[i].Seq = 0;
+    }
+
+    if(init_struct->Crop_W != 0 &&
+            (init_struct->Crop_H == 0 || init_struct->Bytes_Per_Pixel == 0 ||
+             (uint32_t)init_struct->Crop_W * init_struct->Bytes_Per_Pixel > 0x4000 || init_struct->Crop_H > 0x4000)) return ERROR;
+
+    src_w = init_struct->Crop_W ? init_struct->Crop_W : init_struct->Src_W;
+    src_h = init_struct->Crop_W ? init_struct->Crop_H : init_struct->Src_H;
+
+    //缩放和二值化只对未压缩的图像有效, 且缩放必须给出原始大小, 只能缩小
+    if((init_struct->Scale_W != 0 || init_struct->Binarization == TRUE) &&
+            (init_struct->Jpeg == TRUE || init_struct->Data_Format == DVP_EFDF_ByPass)) return ERROR;
+
+    if(init_struct->Scale_W != 0 &&
+            (src_w == 0 || src_h == 0 || init_struct->Scale_H == 0 ||
+             init_struct->Scale_W > src_w || init_struct->Scale_H > src_h)) return ERROR;
+
+    if(init_struct->Binarization == TRUE && init_struct->Data_Format != DVP_EFDF_Y8) return ERROR;
+
+    cap.size = size;
+    cap.jpeg = init_struct->Jpeg == TRUE;
+    cap.snapshot = init_struct->Snapshot == TRUE;
+    cap.write = 0;
+    cap.latest = 1;
+    cap.read = 2;
+    cap.running = 0;
+    cap.seq = 0;
+    cap_stats.Frames = 0;
+    cap_stats.Dropped = 0;
+    cap_stats.Errors = 0;
+    cap_stats.Overruns = 0;
+
+    CRM_Periph_Clock_Enable(CRM_DVP_Periph_CLOCK, TRUE);
+    CRM_Periph_Clock_Enable(CRM_DMA1_Periph_CLOCK, TRUE);
+
+    DVP_Reset();
+    DVP_Capture_Mode_Set(cap.snapshot ? DVP_CAP_FUNC_Mode_SINGLE : DVP_CAP_FUNC_Mode_CONTINUOUS);
+    DVP_Sync_Mode_Set(DVP_Sync_Mode_HARDWARE);
+    DVP_PCLK_Polarity_Set(init_struct->PCLK_Polarity);
+    DVP_HSync_Polarity_Set(init_struct->HSync_Polarity);
+    DVP_VSync_Polarity_Set(init_struct->VSync_Polarity);
+    DVP_Basic_Frame_rate_Control_Set(init_struct->Frame_Rate);
+    DVP_Pixel_Data_Length_Set(DVP_Pixel_Data_Length_8);
+
+    //裁剪窗口以像素时钟计数, 由库函数乘以每像素字节数
+    if(init_struct->Crop_W != 0) {
+        DVP_Window_Crop_Set(init_struct->Crop_X, init_struct->Crop_Y,
+                            init_struct->Crop_W, init_struct->Crop_H, init_struct->Bytes_Per_Pixel);
+        DVP_Window_Crop_Enable(TRUE);
+    }
+
+    DVP_Jpeg_Enable(init_struct->Jpeg);
+
+    //缩放系数寄存器要在设置数据格式之后才能写入
+    DVP_Enhanced_Data_Format_Set(init_struct->Data_Format);
+
+    if(init_struct->Scale_W != 0) {
+        DVP_Enhanced_Scaling_Resize_Set(src_w, init_struct->Scale_W, src_h, init_struct->Scale_H);
+        DVP_Enhanced_Scaling_Resize_Enable(TRUE);
+    }
+
+    DVP_Monochrome_Image_Binarization_Set(init_struct->Threshold, init_struct->Binarization);
+
+    DMA_Reset(DVP_CAP_DMA_CHANNEL);
+    DMA_Default_Para_Init(&DMA_Init_struct);
+    DMA_Init_struct.Peripheral_Base_Addr = (uint32_t)&DVP->dt;
+    DMA_Init_struct.Memory_Base_Addr = (uint32_t)cap.frame[0].Data;
+    DMA_Init_struct.direction = DMA_Dir_PERIPHERAL_To_MEMORY;
+    DMA_Init_struct.Buffer_Size = size / 4;
+    DMA_Init_struct.Peripheral_Inc_Enable = FALSE;
+    DMA_Init_struct.Memory_Inc_Enable = TRUE;
+    DMA_Init_struct.Peripheral_Data_Width = DMA_Peripheral_Data_Width_WORD;
+    DMA_Init_struct.Memory_Data_Width = DMA_Memory_Data_Width_WORD;
+    DMA_Init_struct.Loop_Mode_Enable = FALSE;
+    DMA_Init_struct.priority = DMA_Priority_VERY_HIGH;
+    DMA_Init(DVP_CAP_DMA_CHANNEL, &DMA_Init_struct);
+
+    DMAMUX_Enable(DMA1, TRUE);
+    DMA_Flexible_Config(DMA1, DVP_CAP_DMAMUX_CHANNEL, DMAMUX_DMAREQ_ID_DVP);
+
+    DVP_Flag_Clear(DVP_CFD_INT_FLAG | DVP_OVR_INT_FLAG | DVP_ESE_INT_FLAG);
+    DVP_Interrupt_Enable(DVP_CFD_INT | DVP_OVR_INT | DVP_ESE_INT, TRUE);
+    NVIC_IRQ_Enable(DVP_IRQn, init_struct->NVIC_Preempt_Priority, init_struct->NVIC_Sub_Priority);
+
+    DVP_Enable(TRUE);
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  开始连续采集
+  * @param  无
+  * @retval 无
+  */
+void DVP_Cap_Start(void) {
+    if(cap.running) return;
+
+    cap.running = 1;
+    DVP_Cap_Arm();
+    DVP_Capture_Enable(TRUE);
+}
+
+/**
+  * @brief  停止采集
+  * @param  无
+  * @retval 无
+  */
+void DVP_Cap_Stop(void) {
+    DVP_Capture_Enable(FALSE);
+    NVIC_DisableIRQ(DVP_IRQn);
+    DVP_Cap_Halt();
+    cap.running = 0;
+    NVIC_EnableIRQ(DVP_IRQn);
+}
+
+/**
+  * @brief  快照模式下采集一帧, 采完DVP自动清除 CAP 位, 每次都要重新使能
+  * @param  无
+  * @retval 无
+  */
+void DVP_Cap_Snapshot(void) {
+    DVP_Cap_Start();
+}
+
+/**
+  * @brief  取最新的完整帧
+  * @param  无
+  * @retval 没有新帧返回0; 取到的帧在下一次成功取帧之前不会被覆盖
+  */
+const DVP_Cap_Frame *DVP_Cap_Acquire(void) {
+    uint32_t latest;
+
+    if((cap.latest & DVP_CAP_FRESH) == 0) return 0;
+
+    /* 中断在 LDREX/STREX 之间发生时 STREX 失败, 重新读取 */
+    do {
+        latest = __LDREXW(&cap.latest);
+    } while(__STREXW(cap.read, &cap.latest) != 0);
+
+    cap.read = latest & DVP_CAP_INDEX;
+
+    return &cap.frame[cap.read];
+}
+
+/**
+  * @brief  读取统计计数
+  * @param  stats: 输出
+  * @retval 无
+  */
+void DVP_Cap_GetStats(DVP_Cap_Stats *stats) {
+    *stats = cap_stats;
+}
+
+/**
+  * @brief  DVP中断: 溢出/同步错误标记本帧作废, 帧结束时交换缓冲
+  * @param  无
+  * @retval 无
+  */
+void DVP_IRQHandler(void) {
+    if(DVP_Flag_Get(DVP_OVR_INT_FLAG) == SET) {
+        DVP_Flag_Clear(DVP_OVR_INT_FLAG);
+        cap_stats.Overruns++;
+        cap.bad = 1;
+    }
+
+    if(DVP_Flag_Get(DVP_ESE_INT_FLAG) == SET) {
+        DVP_Flag_Clear(DVP_ESE_INT_FLAG);
+        cap.bad = 1;
+    }
+
+    if(DVP_Flag_Get(DVP_CFD_INT_FLAG) == SET) {
+        DVP_Flag_Clear(DVP_CFD_INT_FLAG);
+
+        if(cap.running) DVP_Cap_Frame_Done();
+    }
+}
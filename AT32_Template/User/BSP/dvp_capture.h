@@ -0,0 +1,89 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : dvp_capture.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : DVP摄像头采集, DMA写三缓冲, 使用者总是取到最新的完整帧;
+  *				   裁剪/缩放/二值化由DVP硬件在采集时完成
+  * Function List:
+  *		DVP_Cap_Default_Para_Init
+  *		DVP_Cap_Init
+  *		DVP_Cap_Start
+  *		DVP_Cap_Stop
+  *		DVP_Cap_Snapshot
+  *		DVP_Cap_Acquire
+  *		DVP_Cap_GetStats
+  ******************************************************
+**/
+
+#ifndef __DVP_CAPTURE_H_
+#define __DVP_CAPTURE_H_
+
+#include "at32f435_437.h"
+
+//DVP请求经DMAMUX接到DMA1通道1
+#define DVP_CAP_DMA_CHANNEL			DMA1_ChanneL1
+#define DVP_CAP_DMAMUX_CHANNEL		DMA1MUX_ChanneL1
+#define DVP_CAP_DMA_FLAGS			(DMA1_GL1_FLAG | DMA1_FDT1_FLAG | DMA1_HDT1_FLAG | DMA1_DTERR1_FLAG)
+
+#define DVP_CAP_BUF_NUM				3
+#define DVP_CAP_BUF_MAX				(65535u * 4)	//DMA一次最多搬运65535个字
+
+typedef struct {
+    uint8_t *Data;					//帧数据, 指向三缓冲之一
+    uint32_t Length;				//有效字节数, JPEG时为实际长度
+    uint32_t Seq;					//帧序号, 相邻两次取到的序号差减1即丢掉的帧数
+} DVP_Cap_Frame;
+
+typedef struct {
+    uint8_t *Buffer[DVP_CAP_BUF_NUM];	//三个帧缓冲, 4字节对齐, 可在SRAM或SDRAM
+    uint32_t BufSize;				//每个缓冲区字节数, 4的倍数; 非JPEG时须等于一帧(裁剪/缩放后)的字节数
+
+    DVP_ckp_Type PCLK_Polarity;
+    DVP_hsp_Type HSync_Polarity;
+    DVP_vsp_Type VSync_Polarity;
+    DVP_bfrc_Type Frame_Rate;		//硬件丢帧降低帧率
+    confirm_state Jpeg;				//TRUE: 摄像头输出JPEG, 帧长度不固定
+    confirm_state Snapshot;			//TRUE: 每次 DVP_Cap_Snapshot 只采一帧; FALSE: 连续采集
+
+    uint16_t Crop_X;				//裁剪窗口, 单位为像素; Crop_W=0 不裁剪
+    uint16_t Crop_Y;
+    uint16_t Crop_W;
+    uint16_t Crop_H;
+    uint8_t  Bytes_Per_Pixel;		//每像素占几个像素时钟(RGB565/YUV422为2)
+
+    DVP_efdf_Type Data_Format;		//输入像素格式, 缩放和二值化需要; DVP_EFDF_ByPass 不做增强处理
+    uint16_t Src_W;					//缩放前的图像大小, 不裁剪时需要给出; 裁剪时取裁剪窗口大小
+    uint16_t Src_H;
+    uint16_t Scale_W;				//缩放后的图像大小, 只能缩小; 0 不缩放
+    uint16_t Scale_H;
+    confirm_state Binarization;		//TRUE: Y8图像按阈值二值化
+    uint8_t  Threshold;				//二值化阈值
+
+    uint32_t NVIC_Preempt_Priority;
+    uint32_t NVIC_Sub_Priority;
+} DVP_Cap_Init_Type;
+
+typedef struct {
+    uint32_t Frames;				//已交给使用者的完整帧数
+    uint32_t Dropped;				//使用者还没来得及取就被更新的帧覆盖的帧数
+    uint32_t Errors;				//长度不对/JPEG超出缓冲区/同步错误而丢弃的帧数
+    uint32_t Overruns;				//DVP FIFO溢出次数
+} DVP_Cap_Stats;
+
+void DVP_Cap_Default_Para_Init(DVP_Cap_Init_Type *init_struct);	// 填充缺省值: 连续采集, 不裁剪, 不缩放, 全帧率
+error_status DVP_Cap_Init(DVP_Cap_Init_Type *init_struct);		// 配置DVP/DMA/中断, 参数非法返回 ERROR; GPIO和摄像头寄存器由调用者配置
+void DVP_Cap_Start(void);		// 开始连续采集
+void DVP_Cap_Stop(void);		// 停止采集
+void DVP_Cap_Snapshot(void);	// 快照模式下采集一帧, 结果同样用 DVP_Cap_Acquire 取
+const DVP_Cap_Frame *DVP_Cap_Acquire(void);	// 取最新的完整帧, 没有新帧返回0; 取到的帧在下一次成功取帧之前不会被覆盖
+void DVP_Cap_GetStats(DVP_Cap_Stats *stats);	// 读取统计计数
+
+#endif
@@ -0,0 +1,461 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : edma_graph.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					库函数 eDMA_Link_List_Init / eDMA_2D_Init 只写LLP和跨距寄存器,
+					描述符的格式和内容要自己拼. 这里把一次传输描述成一串 EDG_Desc,
+					每加一段就在构建时检查对齐、长度、外设请求和2D参数, 出错的链
+					记住第一个错误, 不能启动. 只有最后一个描述符打开传输完成中断,
+					整条链只在全部完成时进一次中断; 错误中断每个描述符都打开.
+					内存到内存的拷贝在源和目的对4取余相同时拆成"字节头 + 字主体 +
+					字节尾"三段, 主体按字搬运.
+					2D寄存器不在描述符中, 所以一条2D链上所有块的行列数和跨距必须相同;
+					已有一维描述符的链上的矩形按行拆成普通描述符.
+					本文件只依赖标准头文件, EDG_Simulate 在PC上按硬件的方式逐条执行
+					描述符, 同时检查链表指针, 用于验证构建出的链.
+  * Function List:
+  *		EDG_Init
+  *		EDG_AddToPeriph
+  *		EDG_AddFromPeriph
+  *		EDG_AddCopy
+  *		EDG_AddGather
+  *		EDG_AddGatherToPeriph
+  *		EDG_AddRect
+  *		EDG_Simulate
+  **********************************************************
+ */
+#include "edma_graph.h"
+#include <stddef.h>
+
+#define EDG_CTRL_BASE       (EDG_CTRL_SEN | EDG_CTRL_DMERRIEN | EDG_CTRL_DTERRIEN | EDG_CTRL_SPL_HIGH)
+#define EDG_CTRL_WIDTH(w)   (((uint32_t)(w) << EDG_CTRL_PWIDTH_Pos) | ((uint32_t)(w) << EDG_CTRL_MWIDTH_Pos))
+#define EDG_PWIDTH(c)       (((c) >> EDG_CTRL_PWIDTH_Pos) & 3)
+#define EDG_MWIDTH(c)       (((c) >> EDG_CTRL_MWIDTH_Pos) & 3)
+
+static EDG_Result EDG_Fail(EDG_Chain *chain, EDG_Result err) {
+    if(chain->Error == EDG_OK) chain->Error = err;
+
+    return err;
+}
+
+/**
+  * @brief  在链尾加一个描述符, 并把完成中断从原来的链尾移到它上面
+  * @param  chain: 链
+  * @param  ctrl: SxCTRL, 不含 FDTIEN
+  * @param  count: 数据个数
+  * @param  paddr: 外设地址/源地址
+  * @param  maddr: 内存地址/目的地址
+  * @retval EDG_OK 或 EDG_ERR_FULL
+  */
+static EDG_Result EDG_Push(EDG_Chain *chain, uint32_t ctrl, uint32_t count, uint32_t paddr, uint32_t maddr) {
+    EDG_Desc *d;
+
+    if(chain->Num >= chain->Max) return EDG_Fail(chain, EDG_ERR_FULL);
+
+    d = &chain->Desc[chain->Num];
+    d->Ctrl = ctrl | EDG_CTRL_FDTIEN;
+    d->Count = count;
+    d->PAddr = paddr;
+    d->MAddr = maddr;
+    d->Next = 0;
+
+    if(chain->Num > 0) {
+        chain->Desc[chain->Num - 1].Ctrl &= ~EDG_CTRL_FDTIEN;
+        chain->Desc[chain->Num - 1].Next = chain->DescBus + chain->Num * sizeof(EDG_Desc);
+    }
+
+    chain->Num++;
+    chain->Bytes += count << ((ctrl >> EDG_CTRL_PWIDTH_Pos) & 3);
+    return EDG_OK;
+}
+
+//一维描述符不能加到2D链上; 外设请求要与链上已有的相同
+static EDG_Result EDG_Check(EDG_Chain *chain, uint8_t req) {
+    if(chain->Error != EDG_OK) return chain->Error;
+
+    if(chain->Is2D) return EDG_Fail(chain, EDG_ERR_2D);
+
+    if(req != 0) {
+        if((chain->Req != 0) && (chain->Req != req)) return EDG_Fail(chain, EDG_ERR_REQ);
+
+        chain->Req = req;
+    }
+
+    return EDG_OK;
+}
+
+static EDG_Result EDG_AddPeriph(EDG_Chain *chain, uint32_t dtd, uint32_t periph, uint8_t req,
+                                uint32_t mem, uint32_t len, uint8_t width) {
+    uint32_t size = 1u << width;
+    uint32_t count = len >> width;
+    uint32_t n;
+    EDG_Result res = EDG_Check(chain, req);
+
+    if(res != EDG_OK) return res;
+
+    if(width > EDG_WIDTH_WORD) return EDG_Fail(chain, EDG_ERR_ALIGN);
+
+    if(((periph | mem | len) & (size - 1)) != 0) return EDG_Fail(chain, EDG_ERR_ALIGN);
+
+    if(len == 0) return EDG_Fail(chain, EDG_ERR_LENGTH);
+
+    while(count > 0) {
+        n = (count > EDG_COUNT_MAX) ? EDG_COUNT_MAX : count;
+        res = EDG_Push(chain, EDG_CTRL_BASE | dtd | EDG_CTRL_MINCM | EDG_CTRL_WIDTH(width), n, periph, mem);
+
+        if(res != EDG_OK) return res;
+
+        mem += n << width;
+        count -= n;
+    }
+
+    return EDG_OK;
+}
+
+//内存到内存, 宽度已选好, 长度对齐
+static EDG_Result EDG_AddCopyWidth(EDG_Chain *chain, uint32_t dst, uint32_t src, uint32_t len, uint8_t width) {
+    uint32_t count = len >> width;
+    uint32_t n;
+    EDG_Result res;
+
+    while(count > 0) {
+        n = (count > EDG_COUNT_MAX) ? EDG_COUNT_MAX : count;
+        res = EDG_Push(chain, EDG_CTRL_BASE | EDG_CTRL_DTD_M2M | EDG_CTRL_PINCM | EDG_CTRL_MINCM | EDG_CTRL_WIDTH(width), n, src, dst);
+
+        if(res != EDG_OK) return res;
+
+        src += n << width;
+        dst += n << width;
+        count -= n;
+    }
+
+    return EDG_OK;
+}
+
+/**
+  * @brief  清空一条链
+  * @param  chain: 链
+  * @param  desc: 描述符数组, 4字节对齐, 在eDMA能访问的RAM中, 链执行期间不能改动
+  * @param  max: 描述符个数
+  * @retval 无
+  */
+void EDG_Init(EDG_Chain *chain, EDG_Desc *desc, uint16_t max) {
+    chain->Desc = desc;
+    chain->DescBus = (uint32_t)(uintptr_t)desc;
+    chain->Max = max;
+    chain->Num = 0;
+    chain->Req = 0;
+    chain->Is2D = 0;
+    chain->XCnt = 0;
+    chain->YCnt = 0;
+    chain->SrcStride = 0;
+    chain->DstStride = 0;
+    chain->Error = (((uintptr_t)desc & 3) != 0) ? EDG_ERR_ALIGN : EDG_OK;
+    chain->Bytes = 0;
+}
+
+/**
+  * @brief  内存到外设
+  * @param  chain: 链
+  * @param  periph: 外设数据寄存器地址, 如 (uint32_t)&SPI1->dt
+  * @param  req: EDMAMUX_DMAREQ_ID_xxx
+  * @param  src: 数据地址
+  * @param  len: 字节数, 宽度的整数倍
+  * @param  width: EDG_WIDTH_xxx, 外设寄存器的宽度
+  * @retval EDG_OK 或错误原因
+  */
+EDG_Result EDG_AddToPeriph(EDG_Chain *chain, uint32_t periph, uint8_t req, uint32_t src, uint32_t len, uint8_t width) {
+    return EDG_AddPeriph(chain, EDG_CTRL_DTD_M2P, periph, req, src, len, width);
+}
+
+/**
+  * @brief  外设到内存
+  * @param  chain: 链
+  * @param  periph: 外设数据寄存器地址
+  * @param  req: EDMAMUX_DMAREQ_ID_xxx
+  * @param  dst: 接收缓冲区
+  * @param  len: 字节数, 宽度的整数倍
+  * @param  width: EDG_WIDTH_xxx
+  * @retval EDG_OK 或错误原因
+  */
+EDG_Result EDG_AddFromPeriph(EDG_Chain *chain, uint32_t periph, uint8_t req, uint32_t dst, uint32_t len, uint8_t width) {
+    return EDG_AddPeriph(chain, EDG_CTRL_DTD_P2M, periph, req, dst, len, width);
+}
+
+/**
+  * @brief  内存到内存拷贝
+  * @param  chain: 链
+  * @param  dst: 目的地址
+  * @param  src: 源地址
+  * @param  len: 字节数
+  * @retval EDG_OK 或错误原因
+  */
+EDG_Result EDG_AddCopy(EDG_Chain *chain, uint32_t dst, uint32_t src, uint32_t len) {
+    uint32_t head, body;
+    EDG_Result res = EDG_Check(chain, 0);
+
+    if(res != EDG_OK) return res;
+
+    if(len == 0) return EDG_Fail(chain, EDG_ERR_LENGTH);
+
+    //对4取余不同时只能逐字节或逐半字搬运
+    if(((src ^ dst) & 3) != 0)
+        return EDG_AddCopyWidth(chain, dst, src, len, ((src | dst | len) & 1) ? EDG_WIDTH_BYTE : EDG_WIDTH_HALFWORD);
+
+    head = (4 - (src & 3)) & 3;
+
+    if(head > len) head = len;
+
+    body = (len - head) & ~3u;
+
+    if(head > 0) {
+        res = EDG_AddCopyWidth(chain, dst, src, head, EDG_WIDTH_BYTE);
+
+        if(res != EDG_OK) return res;
+    }
+
+    if(body > 0) {
+        res = EDG_AddCopyWidth(chain, dst + head, src + head, body, EDG_WIDTH_WORD);
+
+        if(res != EDG_OK) return res;
+    }
+
+    if(len - head - body > 0)
+        return EDG_AddCopyWidth(chain, dst + head + body, src + head + body, len - head - body, EDG_WIDTH_BYTE);
+
+    return EDG_OK;
+}
+
+/**
+  * @brief  把多段内存依次拼接到 dst, 如协议头 + 负载 + 校验组成一个报文
+  * @param  chain: 链
+  * @param  dst: 目的地址
+  * @param  vec: 各段的地址和长度
+  * @param  n: 段数
+  * @retval EDG_OK 或错误原因
+  */
+EDG_Result EDG_AddGather(EDG_Chain *chain, uint32_t dst, const EDG_Vec *vec, uint16_t n) {
+    uint16_t i;
+    EDG_Result res;
+
+    for(i = 0; i < n; i++) {
+        res = EDG_AddCopy(chain, dst, vec[i].Addr, vec[i].Len);
+
+        if(res != EDG_OK) return res;
+
+        dst += vec[i].Len;
+    }
+
+    return EDG_OK;
+}
+
+/**
+  * @brief  把多段内存依次送给同一个外设, 不需要先拷贝到一个连续缓冲区
+  * @param  chain: 链
+  * @param  periph: 外设数据寄存器地址
+  * @param  req: EDMAMUX_DMAREQ_ID_xxx
+  * @param  vec: 各段的地址和长度, 都要与宽度对齐
+  * @param  n: 段数
+  * @param  width: EDG_WIDTH_xxx
+  * @retval EDG_OK 或错误原因
+  */
+EDG_Result EDG_AddGatherToPeriph(EDG_Chain *chain, uint32_t periph, uint8_t req, const EDG_Vec *vec, uint16_t n, uint8_t width) {
+    uint16_t i;
+    EDG_Result res;
+
+    for(i = 0; i < n; i++) {
+        res = EDG_AddPeriph(chain, EDG_CTRL_DTD_M2P, periph, req, vec[i].Addr, vec[i].Len, width);
+
+        if(res != EDG_OK) return res;
+    }
+
+    return EDG_OK;
+}
+
+/**
+  * @brief  帧缓冲子矩形拷贝. 空链或行列数/跨距相同的2D链上用一个2D描述符,
+  *         否则每行一个描述符
+  * @param  chain: 链
+  * @param  dst: 目的矩形左上角
+  * @param  dst_pitch: 目的每行字节数
+  * @param  src: 源矩形左上角
+  * @param  src_pitch: 源每行字节数
+  * @param  row_bytes: 矩形每行字节数
+  * @param  rows: 行数
+  * @retval EDG_OK 或错误原因
+  */
+EDG_Result EDG_AddRect(EDG_Chain *chain, uint32_t dst, uint32_t dst_pitch, uint32_t src, uint32_t src_pitch,
+                       uint32_t row_bytes, uint16_t rows) {
+    uint8_t width;
+    uint32_t xcnt;
+    int32_t sstride, dstride;
+    uint16_t r;
+    EDG_Result res;
+
+    if(chain->Error != EDG_OK) return chain->Error;
+
+    if((row_bytes == 0) || (rows == 0)) return EDG_Fail(chain, EDG_ERR_LENGTH);
+
+    width = ((src | dst | src_pitch | dst_pitch | row_bytes) & 3) == 0 ? EDG_WIDTH_WORD :
+            ((src | dst | src_pitch | dst_pitch | row_bytes) & 1) == 0 ? EDG_WIDTH_HALFWORD : EDG_WIDTH_BYTE;
+    xcnt = row_bytes >> width;
+    sstride = EDG_STRIDE(src_pitch, row_bytes);
+    dstride = EDG_STRIDE(dst_pitch, row_bytes);
+
+    //2D链上一块只占一个描述符, 超过 SxDTCNT 的块不能再拆
+    if(chain->Is2D && (xcnt * rows > EDG_COUNT_MAX)) return EDG_Fail(chain, EDG_ERR_LENGTH);
+
+    if((chain->Num == 0 || chain->Is2D) && (xcnt * rows <= EDG_COUNT_MAX) && (xcnt <= 0xFFFF) &&
+            (sstride >= -32768) && (sstride <= 32767) && (dstride >= -32768) && (dstride <= 32767)) {
+        if(chain->Is2D) {
+            if((chain->XCnt != xcnt) || (chain->YCnt != rows) || (chain->SrcStride != sstride) || (chain->DstStride != dstride) ||
+                    (EDG_PWIDTH(chain->Desc[0].Ctrl) != width))
+                return EDG_Fail(chain, EDG_ERR_2D);
+        } else {
+            chain->Is2D = 1;
+            chain->XCnt = (uint16_t)xcnt;
+            chain->YCnt = rows;
+            chain->SrcStride = (int16_t)sstride;
+            chain->DstStride = (int16_t)dstride;
+        }
+
+        return EDG_Push(chain, EDG_CTRL_BASE | EDG_CTRL_DTD_M2M | EDG_CTRL_PINCM | EDG_CTRL_MINCM | EDG_CTRL_WIDTH(width),
+                        xcnt * rows, src, dst);
+    }
+
+    if(chain->Is2D) return EDG_Fail(chain, EDG_ERR_2D);
+
+    for(r = 0; r < rows; r++) {
+        res = EDG_AddCopy(chain, dst + r * dst_pitch, src + r * src_pitch, row_bytes);
+
+        if(res != EDG_OK) return res;
+    }
+
+    return EDG_OK;
+}
+
+/**
+  * @brief  在PC上执行整条链: 从第一个描述符开始, 按 Next 找下一个, 像eDMA一样搬运数据.
+  *         同时检查 Next 是否指向本链的描述符、是否成环、是否有描述符没被走到、
+  *         完成中断是否只在最后一个描述符上、地址是否与宽度对齐
+  * @param  chain: 链
+  * @param  bus: 总线访问方法
+  * @param  bytes: 返回实际搬运的字节数, 可为NULL
+  * @retval EDG_OK 或错误原因
+  */
+EDG_Result EDG_Simulate(const EDG_Chain *chain, const EDG_HostBus *bus, uint32_t *bytes) {
+    const EDG_Desc *d;
+    uint32_t idx = 0, visited = 0, total = 0;
+    uint32_t w, size, rows, xcnt, row, r, i, data;
+    uint32_t src, dst;
+    uint8_t *ps, *pd;
+
+    if(chain->Error != EDG_OK) return chain->Error;
+
+    if(chain->Num == 0) return EDG_ERR_LENGTH;
+
+    while(1) {
+        if(visited++ >= chain->Num) return EDG_ERR_CHAIN;
+
+        d = &chain->Desc[idx];
+        w = EDG_PWIDTH(d->Ctrl);
+        size = 1u << w;
+
+        if((w > EDG_WIDTH_WORD) || (EDG_MWIDTH(d->Ctrl) != w)) return EDG_ERR_ALIGN;
+
+        if((d->Count == 0) || (d->Count > EDG_COUNT_MAX)) return EDG_ERR_LENGTH;
+
+        if(((d->Ctrl & EDG_CTRL_FDTIEN) != 0) != (d->Next == 0)) return EDG_ERR_CHAIN;
+
+        if(((d->PAddr | d->MAddr) & (size - 1)) != 0) return EDG_ERR_ALIGN;
+
+        switch(d->Ctrl & EDG_CTRL_DTD_Msk) {
+        case EDG_CTRL_DTD_M2M:
+            rows = chain->Is2D ? chain->YCnt : 1;
+            xcnt = chain->Is2D ? chain->XCnt : d->Count;
+
+            if(xcnt * rows != d->Count) return EDG_ERR_2D;
+
+            row = xcnt << w;
+            src = d->PAddr;
+            dst = d->MAddr;
+
+            for(r = 0; r < rows; r++) {
+                ps = bus->Map(src, row);
+                pd = bus->Map(dst, row);
+
+                if((ps == NULL) || (pd == NULL)) return EDG_ERR_CHAIN;
+
+                for(i = 0; i < row; i++) pd[i] = ps[i];
+
+                src += row + chain->SrcStride;
+                dst += row + chain->DstStride;
+            }
+
+            break;
+
+        case EDG_CTRL_DTD_M2P:
+            if(chain->Is2D) return EDG_ERR_2D;
+
+            pd = bus->Map(d->MAddr, d->Count << w);
+
+            if(pd == NULL) return EDG_ERR_CHAIN;
+
+            for(i = 0; i < d->Count; i++) {
+                data = pd[i * size];
+
+                if(size > 1) data |= (uint32_t)pd[i * size + 1] << 8;
+
+                if(size > 2) data |= ((uint32_t)pd[i * size + 2] << 16) | ((uint32_t)pd[i * size + 3] << 24);
+
+                bus->PeriphWrite(d->PAddr, data, (uint8_t)w);
+            }
+
+            break;
+
+        case EDG_CTRL_DTD_P2M:
+            if(chain->Is2D) return EDG_ERR_2D;
+
+            pd = bus->Map(d->MAddr, d->Count << w);
+
+            if(pd == NULL) return EDG_ERR_CHAIN;
+
+            for(i = 0; i < d->Count; i++) {
+                data = bus->PeriphRead(d->PAddr, (uint8_t)w);
+
+                for(r = 0; r < size; r++) pd[i * size + r] = (uint8_t)(data >> (8 * r));
+            }
+
+            break;
+
+        default:
+            return EDG_ERR_CHAIN;
+        }
+
+        total += d->Count << w;
+
+        if(d->Next == 0) break;
+
+        if((d->Next < chain->DescBus) || ((d->Next - chain->DescBus) % sizeof(EDG_Desc) != 0)) return EDG_ERR_CHAIN;
+
+        idx = (d->Next - chain->DescBus) / sizeof(EDG_Desc);
+
+        if(idx >= chain->Num) return EDG_ERR_CHAIN;
+    }
+
+    if(bytes != NULL) *bytes = total;
+
+    //有描述符没有被走到
+    return (visited == chain->Num) ? EDG_OK : EDG_ERR_CHAIN;
+}
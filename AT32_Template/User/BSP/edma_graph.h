@@ -0,0 +1,114 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : edma_graph.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : eDMA链表描述符的构建与检查: 内存<->外设, 2D块拷贝, 多缓冲区汇集,
+  *				   整条链由 edma_launch 一次启动; 附带在PC上逐条执行描述符的解释器
+  * Function List:
+  *		EDG_Init
+  *		EDG_AddToPeriph
+  *		EDG_AddFromPeriph
+  *		EDG_AddCopy
+  *		EDG_AddGather
+  *		EDG_AddGatherToPeriph
+  *		EDG_AddRect
+  *		EDG_Simulate
+  ******************************************************
+**/
+
+#ifndef __EDMA_GRAPH_H_
+#define __EDMA_GRAPH_H_
+
+#include <stdint.h>
+
+//SxCTRL 各位, 与 eDMA_Stream_Type.ctrl_bit 一致. 描述符里的 Ctrl 在链表装入时写入 SxCTRL
+#define EDG_CTRL_SEN                (1u << 0)
+#define EDG_CTRL_DMERRIEN           (1u << 1)
+#define EDG_CTRL_DTERRIEN           (1u << 2)
+#define EDG_CTRL_FDTIEN             (1u << 4)
+#define EDG_CTRL_DTD_P2M            (0u << 6)
+#define EDG_CTRL_DTD_M2P            (1u << 6)
+#define EDG_CTRL_DTD_M2M            (2u << 6)
+#define EDG_CTRL_DTD_Msk            (3u << 6)
+#define EDG_CTRL_PINCM              (1u << 9)
+#define EDG_CTRL_MINCM              (1u << 10)
+#define EDG_CTRL_PWIDTH_Pos         11
+#define EDG_CTRL_MWIDTH_Pos         13
+#define EDG_CTRL_SPL_HIGH           (2u << 16)
+
+//数据宽度
+#define EDG_WIDTH_BYTE              0
+#define EDG_WIDTH_HALFWORD          1
+#define EDG_WIDTH_WORD              2
+
+#define EDG_COUNT_MAX               65535	//SxDTCNT 只有16位
+
+//2D模式下每行结束后地址加上 stride; 这里的 stride 取下一行首与本行末的字节距离
+#define EDG_STRIDE(pitch, row)      ((int32_t)(pitch) - (int32_t)(row))
+
+typedef enum {
+    EDG_OK = 0,
+    EDG_ERR_FULL,                   //描述符数组已满
+    EDG_ERR_ALIGN,                  //地址或长度与数据宽度不对齐
+    EDG_ERR_LENGTH,                 //长度为0, 或2D块超过 EDG_COUNT_MAX
+    EDG_ERR_REQ,                    //一条链只能有一个外设请求(DMAMUX按数据流选择)
+    EDG_ERR_2D,                     //2D块的行列数/跨距与链上已有的不同(2D寄存器不在描述符中)
+    EDG_ERR_STRIDE,                 //跨距超出 int16_t
+    EDG_ERR_CHAIN                   //模拟时发现: 链表指针越界/成环, 或地址无法访问
+} EDG_Result;
+
+//链表描述符, 按 SxCTRL/SxDTCNT/SxPADDR/SxM0ADDR/SxLLP 的顺序存放, 4字节对齐, 放在eDMA能访问的RAM
+typedef struct {
+    uint32_t Ctrl;
+    uint32_t Count;                 //以外设宽度为单位的数据个数
+    uint32_t PAddr;                 //外设地址; 内存到内存时为源地址
+    uint32_t MAddr;                 //内存地址; 内存到内存时为目的地址
+    uint32_t Next;                  //下一个描述符的地址, 0 为最后一个
+} EDG_Desc;
+
+typedef struct {
+    uint32_t Addr;
+    uint32_t Len;                   //字节数
+} EDG_Vec;
+
+typedef struct {
+    EDG_Desc *Desc;
+    uint32_t DescBus;               //Desc 的总线地址, 目标板上就是 (uint32_t)Desc
+    uint16_t Max;
+    uint16_t Num;
+    uint8_t  Req;                   //EDMAMUX_DMAREQ_ID_xxx, 0 只有内存到内存
+    uint8_t  Is2D;                  //整条链工作在2D模式
+    uint16_t XCnt;                  //2D: 每行数据个数
+    uint16_t YCnt;                  //2D: 行数
+    int16_t  SrcStride;
+    int16_t  DstStride;
+    EDG_Result Error;               //第一次构建失败的原因, 有错误的链不能启动
+    uint32_t Bytes;                 //整条链搬运的字节数
+} EDG_Chain;
+
+//解释器访问"总线"的方法, 由PC上的测试程序提供
+typedef struct {
+    uint8_t *(*Map)(uint32_t addr, uint32_t len);			//总线地址转为主机指针, 不可访问返回NULL
+    uint32_t (*PeriphRead)(uint32_t addr, uint8_t width);	//外设到内存时每个数据调用一次
+    void (*PeriphWrite)(uint32_t addr, uint32_t data, uint8_t width);	//内存到外设时每个数据调用一次
+} EDG_HostBus;
+
+void EDG_Init(EDG_Chain *chain, EDG_Desc *desc, uint16_t max);	// 清空一条链, desc 为描述符数组
+EDG_Result EDG_AddToPeriph(EDG_Chain *chain, uint32_t periph, uint8_t req, uint32_t src, uint32_t len, uint8_t width);	// 内存到外设数据寄存器
+EDG_Result EDG_AddFromPeriph(EDG_Chain *chain, uint32_t periph, uint8_t req, uint32_t dst, uint32_t len, uint8_t width);	// 外设数据寄存器到内存
+EDG_Result EDG_AddCopy(EDG_Chain *chain, uint32_t dst, uint32_t src, uint32_t len);	// 内存到内存, 按对齐情况自动选宽度, 超长自动拆分
+EDG_Result EDG_AddGather(EDG_Chain *chain, uint32_t dst, const EDG_Vec *vec, uint16_t n);	// 把 n 段内存依次拼接到 dst
+EDG_Result EDG_AddGatherToPeriph(EDG_Chain *chain, uint32_t periph, uint8_t req, const EDG_Vec *vec, uint16_t n, uint8_t width);	// n 段内存依次送给外设
+EDG_Result EDG_AddRect(EDG_Chain *chain, uint32_t dst, uint32_t dst_pitch, uint32_t src, uint32_t src_pitch,
+                       uint32_t row_bytes, uint16_t rows);	// 帧缓冲子矩形拷贝, 空链时用2D模式, 否则按行拆成描述符
+EDG_Result EDG_Simulate(const EDG_Chain *chain, const EDG_HostBus *bus, uint32_t *bytes);	// 在PC上按描述符执行整条链, 并检查链表本身
+
+#endif
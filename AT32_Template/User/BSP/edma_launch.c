@@ -0,0 +1,171 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : edma_launch.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					第一个描述符由CPU直接写入数据流寄存器, LLP指向第二个, 此后每个描述符
+					传完时eDMA自己从RAM取下一个装入 SxCTRL/SxDTCNT/SxPADDR/SxM0ADDR.
+					edma_graph 只在最后一个描述符上打开 FDTIEN, 所以整条链只有一次完成中断,
+					链中间不需要CPU参与. 2D寄存器和FIFO控制不在描述符中, 启动时按整条链
+					设置一次. 出错时停止数据流, 以 ERROR 调用回调.
+  * Function List:
+  *		EDG_Launch_Init
+  *		EDG_Launch
+  *		EDG_Busy
+  *		EDG_Launch_GetStats
+  *		EDG_IRQHandler
+  **********************************************************
+ */
+#include "edma_launch.h"
+
+static EDG_Done_Callback edg_done;
+static void *edg_arg;
+static uint32_t edg_bytes;
+static __IO uint8_t edg_busy;
+static EDG_Launch_Stats edg_stats;
+
+/**
+  * @brief  链结束或出错, 释放数据流并通知使用者
+  * @param  ok: SUCCESS 整条链完成, ERROR 传输错误
+  * @retval 无
+  */
+static void EDG_Finish(error_status ok) {
+    EDG_Done_Callback done = edg_done;
+
+    if(ok == SUCCESS) edg_stats.Bytes += edg_bytes;
+    else edg_stats.Errors++;
+
+    edg_done = 0;
+    edg_busy = 0;
+
+    if(done) done(ok, edg_arg);
+}
+
+/**
+  * @brief  打开eDMA时钟和DMAMUX, 配置数据流中断
+  * @param  preempt: 抢占优先级
+  * @param  sub: 子优先级
+  * @retval 无
+  */
+void EDG_Launch_Init(uint32_t preempt, uint32_t sub) {
+    CRM_Periph_Clock_Enable(CRM_EDMA_Periph_CLOCK, TRUE);
+
+    eDMA_Stream_Enable(EDG_STREAM, FALSE);
+
+    while(eDMA_Stream_Status_Get(EDG_STREAM) != RESET);
+
+    eDMAMUX_Enable(TRUE);
+    eDMA_Flag_Clear(EDG_FLAG_ALL);
+
+    edg_busy = 0;
+    edg_done = 0;
+    edg_stats.Launches = 0;
+    edg_stats.Descs = 0;
+    edg_stats.Bytes = 0;
+    edg_stats.Errors = 0;
+
+    NVIC_IRQ_Enable(EDG_IRQn, preempt, sub);
+}
+
+/**
+  * @brief  启动整条链, 链结束或出错时在中断中调用 done
+  * @param  chain: 由 edma_graph 构建的链, 描述符在完成前不能改动
+  * @param  done: 完成回调, 可为0
+  * @param  arg: 回调参数
+  * @retval ERROR: 链有构建错误, 为空, 或上一条链还没结束
+  */
+error_status EDG_Launch(const EDG_Chain *chain, EDG_Done_Callback done, void *arg) {
+    const EDG_Desc *d = chain->Desc;
+
+    if(chain->Error != EDG_OK || chain->Num == 0 || edg_busy) return ERROR;
+
+    edg_busy = 1;
+    edg_done = done;
+    edg_arg = arg;
+    edg_bytes = chain->Bytes;
+    edg_stats.Launches++;
+    edg_stats.Descs += chain->Num;
+
+    eDMA_Flag_Clear(EDG_FLAG_ALL);
+
+    //内存到内存必须用FIFO; 单次传输(不突发)时阈值没有对齐限制
+    EDG_STREAM->fctrl_bit.fen = 1;
+    EDG_STREAM->fctrl_bit.fthsel = 3;
+
+    EDG_STREAM->ctrl = d->Ctrl & ~EDG_CTRL_SEN;
+    EDG_STREAM->dtcnt = d->Count;
+    EDG_STREAM->paddr = d->PAddr;
+    EDG_STREAM->m0addr = d->MAddr;
+
+    if(chain->Is2D) {
+        eDMA_2D_Init(EDG_STREAM_2D, chain->SrcStride, chain->DstStride, chain->XCnt, chain->YCnt);
+        eDMA_2D_Enable(EDG_STREAM_2D, TRUE);
+    } else {
+        eDMA_2D_Enable(EDG_STREAM_2D, FALSE);
+    }
+
+    if(d->Next != 0) {
+        eDMA_Link_List_Init(EDG_STREAM_LL, d->Next);
+        eDMA_Link_List_Enable(EDG_STREAM_LL, TRUE);
+    } else {
+        eDMA_Link_List_Enable(EDG_STREAM_LL, FALSE);
+    }
+
+    //DMAMUX按数据流选择请求, 纯内存到内存的链不需要
+    if(chain->Req != 0) eDMAMUX_Init(EDG_MUX_CHANNEL, (eDMAMUX_Requst_ID_sel_Type)chain->Req);
+
+    //描述符是CPU写入的普通内存, 启动前确保已写出
+    __DSB();
+    eDMA_Stream_Enable(EDG_STREAM, TRUE);
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  查询数据流是否还在执行上一条链
+  * @param  无
+  * @retval SET: 忙
+  */
+flag_status EDG_Busy(void) {
+    return edg_busy ? SET : RESET;
+}
+
+/**
+  * @brief  读取统计计数
+  * @param  stats: 统计计数
+  * @retval 无
+  */
+void EDG_Launch_GetStats(EDG_Launch_Stats *stats) {
+    *stats = edg_stats;
+}
+
+void EDG_IRQHandler(void) {
+    if(eDMA_Flag_Get(EDMA_DTERR8_FLAG) != RESET || eDMA_Flag_Get(EDMA_DMERR8_FLAG) != RESET) {
+        eDMA_Stream_Enable(EDG_STREAM, FALSE);
+        eDMA_Flag_Clear(EDG_FLAG_ALL);
+
+        if(edg_busy) EDG_Finish(ERROR);
+
+        return;
+    }
+
+    if(eDMA_Flag_Get(EDG_FLAG_FDT) != RESET) {
+        eDMA_Flag_Clear(EDG_FLAG_FDT);
+
+        //中间描述符也会置FDT标志, 装入最后一个描述符(FDTIEN=1)时可能立即进中断;
+        //数据流还在运行就说明不是链尾, 标志已清除, 等真正结束时再进一次
+        if(eDMA_Stream_Status_Get(EDG_STREAM) != RESET) return;
+
+        if(edg_busy) EDG_Finish(SUCCESS);
+    }
+}
@@ -0,0 +1,55 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : edma_launch.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 把 edma_graph 构建好的描述符链装入一个eDMA数据流, 一次启动, 整条链结束时一次中断
+  * Function List:
+  *		EDG_Launch_Init
+  *		EDG_Launch
+  *		EDG_Busy
+  *		EDG_Launch_GetStats
+  *		EDG_IRQHandler
+  ******************************************************
+**/
+
+#ifndef __EDMA_LAUNCH_H_
+#define __EDMA_LAUNCH_H_
+
+#include "at32f435_437.h"
+#include "edma_graph.h"
+
+//描述符链使用的数据流, 中断服务函数在edma_launch.c中实现
+#define EDG_STREAM                  EDMA_STREAM8
+#define EDG_STREAM_LL               EDMA_STREAM8_LL
+#define EDG_STREAM_2D               EDMA_STREAM8_2D
+#define EDG_MUX_CHANNEL             EDMAMUX_ChanneL8
+#define EDG_IRQn                    EDMA_Stream8_IRQn
+#define EDG_IRQHandler              EDMA_Stream8_IRQHandler
+#define EDG_FLAG_FDT                EDMA_FDT8_FLAG
+#define EDG_FLAG_ERR                (EDMA_DTERR8_FLAG | EDMA_DMERR8_FLAG)
+#define EDG_FLAG_ALL                (EDMA_FDT8_FLAG | EDMA_HDT8_FLAG | EDG_FLAG_ERR | EDMA_FERR8_FLAG)
+
+//整条链结束(ok = SUCCESS)或出错(ok = ERROR, 数据流已停止)时在中断中调用
+typedef void (*EDG_Done_Callback)(error_status ok, void *arg);
+
+typedef struct {
+    uint32_t Launches;              //启动的链数
+    uint32_t Descs;                 //启动的描述符总数
+    uint32_t Bytes;                 //成功完成的链搬运的字节数
+    uint32_t Errors;                //传输错误结束的链数
+} EDG_Launch_Stats;
+
+void EDG_Launch_Init(uint32_t preempt, uint32_t sub);	// 打开eDMA时钟和DMAMUX, 配置数据流中断
+error_status EDG_Launch(const EDG_Chain *chain, EDG_Done_Callback done, void *arg);	// 启动整条链, 链有错误/为空/数据流忙返回 ERROR
+flag_status EDG_Busy(void);		// 上一条链还没结束返回 SET
+void EDG_Launch_GetStats(EDG_Launch_Stats *stats);	// 读取统计计数
+
+#endif
@@ -0,0 +1,562 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : i2c_seq.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					AT32F435的I2C由CTRL2.CNT计数收发的字节数, 计到0时按 RLDEN/ASTOPEN
+					暂停等待重装(TCRLD)、自动发停止, 或停下等待软件(TDC). 这里每个阶段
+					的数据由DMA按 TDIS/RDBF 请求搬运, DMA计数是整个阶段的长度;
+					CNT每次装入不超过255, 还有剩余时打开重装, 最后一块写阶段(后面还要读)
+					用软件停止, 其余用自动停止. CPU只在 TCRLD(每255字节一次)、TDC(写转读,
+					发重复起始)和 STOPF(事务结束)时进中断, 数据字节之间不需要CPU.
+					没有应答时硬件自动发停止, 在 STOPF 中以 I2CS_NACK 结束;
+					总线错误/仲裁丢失/溢出和超时时关闭再打开I2C复位其状态机.
+					I2CS_Bench 用同一个事务比较逐字节查询标志和本驱动的耗时与CPU占用.
+  * Function List:
+  *		I2CS_Init
+  *		I2CS_Submit
+  *		I2CS_Poll
+  *		I2CS_Idle
+  *		I2CS_GetStats
+  *		I2CS_Bench
+  *		I2CS_EVT_IRQHandler
+  *		I2CS_ERR_IRQHandler
+  **********************************************************
+ */
+#include "i2c_seq.h"
+
+#define I2CS_ERR_FLAGS              (I2C_BUSERR_FLAG | I2C_ARLOST_FLAG | I2C_OUF_FLAG | I2C_PECERR_FLAG | I2C_TMOUT_FLAG)
+#define I2CS_INTS                   (I2C_ACKFIAL_INT | I2C_Stop_INT | I2C_TDC_INT | I2C_ERR_INT)
+
+static I2CS_Trans *i2cs_head;       //正在执行的事务, 其后是等待的事务
+static I2CS_Trans *i2cs_tail;
+static uint32_t i2cs_depth;
+
+static uint8_t  i2cs_read;          //1: 正在读阶段
+static uint8_t  i2cs_nack;          //收到 ACKFAIL, 等待硬件发出的停止
+static uint16_t i2cs_left;          //本阶段还没装入CNT的字节数
+static uint32_t i2cs_start;         //事务开始时的DWT计数
+static uint32_t i2cs_timeout;       //CPU周期
+static I2CS_Stats i2cs_stats;
+
+/**
+  * @brief  n 字节中本次装入CNT的字节数
+  */
+static uint8_t I2CS_Count(uint16_t n) {
+    return n > I2CS_CHUNK ? I2CS_CHUNK : (uint8_t)n;
+}
+
+/**
+  * @brief  装入 n 字节中第一块时CNT计到0后的动作
+  * @param  n: 本阶段剩余字节数
+  * @param  stop: 阶段结束后是否发停止
+  */
+static I2C_Reload_Stop_Mode_Type I2CS_EndMode(uint16_t n, uint8_t stop) {
+    if(n > I2CS_CHUNK) return I2C_Reload_Mode;
+
+    return stop ? I2C_Auto_Stop_Mode : I2C_SOFT_Stop_Mode;
+}
+
+/**
+  * @brief  TCRLD时装入下一块, 写CNT同时清除 TCRLD 并放开SCL
+  * @param  left: 本阶段还没装入的字节数, 返回时减去本块
+  * @param  stop: 阶段结束后是否发停止
+  * @retval 本块字节数
+  */
+static uint8_t I2CS_Reload(uint16_t *left, uint8_t stop) {
+    uint8_t cnt = I2CS_Count(*left);
+
+    I2C_Reload_Enable(I2CS_I2C, *left > I2CS_CHUNK ? TRUE : FALSE);
+    I2C_Auto_Stop_Enable(I2CS_I2C, (*left <= I2CS_CHUNK && stop) ? TRUE : FALSE);
+    I2C_CNT_Set(I2CS_I2C, cnt);
+
+    *left -= cnt;
+
+    return cnt;
+}
+
+/**
+  * @brief  让DMA通道从头搬运 len 字节
+  */
+static void I2CS_DMA_Start(DMA_Channel_Type *channel, uint32_t flags, uint32_t mem, uint16_t len) {
+    DMA_Channel_Enable(channel, FALSE);
+    DMA_Flag_Clear(flags);
+    channel->maddr = mem;
+    DMA_Data_Number_Set(channel, len);
+    DMA_Channel_Enable(channel, TRUE);
+}
+
+/**
+  * @brief  关闭DMA请求和通道
+  */
+static void I2CS_Release(void) {
+    I2C_DMA_Enable(I2CS_I2C, I2C_DMA_Request_TX, FALSE);
+    I2C_DMA_Enable(I2CS_I2C, I2C_DMA_Request_RX, FALSE);
+    DMA_Channel_Enable(I2CS_DMA_TX_CHANNEL, FALSE);
+    DMA_Channel_Enable(I2CS_DMA_RX_CHANNEL, FALSE);
+}
+
+/**
+  * @brief  关闭再打开I2C, 复位其状态机和标志, 寄存器配置保留
+  */
+static void I2CS_Reset(void) {
+    I2C_Enable(I2CS_I2C, FALSE);
+
+    //I2CEN须保持为0至少3个APB周期
+    while(I2CS_I2C->ctrl1_bit.i2cen != 0);
+
+    __NOP();
+    __NOP();
+    __NOP();
+
+    I2C_Enable(I2CS_I2C, TRUE);
+    I2C_Flag_Clear(I2CS_I2C, I2C_ACKFAIL_FLAG | I2C_STOPF_FLAG | I2CS_ERR_FLAGS);
+}
+
+/**
+  * @brief  写阶段: 装入第一块并发起始和写地址
+  */
+static void I2CS_Start_Write(I2CS_Trans *trans) {
+    uint8_t cnt = I2CS_Count(trans->WLen);
+
+    i2cs_read = 0;
+    i2cs_left = trans->WLen - cnt;
+
+    if(trans->WLen != 0) {
+        I2CS_DMA_Start(I2CS_DMA_TX_CHANNEL, I2CS_DMA_TX_FLAGS, (uint32_t)trans->WBuf, trans->WLen);
+        I2C_DMA_Enable(I2CS_I2C, I2C_DMA_Request_TX, TRUE);
+    }
+
+    I2C_Transmit_Set(I2CS_I2C, trans->Addr << 1, cnt, I2CS_EndMode(trans->WLen, trans->RLen == 0), I2C_Gen_Start_Write);
+}
+
+/**
+  * @brief  读阶段: 装入第一块并发(重复)起始和读地址
+  */
+static void I2CS_Start_Read(I2CS_Trans *trans) {
+    uint8_t cnt = I2CS_Count(trans->RLen);
+
+    I2C_DMA_Enable(I2CS_I2C, I2C_DMA_Request_TX, FALSE);
+
+    i2cs_read = 1;
+    i2cs_left = trans->RLen - cnt;
+
+    I2CS_DMA_Start(I2CS_DMA_RX_CHANNEL, I2CS_DMA_RX_FLAGS, (uint32_t)trans->RBuf, trans->RLen);
+    I2C_DMA_Enable(I2CS_I2C, I2C_DMA_Request_RX, TRUE);
+
+    I2C_Transmit_Set(I2CS_I2C, trans->Addr << 1, cnt, I2CS_EndMode(trans->RLen, 1), I2C_Gen_Start_Read);
+}
+
+/**
+  * @brief  开始队首事务
+  */
+static void I2CS_Start(void) {
+    I2CS_Trans *trans = i2cs_head;
+
+    trans->State = I2CS_ACTIVE;
+    i2cs_nack = 0;
+    i2cs_timeout = (trans->Timeout ? trans->Timeout : I2CS_TIMEOUT_US) * (system_Core_clock / 1000000);
+    i2cs_start = DWT->CYCCNT;
+
+    I2C_Flag_Clear(I2CS_I2C, I2C_ACKFAIL_FLAG | I2C_STOPF_FLAG | I2CS_ERR_FLAGS);
+
+    if(trans->WLen != 0 || trans->RLen == 0) I2CS_Start_Write(trans);
+    else I2CS_Start_Read(trans);
+}
+
+/**
+  * @brief  结束队首事务, 开始下一个, 再调用回调
+  */
+static void I2CS_Finish(uint8_t result) {
+    I2CS_Trans *trans = i2cs_head;
+
+    I2CS_Release();
+
+    switch(result) {
+        case I2CS_OK:
+            i2cs_stats.Done++;
+            i2cs_stats.Bytes += trans->WLen + trans->RLen;
+            break;
+
+        case I2CS_NACK:
+            i2cs_stats.Nacks++;
+            break;
+
+        case I2CS_TIMEOUT:
+            i2cs_stats.Timeouts++;
+            break;
+
+        default:
+            i2cs_stats.Errors++;
+            break;
+    }
+
+    trans->Result = result;
+    trans->State = I2CS_DONE;
+
+    i2cs_head = trans->Next;
+    trans->Next = 0;
+
+    if(i2cs_head == 0) i2cs_tail = 0;
+
+    i2cs_depth--;
+
+    //先让总线继续工作, 回调中提交的事务排在后面
+    if(i2cs_head) I2CS_Start();
+
+    if(trans->Callback) trans->Callback(trans);
+}
+
+static void I2CS_Abort(uint8_t result) {
+    I2CS_Release();
+    I2CS_Reset();
+    I2CS_Finish(result);
+}
+
+/**
+  * @brief  配置引脚、I2C、DMA通道和中断
+  * @param  clkctrl: I2C clkctrl 寄存器值, 决定SCL频率, 见 I2CS_CLKCTRL_xxx
+  * @param  preempt: 事件/错误中断抢占优先级
+  * @param  sub: 子优先级
+  * @retval ERROR: clkctrl 为0
+  */
+error_status I2CS_Init(uint32_t clkctrl, uint32_t preempt, uint32_t sub) {
+    GPIO_Init_Type GPIO_Init_struct;
+    DMA_Init_Type DMA_Init_struct;
+
+    if(clkctrl == 0) return ERROR;
+
+    CRM_Periph_Clock_Enable(I2CS_CRM_GPIO, TRUE);
+    CRM_Periph_Clock_Enable(I2CS_CRM_I2C, TRUE);
+    CRM_Periph_Clock_Enable(CRM_DMA1_Periph_CLOCK, TRUE);
+
+    GPIO_Pin_Mux_Config(I2CS_GPIO_PORT, I2CS_SCL_PINSRC, I2CS_GPIO_MUX);
+    GPIO_Pin_Mux_Config(I2CS_GPIO_PORT, I2CS_SDA_PINSRC, I2CS_GPIO_MUX);
+
+    GPIO_Default_Para_Init(&GPIO_Init_struct);
+    GPIO_Init_struct.GPIO_Pins = I2CS_SCL_PIN | I2CS_SDA_PIN;
+    GPIO_Init_struct.GPIO_Mode = GPIO_Mode_MUX;
+    GPIO_Init_struct.GPIO_Out_Type = GPIO_OutPut_Open_DRAIN;
+    GPIO_Init_struct.GPIO_Pull = GPIO_Pull_UP;
+    GPIO_Init_struct.GPIO_Drive_Strength = GPIO_Drive_Strength_ModeRATE;
+    GPIO_Init(I2CS_GPIO_PORT, &GPIO_Init_struct);
+
+    CoreDebug->DEMCR |= CoreDEBUG_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_Ctrl_CYCCNTENA_Msk;
+
+    I2C_Init(I2CS_I2C, 0x0F, clkctrl);
+    I2C_Enable(I2CS_I2C, TRUE);
+
+    //两个通道只在每个事务开始时改内存地址和计数
+    DMA_Reset(I2CS_DMA_TX_CHANNEL);
+    DMA_Default_Para_Init(&DMA_Init_struct);
+    DMA_Init_struct.Peripheral_Base_Addr = (uint32_t)&I2CS_I2C->txdt;
+    DMA_Init_struct.direction = DMA_Dir_Memory_To_PERIPHERAL;
+    DMA_Init_struct.Buffer_Size = 0;
+    DMA_Init_struct.Peripheral_Inc_Enable = FALSE;
+    DMA_Init_struct.Memory_Inc_Enable = TRUE;
+    DMA_Init_struct.Peripheral_Data_Width = DMA_Peripheral_Data_Width_BYTE;
+    DMA_Init_struct.Memory_Data_Width = DMA_Memory_Data_Width_BYTE;
+    DMA_Init_struct.Loop_Mode_Enable = FALSE;
+    DMA_Init_struct.priority = DMA_Priority_HIGH;
+    DMA_Init(I2CS_DMA_TX_CHANNEL, &DMA_Init_struct);
+
+    DMA_Reset(I2CS_DMA_RX_CHANNEL);
+    DMA_Init_struct.Peripheral_Base_Addr = (uint32_t)&I2CS_I2C->rxdt;
+    DMA_Init_struct.direction = DMA_Dir_PERIPHERAL_To_MEMORY;
+    DMA_Init(I2CS_DMA_RX_CHANNEL, &DMA_Init_struct);
+
+    DMAMUX_Enable(DMA1, TRUE);
+    DMA_Flexible_Config(DMA1, I2CS_DMA_TX_MUX, I2CS_DMA_TX_REQ);
+    DMA_Flexible_Config(DMA1, I2CS_DMA_RX_MUX, I2CS_DMA_RX_REQ);
+
+    i2cs_head = 0;
+    i2cs_tail = 0;
+    i2cs_depth = 0;
+    i2cs_stats.Done = 0;
+    i2cs_stats.Nacks = 0;
+    i2cs_stats.Errors = 0;
+    i2cs_stats.Timeouts = 0;
+    i2cs_stats.Bytes = 0;
+    i2cs_stats.Reloads = 0;
+    i2cs_stats.IrqCycles = 0;
+    i2cs_stats.QueueMax = 0;
+
+    //TDC_INT 同时打开 TDC 和 TCRLD 中断
+    I2C_Flag_Clear(I2CS_I2C, I2C_ACKFAIL_FLAG | I2C_STOPF_FLAG | I2CS_ERR_FLAGS);
+    I2C_Interrupt_Enable(I2CS_I2C, I2CS_INTS, TRUE);
+
+    NVIC_IRQ_Enable(I2CS_EVT_IRQn, preempt, sub);
+    NVIC_IRQ_Enable(I2CS_ERR_IRQn, preempt, sub);
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  提交事务, 总线空闲时立即开始
+  * @param  trans: 事务, 在回调之前不能释放或改动
+  * @retval ERROR: 缓冲区为空, 或事务已在队列中
+  */
+error_status I2CS_Submit(I2CS_Trans *trans) {
+    uint32_t primask;
+
+    if((trans->WLen != 0 && trans->WBuf == 0) || (trans->RLen != 0 && trans->RBuf == 0)) return ERROR;
+
+    if(trans->State == I2CS_QUEUED || trans->State == I2CS_ACTIVE) return ERROR;
+
+    trans->State = I2CS_QUEUED;
+    trans->Next = 0;
+
+    primask = __Get_PRIMASK();
+    __Disable_irq();
+
+    if(i2cs_tail) i2cs_tail->Next = trans;
+    else i2cs_head = trans;
+
+    i2cs_tail = trans;
+    i2cs_depth++;
+
+    if(i2cs_depth > i2cs_stats.QueueMax) i2cs_stats.QueueMax = i2cs_depth;
+
+    if(i2cs_head == trans) I2CS_Start();
+
+    __Set_PRIMASK(primask);
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  检查正在执行的事务是否超时, 超时则复位I2C并以 I2CS_TIMEOUT 结束
+  * @param  无
+  * @retval 无
+  */
+void I2CS_Poll(void) {
+    uint32_t primask;
+
+    primask = __Get_PRIMASK();
+    __Disable_irq();
+
+    if(i2cs_head && i2cs_head->State == I2CS_ACTIVE && DWT->CYCCNT - i2cs_start > i2cs_timeout)
+        I2CS_Abort(I2CS_TIMEOUT);
+
+    __Set_PRIMASK(primask);
+}
+
+/**
+  * @brief  查询队列是否为空
+  * @param  无
+  * @retval SET: 没有等待或正在执行的事务
+  */
+flag_status I2CS_Idle(void) {
+    return i2cs_head == 0 ? SET : RESET;
+}
+
+/**
+  * @brief  读取统计计数
+  * @param  stats: 输出
+  * @retval 无
+  */
+void I2CS_GetStats(I2CS_Stats *stats) {
+    *stats = i2cs_stats;
+}
+
+/**
+  * @brief  查询方式等待标志
+  * @retval I2CS_OK: 标志置位; 其余为出错原因
+  */
+static uint8_t I2CS_Wait(uint32_t flag, uint32_t start, uint32_t timeout) {
+    uint32_t sts;
+
+    while(1) {
+        sts = I2CS_I2C->sts;
+
+        if(sts & flag) return I2CS_OK;
+
+        if(sts & I2C_ACKFAIL_FLAG) return I2CS_NACK;
+
+        if(sts & I2CS_ERR_FLAGS) return I2CS_ERROR;
+
+        if(DWT->CYCCNT - start > timeout) return I2CS_TIMEOUT;
+    }
+}
+
+/**
+  * @brief  查询方式执行一个阶段, CPU逐字节等待 TDIS/RDBF
+  */
+static uint8_t I2CS_Poll_Phase(I2CS_Trans *trans, uint8_t read, uint32_t start, uint32_t timeout) {
+    uint16_t len = read ? trans->RLen : trans->WLen;
+    uint8_t stop = (read || trans->RLen == 0) ? 1 : 0;
+    uint8_t cnt = I2CS_Count(len);
+    uint16_t left = len - cnt;
+    uint16_t i;
+    uint8_t r;
+
+    I2C_Transmit_Set(I2CS_I2C, trans->Addr << 1, cnt, I2CS_EndMode(len, stop), read ? I2C_Gen_Start_Read : I2C_Gen_Start_Write);
+
+    for(i = 0; i < len; i++) {
+        if(cnt == 0) {
+            r = I2CS_Wait(I2C_TCRLD_FLAG, start, timeout);
+
+            if(r != I2CS_OK) return r;
+
+            cnt = I2CS_Reload(&left, stop);
+        }
+
+        r = I2CS_Wait(read ? I2C_RDBF_FLAG : I2C_TDIS_FLAG, start, timeout);
+
+        if(r != I2CS_OK) return r;
+
+        if(read) trans->RBuf[i] = I2C_Data_Receive(I2CS_I2C);
+        else I2C_Data_Send(I2CS_I2C, trans->WBuf[i]);
+
+        cnt--;
+    }
+
+    return I2CS_Wait(stop ? I2C_STOPF_FLAG : I2C_TDC_FLAG, start, timeout);
+}
+
+/**
+  * @brief  查询方式执行整个事务, 作为对比的基准, 调用时队列须空闲
+  */
+static uint8_t I2CS_Poll_Xfer(I2CS_Trans *trans) {
+    uint32_t timeout = (trans->Timeout ? trans->Timeout : I2CS_TIMEOUT_US) * (system_Core_clock / 1000000);
+    uint32_t start = DWT->CYCCNT;
+    uint8_t r = I2CS_OK;
+
+    I2C_Interrupt_Enable(I2CS_I2C, I2CS_INTS, FALSE);
+    I2C_Flag_Clear(I2CS_I2C, I2C_ACKFAIL_FLAG | I2C_STOPF_FLAG | I2CS_ERR_FLAGS);
+
+    if(trans->WLen != 0 || trans->RLen == 0) r = I2CS_Poll_Phase(trans, 0, start, timeout);
+
+    if(r == I2CS_OK && trans->RLen != 0) r = I2CS_Poll_Phase(trans, 1, start, timeout);
+
+    //没有应答时硬件自动发停止
+    if(r == I2CS_NACK) {
+        while((I2CS_I2C->sts & I2C_STOPF_FLAG) == 0 && DWT->CYCCNT - start <= timeout);
+    }
+
+    if(r == I2CS_ERROR || r == I2CS_TIMEOUT) I2CS_Reset();
+
+    I2C_Flag_Clear(I2CS_I2C, I2C_ACKFAIL_FLAG | I2C_STOPF_FLAG | I2CS_ERR_FLAGS);
+    I2C_Interrupt_Enable(I2CS_I2C, I2CS_INTS, TRUE);
+
+    return r;
+}
+
+/**
+  * @brief  同一事务先用逐字节查询方式执行一次, 再用重装+DMA方式执行一次, 比较耗时和CPU占用
+  * @param  trans: 被测事务, 例如从EEPROM连续读1024字节; 执行期间不调用其回调
+  * @param  result: 输出
+  * @retval ERROR: 队列不空, 或任一次执行没有成功
+  */
+error_status I2CS_Bench(I2CS_Trans *trans, I2CS_BenchResult *result) {
+    I2CS_Callback callback = trans->Callback;
+    uint32_t t0, t1, irq;
+    uint8_t r;
+
+    if(i2cs_head != 0) return ERROR;
+
+    result->Bytes = trans->WLen + trans->RLen;
+
+    t0 = DWT->CYCCNT;
+    r = I2CS_Poll_Xfer(trans);
+    result->Poll_Cycles = DWT->CYCCNT - t0;
+
+    if(r != I2CS_OK) return ERROR;
+
+    trans->Callback = 0;
+    irq = i2cs_stats.IrqCycles;
+
+    t0 = DWT->CYCCNT;
+
+    if(I2CS_Submit(trans) != SUCCESS) {
+        trans->Callback = callback;
+        return ERROR;
+    }
+
+    t1 = DWT->CYCCNT;
+
+    while(trans->State != I2CS_DONE) I2CS_Poll();
+
+    result->Seq_Cycles = DWT->CYCCNT - t0;
+    result->Seq_CPU_Cycles = (t1 - t0) + (i2cs_stats.IrqCycles - irq);
+    trans->Callback = callback;
+
+    if(trans->Result != I2CS_OK) return ERROR;
+
+    result->Poll_Bps = (uint32_t)((uint64_t)result->Bytes * system_Core_clock / result->Poll_Cycles);
+    result->Seq_Bps = (uint32_t)((uint64_t)result->Bytes * system_Core_clock / result->Seq_Cycles);
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  I2C事件中断: 重装计数、写转读、事务结束
+  * @param  无
+  * @retval 无
+  */
+void I2CS_EVT_IRQHandler(void) {
+    uint32_t t0 = DWT->CYCCNT;
+    uint32_t sts = I2CS_I2C->sts;
+    I2CS_Trans *trans = i2cs_head;
+    uint16_t n;
+
+    if(trans == 0) {
+        I2C_Flag_Clear(I2CS_I2C, I2C_ACKFAIL_FLAG | I2C_STOPF_FLAG);
+        return;
+    }
+
+    if(sts & I2C_ACKFAIL_FLAG) {
+        I2C_Flag_Clear(I2CS_I2C, I2C_ACKFAIL_FLAG);
+        i2cs_nack = 1;
+    }
+
+    if(sts & I2C_TCRLD_FLAG) {
+        I2CS_Reload(&i2cs_left, (i2cs_read || trans->RLen == 0) ? 1 : 0);
+        i2cs_stats.Reloads++;
+    } else if((sts & I2C_TDC_FLAG) && i2cs_read == 0) {
+        //写阶段以软件停止结束, 发重复起始转入读阶段
+        I2CS_Start_Read(trans);
+    }
+
+    if(sts & I2C_STOPF_FLAG) {
+        I2C_Flag_Clear(I2CS_I2C, I2C_STOPF_FLAG);
+
+        if(i2cs_nack) {
+            I2CS_Finish(I2CS_NACK);
+        } else {
+            //最后一个字节在停止条件之前收到, DMA此时应已取走
+            for(n = 1000; n != 0 && i2cs_read && DMA_Data_Number_Get(I2CS_DMA_RX_CHANNEL) != 0; n--);
+
+            I2CS_Finish(I2CS_OK);
+        }
+    }
+
+    i2cs_stats.IrqCycles += DWT->CYCCNT - t0;
+}
+
+/**
+  * @brief  I2C错误中断: 总线错误、仲裁丢失、溢出时复位I2C并结束事务
+  * @param  无
+  * @retval 无
+  */
+void I2CS_ERR_IRQHandler(void) {
+    uint32_t t0 = DWT->CYCCNT;
+    uint32_t sts = I2CS_I2C->sts;
+
+    I2C_Flag_Clear(I2CS_I2C, sts & I2CS_ERR_FLAGS);
+
+    if(i2cs_head != 0 && (sts & I2CS_ERR_FLAGS) != 0) I2CS_Abort(I2CS_ERROR);
+
+    i2cs_stats.IrqCycles += DWT->CYCCNT - t0;
+}
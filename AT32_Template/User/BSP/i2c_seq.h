@@ -0,0 +1,125 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : i2c_seq.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : I2C主机硬件排序传输: 以255字节为一块重装计数, 数据由DMA搬运, 自动停止,
+  *				   支持先写后重复起始读的事务排队, 以及与逐字节查询方式的吞吐量对比
+  * Function List:
+  *		I2CS_Init
+  *		I2CS_Submit
+  *		I2CS_Poll
+  *		I2CS_Idle
+  *		I2CS_GetStats
+  *		I2CS_Bench
+  *		I2CS_EVT_IRQHandler
+  *		I2CS_ERR_IRQHandler
+  ******************************************************
+**/
+
+#ifndef __I2C_SEQ_H_
+#define __I2C_SEQ_H_
+
+#include "at32f435_437.h"
+
+//I2C1: PB6=SCL, PB7=SDA, 中断服务函数在i2c_seq.c中实现
+#define I2CS_I2C                    I2C1
+#define I2CS_CRM_I2C                CRM_I2C1_Periph_CLOCK
+#define I2CS_GPIO_PORT              GPIOB
+#define I2CS_CRM_GPIO               CRM_GPIOB_Periph_CLOCK
+#define I2CS_SCL_PIN                GPIO_Pins_6
+#define I2CS_SDA_PIN                GPIO_Pins_7
+#define I2CS_SCL_PINSRC             GPIO_Pins_SOURCE6
+#define I2CS_SDA_PINSRC             GPIO_Pins_SOURCE7
+#define I2CS_GPIO_MUX               GPIO_MUX_4
+#define I2CS_EVT_IRQn               I2C1_EVT_IRQn
+#define I2CS_ERR_IRQn               I2C1_ERR_IRQn
+#define I2CS_EVT_IRQHandler         I2C1_EVT_IRQHandler
+#define I2CS_ERR_IRQHandler         I2C1_ERR_IRQHandler
+
+//发送/接收请求经DMAMUX接到DMA1通道2/3, 只用I2C中断, DMA通道不开中断
+#define I2CS_DMA_TX_CHANNEL         DMA1_ChanneL2
+#define I2CS_DMA_TX_MUX             DMA1MUX_ChanneL2
+#define I2CS_DMA_TX_REQ             DMAMUX_DMAREQ_ID_I2C1_TX
+#define I2CS_DMA_TX_FLAGS           (DMA1_GL2_FLAG | DMA1_FDT2_FLAG | DMA1_HDT2_FLAG | DMA1_DTERR2_FLAG)
+#define I2CS_DMA_RX_CHANNEL         DMA1_ChanneL3
+#define I2CS_DMA_RX_MUX             DMA1MUX_ChanneL3
+#define I2CS_DMA_RX_REQ             DMAMUX_DMAREQ_ID_I2C1_RX
+#define I2CS_DMA_RX_FLAGS           (DMA1_GL3_FLAG | DMA1_FDT3_FLAG | DMA1_HDT3_FLAG | DMA1_DTERR3_FLAG)
+
+//clkctrl 参考值, PCLK1 = 144MHz
+#define I2CS_CLKCTRL_100K           0x80504C4E
+#define I2CS_CLKCTRL_200K           0x30F03C6B
+
+#define I2CS_CHUNK                  255     //CNT最大值, 超过时分块重装
+#define I2CS_TIMEOUT_US             20000   //事务未指定超时时间时使用
+
+//事务结果
+#define I2CS_OK                     0
+#define I2CS_NACK                   1       //地址或数据没有应答
+#define I2CS_ERROR                  2       //总线错误/仲裁丢失/溢出, 已复位I2C
+#define I2CS_TIMEOUT                3       //超时, 已复位I2C
+
+//事务状态
+#define I2CS_IDLE                   0
+#define I2CS_QUEUED                 1
+#define I2CS_ACTIVE                 2
+#define I2CS_DONE                   3
+
+typedef struct I2CS_Trans I2CS_Trans;
+
+//事务结束时在I2C中断中调用(超时时在调用 I2CS_Poll 的上下文中), 回调中可以再次提交
+typedef void (*I2CS_Callback)(I2CS_Trans *trans);
+
+//先写 WLen 字节, 再重复起始读 RLen 字节; 只写、只读, 两者都为0时只检查地址应答
+struct I2CS_Trans {
+    uint8_t  Addr;                  //7位从机地址, 不含读写位
+    const uint8_t *WBuf;
+    uint16_t WLen;                  //0--65535, 超过255字节时分块重装, 中间不停止
+    uint8_t  *RBuf;
+    uint16_t RLen;
+    uint32_t Timeout;               //微秒, 0 使用 I2CS_TIMEOUT_US
+    I2CS_Callback Callback;
+    void *Arg;
+
+    //以下由驱动维护
+    __IO uint8_t State;
+    __IO uint8_t Result;            //I2CS_OK 等
+    I2CS_Trans *Next;
+};
+
+typedef struct {
+    uint32_t Done;                  //成功的事务数
+    uint32_t Nacks;
+    uint32_t Errors;
+    uint32_t Timeouts;
+    uint32_t Bytes;                 //成功的事务收发的数据字节数
+    uint32_t Reloads;               //重装计数的次数, 即CPU在数据中途介入的次数
+    uint32_t IrqCycles;             //事件/错误中断累计占用的CPU周期
+    uint32_t QueueMax;              //队列中(含正在执行的)同时存在的最大事务数
+} I2CS_Stats;
+
+typedef struct {
+    uint32_t Bytes;                 //一次事务的数据字节数
+    uint32_t Poll_Cycles;           //查询方式: 总耗时, CPU全程等待
+    uint32_t Seq_Cycles;            //重装+DMA方式: 总耗时
+    uint32_t Seq_CPU_Cycles;        //重装+DMA方式: 其中在中断中占用的CPU周期
+    uint32_t Poll_Bps;              //吞吐量, 字节/秒
+    uint32_t Seq_Bps;
+} I2CS_BenchResult;
+
+error_status I2CS_Init(uint32_t clkctrl, uint32_t preempt, uint32_t sub);	// 配置引脚/I2C/DMA和中断, clkctrl 见 I2CS_CLKCTRL_xxx
+error_status I2CS_Submit(I2CS_Trans *trans);	// 提交事务, 总线空闲时立即开始; 参数错误或已在队列中返回 ERROR
+void I2CS_Poll(void);				// 检查超时, 在主循环或定时器中断中周期调用
+flag_status I2CS_Idle(void);		// 队列中没有事务返回 SET
+void I2CS_GetStats(I2CS_Stats *stats);	// 读取统计计数
+error_status I2CS_Bench(I2CS_Trans *trans, I2CS_BenchResult *result);	// 同一事务分别用查询方式和本驱动各执行一次并计时, 须在队列空闲时调用
+
+#endif
@@ -0,0 +1,361 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : qspi_xip.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					XIP的速度主要取决于每次取指要等多少个QSPI时钟, 以及能否命中
+					XIP读缓存. 1-4-4 读把地址也放到4线上; 加大每次读取的长度让顺序
+					取指一次取够. 虚拟周期多一个少一个读出的数据都会错位, 所以用单线
+					0x0B读一段数据作参考, 逐个试出能读对的虚拟周期, 不依赖具体Flash
+					型号的手册值. AT32的QSPI没有双沿模式, XIP下也不能发连续读模式字节.
+					另一半是找出哪些函数值得搬到内部RAM: 用DWT周期计数器统计登记
+					过的函数, 按累计耗时排序, 对位于QSPI中的前几名给出分散加载文件
+					的写法. 快照功能用于比较修改配置(或重新链接)前后的耗时.
+  * Function List:
+  *		XIP_Default_Para_Init
+  *		XIP_Init
+  *		XIP_Calibrate
+  *		XIP_Measure
+  *		XIP_Prof_Init
+  *		XIP_Prof_Add
+  *		XIP_Prof_Record
+  *		XIP_Prof_Snapshot
+  *		XIP_Prof_Report
+  **********************************************************
+ */
+#include "qspi_xip.h"
+#include <stdio.h>
+
+/* xip macros */
+#define XIP_SIZE				((uint32_t)0x10000000)
+#define XIP_CAL_MAX				256					//校准时比较的最大字节数
+#define XIP_REF_DIV				QSPI_CLK_Div_8		//参考读法的分频, 单线0x0B在此频率下都能可靠读出
+#define XIP_HOT_PERCENT			90					//建议放入RAM的函数覆盖QSPI中耗时的百分比
+
+static XIP_Init_Type xip;
+static XIP_Prof_Entry prof[XIP_PROF_MAX];
+static uint8_t prof_count;
+
+/**
+  * @brief  单线发送0xFF: Flash若处于连续读状态, 模式位被清除, 重新等待命令
+  * @param  无
+  * @retval 无
+  */
+static void XIP_Mode_Reset(void) {
+    QSPI_CMD_Type cmd = {0};
+
+    QSPI_Xip_Enable(XIP_QSPI, FALSE);
+    cmd.instruction_code = 0xFF;
+    cmd.instruction_length = QSPI_CMD_INSLEN_1_BYTE;
+    cmd.address_length = QSPI_CMD_ADRLEN_0_BYTE;
+    cmd.operation_Mode = QSPI_OPERATE_Mode_111;
+    QSPI_CMD_Operation_kick(XIP_QSPI, &cmd);
+
+    while(QSPI_Flag_Get(XIP_QSPI, QSPI_CMDSTS_FLAG) == RESET);
+
+    QSPI_Flag_Clear(XIP_QSPI, QSPI_CMDSTS_FLAG);
+}
+
+/**
+  * @brief  按给定读法进入XIP, 切换时缓存被清空
+  * @param  mode: XIP_READ_xxx
+  * @param  dummy: 虚拟周期数
+  * @param  div: QSPI时钟分频
+  * @retval 无
+  */
+static void XIP_Map(uint8_t mode, uint8_t dummy, QSPI_CLK_Div_Type div) {
+    QSPI_Xip_Type xip_init = {0};
+
+    QSPI_Xip_Enable(XIP_QSPI, FALSE);
+    QSPI_CLK_Division_Set(XIP_QSPI, div);
+
+    xip_init.read_Address_length = xip.Addr_4Byte == TRUE ? QSPI_Xip_AddrLEN_4_BYTE : QSPI_Xip_AddrLEN_3_BYTE;
+    xip_init.read_Second_dummy_Cycle_Num = dummy;
+    xip_init.read_Select_Mode = xip.Read_Select;
+    xip_init.read_Data_counter = xip.Read_Count;
+    xip_init.read_Time_counter = xip.Read_Count;
+
+    switch(mode) {
+        case XIP_READ_SINGLE:
+            xip_init.read_instruction_code = 0x0B;
+            xip_init.read_Operation_Mode = QSPI_OPERATE_Mode_111;
+            break;
+
+        case XIP_READ_QUAD_OUT:
+            xip_init.read_instruction_code = 0x6B;
+            xip_init.read_Operation_Mode = QSPI_OPERATE_Mode_114;
+            break;
+
+        default:
+            xip_init.read_instruction_code = 0xEB;
+            xip_init.read_Operation_Mode = QSPI_OPERATE_Mode_144;
+            break;
+    }
+
+    //XIP只读, 写命令保持与读相同的地址长度, 不会被使用
+    xip_init.write_instruction_code = 0x32;
+    xip_init.write_Address_length = xip_init.read_Address_length;
+    xip_init.write_Operation_Mode = QSPI_OPERATE_Mode_114;
+    xip_init.write_Select_Mode = QSPI_XIPW_SEL_ModeD;
+    xip_init.write_Data_counter = 0x7F;
+    xip_init.write_Time_counter = 0x7F;
+
+    QSPI_Xip_Init(XIP_QSPI, &xip_init);
+    QSPI_Xip_Enable(XIP_QSPI, TRUE);
+}
+
+/**
+  * @brief  从XIP区读出数据
+  * @param  offset: 相对XIP_BASE的偏移
+  * @param  buf: 输出
+  * @param  size: 字节数
+  * @retval 无
+  */
+static void XIP_Read(uint32_t offset, uint8_t *buf, uint32_t size) {
+    const volatile uint8_t *src = (const volatile uint8_t *)(XIP_BASE + offset);
+    uint32_t i;
+
+    for(i = 0; i < size; i++) buf[i] = src[i];
+}
+
+/**
+  * @brief  打开DWT周期计数器
+  * @param  无
+  * @retval 无
+  */
+static void XIP_DWT_Enable(void) {
+    CoreDebug->DEMCR |= CoreDEBUG_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_Ctrl_CYCCNTENA_Msk;
+}
+
+/**
+  * @brief  填充缺省参数
+  * @param  init_struct: XIP参数
+  * @retval 无
+  */
+void XIP_Default_Para_Init(XIP_Init_Type *init_struct) {
+    init_struct->Clock_Div = QSPI_CLK_Div_2;
+    init_struct->Addr_4Byte = FALSE;
+    init_struct->Read_Mode = XIP_READ_QUAD_IO;
+    init_struct->Dummy_Cycles = XIP_DUMMY_AUTO;
+    init_struct->Cache_Enable = TRUE;
+    init_struct->Read_Select = QSPI_XIPR_SEL_ModeD;
+    init_struct->Read_Count = 0x7F;
+}
+
+/**
+  * @brief  配置QSPI1并进入XIP, GPIO和Flash的QE位由调用者配置
+  * @param  init_struct: XIP参数
+  * @retval ERROR: 参数非法或校准失败
+  */
+error_status XIP_Init(XIP_Init_Type *init_struct) {
+    if(init_struct->Read_Mode > XIP_READ_QUAD_IO ||
+            (init_struct->Dummy_Cycles != XIP_DUMMY_AUTO && init_struct->Dummy_Cycles > 32)) return ERROR;
+
+    xip = *init_struct;
+
+    CRM_Periph_Clock_Enable(CRM_QSPI1_Periph_CLOCK, TRUE);
+    QSPI_SCK_Mode_Set(XIP_QSPI, QSPI_SCK_Mode_0);
+    QSPI_Busy_Config(XIP_QSPI, QSPI_Busy_Offset_0);
+
+    //上次复位前可能停在连续读状态
+    XIP_Mode_Reset();
+
+    if(xip.Dummy_Cycles == XIP_DUMMY_AUTO) return XIP_Calibrate(0, XIP_CAL_MAX);
+
+    QSPI_Xip_Cache_ByPass_Set(XIP_QSPI, xip.Cache_Enable == TRUE ? FALSE : TRUE);
+    XIP_Map(xip.Read_Mode, xip.Dummy_Cycles, xip.Clock_Div);
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  以低速单线读为参考, 逐个试出能读对数据的虚拟周期; 本函数不能在QSPI中执行
+  * @param  offset: 参考数据在Flash中的偏移, 应是内容不全相同的区域(如程序代码)
+  * @param  size: 比较的字节数, 最多256
+  * @retval ERROR: 参考数据无效或找不到可用的虚拟周期
+  */
+error_status XIP_Calibrate(uint32_t offset, uint32_t size) {
+    uint8_t ref[XIP_CAL_MAX], buf[XIP_CAL_MAX];
+    uint8_t dummy;
+    uint32_t i;
+
+    if(size == 0 || size > XIP_CAL_MAX) size = XIP_CAL_MAX;
+
+    //校准期间不用缓存, 每次都真正从Flash读
+    QSPI_Xip_Cache_ByPass_Set(XIP_QSPI, TRUE);
+
+    XIP_Map(XIP_READ_SINGLE, 8, XIP_REF_DIV);
+    XIP_Read(offset, ref, size);
+
+    /* 全是同一个值(如擦除后的0xFF)时任何虚拟周期都"读对", 没法校准 */
+    for(i = 1; i < size && ref[i] == ref[0]; i++);
+
+    if(i == size) return ERROR;
+
+    for(dummy = 0; dummy <= 32; dummy++) {
+        XIP_Map(xip.Read_Mode, dummy, xip.Clock_Div);
+        XIP_Read(offset, buf, size);
+
+        for(i = 0; i < size && buf[i] == ref[i]; i++);
+
+        if(i == size) {
+            xip.Dummy_Cycles = dummy;
+            QSPI_Xip_Cache_ByPass_Set(XIP_QSPI, xip.Cache_Enable == TRUE ? FALSE : TRUE);
+            XIP_Map(xip.Read_Mode, dummy, xip.Clock_Div);
+            return SUCCESS;
+        }
+    }
+
+    /* 回到参考读法, 至少保证QSPI中的常量还能读 */
+    XIP_Map(XIP_READ_SINGLE, 8, XIP_REF_DIV);
+
+    return ERROR;
+}
+
+/**
+  * @brief  测量从XIP区顺序读取的耗时
+  * @param  offset: 起始偏移
+  * @param  size: 字节数
+  * @retval CPU周期数
+  */
+uint32_t XIP_Measure(uint32_t offset, uint32_t size) {
+    const volatile uint32_t *src = (const volatile uint32_t *)(XIP_BASE + (offset & ~3U));
+    uint32_t start, i;
+
+    XIP_DWT_Enable();
+    start = DWT->CYCCNT;
+
+    for(i = 0; i < size / 4; i++) (void)src[i];
+
+    return DWT->CYCCNT - start;
+}
+
+/**
+  * @brief  打开DWT周期计数器, 清空统计表
+  * @param  无
+  * @retval 无
+  */
+void XIP_Prof_Init(void) {
+    XIP_DWT_Enable();
+    prof_count = 0;
+}
+
+/**
+  * @brief  登记一个被统计的函数
+  * @param  name: 函数名, 报告和分散加载文件中使用
+  * @param  fn: 函数地址
+  * @retval 编号, 表满返回 0xFF
+  */
+uint8_t XIP_Prof_Add(const char *name, const void *fn) {
+    XIP_Prof_Entry *e;
+
+    if(prof_count >= XIP_PROF_MAX) return 0xFF;
+
+    e = &prof[prof_count];
+    e->Name = name;
+    e->Addr = (uint32_t)fn & ~1U;
+    e->Calls = 0;
+    e->Cycles = 0;
+    e->Max = 0;
+    e->Base = 0;
+
+    return prof_count++;
+}
+
+/**
+  * @brief  记录一次调用耗时
+  * @param  id: XIP_Prof_Add 返回的编号
+  * @param  cycles: CPU周期数
+  * @retval 无
+  */
+void XIP_Prof_Record(uint8_t id, uint32_t cycles) {
+    XIP_Prof_Entry *e;
+
+    if(id >= prof_count) return;
+
+    e = &prof[id];
+    e->Calls++;
+    e->Cycles += cycles;
+
+    if(cycles > e->Max) e->Max = cycles;
+}
+
+/**
+  * @brief  把当前平均耗时存为基准并清零计数
+  * @param  无
+  * @retval 无
+  */
+void XIP_Prof_Snapshot(void) {
+    uint8_t i;
+
+    for(i = 0; i < prof_count; i++) {
+        prof[i].Base = prof[i].Calls ? prof[i].Cycles / prof[i].Calls : 0;
+        prof[i].Calls = 0;
+        prof[i].Cycles = 0;
+        prof[i].Max = 0;
+    }
+}
+
+/**
+  * @brief  按累计耗时排序打印, 给出与快照相比的加速比(x100)和建议放入RAM的函数
+  * @param  无
+  * @retval 无
+  */
+void XIP_Prof_Report(void) {
+    uint8_t order[XIP_PROF_MAX];
+    uint32_t total = 0, sum = 0, avg;
+    uint8_t i, j, t;
+    XIP_Prof_Entry *e;
+
+    for(i = 0; i < prof_count; i++) order[i] = i;
+
+    for(i = 1; i < prof_count; i++) {
+        t = order[i];
+
+        for(j = i; j > 0 && prof[order[j - 1]].Cycles < prof[t].Cycles; j--) order[j] = order[j - 1];
+
+        order[j] = t;
+    }
+
+    printf("XIP %s, dummy %u, cache %s\r\n", xip.Read_Mode == XIP_READ_QUAD_IO ? "1-4-4" :
+           xip.Read_Mode == XIP_READ_QUAD_OUT ? "1-1-4" : "1-1-1", xip.Dummy_Cycles, xip.Cache_Enable == TRUE ? "on" : "off");
+    printf("%-20s %-10s %8s %10s %8s %8s %8s\r\n", "function", "addr", "calls", "cycles", "avg", "base", "x100");
+
+    for(i = 0; i < prof_count; i++) {
+        e = &prof[order[i]];
+        avg = e->Calls ? e->Cycles / e->Calls : 0;
+        printf("%-20s 0x%08X %8u %10u %8u %8u %8u\r\n", e->Name, e->Addr, e->Calls, e->Cycles, avg, e->Base,
+               avg && e->Base ? e->Base * 100 / avg : 0);
+
+        if(e->Addr - XIP_BASE < XIP_SIZE) total += e->Cycles;
+    }
+
+    if(total == 0) return;
+
+    /* 按累计耗时从高到低, 取覆盖QSPI中大部分耗时的几个函数 */
+    printf("move to RAM (scatter file, RAM execution region):\r\n");
+
+    for(i = 0; i < prof_count && (uint64_t)sum * 100 < (uint64_t)total * XIP_HOT_PERCENT; i++) {
+        e = &prof[order[i]];
+
+        if(e->Addr - XIP_BASE >= XIP_SIZE || e->Cycles == 0) continue;
+
+        sum += e->Cycles;
+#if defined(__ARMCC_VERSION) && (__ARMCC_VERSION >= 6010050)
+        printf("    *.o (.text.%s)\r\n", e->Name);
+#else
+        printf("    *.o (i.%s)\r\n", e->Name);
+#endif
+    }
+}
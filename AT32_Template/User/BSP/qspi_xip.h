@@ -0,0 +1,88 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : qspi_xip.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : QSPI1 XIP配置, 虚拟周期自动校准, 以及基于DWT的函数耗时统计,
+  *				   用统计结果决定哪些函数放到内部RAM执行
+  * Function List:
+  *		XIP_Default_Para_Init
+  *		XIP_Init
+  *		XIP_Calibrate
+  *		XIP_Measure
+  *		XIP_Prof_Init
+  *		XIP_Prof_Add
+  *		XIP_Prof_Record
+  *		XIP_Prof_Snapshot
+  *		XIP_Prof_Report
+  ******************************************************
+**/
+
+#ifndef __QSPI_XIP_H_
+#define __QSPI_XIP_H_
+
+#include "at32f435_437.h"
+
+#define XIP_QSPI				QSPI1
+#define XIP_BASE				QSPI1_Mem_BASE
+
+//读命令, 都按W25Q/GD25Q系列的指令码
+#define XIP_READ_SINGLE			0	//0x0B, 1-1-1, 8个虚拟周期, 也是校准时的参考读法
+#define XIP_READ_QUAD_OUT		1	//0x6B, 1-1-4
+#define XIP_READ_QUAD_IO		2	//0xEB, 1-4-4, 模式字节计入虚拟周期
+
+#define XIP_DUMMY_AUTO			0xFF	//由 XIP_Calibrate 确定虚拟周期数
+
+//函数放到内部RAM执行: 函数前加 XIP_RAMFUNC, 并在分散加载文件的RAM执行区加 *(.ramfunc),
+//启动时 __main 会把它从Flash复制到RAM
+#define XIP_RAMFUNC				__attribute__((section(".ramfunc")))
+
+#define XIP_PROF_MAX			32
+
+typedef struct {
+    QSPI_CLK_Div_Type Clock_Div;	//QSPI时钟分频
+    confirm_state Addr_4Byte;		//TRUE: 4字节地址(容量大于16MB)
+    uint8_t  Read_Mode;				//XIP_READ_xxx
+    uint8_t  Dummy_Cycles;			//读命令的虚拟周期数(0~32), XIP_DUMMY_AUTO 由校准确定
+    confirm_state Cache_Enable;		//TRUE: 使用XIP读缓存
+    QSPI_Xip_Read_sel_Type Read_Select;	//ModeD: 每次读 Read_Count 个数据; ModeT: 读 Read_Count 个时钟
+    uint8_t  Read_Count;			//每次XIP读取的长度, 越大顺序取指越快, 随机跳转的代价也越大
+} XIP_Init_Type;
+
+typedef struct {
+    const char *Name;
+    uint32_t Addr;					//函数地址, 用于判断是否在QSPI中执行
+    uint32_t Calls;
+    uint32_t Cycles;				//累计CPU周期
+    uint32_t Max;					//单次最长
+    uint32_t Base;					//快照时的平均周期, 0 表示没有快照
+} XIP_Prof_Entry;
+
+void XIP_Default_Para_Init(XIP_Init_Type *init_struct);	// 填充缺省值: 1-4-4读, 自动虚拟周期, 开缓存
+error_status XIP_Init(XIP_Init_Type *init_struct);		// 配置QSPI1并进入XIP; Flash的QE位须已置位, GPIO由调用者配置
+error_status XIP_Calibrate(uint32_t offset, uint32_t size);	// 以单线读为参考, 找出读对数据的虚拟周期; 本函数不能在QSPI中执行
+uint32_t XIP_Measure(uint32_t offset, uint32_t size);	// 读 size 字节所用的CPU周期数, 用于比较不同配置
+
+void XIP_Prof_Init(void);		// 打开DWT周期计数器, 清空统计表
+uint8_t XIP_Prof_Add(const char *name, const void *fn);	// 登记一个函数, 返回编号; 表满返回 0xFF
+void XIP_Prof_Record(uint8_t id, uint32_t cycles);	// 记录一次调用耗时
+void XIP_Prof_Snapshot(void);	// 把当前平均耗时存为基准并清零计数, 之后的报告给出加速比
+void XIP_Prof_Report(void);		// 按累计耗时排序打印, 并给出建议放入RAM的函数和分散加载文件写法
+
+//在被测函数里成对使用: uint32_t t = XIP_Prof_Begin(); ... XIP_Prof_End(id, t);
+__STATIC_INLINE uint32_t XIP_Prof_Begin(void) {
+    return DWT->CYCCNT;
+}
+
+__STATIC_INLINE void XIP_Prof_End(uint8_t id, uint32_t start) {
+    XIP_Prof_Record(id, DWT->CYCCNT - start);
+}
+
+#endif
@@ -0,0 +1,464 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : usbd_cdc_bulk.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					复合设备(IAD): 接口0/1为CDC-ACM虚拟串口, 接口2为厂商自定义批量接口,
+					两者都是64字节批量端点, 数据路径相同, 用端口号 UCB_PORT_xxx 区分.
+					接收: 每个端口两块 UCB_RX_SIZE 字节的缓冲区, 一块交给内核接收(一次编程
+					多个包, 收满或短包才完成), 另一块给应用读取, 应用释放后立即重新交给内核,
+					应用处理数据时主机仍可继续发送.
+					发送: 一块数据一次提交给内核, 长度为包长整数倍时自动补零长度包.
+					UCB_Bench 连续发送并统计吞吐量和USB中断占用的CPU周期, 全速批量的理论
+					上限约为 1.2MB/s.
+  * Function List:
+  *		UCB_Init
+  *		UCB_Ready
+  *		UCB_DTR
+  *		UCB_Send
+  *		UCB_TxBusy
+  *		UCB_Read
+  *		UCB_ReadDone
+  *		UCB_Bench
+  **********************************************************
+ */
+#include "usbd_cdc_bulk.h"
+
+#define UCB_CFG_LEN                 98
+
+//接收缓冲区状态
+#define UCB_RX_FREE                 0
+#define UCB_RX_ARMED                1
+#define UCB_RX_FULL                 2
+
+typedef struct {
+    uint8_t  InEp;
+    uint8_t  OutEp;
+    __IO uint8_t TxZlp;             //当前发送完成后还要发零长度包
+    __IO uint8_t RxState[2];
+    uint32_t RxLen[2];
+    uint8_t  RxRead;                //下一块给应用读取的缓冲区
+    uint32_t RxBuf[2][UCB_RX_SIZE / 4];
+} UCB_Port;
+
+static UCB_Port ucb_port[UCB_PORT_NUM];
+
+static uint8_t ucb_line_coding[7] = {0x00, 0xC2, 0x01, 0x00, 0x00, 0x00, 0x08};     //115200 8N1
+static __IO uint8_t ucb_dtr;
+
+static const uint8_t ucb_dev_desc[18] = {
+    0x12, 0x01, 0x00, 0x02,
+    0xEF, 0x02, 0x01,                                   //Misc/IAD
+    UDC_EP0_MPS,
+    UCB_VID & 0xFF, UCB_VID >> 8,
+    UCB_PID & 0xFF, UCB_PID >> 8,
+    UCB_BCD_DEVICE & 0xFF, UCB_BCD_DEVICE >> 8,
+    1, 2, 3, 1
+};
+
+static const uint8_t ucb_cfg_desc[UCB_CFG_LEN] = {
+    0x09, 0x02, UCB_CFG_LEN, 0x00, 0x03, 0x01, 0x00, 0x80, 0x32,
+    //IAD: 接口0~1为CDC
+    0x08, 0x0B, 0x00, 0x02, 0x02, 0x02, 0x01, 0x00,
+    //接口0: CDC通信
+    0x09, 0x04, 0x00, 0x00, 0x01, 0x02, 0x02, 0x01, 0x00,
+    0x05, 0x24, 0x00, 0x10, 0x01,                       //Header
+    0x05, 0x24, 0x01, 0x00, 0x01,                       //Call Management
+    0x04, 0x24, 0x02, 0x02,                             //ACM
+    0x05, 0x24, 0x06, 0x00, 0x01,                       //Union
+    0x07, 0x05, UCB_CDC_CMD_EP, 0x03, UCB_CMD_MPS, 0x00, 0x10,
+    //接口1: CDC数据
+    0x09, 0x04, 0x01, 0x00, 0x02, 0x0A, 0x00, 0x00, 0x00,
+    0x07, 0x05, UCB_CDC_OUT_EP, 0x02, UCB_BULK_MPS, 0x00, 0x00,
+    0x07, 0x05, UCB_CDC_IN_EP, 0x02, UCB_BULK_MPS, 0x00, 0x00,
+    //接口2: 厂商批量
+    0x09, 0x04, 0x02, 0x00, 0x02, 0xFF, 0x00, 0x00, 0x04,
+    0x07, 0x05, UCB_VENDOR_OUT_EP, 0x02, UCB_BULK_MPS, 0x00, 0x00,
+    0x07, 0x05, UCB_VENDOR_IN_EP, 0x02, UCB_BULK_MPS, 0x00, 0x00
+};
+
+static const uint8_t ucb_lang_desc[4] = {0x04, 0x03, 0x09, 0x04};
+
+static const char *const ucb_strings[] = {
+    0,
+    "txt1994",
+    "AT32 CDC + Bulk",
+    0,                                                  //序列号由唯一ID生成
+    "AT32 Bulk"
+};
+
+static uint8_t ucb_str_desc[2 + 2 * 32];
+
+/**
+  * @brief  ASCII字符串转为UTF-16LE字符串描述符
+  */
+static uint16_t UCB_String(const char *s) {
+    uint16_t n = 2;
+
+    while(*s && n < sizeof(ucb_str_desc)) {
+        ucb_str_desc[n++] = (uint8_t)*s++;
+        ucb_str_desc[n++] = 0;
+    }
+
+    ucb_str_desc[0] = n;
+    ucb_str_desc[1] = 0x03;
+
+    return n;
+}
+
+/**
+  * @brief  96位唯一ID转为24个十六进制字符的序列号
+  */
+static uint16_t UCB_Serial(void) {
+    const uint8_t *uid = (const uint8_t *)UCB_UID_ADDR;
+    const char hex[] = "0123456789ABCDEF";
+    char s[25];
+    uint8_t i;
+
+    for(i = 0; i < 12; i++) {
+        s[i * 2] = hex[uid[i] >> 4];
+        s[i * 2 + 1] = hex[uid[i] & 0x0F];
+    }
+
+    s[24] = 0;
+
+    return UCB_String(s);
+}
+
+static const uint8_t *UCB_Descriptor(uint8_t type, uint8_t index, uint16_t *len) {
+    switch(type) {
+        case 0x01:
+            *len = sizeof(ucb_dev_desc);
+            return ucb_dev_desc;
+
+        case 0x02:
+            *len = sizeof(ucb_cfg_desc);
+            return ucb_cfg_desc;
+
+        case 0x03:
+            if(index == 0) {
+                *len = sizeof(ucb_lang_desc);
+                return ucb_lang_desc;
+            }
+
+            if(index == 3) {
+                *len = UCB_Serial();
+                return ucb_str_desc;
+            }
+
+            if(index < sizeof(ucb_strings) / sizeof(ucb_strings[0]) && ucb_strings[index]) {
+                *len = UCB_String(ucb_strings[index]);
+                return ucb_str_desc;
+            }
+
+            return 0;
+
+        default:
+            //包括设备限定描述符: 只支持全速, 回STALL
+            return 0;
+    }
+}
+
+static error_status UCB_Setup(const UDC_Setup *req, uint8_t **data, uint16_t *len) {
+    //只处理发给CDC通信接口的类请求
+    if((req->bmRequestType & 0x7F) != 0x21 || (req->wIndex & 0xFF) != 0) return ERROR;
+
+    switch(req->bRequest) {
+        case 0x20:      //SET_LINE_CODING, 数据在 EP0_RxReady 中处理
+            return SUCCESS;
+
+        case 0x21:      //GET_LINE_CODING
+            *data = ucb_line_coding;
+            *len = sizeof(ucb_line_coding);
+            return SUCCESS;
+
+        case 0x22:      //SET_CONTROL_LINE_STATE
+            ucb_dtr = req->wValue & 0x01;
+            return SUCCESS;
+
+        case 0x23:      //SEND_BREAK
+            return SUCCESS;
+
+        default:
+            return ERROR;
+    }
+}
+
+static void UCB_EP0_RxReady(const UDC_Setup *req, const uint8_t *data, uint16_t len) {
+    uint8_t i;
+
+    if(req->bRequest == 0x20 && len >= sizeof(ucb_line_coding)) {
+        for(i = 0; i < sizeof(ucb_line_coding); i++) ucb_line_coding[i] = data[i];
+    }
+}
+
+/**
+  * @brief  把缓冲区 i 交给内核接收
+  */
+static void UCB_Arm(UCB_Port *p, uint8_t i) {
+    p->RxState[i] = UCB_RX_ARMED;
+
+    if(UDC_EP_Receive(p->OutEp, (uint8_t *)p->RxBuf[i], UCB_RX_SIZE) != SUCCESS) p->RxState[i] = UCB_RX_FREE;
+}
+
+static void UCB_Configured(uint8_t cfg) {
+    uint8_t n;
+    UCB_Port *p;
+
+    ucb_dtr = 0;
+
+    if(cfg == 0) {
+        UDC_EP_Close(UCB_CDC_CMD_EP);
+
+        for(n = 0; n < UCB_PORT_NUM; n++) {
+            UDC_EP_Close(ucb_port[n].InEp);
+            UDC_EP_Close(ucb_port[n].OutEp);
+        }
+
+        return;
+    }
+
+    UDC_EP_Open(UCB_CDC_CMD_EP, EPT_INT_Type, UCB_CMD_MPS);
+
+    for(n = 0; n < UCB_PORT_NUM; n++) {
+        p = &ucb_port[n];
+        p->TxZlp = 0;
+        p->RxState[0] = UCB_RX_FREE;
+        p->RxState[1] = UCB_RX_FREE;
+        p->RxRead = 0;
+        UDC_EP_Open(p->InEp, EPT_BULK_Type, UCB_BULK_MPS);
+        UDC_EP_Open(p->OutEp, EPT_BULK_Type, UCB_BULK_MPS);
+        UCB_Arm(p, 0);
+    }
+}
+
+static UCB_Port *UCB_Find(uint8_t ep) {
+    uint8_t n;
+
+    for(n = 0; n < UCB_PORT_NUM; n++) {
+        if(ucb_port[n].InEp == ep || ucb_port[n].OutEp == ep) return &ucb_port[n];
+    }
+
+    return 0;
+}
+
+static void UCB_InDone(uint8_t ep, uint32_t len) {
+    UCB_Port *p = UCB_Find(ep);
+
+    (void)len;
+
+    if(p && p->TxZlp) {
+        p->TxZlp = 0;
+        UDC_EP_Transmit(ep, 0, 0);
+    }
+}
+
+/**
+  * @brief  一块缓冲区收满或收到短包: 交给应用, 另一块空闲时立即接着接收
+  */
+static void UCB_OutDone(uint8_t ep, uint32_t len) {
+    UCB_Port *p = UCB_Find(ep);
+    uint8_t i;
+
+    if(p == 0) return;
+
+    i = (p->RxState[0] == UCB_RX_ARMED) ? 0 : 1;
+
+    //零长度包, 原缓冲区继续接收
+    if(len == 0) {
+        UCB_Arm(p, i);
+        return;
+    }
+
+    p->RxLen[i] = len;
+    p->RxState[i] = UCB_RX_FULL;
+
+    if(p->RxState[i ^ 1] == UCB_RX_FREE) UCB_Arm(p, i ^ 1);
+}
+
+static const UDC_Class ucb_class = {
+    UCB_Descriptor,
+    UCB_Setup,
+    UCB_EP0_RxReady,
+    UCB_Configured,
+    UCB_InDone,
+    UCB_OutDone
+};
+
+/**
+  * @brief  初始化端口并连接USB, 48MHz USB时钟须已配置
+  * @param  preempt: 抢占优先级
+  * @param  sub: 子优先级
+  * @retval 无
+  */
+void UCB_Init(uint32_t preempt, uint32_t sub) {
+    ucb_port[UCB_PORT_CDC].InEp = UCB_CDC_IN_EP;
+    ucb_port[UCB_PORT_CDC].OutEp = UCB_CDC_OUT_EP;
+    ucb_port[UCB_PORT_VENDOR].InEp = UCB_VENDOR_IN_EP;
+    ucb_port[UCB_PORT_VENDOR].OutEp = UCB_VENDOR_OUT_EP;
+    ucb_dtr = 0;
+
+    UDC_Init(&ucb_class, preempt, sub);
+}
+
+/**
+  * @brief  主机是否已配置设备
+  * @param  无
+  * @retval 1: 已配置
+  */
+uint8_t UCB_Ready(void) {
+    return UDC_Configured() ? 1 : 0;
+}
+
+/**
+  * @brief  CDC端口的DTR状态
+  * @param  无
+  * @retval 1: 主机已打开串口
+  */
+uint8_t UCB_DTR(void) {
+    return ucb_dtr;
+}
+
+/**
+  * @brief  发送一块数据, 内核一次编程整块, 长度为包长整数倍时最后补零长度包
+  * @param  port: UCB_PORT_CDC、UCB_PORT_VENDOR
+  * @param  buf: 数据, 完成前不能改动, 4字节对齐时最快
+  * @param  len: 字节数
+  * @retval ERROR: 未配置或上一块还未发完
+  */
+error_status UCB_Send(uint8_t port, const uint8_t *buf, uint32_t len) {
+    UCB_Port *p;
+
+    if(port >= UCB_PORT_NUM || UDC_Configured() == 0) return ERROR;
+
+    p = &ucb_port[port];
+
+    if(p->TxZlp) return ERROR;
+
+    p->TxZlp = (len != 0 && (len % UCB_BULK_MPS) == 0) ? 1 : 0;
+
+    if(UDC_EP_Transmit(p->InEp, buf, len) != SUCCESS) {
+        p->TxZlp = 0;
+        return ERROR;
+    }
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  查询发送是否未完成(含结尾的零长度包)
+  * @param  port: 端口
+  * @retval SET: 忙
+  */
+flag_status UCB_TxBusy(uint8_t port) {
+    if(port >= UCB_PORT_NUM) return RESET;
+
+    return (ucb_port[port].TxZlp || UDC_EP_Busy(ucb_port[port].InEp) == SET) ? SET : RESET;
+}
+
+/**
+  * @brief  取最早收满的一块接收缓冲区, 用完后须调用 UCB_ReadDone
+  * @param  port: 端口
+  * @param  data: 输出数据地址
+  * @retval 字节数, 0 表示没有数据
+  */
+uint32_t UCB_Read(uint8_t port, const uint8_t **data) {
+    UCB_Port *p;
+
+    if(port >= UCB_PORT_NUM) return 0;
+
+    p = &ucb_port[port];
+
+    if(p->RxState[p->RxRead] != UCB_RX_FULL) return 0;
+
+    *data = (const uint8_t *)p->RxBuf[p->RxRead];
+
+    return p->RxLen[p->RxRead];
+}
+
+/**
+  * @brief  释放 UCB_Read 取得的缓冲区; 另一块也已收满(接收暂停)时立即重新接收
+  * @param  port: 端口
+  * @retval 无
+  */
+void UCB_ReadDone(uint8_t port) {
+    UCB_Port *p;
+    uint32_t primask;
+    uint8_t i;
+
+    if(port >= UCB_PORT_NUM) return;
+
+    p = &ucb_port[port];
+    i = p->RxRead;
+
+    if(p->RxState[i] != UCB_RX_FULL) return;
+
+    primask = __Get_PRIMASK();
+    __Disable_irq();
+
+    p->RxState[i] = UCB_RX_FREE;
+    p->RxRead = i ^ 1;
+
+    if(p->RxState[i ^ 1] != UCB_RX_ARMED && UDC_Configured()) UCB_Arm(p, i);
+
+    __Set_PRIMASK(primask);
+}
+
+/**
+  * @brief  以 len 字节一块连续发送 total 字节, 统计吞吐量和USB中断占用的CPU
+  * @param  port: 端口, 主机端须持续读取该端口
+  * @param  buf: 发送数据
+  * @param  len: 每块字节数, 取包长的整数倍且较大时吞吐量最高
+  * @param  total: 总字节数
+  * @param  result: 输出
+  * @retval ERROR: 未配置或主机1秒内没有读走数据
+  */
+error_status UCB_Bench(uint8_t port, const uint8_t *buf, uint32_t len, uint32_t total, UCB_BenchResult *result) {
+    UDC_Stats s0, s1;
+    uint64_t cycles = 0;
+    uint32_t sent = 0, n, t0, t1, wait;
+
+    if(port >= UCB_PORT_NUM || len == 0 || UDC_Configured() == 0) return ERROR;
+
+    while(UCB_TxBusy(port) == SET);
+
+    UDC_GetStats(&s0);
+    t0 = DWT->CYCCNT;
+
+    while(sent < total) {
+        n = (total - sent) > len ? len : total - sent;
+
+        if(UCB_Send(port, buf, n) != SUCCESS) return ERROR;
+
+        wait = DWT->CYCCNT;
+
+        while(UCB_TxBusy(port) == SET) {
+            if(DWT->CYCCNT - wait > system_Core_clock) return ERROR;
+        }
+
+        t1 = DWT->CYCCNT;
+        cycles += t1 - t0;
+        t0 = t1;
+        sent += n;
+    }
+
+    UDC_GetStats(&s1);
+
+    result->Bytes = sent;
+    result->Cycles = cycles > 0xFFFFFFFF ? 0xFFFFFFFF : (uint32_t)cycles;
+    result->IrqCycles = s1.IrqCycles - s0.IrqCycles;
+    result->Bps = cycles ? (uint32_t)((uint64_t)sent * system_Core_clock / cycles) : 0;
+    result->CpuPermille = cycles ? (uint32_t)((uint64_t)result->IrqCycles * 1000 / cycles) : 0;
+
+    return SUCCESS;
+}
@@ -0,0 +1,73 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : usbd_cdc_bulk.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 基于usbd_core的复合设备: 一个CDC-ACM虚拟串口和一个厂商自定义批量接口,
+  *				   接收为两块缓冲区轮流接收, 发送整块一次提交, 带发送吞吐量测试
+  * Function List:
+  *		UCB_Init
+  *		UCB_Ready
+  *		UCB_DTR
+  *		UCB_Send
+  *		UCB_TxBusy
+  *		UCB_Read
+  *		UCB_ReadDone
+  *		UCB_Bench
+  ******************************************************
+**/
+
+#ifndef __USBD_CDC_BULK_H_
+#define __USBD_CDC_BULK_H_
+
+#include "usbd_core.h"
+
+#define UCB_VID                     0x2E3C
+#define UCB_PID                     0x5740
+#define UCB_BCD_DEVICE              0x0100
+
+//端点分配, 发送FIFO见 usbd_core.h 中的 UDC_TX_FIFOx
+#define UCB_CDC_IN_EP               UDC_EP_IN(1)
+#define UCB_CDC_OUT_EP              UDC_EP_OUT(1)
+#define UCB_CDC_CMD_EP              UDC_EP_IN(2)
+#define UCB_VENDOR_IN_EP            UDC_EP_IN(3)
+#define UCB_VENDOR_OUT_EP           UDC_EP_OUT(3)
+
+#define UCB_BULK_MPS                64
+#define UCB_CMD_MPS                 8
+
+//每个端口两块接收缓冲区, 必须为 UCB_BULK_MPS 的整数倍
+#define UCB_RX_SIZE                 512
+
+#define UCB_UID_ADDR                0x1FFFF7E8  //96位唯一ID, 作为序列号
+
+//端口
+#define UCB_PORT_CDC                0
+#define UCB_PORT_VENDOR             1
+#define UCB_PORT_NUM                2
+
+typedef struct {
+    uint32_t Bytes;                 //发送的总字节数
+    uint32_t Cycles;                //总耗时(CPU周期)
+    uint32_t IrqCycles;             //其间USB中断占用的CPU周期
+    uint32_t Bps;                   //吞吐量, 字节/秒
+    uint32_t CpuPermille;           //USB中断占用的CPU千分比
+} UCB_BenchResult;
+
+void UCB_Init(uint32_t preempt, uint32_t sub);	// 初始化并连接USB
+uint8_t UCB_Ready(void);			// 主机已配置设备返回1
+uint8_t UCB_DTR(void);				// CDC端口的DTR状态, 主机打开串口时为1
+error_status UCB_Send(uint8_t port, const uint8_t *buf, uint32_t len);	// 发送一块数据, 完成前 buf 不能改动; 忙或未配置返回 ERROR
+flag_status UCB_TxBusy(uint8_t port);	// 发送未完成返回 SET
+uint32_t UCB_Read(uint8_t port, const uint8_t **data);	// 取最早收满的一块接收缓冲区, 返回字节数, 没有数据返回0
+void UCB_ReadDone(uint8_t port);	// 释放 UCB_Read 取得的缓冲区, 继续接收
+error_status UCB_Bench(uint8_t port, const uint8_t *buf, uint32_t len, uint32_t total, UCB_BenchResult *result);	// 以 len 字节一块连续发送 total 字节并计时, 主机须持续读取
+
+#endif
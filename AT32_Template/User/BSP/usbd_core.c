@@ -0,0 +1,902 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : usbd_core.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					AT32F435的OTGFS只有从模式(没有内部DMA, 也没有ULPI, 只支持全速),
+					FIFO只能由CPU读写. 为了让CPU只搬数据而不在每个包上做别的事:
+					1. IN端点一次编程 pktcnt/xfersize 为整个传输(最多1023包), 端点的发送FIFO
+					   半空时进中断, 按FIFO剩余空间一次写入尽可能多的整包, 中途不需要重新编程;
+					2. OUT端点同样一次编程多个包, RXFLVL中断把数据从FIFO直接读进用户缓冲区,
+					   收满或收到短包时才有一次完成中断;
+					3. FIFO读写按字进行, 缓冲区4字节对齐时4字展开循环, 不对齐时逐字非对齐访问,
+					   末尾不足一字的部分单独处理, 不会像 USB_Read_Packet 那样越界写缓冲区.
+					端点0按单包处理数据阶段, 标准请求在本文件中处理, 描述符、类请求和
+					非0端点的完成交给类层(UDC_Class).
+  * Function List:
+  *		UDC_Init
+  *		UDC_EP_Open
+  *		UDC_EP_Close
+  *		UDC_EP_Transmit
+  *		UDC_EP_Receive
+  *		UDC_EP_Busy
+  *		UDC_EP_Stall
+  *		UDC_Configured
+  *		UDC_GetStats
+  *		UDC_IRQHandler
+  **********************************************************
+ */
+#include "usbd_core.h"
+
+#define UDC_CTL_CNAK                ((uint32_t)1 << 26)
+#define UDC_CTL_SNAK                ((uint32_t)1 << 27)
+#define UDC_CTL_EPDIS               ((uint32_t)1 << 30)
+#define UDC_CTL_EPENA               ((uint32_t)1 << 31)
+
+#define UDC_PKTCNT_MAX              1023    //DIEPTSIZ/DOEPTSIZ.pktcnt 的最大值
+
+//端点0控制传输阶段
+#define UDC_EP0_IDLE                0
+#define UDC_EP0_DATA_IN             1
+#define UDC_EP0_DATA_OUT            2
+#define UDC_EP0_STATUS_IN           3
+#define UDC_EP0_STATUS_OUT          4
+
+typedef struct {
+    uint8_t  *Buf;
+    uint32_t Len;                   //整个传输的字节数
+    uint32_t Done;                  //已完成的块的字节数
+    uint32_t Chunk;                 //当前编程的块的字节数
+    uint32_t Fifo;                  //当前块已写入FIFO(IN)或已从FIFO读出(OUT)的字节数
+    uint16_t Mps;
+    __IO uint8_t Busy;
+} UDC_EP;
+
+static const UDC_Class *udc_cls;
+static UDC_EP udc_in[UDC_EP_NUM];
+static UDC_EP udc_out[UDC_EP_NUM];
+
+static uint32_t udc_setup_raw[2];   //SETUP包, 按字从FIFO读出
+static UDC_Setup udc_setup;
+static uint32_t udc_ep0_buf[UDC_EP0_MPS / 4];
+static uint8_t udc_reply[2];
+static uint8_t udc_ep0_state;
+static uint8_t udc_ep0_zlp;         //IN数据阶段最后还要补一个零长度包
+static uint8_t udc_cfg;
+static UDC_Stats udc_stats;
+
+/**
+  * @brief  从 p 写 len 字节到端点 n 的发送FIFO
+  */
+static void UDC_FIFO_Write(uint8_t n, const uint8_t *p, uint32_t len) {
+    __IO uint32_t *fifo = &USB_FIFO(UDC_OTG, n);
+    uint32_t words = len / 4;
+    uint32_t tail = len & 3;
+    uint32_t v, i;
+
+    if(((uint32_t)p & 3) == 0) {
+        const uint32_t *w = (const uint32_t *)p;
+
+        for(; words >= 4; words -= 4, w += 4) {
+            *fifo = w[0];
+            *fifo = w[1];
+            *fifo = w[2];
+            *fifo = w[3];
+        }
+
+        for(; words != 0; words--) *fifo = *w++;
+
+        p = (const uint8_t *)w;
+    } else {
+        for(; words != 0; words--, p += 4) *fifo = __UNALIGNED_UINT32_Read(p);
+    }
+
+    if(tail != 0) {
+        for(v = 0, i = 0; i < tail; i++) v |= (uint32_t)p[i] << (i * 8);
+
+        *fifo = v;
+    }
+}
+
+/**
+  * @brief  从接收FIFO读 len 字节到 p, p 为0时丢弃
+  */
+static void UDC_FIFO_Read(uint8_t *p, uint32_t len) {
+    __IO uint32_t *fifo = &USB_FIFO(UDC_OTG, 0);
+    uint32_t words = len / 4;
+    uint32_t tail = len & 3;
+    uint32_t v, i;
+
+    if(p == 0) {
+        for(words = (len + 3) / 4; words != 0; words--) v = *fifo;
+
+        return;
+    }
+
+    if(((uint32_t)p & 3) == 0) {
+        uint32_t *w = (uint32_t *)p;
+
+        for(; words >= 4; words -= 4, w += 4) {
+            w[0] = *fifo;
+            w[1] = *fifo;
+            w[2] = *fifo;
+            w[3] = *fifo;
+        }
+
+        for(; words != 0; words--) *w++ = *fifo;
+
+        p = (uint8_t *)w;
+    } else {
+        for(; words != 0; words--, p += 4) __UNALIGNED_UINT32_Write(p, *fifo);
+    }
+
+    if(tail != 0) {
+        v = *fifo;
+
+        for(i = 0; i < tail; i++) p[i] = (uint8_t)(v >> (i * 8));
+    }
+}
+
+/**
+  * @brief  编程IN端点 n 的下一块, 打开其发送FIFO空中断
+  */
+static void UDC_In_Start(uint8_t n) {
+    UDC_EP *e = &udc_in[n];
+    OTG_eptin_Type *r = USB_INEPT(UDC_OTG, n);
+    uint32_t max = (n == 0) ? e->Mps : (uint32_t)UDC_PKTCNT_MAX * e->Mps;
+    uint32_t chunk = e->Len - e->Done;
+    uint32_t pkts;
+
+    if(chunk > max) chunk = max;
+
+    pkts = (chunk == 0) ? 1 : (chunk + e->Mps - 1) / e->Mps;
+
+    e->Chunk = chunk;
+    e->Fifo = 0;
+
+    r->dieptsiz = (pkts << 19) | chunk;
+    r->diepctl |= UDC_CTL_CNAK | UDC_CTL_EPENA;
+
+    if(chunk != 0) OTG_DEVICE(UDC_OTG)->diepempmsk |= 1 << n;
+}
+
+/**
+  * @brief  发送FIFO半空: 按剩余空间写入尽可能多的整包
+  */
+static void UDC_In_Fill(uint8_t n) {
+    UDC_EP *e = &udc_in[n];
+    OTG_eptin_Type *r = USB_INEPT(UDC_OTG, n);
+    uint32_t len;
+
+    while(e->Fifo < e->Chunk) {
+        len = e->Chunk - e->Fifo;
+
+        if(len > e->Mps) len = e->Mps;
+
+        if(r->dtxfsts_bit.ineptxfsav < (len + 3) / 4) break;
+
+        UDC_FIFO_Write(n, e->Buf + e->Done + e->Fifo, len);
+        e->Fifo += len;
+    }
+
+    if(e->Fifo >= e->Chunk) OTG_DEVICE(UDC_OTG)->diepempmsk &= ~(1 << n);
+
+    udc_stats.FifoFills++;
+}
+
+/**
+  * @brief  编程OUT端点 n 的下一块
+  */
+static void UDC_Out_Start(uint8_t n) {
+    UDC_EP *e = &udc_out[n];
+    OTG_eptout_Type *r = USB_OutEPT(UDC_OTG, n);
+    uint32_t max = (n == 0) ? e->Mps : (uint32_t)UDC_PKTCNT_MAX * e->Mps;
+    uint32_t chunk = e->Len - e->Done;
+
+    if(chunk > max) chunk = max;
+
+    chunk -= chunk % e->Mps;
+
+    e->Chunk = chunk;
+    e->Fifo = 0;
+
+    //端点0同时保持可以接收3个SETUP包
+    r->doeptsiz = ((chunk / e->Mps) << 19) | chunk | (n == 0 ? ((uint32_t)3 << 29) : 0);
+    r->doepctl |= UDC_CTL_CNAK | UDC_CTL_EPENA;
+}
+
+static void UDC_EP0_Send(const uint8_t *data, uint32_t len) {
+    udc_in[0].Buf = (uint8_t *)data;
+    udc_in[0].Len = len;
+    udc_in[0].Done = 0;
+    udc_in[0].Busy = 1;
+    UDC_In_Start(0);
+}
+
+static void UDC_EP0_Recv(uint32_t len) {
+    udc_out[0].Buf = (uint8_t *)udc_ep0_buf;
+    udc_out[0].Len = len < UDC_EP0_MPS ? UDC_EP0_MPS : len;
+    udc_out[0].Done = 0;
+    udc_out[0].Busy = 1;
+    UDC_Out_Start(0);
+}
+
+static void UDC_EP0_Stall(void) {
+    USB_INEPT(UDC_OTG, 0)->diepctl_bit.stall = TRUE;
+    USB_OutEPT(UDC_OTG, 0)->doepctl_bit.stall = TRUE;
+    udc_ep0_state = UDC_EP0_IDLE;
+    USB_EPT0_Start(UDC_OTG);
+}
+
+/**
+  * @brief  标准请求; 有IN数据阶段时给出数据和长度
+  * @retval ERROR: 不支持, 回STALL
+  */
+static error_status UDC_Std_Request(const UDC_Setup *req, const uint8_t **data, uint16_t *len) {
+    uint8_t recipient = req->bmRequestType & 0x1F;
+    uint8_t ep = req->wIndex & 0xFF;
+    uint8_t n = ep & 0x0F;
+
+    *data = 0;
+    *len = 0;
+
+    switch(req->bRequest) {
+        case 0x00:      //GET_STATUS
+            udc_reply[0] = 0;
+            udc_reply[1] = 0;
+
+            if(recipient == 2 && n < UDC_EP_NUM) {
+                if(ep & 0x80) udc_reply[0] = USB_INEPT(UDC_OTG, n)->diepctl_bit.stall;
+                else udc_reply[0] = USB_OutEPT(UDC_OTG, n)->doepctl_bit.stall;
+            }
+
+            *data = udc_reply;
+            *len = 2;
+            return SUCCESS;
+
+        case 0x01:      //CLEAR_FEATURE
+        case 0x03:      //SET_FEATURE
+            //端点HALT; 设备远程唤醒等其他特性直接应答
+            if(recipient == 2 && req->wValue == 0 && n != 0 && n < UDC_EP_NUM)
+                UDC_EP_Stall(ep, req->bRequest == 0x03 ? TRUE : FALSE);
+
+            return SUCCESS;
+
+        case 0x05:      //SET_ADDRESS, 从模式下在状态阶段之前设置
+            USB_Set_Address(UDC_OTG, req->wValue & 0x7F);
+            return SUCCESS;
+
+        case 0x06:      //GET_DESCRIPTOR
+            *data = udc_cls->Descriptor(req->wValue >> 8, req->wValue & 0xFF, len);
+            return *data ? SUCCESS : ERROR;
+
+        case 0x08:      //GET_CONFIGURATION
+            udc_reply[0] = udc_cfg;
+            *data = udc_reply;
+            *len = 1;
+            return SUCCESS;
+
+        case 0x09:      //SET_CONFIGURATION
+            if(req->wValue > 1) return ERROR;
+
+            if(udc_cfg != req->wValue) {
+                if(udc_cfg != 0) udc_cls->Configured(0);
+
+                udc_cfg = req->wValue;
+
+                if(udc_cfg != 0) udc_cls->Configured(udc_cfg);
+            }
+
+            return SUCCESS;
+
+        case 0x0A:      //GET_INTERFACE
+            udc_reply[0] = 0;
+            *data = udc_reply;
+            *len = 1;
+            return SUCCESS;
+
+        case 0x0B:      //SET_INTERFACE, 只有备用设置0
+            return req->wValue == 0 ? SUCCESS : ERROR;
+
+        default:
+            return ERROR;
+    }
+}
+
+/**
+  * @brief  收到SETUP包, 分发请求并进入数据或状态阶段
+  */
+static void UDC_EP0_Setup(void) {
+    const UDC_Setup *req = &udc_setup;
+    const uint8_t *data = 0;
+    uint16_t len = 0;
+    uint8_t *cls_data = 0;
+    error_status ok;
+
+    udc_setup.bmRequestType = udc_setup_raw[0] & 0xFF;
+    udc_setup.bRequest = (udc_setup_raw[0] >> 8) & 0xFF;
+    udc_setup.wValue = udc_setup_raw[0] >> 16;
+    udc_setup.wIndex = udc_setup_raw[1] & 0xFFFF;
+    udc_setup.wLength = udc_setup_raw[1] >> 16;
+    udc_stats.Setups++;
+
+    //新的SETUP中止未完成的控制传输
+    udc_in[0].Busy = 0;
+    udc_out[0].Busy = 0;
+
+    if((req->bmRequestType & 0x60) == 0) {
+        ok = UDC_Std_Request(req, &data, &len);
+    } else {
+        ok = udc_cls->Setup(req, &cls_data, &len);
+        data = cls_data;
+    }
+
+    if(ok != SUCCESS) {
+        UDC_EP0_Stall();
+        return;
+    }
+
+    if(req->wLength == 0) {
+        udc_ep0_state = UDC_EP0_STATUS_IN;
+        UDC_EP0_Send(0, 0);
+    } else if(req->bmRequestType & 0x80) {
+        if(len > req->wLength) len = req->wLength;
+
+        //比主机要求的短且是整包时, 以零长度包结束
+        udc_ep0_zlp = (len < req->wLength && len != 0 && (len % UDC_EP0_MPS) == 0) ? 1 : 0;
+        udc_ep0_state = UDC_EP0_DATA_IN;
+        UDC_EP0_Send(data, len);
+    } else {
+        if(req->wLength > UDC_EP0_MPS) {
+            UDC_EP0_Stall();
+            return;
+        }
+
+        udc_ep0_state = UDC_EP0_DATA_OUT;
+        UDC_EP0_Recv(req->wLength);
+    }
+}
+
+/**
+  * @brief  端点0 IN阶段完成
+  */
+static void UDC_EP0_In_Done(void) {
+    if(udc_ep0_state == UDC_EP0_DATA_IN) {
+        if(udc_ep0_zlp) {
+            udc_ep0_zlp = 0;
+            UDC_EP0_Send(0, 0);
+            return;
+        }
+
+        udc_ep0_state = UDC_EP0_STATUS_OUT;
+        UDC_EP0_Recv(0);
+    } else {
+        udc_ep0_state = UDC_EP0_IDLE;
+        USB_EPT0_Start(UDC_OTG);
+    }
+}
+
+/**
+  * @brief  端点0 OUT阶段完成
+  */
+static void UDC_EP0_Out_Done(uint32_t len) {
+    if(udc_ep0_state == UDC_EP0_DATA_OUT) {
+        if(udc_cls->EP0_RxReady) udc_cls->EP0_RxReady(&udc_setup, (const uint8_t *)udc_ep0_buf, len);
+
+        udc_ep0_state = UDC_EP0_STATUS_IN;
+        UDC_EP0_Send(0, 0);
+    } else {
+        udc_ep0_state = UDC_EP0_IDLE;
+        USB_EPT0_Start(UDC_OTG);
+    }
+}
+
+/**
+  * @brief  IN端点 n 的一块发送完成
+  */
+static void UDC_In_Done(uint8_t n) {
+    UDC_EP *e = &udc_in[n];
+
+    if(e->Busy == 0) return;
+
+    e->Done += e->Chunk;
+
+    if(e->Done < e->Len) {
+        UDC_In_Start(n);
+        return;
+    }
+
+    e->Busy = 0;
+
+    if(n == 0) {
+        UDC_EP0_In_Done();
+        return;
+    }
+
+    udc_stats.InBytes += e->Len;
+    udc_stats.Transfers++;
+
+    if(udc_cls->InDone) udc_cls->InDone(UDC_EP_IN(n), e->Len);
+}
+
+/**
+  * @brief  OUT端点 n 的一块接收完成(收满或短包)
+  */
+static void UDC_Out_Done(uint8_t n) {
+    UDC_EP *e = &udc_out[n];
+    uint32_t got = e->Fifo;
+
+    if(e->Busy == 0) return;
+
+    e->Done += got;
+
+    if(got == e->Chunk && e->Done < e->Len) {
+        UDC_Out_Start(n);
+        return;
+    }
+
+    e->Busy = 0;
+
+    if(n == 0) {
+        UDC_EP0_Out_Done(e->Done);
+        return;
+    }
+
+    udc_stats.OutBytes += e->Done;
+    udc_stats.Transfers++;
+
+    if(udc_cls->OutDone) udc_cls->OutDone(UDC_EP_OUT(n), e->Done);
+}
+
+/**
+  * @brief  接收FIFO非空: 取出一个状态, 把数据读入对应端点的缓冲区
+  */
+static void UDC_Rx_Level(void) {
+    uint32_t sts, n, bcnt, room;
+    UDC_EP *e;
+
+    UDC_OTG->gintmsk_bit.rxflvlmsk = FALSE;
+
+    sts = UDC_OTG->grxstsp;
+    n = sts & USB_OTG_GRXSTSP_EPTNUM;
+    bcnt = (sts & USB_OTG_GRXSTSP_BCNT) >> 4;
+
+    switch((sts & USB_OTG_GRXSTSP_PKTSTS) >> 17) {
+        case USB_Out_STS_DATA:
+            if(bcnt == 0) break;
+
+            if(n >= UDC_EP_NUM) {
+                UDC_FIFO_Read(0, bcnt);
+                break;
+            }
+
+            e = &udc_out[n];
+            room = (e->Busy && e->Fifo < e->Chunk) ? e->Chunk - e->Fifo : 0;
+
+            if(bcnt <= room) {
+                UDC_FIFO_Read(e->Buf + e->Done + e->Fifo, bcnt);
+                e->Fifo += bcnt;
+            } else {
+                UDC_FIFO_Read(0, bcnt);
+            }
+
+            break;
+
+        case USB_SetUP_STS_DATA:
+            udc_setup_raw[0] = USB_FIFO(UDC_OTG, 0);
+            udc_setup_raw[1] = USB_FIFO(UDC_OTG, 0);
+            break;
+
+        default:
+            break;
+    }
+
+    UDC_OTG->gintmsk_bit.rxflvlmsk = TRUE;
+}
+
+/**
+  * @brief  总线复位: 清除端点状态, 只留端点0
+  */
+static void UDC_Reset(void) {
+    OTG_Device_Type *dev = OTG_DEVICE(UDC_OTG);
+    uint8_t n;
+
+    dev->dctl_bit.rwkupsig = FALSE;
+    USB_Flush_TX_FIFO(UDC_OTG, 0x10);
+
+    for(n = 0; n < UDC_EP_NUM; n++) {
+        USB_INEPT(UDC_OTG, n)->diepint = 0xFF;
+        USB_OutEPT(UDC_OTG, n)->doepint = 0xFF;
+        USB_OutEPT(UDC_OTG, n)->doepctl |= UDC_CTL_SNAK;
+        udc_in[n].Busy = 0;
+        udc_out[n].Busy = 0;
+    }
+
+    dev->daint = 0xFFFFFFFF;
+    dev->daintmsk = 0x00010001;
+    dev->doepmsk = USB_OTG_DOEPINT_SetUP_FLAG | USB_OTG_DOEPINT_XFERC_FLAG;
+    dev->diepmsk = USB_OTG_DIEPINT_XFERC_FLAG | USB_OTG_DIEPINT_TimeOut_FLAG;
+    dev->diepempmsk = 0;
+
+    USB_Set_Address(UDC_OTG, 0);
+    USB_EPT0_Start(UDC_OTG);
+
+    if(udc_cfg != 0) udc_cls->Configured(0);
+
+    udc_cfg = 0;
+    udc_ep0_state = UDC_EP0_IDLE;
+    udc_stats.Resets++;
+}
+
+/**
+  * @brief  配置引脚、OTGFS内核、FIFO和中断, 然后接上D+上拉
+  * @param  cls: 类层回调
+  * @param  preempt: 抢占优先级
+  * @param  sub: 子优先级
+  * @retval 无
+  */
+void UDC_Init(const UDC_Class *cls, uint32_t preempt, uint32_t sub) {
+    GPIO_Init_Type GPIO_Init_struct;
+    OTG_Device_Type *dev = OTG_DEVICE(UDC_OTG);
+    uint32_t t0;
+    uint8_t n;
+
+    udc_cls = cls;
+    udc_cfg = 0;
+    udc_ep0_state = UDC_EP0_IDLE;
+
+    for(n = 0; n < UDC_EP_NUM; n++) {
+        udc_in[n].Busy = 0;
+        udc_out[n].Busy = 0;
+    }
+
+    udc_in[0].Mps = UDC_EP0_MPS;
+    udc_out[0].Mps = UDC_EP0_MPS;
+
+    udc_stats.Resets = 0;
+    udc_stats.Setups = 0;
+    udc_stats.InBytes = 0;
+    udc_stats.OutBytes = 0;
+    udc_stats.Transfers = 0;
+    udc_stats.FifoFills = 0;
+    udc_stats.IrqCycles = 0;
+
+    CRM_Periph_Clock_Enable(UDC_CRM_GPIO, TRUE);
+    CRM_Periph_Clock_Enable(UDC_CRM_OTG, TRUE);
+
+    GPIO_Default_Para_Init(&GPIO_Init_struct);
+    GPIO_Init_struct.GPIO_Pins = UDC_DM_PIN | UDC_DP_PIN;
+    GPIO_Init_struct.GPIO_Mode = GPIO_Mode_MUX;
+    GPIO_Init_struct.GPIO_Out_Type = GPIO_OutPut_PUSH_PULL;
+    GPIO_Init_struct.GPIO_Pull = GPIO_Pull_NONE;
+    GPIO_Init_struct.GPIO_Drive_Strength = GPIO_Drive_Strength_STRONGER;
+    GPIO_Init(UDC_GPIO_PORT, &GPIO_Init_struct);
+    GPIO_Pin_Mux_Config(UDC_GPIO_PORT, UDC_DM_PINSRC, UDC_GPIO_MUX);
+    GPIO_Pin_Mux_Config(UDC_GPIO_PORT, UDC_DP_PINSRC, UDC_GPIO_MUX);
+
+    CoreDebug->DEMCR |= CoreDEBUG_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_Ctrl_CYCCNTENA_Msk;
+
+    USB_Interrupt_Disable(UDC_OTG);
+    USB_Global_Init(UDC_OTG);
+    USB_Global_Set_Mode(UDC_OTG, OTG_Device_Mode);
+
+    //强制设备模式后至少等待25ms
+    t0 = DWT->CYCCNT;
+
+    while(DWT->CYCCNT - t0 < system_Core_clock / 40);
+
+    UDC_OTG->gccfg_bit.vbusig = TRUE;
+    OTG_PCGCCTL(UDC_OTG)->pcgcctl = 0;
+    dev->dcfg_bit.devspd = USB_DCFG_FULL_SPEED;
+    dev->dcfg_bit.perfrint = DCFG_PERFRINT_80;
+
+    USB_Set_RX_FIFO(UDC_OTG, UDC_RX_FIFO);
+    USB_Set_TX_FIFO(UDC_OTG, 0, UDC_TX_FIFO0);
+    USB_Set_TX_FIFO(UDC_OTG, 1, UDC_TX_FIFO1);
+    USB_Set_TX_FIFO(UDC_OTG, 2, UDC_TX_FIFO2);
+    USB_Set_TX_FIFO(UDC_OTG, 3, UDC_TX_FIFO3);
+    USB_Flush_TX_FIFO(UDC_OTG, 0x10);
+    USB_Flush_RX_FIFO(UDC_OTG);
+
+    for(n = 0; n < USB_EPT_MAX_Num; n++) {
+        if(USB_INEPT(UDC_OTG, n)->diepctl_bit.eptena) USB_INEPT(UDC_OTG, n)->diepctl = UDC_CTL_EPDIS | UDC_CTL_SNAK;
+        else USB_INEPT(UDC_OTG, n)->diepctl = 0;
+
+        if(USB_OutEPT(UDC_OTG, n)->doepctl_bit.eptena) USB_OutEPT(UDC_OTG, n)->doepctl = UDC_CTL_EPDIS | UDC_CTL_SNAK;
+        else USB_OutEPT(UDC_OTG, n)->doepctl = 0;
+
+        USB_INEPT(UDC_OTG, n)->dieptsiz = 0;
+        USB_INEPT(UDC_OTG, n)->diepint = 0xFF;
+        USB_OutEPT(UDC_OTG, n)->doeptsiz = 0;
+        USB_OutEPT(UDC_OTG, n)->doepint = 0xFF;
+    }
+
+    dev->diepmsk = 0;
+    dev->doepmsk = 0;
+    dev->daint = 0xFFFFFFFF;
+    dev->daintmsk = 0;
+    dev->diepempmsk = 0;
+
+    //nptxfemplvl 保持为0: 发送FIFO半空即中断, 总线上的包和CPU写FIFO重叠
+    UDC_OTG->gintsts = 0xFFFFFFFF;
+    UDC_OTG->gintmsk = USB_OTG_RXFLVL_INT | USB_OTG_USBSUSP_INT | USB_OTG_USBRST_INT | USB_OTG_ENUMDONE_INT |
+                       USB_OTG_IEPT_INT | USB_OTG_OEPT_INT | USB_OTG_WKUP_INT;
+
+    USB_Interrupt_Enable(UDC_OTG);
+    NVIC_IRQ_Enable(UDC_IRQn, preempt, sub);
+    USB_Connect(UDC_OTG);
+}
+
+/**
+  * @brief  打开端点, 在类层的 Configured 回调中调用
+  * @param  ep: 端点地址, UDC_EP_IN(n)/UDC_EP_OUT(n), n 为 1~UDC_EP_NUM-1
+  * @param  type: EPT_BULK_Type、EPT_INT_Type
+  * @param  mps: 最大包长
+  * @retval 无
+  */
+void UDC_EP_Open(uint8_t ep, uint8_t type, uint16_t mps) {
+    uint8_t n = ep & 0x0F;
+
+    if(n == 0 || n >= UDC_EP_NUM) return;
+
+    if(ep & 0x80) {
+        OTG_eptin_Type *r = USB_INEPT(UDC_OTG, n);
+
+        udc_in[n].Mps = mps;
+        udc_in[n].Busy = 0;
+        OTG_DEVICE(UDC_OTG)->daintmsk |= 1 << n;
+        r->diepctl_bit.mps = mps;
+        r->diepctl_bit.eptype = type;
+        r->diepctl_bit.txfnum = n;
+        r->diepctl_bit.setd0pid = TRUE;
+        r->diepctl_bit.usbacept = TRUE;
+    } else {
+        OTG_eptout_Type *r = USB_OutEPT(UDC_OTG, n);
+
+        udc_out[n].Mps = mps;
+        udc_out[n].Busy = 0;
+        OTG_DEVICE(UDC_OTG)->daintmsk |= (1 << n) << 16;
+        r->doepctl_bit.mps = mps;
+        r->doepctl_bit.eptype = type;
+        r->doepctl_bit.setd0pid = TRUE;
+        r->doepctl_bit.usbacept = TRUE;
+    }
+}
+
+/**
+  * @brief  关闭端点, 丢弃未完成的传输
+  * @param  ep: 端点地址
+  * @retval 无
+  */
+void UDC_EP_Close(uint8_t ep) {
+    uint8_t n = ep & 0x0F;
+
+    if(n == 0 || n >= UDC_EP_NUM) return;
+
+    if(ep & 0x80) {
+        OTG_eptin_Type *r = USB_INEPT(UDC_OTG, n);
+
+        OTG_DEVICE(UDC_OTG)->daintmsk &= ~(1 << n);
+        OTG_DEVICE(UDC_OTG)->diepempmsk &= ~(1 << n);
+
+        if(r->diepctl_bit.eptena) r->diepctl |= UDC_CTL_SNAK | UDC_CTL_EPDIS;
+
+        r->diepctl_bit.usbacept = FALSE;
+        USB_Flush_TX_FIFO(UDC_OTG, n);
+        udc_in[n].Busy = 0;
+    } else {
+        OTG_eptout_Type *r = USB_OutEPT(UDC_OTG, n);
+
+        OTG_DEVICE(UDC_OTG)->daintmsk &= ~((1 << n) << 16);
+
+        if(r->doepctl_bit.eptena) r->doepctl |= UDC_CTL_SNAK | UDC_CTL_EPDIS;
+
+        r->doepctl_bit.usbacept = FALSE;
+        udc_out[n].Busy = 0;
+    }
+}
+
+/**
+  * @brief  在IN端点上发送, 整个传输一次编程, 完成时调用类层 InDone
+  * @param  ep: UDC_EP_IN(n)
+  * @param  buf: 数据, 完成前不能改动; 4字节对齐时FIFO写入最快
+  * @param  len: 字节数, 0 发零长度包
+  * @retval ERROR: 端点忙或未打开
+  */
+error_status UDC_EP_Transmit(uint8_t ep, const uint8_t *buf, uint32_t len) {
+    uint8_t n = ep & 0x0F;
+    UDC_EP *e = &udc_in[n];
+    uint32_t primask;
+
+    if(n == 0 || n >= UDC_EP_NUM || (ep & 0x80) == 0) return ERROR;
+
+    primask = __Get_PRIMASK();
+    __Disable_irq();
+
+    if(e->Busy || USB_INEPT(UDC_OTG, n)->diepctl_bit.usbacept == 0) {
+        __Set_PRIMASK(primask);
+        return ERROR;
+    }
+
+    e->Buf = (uint8_t *)buf;
+    e->Len = len;
+    e->Done = 0;
+    e->Busy = 1;
+    UDC_In_Start(n);
+
+    __Set_PRIMASK(primask);
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  在OUT端点上接收, 收满 len 字节或收到短包时调用类层 OutDone
+  * @param  ep: UDC_EP_OUT(n)
+  * @param  buf: 缓冲区, 4字节对齐时FIFO读出最快
+  * @param  len: 缓冲区字节数, 须为最大包长的整数倍
+  * @retval ERROR: 端点忙、未打开或 len 不合法
+  */
+error_status UDC_EP_Receive(uint8_t ep, uint8_t *buf, uint32_t len) {
+    uint8_t n = ep & 0x0F;
+    UDC_EP *e = &udc_out[n];
+    uint32_t primask;
+
+    if(n == 0 || n >= UDC_EP_NUM || (ep & 0x80) != 0) return ERROR;
+
+    if(len == 0 || (len % e->Mps) != 0) return ERROR;
+
+    primask = __Get_PRIMASK();
+    __Disable_irq();
+
+    if(e->Busy || USB_OutEPT(UDC_OTG, n)->doepctl_bit.usbacept == 0) {
+        __Set_PRIMASK(primask);
+        return ERROR;
+    }
+
+    e->Buf = buf;
+    e->Len = len;
+    e->Done = 0;
+    e->Busy = 1;
+    UDC_Out_Start(n);
+
+    __Set_PRIMASK(primask);
+
+    return SUCCESS;
+}
+
+/**
+  * @brief  查询端点上是否有未完成的传输
+  * @param  ep: 端点地址
+  * @retval SET: 忙
+  */
+flag_status UDC_EP_Busy(uint8_t ep) {
+    uint8_t n = ep & 0x0F;
+
+    if(n >= UDC_EP_NUM) return RESET;
+
+    if(ep & 0x80) return udc_in[n].Busy ? SET : RESET;
+
+    return udc_out[n].Busy ? SET : RESET;
+}
+
+/**
+  * @brief  设置或清除端点STALL, 清除时数据PID复位为DATA0
+  * @param  ep: 端点地址
+  * @param  state: TRUE 设置
+  * @retval 无
+  */
+void UDC_EP_Stall(uint8_t ep, confirm_state state) {
+    uint8_t n = ep & 0x0F;
+
+    if(n >= UDC_EP_NUM) return;
+
+    if(ep & 0x80) {
+        USB_INEPT(UDC_OTG, n)->diepctl_bit.stall = state;
+
+        if(state == FALSE) USB_INEPT(UDC_OTG, n)->diepctl_bit.setd0pid = TRUE;
+    } else {
+        USB_OutEPT(UDC_OTG, n)->doepctl_bit.stall = state;
+
+        if(state == FALSE) USB_OutEPT(UDC_OTG, n)->doepctl_bit.setd0pid = TRUE;
+    }
+}
+
+/**
+  * @brief  当前配置值
+  * @param  无
+  * @retval 0: 未配置
+  */
+uint8_t UDC_Configured(void) {
+    return udc_cfg;
+}
+
+/**
+  * @brief  读取统计计数
+  * @param  stats: 输出
+  * @retval 无
+  */
+void UDC_GetStats(UDC_Stats *stats) {
+    *stats = udc_stats;
+}
+
+/**
+  * @brief  OTGFS中断
+  * @param  无
+  * @retval 无
+  */
+void UDC_IRQHandler(void) {
+    uint32_t t0 = DWT->CYCCNT;
+    uint32_t sts = USB_Global_Get_All_Interrupt(UDC_OTG);
+    uint32_t eps, flags;
+    uint8_t n;
+
+    if(sts & USB_OTG_RXFLVL_FLAG) UDC_Rx_Level();
+
+    if(sts & USB_OTG_OEPT_FLAG) {
+        eps = USB_Get_All_Out_Interrupt(UDC_OTG);
+
+        for(n = 0; eps != 0; n++, eps >>= 1) {
+            if((eps & 1) == 0) continue;
+
+            flags = USB_EPT_Out_Interrupt(UDC_OTG, n);
+
+            //状态阶段的完成先于新的SETUP处理
+            if(flags & USB_OTG_DOEPINT_XFERC_FLAG) {
+                USB_EPT_Out_Clear(UDC_OTG, n, USB_OTG_DOEPINT_XFERC_FLAG);
+                UDC_Out_Done(n);
+            }
+
+            if(flags & USB_OTG_DOEPINT_SetUP_FLAG) {
+                USB_EPT_Out_Clear(UDC_OTG, n, USB_OTG_DOEPINT_SetUP_FLAG);
+                UDC_EP0_Setup();
+            }
+        }
+    }
+
+    if(sts & USB_OTG_IEPT_FLAG) {
+        eps = USB_Get_All_In_Interrupt(UDC_OTG);
+
+        for(n = 0; eps != 0; n++, eps >>= 1) {
+            if((eps & 1) == 0) continue;
+
+            flags = USB_EPT_In_Interrupt(UDC_OTG, n);
+
+            if(flags & USB_OTG_DIEPINT_XFERC_FLAG) {
+                OTG_DEVICE(UDC_OTG)->diepempmsk &= ~(1 << n);
+                USB_EPT_In_Clear(UDC_OTG, n, USB_OTG_DIEPINT_XFERC_FLAG);
+                UDC_In_Done(n);
+            }
+
+            if(flags & USB_OTG_DIEPINT_TimeOut_FLAG) USB_EPT_In_Clear(UDC_OTG, n, USB_OTG_DIEPINT_TimeOut_FLAG);
+
+            if((flags & USB_OTG_DIEPINT_TXFEMP_FLAG) && udc_in[n].Busy) UDC_In_Fill(n);
+        }
+    }
+
+    if(sts & USB_OTG_USBRST_FLAG) {
+        USB_Global_Clear_Interrupt(UDC_OTG, USB_OTG_USBRST_FLAG);
+        UDC_Reset();
+    }
+
+    if(sts & USB_OTG_ENUMDONE_FLAG) {
+        USB_Global_Clear_Interrupt(UDC_OTG, USB_OTG_ENUMDONE_FLAG);
+        USB_EPT0_Setup(UDC_OTG);
+        UDC_OTG->gusbcfg_bit.usbtrdtim = USB_TRDTIM_16;
+    }
+
+    if(sts & (USB_OTG_USBSUSP_FLAG | USB_OTG_WKUP_FLAG))
+        USB_Global_Clear_Interrupt(UDC_OTG, sts & (USB_OTG_USBSUSP_FLAG | USB_OTG_WKUP_FLAG));
+
+    udc_stats.IrqCycles += DWT->CYCCNT - t0;
+}
@@ -0,0 +1,104 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : usbd_core.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : OTGFS设备内核: 枚举和标准请求, 端点一次编程多包传输, 由发送FIFO空中断
+  *				   连续补满FIFO, 接收数据从FIFO直接读入用户缓冲区; 类请求和端点完成交给类层
+  * Function List:
+  *		UDC_Init
+  *		UDC_EP_Open
+  *		UDC_EP_Close
+  *		UDC_EP_Transmit
+  *		UDC_EP_Receive
+  *		UDC_EP_Busy
+  *		UDC_EP_Stall
+  *		UDC_Configured
+  *		UDC_GetStats
+  *		UDC_IRQHandler
+  ******************************************************
+**/
+
+#ifndef __USBD_CORE_H_
+#define __USBD_CORE_H_
+
+#include "at32f435_437.h"
+
+//OTGFS1: PA11=D-, PA12=D+, 中断服务函数在usbd_core.c中实现
+#define UDC_OTG                     OTG1_GLOBAL
+#define UDC_CRM_OTG                 CRM_OTGFS1_Periph_CLOCK
+#define UDC_GPIO_PORT               GPIOA
+#define UDC_CRM_GPIO                CRM_GPIOA_Periph_CLOCK
+#define UDC_DM_PIN                  GPIO_Pins_11
+#define UDC_DP_PIN                  GPIO_Pins_12
+#define UDC_DM_PINSRC               GPIO_Pins_SOURCE11
+#define UDC_DP_PINSRC               GPIO_Pins_SOURCE12
+#define UDC_GPIO_MUX                GPIO_MUX_10
+#define UDC_IRQn                    OTGFS1_IRQn
+#define UDC_IRQHandler              OTGFS1_IRQHandler
+
+//FIFO分配, 单位为字, 合计不超过 OTG_FIFO_SIZE(320)
+#define UDC_RX_FIFO                 128     //所有OUT端点共用, 至少能放下两个最大包
+#define UDC_TX_FIFO0                16
+#define UDC_TX_FIFO1                64      //批量IN端点放4个包, FIFO半空时中断补满
+#define UDC_TX_FIFO2                16
+#define UDC_TX_FIFO3                64
+
+#define UDC_EP_NUM                  4       //使用的端点号 0~3
+#define UDC_EP0_MPS                 64
+
+//端点号, 最高位为1表示IN
+#define UDC_EP_IN(n)                (0x80 | (n))
+#define UDC_EP_OUT(n)               (n)
+
+typedef struct {
+    uint8_t  bmRequestType;
+    uint8_t  bRequest;
+    uint16_t wValue;
+    uint16_t wIndex;
+    uint16_t wLength;
+} UDC_Setup;
+
+//类层回调, 都在USB中断中调用
+typedef struct {
+    //返回描述符, 不存在返回0
+    const uint8_t *(*Descriptor)(uint8_t type, uint8_t index, uint16_t *len);
+    //类请求和厂商请求; 有IN数据阶段时给出 *data/*len, OUT数据阶段(不超过64字节)收完后调用 EP0_RxReady; 不支持返回 ERROR(回STALL)
+    error_status (*Setup)(const UDC_Setup *req, uint8_t **data, uint16_t *len);
+    //OUT数据阶段收完
+    void (*EP0_RxReady)(const UDC_Setup *req, const uint8_t *data, uint16_t len);
+    //SET_CONFIGURATION, cfg 为0或总线复位时表示退出配置状态, 类层在此打开/关闭端点
+    void (*Configured)(uint8_t cfg);
+    //端点传输完成, len 为实际收发字节数
+    void (*InDone)(uint8_t ep, uint32_t len);
+    void (*OutDone)(uint8_t ep, uint32_t len);
+} UDC_Class;
+
+typedef struct {
+    uint32_t Resets;                //总线复位次数
+    uint32_t Setups;                //处理的SETUP包数
+    uint32_t InBytes;               //非0端点发送的字节数
+    uint32_t OutBytes;              //非0端点接收的字节数
+    uint32_t Transfers;             //非0端点完成的传输数
+    uint32_t FifoFills;             //发送FIFO空中断中补FIFO的次数
+    uint32_t IrqCycles;             //USB中断累计占用的CPU周期
+} UDC_Stats;
+
+void UDC_Init(const UDC_Class *cls, uint32_t preempt, uint32_t sub);	// 配置引脚/内核/FIFO并连接; 48MHz USB时钟须已由调用者配置
+void UDC_EP_Open(uint8_t ep, uint8_t type, uint16_t mps);	// 打开端点, type 为 EPT_BULK_Type 等
+void UDC_EP_Close(uint8_t ep);		// 关闭端点, 未完成的传输被丢弃
+error_status UDC_EP_Transmit(uint8_t ep, const uint8_t *buf, uint32_t len);	// 发送, len 为0时发零长度包; 端点忙返回 ERROR
+error_status UDC_EP_Receive(uint8_t ep, uint8_t *buf, uint32_t len);	// 接收, len 须为最大包长的整数倍; 收到短包或收满时完成
+flag_status UDC_EP_Busy(uint8_t ep);	// 端点上有未完成的传输返回 SET
+void UDC_EP_Stall(uint8_t ep, confirm_state state);	// 设置/清除端点STALL
+uint8_t UDC_Configured(void);		// 返回当前配置值, 0 表示未配置
+void UDC_GetStats(UDC_Stats *stats);	// 读取统计计数
+
+#endif
@@ -0,0 +1,253 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : dci_capture.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					三个帧缓冲分别处于三种状态: DMA正在写, 最新完成(等待取走), 使用者
+					正在读. 每帧结束(DCI EF中断, 处于场消隐期间)时停下DMA, 检查长度,
+					把刚写完的缓冲和"最新完成"交换, 再让DMA去写换出来的那个. 使用者
+					用 LDREX/STREX 把自己手中的缓冲和"最新完成"交换, 双方都不需要等待
+					对方, 也不会读到正在写的帧. 使用者处理慢时中间的帧被覆盖, 计入
+					Dropped, 延迟不超过一帧.
+					JPEG模式下帧长度从DMA剩余计数得到, 超出缓冲区的帧丢弃.
+  * Function List:
+  *		DCI_Cap_Struct_Para_Init
+  *		DCI_Cap_Init
+  *		DCI_Cap_Start
+  *		DCI_Cap_Stop
+  *		DCI_Cap_Snapshot
+  *		DCI_Cap_Acquire
+  *		DCI_Cap_GetStats
+  *		DCI_IRQHandler
+  **********************************************************
+ */
+
+#include "dci_capture.h"
+
+#define DCI_CAP_FRESH			0x80	//"最新完成"中的帧还没被取走
+#define DCI_CAP_INDEX			0x03
+
+typedef struct {
+    DCI_Cap_Frame frame[DCI_CAP_BUF_NUM];
+    uint32_t size;
+    uint8_t  jpeg;
+    uint8_t  snapshot;
+    uint8_t  write;					//DMA正在写的缓冲, 只有中断修改
+    uint8_t  read;					//使用者手中的缓冲, 只有使用者修改
+    volatile uint32_t latest;		//最新完成的缓冲 | DCI_CAP_FRESH, 双方交换
+    volatile uint8_t bad;			//本帧发生过溢出/同步错误
+    volatile uint8_t running;
+    uint32_t seq;
+} DCI_Cap_Handle;
+
+static DCI_Cap_Handle cap;
+static DCI_Cap_Stats cap_stats;
+
+//让DMA从头写 cap.write 指向的缓冲
+static void DCI_Cap_Arm(void) {
+    DMA_Flag_Clear(DCI_CAP_DMA, DCI_CAP_DMA_CH, DCI_CAP_DMA_FLAGS);
+    DMA_Memory_Address_Config(DCI_CAP_DMA, DCI_CAP_DMA_CH, DMA_Memory_0, (uint32_t)cap.frame[cap.write].Data);
+    DMA_Transfer_Number_Config(DCI_CAP_DMA, DCI_CAP_DMA_CH, cap.size / 4);
+    DMA_Channel_Enable(DCI_CAP_DMA, DCI_CAP_DMA_CH);
+    cap.bad = 0;
+}
+
+//停下DMA(FIFO中剩余的数据会写入存储器), 返回本帧写入的字节数
+static uint32_t DCI_Cap_Halt(void) {
+    DMA_Channel_Disable(DCI_CAP_DMA, DCI_CAP_DMA_CH);
+
+    while(DMA_CHCTL(DCI_CAP_DMA, DCI_CAP_DMA_CH) & DMA_CHXCTL_CHEN);
+
+    return cap.size - DMA_Transfer_Number_Get(DCI_CAP_DMA, DCI_CAP_DMA_CH) * 4;
+}
+
+//一帧结束: 检查后与"最新完成"交换, 被换下的未取走帧计为丢弃
+static void DCI_Cap_FrameDone(void) {
+    uint32_t len = DCI_Cap_Halt();
+    uint32_t old;
+
+    if(cap.bad || len == 0 || (cap.jpeg ? len == cap.size : len != cap.size)) {
+        cap_stats.Errors++;
+    } else {
+        cap.frame[cap.write].Length = len;
+        cap.frame[cap.write].Seq = ++cap.seq;
+
+        old = cap.latest;
+        cap.latest = cap.write | DCI_CAP_FRESH;
+        cap.write = old & DCI_CAP_INDEX;
+        cap_stats.Frames++;
+
+        if(old & DCI_CAP_FRESH) cap_stats.Dropped++;
+    }
+
+    if(cap.snapshot) cap.running = 0;
+    else DCI_Cap_Arm();
+}
+
+void DCI_Cap_Struct_Para_Init(DCI_Cap_Parameter_Struct * init_Struct) {
+    uint8_t i;
+
+    for(i = 0; i < DCI_CAP_BUF_NUM; i++) init_Struct->Buffer[i] = 0;
+
+    init_Struct->BufSize = 0;
+    init_Struct->clock_polarity = DCI_CK_Polarity_RISING;
+    init_Struct->hsync_polarity = DCI_HSYNC_Polarity_LOW;
+    init_Struct->vsync_polarity = DCI_VSYNC_Polarity_LOW;
+    init_Struct->frame_rate = DCI_Frame_RATE_ALL;
+    init_Struct->Jpeg = 0;
+    init_Struct->Snapshot = 0;
+    init_Struct->CropX = 0;
+    init_Struct->CropY = 0;
+    init_Struct->CropW = 0;
+    init_Struct->CropH = 0;
+    init_Struct->BytesPerPixel = 2;
+}
+
+ErrStatus DCI_Cap_Init(DCI_Cap_Parameter_Struct * init_Struct) {
+    DCI_Parameter_Struct DCI_InitStruct;
+    DMA_Multi_Data_Parameter_Struct DMA_InitStruct;
+    uint32_t size = init_Struct->BufSize;
+    uint8_t i;
+
+    if(size == 0 || (size & 3) != 0 || size > DCI_CAP_BUF_MAX) return ERROR;
+
+    for(i = 0; i < DCI_CAP_BUF_NUM; i++) {
+        if(init_Struct->Buffer[i] == 0 || ((uint32_t)init_Struct->Buffer[i] & 3) != 0) return ERROR;
+
+        cap.frame[i].Data = init_Struct->Buffer[i];
+        cap.frame[i].Length = 0;
+        cap.frame[i].Seq = 0;
+    }
+
+    if(init_Struct->CropW != 0 &&
+            (init_Struct->CropH == 0 || init_Struct->BytesPerPixel == 0 ||
+             (uint32_t)init_Struct->CropW * init_Struct->BytesPerPixel > 0x4000 || init_Struct->CropH > 0x4000)) return ERROR;
+
+    cap.size = size;
+    cap.jpeg = init_Struct->Jpeg;
+    cap.snapshot = init_Struct->Snapshot;
+    cap.write = 0;
+    cap.latest = 1;
+    cap.read = 2;
+    cap.running = 0;
+    cap.seq = 0;
+    cap_stats.Frames = 0;
+    cap_stats.Dropped = 0;
+    cap_stats.Errors = 0;
+    cap_stats.Overruns = 0;
+
+    RCU_Periph_Clock_Enable(RCU_DCI);
+    RCU_Periph_Clock_Enable(RCU_DMA1);
+
+    DCI_DeInit();
+    DCI_InitStruct.capture_mode = cap.snapshot ? DCI_Capture_Mode_SNAPSHOT : DCI_Capture_Mode_CONTINUOUS;
+    DCI_InitStruct.clock_polarity = init_Struct->clock_polarity;
+    DCI_InitStruct.hsync_polarity = init_Struct->hsync_polarity;
+    DCI_InitStruct.vsync_polarity = init_Struct->vsync_polarity;
+    DCI_InitStruct.frame_rate = init_Struct->frame_rate;
+    DCI_InitStruct.interface_format = DCI_Interface_FORMAT_8BITS;
+    DCI_Init(&DCI_InitStruct);
+
+    //裁剪窗口以像素时钟计数, 水平方向要乘以每像素字节数
+    if(init_Struct->CropW != 0) {
+        DCI_Crop_Window_Config(init_Struct->CropX * init_Struct->BytesPerPixel, init_Struct->CropY,
+                               init_Struct->CropW * init_Struct->BytesPerPixel - 1, init_Struct->CropH - 1);
+        DCI_Crop_Window_Enable();
+    }
+
+    if(cap.jpeg) DCI_Jpeg_Enable();
+
+    DMA_DeInit(DCI_CAP_DMA, DCI_CAP_DMA_CH);
+    DMA_InitStruct.periph_addr = (uint32_t)&DCI_DATA;
+    DMA_InitStruct.periph_width = DMA_Periph_Width_32BIT;
+    DMA_InitStruct.periph_inc = DMA_Periph_INCREASE_DISABLE;
+    DMA_InitStruct.memory0_addr = (uint32_t)cap.frame[0].Data;
+    DMA_InitStruct.memory_width = DMA_Memory_Width_32BIT;
+    DMA_InitStruct.memory_inc = DMA_Memory_INCREASE_ENABLE;
+    DMA_InitStruct.memory_Burst_width = DMA_Memory_Burst_SINGLE;
+    DMA_InitStruct.periph_Burst_width = DMA_Periph_Burst_SINGLE;
+    DMA_InitStruct.critical_value = DMA_FIFO_4_WORD;
+    DMA_InitStruct.circular_mode = DMA_CIRCULAR_Mode_DISABLE;
+    DMA_InitStruct.direction = DMA_Periph_TO_MEMORY;
+    DMA_InitStruct.number = size / 4;
+    DMA_InitStruct.priority = DMA_Priority_HIGH;
+    DMA_Multi_Data_Mode_Init(DCI_CAP_DMA, DCI_CAP_DMA_CH, &DMA_InitStruct);
+    DMA_Channel_Subperipheral_Select(DCI_CAP_DMA, DCI_CAP_DMA_CH, DMA_SUBPERI1);
+
+    DCI_Interrupt_Flag_Clear(DCI_INT_Flag_EF | DCI_INT_Flag_OVR | DCI_INT_Flag_ESE);
+    DCI_Interrupt_Enable(DCI_INT_EF | DCI_INT_OVR | DCI_INT_ESE);
+    NVIC_irq_Enable(DCI_IRQn, 1, 0);
+
+    DCI_Enable();
+
+    return SUCCESS;
+}
+
+void DCI_Cap_Start(void) {
+    if(cap.running) return;
+
+    cap.running = 1;
+    DCI_Cap_Arm();
+    DCI_Capture_Enable();
+}
+
+void DCI_Cap_Stop(void) {
+    DCI_Capture_Disable();
+    NVIC_DisableIRQ(DCI_IRQn);
+    DCI_Cap_Halt();
+    cap.running = 0;
+    NVIC_EnableIRQ(DCI_IRQn);
+}
+
+//快照模式下DCI采完一帧自动清除 CAP 位, 每次都要重新使能
+void DCI_Cap_Snapshot(void) {
+    DCI_Cap_Start();
+}
+
+const DCI_Cap_Frame * DCI_Cap_Acquire(void) {
+    uint32_t latest;
+
+    if((cap.latest & DCI_CAP_FRESH) == 0) return 0;
+
+    //中断在 LDREX/STREX 之间发生时 STREX 失败, 重新读取
+    do {
+        latest = __LDREXW(&cap.latest);
+    } while(__STREXW(cap.read, &cap.latest) != 0);
+
+    cap.read = latest & DCI_CAP_INDEX;
+
+    return &cap.frame[cap.read];
+}
+
+void DCI_Cap_GetStats(DCI_Cap_Stats * stats) {
+    *stats = cap_stats;
+}
+
+void DCI_IRQHandler(void) {
+    if(DCI_Interrupt_Flag_Get(DCI_INT_Flag_OVR) == SET) {
+        DCI_Interrupt_Flag_Clear(DCI_INT_Flag_OVR);
+        cap_stats.Overruns++;
+        cap.bad = 1;
+    }
+
+    if(DCI_Interrupt_Flag_Get(DCI_INT_Flag_ESE) == SET) {
+        DCI_Interrupt_Flag_Clear(DCI_INT_Flag_ESE);
+        cap.bad = 1;
+    }
+
+    if(DCI_Interrupt_Flag_Get(DCI_INT_Flag_EF) == SET) {
+        DCI_Interrupt_Flag_Clear(DCI_INT_Flag_EF);
+
+        if(cap.running) DCI_Cap_FrameDone();
+    }
+}
@@ -0,0 +1,77 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : dci_capture.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : DCI摄像头采集, DMA写三缓冲, 使用者总是取到最新的完整帧
+  * Function List:
+  *		DCI_Cap_Struct_Para_Init
+  *		DCI_Cap_Init
+  *		DCI_Cap_Start
+  *		DCI_Cap_Stop
+  *		DCI_Cap_Snapshot
+  *		DCI_Cap_Acquire
+  *		DCI_Cap_GetStats
+  ******************************************************
+**/
+
+#ifndef __DCI_CAPTURE_H_
+#define __DCI_CAPTURE_H_
+
+#include "gd32f4xx.h"
+
+//DCI只能由DMA1的通道1或通道7(子外设1)搬运
+#define DCI_CAP_DMA				DMA1
+#define DCI_CAP_DMA_CH			DMA_CH1
+#define DCI_CAP_DMA_FLAGS		(DMA_Flag_FEE | DMA_Flag_SDE | DMA_Flag_TAE | DMA_Flag_HTF | DMA_Flag_FTF)
+
+#define DCI_CAP_BUF_NUM			3
+#define DCI_CAP_BUF_MAX			(65535u * 4)	//DMA一次最多搬运65535个字
+
+typedef struct {
+    uint8_t * Data;				//帧数据, 指向三缓冲之一
+    uint32_t Length;			//有效字节数, JPEG时为实际长度
+    uint32_t Seq;				//帧序号, 相邻两次取到的序号差减1即丢掉的帧数
+} DCI_Cap_Frame;
+
+typedef struct {
+    uint8_t * Buffer[DCI_CAP_BUF_NUM];	//三个帧缓冲, 4字节对齐, 可在SRAM或SDRAM
+    uint32_t BufSize;			//每个缓冲区字节数, 4的倍数; 非JPEG时须等于一帧(裁剪后)的字节数
+
+    uint32_t clock_polarity;	//DCI_CK_Polarity_xxx
+    uint32_t hsync_polarity;	//DCI_HSYNC_Polarity_xxx
+    uint32_t vsync_polarity;	//DCI_VSYNC_Polarity_xxx
+    uint32_t frame_rate;		//DCI_Frame_RATE_xxx, 硬件丢帧降低帧率
+    uint8_t  Jpeg;				//1: 摄像头输出JPEG, 帧长度不固定
+    uint8_t  Snapshot;			//1: 每次 DCI_Cap_Snapshot 只采一帧; 0: 连续采集
+
+    uint16_t CropX;				//裁剪窗口, 单位为像素; CropW=0 不裁剪
+    uint16_t CropY;
+    uint16_t CropW;
+    uint16_t CropH;
+    uint8_t  BytesPerPixel;		//每像素占几个像素时钟(RGB565/YUV422为2)
+} DCI_Cap_Parameter_Struct;
+
+typedef struct {
+    uint32_t Frames;			//已交给使用者的完整帧数
+    uint32_t Dropped;			//使用者还没来得及取就被更新的帧覆盖的帧数
+    uint32_t Errors;			//长度不对/JPEG超出缓冲区/同步错误而丢弃的帧数
+    uint32_t Overruns;			//DCI FIFO溢出次数
+} DCI_Cap_Stats;
+
+void DCI_Cap_Struct_Para_Init(DCI_Cap_Parameter_Struct * init_Struct);	// 填充缺省值: 连续采集, 不裁剪, 全帧率
+ErrStatus DCI_Cap_Init(DCI_Cap_Parameter_Struct * init_Struct);	// 配置DCI/DMA/中断, 参数非法返回 ERROR; GPIO和摄像头寄存器由调用者配置
+void DCI_Cap_Start(void);		// 开始连续采集
+void DCI_Cap_Stop(void);		// 停止采集
+void DCI_Cap_Snapshot(void);	// 快照模式下采集一帧, 结果同样用 DCI_Cap_Acquire 取
+const DCI_Cap_Frame * DCI_Cap_Acquire(void);	// 取最新的完整帧, 没有新帧返回0; 取到的帧在下一次成功取帧之前不会被覆盖
+void DCI_Cap_GetStats(DCI_Cap_Stats * stats);	// 读取统计计数
+
+#endif
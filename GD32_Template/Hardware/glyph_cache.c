@@ -0,0 +1,223 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : glyph_cache.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					字模一般以A8/A4存放, 图标以RGB565/RGB888等存放, 每次绘制都让IPA
+					做一遍格式转换既慢又占总线. 这里第一次绘制时把图像转换好存入
+					SDRAM缓存区, 以后直接从缓存拷贝(不透明图像)或混合(带alpha的图像):
+					  不透明源      -> 缓存成目标格式, 绘制时 IPAQ_Copy 不用转换
+					  带alpha的源   -> 缓存成 alphaFormat, A8/A4 按颜色着色,
+					                   绘制时 IPAQ_Blend, 颜色的alpha作为整体透明度
+					缓存用源地址+颜色+缓存格式作键, 开放寻址哈希查找; 缓存区按顺序
+					分配, 满了就整体清空, 不做逐个淘汰. 转换和绘制都进IPA队列, 队列
+					按顺序执行, 所以转换完成前不会开始绘制.
+  * Function List:
+  *		Glyph_Init
+  *		Glyph_Draw
+  *		Glyph_DrawString
+  *		Glyph_Flush
+  *		Glyph_GetStats
+  **********************************************************
+ */
+
+#include "glyph_cache.h"
+
+#if defined (GD32F450) || defined (GD32F470)
+
+#define GLYPH_MASK		(GLYPH_SLOTS - 1)
+
+typedef struct {
+    uint32_t key;					//源地址, 0 表示空
+    uint32_t color;
+    uint32_t addr;					//缓存中的地址
+    uint8_t  format;				//缓存格式
+} Glyph_Entry;
+
+static Glyph_Entry slots[GLYPH_SLOTS];
+static uint32_t glyph_pool;
+static uint32_t glyph_size;
+static uint32_t glyph_count;
+static uint8_t glyph_alpha;
+static Glyph_Stats glyph_stats;
+
+static uint8_t Glyph_HasAlpha(uint8_t format) {
+    return (format == IPAQ_RGB888 || format == IPAQ_RGB565 || format == IPAQ_L8 || format == IPAQ_L4) ? 0 : 1;
+}
+
+//只有A8/A4的颜色来自参数, 其它格式颜色不参与键
+static uint8_t Glyph_Colored(uint8_t format) {
+    return (format == IPAQ_A8 || format == IPAQ_A4) ? 1 : 0;
+}
+
+static uint32_t Glyph_Bytes(uint8_t format, uint16_t w, uint16_t h) {
+    uint32_t bpp = IPAQ_BytesPerPixel(format);
+
+    return bpp ? (uint32_t)w * h * bpp : ((uint32_t)w * h + 1) >> 1;
+}
+
+static Glyph_Entry * Glyph_Lookup(uint32_t key, uint32_t color, uint8_t format) {
+    uint32_t i = ((key >> 2) ^ (color * 0x9E3779B1U) ^ format) & GLYPH_MASK;
+
+    //装载率不超过3/4, 一定能找到空位
+    while(slots[i].key) {
+        if(slots[i].key == key && slots[i].color == color && slots[i].format == format) break;
+
+        i = (i + 1) & GLYPH_MASK;
+    }
+
+    return &slots[i];
+}
+
+void Glyph_Init(uint32_t pool, uint32_t size, uint8_t alphaFormat) {
+    uint32_t i;
+
+    glyph_pool = pool;
+    glyph_size = size;
+    glyph_alpha = alphaFormat;
+    glyph_stats.Hits = 0;
+    glyph_stats.Misses = 0;
+    glyph_stats.Flushes = 0;
+    glyph_stats.Used = 0;
+    glyph_count = 0;
+
+    for(i = 0; i < GLYPH_SLOTS; i++) slots[i].key = 0;
+}
+
+void Glyph_Flush(void) {
+    uint32_t i;
+
+    IPAQ_FenceWait(IPAQ_Fence());
+
+    for(i = 0; i < GLYPH_SLOTS; i++) slots[i].key = 0;
+
+    glyph_count = 0;
+    glyph_stats.Used = 0;
+    glyph_stats.Flushes++;
+}
+
+IPAQ_Fence_t Glyph_Draw(const Glyph_Source * src, uint32_t argb, const IPAQ_Surface * dst,
+                        int16_t x, int16_t y, const IPAQ_Rect * clip) {
+    int32_t x0 = x, y0 = y, x1 = x + src->W, y1 = y + src->H;
+    uint32_t color, bytes;
+    uint8_t alpha, format;
+    Glyph_Entry * entry;
+    IPAQ_Surface cache, from;
+    IPAQ_Rect rect, full;
+
+    if(x0 < 0) x0 = 0;
+
+    if(y0 < 0) y0 = 0;
+
+    if(clip) {
+        if(x0 < clip->X) x0 = clip->X;
+
+        if(y0 < clip->Y) y0 = clip->Y;
+
+        if(x1 > clip->X + clip->W) x1 = clip->X + clip->W;
+
+        if(y1 > clip->Y + clip->H) y1 = clip->Y + clip->H;
+    }
+
+    if(x0 >= x1 || y0 >= y1) return IPAQ_Fence();
+
+    rect.X = x0;
+    rect.Y = y0;
+    rect.W = x1 - x0;
+    rect.H = y1 - y0;
+
+    alpha = Glyph_HasAlpha(src->Format);
+    format = alpha ? glyph_alpha : dst->Format;
+    color = Glyph_Colored(src->Format) ? (argb & 0xFFFFFF) : 0;
+
+    cache.Stride = src->W;
+    cache.Format = format;
+
+    entry = Glyph_Lookup(src->Addr, color, format);
+
+    if(entry->key) {
+        glyph_stats.Hits++;
+    } else {
+        bytes = (Glyph_Bytes(format, src->W, src->H) + 3) & ~3U;
+
+        //比整个缓存区还大的图像不缓存, 直接从源绘制
+        if(bytes > glyph_size) {
+            cache.Addr = src->Addr;
+            cache.Format = src->Format;
+
+            if(alpha) return IPAQ_Blend(&cache, rect.X - x, rect.Y - y, argb, dst, &rect);
+            else return IPAQ_Copy(&cache, rect.X - x, rect.Y - y, 0, dst, &rect);
+        }
+
+        if(glyph_stats.Used + bytes > glyph_size || glyph_count >= GLYPH_SLOTS * 3 / 4) {
+            Glyph_Flush();
+            entry = Glyph_Lookup(src->Addr, color, format);
+        }
+
+        glyph_stats.Misses++;
+        glyph_count++;
+        entry->key = src->Addr;
+        entry->color = color;
+        entry->format = format;
+        entry->addr = glyph_pool + glyph_stats.Used;
+        glyph_stats.Used += bytes;
+
+        //整幅转换进缓存, A8/A4 按颜色着色, alpha保留原值
+        from.Addr = src->Addr;
+        from.Stride = src->W;
+        from.Format = src->Format;
+        full.X = 0;
+        full.Y = 0;
+        full.W = src->W;
+        full.H = src->H;
+        cache.Addr = entry->addr;
+        IPAQ_Copy(&from, 0, 0, color, &cache, &full);
+    }
+
+    cache.Addr = entry->addr;
+
+    if(alpha) return IPAQ_Blend(&cache, rect.X - x, rect.Y - y, argb, dst, &rect);
+
+    return IPAQ_Copy(&cache, rect.X - x, rect.Y - y, 0, dst, &rect);
+}
+
+IPAQ_Fence_t Glyph_DrawString(const Glyph_Font * font, const char * str, uint32_t argb, const IPAQ_Surface * dst,
+                              int16_t x, int16_t y, const IPAQ_Rect * clip) {
+    uint32_t bytes = Glyph_Bytes(font->Format, font->W, font->H);
+    IPAQ_Fence_t fence = IPAQ_Fence();
+    Glyph_Source src;
+    uint8_t c;
+
+    src.W = font->W;
+    src.H = font->H;
+    src.Format = font->Format;
+
+    while((c = (uint8_t) * str++) != 0) {
+        if(clip && x >= clip->X + clip->W) break;
+
+        if(c >= font->First && c - font->First < font->Count) {
+            src.Addr = font->Addr + (c - font->First) * bytes;
+            fence = Glyph_Draw(&src, argb, dst, x, y, clip);
+        }
+
+        x += font->W;
+    }
+
+    return fence;
+}
+
+void Glyph_GetStats(Glyph_Stats * stats) {
+    *stats = glyph_stats;
+}
+
+#endif /* GD32F450 and GD32F470 */
@@ -0,0 +1,68 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : glyph_cache.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 字模/图标预转换缓存, 首次绘制时用IPA转换成显示格式存入SDRAM, 之后直接拷贝/混合
+  * Function List:
+  *		Glyph_Init
+  *		Glyph_Draw
+  *		Glyph_DrawString
+  *		Glyph_Flush
+  *		Glyph_GetStats
+  ******************************************************
+**/
+
+#ifndef __GLYPH_CACHE_H_
+#define __GLYPH_CACHE_H_
+
+#include "gd32f4xx.h"
+#include "ipa_queue.h"
+
+#if defined (GD32F450) || defined (GD32F470)
+
+#define GLYPH_SLOTS			256		//缓存条目数, 必须是2的幂
+
+//字模/图标原始数据, 须在可直接访问的存储器中(内部Flash/SDRAM/映射的外部Flash)
+typedef struct {
+    uint32_t Addr;				//同时作为缓存的键, 不同图像不能共用地址
+    uint16_t W;
+    uint16_t H;
+    uint8_t  Format;			//IPAQ_xxx; A4/L4 宽度须为偶数
+} Glyph_Source;
+
+//等宽字库, 每个字符 W*H 像素连续存放
+typedef struct {
+    uint32_t Addr;
+    uint16_t W;
+    uint16_t H;
+    uint8_t  Format;			//一般为 IPAQ_A8 或 IPAQ_A4
+    uint8_t  First;				//第一个字符的编码
+    uint8_t  Count;				//字符个数
+} Glyph_Font;
+
+typedef struct {
+    uint32_t Hits;
+    uint32_t Misses;			//需要转换的次数
+    uint32_t Flushes;			//缓存满后清空的次数
+    uint32_t Used;				//缓存区已用字节数
+} Glyph_Stats;
+
+void Glyph_Init(uint32_t pool, uint32_t size, uint8_t alphaFormat);	// pool 为SDRAM中的缓存区; 带alpha的源缓存成 alphaFormat(IPAQ_ARGB8888/ARGB4444/ARGB1555)
+IPAQ_Fence_t Glyph_Draw(const Glyph_Source * src, uint32_t argb, const IPAQ_Surface * dst,
+                        int16_t x, int16_t y, const IPAQ_Rect * clip);	// 画在 (x, y), 只画 clip 内的部分; argb 为A8/A4/AL源的颜色
+IPAQ_Fence_t Glyph_DrawString(const Glyph_Font * font, const char * str, uint32_t argb, const IPAQ_Surface * dst,
+                              int16_t x, int16_t y, const IPAQ_Rect * clip);	// 画一行字符, 字库中没有的字符跳过一个字宽
+void Glyph_Flush(void);		// 等待用到缓存的IPA操作完成后清空缓存
+void Glyph_GetStats(Glyph_Stats * stats);	// 读取统计信息
+
+#endif /* GD32F450 and GD32F470 */
+
+#endif
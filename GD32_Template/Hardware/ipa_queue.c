@@ -0,0 +1,293 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : ipa_queue.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					IPA一次只能执行一个传输, 库函数配置完前景/背景/目标后调用
+					IPA_Transfer_Enable, 再轮询 TEN 位. 这里把每个操作的三组参数
+					放入环形队列, 全部传输完成中断里立即启动下一个, CPU只在需要
+					结果时用栅栏等待. 队列只能在主循环中写入.
+					访问错误/配置错误时该操作被丢弃, 计入 Errors, 队列继续执行,
+					所以栅栏一定会完成.
+  * Function List:
+  *		IPAQ_Init
+  *		IPAQ_BytesPerPixel
+  *		IPAQ_Fill
+  *		IPAQ_Copy
+  *		IPAQ_Blend
+  *		IPAQ_Fence
+  *		IPAQ_FenceDone
+  *		IPAQ_FenceWait
+  *		IPAQ_GetStats
+  *		IPA_IRQHandler
+  **********************************************************
+ */
+
+#include "ipa_queue.h"
+
+#if defined (GD32F450) || defined (GD32F470)
+
+#define IPAQ_MASK		(IPAQ_LEN - 1)
+
+typedef struct {
+    uint32_t pfcm;
+    IPA_foreground_Parameter_Struct fg;
+    IPA_background_Parameter_Struct bg;
+    IPA_destination_Parameter_Struct dst;
+} IPAQ_Job;
+
+static IPAQ_Job ring[IPAQ_LEN];
+static volatile uint32_t ring_wr;		//主循环写, 同时是最后一个操作的栅栏
+static volatile uint32_t ring_rd;		//中断写, 同时是已完成的栅栏
+static volatile uint8_t ipa_busy;
+static IPAQ_Stats ipaq_stats;
+
+static void IPAQ_Start(IPAQ_Job * job) {
+    IPA_pixel_format_convert_Mode_Set(job->pfcm);
+
+    if(job->pfcm != IPA_FILL_Up_DE) IPA_foreground_Init(&job->fg);
+
+    if(job->pfcm == IPA_FGBGTODE) IPA_background_Init(&job->bg);
+
+    IPA_destination_Init(&job->dst);
+    IPA_Transfer_Enable();
+}
+
+//取得一个空位, 队列满时等中断腾出位置
+static IPAQ_Job * IPAQ_Alloc(void) {
+    uint32_t wr = ring_wr;
+
+    if(wr - ring_rd >= IPAQ_LEN) {
+        ipaq_stats.RingFull++;
+
+        while(wr - ring_rd >= IPAQ_LEN) __NOP();
+    }
+
+    return &ring[wr & IPAQ_MASK];
+}
+
+//提交 IPAQ_Alloc 取得的操作; 中断在 ring_wr 更新后发现还有操作会自己启动, 这里只在它已经停下时启动
+static IPAQ_Fence_t IPAQ_Commit(void) {
+    uint32_t wr = ring_wr + 1;
+
+    __DMB();
+    ring_wr = wr;
+    ipaq_stats.Submitted++;
+
+    if(wr - ring_rd > ipaq_stats.MaxDepth)
+        ipaq_stats.MaxDepth = wr - ring_rd;
+
+    if(ipa_busy == 0) {
+        ipa_busy = 1;
+        IPAQ_Start(&ring[ring_rd & IPAQ_MASK]);
+    }
+
+    return wr;
+}
+
+uint32_t IPAQ_BytesPerPixel(uint8_t format) {
+    switch(format) {
+        case IPAQ_ARGB8888:
+            return 4;
+
+        case IPAQ_RGB888:
+            return 3;
+
+        case IPAQ_RGB565:
+        case IPAQ_ARGB1555:
+        case IPAQ_ARGB4444:
+        case IPAQ_AL88:
+            return 2;
+
+        case IPAQ_L8:
+        case IPAQ_AL44:
+        case IPAQ_A8:
+            return 1;
+
+        default:
+            return 0;
+    }
+}
+
+//(x, y) 处像素的地址, 4位格式 x 须为偶数
+static uint32_t IPAQ_PixelAddr(const IPAQ_Surface * s, uint16_t x, uint16_t y) {
+    uint32_t n = (uint32_t)y * s->Stride + x;
+    uint32_t bpp = IPAQ_BytesPerPixel(s->Format);
+
+    return s->Addr + (bpp ? n * bpp : n >> 1);
+}
+
+//目标参数; 填充颜色要按目标格式截成各分量的位数
+static void IPAQ_SetDst(IPAQ_Job * job, const IPAQ_Surface * dst, const IPAQ_Rect * rect, uint32_t argb) {
+    uint32_t a = argb >> 24, r = (argb >> 16) & 0xFF, g = (argb >> 8) & 0xFF, b = argb & 0xFF;
+
+    switch(dst->Format) {
+        case IPAQ_RGB565:
+            a = 0;
+            r >>= 3;
+            g >>= 2;
+            b >>= 3;
+            break;
+
+        case IPAQ_ARGB1555:
+            a >>= 7;
+            r >>= 3;
+            g >>= 3;
+            b >>= 3;
+            break;
+
+        case IPAQ_ARGB4444:
+            a >>= 4;
+            r >>= 4;
+            g >>= 4;
+            b >>= 4;
+            break;
+
+        default:
+            break;
+    }
+
+    job->dst.destination_memaddr = IPAQ_PixelAddr(dst, rect->X, rect->Y);
+    job->dst.destination_lineoff = dst->Stride - rect->W;
+    job->dst.destination_pf = dst->Format;
+    job->dst.destination_prealpha = a;
+    job->dst.destination_prered = r;
+    job->dst.destination_pregreen = g;
+    job->dst.destination_preblue = b;
+    job->dst.image_width = rect->W;
+    job->dst.image_height = rect->H;
+}
+
+static void IPAQ_SetFg(IPAQ_Job * job, const IPAQ_Surface * src, uint16_t sx, uint16_t sy, uint16_t w,
+                       uint32_t argb, uint32_t algorithm) {
+    job->fg.foreground_memaddr = IPAQ_PixelAddr(src, sx, sy);
+    job->fg.foreground_lineoff = src->Stride - w;
+    job->fg.foreground_pf = src->Format;
+    job->fg.foreground_alpha_algorithm = algorithm;
+    job->fg.foreground_prealpha = argb >> 24;
+    job->fg.foreground_prered = (argb >> 16) & 0xFF;
+    job->fg.foreground_pregreen = (argb >> 8) & 0xFF;
+    job->fg.foreground_preblue = argb & 0xFF;
+}
+
+void IPAQ_Init(uint8_t interval) {
+    ring_wr = 0;
+    ring_rd = 0;
+    ipa_busy = 0;
+    ipaq_stats.Submitted = 0;
+    ipaq_stats.Completed = 0;
+    ipaq_stats.Errors = 0;
+    ipaq_stats.RingFull = 0;
+    ipaq_stats.MaxDepth = 0;
+
+    RCU_Periph_Clock_Enable(RCU_IPA);
+    IPA_DeInit();
+
+    if(interval) {
+        IPA_interval_Clock_num_Config(interval);
+        IPA_inter_TIMER_Config(IPA_INTER_TIMER_ENABLE);
+    }
+
+    IPA_Interrupt_Enable(IPA_INT_FTF | IPA_INT_TAE | IPA_INT_WCF);
+    NVIC_irq_Enable(IPA_IRQn, 2, 0);
+}
+
+IPAQ_Fence_t IPAQ_Fill(const IPAQ_Surface * dst, const IPAQ_Rect * rect, uint32_t argb) {
+    IPAQ_Job * job;
+
+    if(rect->W == 0 || rect->H == 0) return ring_wr;
+
+    job = IPAQ_Alloc();
+    job->pfcm = IPA_FILL_Up_DE;
+    IPAQ_SetDst(job, dst, rect, argb);
+
+    return IPAQ_Commit();
+}
+
+IPAQ_Fence_t IPAQ_Copy(const IPAQ_Surface * src, uint16_t sx, uint16_t sy, uint32_t argb,
+                       const IPAQ_Surface * dst, const IPAQ_Rect * rect) {
+    IPAQ_Job * job;
+
+    if(rect->W == 0 || rect->H == 0) return ring_wr;
+
+    job = IPAQ_Alloc();
+    job->pfcm = src->Format == dst->Format ? IPA_FGTODE : IPA_FGTODE_PF_CONVERT;
+    IPAQ_SetFg(job, src, sx, sy, rect->W, argb, IPA_FG_ALPHA_Mode_0);
+    IPAQ_SetDst(job, dst, rect, 0);
+
+    return IPAQ_Commit();
+}
+
+IPAQ_Fence_t IPAQ_Blend(const IPAQ_Surface * src, uint16_t sx, uint16_t sy, uint32_t argb,
+                        const IPAQ_Surface * dst, const IPAQ_Rect * rect) {
+    IPAQ_Job * job;
+
+    if(rect->W == 0 || rect->H == 0) return ring_wr;
+
+    job = IPAQ_Alloc();
+    job->pfcm = IPA_FGBGTODE;
+    IPAQ_SetFg(job, src, sx, sy, rect->W, argb, IPA_FG_ALPHA_Mode_2);
+
+    //背景就是目标本身
+    job->bg.background_memaddr = IPAQ_PixelAddr(dst, rect->X, rect->Y);
+    job->bg.background_lineoff = dst->Stride - rect->W;
+    job->bg.background_pf = dst->Format;
+    job->bg.background_alpha_algorithm = IPA_BG_ALPHA_Mode_0;
+    job->bg.background_prealpha = 0xFF;
+    job->bg.background_prered = 0;
+    job->bg.background_pregreen = 0;
+    job->bg.background_preblue = 0;
+
+    IPAQ_SetDst(job, dst, rect, 0);
+
+    return IPAQ_Commit();
+}
+
+IPAQ_Fence_t IPAQ_Fence(void) {
+    return ring_wr;
+}
+
+//序号自由运行, 用有符号差值比较, 回绕后仍然正确
+uint32_t IPAQ_FenceDone(IPAQ_Fence_t fence) {
+    return (int32_t)(ring_rd - fence) >= 0 ? 1 : 0;
+}
+
+void IPAQ_FenceWait(IPAQ_Fence_t fence) {
+    while(IPAQ_FenceDone(fence) == 0) __NOP();
+}
+
+void IPAQ_GetStats(IPAQ_Stats * stats) {
+    *stats = ipaq_stats;
+}
+
+void IPA_IRQHandler(void) {
+    uint32_t rd;
+
+    if(IPA_Interrupt_Flag_Get(IPA_INT_Flag_TAE | IPA_INT_Flag_WCF) == SET) {
+        IPA_Interrupt_Flag_Clear(IPA_INT_Flag_TAE | IPA_INT_Flag_WCF);
+        ipaq_stats.Errors++;
+    } else if(IPA_Interrupt_Flag_Get(IPA_INT_Flag_FTF) == SET) {
+        IPA_Interrupt_Flag_Clear(IPA_INT_Flag_FTF);
+        ipaq_stats.Completed++;
+    } else {
+        return;
+    }
+
+    rd = ring_rd + 1;
+    ring_rd = rd;
+
+    if(rd != ring_wr) IPAQ_Start(&ring[rd & IPAQ_MASK]);
+    else ipa_busy = 0;
+}
+
+#endif /* GD32F450 and GD32F470 */
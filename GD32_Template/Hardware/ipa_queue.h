@@ -0,0 +1,86 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : ipa_queue.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : GD32F450/470 IPA操作队列, 填充/拷贝(格式转换)/混合在中断中依次执行
+  * Function List:
+  *		IPAQ_Init
+  *		IPAQ_BytesPerPixel
+  *		IPAQ_Fill
+  *		IPAQ_Copy
+  *		IPAQ_Blend
+  *		IPAQ_Fence
+  *		IPAQ_FenceDone
+  *		IPAQ_FenceWait
+  *		IPAQ_GetStats
+  ******************************************************
+**/
+
+#ifndef __IPA_QUEUE_H_
+#define __IPA_QUEUE_H_
+
+#include "gd32f4xx.h"
+
+#if defined (GD32F450) || defined (GD32F470)
+
+#define IPAQ_LEN			16		//队列深度, 必须是2的幂
+
+/* 像素格式, 与 FOREGROUND_PPF_xxx/BACKGROUND_PPF_xxx 取值相同, 0~4 同时是 IPA_DPF_xxx 和 LAYER_PPF_xxx */
+#define IPAQ_ARGB8888		0
+#define IPAQ_RGB888			1
+#define IPAQ_RGB565			2
+#define IPAQ_ARGB1555		3
+#define IPAQ_ARGB4444		4
+#define IPAQ_L8				5
+#define IPAQ_AL44			6
+#define IPAQ_AL88			7
+#define IPAQ_L4				8
+#define IPAQ_A8				9
+#define IPAQ_A4				10
+
+typedef uint32_t IPAQ_Fence_t;		//操作序号, 用来等待某个操作(及之前所有操作)完成
+
+typedef struct {
+    uint32_t Addr;					//左上角像素地址
+    uint16_t Stride;				//每行像素数
+    uint8_t  Format;				//IPAQ_ARGB8888 ...; 作为目标时只能是 0~4
+} IPAQ_Surface;
+
+typedef struct {
+    uint16_t X;
+    uint16_t Y;
+    uint16_t W;
+    uint16_t H;
+} IPAQ_Rect;
+
+typedef struct {
+    uint32_t Submitted;
+    uint32_t Completed;
+    uint32_t Errors;				//访问错误/配置错误中断次数
+    uint32_t RingFull;				//提交时队列已满需要等待的次数
+    uint32_t MaxDepth;
+} IPAQ_Stats;
+
+void IPAQ_Init(uint8_t interval);	// 复位IPA并使能中断; interval 非0时每次访问总线后间隔若干时钟, 给CPU/TLI让出带宽
+uint32_t IPAQ_BytesPerPixel(uint8_t format);	// 4位格式返回0
+IPAQ_Fence_t IPAQ_Fill(const IPAQ_Surface * dst, const IPAQ_Rect * rect, uint32_t argb);	// 用 ARGB8888 颜色填充矩形
+IPAQ_Fence_t IPAQ_Copy(const IPAQ_Surface * src, uint16_t sx, uint16_t sy, uint32_t argb,
+                       const IPAQ_Surface * dst, const IPAQ_Rect * rect);	// 拷贝, 格式不同时转换; argb 为 A8/A4 源的颜色
+IPAQ_Fence_t IPAQ_Blend(const IPAQ_Surface * src, uint16_t sx, uint16_t sy, uint32_t argb,
+                        const IPAQ_Surface * dst, const IPAQ_Rect * rect);	// 按源alpha叠加到目标上; argb 的alpha再乘到源alpha上
+IPAQ_Fence_t IPAQ_Fence(void);	// 最后一个已提交操作的栅栏
+uint32_t IPAQ_FenceDone(IPAQ_Fence_t fence);	// 栅栏之前的操作都已完成返回1
+void IPAQ_FenceWait(IPAQ_Fence_t fence);	// 等待栅栏完成
+void IPAQ_GetStats(IPAQ_Stats * stats);	// 读取统计信息
+
+#endif /* GD32F450 and GD32F470 */
+
+#endif
@@ -0,0 +1,57 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : mem_pool.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 多区域内存分配: 小对象按尺寸级别从slab池O(1)分配, 大缓冲区按页分配;
+  *				   内部SRAM/TCMSRAM放延迟敏感的小对象, EXMC SDRAM放大缓冲区.
+  *				   只依赖标准头文件, 可在PC上测试
+  * Function List:
+  *		Mem_AddRegion
+  *		Mem_Alloc
+  *		Mem_Free
+  *		Mem_GetStats
+  ******************************************************
+**/
+
+#ifndef __MEM_POOL_H_
+#define __MEM_POOL_H_
+
+#include <stdint.h>
+
+//区域类型
+#define MEM_FAST            0x00    //内部SRAM/TCMSRAM; TCMSRAM只有CPU能访问, 不能给DMA
+#define MEM_BULK            0x01    //外部SDRAM (EXMC_sdram_Init 之后加入)
+#define MEM_STRICT          0x80    //与类型相或: 只在该类型的区域分配, 不够时不借用另一类
+
+#define MEM_REGION_MAX      4
+#define MEM_PAGE_SIZE       4096    //页大小, 大于 MEM_CLASS_MAX 的申请按整页分配, 32字节对齐
+#define MEM_CLASS_NUM       8       //小对象尺寸级别: 16, 32, 64 ... 2048
+#define MEM_CLASS_MIN       16
+#define MEM_CLASS_MAX       (MEM_CLASS_MIN << (MEM_CLASS_NUM - 1))
+
+typedef struct {
+    uint32_t Pages;             //区域的页数
+    uint32_t FreePages;         //页堆中空闲的页
+    uint32_t SlabPages;         //切成小对象的页, 页内对象全部释放后归还页堆, 每级留一页空页作缓存
+    uint32_t InUse;             //已分配的字节(按级别/整页计)
+    uint32_t Peak;              //InUse 的最大值
+    uint32_t Allocs;
+    uint32_t Frees;
+    uint32_t Fails;             //该区域分配失败的次数
+    uint32_t ClassInUse[MEM_CLASS_NUM];	//各尺寸级别在用的对象数
+} Mem_Stats;
+
+uint8_t Mem_AddRegion(void * base, uint32_t size, uint8_t kind);	// 加入一块内存, 返回区域号; 失败返回 0xFF
+void * Mem_Alloc(uint32_t size, uint8_t kind);	// 先在 kind 类区域按加入顺序分配, 没有 MEM_STRICT 时再借用另一类; 失败返回 NULL; 不可在中断中调用
+void Mem_Free(void * p);			// 释放 Mem_Alloc 得到的内存, NULL 和不属于任何区域的指针被忽略; 不可在中断中调用
+void Mem_GetStats(uint8_t region, Mem_Stats * stats);	// 读取一个区域的统计
+
+#endif
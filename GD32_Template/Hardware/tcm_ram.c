@@ -0,0 +1,172 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : tcm_ram.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					TCMSRAM与SRAM的对比测试. 同一段控制环代码(查表 + 积分 + 状态更新,
+					每通道每轮六次读两次写)分别操作SRAM0和TCMSRAM中的一份状态, 各测
+					一次空闲和一次DMA1内存到内存连续搬运SRAM0的情况, 用DWT周期计数器计时.
+					状态在SRAM0时CPU和DMA在总线矩阵上轮流占用SRAM0, DMA越忙控制环越慢;
+					状态在TCMSRAM时两者互不相干, TcmDMA 应与 TcmIdle 基本相同.
+					DMA每搬完一块在中断中立即重新启动, 中断本身的开销两种情况相同.
+					TCM_IsrStackInit 把线程模式切到PSP(沿用SRAM中的启动栈),
+					MSP 改指TCMSRAM中的独立栈: 中断压栈和中断内的局部变量不再和DMA争用SRAM,
+					线程模式的局部变量仍在SRAM, 可以交给DMA.
+  * Function List:
+  *		TCM_IsrStackInit
+  *		TCM_Bench
+  *		TCM_BENCH_DMA_IRQHandler
+  **********************************************************
+ */
+
+#include "tcm_ram.h"
+
+#define TCM_LOOP_CH         16
+#define TCM_CONTROL_SPSEL   0x02    //CONTROL.SPSEL: 线程模式使用PSP
+
+typedef struct {
+    uint32_t x[TCM_LOOP_CH];        //各通道状态
+    uint32_t acc[TCM_LOOP_CH];      //积分项
+    int16_t  lut[256];              //非线性校正表
+} TCM_Loop;
+
+static TCM_Loop sram_loop;
+TCM_BSS static TCM_Loop tcm_loop;
+
+//DMA缓冲区必须在SRAM
+static uint32_t dma_src[TCM_BENCH_DMA_WORDS];
+static uint32_t dma_dst[TCM_BENCH_DMA_WORDS];
+static volatile uint8_t dma_run;
+static volatile uint32_t dma_words;
+
+TCM_BSS static uint64_t tcm_isr_stack[TCM_ISR_STACK_SIZE / 8];	//8字节对齐, 满足AAPCS栈对齐
+
+static void TCM_LoopReset(TCM_Loop * s) {
+    uint32_t i;
+
+    for(i = 0; i < TCM_LOOP_CH; i++) {
+        s->x[i] = i << 20;
+        s->acc[i] = 0;
+    }
+
+    for(i = 0; i < 256; i++)
+        s->lut[i] = (int16_t)(((int32_t)(i * i) - 128 * 128) >> 4);
+}
+
+//volatile 保证每次都真正访问内存, 而不是把状态留在寄存器里
+static void TCM_Kernel(volatile TCM_Loop * s, uint32_t rounds) {
+    uint32_t r, ch;
+    int32_t e;
+
+    for(r = 0; r < rounds; r++) {
+        for(ch = 0; ch < TCM_LOOP_CH; ch++) {
+            e = s->lut[s->x[ch] >> 24];
+            s->acc[ch] += (uint32_t)e - (s->acc[ch] >> 6);
+            s->x[ch] += (s->acc[ch] << 4) + (r ^ ch);
+        }
+    }
+}
+
+static void TCM_DMAStart(void) {
+    DMA_Interrupt_Flag_Clear(TCM_BENCH_DMA, TCM_BENCH_DMA_CH, DMA_INT_Flag_FTF);
+    DMA_Transfer_Number_Config(TCM_BENCH_DMA, TCM_BENCH_DMA_CH, TCM_BENCH_DMA_WORDS);
+    DMA_Channel_Enable(TCM_BENCH_DMA, TCM_BENCH_DMA_CH);
+}
+
+static void TCM_DMAInit(void) {
+    DMA_Multi_Data_Parameter_Struct DMA_InitStruct;
+
+    RCU_Periph_Clock_Enable(RCU_DMA1);
+
+    DMA_DeInit(TCM_BENCH_DMA, TCM_BENCH_DMA_CH);
+
+    //内存到内存: 外设地址是源
+    DMA_InitStruct.periph_addr = (uint32_t)dma_src;
+    DMA_InitStruct.periph_width = DMA_Periph_Width_32BIT;
+    DMA_InitStruct.periph_inc = DMA_Periph_INCREASE_ENABLE;
+    DMA_InitStruct.memory0_addr = (uint32_t)dma_dst;
+    DMA_InitStruct.memory_width = DMA_Memory_Width_32BIT;
+    DMA_InitStruct.memory_inc = DMA_Memory_INCREASE_ENABLE;
+    DMA_InitStruct.memory_Burst_width = DMA_Memory_Burst_4_BEAT;
+    DMA_InitStruct.periph_Burst_width = DMA_Periph_Burst_4_BEAT;
+    DMA_InitStruct.critical_value = DMA_FIFO_4_WORD;
+    DMA_InitStruct.circular_mode = DMA_CIRCULAR_Mode_DISABLE;
+    DMA_InitStruct.direction = DMA_Memory_TO_MEMORY;
+    DMA_InitStruct.number = TCM_BENCH_DMA_WORDS;
+    DMA_InitStruct.priority = DMA_Priority_HIGH;
+    DMA_Multi_Data_Mode_Init(TCM_BENCH_DMA, TCM_BENCH_DMA_CH, &DMA_InitStruct);
+    DMA_Interrupt_Enable(TCM_BENCH_DMA, TCM_BENCH_DMA_CH, DMA_CHXCTL_FTFIE);
+
+    NVIC_irq_Enable(TCM_BENCH_DMA_IRQn, 3, 3);
+}
+
+static uint32_t TCM_Run(TCM_Loop * s, uint32_t rounds, uint8_t dma) {
+    uint32_t start, cycles;
+
+    TCM_LoopReset(s);
+    dma_words = 0;
+
+    if(dma) {
+        dma_run = 1;
+        TCM_DMAStart();
+    }
+
+    start = DWT->CYCCNT;
+    TCM_Kernel(s, rounds);
+    cycles = DWT->CYCCNT - start;
+
+    //不再重启, 等最后一块搬完
+    dma_run = 0;
+
+    while(DMA_CHCTL(TCM_BENCH_DMA, TCM_BENCH_DMA_CH) & DMA_CHXCTL_CHEN);
+
+    return cycles;
+}
+
+//在 main 开头、使能任何中断之前调用一次; 切换前后SP的值相同, 当前函数的栈帧不受影响
+void TCM_IsrStackInit(void) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+
+    __set_PSP(__get_MSP());
+    __set_CONTROL(__get_CONTROL() | TCM_CONTROL_SPSEL);
+    __ISB();
+
+    __set_MSP((uint32_t)&tcm_isr_stack[TCM_ISR_STACK_SIZE / 8]);
+
+    if(primask == 0) __enable_irq();
+}
+
+void TCM_Bench(uint32_t rounds, TCM_BenchResult * result) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    TCM_DMAInit();
+
+    result->SramIdle = TCM_Run(&sram_loop, rounds, 0);
+    result->SramDMA = TCM_Run(&sram_loop, rounds, 1);
+    result->DMAWords[0] = dma_words;
+    result->TcmIdle = TCM_Run(&tcm_loop, rounds, 0);
+    result->TcmDMA = TCM_Run(&tcm_loop, rounds, 1);
+    result->DMAWords[1] = dma_words;
+}
+
+void TCM_BENCH_DMA_IRQHandler(void) {
+    if(DMA_Interrupt_Flag_Get(TCM_BENCH_DMA, TCM_BENCH_DMA_CH, DMA_INT_Flag_FTF) != RESET) {
+        DMA_Interrupt_Flag_Clear(TCM_BENCH_DMA, TCM_BENCH_DMA_CH, DMA_INT_Flag_FTF);
+        dma_words += TCM_BENCH_DMA_WORDS;
+
+        if(dma_run) TCM_DMAStart();
+    }
+}
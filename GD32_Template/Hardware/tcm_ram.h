@@ -0,0 +1,70 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : tcm_ram.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 64KB TCMSRAM的变量放置(配合 Project/led_tcm.sct)、TCMSRAM中的中断栈,
+  *				   以及CPU与DMA争用SRAM的对比测试
+  * Function List:
+  *		TCM_IsrStackInit
+  *		TCM_Bench
+  *		TCM_BENCH_DMA_IRQHandler
+  ******************************************************
+**/
+
+#ifndef __TCM_RAM_H_
+#define __TCM_RAM_H_
+
+#include "gd32f4xx.h"
+
+//TCMSRAM只接在Cortex-M4的D总线上: DMA、ENET、USBHS、IPA都访问不到, 也不能执行代码.
+//总线矩阵上没有别的主机和CPU争用它, DMA搬运SRAM时CPU访问TCMSRAM不受影响.
+//
+//放置规则:
+//  TCM_DATA  有初值的变量和查找表(正弦表、CRC表、校准曲线), 由 __main 从Flash复制
+//  TCM_BSS   控制环状态: PID积分项、滤波器历史、观测器状态, 由 __main 清零
+//  栈        启动文件的 STACK 段(main 和各驱动的局部变量)留在SRAM, 局部变量也可以作DMA缓冲区.
+//            main 开头调用 TCM_IsrStackInit 后线程模式改用PSP(仍是这段SRAM栈),
+//            MSP 指向TCMSRAM中 TCM_ISR_STACK_SIZE 字节的独立栈, 只有中断使用
+//  DMA缓冲区 普通全局/静态/局部变量(SRAM0/1/2)或 mem_pool 的 MEM_BULK,
+//            不能加 TCM_xxx, 也不能在中断里用局部变量(中断栈在TCMSRAM), DMA驱动可用 TCM_ADDR 检查
+#define TCM_SIZE                    0x10000
+#define TCM_ISR_STACK_SIZE          0x800       //中断栈字节数, 8的倍数, 按最深的中断嵌套估算
+
+#if defined(__CC_ARM)
+#define TCM_DATA                    __attribute__((section(".data.tcm")))
+#define TCM_BSS                     __attribute__((section(".bss.tcm"), zero_init))
+#else
+#define TCM_DATA                    __attribute__((section(".data.tcm")))
+#define TCM_BSS                     __attribute__((section(".bss.tcm")))	//AC6/GCC 以 .bss 开头的段就是ZI段
+#endif
+
+#define TCM_ADDR(p)                 (((uint32_t)(p) - TCMSRAM_BASE) < TCM_SIZE)
+
+//对比测试用的内存到内存DMA, 中断服务函数在tcm_ram.c中实现
+#define TCM_BENCH_DMA               DMA1
+#define TCM_BENCH_DMA_CH            DMA_CH3
+#define TCM_BENCH_DMA_IRQn          DMA1_Channel3_IRQn
+#define TCM_BENCH_DMA_IRQHandler    DMA1_Channel3_IRQHandler
+
+#define TCM_BENCH_DMA_WORDS         4096	//每次搬运16KB, 源和目的都在SRAM0
+
+typedef struct {
+    uint32_t SramIdle;          //状态在SRAM, 无DMA, 周期数
+    uint32_t SramDMA;           //状态在SRAM, DMA同时搬运SRAM0
+    uint32_t TcmIdle;           //状态在TCMSRAM, 无DMA
+    uint32_t TcmDMA;            //状态在TCMSRAM, DMA同时搬运SRAM0
+    uint32_t DMAWords[2];       //两次DMA测试期间DMA搬运的字数: [0]状态在SRAM [1]状态在TCMSRAM
+} TCM_BenchResult;
+
+void TCM_IsrStackInit(void); // 中断改用TCMSRAM中的独立栈, 在 main 开头、使能中断前调用一次
+void TCM_Bench(uint32_t rounds, TCM_BenchResult * result); // 用同一段控制环代码分别测四种情况, rounds 一般取 10000
+
+#endif
@@ -0,0 +1,132 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : tli_frame.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					TLI_LxFBADDR 写入的是影子寄存器, 要 TLI_RL 置位后才生效. 行标记
+					设在有效区之后, 中断里检查各图层是否有已提交且IPA已画完的后台
+					缓冲, 有则写地址并请求帧消隐期间重载; 重载完成中断(LCR)再确认
+					切换, 此后旧的前台缓冲才允许被画. 这样换帧一定发生在两帧之间:
+					  主循环: Frame_Begin -> IPAQ_xxx 画后台 -> Frame_Present(栅栏)
+					  中断:   行标记 -> 写地址, FBR -> LCR -> 前后台交换
+  * Function List:
+  *		Frame_Init
+  *		Frame_LayerSetup
+  *		Frame_Begin
+  *		Frame_Present
+  *		Frame_GetStats
+  *		TLI_IRQHandler
+  **********************************************************
+ */
+
+#include "tli_frame.h"
+
+#if defined (GD32F450) || defined (GD32F470)
+
+typedef struct {
+    uint32_t fb[2];
+    uint8_t  used;					//已调用 Frame_LayerSetup
+    volatile uint8_t front;			//正在扫描的缓冲下标
+    volatile uint8_t pending;		//后台已提交, 等待切换
+    volatile uint8_t reload;		//地址已写入影子寄存器, 等待重载
+    IPAQ_Fence_t fence;
+} Frame_Layer;
+
+static const uint32_t layer_base[2] = {LAYER0, LAYER1};
+static Frame_Layer frame[2];
+static Frame_Stats frame_stats;
+
+void Frame_Init(uint16_t line) {
+    uint8_t i;
+
+    for(i = 0; i < 2; i++) {
+        frame[i].used = 0;
+        frame[i].pending = 0;
+        frame[i].reload = 0;
+        frame_stats.Shown[i] = 0;
+        frame_stats.Late[i] = 0;
+    }
+
+    frame_stats.Marks = 0;
+
+    TLI_Line_Mark_Set(line);
+    TLI_Interrupt_Flag_Clear(TLI_INT_Flag_LM | TLI_INT_Flag_LCR);
+    TLI_Interrupt_Enable(TLI_INT_LM | TLI_INT_LCR);
+    NVIC_irq_Enable(TLI_IRQn, 1, 0);
+}
+
+void Frame_LayerSetup(uint8_t layer, uint32_t buf0, uint32_t buf1) {
+    frame[layer].fb[0] = buf0;
+    frame[layer].fb[1] = buf1;
+    frame[layer].front = 0;
+    frame[layer].pending = 0;
+    frame[layer].reload = 0;
+    frame[layer].fence = IPAQ_Fence();
+    __DMB();
+    frame[layer].used = 1;
+}
+
+//换帧完成后后台缓冲不再被扫描, 可以开始画下一帧
+uint32_t Frame_Begin(uint8_t layer) {
+    while(frame[layer].pending) __NOP();
+
+    return frame[layer].fb[frame[layer].front ^ 1];
+}
+
+void Frame_Present(uint8_t layer, IPAQ_Fence_t fence) {
+    frame[layer].fence = fence;
+    __DMB();
+    frame[layer].pending = 1;
+}
+
+void Frame_GetStats(Frame_Stats * stats) {
+    *stats = frame_stats;
+}
+
+void TLI_IRQHandler(void) {
+    uint8_t i, request = 0;
+
+    if(TLI_Interrupt_Flag_Get(TLI_INT_Flag_LCR) == SET) {
+        TLI_Interrupt_Flag_Clear(TLI_INT_Flag_LCR);
+
+        for(i = 0; i < 2; i++) {
+            if(frame[i].reload) {
+                frame[i].front ^= 1;
+                frame[i].reload = 0;
+                frame[i].pending = 0;
+                frame_stats.Shown[i]++;
+            }
+        }
+    }
+
+    if(TLI_Interrupt_Flag_Get(TLI_INT_Flag_LM) == SET) {
+        TLI_Interrupt_Flag_Clear(TLI_INT_Flag_LM);
+        frame_stats.Marks++;
+
+        for(i = 0; i < 2; i++) {
+            if(frame[i].used == 0 || frame[i].pending == 0 || frame[i].reload) continue;
+
+            if(IPAQ_FenceDone(frame[i].fence)) {
+                TLI_LxFBADDR(layer_base[i]) = frame[i].fb[frame[i].front ^ 1];
+                frame[i].reload = 1;
+                request = 1;
+            } else {
+                frame_stats.Late[i]++;
+            }
+        }
+
+        if(request) TLI_Reload_Config(TLI_Frame_BLANK_Reload_EN);
+    }
+}
+
+#endif /* GD32F450 and GD32F470 */
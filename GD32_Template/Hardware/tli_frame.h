@@ -0,0 +1,45 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : tli_frame.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : GD32F450/470 TLI两个图层各自双缓冲, 在行标记中断中换帧
+  * Function List:
+  *		Frame_Init
+  *		Frame_LayerSetup
+  *		Frame_Begin
+  *		Frame_Present
+  *		Frame_GetStats
+  ******************************************************
+**/
+
+#ifndef __TLI_FRAME_H_
+#define __TLI_FRAME_H_
+
+#include "gd32f4xx.h"
+#include "ipa_queue.h"
+
+#if defined (GD32F450) || defined (GD32F470)
+
+typedef struct {
+    uint32_t Marks;				//行标记中断次数, 即扫描的帧数
+    uint32_t Shown[2];			//各图层切换显示的新帧数
+    uint32_t Late[2];			//新帧已提交但IPA还没画完, 重复显示旧帧的次数
+} Frame_Stats;
+
+void Frame_Init(uint16_t line);	// TLI须已初始化并使能; line 一般取 activesz_vasz, 即有效区之后的第一行
+void Frame_LayerSetup(uint8_t layer, uint32_t buf0, uint32_t buf1);	// layer 为0/1, 图层须已用 buf0 初始化并使能
+uint32_t Frame_Begin(uint8_t layer);	// 等待该图层后台缓冲空闲, 返回其地址
+void Frame_Present(uint8_t layer, IPAQ_Fence_t fence);	// 提交后台缓冲, fence 完成后在下一帧开始显示
+void Frame_GetStats(Frame_Stats * stats);	// 读取统计信息
+
+#endif /* GD32F450 and GD32F470 */
+
+#endif
@@ -8,6 +8,7 @@
    2022-03-31       CDT             First version
    2022-06-30       CDT             Add USB core ID select function
    2022-10-31       CDT             Add USB DMA function
+   2026-10-19       txt1994         Unrolled FIFO copy loops for aligned buffers, check DMA address alignment
  @endverbatim
  *******************************************************************************
  * Copyright (C) 2022-2023, Xiaohua Semiconductor Co., Ltd. All rights reserved.
@@ -127,24 +128,39 @@ void usb_coresoftrst(LL_USB_TypeDef *USBx) {
  * @param  [in] len         length in bytes
  * @param  [in] u8DmaEn     USB DMA status
  * @retval 无
+ * @note   In DMA mode the core fetches the data itself from the address in
+ *         DIEPDMA/HCDMA, programmed when the transfer begins, so nothing is
+ *         written here.
  */
 void usb_wrpkt(LL_USB_TypeDef *USBx, uint8_t *src, uint8_t ch_ep_num, uint16_t len, uint8_t u8DmaEn) {
-    __IO uint32_t u32pAddr;
     __IO uint32_t *fifo;
+    const uint32_t *pu32Src;
     uint32_t u32Count32b;
-    uint32_t u32Tmp;
 
     if (u8DmaEn == 0U) {
-        u32Count32b = (len + 3UL);
-        u32Count32b = u32Count32b >> 2U;
+        u32Count32b = ((uint32_t)len + 3UL) >> 2U;
         fifo = USBx->DFIFO[ch_ep_num];
-        u32Tmp = 0UL;
 
-        while (u32Tmp < u32Count32b) {
-            WRITE_REG32(*fifo, *((uint32_t *)src));
-            u32pAddr = (uint32_t)src;
-            src = (uint8_t *)(u32pAddr + 4U);
-            u32Tmp++;
+        if (IS_ADDR_ALIGN_WORD(src)) {
+            pu32Src = (const uint32_t *)src;
+
+            while (u32Count32b >= 4UL) {
+                WRITE_REG32(*fifo, pu32Src[0]);
+                WRITE_REG32(*fifo, pu32Src[1]);
+                WRITE_REG32(*fifo, pu32Src[2]);
+                WRITE_REG32(*fifo, pu32Src[3]);
+                pu32Src += 4U;
+                u32Count32b -= 4UL;
+            }
+
+            src = (uint8_t *)pu32Src;
+        }
+
+        /* One word access at a time, safe on an unaligned buffer */
+        while (u32Count32b > 0UL) {
+            WRITE_REG32(*fifo, __UNALIGNED_UINT32_READ(src));
+            src += 4U;
+            u32Count32b--;
         }
     }
 }
@@ -155,23 +171,44 @@ void usb_wrpkt(LL_USB_TypeDef *USBx, uint8_t *src, uint8_t ch_ep_num, uint16_t l
  * @param  [in] dest        destination pointer that point to the received data
  * @param  [in] len         number of bytes
  * @retval 无
+ * @note   Only used in slave mode, in DMA mode the core writes the data to the
+ *         address in DOEPDMA/HCDMA.
  */
 void usb_rdpkt(LL_USB_TypeDef *USBx, uint8_t *dest, uint16_t len) {
-    uint32_t u32Tmp;
-    __IO uint32_t u32Count32b;
-    __IO uint32_t u32pAddr;
-
     __IO uint32_t *fifo = USBx->DFIFO[0];
-    u32Count32b = (len + 3UL);
-    u32Count32b = u32Count32b >> 2U;
-    u32pAddr = 0UL;
-    u32Tmp = 0UL;
+    uint32_t *pu32Dest;
+    uint32_t u32Count32b = (uint32_t)len >> 2U;
+    uint32_t u32Tail = (uint32_t)len & 3UL;
+    uint32_t u32Word;
+    uint32_t i;
+
+    if (IS_ADDR_ALIGN_WORD(dest)) {
+        pu32Dest = (uint32_t *)dest;
+
+        while (u32Count32b >= 4UL) {
+            pu32Dest[0] = READ_REG32(*fifo);
+            pu32Dest[1] = READ_REG32(*fifo);
+            pu32Dest[2] = READ_REG32(*fifo);
+            pu32Dest[3] = READ_REG32(*fifo);
+            pu32Dest += 4U;
+            u32Count32b -= 4UL;
+        }
 
-    while (u32Tmp < u32Count32b) {
-        *(uint32_t *)dest = READ_REG32(*fifo);
-        u32pAddr = (uint32_t)dest;
-        dest = (uint8_t *)(u32pAddr + 4U);
-        u32Tmp++;
+        dest = (uint8_t *)pu32Dest;
+    }
+
+    while (u32Count32b > 0UL) {
+        __UNALIGNED_UINT32_WRITE(dest, READ_REG32(*fifo));
+        dest += 4U;
+        u32Count32b--;
+    }
+
+    /* The last word holds 1..3 bytes, store only those so the buffer is never overrun */
+    if (u32Tail > 0UL) {
+        u32Word = READ_REG32(*fifo);
+        for (i = 0UL; i < u32Tail; i++) {
+            dest[i] = (uint8_t)(u32Word >> (i * 8UL));
+        }
     }
 }
 
@@ -824,6 +861,7 @@ void usb_epntransbegin(LL_USB_TypeDef *USBx, USB_DEV_EP *ep, uint8_t u8DmaEn) {
         MODIFY_REG32(USBx->INEP_REGS[ep->epidx]->DIEPTSIZ, USBFS_DIEPTSIZ_XFRSIZ | USBFS_DIEPTSIZ_PKTCNT, u32DeptsizTmp);
 
         if (u8DmaEn == 1U) {
+            DDL_ASSERT(IS_ADDR_ALIGN_WORD(ep->dma_addr));
             WRITE_REG32(USBx->INEP_REGS[ep->epidx]->DIEPDMA, ep->dma_addr);
         } else {
             if (ep->trans_type != EP_TYPE_ISOC) {
@@ -869,6 +907,7 @@ void usb_epntransbegin(LL_USB_TypeDef *USBx, USB_DEV_EP *ep, uint8_t u8DmaEn) {
         MODIFY_REG32(USBx->OUTEP_REGS[ep->epidx]->DOEPTSIZ, USBFS_DOEPTSIZ_XFRSIZ | USBFS_DOEPTSIZ_PKTCNT, u32DeptsizTmp);
 
         if (u8DmaEn == 1U) {
+            DDL_ASSERT(IS_ADDR_ALIGN_WORD(ep->dma_addr));
             WRITE_REG32(USBx->OUTEP_REGS[ep->epidx]->DOEPDMA, ep->dma_addr);
         }
 
@@ -921,6 +960,7 @@ void usb_ep0transbegin(LL_USB_TypeDef *USBx, USB_DEV_EP *ep, uint8_t u8DmaEn) {
         MODIFY_REG32(USBx->INEP_REGS[0]->DIEPTSIZ, USBFS_DIEPTSIZ_XFRSIZ | USBFS_DIEPTSIZ_PKTCNT, u32DeptsizTmp);
 
         if (u8DmaEn == 1U) {
+            DDL_ASSERT(IS_ADDR_ALIGN_WORD(ep->dma_addr));
             WRITE_REG32(USBx->INEP_REGS[ep->epidx]->DIEPDMA, ep->dma_addr);
         }
 
@@ -952,6 +992,7 @@ void usb_ep0transbegin(LL_USB_TypeDef *USBx, USB_DEV_EP *ep, uint8_t u8DmaEn) {
         MODIFY_REG32(USBx->OUTEP_REGS[ep->epidx]->DOEPTSIZ, USBFS_DOEPTSIZ_XFRSIZ | USBFS_DOEPTSIZ_PKTCNT, u32DeptsizTmp);
 
         if (u8DmaEn == 1U) {
+            DDL_ASSERT(IS_ADDR_ALIGN_WORD(ep->dma_addr));
             WRITE_REG32(USBx->OUTEP_REGS[ep->epidx]->DOEPDMA, ep->dma_addr);
         }
 
@@ -1029,6 +1070,7 @@ void usb_ep0revcfg(LL_USB_TypeDef *USBx, uint8_t u8DmaEn, uint8_t *u8RevBuf) {
     WRITE_REG32(USBx->OUTEP_REGS[0]->DOEPTSIZ, u32deptsize);
 
     if (u8DmaEn == 1U) {
+        DDL_ASSERT(IS_ADDR_ALIGN_WORD(u8RevBuf));
         WRITE_REG32(USBx->OUTEP_REGS[0]->DOEPDMA, (uint32_t)&u8RevBuf[0]);
         u32doepctl = READ_REG32(USBx->OUTEP_REGS[0]->DOEPCTL);
         u32doepctl |= (USBFS_DOEPCTL_EPENA | USBFS_DOEPCTL_USBAEP);
@@ -1307,7 +1349,10 @@ uint8_t usb_hchtransbegin(LL_USB_TypeDef *USBx, uint8_t hc_num, USB_HOST_CH *pCh
     WRITE_REG32(USBx->HC_REGS[hc_num]->HCTSIZ, u32hctsiz);
 
     if (u8DmaEn == 1U) {
-        WRITE_REG32(USBx->HC_REGS[hc_num]->HCDMA, pCh->xfer_buff);
+        /* The DMA works on whole words: the buffer must be word aligned */
+        pCh->dma_addr = (uint32_t)pCh->xfer_buff;
+        DDL_ASSERT(IS_ADDR_ALIGN_WORD(pCh->dma_addr));
+        WRITE_REG32(USBx->HC_REGS[hc_num]->HCDMA, pCh->dma_addr);
     }
 
     u32hcchar = READ_REG32(USBx->HC_REGS[hc_num]->HCCHAR);
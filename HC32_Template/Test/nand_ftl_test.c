@@ -0,0 +1,476 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : nand_ftl_test.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					Host test of nand_ftl.c against a RAM model of the NAND. The model
+					keeps two copies of every page: the cells, where bits are flipped,
+					and the programmed data. A read counts the differing bits per
+					512-byte section like the NFC 4-bit BCH: up to SIM_BCH_T bits per
+					section come back corrected with the count, more is FTL_ERR_ECC.
+					Programming a page twice, or a page that is not erased, fails the
+					test. Every SIM_DISTURB_READS reads of a block flip one bit in
+					another programmed page of the block (read disturb), and the next
+					program of a chosen block can be made to fail.
+					  1. Format with two factory bad blocks, fill the device, overwrite
+					     it sequentially without a single GC copy, then random overwrites
+					     with GC and read-modify-write.
+					  2. Correctable bits in one page: the block is relocated.
+					  3. Too many bits in one section: FTL_ERR_ECC, the rest of the
+					     block is relocated.
+					  4. Two hot pages in one block read in turn, nothing written: every
+					     block they pass through keeps below SIM_BCH_T bits per section
+					     and nothing becomes unreadable.
+					  5. Program failure: the data is moved out and the block marked bad.
+					  6. Remount and check everything, including the bad blocks.
+					The FTL source is included so the test can find the physical page
+					of a logical one. Build and run from this directory:
+					  gcc -O2 -Wall -I../User/BSP nand_ftl_test.c -o nand_ftl_test
+					  ./nand_ftl_test
+					Returns 0 when every check passes.
+  * Function List:
+  *		main
+  **********************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Small device so a run takes well under a second; the FTL sees the same sizes as on target */
+#define FTL_PAGE_SIZE               (2048UL)
+#define FTL_PAGES_PER_BLOCK         (16UL)
+#define FTL_BLOCK_NUM               (64UL)
+#define FTL_DISTURB_READS           (1000UL)
+
+#include "nand_ftl.c"
+
+#define SIM_PAGE_BYTES              (FTL_PAGE_SIZE + FTL_SPARE_SIZE)
+#define SIM_PAGES                   (FTL_BLOCK_NUM * FTL_PAGES_PER_BLOCK)
+#define SIM_SECTION                 (512UL)
+#define SIM_SECTIONS                (FTL_PAGE_SIZE / SIM_SECTION)   /* Spare bytes belong to the last one */
+#define SIM_BCH_T                   (4UL)
+#define SIM_DISTURB_READS           (64UL)
+
+#define TEST_SECTORS                (FTL_LPN_NUM * FTL_SECTORS_PER_PAGE)
+#define TEST_CHUNK                  (8UL)
+
+static uint8_t m_au8Cell[SIM_PAGES][SIM_PAGE_BYTES];
+static uint8_t m_au8Data[SIM_PAGES][SIM_PAGE_BYTES];
+static uint8_t m_au8Used[SIM_PAGES];
+static uint8_t m_au8Bad[FTL_BLOCK_NUM];
+static uint32_t m_au32SimReads[FTL_BLOCK_NUM];
+static uint32_t m_au32SimErase[FTL_BLOCK_NUM];
+static uint32_t m_u32Disturb = 0UL;             /* 0: off */
+static uint32_t m_u32FailBlk = FTL_NONE;        /* Next program in this block fails */
+static uint32_t m_u32MaxSection;                /* Most flipped bits seen in one section */
+
+static uint32_t m_au32Gen[TEST_SECTORS];        /* 0: never written, reads as 0xFF */
+static uint32_t m_u32Gen;
+static uint32_t m_u32Rnd = 2463534242UL;
+static int m_iFailed;
+
+#define CHECK(c)    do { if (!(c)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #c); m_iFailed = 1; } } while (0)
+
+static uint32_t Rnd(void) {
+    m_u32Rnd ^= m_u32Rnd << 13;
+    m_u32Rnd ^= m_u32Rnd >> 17;
+    m_u32Rnd ^= m_u32Rnd << 5;
+    return m_u32Rnd;
+}
+
+static void SIM_Flip(uint32_t u32Page, uint32_t u32Section) {
+    uint32_t u32End = (u32Section == (SIM_SECTIONS - 1UL)) ? SIM_PAGE_BYTES : ((u32Section + 1UL) * SIM_SECTION);
+    uint32_t u32Byte = u32Section * SIM_SECTION + Rnd() % (u32End - u32Section * SIM_SECTION);
+    uint8_t u8Bit = (uint8_t)(1U << (Rnd() & 7U));
+
+    /* Flip a bit that still matches, so repeated flips add up */
+    while (((m_au8Cell[u32Page][u32Byte] ^ m_au8Data[u32Page][u32Byte]) & u8Bit) != 0U) {
+        u8Bit = (uint8_t)((u8Bit << 1) | (u8Bit >> 7));
+    }
+
+    m_au8Cell[u32Page][u32Byte] ^= u8Bit;
+}
+
+static int32_t SIM_Read(uint32_t u32Page, uint8_t *pu8Buf, uint32_t *pu32BitFlips) {
+    const uint32_t u32Blk = u32Page / FTL_PAGES_PER_BLOCK;
+    int32_t i32Ret = FTL_OK;
+    uint32_t u32Bits;
+    uint32_t u32End;
+    uint32_t s;
+    uint32_t i;
+    uint32_t u32Victim;
+
+    *pu32BitFlips = 0UL;
+
+    for (s = 0UL; s < SIM_SECTIONS; s++) {
+        u32End = (s == (SIM_SECTIONS - 1UL)) ? SIM_PAGE_BYTES : ((s + 1UL) * SIM_SECTION);
+
+        for (u32Bits = 0UL, i = s * SIM_SECTION; i < u32End; i++) {
+            u32Bits += (uint32_t)__builtin_popcount(m_au8Cell[u32Page][i] ^ m_au8Data[u32Page][i]);
+        }
+
+        if (u32Bits > m_u32MaxSection) {
+            m_u32MaxSection = u32Bits;
+        }
+
+        if (u32Bits > SIM_BCH_T) {
+            i32Ret = FTL_ERR_ECC;
+        }
+
+        *pu32BitFlips += u32Bits;
+    }
+
+    (void)memcpy(pu8Buf, (FTL_OK == i32Ret) ? m_au8Data[u32Page] : m_au8Cell[u32Page], SIM_PAGE_BYTES);
+
+    if ((0UL != m_u32Disturb) && (0UL == (++m_au32SimReads[u32Blk] % m_u32Disturb))) {
+        u32Victim = u32Blk * FTL_PAGES_PER_BLOCK + Rnd() % FTL_PAGES_PER_BLOCK;
+
+        if ((u32Victim != u32Page) && (0U != m_au8Used[u32Victim])) {
+            SIM_Flip(u32Victim, Rnd() % SIM_SECTIONS);
+        }
+    }
+
+    return i32Ret;
+}
+
+static int32_t SIM_Program(uint32_t u32Page, const uint8_t *pu8Buf) {
+    uint32_t i;
+
+    CHECK(0U == m_au8Used[u32Page]);
+
+    for (i = 0UL; i < SIM_PAGE_BYTES; i++) {
+        if (0xFFU != m_au8Cell[u32Page][i]) {
+            CHECK(0 == "program of a page that is not erased");
+            return FTL_ERR;
+        }
+    }
+
+    m_au8Used[u32Page] = 1U;
+
+    if ((u32Page / FTL_PAGES_PER_BLOCK) == m_u32FailBlk) {
+        m_u32FailBlk = FTL_NONE;
+        (void)memset(m_au8Cell[u32Page], 0x5A, SIM_PAGE_BYTES / 2UL);
+        (void)memcpy(m_au8Data[u32Page], m_au8Cell[u32Page], SIM_PAGE_BYTES);
+        return FTL_ERR;
+    }
+
+    (void)memcpy(m_au8Cell[u32Page], pu8Buf, SIM_PAGE_BYTES);
+    (void)memcpy(m_au8Data[u32Page], pu8Buf, SIM_PAGE_BYTES);
+
+    return FTL_OK;
+}
+
+static int32_t SIM_Erase(uint32_t u32Blk) {
+    const uint32_t u32Page = u32Blk * FTL_PAGES_PER_BLOCK;
+
+    CHECK(0U == m_au8Bad[u32Blk]);
+    (void)memset(m_au8Cell[u32Page], 0xFF, FTL_PAGES_PER_BLOCK * SIM_PAGE_BYTES);
+    (void)memset(m_au8Data[u32Page], 0xFF, FTL_PAGES_PER_BLOCK * SIM_PAGE_BYTES);
+    (void)memset(&m_au8Used[u32Page], 0, FTL_PAGES_PER_BLOCK);
+    m_au32SimReads[u32Blk] = 0UL;
+    m_au32SimErase[u32Blk]++;
+
+    return FTL_OK;
+}
+
+static int32_t SIM_IsBad(uint32_t u32Blk) {
+    return m_au8Bad[u32Blk];
+}
+
+static int32_t SIM_MarkBad(uint32_t u32Blk) {
+    m_au8Bad[u32Blk] = 1U;
+    return FTL_OK;
+}
+
+static const stc_ftl_nand_ops_t m_stcSimOps = {
+    SIM_Read, SIM_Program, SIM_Erase, SIM_IsBad, SIM_MarkBad,
+};
+
+static void Fill(uint32_t u32Sector, uint32_t u32Gen, uint8_t *pu8Buf) {
+    uint32_t u32X = (u32Sector * 2654435761UL) ^ (u32Gen * 40503UL) ^ 0x9E3779B9UL;
+    uint32_t i;
+
+    if (0UL == u32Gen) {
+        (void)memset(pu8Buf, 0xFF, FTL_SECTOR_SIZE);
+        return;
+    }
+
+    for (i = 0UL; i < FTL_SECTOR_SIZE; i++) {
+        u32X ^= u32X << 13;
+        u32X ^= u32X >> 17;
+        u32X ^= u32X << 5;
+        pu8Buf[i] = (uint8_t)u32X;
+    }
+}
+
+static void Write(uint32_t u32Sector, uint32_t u32Count) {
+    static uint8_t au8Buf[TEST_CHUNK * FTL_SECTOR_SIZE];
+    uint32_t i;
+
+    for (i = 0UL; i < u32Count; i++) {
+        m_au32Gen[u32Sector + i] = ++m_u32Gen;
+        Fill(u32Sector + i, m_u32Gen, &au8Buf[i * FTL_SECTOR_SIZE]);
+    }
+
+    CHECK(FTL_OK == FTL_Write(u32Sector, au8Buf, u32Count));
+}
+
+static int32_t Check(uint32_t u32Sector, uint32_t u32Count) {
+    static uint8_t au8Buf[TEST_CHUNK * FTL_SECTOR_SIZE];
+    uint8_t au8Want[FTL_SECTOR_SIZE];
+    int32_t i32Ret = FTL_Read(u32Sector, au8Buf, u32Count);
+    uint32_t i;
+
+    if (FTL_OK != i32Ret) {
+        return i32Ret;
+    }
+
+    for (i = 0UL; i < u32Count; i++) {
+        Fill(u32Sector + i, m_au32Gen[u32Sector + i], au8Want);
+
+        if (0 != memcmp(&au8Buf[i * FTL_SECTOR_SIZE], au8Want, FTL_SECTOR_SIZE)) {
+            printf("sector %u: wrong data\n", (unsigned)(u32Sector + i));
+            return FTL_ERR;
+        }
+    }
+
+    return FTL_OK;
+}
+
+static void CheckAll(void) {
+    uint32_t i;
+
+    for (i = 0UL; i < TEST_SECTORS; i += TEST_CHUNK) {
+        CHECK(FTL_OK == Check(i, TEST_CHUNK));
+    }
+}
+
+/* A mapped logical page in a full block, searched from u32From */
+static uint32_t FullLpn(uint32_t u32From) {
+    uint32_t i;
+
+    for (i = u32From; i < FTL_LPN_NUM; i++) {
+        if ((FTL_NONE != m_au32L2p[i]) && (FTL_BLK_FULL == m_au8State[m_au32L2p[i] / FTL_PAGES_PER_BLOCK])) {
+            return i;
+        }
+    }
+
+    return FTL_NONE;
+}
+
+static void TestFill(void) {
+    stc_ftl_stats_t stcStats;
+    uint32_t u32Count;
+    uint32_t i;
+
+    m_au8Bad[5] = 1U;
+    m_au8Bad[40] = 1U;
+    CHECK(FTL_OK == FTL_Format(&m_stcSimOps));
+    CHECK(TEST_SECTORS == FTL_GetSectorCount());
+
+    for (i = 0UL; i < TEST_SECTORS; i += TEST_CHUNK) {
+        Write(i, TEST_CHUNK);
+    }
+
+    CheckAll();
+
+    /* A sequential log over it: whole blocks go stale together and GC only erases */
+    for (i = 0UL; i < TEST_SECTORS; i += TEST_CHUNK) {
+        Write(i, TEST_CHUNK);
+    }
+
+    CheckAll();
+    FTL_GetStats(&stcStats);
+    printf("sequential: host %u, gc %u, erases %u\n",
+           (unsigned)stcStats.u32HostPages, (unsigned)stcStats.u32GcPages, (unsigned)stcStats.u32Erases);
+    CHECK((2UL * FTL_LPN_NUM) == stcStats.u32HostPages);
+    CHECK(0UL == stcStats.u32GcPages);
+    CHECK(2UL == stcStats.u32BadBlocks);
+
+    /* Random overwrites of 1..8 sectors, partial pages go through the cache and RMW */
+    for (i = 0UL; i < 4000UL; i++) {
+        u32Count = 1UL + Rnd() % TEST_CHUNK;
+        Write(Rnd() % (TEST_SECTORS - u32Count + 1UL), u32Count);
+
+        if (0UL == (i % 64UL)) {
+            CHECK(FTL_OK == FTL_Background());
+        }
+    }
+
+    CHECK(FTL_OK == FTL_Flush());
+    CheckAll();
+    FTL_GetStats(&stcStats);
+    printf("random:     host %u, gc %u, rmw %u, erases %u, erase count %u..%u\n",
+           (unsigned)stcStats.u32HostPages, (unsigned)stcStats.u32GcPages, (unsigned)stcStats.u32Rmw,
+           (unsigned)stcStats.u32Erases, (unsigned)stcStats.u32MinErase, (unsigned)stcStats.u32MaxErase);
+    CHECK(0UL != stcStats.u32GcPages);
+    CHECK(0UL != stcStats.u32Rmw);
+}
+
+static void TestCorrectable(void) {
+    stc_ftl_stats_t stcStats;
+    uint32_t u32Lpn = FullLpn(100UL);
+    uint32_t u32Ppn = m_au32L2p[u32Lpn];
+    uint32_t u32Blk = u32Ppn / FTL_PAGES_PER_BLOCK;
+    uint32_t u32Erase = m_au32SimErase[u32Blk];
+    uint32_t u32Flips;
+
+    FTL_GetStats(&stcStats);
+    u32Flips = stcStats.u32BitFlips;
+    SIM_Flip(u32Ppn, 0UL);
+    SIM_Flip(u32Ppn, 0UL);
+    SIM_Flip(u32Ppn, 3UL);
+
+    CHECK(FTL_OK == Check(0UL, 1UL));   /* Drop the FTL's copy of the last page read */
+    CHECK(FTL_OK == Check(u32Lpn * FTL_SECTORS_PER_PAGE, FTL_SECTORS_PER_PAGE));
+    FTL_GetStats(&stcStats);
+    CHECK(3UL == (stcStats.u32BitFlips - u32Flips));
+    CHECK(0U != (m_au8Flag[u32Blk] & FTL_FLAG_SCRUB));
+
+    CHECK(FTL_OK == FTL_Background());
+    CHECK((m_au32L2p[u32Lpn] / FTL_PAGES_PER_BLOCK) != u32Blk);
+    CHECK(m_au32SimErase[u32Blk] == (u32Erase + 1UL));
+    CheckAll();
+}
+
+static void TestUncorrectable(void) {
+    stc_ftl_stats_t stcStats;
+    uint32_t u32Lpn = FullLpn(300UL);
+    uint32_t u32Ppn = m_au32L2p[u32Lpn];
+    uint32_t u32Blk = u32Ppn / FTL_PAGES_PER_BLOCK;
+    uint32_t i;
+
+    for (i = 0UL; i <= SIM_BCH_T; i++) {
+        SIM_Flip(u32Ppn, 1UL);
+    }
+
+    CHECK(FTL_OK == Check(0UL, 1UL));
+    CHECK(FTL_ERR_ECC == Check(u32Lpn * FTL_SECTORS_PER_PAGE, 1UL));
+    FTL_GetStats(&stcStats);
+    CHECK(1UL == stcStats.u32EccFail);
+
+    /* The other pages of the block move out, the lost one is unmapped; the host rewrites it */
+    CHECK(FTL_OK == FTL_Background());
+    CHECK(FTL_NONE == m_au32L2p[u32Lpn]);
+    CHECK(FTL_BLK_FREE == m_au8State[u32Blk]);
+
+    for (i = 0UL; i < FTL_SECTORS_PER_PAGE; i++) {
+        m_au32Gen[u32Lpn * FTL_SECTORS_PER_PAGE + i] = 0UL;
+    }
+
+    CheckAll();
+    Write(u32Lpn * FTL_SECTORS_PER_PAGE, FTL_SECTORS_PER_PAGE);
+    CheckAll();
+}
+
+static void TestReadDisturb(void) {
+    stc_ftl_stats_t stcStats;
+    uint32_t au32Hot[2];
+    uint32_t u32Gc;
+    uint32_t u32EccFail;
+    uint32_t u32Blk;
+    uint32_t i;
+
+    au32Hot[0] = FullLpn(500UL);
+    u32Blk = m_au32L2p[au32Hot[0]] / FTL_PAGES_PER_BLOCK;
+
+    for (au32Hot[1] = 0UL; au32Hot[1] < FTL_LPN_NUM; au32Hot[1]++) {
+        if ((au32Hot[1] != au32Hot[0]) && ((m_au32L2p[au32Hot[1]] / FTL_PAGES_PER_BLOCK) == u32Blk)) {
+            break;
+        }
+    }
+
+    CHECK(au32Hot[1] < FTL_LPN_NUM);
+    FTL_GetStats(&stcStats);
+    u32Gc = stcStats.u32GcPages;
+    u32EccFail = stcStats.u32EccFail;
+    m_u32MaxSection = 0UL;
+    m_u32Disturb = SIM_DISTURB_READS;
+
+    /* Only reads: the cold pages next to the hot ones are never read, so their bits are only
+       caught by the read count. The hot pages go through the open block after the first move */
+    for (i = 0UL; i < 40000UL; i++) {
+        CHECK(FTL_OK == Check(au32Hot[i & 1UL] * FTL_SECTORS_PER_PAGE + (i >> 1) % FTL_SECTORS_PER_PAGE, 1UL));
+
+        if (0UL == (i % 16UL)) {
+            CHECK(FTL_OK == FTL_Background());
+        }
+    }
+
+    m_u32Disturb = 0UL;
+    CHECK(FTL_OK == FTL_Flush());
+    CheckAll();
+    FTL_GetStats(&stcStats);
+    printf("disturb:    gc %u, bits corrected %u, most bits in a section %u\n",
+           (unsigned)(stcStats.u32GcPages - u32Gc), (unsigned)stcStats.u32BitFlips, (unsigned)m_u32MaxSection);
+    CHECK(u32EccFail == stcStats.u32EccFail);
+    CHECK(m_u32MaxSection <= SIM_BCH_T);
+    CHECK(m_au32SimErase[u32Blk] > 1UL);
+}
+
+static void TestProgramFail(void) {
+    stc_ftl_stats_t stcStats;
+    uint32_t u32Blk;
+    uint32_t i;
+
+    Write(0UL, FTL_SECTORS_PER_PAGE);
+    CHECK(FTL_NONE != m_u32OpenBlk);
+    u32Blk = m_u32OpenBlk;
+    m_u32FailBlk = u32Blk;
+
+    for (i = 0UL; i < 4UL; i++) {
+        Write((10UL + i) * FTL_SECTORS_PER_PAGE, FTL_SECTORS_PER_PAGE);
+    }
+
+    CHECK(FTL_NONE == m_u32FailBlk);
+    CHECK(u32Blk != m_u32OpenBlk);
+    CheckAll();
+
+    CHECK(FTL_OK == FTL_Background());
+    CHECK(1U == m_au8Bad[u32Blk]);
+    CHECK(FTL_BLK_BAD == m_au8State[u32Blk]);
+    FTL_GetStats(&stcStats);
+    CHECK(3UL == stcStats.u32BadBlocks);
+    CheckAll();
+}
+
+static void TestRemount(void) {
+    stc_ftl_stats_t stcStats;
+
+    CHECK(FTL_OK == FTL_Flush());
+    CHECK(FTL_OK == FTL_Mount(&m_stcSimOps));
+    FTL_GetStats(&stcStats);
+    CHECK(3UL == stcStats.u32BadBlocks);
+    CHECK(0UL == stcStats.u32EccFail);
+    CHECK(0UL == stcStats.u32GcPages);
+    CheckAll();
+
+    Write(TEST_SECTORS - TEST_CHUNK, TEST_CHUNK);
+    CHECK(FTL_OK == FTL_Flush());
+    CheckAll();
+}
+
+int main(void) {
+    (void)memset(m_au8Cell, 0xFF, sizeof(m_au8Cell));
+    (void)memset(m_au8Data, 0xFF, sizeof(m_au8Data));
+
+    TestFill();
+    TestCorrectable();
+    TestUncorrectable();
+    TestReadDisturb();
+    TestProgramFail();
+    TestRemount();
+
+    printf("%s\n", m_iFailed ? "nand_ftl_test: FAILED" : "nand_ftl_test: OK");
+    return m_iFailed;
+}
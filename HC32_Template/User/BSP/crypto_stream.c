@@ -0,0 +1,723 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : crypto_stream.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					HASH_Calculate/HASH_HMAC_Calculate only take one contiguous buffer and
+					AES_Encrypt/AES_Decrypt reload the key for every call and only do ECB.
+					This module keeps the state in a context so data can be fed in chunks:
+					  - SHA-256/HMAC: whole 64-byte groups go straight from the caller's buffer
+					    to the data registers, only the incomplete tail (< 64 bytes) is copied;
+					    padding is done once in HASH_Stream_Final.
+					  - AES: the key is written to the engine once and stays there while the same
+					    context is used; CBC/CTR/GCM are built on the engine's ECB block, GHASH
+					    uses a 4-bit table.
+					Neither engine can be fed by DMA: HASH wants big-endian words (the DMA cannot
+					swap bytes) and AES START has no AOS trigger, so the CPU writes the registers.
+  * Function List:
+  *		HASH_Stream_Init
+  *		HASH_Stream_Update
+  *		HASH_Stream_Final
+  *		AES_Stream_Init
+  *		AES_Stream_Aad
+  *		AES_Stream_Update
+  *		AES_Stream_Final
+  **********************************************************
+ */
+
+#include "crypto_stream.h"
+#include <string.h>
+
+#define CRYPTO_TIMEOUT              (30000UL)
+#define HASH_GROUP_SIZE             (64U)
+#define HASH_LAST_GROUP_SIZE_MAX    (56U)
+#define HASH_KEY_LONG_SIZE          (64U)
+#define AES_BLOCK_SIZE              (16U)
+
+static stc_hash_stream_t *m_pstcHashOwner = NULL;
+static stc_aes_stream_t *m_pstcAesOwner = NULL;
+
+/* Reduction table for the 4-bit GHASH multiplication */
+static const uint16_t m_au16Last4[16] = {
+    0x0000U, 0x1C20U, 0x3840U, 0x2460U, 0x7080U, 0x6CA0U, 0x48C0U, 0x54E0U,
+    0xE100U, 0xFD20U, 0xD940U, 0xC560U, 0x9180U, 0x8DA0U, 0xA9C0U, 0xB5E0U
+};
+
+/**
+ * @brief  Read a word from a possibly unaligned buffer.
+ */
+static uint32_t Crypto_Load32(const uint8_t *pu8Data) {
+    uint32_t u32Word;
+
+    (void)memcpy(&u32Word, pu8Data, 4U);
+    return u32Word;
+}
+
+static void Crypto_Xor(uint8_t *pu8Dest, const uint8_t *pu8A, const uint8_t *pu8B, uint32_t u32Size) {
+    uint32_t i;
+
+    for (i = 0UL; i < u32Size; i++) {
+        pu8Dest[i] = pu8A[i] ^ pu8B[i];
+    }
+}
+
+static void Crypto_PutBE32(uint8_t *pu8Dest, uint32_t u32Value) {
+    pu8Dest[0] = (uint8_t)(u32Value >> 24U);
+    pu8Dest[1] = (uint8_t)(u32Value >> 16U);
+    pu8Dest[2] = (uint8_t)(u32Value >> 8U);
+    pu8Dest[3] = (uint8_t)u32Value;
+}
+
+static uint64_t Crypto_GetBE64(const uint8_t *pu8Src) {
+    uint64_t u64Value = 0ULL;
+    uint8_t i;
+
+    for (i = 0U; i < 8U; i++) {
+        u64Value = (u64Value << 8U) | pu8Src[i];
+    }
+
+    return u64Value;
+}
+
+/*************************************** HASH ***************************************/
+
+/**
+ * @brief  Wait until the given HASH CR bit is cleared.
+ */
+static int32_t HASH_Stream_Wait(uint32_t u32Bit) {
+    __IO uint32_t u32TimeCount = 0UL;
+
+    while (READ_REG32_BIT(CM_HASH->CR, u32Bit) != 0UL) {
+        if (u32TimeCount++ > CRYPTO_TIMEOUT) {
+            return LL_ERR_TIMEOUT;
+        }
+    }
+
+    return LL_OK;
+}
+
+/**
+ * @brief  Process one 64-byte group.
+ * @param  [in] pstcCtx                 HASH stream context.
+ * @param  [in] pu8Data                 64 bytes, no alignment required.
+ * @param  [in] u8Last                  Non-zero for the last group of the key or message.
+ */
+static int32_t HASH_Stream_Group(stc_hash_stream_t *pstcCtx, const uint8_t *pu8Data, uint8_t u8Last) {
+    uint8_t i;
+    __IO uint32_t *regDR = &CM_HASH->DR15;
+
+    for (i = 0U; i < (HASH_GROUP_SIZE / 4U); i++) {
+        regDR[i] = __REV(Crypto_Load32(&pu8Data[i * 4U]));
+    }
+
+    if (pstcCtx->u8FirstGroup != 0U) {
+        pstcCtx->u8FirstGroup = 0U;
+        WRITE_REG32(bCM_HASH->CR_b.FST_GRP, 1U);
+    }
+
+    if (u8Last != 0U) {
+        WRITE_REG32(bCM_HASH->CR_b.KMSG_END, 1U);
+    }
+
+    WRITE_REG32(bCM_HASH->CR_b.START, 1U);
+    return HASH_Stream_Wait(HASH_CR_START);
+}
+
+static int32_t HASH_Stream_Absorb(stc_hash_stream_t *pstcCtx, const uint8_t *pu8Data, uint32_t u32Size) {
+    uint32_t u32Len;
+    int32_t i32Ret = LL_OK;
+
+    pstcCtx->u32TotalLen += u32Size;
+
+    if (pstcCtx->u32TailLen != 0UL) {
+        u32Len = LL_MIN(HASH_GROUP_SIZE - pstcCtx->u32TailLen, u32Size);
+        (void)memcpy(&pstcCtx->au8Tail[pstcCtx->u32TailLen], pu8Data, u32Len);
+        pstcCtx->u32TailLen += u32Len;
+        pu8Data += u32Len;
+        u32Size -= u32Len;
+
+        if (pstcCtx->u32TailLen < HASH_GROUP_SIZE) {
+            return LL_OK;
+        }
+
+        i32Ret = HASH_Stream_Group(pstcCtx, pstcCtx->au8Tail, 0U);
+        pstcCtx->u32TailLen = 0UL;
+    }
+
+    /* Whole groups are written from the caller's buffer without copying */
+    while ((i32Ret == LL_OK) && (u32Size >= HASH_GROUP_SIZE)) {
+        i32Ret = HASH_Stream_Group(pstcCtx, pu8Data, 0U);
+        pu8Data += HASH_GROUP_SIZE;
+        u32Size -= HASH_GROUP_SIZE;
+    }
+
+    if ((i32Ret == LL_OK) && (u32Size != 0UL)) {
+        (void)memcpy(pstcCtx->au8Tail, pu8Data, u32Size);
+        pstcCtx->u32TailLen = u32Size;
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Append the SHA-256 padding and length, process the last group(s).
+ */
+static int32_t HASH_Stream_Pad(stc_hash_stream_t *pstcCtx) {
+    uint32_t u32Len = pstcCtx->u32TailLen;
+    int32_t i32Ret = LL_OK;
+
+    (void)memset(&pstcCtx->au8Tail[u32Len], 0, HASH_GROUP_SIZE - u32Len);
+    pstcCtx->au8Tail[u32Len] = 0x80U;
+
+    if (u32Len >= HASH_LAST_GROUP_SIZE_MAX) {
+        i32Ret = HASH_Stream_Group(pstcCtx, pstcCtx->au8Tail, 0U);
+        (void)memset(pstcCtx->au8Tail, 0, HASH_GROUP_SIZE);
+    }
+
+    if (i32Ret == LL_OK) {
+        Crypto_PutBE32(&pstcCtx->au8Tail[56U], pstcCtx->u32TotalLen >> 29U);
+        Crypto_PutBE32(&pstcCtx->au8Tail[60U], pstcCtx->u32TotalLen << 3U);
+        i32Ret = HASH_Stream_Group(pstcCtx, pstcCtx->au8Tail, 1U);
+    }
+
+    pstcCtx->u32TailLen = 0UL;
+    pstcCtx->u32TotalLen = 0UL;
+    pstcCtx->u8FirstGroup = 1U;
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Open a SHA-256 or HMAC-SHA-256 stream.
+ * @param  [in] pstcCtx                 HASH stream context.
+ * @param  [in] pu8Key                  HMAC key, NULL for plain SHA-256.
+ * @param  [in] u32KeySize              Key size in bytes.
+ * @retval int32_t:
+ *           - LL_OK:                   No errors occurred.
+ *           - LL_ERR_INVD_PARAM:       Parameter error.
+ *           - LL_ERR_BUSY:             Another stream has not been finished.
+ *           - LL_ERR_TIMEOUT:          Works timeout.
+ */
+int32_t HASH_Stream_Init(stc_hash_stream_t *pstcCtx, const uint8_t *pu8Key, uint32_t u32KeySize) {
+    int32_t i32Ret;
+
+    if ((pstcCtx == NULL) || ((pu8Key != NULL) && (u32KeySize == 0UL))) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    if ((m_pstcHashOwner != NULL) && (m_pstcHashOwner != pstcCtx)) {
+        return LL_ERR_BUSY;
+    }
+
+    FCG_Fcg0PeriphClockCmd(FCG0_PERIPH_HASH, ENABLE);
+
+    pstcCtx->u32TailLen = 0UL;
+    pstcCtx->u32TotalLen = 0UL;
+    pstcCtx->u8FirstGroup = 1U;
+    pstcCtx->u8Hmac = (pu8Key != NULL) ? 1U : 0U;
+
+    i32Ret = HASH_Stream_Wait(HASH_CR_START);
+
+    if (i32Ret != LL_OK) {
+        return i32Ret;
+    }
+
+    m_pstcHashOwner = pstcCtx;
+    (void)HASH_SetMode((pu8Key != NULL) ? HASH_MD_HMAC : HASH_MD_SHA256);
+
+    if (pu8Key != NULL) {
+        if (u32KeySize > HASH_KEY_LONG_SIZE) {
+            WRITE_REG32(bCM_HASH->CR_b.LKEY, 1U);
+            i32Ret = HASH_Stream_Absorb(pstcCtx, pu8Key, u32KeySize);
+
+            if (i32Ret == LL_OK) {
+                i32Ret = HASH_Stream_Pad(pstcCtx);
+            }
+        } else {
+            WRITE_REG32(bCM_HASH->CR_b.LKEY, 0U);
+            (void)memset(pstcCtx->au8Tail, 0, HASH_GROUP_SIZE);
+            (void)memcpy(pstcCtx->au8Tail, pu8Key, u32KeySize);
+            /* Only one group */
+            i32Ret = HASH_Stream_Group(pstcCtx, pstcCtx->au8Tail, 1U);
+            pstcCtx->u8FirstGroup = 1U;
+        }
+
+        WRITE_REG32(bCM_HASH->CR_b.CYC_END, 0U);
+    }
+
+    if (i32Ret != LL_OK) {
+        m_pstcHashOwner = NULL;
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Feed message bytes, any size.
+ * @retval int32_t:
+ *           - LL_OK:                   No errors occurred.
+ *           - LL_ERR_INVD_PARAM:       Parameter error.
+ *           - LL_ERR_TIMEOUT:          Works timeout.
+ */
+int32_t HASH_Stream_Update(stc_hash_stream_t *pstcCtx, const uint8_t *pu8Data, uint32_t u32Size) {
+    if ((pstcCtx == NULL) || (pstcCtx != m_pstcHashOwner) || ((pu8Data == NULL) && (u32Size != 0UL))) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    return HASH_Stream_Absorb(pstcCtx, pu8Data, u32Size);
+}
+
+/**
+ * @brief  Finish the message and read the digest, the stream is closed afterwards.
+ * @param  [out] pu8MsgDigest           32 bytes, no alignment required.
+ * @retval int32_t:
+ *           - LL_OK:                   No errors occurred.
+ *           - LL_ERR_INVD_PARAM:       Parameter error.
+ *           - LL_ERR_TIMEOUT:          Works timeout.
+ */
+int32_t HASH_Stream_Final(stc_hash_stream_t *pstcCtx, uint8_t *pu8MsgDigest) {
+    uint8_t i;
+    uint32_t u32Word;
+    __IO uint32_t *regHR = &CM_HASH->HR7;
+    int32_t i32Ret;
+
+    if ((pstcCtx == NULL) || (pstcCtx != m_pstcHashOwner) || (pu8MsgDigest == NULL)) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    i32Ret = HASH_Stream_Pad(pstcCtx);
+
+    if ((i32Ret == LL_OK) && (pstcCtx->u8Hmac != 0U)) {
+        i32Ret = HASH_Stream_Wait(HASH_CR_HMAC_END);
+        CLR_REG32_BIT(CM_HASH->CR, HASH_CR_CYC_END | HASH_CR_HMAC_END);
+    }
+
+    if (i32Ret == LL_OK) {
+        for (i = 0U; i < (HASH_STREAM_DIGEST_SIZE / 4U); i++) {
+            u32Word = __REV(regHR[i]);
+            (void)memcpy(&pu8MsgDigest[i * 4U], &u32Word, 4U);
+        }
+    }
+
+    WRITE_REG32(bCM_HASH->CR_b.START, 0U);
+    m_pstcHashOwner = NULL;
+
+    return i32Ret;
+}
+
+/*************************************** AES ***************************************/
+
+/**
+ * @brief  Load the context's key unless it is already in the engine.
+ */
+static void AES_Stream_LoadKey(stc_aes_stream_t *pstcCtx) {
+    uint8_t i;
+    __IO uint32_t *regKR = &CM_AES->KR0;
+
+    if (m_pstcAesOwner == pstcCtx) {
+        return;
+    }
+
+    for (i = 0U; i < (pstcCtx->u8KeySize / 4U); i++) {
+        regKR[i] = pstcCtx->au32Key[i];
+    }
+
+    /* 16/24/32 bytes -> 0/1/2 */
+    MODIFY_REG32(CM_AES->CR, AES_CR_KEYSIZE, ((uint32_t)pstcCtx->u8KeySize / 8UL - 2UL) << AES_CR_KEYSIZE_POS);
+    m_pstcAesOwner = pstcCtx;
+}
+
+/**
+ * @brief  Run one block through the engine with the resident key.
+ * @param  [in]  pu8In                  16 bytes input.
+ * @param  [out] pu8Out                 16 bytes output, may equal pu8In.
+ * @param  [in]  u8Dir                  @ref CRYPTO_STREAM_AES_Dir
+ */
+static int32_t AES_Stream_Block(const uint8_t *pu8In, uint8_t *pu8Out, uint8_t u8Dir) {
+    uint8_t i;
+    uint32_t u32Word;
+    __IO uint32_t *regDR = &CM_AES->DR0;
+    __IO uint32_t u32TimeCount = 0UL;
+
+    for (i = 0U; i < 4U; i++) {
+        regDR[i] = Crypto_Load32(&pu8In[i * 4U]);
+    }
+
+    WRITE_REG32(bCM_AES->CR_b.MODE, u8Dir);
+    WRITE_REG32(bCM_AES->CR_b.START, 1UL);
+
+    while (bCM_AES->CR_b.START != 0UL) {
+        if (u32TimeCount++ >= CRYPTO_TIMEOUT) {
+            return LL_ERR_TIMEOUT;
+        }
+    }
+
+    for (i = 0U; i < 4U; i++) {
+        u32Word = regDR[i];
+        (void)memcpy(&pu8Out[i * 4U], &u32Word, 4U);
+    }
+
+    return LL_OK;
+}
+
+/**
+ * @brief  Build the 4-bit multiplication table for H.
+ */
+static void AES_Stream_GcmTable(stc_aes_stream_t *pstcCtx, const uint8_t *pu8H) {
+    uint64_t u64Vh = Crypto_GetBE64(pu8H);
+    uint64_t u64Vl = Crypto_GetBE64(&pu8H[8]);
+    uint64_t u64T;
+    uint32_t i, j;
+
+    pstcCtx->au64HL[0] = 0ULL;
+    pstcCtx->au64HH[0] = 0ULL;
+    pstcCtx->au64HL[8] = u64Vl;
+    pstcCtx->au64HH[8] = u64Vh;
+
+    for (i = 4UL; i > 0UL; i >>= 1U) {
+        u64T = (u64Vl & 1ULL) * 0xE1000000ULL;
+        u64Vl = (u64Vh << 63U) | (u64Vl >> 1U);
+        u64Vh = (u64Vh >> 1U) ^ (u64T << 32U);
+        pstcCtx->au64HL[i] = u64Vl;
+        pstcCtx->au64HH[i] = u64Vh;
+    }
+
+    for (i = 2UL; i <= 8UL; i *= 2UL) {
+        for (j = 1UL; j < i; j++) {
+            pstcCtx->au64HH[i + j] = pstcCtx->au64HH[i] ^ pstcCtx->au64HH[j];
+            pstcCtx->au64HL[i + j] = pstcCtx->au64HL[i] ^ pstcCtx->au64HL[j];
+        }
+    }
+}
+
+/**
+ * @brief  X = X * H in GF(2^128).
+ */
+static void AES_Stream_GcmMult(stc_aes_stream_t *pstcCtx) {
+    uint8_t *pu8X = pstcCtx->au8X;
+    uint64_t u64Zh, u64Zl;
+    uint32_t u32Lo, u32Hi, u32Rem;
+    int32_t i;
+
+    u32Lo = pu8X[15] & 0x0FU;
+    u64Zh = pstcCtx->au64HH[u32Lo];
+    u64Zl = pstcCtx->au64HL[u32Lo];
+
+    for (i = 15; i >= 0; i--) {
+        u32Lo = pu8X[i] & 0x0FU;
+        u32Hi = (pu8X[i] >> 4U) & 0x0FU;
+
+        if (i != 15) {
+            u32Rem = (uint32_t)(u64Zl & 0x0FU);
+            u64Zl = (u64Zh << 60U) | (u64Zl >> 4U);
+            u64Zh = (u64Zh >> 4U) ^ ((uint64_t)m_au16Last4[u32Rem] << 48U);
+            u64Zh ^= pstcCtx->au64HH[u32Lo];
+            u64Zl ^= pstcCtx->au64HL[u32Lo];
+        }
+
+        u32Rem = (uint32_t)(u64Zl & 0x0FU);
+        u64Zl = (u64Zh << 60U) | (u64Zl >> 4U);
+        u64Zh = (u64Zh >> 4U) ^ ((uint64_t)m_au16Last4[u32Rem] << 48U);
+        u64Zh ^= pstcCtx->au64HH[u32Hi];
+        u64Zl ^= pstcCtx->au64HL[u32Hi];
+    }
+
+    Crypto_PutBE32(&pu8X[0], (uint32_t)(u64Zh >> 32U));
+    Crypto_PutBE32(&pu8X[4], (uint32_t)u64Zh);
+    Crypto_PutBE32(&pu8X[8], (uint32_t)(u64Zl >> 32U));
+    Crypto_PutBE32(&pu8X[12], (uint32_t)u64Zl);
+}
+
+/**
+ * @brief  Feed bytes into GHASH, partial blocks wait in au8Buf.
+ */
+static void AES_Stream_Ghash(stc_aes_stream_t *pstcCtx, const uint8_t *pu8Data, uint32_t u32Size) {
+    uint32_t u32Len;
+
+    while (u32Size != 0UL) {
+        u32Len = LL_MIN(AES_BLOCK_SIZE - pstcCtx->u8BufLen, u32Size);
+        (void)memcpy(&pstcCtx->au8Buf[pstcCtx->u8BufLen], pu8Data, u32Len);
+        pstcCtx->u8BufLen += (uint8_t)u32Len;
+        pu8Data += u32Len;
+        u32Size -= u32Len;
+
+        if (pstcCtx->u8BufLen == AES_BLOCK_SIZE) {
+            Crypto_Xor(pstcCtx->au8X, pstcCtx->au8X, pstcCtx->au8Buf, AES_BLOCK_SIZE);
+            AES_Stream_GcmMult(pstcCtx);
+            pstcCtx->u8BufLen = 0U;
+        }
+    }
+}
+
+/**
+ * @brief  Zero-pad and absorb the pending partial GHASH block.
+ */
+static void AES_Stream_GhashFlush(stc_aes_stream_t *pstcCtx) {
+    if (pstcCtx->u8BufLen != 0U) {
+        (void)memset(&pstcCtx->au8Buf[pstcCtx->u8BufLen], 0, AES_BLOCK_SIZE - pstcCtx->u8BufLen);
+        Crypto_Xor(pstcCtx->au8X, pstcCtx->au8X, pstcCtx->au8Buf, AES_BLOCK_SIZE);
+        AES_Stream_GcmMult(pstcCtx);
+        pstcCtx->u8BufLen = 0U;
+    }
+}
+
+/**
+ * @brief  Increment the counter block: whole 128 bits for CTR, low 32 bits for GCM.
+ */
+static void AES_Stream_IncCounter(stc_aes_stream_t *pstcCtx) {
+    uint8_t u8Stop = (pstcCtx->u8Mode == AES_STREAM_GCM) ? 12U : 0U;
+    uint8_t i = AES_BLOCK_SIZE;
+
+    while (i > u8Stop) {
+        i--;
+
+        if (++pstcCtx->au8Iv[i] != 0U) {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief  CTR/GCM key stream XOR, any length.
+ */
+static int32_t AES_Stream_Ctr(stc_aes_stream_t *pstcCtx, const uint8_t *pu8In, uint8_t *pu8Out, uint32_t u32Size) {
+    uint32_t u32Len;
+    int32_t i32Ret = LL_OK;
+
+    while ((i32Ret == LL_OK) && (u32Size != 0UL)) {
+        if (pstcCtx->u8Pos == AES_BLOCK_SIZE) {
+            i32Ret = AES_Stream_Block(pstcCtx->au8Iv, pstcCtx->au8Stream, AES_STREAM_ENCRYPT);
+            AES_Stream_IncCounter(pstcCtx);
+            pstcCtx->u8Pos = 0U;
+        }
+
+        u32Len = LL_MIN(AES_BLOCK_SIZE - pstcCtx->u8Pos, u32Size);
+        Crypto_Xor(pu8Out, pu8In, &pstcCtx->au8Stream[pstcCtx->u8Pos], u32Len);
+        pstcCtx->u8Pos += (uint8_t)u32Len;
+        pu8In += u32Len;
+        pu8Out += u32Len;
+        u32Size -= u32Len;
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Open an AES stream and load the key into the engine.
+ * @param  [in] pstcCtx                 AES stream context.
+ * @param  [in] u8Mode                  @ref CRYPTO_STREAM_AES_Mode
+ * @param  [in] u8Dir                   @ref CRYPTO_STREAM_AES_Dir
+ * @param  [in] pu8Key                  Key.
+ * @param  [in] u8KeySize               @ref AES_Key_Size
+ * @param  [in] pu8Iv                   16 bytes for CBC/CTR, 12 bytes for GCM, ignored for ECB.
+ * @retval int32_t:
+ *           - LL_OK:                   No errors occurred.
+ *           - LL_ERR_INVD_PARAM:       Parameter error.
+ *           - LL_ERR_TIMEOUT:          Works timeout.
+ */
+int32_t AES_Stream_Init(stc_aes_stream_t *pstcCtx, uint8_t u8Mode, uint8_t u8Dir,
+                        const uint8_t *pu8Key, uint8_t u8KeySize, const uint8_t *pu8Iv) {
+    uint8_t au8H[AES_BLOCK_SIZE] = {0U};
+    int32_t i32Ret = LL_OK;
+
+    if ((pstcCtx == NULL) || (pu8Key == NULL) || (u8Mode > AES_STREAM_GCM) || (u8Dir > AES_STREAM_DECRYPT) ||
+            ((u8KeySize != AES_KEY_SIZE_16BYTE) && (u8KeySize != AES_KEY_SIZE_24BYTE) && (u8KeySize != AES_KEY_SIZE_32BYTE)) ||
+            ((u8Mode != AES_STREAM_ECB) && (pu8Iv == NULL))) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    FCG_Fcg0PeriphClockCmd(FCG0_PERIPH_AES, ENABLE);
+
+    /* A new key for this context */
+    if (m_pstcAesOwner == pstcCtx) {
+        m_pstcAesOwner = NULL;
+    }
+
+    (void)memset(pstcCtx, 0, sizeof(stc_aes_stream_t));
+    (void)memcpy(pstcCtx->au32Key, pu8Key, u8KeySize);
+    pstcCtx->u8KeySize = u8KeySize;
+    pstcCtx->u8Mode = u8Mode;
+    pstcCtx->u8Dir = u8Dir;
+    pstcCtx->u8Pos = AES_BLOCK_SIZE;
+
+    AES_Stream_LoadKey(pstcCtx);
+
+    if (u8Mode == AES_STREAM_GCM) {
+        /* H = E(K, 0), J0 = IV || 0^31 || 1, the first data block uses inc32(J0) */
+        i32Ret = AES_Stream_Block(au8H, au8H, AES_STREAM_ENCRYPT);
+        AES_Stream_GcmTable(pstcCtx, au8H);
+        (void)memcpy(pstcCtx->au8J0, pu8Iv, 12U);
+        pstcCtx->au8J0[15] = 1U;
+        (void)memcpy(pstcCtx->au8Iv, pstcCtx->au8J0, AES_BLOCK_SIZE);
+        AES_Stream_IncCounter(pstcCtx);
+        pstcCtx->u8AadOpen = 1U;
+    } else if (u8Mode != AES_STREAM_ECB) {
+        (void)memcpy(pstcCtx->au8Iv, pu8Iv, AES_BLOCK_SIZE);
+    } else {
+        /* ECB has no IV */
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Feed GCM additional authenticated data, any size, before any AES_Stream_Update.
+ * @retval int32_t:
+ *           - LL_OK:                   No errors occurred.
+ *           - LL_ERR_INVD_PARAM:       Parameter error.
+ *           - LL_ERR_INVD_MD:          Not GCM, or payload already started.
+ */
+int32_t AES_Stream_Aad(stc_aes_stream_t *pstcCtx, const uint8_t *pu8Aad, uint32_t u32Size) {
+    if ((pstcCtx == NULL) || ((pu8Aad == NULL) && (u32Size != 0UL))) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    if ((pstcCtx->u8Mode != AES_STREAM_GCM) || (pstcCtx->u8AadOpen == 0U)) {
+        return LL_ERR_INVD_MD;
+    }
+
+    AES_Stream_Ghash(pstcCtx, pu8Aad, u32Size);
+    pstcCtx->u32AadLen += u32Size;
+
+    return LL_OK;
+}
+
+/**
+ * @brief  Encrypt or decrypt a chunk.
+ * @param  [in]  pstcCtx                AES stream context.
+ * @param  [in]  pu8In                  Input.
+ * @param  [out] pu8Out                 Output, may equal pu8In.
+ * @param  [in]  u32Size                Multiple of 16 for ECB/CBC, any size for CTR/GCM.
+ * @retval int32_t:
+ *           - LL_OK:                   No errors occurred.
+ *           - LL_ERR_INVD_PARAM:       Parameter error.
+ *           - LL_ERR_TIMEOUT:          Works timeout.
+ */
+int32_t AES_Stream_Update(stc_aes_stream_t *pstcCtx, const uint8_t *pu8In, uint8_t *pu8Out, uint32_t u32Size) {
+    uint8_t au8Tmp[AES_BLOCK_SIZE];
+    uint32_t u32Index = 0UL;
+    int32_t i32Ret = LL_OK;
+
+    if ((pstcCtx == NULL) || (pu8In == NULL) || (pu8Out == NULL)) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    if (((pstcCtx->u8Mode == AES_STREAM_ECB) || (pstcCtx->u8Mode == AES_STREAM_CBC)) &&
+            ((u32Size % AES_BLOCK_SIZE) != 0UL)) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    AES_Stream_LoadKey(pstcCtx);
+
+    switch (pstcCtx->u8Mode) {
+        case AES_STREAM_ECB:
+            for (; (i32Ret == LL_OK) && (u32Index < u32Size); u32Index += AES_BLOCK_SIZE) {
+                i32Ret = AES_Stream_Block(&pu8In[u32Index], &pu8Out[u32Index], pstcCtx->u8Dir);
+            }
+
+            break;
+
+        case AES_STREAM_CBC:
+            for (; (i32Ret == LL_OK) && (u32Index < u32Size); u32Index += AES_BLOCK_SIZE) {
+                if (pstcCtx->u8Dir == AES_STREAM_ENCRYPT) {
+                    Crypto_Xor(au8Tmp, &pu8In[u32Index], pstcCtx->au8Iv, AES_BLOCK_SIZE);
+                    i32Ret = AES_Stream_Block(au8Tmp, &pu8Out[u32Index], AES_STREAM_ENCRYPT);
+                    (void)memcpy(pstcCtx->au8Iv, &pu8Out[u32Index], AES_BLOCK_SIZE);
+                } else {
+                    /* Keep the ciphertext, pu8Out may overwrite it */
+                    (void)memcpy(au8Tmp, &pu8In[u32Index], AES_BLOCK_SIZE);
+                    i32Ret = AES_Stream_Block(au8Tmp, &pu8Out[u32Index], AES_STREAM_DECRYPT);
+                    Crypto_Xor(&pu8Out[u32Index], &pu8Out[u32Index], pstcCtx->au8Iv, AES_BLOCK_SIZE);
+                    (void)memcpy(pstcCtx->au8Iv, au8Tmp, AES_BLOCK_SIZE);
+                }
+            }
+
+            break;
+
+        case AES_STREAM_GCM:
+            if (pstcCtx->u8AadOpen != 0U) {
+                AES_Stream_GhashFlush(pstcCtx);
+                pstcCtx->u8AadOpen = 0U;
+            }
+
+            /* GHASH always runs over the ciphertext */
+            if (pstcCtx->u8Dir == AES_STREAM_DECRYPT) {
+                AES_Stream_Ghash(pstcCtx, pu8In, u32Size);
+            }
+
+            i32Ret = AES_Stream_Ctr(pstcCtx, pu8In, pu8Out, u32Size);
+
+            if (pstcCtx->u8Dir == AES_STREAM_ENCRYPT) {
+                AES_Stream_Ghash(pstcCtx, pu8Out, u32Size);
+            }
+
+            pstcCtx->u32DataLen += u32Size;
+            break;
+
+        default:
+            i32Ret = AES_Stream_Ctr(pstcCtx, pu8In, pu8Out, u32Size);
+            break;
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Close the stream; for GCM compute the tag.
+ * @param  [in]  pstcCtx                AES stream context.
+ * @param  [out] pu8Tag                 GCM: 16-byte tag (compare it with the received one when decrypting).
+ *                                      Other modes: may be NULL.
+ * @retval int32_t:
+ *           - LL_OK:                   No errors occurred.
+ *           - LL_ERR_INVD_PARAM:       Parameter error.
+ *           - LL_ERR_TIMEOUT:          Works timeout.
+ */
+int32_t AES_Stream_Final(stc_aes_stream_t *pstcCtx, uint8_t *pu8Tag) {
+    uint8_t au8Len[AES_BLOCK_SIZE];
+    uint8_t i;
+    __IO uint32_t *regKR = &CM_AES->KR0;
+    int32_t i32Ret = LL_OK;
+
+    if ((pstcCtx == NULL) || ((pstcCtx->u8Mode == AES_STREAM_GCM) && (pu8Tag == NULL))) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    if (pstcCtx->u8Mode == AES_STREAM_GCM) {
+        AES_Stream_LoadKey(pstcCtx);
+        AES_Stream_GhashFlush(pstcCtx);
+
+        /* len(A) || len(C) in bits */
+        Crypto_PutBE32(&au8Len[0], pstcCtx->u32AadLen >> 29U);
+        Crypto_PutBE32(&au8Len[4], pstcCtx->u32AadLen << 3U);
+        Crypto_PutBE32(&au8Len[8], pstcCtx->u32DataLen >> 29U);
+        Crypto_PutBE32(&au8Len[12], pstcCtx->u32DataLen << 3U);
+        Crypto_Xor(pstcCtx->au8X, pstcCtx->au8X, au8Len, AES_BLOCK_SIZE);
+        AES_Stream_GcmMult(pstcCtx);
+
+        i32Ret = AES_Stream_Block(pstcCtx->au8J0, au8Len, AES_STREAM_ENCRYPT);
+        Crypto_Xor(pu8Tag, pstcCtx->au8X, au8Len, AES_BLOCK_SIZE);
+    }
+
+    /* Do not leave the key behind in the engine or the context */
+    if (m_pstcAesOwner == pstcCtx) {
+        for (i = 0U; i < 8U; i++) {
+            regKR[i] = 0UL;
+        }
+
+        m_pstcAesOwner = NULL;
+    }
+
+    (void)memset(pstcCtx->au32Key, 0, sizeof(pstcCtx->au32Key));
+
+    return i32Ret;
+}
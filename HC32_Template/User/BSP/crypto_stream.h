@@ -0,0 +1,102 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : crypto_stream.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : Streaming SHA-256/HMAC and AES-ECB/CBC/CTR/GCM on the HC32 HASH/AES engines
+  * Function List:
+  *		HASH_Stream_Init
+  *		HASH_Stream_Update
+  *		HASH_Stream_Final
+  *		AES_Stream_Init
+  *		AES_Stream_Aad
+  *		AES_Stream_Update
+  *		AES_Stream_Final
+  ******************************************************
+**/
+
+#ifndef __CRYPTO_STREAM_H_
+#define __CRYPTO_STREAM_H_
+
+#include "hc32_ll.h"
+
+/**
+ * @defgroup CRYPTO_STREAM_AES_Mode AES Stream Mode
+ * @{
+ */
+#define AES_STREAM_ECB              (0U)
+#define AES_STREAM_CBC              (1U)
+#define AES_STREAM_CTR              (2U)
+#define AES_STREAM_GCM              (3U)
+/**
+ * @}
+ */
+
+/**
+ * @defgroup CRYPTO_STREAM_AES_Dir AES Stream Direction
+ * @{
+ */
+#define AES_STREAM_ENCRYPT          (0U)
+#define AES_STREAM_DECRYPT          (1U)
+/**
+ * @}
+ */
+
+#define HASH_STREAM_DIGEST_SIZE     (32U)
+#define AES_STREAM_TAG_SIZE         (16U)
+
+/**
+ * @brief SHA-256/HMAC stream context.
+ * @note  The engine keeps the chaining state internally and it cannot be read back,
+ *        so only one hash stream can be open at a time.
+ */
+typedef struct {
+    uint8_t  au8Tail[64];           /*!< Bytes of the current incomplete 64-byte group */
+    uint32_t u32TailLen;
+    uint32_t u32TotalLen;           /*!< Message bytes absorbed so far */
+    uint8_t  u8FirstGroup;          /*!< Next group is the first one of the key/message */
+    uint8_t  u8Hmac;
+} stc_hash_stream_t;
+
+/**
+ * @brief AES stream context.
+ * @note  The key stays in the engine while the same context is used back to back;
+ *        it is reloaded only when another context used the engine in between.
+ */
+typedef struct {
+    uint32_t au32Key[8];
+    uint8_t  u8KeySize;             /*!< @ref AES_Key_Size */
+    uint8_t  u8Mode;                /*!< @ref CRYPTO_STREAM_AES_Mode */
+    uint8_t  u8Dir;                 /*!< @ref CRYPTO_STREAM_AES_Dir */
+    uint8_t  u8Pos;                 /*!< CTR/GCM: used bytes of au8Stream */
+    uint8_t  u8BufLen;              /*!< GCM: bytes in au8Buf */
+    uint8_t  au8Iv[16];             /*!< CBC chaining value or CTR/GCM counter block */
+    uint8_t  au8Stream[16];         /*!< CTR/GCM key stream of the current counter */
+    uint8_t  au8Buf[16];            /*!< GCM: partial block waiting for GHASH */
+    uint8_t  au8X[16];              /*!< GCM: GHASH accumulator */
+    uint8_t  au8J0[16];             /*!< GCM: pre-counter block, used for the tag */
+    uint64_t au64HL[16];            /*!< GCM: 4-bit multiplication table of H */
+    uint64_t au64HH[16];
+    uint32_t u32AadLen;
+    uint32_t u32DataLen;
+    uint8_t  u8AadOpen;             /*!< GCM: still accepting AAD */
+} stc_aes_stream_t;
+
+int32_t HASH_Stream_Init(stc_hash_stream_t *pstcCtx, const uint8_t *pu8Key, uint32_t u32KeySize);
+int32_t HASH_Stream_Update(stc_hash_stream_t *pstcCtx, const uint8_t *pu8Data, uint32_t u32Size);
+int32_t HASH_Stream_Final(stc_hash_stream_t *pstcCtx, uint8_t *pu8MsgDigest);
+
+int32_t AES_Stream_Init(stc_aes_stream_t *pstcCtx, uint8_t u8Mode, uint8_t u8Dir,
+                        const uint8_t *pu8Key, uint8_t u8KeySize, const uint8_t *pu8Iv);
+int32_t AES_Stream_Aad(stc_aes_stream_t *pstcCtx, const uint8_t *pu8Aad, uint32_t u32Size);
+int32_t AES_Stream_Update(stc_aes_stream_t *pstcCtx, const uint8_t *pu8In, uint8_t *pu8Out, uint32_t u32Size);
+int32_t AES_Stream_Final(stc_aes_stream_t *pstcCtx, uint8_t *pu8Tag);
+
+#endif
@@ -0,0 +1,607 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : dma_sg.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					A vectored write or read is compiled once into a table of LLP descriptors
+					(stc_dma_llp_descriptor_t) and started with a single DMA_SG_Start; the DMA
+					loads the following descriptors itself, so there is no restart per segment.
+					While compiling, segments are folded into as few descriptors as possible:
+					  - adjacent segments (one ends where the next starts) are merged;
+					  - the same segment repeated back to back uses repeat mode (RPT);
+					  - equal-length segments with a constant stride use non-sequence mode
+					    (SNSEQCTL/DNSEQCTL), e.g. one field out of an array of records.
+					Only the last descriptor sets CHCTL.IE, so a table raises one completion
+					interrupt. DMA_SG_Start loads descriptor 0 through DMA_Init/DMA_RepeatInit/
+					DMA_NonSeqInit/DMA_LlpInit; DMA_SG_ReconfigInit lets an event (e.g. a
+					USART receive timeout) skip to the next descriptor for variable-length frames.
+					Peripheral tables move one data per request and wait for the request
+					between descriptors; memory tables move one block per descriptor and run
+					straight through after a single software trigger.
+  * Function List:
+  *		DMA_SG_TableInit
+  *		DMA_SG_CompileTx
+  *		DMA_SG_CompileRx
+  *		DMA_SG_CompileCopy
+  *		DMA_SG_ChInit
+  *		DMA_SG_ReconfigInit
+  *		DMA_SG_Start
+  *		DMA_SG_IsBusy
+  *		DMA_SG_IrqHandler
+  *		DMA_SG_GetThroughput
+  **********************************************************
+ */
+
+#include "dma_sg.h"
+#include <string.h>
+
+#define DMA_SG_DIR_TX               (0U)        /*!< Memory segments to a fixed peripheral register */
+#define DMA_SG_DIR_RX               (1U)        /*!< Fixed peripheral register to memory segments */
+#define DMA_SG_DIR_COPY             (2U)        /*!< Memory segments gathered to contiguous memory */
+
+/* The AOS driver is not part of this library copy, the trigger selections are written directly */
+#define DMA_SG_SET_TRIGGER(reg, src)    MODIFY_REG32((reg), AOS_DMA_TRGSELRC_TRGSEL, (uint32_t)(src))
+
+/**
+ * @brief  Record the first build error of a table.
+ */
+static int32_t DMA_SG_Fail(stc_dma_sg_table_t *pstcTable, int32_t i32Err) {
+    if (pstcTable->i32Error == LL_OK) {
+        pstcTable->i32Error = i32Err;
+    }
+
+    return pstcTable->i32Error;
+}
+
+/**
+ * @brief  Append one descriptor and link the previous one to it.
+ * @param  [in] pstcTable               Descriptor table.
+ * @param  [in] u32Sar                  Source address.
+ * @param  [in] u32Dar                  Destination address.
+ * @param  [in] u32Units                Data count, within the per-descriptor limit of the table.
+ * @param  [in] u32Ctrl                 CHCTL address modes and repeat/non-sequence enables.
+ * @param  [in] u32Rpt                  RPT value.
+ * @param  [in] u32SNSeq                SNSEQCTL value.
+ * @param  [in] u32DNSeq                DNSEQCTL value.
+ */
+static int32_t DMA_SG_Push(stc_dma_sg_table_t *pstcTable, uint32_t u32Sar, uint32_t u32Dar, uint32_t u32Units,
+                           uint32_t u32Ctrl, uint32_t u32Rpt, uint32_t u32SNSeq, uint32_t u32DNSeq) {
+    stc_dma_llp_descriptor_t *pstcDesc;
+    stc_dma_llp_descriptor_t *pstcPrev;
+
+    if (pstcTable->u16Num >= pstcTable->u16Max) {
+        return DMA_SG_Fail(pstcTable, LL_ERR_BUF_FULL);
+    }
+
+    pstcDesc = &pstcTable->pstcDesc[pstcTable->u16Num];
+
+    if (pstcTable->u16Num != 0U) {
+        pstcPrev = &pstcTable->pstcDesc[pstcTable->u16Num - 1U];
+        pstcPrev->LLPx = (uint32_t)pstcDesc;
+        pstcPrev->CHCTLx = (pstcPrev->CHCTLx & ~DMA_CHCTL_IE) | DMA_LLP_ENABLE;
+    }
+
+    pstcDesc->SARx = u32Sar;
+    pstcDesc->DARx = u32Dar;
+
+    if (pstcTable->u8Mem != 0U) {
+        pstcDesc->DTCTLx = (u32Units & DMA_DTCTL_BLKSIZE) | (1UL << DMA_DTCTL_CNT_POS);
+    } else {
+        pstcDesc->DTCTLx = 1UL | (u32Units << DMA_DTCTL_CNT_POS);
+    }
+
+    pstcDesc->RPTx = u32Rpt;
+    pstcDesc->SNSEQCTLx = u32SNSeq;
+    pstcDesc->DNSEQCTLx = u32DNSeq;
+    pstcDesc->LLPx = 0UL;
+    pstcDesc->CHCTLx = u32Ctrl | pstcTable->u32DataWidth | DMA_INT_ENABLE |
+                       ((pstcTable->u8Mem != 0U) ? DMA_LLP_RUN : DMA_LLP_WAIT);
+
+    pstcTable->u16Num++;
+    pstcTable->u32Bytes += u32Units << (pstcTable->u32DataWidth >> DMA_CHCTL_HSIZE_POS);
+
+    return LL_OK;
+}
+
+/**
+ * @brief  Compile an I/O vector and append it to a table.
+ * @param  [in] pstcTable               Descriptor table.
+ * @param  [in] pstcVec                 Segments.
+ * @param  [in] u32Num                  Number of segments.
+ * @param  [in] u32Fixed                Peripheral register, or the destination start for DMA_SG_DIR_COPY.
+ * @param  [in] u32DataWidth            @ref DMA_DataWidth_Sel
+ * @param  [in] u8Dir                   DMA_SG_DIR_xxx
+ */
+static int32_t DMA_SG_Compile(stc_dma_sg_table_t *pstcTable, const stc_dma_sg_vec_t *pstcVec, uint32_t u32Num,
+                              uint32_t u32Fixed, uint32_t u32DataWidth, uint8_t u8Dir) {
+    uint8_t u8Mem = (u8Dir == DMA_SG_DIR_COPY) ? 1U : 0U;
+    uint8_t u8MemIsSrc = (u8Dir != DMA_SG_DIR_RX) ? 1U : 0U;
+    uint32_t u32Shift, u32Mask, u32Limit, u32Ctrl;
+    uint32_t u32Addr, u32Len, u32Units, u32Stride, u32Offset = 0UL, u32Chunk;
+    uint32_t i, j, k;
+    int32_t i32Ret;
+
+    if (pstcTable->i32Error != LL_OK) {
+        return pstcTable->i32Error;
+    }
+
+    if (((pstcVec == NULL) && (u32Num != 0UL)) ||
+            ((u32DataWidth != DMA_DATAWIDTH_8BIT) && (u32DataWidth != DMA_DATAWIDTH_16BIT) &&
+             (u32DataWidth != DMA_DATAWIDTH_32BIT))) {
+        return DMA_SG_Fail(pstcTable, LL_ERR_INVD_PARAM);
+    }
+
+    /* Width and trigger kind are per channel, not per descriptor */
+    if (pstcTable->u16Num == 0U) {
+        pstcTable->u32DataWidth = u32DataWidth;
+        pstcTable->u8Mem = u8Mem;
+    } else if ((pstcTable->u32DataWidth != u32DataWidth) || (pstcTable->u8Mem != u8Mem)) {
+        return DMA_SG_Fail(pstcTable, LL_ERR_INVD_MD);
+    }
+
+    u32Shift = u32DataWidth >> DMA_CHCTL_HSIZE_POS;
+    u32Mask = (1UL << u32Shift) - 1UL;
+    u32Limit = (u8Mem != 0U) ? DMA_SG_MEM_BLOCK_MAX : DMA_SG_PERIPH_CNT_MAX;
+
+    if ((u32Fixed & u32Mask) != 0UL) {
+        return DMA_SG_Fail(pstcTable, LL_ERR_ADDR_ALIGN);
+    }
+
+    if (u8Dir == DMA_SG_DIR_TX) {
+        u32Ctrl = DMA_SRC_ADDR_INC | DMA_DEST_ADDR_FIX;
+    } else if (u8Dir == DMA_SG_DIR_RX) {
+        u32Ctrl = DMA_SRC_ADDR_FIX | DMA_DEST_ADDR_INC;
+    } else {
+        u32Ctrl = DMA_SRC_ADDR_INC | DMA_DEST_ADDR_INC;
+    }
+
+    i = 0UL;
+
+    while (i < u32Num) {
+        u32Addr = pstcVec[i].u32Addr;
+        u32Len = pstcVec[i].u32Len;
+
+        if (u32Len == 0UL) {
+            i++;
+            continue;
+        }
+
+        if (((u32Addr | u32Len) & u32Mask) != 0UL) {
+            return DMA_SG_Fail(pstcTable, LL_ERR_ADDR_ALIGN);
+        }
+
+        u32Units = u32Len >> u32Shift;
+
+        /* The same segment back to back: repeat mode reloads the memory address every u32Units */
+        k = 1UL;
+
+        if (u32Units <= DMA_SG_RPT_MAX) {
+            while (((i + k) < u32Num) && (pstcVec[i + k].u32Addr == u32Addr) && (pstcVec[i + k].u32Len == u32Len) &&
+                    ((k + 1UL) * u32Units <= u32Limit)) {
+                k++;
+            }
+        }
+
+        if (k > 1UL) {
+            i32Ret = DMA_SG_Push(pstcTable,
+                                 (u8MemIsSrc != 0U) ? u32Addr : u32Fixed,
+                                 (u8MemIsSrc != 0U) ? u32Fixed : u32Addr,
+                                 k * u32Units,
+                                 u32Ctrl | ((u8MemIsSrc != 0U) ? DMA_RPT_SRC : DMA_RPT_DEST),
+                                 (u8MemIsSrc != 0U) ? u32Units : (u32Units << DMA_RPT_DRPT_POS),
+                                 0UL, 0UL);
+
+            if (i32Ret != LL_OK) {
+                return i32Ret;
+            }
+
+            if (u8Dir == DMA_SG_DIR_COPY) {
+                u32Fixed += k * u32Len;
+            }
+
+            pstcTable->u32Segments += k;
+            i += k;
+            continue;
+        }
+
+        /* Equal-length segments with a constant gap between them: non-sequence mode */
+        k = 1UL;
+
+        if ((u32Units <= DMA_SG_NSEQ_CNT_MAX) && ((i + 1UL) < u32Num) && (pstcVec[i + 1UL].u32Len == u32Len) &&
+                (pstcVec[i + 1UL].u32Addr > u32Addr + u32Len)) {
+            u32Stride = pstcVec[i + 1UL].u32Addr - u32Addr;
+            u32Offset = DMA_SG_NSEQ_OFFSET(u32Stride >> u32Shift, u32Units);
+
+            if (((u32Stride & u32Mask) == 0UL) && (u32Offset <= DMA_SG_NSEQ_OFFSET_MAX)) {
+                while (((i + k) < u32Num) && (pstcVec[i + k].u32Len == u32Len) &&
+                        (pstcVec[i + k].u32Addr - pstcVec[i + k - 1UL].u32Addr == u32Stride) &&
+                        ((k + 1UL) * u32Units <= u32Limit)) {
+                    k++;
+                }
+            }
+        }
+
+        if (k > 1UL) {
+            u32Offset |= u32Units << DMA_SNSEQCTL_SNSCNT_POS;
+            i32Ret = DMA_SG_Push(pstcTable,
+                                 (u8MemIsSrc != 0U) ? u32Addr : u32Fixed,
+                                 (u8MemIsSrc != 0U) ? u32Fixed : u32Addr,
+                                 k * u32Units,
+                                 u32Ctrl | ((u8MemIsSrc != 0U) ? DMA_NON_SEQ_SRC : DMA_NON_SEQ_DEST),
+                                 0UL,
+                                 (u8MemIsSrc != 0U) ? u32Offset : 0UL,
+                                 (u8MemIsSrc != 0U) ? 0UL : u32Offset);
+
+            if (i32Ret != LL_OK) {
+                return i32Ret;
+            }
+
+            if (u8Dir == DMA_SG_DIR_COPY) {
+                u32Fixed += k * u32Len;
+            }
+
+            pstcTable->u32Segments += k;
+            i += k;
+            continue;
+        }
+
+        /* Plain descriptors: merge the segments that continue this one, split at the limit */
+        pstcTable->u32Segments++;
+
+        for (j = i + 1UL; j < u32Num; j++) {
+            if (pstcVec[j].u32Len == 0UL) {
+                continue;
+            }
+
+            if ((pstcVec[j].u32Addr != u32Addr + u32Len) || ((pstcVec[j].u32Len & u32Mask) != 0UL)) {
+                break;
+            }
+
+            u32Len += pstcVec[j].u32Len;
+            pstcTable->u32Segments++;
+        }
+
+        i = j;
+        u32Units = u32Len >> u32Shift;
+
+        while (u32Units != 0UL) {
+            u32Chunk = (u32Units > u32Limit) ? u32Limit : u32Units;
+            i32Ret = DMA_SG_Push(pstcTable,
+                                 (u8MemIsSrc != 0U) ? u32Addr : u32Fixed,
+                                 (u8MemIsSrc != 0U) ? u32Fixed : u32Addr,
+                                 u32Chunk, u32Ctrl, 0UL, 0UL, 0UL);
+
+            if (i32Ret != LL_OK) {
+                return i32Ret;
+            }
+
+            u32Addr += u32Chunk << u32Shift;
+
+            if (u8Dir == DMA_SG_DIR_COPY) {
+                u32Fixed += u32Chunk << u32Shift;
+            }
+
+            u32Units -= u32Chunk;
+        }
+    }
+
+    return LL_OK;
+}
+
+/**
+ * @brief  Reset the descriptor table.
+ * @param  [in] pstcTable               Descriptor table.
+ * @param  [in] pstcDesc                Descriptor array, word aligned, in DMA-accessible RAM.
+ * @param  [in] u16Max                  Number of descriptors in pstcDesc.
+ * @retval None
+ */
+void DMA_SG_TableInit(stc_dma_sg_table_t *pstcTable, stc_dma_llp_descriptor_t *pstcDesc, uint16_t u16Max) {
+    pstcTable->pstcDesc = pstcDesc;
+    pstcTable->u16Max = u16Max;
+    pstcTable->u16Num = 0U;
+    pstcTable->u32DataWidth = DMA_DATAWIDTH_8BIT;
+    pstcTable->u8Mem = 0U;
+    pstcTable->i32Error = (pstcDesc == NULL) ? LL_ERR_INVD_PARAM : LL_OK;
+    pstcTable->u32Bytes = 0UL;
+    pstcTable->u32Segments = 0UL;
+}
+
+/**
+ * @brief  Append a vectored write: the segments go one after another to a peripheral data register.
+ * @param  [in] pstcTable               Descriptor table.
+ * @param  [in] pstcVec                 Segments.
+ * @param  [in] u32Num                  Number of segments.
+ * @param  [in] u32PeriphAddr           Peripheral data register, e.g. (uint32_t)&CM_SPI1->DR.
+ * @param  [in] u32DataWidth            @ref DMA_DataWidth_Sel
+ * @retval int32_t:
+ *           - LL_OK:                   No errors occurred.
+ *           - LL_ERR_INVD_PARAM:       Parameter error.
+ *           - LL_ERR_INVD_MD:          Width or direction kind differs from the rest of the table.
+ *           - LL_ERR_ADDR_ALIGN:       An address or length is not a multiple of the data width.
+ *           - LL_ERR_BUF_FULL:         Not enough descriptors.
+ */
+int32_t DMA_SG_CompileTx(stc_dma_sg_table_t *pstcTable, const stc_dma_sg_vec_t *pstcVec, uint32_t u32Num,
+                         uint32_t u32PeriphAddr, uint32_t u32DataWidth) {
+    return DMA_SG_Compile(pstcTable, pstcVec, u32Num, u32PeriphAddr, u32DataWidth, DMA_SG_DIR_TX);
+}
+
+/**
+ * @brief  Append a vectored read: data from a peripheral register is scattered over the segments.
+ * @param  [in] pstcTable               Descriptor table.
+ * @param  [in] pstcVec                 Segments; repeating one scratch segment discards data cheaply.
+ * @param  [in] u32Num                  Number of segments.
+ * @param  [in] u32PeriphAddr           Peripheral data register.
+ * @param  [in] u32DataWidth            @ref DMA_DataWidth_Sel
+ * @retval int32_t:                     Same as DMA_SG_CompileTx.
+ */
+int32_t DMA_SG_CompileRx(stc_dma_sg_table_t *pstcTable, const stc_dma_sg_vec_t *pstcVec, uint32_t u32Num,
+                         uint32_t u32PeriphAddr, uint32_t u32DataWidth) {
+    return DMA_SG_Compile(pstcTable, pstcVec, u32Num, u32PeriphAddr, u32DataWidth, DMA_SG_DIR_RX);
+}
+
+/**
+ * @brief  Append a memory gather: the segments are copied back to back starting at u32DestAddr,
+ *         e.g. assembling a frame in an ETH transmit buffer.
+ * @param  [in] pstcTable               Descriptor table.
+ * @param  [in] pstcVec                 Segments.
+ * @param  [in] u32Num                  Number of segments.
+ * @param  [in] u32DestAddr             Destination start.
+ * @param  [in] u32DataWidth            @ref DMA_DataWidth_Sel
+ * @retval int32_t:                     Same as DMA_SG_CompileTx.
+ */
+int32_t DMA_SG_CompileCopy(stc_dma_sg_table_t *pstcTable, const stc_dma_sg_vec_t *pstcVec, uint32_t u32Num,
+                           uint32_t u32DestAddr, uint32_t u32DataWidth) {
+    return DMA_SG_Compile(pstcTable, pstcVec, u32Num, u32DestAddr, u32DataWidth, DMA_SG_DIR_COPY);
+}
+
+/**
+ * @brief  Prepare a DMA channel for descriptor tables.
+ * @param  [in] pstcCh                  Channel handle.
+ * @param  [in] DMAx                    CM_DMA1 or CM_DMA2.
+ * @param  [in] u8Ch                    DMA_CH0 ~ DMA_CH7.
+ * @param  [in] enTrigSrc               Peripheral request, e.g. EVT_SRC_SPI1_SPTI;
+ *                                      EVT_SRC_AOS_STRG for memory tables.
+ * @retval int32_t:
+ *           - LL_OK:                   No errors occurred.
+ *           - LL_ERR_INVD_PARAM:       Parameter error.
+ * @note   The caller registers DMA_SG_IrqHandler for INT_SRC_DMAx_TCn and INT_SRC_DMAx_ERR.
+ */
+int32_t DMA_SG_ChInit(stc_dma_sg_ch_t *pstcCh, CM_DMA_TypeDef *DMAx, uint8_t u8Ch, en_event_src_t enTrigSrc) {
+    __IO uint32_t *TRGSELx;
+
+    if ((pstcCh == NULL) || ((DMAx != CM_DMA1) && (DMAx != CM_DMA2)) || (u8Ch > DMA_CH7)) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    FCG_Fcg0PeriphClockCmd(((DMAx == CM_DMA1) ? FCG0_PERIPH_DMA1 : FCG0_PERIPH_DMA2) | FCG0_PERIPH_AOS, ENABLE);
+
+    (void)memset(pstcCh, 0, sizeof(stc_dma_sg_ch_t));
+    pstcCh->DMAx = DMAx;
+    pstcCh->u8Ch = u8Ch;
+
+    (void)DMA_ChCmd(DMAx, u8Ch, DISABLE);
+
+    TRGSELx = (DMAx == CM_DMA1) ? &CM_AOS->DMA1_TRGSEL0 : &CM_AOS->DMA2_TRGSEL0;
+    DMA_SG_SET_TRIGGER(TRGSELx[u8Ch], enTrigSrc);
+
+    /* Peripheral tables have one data per block: keep the block interrupt masked */
+    DMA_TransCompleteIntCmd(DMAx, DMA_INT_BTC_CH0 << u8Ch, DISABLE);
+    DMA_TransCompleteIntCmd(DMAx, DMA_INT_TC_CH0 << u8Ch, ENABLE);
+    DMA_ErrIntCmd(DMAx, (DMA_INT_TRANS_ERR_CH0 | DMA_INT_REQ_ERR_CH0) << u8Ch, ENABLE);
+    DMA_Cmd(DMAx, ENABLE);
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    return LL_OK;
+}
+
+/**
+ * @brief  Let an event end the current descriptor early and continue with the next one,
+ *         so frames of unknown length land in consecutive buffers of an Rx table.
+ * @param  [in] pstcCh                  Channel handle.
+ * @param  [in] enEventSrc              Event, e.g. EVT_SRC_USART1_RTO.
+ * @retval int32_t:
+ *           - LL_OK:                   No errors occurred.
+ *           - LL_ERR_INVD_PARAM:       Parameter error.
+ * @note   The reconfiguration logic is shared by all channels of a DMA unit.
+ */
+int32_t DMA_SG_ReconfigInit(const stc_dma_sg_ch_t *pstcCh, en_event_src_t enEventSrc) {
+    stc_dma_reconfig_init_t stcRcInit;
+    int32_t i32Ret;
+
+    if ((pstcCh == NULL) || (pstcCh->DMAx == NULL)) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    (void)DMA_ReconfigStructInit(&stcRcInit);
+    stcRcInit.u32CountMode = DMA_RC_CNT_KEEP;
+    stcRcInit.u32DestAddrMode = DMA_RC_DEST_ADDR_KEEP;
+    stcRcInit.u32SrcAddrMode = DMA_RC_SRC_ADDR_KEEP;
+    i32Ret = DMA_ReconfigInit(pstcCh->DMAx, pstcCh->u8Ch, &stcRcInit);
+
+    if (i32Ret == LL_OK) {
+        DMA_ReconfigLlpCmd(pstcCh->DMAx, pstcCh->u8Ch, ENABLE);
+        DMA_SG_SET_TRIGGER(CM_AOS->DMA_TRGSELRC, enEventSrc);
+        DMA_ReconfigCmd(pstcCh->DMAx, ENABLE);
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Start a compiled table; pfnDone is called from DMA_SG_IrqHandler when it ends.
+ * @param  [in] pstcCh                  Channel handle.
+ * @param  [in] pstcTable               Descriptor table, must not change until completion.
+ * @param  [in] pfnDone                 Completion callback, may be NULL.
+ * @param  [in] pvArg                   Callback argument.
+ * @retval int32_t:
+ *           - LL_OK:                   No errors occurred.
+ *           - LL_ERR_INVD_PARAM:       Table is empty or failed to build.
+ *           - LL_ERR_BUSY:             The previous table has not finished.
+ */
+int32_t DMA_SG_Start(stc_dma_sg_ch_t *pstcCh, const stc_dma_sg_table_t *pstcTable,
+                     void (*pfnDone)(int32_t i32Result, void *pvArg), void *pvArg) {
+    const stc_dma_llp_descriptor_t *pstcDesc;
+    stc_dma_init_t stcInit;
+    stc_dma_repeat_init_t stcRptInit;
+    stc_dma_nonseq_init_t stcNSeqInit;
+    stc_dma_llp_init_t stcLlpInit;
+    CM_DMA_TypeDef *DMAx = pstcCh->DMAx;
+    uint8_t u8Ch = pstcCh->u8Ch;
+
+    if ((pstcTable == NULL) || (pstcTable->i32Error != LL_OK) || (pstcTable->u16Num == 0U)) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    if (pstcCh->u8Busy != 0U) {
+        return LL_ERR_BUSY;
+    }
+
+    pstcDesc = &pstcTable->pstcDesc[0];
+
+    (void)DMA_ChCmd(DMAx, u8Ch, DISABLE);
+    DMA_ClearTransCompleteStatus(DMAx, (DMA_FLAG_TC_CH0 | DMA_FLAG_BTC_CH0) << u8Ch);
+    DMA_ClearErrStatus(DMAx, (DMA_FLAG_TRANS_ERR_CH0 | DMA_FLAG_REQ_ERR_CH0) << u8Ch);
+
+    /* Descriptor 0 goes into the channel registers, the DMA fetches the rest through LLP */
+    stcInit.u32IntEn = pstcDesc->CHCTLx & DMA_CHCTL_IE;
+    stcInit.u32SrcAddr = pstcDesc->SARx;
+    stcInit.u32DestAddr = pstcDesc->DARx;
+    stcInit.u32DataWidth = pstcDesc->CHCTLx & DMA_CHCTL_HSIZE;
+    stcInit.u32BlockSize = pstcDesc->DTCTLx & DMA_DTCTL_BLKSIZE;
+    stcInit.u32TransCount = pstcDesc->DTCTLx >> DMA_DTCTL_CNT_POS;
+    stcInit.u32SrcAddrInc = pstcDesc->CHCTLx & DMA_CHCTL_SINC;
+    stcInit.u32DestAddrInc = pstcDesc->CHCTLx & DMA_CHCTL_DINC;
+    (void)DMA_Init(DMAx, u8Ch, &stcInit);
+
+    stcRptInit.u32Mode = pstcDesc->CHCTLx & (DMA_CHCTL_SRPTEN | DMA_CHCTL_DRPTEN);
+    stcRptInit.u32SrcCount = pstcDesc->RPTx & DMA_RPT_SRPT;
+    stcRptInit.u32DestCount = (pstcDesc->RPTx & DMA_RPT_DRPT) >> DMA_RPT_DRPT_POS;
+    (void)DMA_RepeatInit(DMAx, u8Ch, &stcRptInit);
+
+    stcNSeqInit.u32Mode = pstcDesc->CHCTLx & (DMA_CHCTL_SNSEQEN | DMA_CHCTL_DNSEQEN);
+    stcNSeqInit.u32SrcCount = (pstcDesc->SNSEQCTLx & DMA_SNSEQCTL_SNSCNT) >> DMA_SNSEQCTL_SNSCNT_POS;
+    stcNSeqInit.u32SrcOffset = pstcDesc->SNSEQCTLx & DMA_SNSEQCTL_SOFFSET;
+    stcNSeqInit.u32DestCount = (pstcDesc->DNSEQCTLx & DMA_DNSEQCTL_DNSCNT) >> DMA_DNSEQCTL_DNSCNT_POS;
+    stcNSeqInit.u32DestOffset = pstcDesc->DNSEQCTLx & DMA_DNSEQCTL_DOFFSET;
+    (void)DMA_NonSeqInit(DMAx, u8Ch, &stcNSeqInit);
+
+    stcLlpInit.u32State = pstcDesc->CHCTLx & DMA_CHCTL_LLPEN;
+    stcLlpInit.u32Mode = pstcDesc->CHCTLx & DMA_CHCTL_LLPRUN;
+    stcLlpInit.u32Addr = pstcDesc->LLPx;
+    (void)DMA_LlpInit(DMAx, u8Ch, &stcLlpInit);
+
+    pstcCh->u8Busy = 1U;
+    pstcCh->u8Mem = pstcTable->u8Mem;
+    pstcCh->u32Bytes = pstcTable->u32Bytes;
+    pstcCh->pfnDone = pfnDone;
+    pstcCh->pvArg = pvArg;
+    pstcCh->stcStats.u32Starts++;
+    pstcCh->stcStats.u32Descs += pstcTable->u16Num;
+    pstcCh->stcStats.u32Segments += pstcTable->u32Segments;
+
+    /* The descriptors were written by the CPU; make sure they reached RAM */
+    __DSB();
+    pstcCh->u32Start = DWT->CYCCNT;
+    (void)DMA_ChCmd(DMAx, u8Ch, ENABLE);
+
+    if (pstcCh->u8Mem != 0U) {
+        WRITE_REG32(bCM_AOS->INTSFTTRG_b.STRG, 1UL);
+    }
+
+    return LL_OK;
+}
+
+/**
+ * @brief  Check whether the channel is still running a table.
+ * @param  [in] pstcCh                  Channel handle.
+ * @retval An @ref en_flag_status_t enumeration value.
+ */
+en_flag_status_t DMA_SG_IsBusy(const stc_dma_sg_ch_t *pstcCh) {
+    return (pstcCh->u8Busy != 0U) ? SET : RESET;
+}
+
+/**
+ * @brief  Release the channel and report the result.
+ */
+static void DMA_SG_Finish(stc_dma_sg_ch_t *pstcCh, int32_t i32Result) {
+    void (*pfnDone)(int32_t i32Result, void *pvArg) = pstcCh->pfnDone;
+    uint32_t u32Cycles = DWT->CYCCNT - pstcCh->u32Start;
+
+    if (i32Result == LL_OK) {
+        pstcCh->stcStats.u32Done++;
+        pstcCh->stcStats.u32Bytes += pstcCh->u32Bytes;
+        pstcCh->stcStats.u32LastBytes = pstcCh->u32Bytes;
+        pstcCh->stcStats.u32LastCycles = u32Cycles;
+        pstcCh->stcStats.u64Cycles += u32Cycles;
+    } else {
+        pstcCh->stcStats.u32Errors++;
+    }
+
+    pstcCh->pfnDone = NULL;
+    pstcCh->u8Busy = 0U;
+
+    if (pfnDone != NULL) {
+        pfnDone(i32Result, pstcCh->pvArg);
+    }
+}
+
+/**
+ * @brief  Transfer-complete and error handling, called from the DMA TC and ERR interrupt callbacks.
+ * @param  [in] pstcCh                  Channel handle.
+ * @retval None
+ */
+void DMA_SG_IrqHandler(stc_dma_sg_ch_t *pstcCh) {
+    CM_DMA_TypeDef *DMAx = pstcCh->DMAx;
+    uint8_t u8Ch = pstcCh->u8Ch;
+    uint32_t u32ErrFlag = (DMA_FLAG_TRANS_ERR_CH0 | DMA_FLAG_REQ_ERR_CH0) << u8Ch;
+
+    if (DMA_GetErrStatus(DMAx, u32ErrFlag) == SET) {
+        DMA_ClearErrStatus(DMAx, u32ErrFlag);
+        (void)DMA_ChCmd(DMAx, u8Ch, DISABLE);
+
+        if (pstcCh->u8Busy != 0U) {
+            DMA_SG_Finish(pstcCh, LL_ERR);
+        }
+
+        return;
+    }
+
+    if (DMA_GetTransCompleteStatus(DMAx, DMA_FLAG_TC_CH0 << u8Ch) == SET) {
+        DMA_ClearTransCompleteStatus(DMAx, (DMA_FLAG_TC_CH0 | DMA_FLAG_BTC_CH0) << u8Ch);
+
+        /* Earlier descriptors also set TC, and loading the last one (IE = 1) may raise it at once;
+           the channel stays enabled until the last descriptor has finished. */
+        if (READ_REG32_BIT(DMAx->CHEN, 1UL << u8Ch) != 0UL) {
+            return;
+        }
+
+        if (pstcCh->u8Busy != 0U) {
+            DMA_SG_Finish(pstcCh, LL_OK);
+        }
+    }
+}
+
+/**
+ * @brief  Average throughput of the completed tables.
+ * @param  [in] pstcCh                  Channel handle.
+ * @retval Bytes per second, 0 before the first completion.
+ */
+uint32_t DMA_SG_GetThroughput(const stc_dma_sg_ch_t *pstcCh) {
+    if (pstcCh->stcStats.u64Cycles == 0ULL) {
+        return 0UL;
+    }
+
+    return (uint32_t)(((uint64_t)pstcCh->stcStats.u32Bytes * SystemCoreClock) / pstcCh->stcStats.u64Cycles);
+}
@@ -0,0 +1,114 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : dma_sg.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : DMA scatter/gather: an I/O vector is compiled into an LLP descriptor table,
+  *				   using repeat/non-sequence modes where they save descriptors, and started with one call
+  * Function List:
+  *		DMA_SG_TableInit
+  *		DMA_SG_CompileTx
+  *		DMA_SG_CompileRx
+  *		DMA_SG_CompileCopy
+  *		DMA_SG_ChInit
+  *		DMA_SG_ReconfigInit
+  *		DMA_SG_Start
+  *		DMA_SG_IsBusy
+  *		DMA_SG_IrqHandler
+  *		DMA_SG_GetThroughput
+  ******************************************************
+**/
+
+#ifndef __DMA_SG_H_
+#define __DMA_SG_H_
+
+#include "hc32_ll.h"
+
+#define DMA_SG_PERIPH_CNT_MAX       (65535UL)   /*!< Peripheral tables: one data per request, DTCTL.CNT */
+#define DMA_SG_MEM_BLOCK_MAX        (1024UL)    /*!< Memory tables: one block per descriptor, BLKSIZE 0 = 1024 */
+#define DMA_SG_RPT_MAX              (1023UL)    /*!< RPT.SRPT/DRPT */
+#define DMA_SG_NSEQ_CNT_MAX         (4095UL)    /*!< SNSEQCTL.SNSCNT/DNSEQCTL.DNSCNT */
+#define DMA_SG_NSEQ_OFFSET_MAX      (0xFFFFFUL) /*!< SNSEQCTL.SOFFSET/DNSEQCTL.DOFFSET */
+
+/* Non-sequence jump, in data units, from the last data of one run to the first of the next:
+   runs of u32Cnt data whose starts are u32Stride data apart. */
+#define DMA_SG_NSEQ_OFFSET(u32Stride, u32Cnt)   ((u32Stride) - (u32Cnt) + 1UL)
+
+/**
+ * @brief One segment of an I/O vector.
+ */
+typedef struct {
+    uint32_t u32Addr;
+    uint32_t u32Len;                /*!< Bytes, a multiple of the data width; 0 is skipped */
+} stc_dma_sg_vec_t;
+
+/**
+ * @brief Compiled descriptor table.
+ * @note  The descriptors must stay untouched in DMA-accessible RAM until the transfer completes.
+ *        Build errors are sticky: a table that failed once cannot be started.
+ */
+typedef struct {
+    stc_dma_llp_descriptor_t *pstcDesc;
+    uint16_t u16Max;
+    uint16_t u16Num;                /*!< Descriptors used */
+    uint32_t u32DataWidth;          /*!< @ref DMA_DataWidth_Sel, fixed by the first compile call */
+    uint8_t  u8Mem;                 /*!< 1: memory to memory, 0: peripheral request driven */
+    int32_t  i32Error;
+    uint32_t u32Bytes;              /*!< Bytes moved by the whole table */
+    uint32_t u32Segments;           /*!< Non-empty vector segments compiled */
+} stc_dma_sg_table_t;
+
+/**
+ * @brief Transfer statistics of one channel.
+ */
+typedef struct {
+    uint32_t u32Starts;
+    uint32_t u32Done;
+    uint32_t u32Errors;             /*!< Transfer or request errors */
+    uint32_t u32Descs;              /*!< Descriptors started */
+    uint32_t u32Segments;           /*!< Vector segments started */
+    uint32_t u32Bytes;              /*!< Bytes of completed tables */
+    uint32_t u32LastBytes;
+    uint32_t u32LastCycles;         /*!< Core cycles from DMA_SG_Start to the completion interrupt */
+    uint64_t u64Cycles;             /*!< Sum of the cycles of completed tables */
+} stc_dma_sg_stats_t;
+
+/**
+ * @brief DMA channel driven by the scatter/gather layer.
+ */
+typedef struct {
+    CM_DMA_TypeDef *DMAx;
+    uint8_t  u8Ch;
+    __IO uint8_t u8Busy;
+    uint8_t  u8Mem;
+    uint32_t u32Bytes;
+    uint32_t u32Start;
+    void (*pfnDone)(int32_t i32Result, void *pvArg);   /*!< Called from DMA_SG_IrqHandler */
+    void *pvArg;
+    stc_dma_sg_stats_t stcStats;
+} stc_dma_sg_ch_t;
+
+void DMA_SG_TableInit(stc_dma_sg_table_t *pstcTable, stc_dma_llp_descriptor_t *pstcDesc, uint16_t u16Max);
+int32_t DMA_SG_CompileTx(stc_dma_sg_table_t *pstcTable, const stc_dma_sg_vec_t *pstcVec, uint32_t u32Num,
+                         uint32_t u32PeriphAddr, uint32_t u32DataWidth);
+int32_t DMA_SG_CompileRx(stc_dma_sg_table_t *pstcTable, const stc_dma_sg_vec_t *pstcVec, uint32_t u32Num,
+                         uint32_t u32PeriphAddr, uint32_t u32DataWidth);
+int32_t DMA_SG_CompileCopy(stc_dma_sg_table_t *pstcTable, const stc_dma_sg_vec_t *pstcVec, uint32_t u32Num,
+                           uint32_t u32DestAddr, uint32_t u32DataWidth);
+
+int32_t DMA_SG_ChInit(stc_dma_sg_ch_t *pstcCh, CM_DMA_TypeDef *DMAx, uint8_t u8Ch, en_event_src_t enTrigSrc);
+int32_t DMA_SG_ReconfigInit(const stc_dma_sg_ch_t *pstcCh, en_event_src_t enEventSrc);
+int32_t DMA_SG_Start(stc_dma_sg_ch_t *pstcCh, const stc_dma_sg_table_t *pstcTable,
+                     void (*pfnDone)(int32_t i32Result, void *pvArg), void *pvArg);
+en_flag_status_t DMA_SG_IsBusy(const stc_dma_sg_ch_t *pstcCh);
+void DMA_SG_IrqHandler(stc_dma_sg_ch_t *pstcCh);
+uint32_t DMA_SG_GetThroughput(const stc_dma_sg_ch_t *pstcCh);
+
+#endif
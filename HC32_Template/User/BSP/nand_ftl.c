@@ -0,0 +1,854 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : nand_ftl.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					Log-structured page mapping FTL. All programs go to one write
+					frontier (the open block), each page carries its logical page number,
+					a global sequence number and the block erase count in the ECC
+					protected spare bytes, and the last page of a full block holds a
+					summary of the LPNs in it. Mounting reads one summary per block and
+					replays the blocks in sequence order; only blocks without a summary
+					(power lost while open, failed program) are scanned page by page.
+					  - Host sectors are merged into page buffers; a page is programmed
+					    as soon as all its sectors are present, so a sequential log is
+					    programmed without read-modify-write and GC of overwritten log
+					    blocks is a bare erase.
+					  - Free blocks are handed out lowest erase count first; GC picks the
+					    block with the fewest valid pages, or the least worn full block
+					    when the erase count spread passes FTL_WL_THRESHOLD, so cold data
+					    does not pin young blocks.
+					  - Pages that needed FTL_SCRUB_BITFLIPS corrected bits, blocks read
+					    FTL_DISTURB_READS times since their erase (read disturb also hits
+					    the pages nobody reads), and blocks whose program failed are moved
+					    out by GC first; failed blocks are then marked bad instead of
+					    erased. Bad blocks are found again at mount from their markers.
+					  - An open block flagged this way is given up at the next
+					    FTL_Background so GC can move it before it fills.
+					The module only calls stc_ftl_nand_ops_t, so it can run on a PC
+					against a RAM model of the NAND with injected bit errors, see
+					Test/nand_ftl_test.c.
+  * Function List:
+  *		FTL_Mount
+  *		FTL_Format
+  *		FTL_Read
+  *		FTL_Write
+  *		FTL_Flush
+  *		FTL_Background
+  *		FTL_GetSectorCount
+  *		FTL_GetStats
+  **********************************************************
+ */
+
+#include "nand_ftl.h"
+#include <string.h>
+
+#define FTL_PAGE_WORDS              ((FTL_PAGE_SIZE + FTL_SPARE_SIZE) / 4UL)
+#define FTL_NONE                    (0xFFFFFFFFUL)
+#define FTL_LPN_SUMMARY             (0xFFFFFFFEUL)
+#define FTL_SUMMARY_MAGIC           (0x4C544653UL)
+#define FTL_SECT_ALL                ((1UL << FTL_SECTORS_PER_PAGE) - 1UL)
+#define FTL_GC_FREE_MIN             (2UL)       /* Free blocks kept back so GC can always relocate one block */
+
+#define FTL_BLK_FREE                (0U)
+#define FTL_BLK_OPEN                (1U)
+#define FTL_BLK_FULL                (2U)
+#define FTL_BLK_BAD                 (3U)
+
+#define FTL_FLAG_ERASED             (0x01U)     /* Erased by this session, safe to program */
+#define FTL_FLAG_SCRUB              (0x02U)     /* Move the data out at the next chance */
+#define FTL_FLAG_RETIRE             (0x04U)     /* Program failed: mark bad instead of erasing */
+#define FTL_FLAG_SUMMARY            (0x08U)     /* Mount: summary page found */
+
+typedef struct {
+    uint32_t u32BadMark;            /* Kept 0xFFFFFFFF, the factory bad block marker lives here */
+    uint32_t u32Lpn;
+    uint32_t u32Seq;
+    uint32_t u32EraseCnt;
+} stc_ftl_spare_t;
+
+typedef struct {
+    uint32_t u32Lpn;                /* FTL_NONE when the slot is unused */
+    uint32_t u32Mask;               /* Sectors written by the host */
+    uint32_t u32Age;
+    uint32_t au32Buf[FTL_PAGE_WORDS];
+} stc_ftl_cache_t;
+
+static const stc_ftl_nand_ops_t *m_pstcOps = NULL;
+static uint32_t m_au32L2p[FTL_LPN_NUM];
+static uint32_t m_au32EraseCnt[FTL_BLOCK_NUM];
+static uint32_t m_au32BlkSeq[FTL_BLOCK_NUM];
+static uint32_t m_au32Reads[FTL_BLOCK_NUM];     /* Page reads since erase, RAM only: restarts from 0 at mount */
+static uint16_t m_au16Valid[FTL_BLOCK_NUM];
+static uint16_t m_au16Order[FTL_BLOCK_NUM];
+static uint8_t  m_au8State[FTL_BLOCK_NUM];
+static uint8_t  m_au8Flag[FTL_BLOCK_NUM];
+static uint32_t m_au32OpenLpn[FTL_DATA_PAGES];
+static uint32_t m_u32OpenBlk;
+static uint32_t m_u32OpenPage;
+static uint32_t m_u32Seq;
+static uint32_t m_u32FreeCnt;
+static uint32_t m_u32Age;
+static uint32_t m_au32Work[FTL_PAGE_WORDS];
+static uint32_t m_u32WorkLpn;       /* LPN whose data is in m_au32Work, FTL_NONE if none */
+static stc_ftl_cache_t m_astcCache[FTL_CACHE_PAGES];
+static stc_ftl_stats_t m_stcStats;
+static uint8_t m_u8Mounted = 0U;
+
+static stc_ftl_spare_t *FTL_Spare(uint32_t *pu32Buf) {
+    return (stc_ftl_spare_t *)&pu32Buf[FTL_PAGE_SIZE / 4UL];
+}
+
+static void FTL_SetState(uint32_t u32Blk, uint8_t u8State) {
+    if (FTL_BLK_FREE == m_au8State[u32Blk]) {
+        m_u32FreeCnt--;
+    }
+
+    if (FTL_BLK_FREE == u8State) {
+        m_u32FreeCnt++;
+    }
+
+    m_au8State[u32Blk] = u8State;
+}
+
+/**
+ * @brief  Read a page, count corrected bits and block reads, and flag the block for
+ *         scrubbing when needed.
+ */
+static int32_t FTL_ReadPage(uint32_t u32Ppn, uint32_t *pu32Buf) {
+    const uint32_t u32Blk = u32Ppn / FTL_PAGES_PER_BLOCK;
+    uint32_t u32Flips = 0UL;
+    int32_t i32Ret = m_pstcOps->pfnRead(u32Ppn, (uint8_t *)pu32Buf, &u32Flips);
+
+    if (FTL_OK == i32Ret) {
+        m_stcStats.u32BitFlips += u32Flips;
+
+        if (u32Flips >= FTL_SCRUB_BITFLIPS) {
+            m_au8Flag[u32Blk] |= FTL_FLAG_SCRUB;
+        }
+    } else {
+        m_stcStats.u32EccFail++;
+        m_au8Flag[u32Blk] |= FTL_FLAG_SCRUB;
+        i32Ret = FTL_ERR_ECC;
+    }
+
+    if (++m_au32Reads[u32Blk] >= FTL_DISTURB_READS) {
+        m_au8Flag[u32Blk] |= FTL_FLAG_SCRUB;
+    }
+
+    return i32Ret;
+}
+
+static void FTL_Retire(uint32_t u32Blk) {
+    (void)m_pstcOps->pfnMarkBad(u32Blk);
+    FTL_SetState(u32Blk, FTL_BLK_BAD);
+    m_au8Flag[u32Blk] = 0U;
+    m_stcStats.u32BadBlocks++;
+}
+
+static int32_t FTL_Erase(uint32_t u32Blk) {
+    m_stcStats.u32Erases++;
+
+    if (FTL_OK != m_pstcOps->pfnErase(u32Blk)) {
+        FTL_Retire(u32Blk);
+        return FTL_ERR;
+    }
+
+    m_au32EraseCnt[u32Blk]++;
+    m_au32Reads[u32Blk] = 0UL;
+    m_au8Flag[u32Blk] = FTL_FLAG_ERASED;
+    FTL_SetState(u32Blk, FTL_BLK_FREE);
+
+    return FTL_OK;
+}
+
+/**
+ * @brief  Make the least worn free block the write frontier.
+ */
+static int32_t FTL_Open(void) {
+    uint32_t u32Blk;
+    uint32_t i;
+
+    for (;;) {
+        u32Blk = FTL_NONE;
+
+        for (i = 0UL; i < FTL_BLOCK_NUM; i++) {
+            if ((FTL_BLK_FREE == m_au8State[i]) &&
+                    ((FTL_NONE == u32Blk) || (m_au32EraseCnt[i] < m_au32EraseCnt[u32Blk]))) {
+                u32Blk = i;
+            }
+        }
+
+        if (FTL_NONE == u32Blk) {
+            return FTL_ERR;
+        }
+
+        /* Free blocks found at mount may hold an interrupted erase */
+        if ((0U != (m_au8Flag[u32Blk] & FTL_FLAG_ERASED)) || (FTL_OK == FTL_Erase(u32Blk))) {
+            break;
+        }
+    }
+
+    FTL_SetState(u32Blk, FTL_BLK_OPEN);
+    m_au8Flag[u32Blk] = 0U;
+    m_au32BlkSeq[u32Blk] = m_u32Seq;
+    m_u32OpenBlk = u32Blk;
+    m_u32OpenPage = 0UL;
+
+    return FTL_OK;
+}
+
+/**
+ * @brief  Write the LPN list of the full open block to its last page and close it.
+ * @note   Without the summary the block is still found at mount, by a page scan.
+ */
+static void FTL_Close(void) {
+    stc_ftl_spare_t *pstcSpare = FTL_Spare(m_au32Work);
+    const uint32_t u32Blk = m_u32OpenBlk;
+
+    m_u32WorkLpn = FTL_NONE;
+    (void)memset(m_au32Work, 0xFF, sizeof(m_au32Work));
+    m_au32Work[0] = FTL_SUMMARY_MAGIC;
+    m_au32Work[1] = m_u32Seq - 1UL;
+    (void)memcpy(&m_au32Work[2], m_au32OpenLpn, sizeof(m_au32OpenLpn));
+    pstcSpare->u32Lpn = FTL_LPN_SUMMARY;
+    pstcSpare->u32Seq = m_au32BlkSeq[u32Blk];
+    pstcSpare->u32EraseCnt = m_au32EraseCnt[u32Blk];
+
+    if (FTL_OK != m_pstcOps->pfnProgram(u32Blk * FTL_PAGES_PER_BLOCK + FTL_DATA_PAGES, (uint8_t *)m_au32Work)) {
+        m_au8Flag[u32Blk] |= FTL_FLAG_RETIRE | FTL_FLAG_SCRUB;
+    }
+
+    FTL_SetState(u32Blk, FTL_BLK_FULL);
+    m_u32OpenBlk = FTL_NONE;
+}
+
+/**
+ * @brief  Program one logical page at the write frontier and remap it.
+ * @param  [in] u32Lpn              Logical page
+ * @param  [in] pu32Buf             Page buffer, the spare part is filled in here
+ * @retval FTL_OK, or FTL_ERR when no good block is left.
+ */
+static int32_t FTL_Append(uint32_t u32Lpn, uint32_t *pu32Buf) {
+    stc_ftl_spare_t *pstcSpare = FTL_Spare(pu32Buf);
+    uint32_t u32Blk;
+    uint32_t u32Ppn;
+    uint32_t u32Old;
+
+    for (;;) {
+        if ((FTL_NONE == m_u32OpenBlk) && (FTL_OK != FTL_Open())) {
+            return FTL_ERR;
+        }
+
+        u32Blk = m_u32OpenBlk;
+        u32Ppn = u32Blk * FTL_PAGES_PER_BLOCK + m_u32OpenPage;
+        pstcSpare->u32BadMark = FTL_NONE;
+        pstcSpare->u32Lpn = u32Lpn;
+        pstcSpare->u32Seq = m_u32Seq;
+        pstcSpare->u32EraseCnt = m_au32EraseCnt[u32Blk];
+
+        if (FTL_OK == m_pstcOps->pfnProgram(u32Ppn, (uint8_t *)pu32Buf)) {
+            break;
+        }
+
+        /* Pages already in the block stay readable; GC moves them out, then retires the block */
+        m_au8Flag[u32Blk] |= FTL_FLAG_RETIRE | FTL_FLAG_SCRUB;
+        FTL_SetState(u32Blk, FTL_BLK_FULL);
+        m_u32OpenBlk = FTL_NONE;
+    }
+
+    m_u32Seq++;
+    u32Old = m_au32L2p[u32Lpn];
+
+    if (FTL_NONE != u32Old) {
+        m_au16Valid[u32Old / FTL_PAGES_PER_BLOCK]--;
+    }
+
+    m_au32L2p[u32Lpn] = u32Ppn;
+    m_au16Valid[u32Blk]++;
+    m_au32OpenLpn[m_u32OpenPage] = u32Lpn;
+
+    if (m_u32WorkLpn == u32Lpn) {
+        m_u32WorkLpn = FTL_NONE;
+    }
+
+    if (++m_u32OpenPage == FTL_DATA_PAGES) {
+        FTL_Close();
+    }
+
+    return FTL_OK;
+}
+
+/**
+ * @brief  Pick the GC victim: a block to scrub or retire, the least worn full block when
+ *         wear has drifted apart, otherwise the full block with the fewest valid pages.
+ */
+static uint32_t FTL_Victim(void) {
+    uint32_t u32Greedy = FTL_NONE;
+    uint32_t u32Cold = FTL_NONE;
+    uint32_t u32MaxEc = 0UL;
+    uint32_t i;
+
+    for (i = 0UL; i < FTL_BLOCK_NUM; i++) {
+        if (FTL_BLK_BAD == m_au8State[i]) {
+            continue;
+        }
+
+        if (m_au32EraseCnt[i] > u32MaxEc) {
+            u32MaxEc = m_au32EraseCnt[i];
+        }
+
+        if (FTL_BLK_FULL != m_au8State[i]) {
+            continue;
+        }
+
+        if (0U != (m_au8Flag[i] & (FTL_FLAG_SCRUB | FTL_FLAG_RETIRE))) {
+            return i;
+        }
+
+        if ((FTL_NONE == u32Greedy) || (m_au16Valid[i] < m_au16Valid[u32Greedy])) {
+            u32Greedy = i;
+        }
+
+        if ((FTL_NONE == u32Cold) || (m_au32EraseCnt[i] < m_au32EraseCnt[u32Cold])) {
+            u32Cold = i;
+        }
+    }
+
+    if ((FTL_NONE != u32Cold) && ((u32MaxEc - m_au32EraseCnt[u32Cold]) > FTL_WL_THRESHOLD)) {
+        return u32Cold;
+    }
+
+    return u32Greedy;
+}
+
+/**
+ * @brief  Drop the mapping of an unreadable page; its LPN is not known from the spare.
+ */
+static void FTL_Drop(uint32_t u32Ppn) {
+    uint32_t i;
+
+    for (i = 0UL; i < FTL_LPN_NUM; i++) {
+        if (m_au32L2p[i] == u32Ppn) {
+            m_au32L2p[i] = FTL_NONE;
+            m_au16Valid[u32Ppn / FTL_PAGES_PER_BLOCK]--;
+            break;
+        }
+    }
+}
+
+/**
+ * @brief  Move the valid pages of a full block to the write frontier and erase it.
+ */
+static int32_t FTL_Collect(uint32_t u32Blk) {
+    stc_ftl_spare_t *pstcSpare = FTL_Spare(m_au32Work);
+    uint32_t u32Ppn;
+    uint32_t i;
+
+    m_u32WorkLpn = FTL_NONE;
+
+    for (i = 0UL; (i < FTL_DATA_PAGES) && (0U != m_au16Valid[u32Blk]); i++) {
+        u32Ppn = u32Blk * FTL_PAGES_PER_BLOCK + i;
+
+        if (FTL_OK != FTL_ReadPage(u32Ppn, m_au32Work)) {
+            FTL_Drop(u32Ppn);
+            continue;
+        }
+
+        if ((pstcSpare->u32Lpn < FTL_LPN_NUM) && (m_au32L2p[pstcSpare->u32Lpn] == u32Ppn)) {
+            if (FTL_OK != FTL_Append(pstcSpare->u32Lpn, m_au32Work)) {
+                return FTL_ERR;
+            }
+
+            m_stcStats.u32GcPages++;
+        }
+    }
+
+    if (0U != (m_au8Flag[u32Blk] & FTL_FLAG_RETIRE)) {
+        FTL_Retire(u32Blk);
+        return FTL_OK;
+    }
+
+    return FTL_Erase(u32Blk);
+}
+
+static int32_t FTL_MakeRoom(void) {
+    uint32_t u32Blk;
+    uint32_t u32Loop = FTL_BLOCK_NUM;
+
+    while ((m_u32FreeCnt < FTL_GC_FREE_MIN) && (0UL != u32Loop--)) {
+        u32Blk = FTL_Victim();
+
+        if ((FTL_NONE == u32Blk) || (FTL_OK != FTL_Collect(u32Blk))) {
+            break;
+        }
+    }
+
+    return ((m_u32FreeCnt > 0UL) || (FTL_NONE != m_u32OpenBlk)) ? FTL_OK : FTL_ERR;
+}
+
+/**
+ * @brief  Program a cache slot, reading back the sectors the host did not write.
+ */
+static int32_t FTL_Evict(stc_ftl_cache_t *pstcSlot) {
+    uint32_t u32Ppn;
+    uint32_t i;
+    int32_t i32Ret;
+
+    if (FTL_NONE == pstcSlot->u32Lpn) {
+        return FTL_OK;
+    }
+
+    u32Ppn = m_au32L2p[pstcSlot->u32Lpn];
+
+    if ((FTL_SECT_ALL != pstcSlot->u32Mask) && (FTL_NONE != u32Ppn)) {
+        m_stcStats.u32Rmw++;
+        m_u32WorkLpn = FTL_NONE;
+
+        if (FTL_OK == FTL_ReadPage(u32Ppn, m_au32Work)) {
+            for (i = 0UL; i < FTL_SECTORS_PER_PAGE; i++) {
+                if (0UL == (pstcSlot->u32Mask & (1UL << i))) {
+                    (void)memcpy(&pstcSlot->au32Buf[i * FTL_SECTOR_SIZE / 4UL],
+                                 &m_au32Work[i * FTL_SECTOR_SIZE / 4UL], FTL_SECTOR_SIZE);
+                }
+            }
+        }
+    }
+
+    i32Ret = FTL_MakeRoom();
+
+    if (FTL_OK == i32Ret) {
+        i32Ret = FTL_Append(pstcSlot->u32Lpn, pstcSlot->au32Buf);
+        m_stcStats.u32HostPages++;
+    }
+
+    pstcSlot->u32Lpn = FTL_NONE;
+    return i32Ret;
+}
+
+/**
+ * @brief  Find the cache slot of an LPN, or take one (evicting the least recently used).
+ */
+static int32_t FTL_Slot(uint32_t u32Lpn, stc_ftl_cache_t **ppstcSlot) {
+    stc_ftl_cache_t *pstcSlot = &m_astcCache[0];
+    int32_t i32Ret = FTL_OK;
+    uint32_t i;
+
+    for (i = 0UL; i < FTL_CACHE_PAGES; i++) {
+        if (m_astcCache[i].u32Lpn == u32Lpn) {
+            *ppstcSlot = &m_astcCache[i];
+            return FTL_OK;
+        }
+
+        if ((FTL_NONE != pstcSlot->u32Lpn) &&
+                ((FTL_NONE == m_astcCache[i].u32Lpn) || (m_astcCache[i].u32Age < pstcSlot->u32Age))) {
+            pstcSlot = &m_astcCache[i];
+        }
+    }
+
+    i32Ret = FTL_Evict(pstcSlot);
+    pstcSlot->u32Lpn = u32Lpn;
+    pstcSlot->u32Mask = 0UL;
+    (void)memset(pstcSlot->au32Buf, 0xFF, FTL_PAGE_SIZE);
+    *ppstcSlot = pstcSlot;
+
+    return i32Ret;
+}
+
+static void FTL_Reset(const stc_ftl_nand_ops_t *pstcOps) {
+    uint32_t i;
+
+    m_pstcOps = pstcOps;
+    m_u8Mounted = 0U;
+    m_u32OpenBlk = FTL_NONE;
+    m_u32OpenPage = 0UL;
+    m_u32Seq = 1UL;
+    m_u32FreeCnt = 0UL;
+    m_u32Age = 0UL;
+    m_u32WorkLpn = FTL_NONE;
+    (void)memset(m_au32L2p, 0xFF, sizeof(m_au32L2p));
+    (void)memset(m_au32EraseCnt, 0, sizeof(m_au32EraseCnt));
+    (void)memset(m_au32Reads, 0, sizeof(m_au32Reads));
+    (void)memset(m_au16Valid, 0, sizeof(m_au16Valid));
+    (void)memset(m_au8Flag, 0, sizeof(m_au8Flag));
+    (void)memset(&m_stcStats, 0, sizeof(m_stcStats));
+
+    for (i = 0UL; i < FTL_BLOCK_NUM; i++) {
+        m_au8State[i] = FTL_BLK_BAD;
+    }
+
+    for (i = 0UL; i < FTL_CACHE_PAGES; i++) {
+        m_astcCache[i].u32Lpn = FTL_NONE;
+    }
+}
+
+/**
+ * @brief  Classify a block at mount from its summary page, or from its first page.
+ */
+static void FTL_ScanBlock(uint32_t u32Blk) {
+    stc_ftl_spare_t *pstcSpare = FTL_Spare(m_au32Work);
+    const uint32_t u32Page = u32Blk * FTL_PAGES_PER_BLOCK;
+
+    if (0 != m_pstcOps->pfnIsBad(u32Blk)) {
+        m_stcStats.u32BadBlocks++;
+        return;
+    }
+
+    if ((FTL_OK == FTL_ReadPage(u32Page + FTL_DATA_PAGES, m_au32Work)) &&
+            (FTL_LPN_SUMMARY == pstcSpare->u32Lpn) && (FTL_SUMMARY_MAGIC == m_au32Work[0])) {
+        m_au8State[u32Blk] = FTL_BLK_FULL;
+        m_au8Flag[u32Blk] |= FTL_FLAG_SUMMARY;
+        m_au32BlkSeq[u32Blk] = pstcSpare->u32Seq;
+        m_au32EraseCnt[u32Blk] = pstcSpare->u32EraseCnt;
+    } else if (FTL_OK != FTL_ReadPage(u32Page, m_au32Work)) {
+        m_au8State[u32Blk] = FTL_BLK_FULL;
+        m_au32BlkSeq[u32Blk] = 0UL;
+        m_au32EraseCnt[u32Blk] = FTL_NONE;
+    } else if (FTL_NONE == pstcSpare->u32Lpn) {
+        m_au8State[u32Blk] = FTL_BLK_FREE;
+        m_au32EraseCnt[u32Blk] = FTL_NONE;
+        m_u32FreeCnt++;
+    } else {
+        m_au8State[u32Blk] = FTL_BLK_FULL;
+        m_au32BlkSeq[u32Blk] = pstcSpare->u32Seq;
+        m_au32EraseCnt[u32Blk] = pstcSpare->u32EraseCnt;
+    }
+}
+
+/**
+ * @brief  Map the pages of a used block; later blocks override earlier ones.
+ */
+static void FTL_Replay(uint32_t u32Blk) {
+    stc_ftl_spare_t *pstcSpare = FTL_Spare(m_au32Work);
+    uint32_t u32Lpn;
+    uint32_t u32Last = m_au32BlkSeq[u32Blk];
+    uint32_t i;
+
+    if ((0U != (m_au8Flag[u32Blk] & FTL_FLAG_SUMMARY)) &&
+            (FTL_OK == FTL_ReadPage(u32Blk * FTL_PAGES_PER_BLOCK + FTL_DATA_PAGES, m_au32Work))) {
+        for (i = 0UL; i < FTL_DATA_PAGES; i++) {
+            u32Lpn = m_au32Work[2UL + i];
+
+            if (u32Lpn < FTL_LPN_NUM) {
+                m_au32L2p[u32Lpn] = u32Blk * FTL_PAGES_PER_BLOCK + i;
+            }
+        }
+
+        u32Last = m_au32Work[1];
+    } else {
+        for (i = 0UL; i < FTL_DATA_PAGES; i++) {
+            if (FTL_OK != FTL_ReadPage(u32Blk * FTL_PAGES_PER_BLOCK + i, m_au32Work)) {
+                continue;
+            }
+
+            if (FTL_NONE == pstcSpare->u32Lpn) {
+                break;
+            }
+
+            if (pstcSpare->u32Lpn < FTL_LPN_NUM) {
+                m_au32L2p[pstcSpare->u32Lpn] = u32Blk * FTL_PAGES_PER_BLOCK + i;
+                u32Last = pstcSpare->u32Seq;
+            }
+        }
+    }
+
+    if (u32Last >= m_u32Seq) {
+        m_u32Seq = u32Last + 1UL;
+    }
+}
+
+/**
+ * @brief  Rebuild the mapping from the NAND contents.
+ * @param  [in] pstcOps             NAND page operations
+ * @retval int32_t:
+ *           - FTL_OK:              Mounted, an empty device mounts as all 0xFF.
+ *           - FTL_ERR_INVD_PARAM:  pstcOps is NULL.
+ */
+int32_t FTL_Mount(const stc_ftl_nand_ops_t *pstcOps) {
+    uint32_t u32Used = 0UL;
+    uint32_t u32Sum = 0UL;
+    uint32_t u32Known = 0UL;
+    uint32_t i;
+    uint32_t j;
+
+    if (NULL == pstcOps) {
+        return FTL_ERR_INVD_PARAM;
+    }
+
+    FTL_Reset(pstcOps);
+
+    for (i = 0UL; i < FTL_BLOCK_NUM; i++) {
+        FTL_ScanBlock(i);
+
+        if (FTL_BLK_FULL == m_au8State[i]) {
+            /* Insertion sort by sequence number */
+            for (j = u32Used; (j > 0UL) && (m_au32BlkSeq[m_au16Order[j - 1UL]] > m_au32BlkSeq[i]); j--) {
+                m_au16Order[j] = m_au16Order[j - 1UL];
+            }
+
+            m_au16Order[j] = (uint16_t)i;
+            u32Used++;
+        }
+
+        if ((FTL_BLK_BAD != m_au8State[i]) && (FTL_NONE != m_au32EraseCnt[i])) {
+            u32Sum += m_au32EraseCnt[i];
+            u32Known++;
+        }
+    }
+
+    for (i = 0UL; i < u32Used; i++) {
+        FTL_Replay(m_au16Order[i]);
+    }
+
+    for (i = 0UL; i < FTL_LPN_NUM; i++) {
+        if (FTL_NONE != m_au32L2p[i]) {
+            m_au16Valid[m_au32L2p[i] / FTL_PAGES_PER_BLOCK]++;
+        }
+    }
+
+    /* Erased blocks lost their count, give them the average */
+    for (i = 0UL; i < FTL_BLOCK_NUM; i++) {
+        if (FTL_NONE == m_au32EraseCnt[i]) {
+            m_au32EraseCnt[i] = (0UL != u32Known) ? (u32Sum / u32Known) : 0UL;
+        }
+    }
+
+    m_u8Mounted = 1U;
+    return FTL_OK;
+}
+
+/**
+ * @brief  Erase every good block and mount the empty device.
+ * @param  [in] pstcOps             NAND page operations
+ * @retval FTL_OK or FTL_ERR_INVD_PARAM.
+ */
+int32_t FTL_Format(const stc_ftl_nand_ops_t *pstcOps) {
+    uint32_t i;
+
+    if (NULL == pstcOps) {
+        return FTL_ERR_INVD_PARAM;
+    }
+
+    FTL_Reset(pstcOps);
+
+    for (i = 0UL; i < FTL_BLOCK_NUM; i++) {
+        if (0 != pstcOps->pfnIsBad(i)) {
+            m_stcStats.u32BadBlocks++;
+        } else {
+            m_au8State[i] = FTL_BLK_FULL;
+            (void)FTL_Erase(i);
+        }
+    }
+
+    m_u8Mounted = 1U;
+    return FTL_OK;
+}
+
+/**
+ * @brief  Read sectors, including data still in the page cache.
+ * @param  [in] u32Sector           First sector
+ * @param  [out] pu8Buf             Destination, u32Count * FTL_SECTOR_SIZE bytes
+ * @param  [in] u32Count            Number of sectors
+ * @retval int32_t:
+ *           - FTL_OK:              Never written sectors read as 0xFF.
+ *           - FTL_ERR_ECC:         A page could not be corrected.
+ *           - FTL_ERR_INVD_PARAM:  Not mounted or out of range.
+ */
+int32_t FTL_Read(uint32_t u32Sector, uint8_t *pu8Buf, uint32_t u32Count) {
+    uint32_t u32Lpn;
+    uint32_t u32Sect;
+    uint32_t u32Ppn;
+    const uint32_t *pu32Src;
+    uint32_t i;
+
+    if ((0U == m_u8Mounted) || (NULL == pu8Buf) ||
+            (u32Sector >= FTL_GetSectorCount()) || (u32Count > (FTL_GetSectorCount() - u32Sector))) {
+        return FTL_ERR_INVD_PARAM;
+    }
+
+    for (; 0UL != u32Count; u32Count--, u32Sector++, pu8Buf += FTL_SECTOR_SIZE) {
+        u32Lpn = u32Sector / FTL_SECTORS_PER_PAGE;
+        u32Sect = u32Sector % FTL_SECTORS_PER_PAGE;
+        pu32Src = NULL;
+
+        for (i = 0UL; i < FTL_CACHE_PAGES; i++) {
+            if ((m_astcCache[i].u32Lpn == u32Lpn) && (0UL != (m_astcCache[i].u32Mask & (1UL << u32Sect)))) {
+                pu32Src = m_astcCache[i].au32Buf;
+                break;
+            }
+        }
+
+        if ((NULL == pu32Src) && (m_u32WorkLpn != u32Lpn)) {
+            u32Ppn = m_au32L2p[u32Lpn];
+
+            if (FTL_NONE == u32Ppn) {
+                (void)memset(pu8Buf, 0xFF, FTL_SECTOR_SIZE);
+                continue;
+            }
+
+            m_u32WorkLpn = FTL_NONE;
+
+            if (FTL_OK != FTL_ReadPage(u32Ppn, m_au32Work)) {
+                return FTL_ERR_ECC;
+            }
+
+            m_u32WorkLpn = u32Lpn;
+        }
+
+        if (NULL == pu32Src) {
+            pu32Src = m_au32Work;
+        }
+
+        (void)memcpy(pu8Buf, &pu32Src[u32Sect * FTL_SECTOR_SIZE / 4UL], FTL_SECTOR_SIZE);
+    }
+
+    return FTL_OK;
+}
+
+/**
+ * @brief  Write sectors. A page is programmed once all its sectors are in the cache,
+ *         partial pages wait there until evicted or flushed.
+ * @param  [in] u32Sector           First sector
+ * @param  [in] pu8Buf              Source, u32Count * FTL_SECTOR_SIZE bytes
+ * @param  [in] u32Count            Number of sectors
+ * @retval int32_t:
+ *           - FTL_OK:              Accepted.
+ *           - FTL_ERR:             No good block left to program.
+ *           - FTL_ERR_INVD_PARAM:  Not mounted or out of range.
+ */
+int32_t FTL_Write(uint32_t u32Sector, const uint8_t *pu8Buf, uint32_t u32Count) {
+    stc_ftl_cache_t *pstcSlot;
+    uint32_t u32Lpn;
+    uint32_t u32Sect;
+    uint32_t u32Num;
+    int32_t i32Ret = FTL_OK;
+
+    if ((0U == m_u8Mounted) || (NULL == pu8Buf) ||
+            (u32Sector >= FTL_GetSectorCount()) || (u32Count > (FTL_GetSectorCount() - u32Sector))) {
+        return FTL_ERR_INVD_PARAM;
+    }
+
+    while ((0UL != u32Count) && (FTL_OK == i32Ret)) {
+        u32Lpn = u32Sector / FTL_SECTORS_PER_PAGE;
+        u32Sect = u32Sector % FTL_SECTORS_PER_PAGE;
+        u32Num = FTL_SECTORS_PER_PAGE - u32Sect;
+
+        if (u32Num > u32Count) {
+            u32Num = u32Count;
+        }
+
+        i32Ret = FTL_Slot(u32Lpn, &pstcSlot);
+        (void)memcpy(&pstcSlot->au32Buf[u32Sect * FTL_SECTOR_SIZE / 4UL], pu8Buf, u32Num * FTL_SECTOR_SIZE);
+        pstcSlot->u32Mask |= ((1UL << u32Num) - 1UL) << u32Sect;
+        pstcSlot->u32Age = ++m_u32Age;
+
+        if (FTL_SECT_ALL == pstcSlot->u32Mask) {
+            i32Ret = FTL_Evict(pstcSlot);
+        }
+
+        u32Sector += u32Num;
+        pu8Buf += u32Num * FTL_SECTOR_SIZE;
+        u32Count -= u32Num;
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Program every partial page in the cache (read-modify-write).
+ * @retval FTL_OK or FTL_ERR.
+ */
+int32_t FTL_Flush(void) {
+    int32_t i32Ret = FTL_OK;
+    uint32_t i;
+
+    if (0U == m_u8Mounted) {
+        return FTL_ERR_INVD_PARAM;
+    }
+
+    for (i = 0UL; i < FTL_CACHE_PAGES; i++) {
+        if (FTL_OK != FTL_Evict(&m_astcCache[i])) {
+            i32Ret = FTL_ERR;
+        }
+    }
+
+    return i32Ret;
+}
+
+/**
+ * @brief  Idle-time work: scrub one flagged block, or collect one block ahead of time
+ *         so the next writes do not wait for GC.
+ * @retval FTL_OK, or FTL_ERR when GC could not relocate.
+ */
+int32_t FTL_Background(void) {
+    uint32_t u32Blk;
+
+    if (0U == m_u8Mounted) {
+        return FTL_ERR_INVD_PARAM;
+    }
+
+    /* Hot pages moved by a scrub land in the open block and can disturb it before it fills:
+       give it up like after a failed program, the page scan at mount still finds it */
+    if ((FTL_NONE != m_u32OpenBlk) && (0U != (m_au8Flag[m_u32OpenBlk] & FTL_FLAG_SCRUB))) {
+        FTL_SetState(m_u32OpenBlk, FTL_BLK_FULL);
+        m_u32OpenBlk = FTL_NONE;
+    }
+
+    u32Blk = FTL_Victim();
+
+    if (FTL_NONE == u32Blk) {
+        return FTL_OK;
+    }
+
+    /* Flagged blocks always; otherwise only when free blocks run short and there is something to gain */
+    if ((0U == (m_au8Flag[u32Blk] & (FTL_FLAG_SCRUB | FTL_FLAG_RETIRE))) &&
+            ((m_u32FreeCnt > FTL_GC_FREE_MIN) || (FTL_DATA_PAGES == m_au16Valid[u32Blk]))) {
+        return FTL_OK;
+    }
+
+    return FTL_Collect(u32Blk);
+}
+
+/**
+ * @brief  Exported size in sectors.
+ */
+uint32_t FTL_GetSectorCount(void) {
+    return FTL_LPN_NUM * FTL_SECTORS_PER_PAGE;
+}
+
+/**
+ * @brief  Get the FTL statistics.
+ * @param  [out] pstcStats          Statistics
+ * @retval 无
+ */
+void FTL_GetStats(stc_ftl_stats_t *pstcStats) {
+    uint32_t i;
+
+    m_stcStats.u32FreeBlocks = m_u32FreeCnt;
+    m_stcStats.u32MinErase = FTL_NONE;
+    m_stcStats.u32MaxErase = 0UL;
+
+    for (i = 0UL; i < FTL_BLOCK_NUM; i++) {
+        if (FTL_BLK_BAD != m_au8State[i]) {
+            if (m_au32EraseCnt[i] < m_stcStats.u32MinErase) {
+                m_stcStats.u32MinErase = m_au32EraseCnt[i];
+            }
+
+            if (m_au32EraseCnt[i] > m_stcStats.u32MaxErase) {
+                m_stcStats.u32MaxErase = m_au32EraseCnt[i];
+            }
+        }
+    }
+
+    *pstcStats = m_stcStats;
+}
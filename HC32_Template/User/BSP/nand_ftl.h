@@ -0,0 +1,123 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : nand_ftl.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : NAND flash translation layer: page mapping, wear levelling, bad blocks,
+  *				   garbage collection and a write-combining page cache. It only uses the
+  *				   page operations in stc_ftl_nand_ops_t, so it builds on a PC as well
+  * Function List:
+  *		FTL_Mount
+  *		FTL_Format
+  *		FTL_Read
+  *		FTL_Write
+  *		FTL_Flush
+  *		FTL_Background
+  *		FTL_GetSectorCount
+  *		FTL_GetStats
+  ******************************************************
+**/
+
+#ifndef __NAND_FTL_H_
+#define __NAND_FTL_H_
+
+#include <stdint.h>
+
+/**
+ * @defgroup NAND_FTL_Geometry NAND FTL Geometry
+ * @note  Override before including this file (or with -D) to match the device.
+ * @{
+ */
+#ifndef FTL_PAGE_SIZE
+#define FTL_PAGE_SIZE               (2048UL)    /*!< Data bytes per page */
+#endif
+#ifndef FTL_PAGES_PER_BLOCK
+#define FTL_PAGES_PER_BLOCK         (64UL)
+#endif
+#ifndef FTL_BLOCK_NUM
+#define FTL_BLOCK_NUM               (256UL)     /*!< Blocks handed to the FTL */
+#endif
+#ifndef FTL_RESERVED_BLOCKS
+#define FTL_RESERVED_BLOCKS         (FTL_BLOCK_NUM / 32UL + 4UL)    /*!< Not exported: bad block and GC headroom */
+#endif
+#ifndef FTL_CACHE_PAGES
+#define FTL_CACHE_PAGES             (4UL)       /*!< Partially written pages kept in RAM */
+#endif
+#ifndef FTL_SCRUB_BITFLIPS
+#define FTL_SCRUB_BITFLIPS          (3UL)       /*!< Corrected bits in one page that get its block rewritten */
+#endif
+#ifndef FTL_DISTURB_READS
+#define FTL_DISTURB_READS           (50000UL)   /*!< Page reads of one block since its erase that get it rewritten (read disturb) */
+#endif
+#ifndef FTL_WL_THRESHOLD
+#define FTL_WL_THRESHOLD            (64UL)      /*!< Erase count spread that moves cold data */
+#endif
+/**
+ * @}
+ */
+
+#define FTL_SECTOR_SIZE             (512UL)
+#define FTL_SPARE_SIZE              (16UL)      /*!< Spare bytes per page used by the FTL, ECC protected */
+#define FTL_SECTORS_PER_PAGE        (FTL_PAGE_SIZE / FTL_SECTOR_SIZE)
+#define FTL_DATA_PAGES              (FTL_PAGES_PER_BLOCK - 1UL)     /*!< The last page of a block holds its summary */
+#define FTL_LPN_NUM                 ((FTL_BLOCK_NUM - FTL_RESERVED_BLOCKS) * FTL_DATA_PAGES)
+
+/**
+ * @defgroup NAND_FTL_Return NAND FTL Return Codes
+ * @note  FTL_OK, FTL_ERR and FTL_ERR_INVD_PARAM equal the LL codes, so a driver can pass them through.
+ * @{
+ */
+#define FTL_OK                      (0)
+#define FTL_ERR                     (-1)        /*!< Program/erase failed or no space left */
+#define FTL_ERR_INVD_PARAM          (-3)
+#define FTL_ERR_ECC                 (-32)       /*!< Uncorrectable page */
+/**
+ * @}
+ */
+
+/**
+ * @brief NAND page operations used by the FTL.
+ * @note  Pages and blocks are numbered from the start of the FTL area. A page buffer holds
+ *        FTL_PAGE_SIZE data bytes followed by FTL_SPARE_SIZE spare bytes, word aligned.
+ */
+typedef struct {
+    int32_t (*pfnRead)(uint32_t u32Page, uint8_t *pu8Buf, uint32_t *pu32BitFlips);    /*!< FTL_OK (corrected bits in *pu32BitFlips), FTL_ERR_ECC; an erased page reads as all 0xFF */
+    int32_t (*pfnProgram)(uint32_t u32Page, const uint8_t *pu8Buf);                   /*!< FTL_OK or FTL_ERR when the status reports a failure */
+    int32_t (*pfnErase)(uint32_t u32Block);
+    int32_t (*pfnIsBad)(uint32_t u32Block);                                           /*!< 1: factory or runtime bad block marker set */
+    int32_t (*pfnMarkBad)(uint32_t u32Block);
+} stc_ftl_nand_ops_t;
+
+/**
+ * @brief FTL statistics.
+ */
+typedef struct {
+    uint32_t u32HostPages;          /*!< Pages programmed for host writes */
+    uint32_t u32GcPages;            /*!< Pages copied by garbage collection, (host + gc) / host is the write amplification */
+    uint32_t u32Rmw;                /*!< Partial pages that needed the old page read back */
+    uint32_t u32Erases;
+    uint32_t u32BitFlips;           /*!< Bits corrected by ECC */
+    uint32_t u32EccFail;            /*!< Uncorrectable page reads */
+    uint32_t u32BadBlocks;
+    uint32_t u32FreeBlocks;
+    uint32_t u32MinErase;
+    uint32_t u32MaxErase;
+} stc_ftl_stats_t;
+
+int32_t FTL_Mount(const stc_ftl_nand_ops_t *pstcOps);
+int32_t FTL_Format(const stc_ftl_nand_ops_t *pstcOps);
+int32_t FTL_Read(uint32_t u32Sector, uint8_t *pu8Buf, uint32_t u32Count);
+int32_t FTL_Write(uint32_t u32Sector, const uint8_t *pu8Buf, uint32_t u32Count);
+int32_t FTL_Flush(void);
+int32_t FTL_Background(void);
+uint32_t FTL_GetSectorCount(void);
+void FTL_GetStats(stc_ftl_stats_t *pstcStats);
+
+#endif
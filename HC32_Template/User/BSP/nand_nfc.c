@@ -0,0 +1,321 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : nand_nfc.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					Page operations of the NAND FTL on the EXMC NFC. Pages are read and
+					programmed with the 4-bit ECC on, FTL_SPARE_SIZE spare bytes travel
+					with the data and are covered by the last ECC section.
+					In 4-bit mode the NFC only reports which 512-byte sections are wrong
+					and their syndromes S1..S8 (BCH over GF(2^13)); the error locator is
+					found here with Berlekamp-Massey and its roots with a Chien search.
+					Codeword bit order: byte 0 of a section is the highest degree term,
+					bit 0 of each byte first, the 52 parity bits are the lowest terms.
+					An erased page has no valid ECC and reads as errors, so a page that
+					is all 0xFF except for a few bits is returned as erased.
+					Program and erase check the FAIL bit of the NAND status. Bad blocks
+					use the factory marker: first spare byte of page 0 or 1 not 0xFF.
+  * Function List:
+  *		NAND_NFC_Init
+  *		NAND_NFC_GetOps
+  *		NAND_NFC_BchCorrect
+  **********************************************************
+ */
+
+#include "nand_nfc.h"
+#include <string.h>
+
+#define NAND_NFC_TIMEOUT            (EXMC_NFC_MAX_TIMEOUT)
+#define NAND_NFC_STATUS_FAIL        (0x01UL)
+#define NAND_NFC_BUF_SIZE           (FTL_PAGE_SIZE + FTL_SPARE_SIZE)
+#define NAND_NFC_SECTIONS           (FTL_PAGE_SIZE / NAND_NFC_SECTION_SIZE)
+
+#define GF_M                        (13U)
+#define GF_POLY                     (0x201BU)   /* x^13 + x^4 + x^3 + x + 1 */
+#define GF_ORDER                    ((1UL << GF_M) - 1UL)
+#define BCH_PARITY_BITS             (GF_M * NAND_NFC_BCH_T)
+
+static uint32_t m_u32Bank;
+static uint32_t m_u32FirstPage;
+static uint32_t m_au32Raw[(FTL_PAGE_SIZE + 4UL) / 4UL];
+
+/**
+ * @brief  GF(2^13) multiply, shift-and-add; only used when a section has errors.
+ */
+static uint16_t GF_Mul(uint16_t u16A, uint16_t u16B) {
+    uint32_t u32A = u16A;
+    uint32_t u32R = 0UL;
+
+    while (0U != u16B) {
+        if (0U != (u16B & 1U)) {
+            u32R ^= u32A;
+        }
+
+        u16B >>= 1U;
+        u32A <<= 1U;
+
+        if (0UL != (u32A & (1UL << GF_M))) {
+            u32A ^= GF_POLY;
+        }
+    }
+
+    return (uint16_t)u32R;
+}
+
+static uint16_t GF_Pow(uint16_t u16A, uint32_t u32E) {
+    uint16_t u16R = 1U;
+
+    u32E %= GF_ORDER;
+
+    while (0UL != u32E) {
+        if (0UL != (u32E & 1UL)) {
+            u16R = GF_Mul(u16R, u16A);
+        }
+
+        u16A = GF_Mul(u16A, u16A);
+        u32E >>= 1U;
+    }
+
+    return u16R;
+}
+
+/**
+ * @brief  Correct one ECC section from its syndromes.
+ * @param  [in,out] pu8Data         Section data (the parity bits are not touched)
+ * @param  [in] u32Len              Section length in bytes
+ * @param  [in] au16Synd            Syndromes S1..S8
+ * @retval Number of corrected bits, or FTL_ERR_ECC when more than NAND_NFC_BCH_T bits are wrong.
+ */
+int32_t NAND_NFC_BchCorrect(uint8_t *pu8Data, uint32_t u32Len, const uint16_t au16Synd[]) {
+    uint16_t au16C[2U * NAND_NFC_BCH_T + 1U] = {1U};
+    uint16_t au16B[2U * NAND_NFC_BCH_T + 1U] = {1U};
+    uint16_t au16T[2U * NAND_NFC_BCH_T + 1U];
+    uint16_t au16Term[NAND_NFC_BCH_T + 1U];
+    uint16_t au16Step[NAND_NFC_BCH_T + 1U];
+    uint16_t u16D;
+    uint16_t u16Bd = 1U;
+    uint16_t u16Sum;
+    uint32_t u32L = 0UL;
+    uint32_t u32M = 1UL;
+    uint32_t u32N;
+    uint32_t u32Bits = u32Len * 8UL + BCH_PARITY_BITS;
+    uint32_t u32Idx;
+    uint32_t u32Roots = 0UL;
+    uint32_t i;
+
+    /* Berlekamp-Massey: error locator C(x) from S1..S2t */
+    for (u32N = 0UL; u32N < 2UL * NAND_NFC_BCH_T; u32N++) {
+        u16D = au16Synd[u32N];
+
+        for (i = 1UL; i <= u32L; i++) {
+            u16D ^= GF_Mul(au16C[i], au16Synd[u32N - i]);
+        }
+
+        if (0U == u16D) {
+            u32M++;
+            continue;
+        }
+
+        (void)memcpy(au16T, au16C, sizeof(au16T));
+        u16Sum = GF_Mul(u16D, GF_Pow(u16Bd, GF_ORDER - 1UL));
+
+        for (i = 0UL; (i + u32M) <= (2UL * NAND_NFC_BCH_T); i++) {
+            au16C[i + u32M] ^= GF_Mul(u16Sum, au16B[i]);
+        }
+
+        if ((2UL * u32L) <= u32N) {
+            u32L = u32N + 1UL - u32L;
+            (void)memcpy(au16B, au16T, sizeof(au16B));
+            u16Bd = u16D;
+            u32M = 1UL;
+        } else {
+            u32M++;
+        }
+    }
+
+    if (0UL == u32L) {
+        return 0;
+    }
+
+    if (u32L > NAND_NFC_BCH_T) {
+        return FTL_ERR_ECC;
+    }
+
+    /* Chien search: C(alpha^-j) == 0 means bit j of the codeword is wrong */
+    for (i = 0UL; i <= u32L; i++) {
+        au16Term[i] = au16C[i];
+        au16Step[i] = GF_Pow(2U, GF_ORDER - i);
+    }
+
+    for (u32N = 0UL; (u32N < u32Bits) && (u32Roots < u32L); u32N++) {
+        u16Sum = 0U;
+
+        for (i = 0UL; i <= u32L; i++) {
+            u16Sum ^= au16Term[i];
+            au16Term[i] = GF_Mul(au16Term[i], au16Step[i]);
+        }
+
+        if (0U == u16Sum) {
+            u32Roots++;
+
+            if (u32N >= BCH_PARITY_BITS) {
+                u32Idx = u32Bits - 1UL - u32N;
+                pu8Data[u32Idx / 8UL] ^= (uint8_t)(1U << (u32Idx % 8UL));
+            }
+        }
+    }
+
+    return (u32Roots == u32L) ? (int32_t)u32L : FTL_ERR_ECC;
+}
+
+/**
+ * @brief  An erased page fails ECC; accept it as erased if only a few bits are 0.
+ */
+static uint32_t NAND_NFC_IsErased(uint8_t *pu8Buf, uint32_t *pu32BitFlips) {
+    uint32_t u32Zeros = 0UL;
+    uint32_t i;
+    uint8_t u8Byte;
+
+    for (i = 0UL; i < NAND_NFC_BUF_SIZE; i++) {
+        for (u8Byte = (uint8_t)~pu8Buf[i]; 0U != u8Byte; u8Byte &= (uint8_t)(u8Byte - 1U)) {
+            if (++u32Zeros > NAND_NFC_BCH_T) {
+                return 0UL;
+            }
+        }
+    }
+
+    (void)memset(pu8Buf, 0xFF, NAND_NFC_BUF_SIZE);
+    *pu32BitFlips = u32Zeros;
+
+    return 1UL;
+}
+
+static int32_t NAND_NFC_Read(uint32_t u32Page, uint8_t *pu8Buf, uint32_t *pu32BitFlips) {
+    uint16_t au16Synd[2U * NAND_NFC_BCH_T];
+    uint32_t u32ErrSec;
+    uint32_t u32Len;
+    uint32_t i;
+    int32_t i32Bits;
+
+    *pu32BitFlips = 0UL;
+
+    if (LL_OK != EXMC_NFC_ReadPageHwEcc(m_u32Bank, m_u32FirstPage + u32Page, pu8Buf, NAND_NFC_BUF_SIZE, NAND_NFC_TIMEOUT)) {
+        return FTL_ERR;
+    }
+
+    if (RESET == EXMC_NFC_GetStatus(EXMC_NFC_FLAG_ECC_ERR)) {
+        return FTL_OK;
+    }
+
+    u32ErrSec = READ_REG32(CM_NFC->ECC_STAT) & NFC_ECC_STAT_ERRSEC;
+    EXMC_NFC_ClearStatus(EXMC_NFC_FLAG_ECC_ERR);
+
+    if (0UL != NAND_NFC_IsErased(pu8Buf, pu32BitFlips)) {
+        return FTL_OK;
+    }
+
+    for (i = 0UL; i < NAND_NFC_SECTIONS; i++) {
+        if (0UL == (u32ErrSec & (1UL << i))) {
+            continue;
+        }
+
+        u32Len = (i == (NAND_NFC_SECTIONS - 1UL)) ? (NAND_NFC_SECTION_SIZE + FTL_SPARE_SIZE) : NAND_NFC_SECTION_SIZE;
+        (void)EXMC_NFC_GetSyndrome(i, au16Synd, (uint8_t)(2U * NAND_NFC_BCH_T));
+        i32Bits = NAND_NFC_BchCorrect(&pu8Buf[i * NAND_NFC_SECTION_SIZE], u32Len, au16Synd);
+
+        if (i32Bits < 0) {
+            return FTL_ERR_ECC;
+        }
+
+        *pu32BitFlips += (uint32_t)i32Bits;
+    }
+
+    return FTL_OK;
+}
+
+static int32_t NAND_NFC_Program(uint32_t u32Page, const uint8_t *pu8Buf) {
+    if (LL_OK != EXMC_NFC_WritePageHwEcc(m_u32Bank, m_u32FirstPage + u32Page, pu8Buf, NAND_NFC_BUF_SIZE, NAND_NFC_TIMEOUT)) {
+        return FTL_ERR;
+    }
+
+    return (0UL != (EXMC_NFC_ReadStatus(m_u32Bank) & NAND_NFC_STATUS_FAIL)) ? FTL_ERR : FTL_OK;
+}
+
+static int32_t NAND_NFC_Erase(uint32_t u32Block) {
+    if (LL_OK != EXMC_NFC_EraseBlock(m_u32Bank, m_u32FirstPage + u32Block * FTL_PAGES_PER_BLOCK, NAND_NFC_TIMEOUT)) {
+        return FTL_ERR;
+    }
+
+    return (0UL != (EXMC_NFC_ReadStatus(m_u32Bank) & NAND_NFC_STATUS_FAIL)) ? FTL_ERR : FTL_OK;
+}
+
+static int32_t NAND_NFC_IsBad(uint32_t u32Block) {
+    const uint8_t *pu8Mark = (const uint8_t *)&m_au32Raw[FTL_PAGE_SIZE / 4UL];
+    uint32_t i;
+
+    for (i = 0UL; i < 2UL; i++) {
+        if ((LL_OK != EXMC_NFC_ReadPageMeta(m_u32Bank, m_u32FirstPage + u32Block * FTL_PAGES_PER_BLOCK + i,
+                                            (uint8_t *)m_au32Raw, sizeof(m_au32Raw), NAND_NFC_TIMEOUT)) ||
+                (0xFFU != pu8Mark[0])) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static int32_t NAND_NFC_MarkBad(uint32_t u32Block) {
+    const uint32_t u32Page = m_u32FirstPage + u32Block * FTL_PAGES_PER_BLOCK;
+
+    (void)EXMC_NFC_EraseBlock(m_u32Bank, u32Page, NAND_NFC_TIMEOUT);
+    (void)memset(m_au32Raw, 0, sizeof(m_au32Raw));
+
+    return EXMC_NFC_WritePageMeta(m_u32Bank, u32Page, (const uint8_t *)m_au32Raw, sizeof(m_au32Raw), NAND_NFC_TIMEOUT);
+}
+
+static const stc_ftl_nand_ops_t m_stcNandNfcOps = {
+    NAND_NFC_Read,
+    NAND_NFC_Program,
+    NAND_NFC_Erase,
+    NAND_NFC_IsBad,
+    NAND_NFC_MarkBad,
+};
+
+/**
+ * @brief  Select the NAND area of the FTL and set the NFC ECC layout it needs.
+ * @param  [in] u32Bank             @ref EXMC_NFC_Bank
+ * @param  [in] u32FirstBlock       First NAND block of the FTL area
+ * @retval int32_t:
+ *           - LL_OK:               Done.
+ *           - LL_ERR_INVD_PARAM:   The NFC page size is not FTL_PAGE_SIZE.
+ * @note   EXMC_NFC_Init() must have run; this sets 4-bit ECC and FTL_SPARE_SIZE spare bytes.
+ */
+int32_t NAND_NFC_Init(uint32_t u32Bank, uint32_t u32FirstBlock) {
+    if ((1024UL << (READ_REG32_BIT(CM_NFC->BACR, NFC_BACR_PAGE) >> NFC_BACR_PAGE_POS)) != FTL_PAGE_SIZE) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    m_u32Bank = u32Bank;
+    m_u32FirstPage = u32FirstBlock * FTL_PAGES_PER_BLOCK;
+    EXMC_NFC_SetEccMode(EXMC_NFC_4BIT_ECC);
+    EXMC_NFC_SetSpareAreaSize((uint8_t)(FTL_SPARE_SIZE / 4UL));
+
+    return LL_OK;
+}
+
+/**
+ * @brief  Page operations to pass to FTL_Mount()/FTL_Format().
+ */
+const stc_ftl_nand_ops_t *NAND_NFC_GetOps(void) {
+    return &m_stcNandNfcOps;
+}
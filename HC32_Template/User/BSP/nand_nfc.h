@@ -0,0 +1,35 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : nand_nfc.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : EXMC NFC page operations for the NAND FTL, with 4-bit BCH correction
+  *				   from the NFC syndromes
+  * Function List:
+  *		NAND_NFC_Init
+  *		NAND_NFC_GetOps
+  *		NAND_NFC_BchCorrect
+  ******************************************************
+**/
+
+#ifndef __NAND_NFC_H_
+#define __NAND_NFC_H_
+
+#include "hc32_ll.h"
+#include "nand_ftl.h"
+
+#define NAND_NFC_SECTION_SIZE       (EXMC_NFC_ECC_CALCULATE_BLOCK_BYTE)
+#define NAND_NFC_BCH_T              (4U)        /*!< Correctable bits per section */
+
+int32_t NAND_NFC_Init(uint32_t u32Bank, uint32_t u32FirstBlock);
+const stc_ftl_nand_ops_t *NAND_NFC_GetOps(void);
+int32_t NAND_NFC_BchCorrect(uint8_t *pu8Data, uint32_t u32Len, const uint16_t au16Synd[]);
+
+#endif
@@ -0,0 +1,364 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : qspi_xip.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					Code fetched through the QSPI ROM window costs instruction + address +
+					dummy + data clocks per access. This module sets up the cheapest read the
+					flash accepts:
+					  - 1-4-4 fast read puts the address on four lines as well;
+					  - the XIP mode code (0x20 on W25Q) keeps the flash in continuous read,
+					    so later accesses skip the 8-clock instruction;
+					  - prefetch keeps reading ahead while the CPU consumes sequential code.
+					One dummy cycle too many or too few shifts every byte, so rather than
+					trusting a datasheet table the dummy count is found by comparing against
+					a slow 1-1-1 0x0B reference read. The HC32 QSPI has no DTR mode.
+					The profiler times registered functions with the DWT cycle counter; the
+					report sorts them by total time and lists the ones running from QSPI that
+					are worth moving to SRAM, written as scatter-file lines. A snapshot keeps
+					the previous averages so the report shows the speed-up after a change.
+  * Function List:
+  *		XIP_StructInit
+  *		XIP_Init
+  *		XIP_Calibrate
+  *		XIP_Measure
+  *		XIP_Prof_Init
+  *		XIP_Prof_Add
+  *		XIP_Prof_Record
+  *		XIP_Prof_Snapshot
+  *		XIP_Prof_Report
+  **********************************************************
+ */
+
+#include "qspi_xip.h"
+#include <stdio.h>
+
+#define XIP_SIZE                    (QSPI_ROM_END - QSPI_ROM_BASE + 1UL)
+#define XIP_CAL_MAX                 (256U)          /* Bytes compared by the calibration */
+#define XIP_REF_CLK_DIV             (QSPI_CLK_DIV8) /* Slow enough for any 0x0B read */
+#define XIP_DUMMY_MIN               (3U)
+#define XIP_DUMMY_MAX               (18U)
+#define XIP_HOT_PERCENT             (90UL)          /* Share of QSPI time covered by the SRAM list */
+
+#define XIP_DUMMY(n)                ((uint32_t)((n) - XIP_DUMMY_MIN) << QSPI_FCR_DMCYCN_POS)
+
+static stc_xip_init_t m_stcXip;
+static stc_xip_prof_entry_t m_astcProf[XIP_PROF_MAX];
+static uint8_t m_u8ProfCount = 0U;
+
+/**
+ * @brief  Take the flash out of continuous read: send 0xFF on one line in direct mode.
+ */
+static void XIP_ModeReset(void) {
+    QSPI_XipModeCmd(XIP_MD_CODE_NONE, DISABLE);
+    QSPI_EnterDirectCommMode();
+    QSPI_WriteDirectCommValue(0xFFU);
+    QSPI_ExitDirectCommMode();
+}
+
+/**
+ * @brief  Switch the ROM window to the given read.
+ */
+static void XIP_Map(uint32_t u32ReadMode, uint8_t u8Dummy, uint32_t u32ClockDiv,
+                    uint32_t u32Prefetch, uint8_t u8ModeCode) {
+    stc_qspi_init_t stcQspiInit;
+
+    /* Leave XIP with a non-continuous mode code, which the next access sends */
+    if (READ_REG32_BIT(CM_QSPI->CR, QSPI_CR_XIPE) != 0UL) {
+        QSPI_XipModeCmd(XIP_MD_CODE_NONE, DISABLE);
+        (void)*(__IO uint8_t *)XIP_BASE;
+    }
+
+    (void)QSPI_StructInit(&stcQspiInit);
+    stcQspiInit.u32ClockDiv = u32ClockDiv;
+    stcQspiInit.u32PrefetchMode = u32Prefetch;
+    stcQspiInit.u32ReadMode = u32ReadMode;
+    stcQspiInit.u32DummyCycle = XIP_DUMMY(u8Dummy);
+    stcQspiInit.u32AddrWidth = m_stcXip.u32AddrWidth;
+    stcQspiInit.u32SetupTime = QSPI_QSSN_SETUP_ADVANCE_QSCK1P5;
+    stcQspiInit.u32ReleaseTime = QSPI_QSSN_RELEASE_DELAY_QSCK1P5;
+    stcQspiInit.u32IntervalTime = QSPI_QSSN_INTERVAL_QSCK2;
+    (void)QSPI_Init(&stcQspiInit);
+
+    if ((u8ModeCode != XIP_MD_CODE_NONE) && (u32ReadMode == XIP_RD_MD_QUAD_IO)) {
+        QSPI_XipModeCmd(u8ModeCode, ENABLE);
+    }
+}
+
+static void XIP_Read(uint32_t u32Offset, uint8_t *pu8Buf, uint32_t u32Size) {
+    const __IO uint8_t *pu8Src = (const __IO uint8_t *)(XIP_BASE + u32Offset);
+    uint32_t i;
+
+    for (i = 0UL; i < u32Size; i++) {
+        pu8Buf[i] = pu8Src[i];
+    }
+}
+
+static void XIP_DwtEnable(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+ * @brief  Fill the XIP configuration with defaults: 1-4-4, continuous read, calibrated dummy.
+ * @param  [in] pstcXipInit             XIP configuration.
+ * @retval int32_t:
+ *           - LL_OK:                   No errors occurred.
+ *           - LL_ERR_INVD_PARAM:       pstcXipInit == NULL.
+ */
+int32_t XIP_StructInit(stc_xip_init_t *pstcXipInit) {
+    if (pstcXipInit == NULL) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    pstcXipInit->u32ClockDiv = QSPI_CLK_DIV2;
+    pstcXipInit->u32ReadMode = XIP_RD_MD_QUAD_IO;
+    pstcXipInit->u32AddrWidth = QSPI_ADDR_WIDTH_24BIT;
+    pstcXipInit->u32PrefetchMode = QSPI_PREFETCH_MD_EDGE_STOP;
+    pstcXipInit->u8DummyCycle = XIP_DUMMY_AUTO;
+    pstcXipInit->u8ModeCode = 0x20U;
+
+    return LL_OK;
+}
+
+/**
+ * @brief  Configure the QSPI ROM window for XIP.
+ * @param  [in] pstcXipInit             XIP configuration.
+ * @retval int32_t:
+ *           - LL_OK:                   No errors occurred.
+ *           - LL_ERR_INVD_PARAM:       Parameter error.
+ *           - LL_ERR:                  Calibration failed, see XIP_Calibrate().
+ * @note   The QSPI pins and the flash QE bit must be set up by the caller.
+ */
+int32_t XIP_Init(const stc_xip_init_t *pstcXipInit) {
+    if ((pstcXipInit == NULL) ||
+            ((pstcXipInit->u8DummyCycle != XIP_DUMMY_AUTO) &&
+             ((pstcXipInit->u8DummyCycle < XIP_DUMMY_MIN) || (pstcXipInit->u8DummyCycle > XIP_DUMMY_MAX)))) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    m_stcXip = *pstcXipInit;
+
+    FCG_Fcg1PeriphClockCmd(FCG1_PERIPH_QSPI, ENABLE);
+
+    /* A warm reset may leave the flash in continuous read */
+    XIP_ModeReset();
+
+    if (m_stcXip.u8DummyCycle == XIP_DUMMY_AUTO) {
+        return XIP_Calibrate(0UL, XIP_CAL_MAX);
+    }
+
+    XIP_Map(m_stcXip.u32ReadMode, m_stcXip.u8DummyCycle, m_stcXip.u32ClockDiv,
+            m_stcXip.u32PrefetchMode, m_stcXip.u8ModeCode);
+
+    return LL_OK;
+}
+
+/**
+ * @brief  Find the dummy cycles that read the same data as a slow 1-1-1 reference read.
+ * @param  [in] u32Offset               Flash offset of the reference data; must not be uniform (use code).
+ * @param  [in] u32Size                 Bytes to compare, up to 256.
+ * @retval int32_t:
+ *           - LL_OK:                   Calibrated, the ROM window uses the configured read.
+ *           - LL_ERR_INVD_PARAM:       Reference data is uniform (e.g. erased).
+ *           - LL_ERR:                  No dummy count works, the window is left on the reference read.
+ * @note   Must not run from QSPI.
+ */
+int32_t XIP_Calibrate(uint32_t u32Offset, uint32_t u32Size) {
+    uint8_t au8Ref[XIP_CAL_MAX];
+    uint8_t au8Buf[XIP_CAL_MAX];
+    uint8_t u8Dummy;
+    uint32_t i;
+
+    if ((u32Size == 0UL) || (u32Size > XIP_CAL_MAX)) {
+        u32Size = XIP_CAL_MAX;
+    }
+
+    /* Prefetch off so every read really goes to the flash */
+    XIP_Map(XIP_RD_MD_FAST, 8U, XIP_REF_CLK_DIV, QSPI_PREFETCH_MD_INVD, XIP_MD_CODE_NONE);
+    XIP_Read(u32Offset, au8Ref, u32Size);
+
+    for (i = 1UL; (i < u32Size) && (au8Ref[i] == au8Ref[0]); i++) {
+    }
+
+    if (i == u32Size) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    for (u8Dummy = XIP_DUMMY_MIN; u8Dummy <= XIP_DUMMY_MAX; u8Dummy++) {
+        XIP_Map(m_stcXip.u32ReadMode, u8Dummy, m_stcXip.u32ClockDiv, QSPI_PREFETCH_MD_INVD, XIP_MD_CODE_NONE);
+        XIP_Read(u32Offset, au8Buf, u32Size);
+
+        for (i = 0UL; (i < u32Size) && (au8Buf[i] == au8Ref[i]); i++) {
+        }
+
+        if (i == u32Size) {
+            m_stcXip.u8DummyCycle = u8Dummy;
+            XIP_Map(m_stcXip.u32ReadMode, u8Dummy, m_stcXip.u32ClockDiv,
+                    m_stcXip.u32PrefetchMode, m_stcXip.u8ModeCode);
+            return LL_OK;
+        }
+    }
+
+    /* Fall back to the reference read so constants in QSPI stay readable */
+    XIP_Map(XIP_RD_MD_FAST, 8U, XIP_REF_CLK_DIV, m_stcXip.u32PrefetchMode, XIP_MD_CODE_NONE);
+
+    return LL_ERR;
+}
+
+/**
+ * @brief  CPU cycles taken to read u32Size bytes sequentially from the ROM window.
+ */
+uint32_t XIP_Measure(uint32_t u32Offset, uint32_t u32Size) {
+    const __IO uint32_t *pu32Src = (const __IO uint32_t *)(XIP_BASE + (u32Offset & ~3UL));
+    uint32_t u32Start;
+    uint32_t i;
+
+    XIP_DwtEnable();
+    u32Start = DWT->CYCCNT;
+
+    for (i = 0UL; i < (u32Size / 4UL); i++) {
+        (void)pu32Src[i];
+    }
+
+    return DWT->CYCCNT - u32Start;
+}
+
+/**
+ * @brief  Start the DWT cycle counter and clear the profile table.
+ */
+void XIP_Prof_Init(void) {
+    XIP_DwtEnable();
+    m_u8ProfCount = 0U;
+}
+
+/**
+ * @brief  Register a profiled function.
+ * @param  [in] pcName                  Function name, used in the report and the scatter lines.
+ * @param  [in] pvFunc                  Function address.
+ * @retval Entry id, 0xFF when the table is full.
+ */
+uint8_t XIP_Prof_Add(const char *pcName, const void *pvFunc) {
+    stc_xip_prof_entry_t *pstcEntry;
+
+    if (m_u8ProfCount >= XIP_PROF_MAX) {
+        return 0xFFU;
+    }
+
+    pstcEntry = &m_astcProf[m_u8ProfCount];
+    pstcEntry->pcName = pcName;
+    pstcEntry->u32Addr = (uint32_t)pvFunc & ~1UL;
+    pstcEntry->u32Calls = 0UL;
+    pstcEntry->u32Cycles = 0UL;
+    pstcEntry->u32Max = 0UL;
+    pstcEntry->u32Base = 0UL;
+
+    return m_u8ProfCount++;
+}
+
+void XIP_Prof_Record(uint8_t u8Id, uint32_t u32Cycles) {
+    stc_xip_prof_entry_t *pstcEntry;
+
+    if (u8Id >= m_u8ProfCount) {
+        return;
+    }
+
+    pstcEntry = &m_astcProf[u8Id];
+    pstcEntry->u32Calls++;
+    pstcEntry->u32Cycles += u32Cycles;
+
+    if (u32Cycles > pstcEntry->u32Max) {
+        pstcEntry->u32Max = u32Cycles;
+    }
+}
+
+/**
+ * @brief  Keep the current averages as the baseline and restart counting.
+ */
+void XIP_Prof_Snapshot(void) {
+    uint8_t i;
+
+    for (i = 0U; i < m_u8ProfCount; i++) {
+        m_astcProf[i].u32Base = (m_astcProf[i].u32Calls != 0UL) ?
+                                (m_astcProf[i].u32Cycles / m_astcProf[i].u32Calls) : 0UL;
+        m_astcProf[i].u32Calls = 0UL;
+        m_astcProf[i].u32Cycles = 0UL;
+        m_astcProf[i].u32Max = 0UL;
+    }
+}
+
+/**
+ * @brief  Print the functions sorted by total time with the speed-up (x100) against the
+ *         snapshot, then the QSPI-resident ones covering most of the time as scatter lines.
+ */
+void XIP_Prof_Report(void) {
+    uint8_t au8Order[XIP_PROF_MAX];
+    uint32_t u32Total = 0UL;
+    uint32_t u32Sum = 0UL;
+    uint32_t u32Avg;
+    uint8_t i, j, u8Tmp;
+    const stc_xip_prof_entry_t *pstcEntry;
+
+    for (i = 0U; i < m_u8ProfCount; i++) {
+        au8Order[i] = i;
+    }
+
+    for (i = 1U; i < m_u8ProfCount; i++) {
+        u8Tmp = au8Order[i];
+
+        for (j = i; (j > 0U) && (m_astcProf[au8Order[j - 1U]].u32Cycles < m_astcProf[u8Tmp].u32Cycles); j--) {
+            au8Order[j] = au8Order[j - 1U];
+        }
+
+        au8Order[j] = u8Tmp;
+    }
+
+    printf("XIP %s, dummy %u, mode code 0x%02X\r\n",
+           (m_stcXip.u32ReadMode == XIP_RD_MD_QUAD_IO) ? "1-4-4" :
+           (m_stcXip.u32ReadMode == XIP_RD_MD_QUAD_OUTPUT) ? "1-1-4" : "1-1-1",
+           m_stcXip.u8DummyCycle, m_stcXip.u8ModeCode);
+    printf("%-20s %-10s %8s %10s %8s %8s %8s\r\n", "function", "addr", "calls", "cycles", "avg", "base", "x100");
+
+    for (i = 0U; i < m_u8ProfCount; i++) {
+        pstcEntry = &m_astcProf[au8Order[i]];
+        u32Avg = (pstcEntry->u32Calls != 0UL) ? (pstcEntry->u32Cycles / pstcEntry->u32Calls) : 0UL;
+        printf("%-20s 0x%08X %8u %10u %8u %8u %8u\r\n", pstcEntry->pcName, pstcEntry->u32Addr,
+               pstcEntry->u32Calls, pstcEntry->u32Cycles, u32Avg, pstcEntry->u32Base,
+               ((u32Avg != 0UL) && (pstcEntry->u32Base != 0UL)) ? (pstcEntry->u32Base * 100U / u32Avg) : 0U);
+
+        if ((pstcEntry->u32Addr - XIP_BASE) < XIP_SIZE) {
+            u32Total += pstcEntry->u32Cycles;
+        }
+    }
+
+    if (u32Total == 0UL) {
+        return;
+    }
+
+    printf("move to RAM (scatter file, RAM execution region):\r\n");
+
+    for (i = 0U; (i < m_u8ProfCount) && ((uint64_t)u32Sum * 100UL < (uint64_t)u32Total * XIP_HOT_PERCENT); i++) {
+        pstcEntry = &m_astcProf[au8Order[i]];
+
+        if (((pstcEntry->u32Addr - XIP_BASE) >= XIP_SIZE) || (pstcEntry->u32Cycles == 0UL)) {
+            continue;
+        }
+
+        u32Sum += pstcEntry->u32Cycles;
+#if defined(__ARMCC_VERSION) && (__ARMCC_VERSION >= 6010050)
+        printf("    *.o (.text.%s)\r\n", pstcEntry->pcName);
+#else
+        printf("    *.o (i.%s)\r\n", pstcEntry->pcName);
+#endif
+    }
+}
@@ -0,0 +1,104 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : qspi_xip.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : QSPI ROM-mode (XIP) setup with dummy-cycle calibration, plus DWT based
+  *				   per-function profiling that tells which functions to run from SRAM
+  * Function List:
+  *		XIP_StructInit
+  *		XIP_Init
+  *		XIP_Calibrate
+  *		XIP_Measure
+  *		XIP_Prof_Init
+  *		XIP_Prof_Add
+  *		XIP_Prof_Record
+  *		XIP_Prof_Snapshot
+  *		XIP_Prof_Report
+  ******************************************************
+**/
+
+#ifndef __QSPI_XIP_H_
+#define __QSPI_XIP_H_
+
+#include "hc32_ll.h"
+
+#define XIP_BASE                    (QSPI_ROM_BASE)
+
+/**
+ * @defgroup QSPI_XIP_Read_Mode XIP Read Mode
+ * @note  Instruction codes follow the W25Q/GD25Q families.
+ * @{
+ */
+#define XIP_RD_MD_FAST              (QSPI_RD_MD_FAST_RD)                /*!< 0x0B 1-1-1, reference read of the calibration */
+#define XIP_RD_MD_QUAD_OUTPUT       (QSPI_RD_MD_QUAD_OUTPUT_FAST_RD)    /*!< 0x6B 1-1-4 */
+#define XIP_RD_MD_QUAD_IO           (QSPI_RD_MD_QUAD_IO_FAST_RD)        /*!< 0xEB 1-4-4, mode byte counted in the dummy cycles */
+/**
+ * @}
+ */
+
+#define XIP_DUMMY_AUTO              (0xFFU)     /*!< Let XIP_Calibrate() find the dummy cycles */
+#define XIP_MD_CODE_NONE            (0xFFU)     /*!< No continuous read, the instruction is sent on every access */
+
+/**
+ * @brief Place a function in SRAM: mark it with XIP_RAMFUNC and put *(.ramfunc) into an SRAM
+ *        execution region of the scatter file; __main copies it from flash at start-up.
+ */
+#define XIP_RAMFUNC                 __attribute__((section(".ramfunc")))
+
+#define XIP_PROF_MAX                (32U)
+
+/**
+ * @brief XIP configuration.
+ */
+typedef struct {
+    uint32_t u32ClockDiv;           /*!< @ref QSPI_Clock_Division */
+    uint32_t u32ReadMode;           /*!< @ref QSPI_XIP_Read_Mode */
+    uint32_t u32AddrWidth;          /*!< @ref QSPI_Addr_Width */
+    uint32_t u32PrefetchMode;       /*!< @ref QSPI_Prefetch_Mode */
+    uint8_t  u8DummyCycle;          /*!< 3~18, or XIP_DUMMY_AUTO */
+    uint8_t  u8ModeCode;            /*!< Continuous read mode code (0x20 on W25Q), or XIP_MD_CODE_NONE */
+} stc_xip_init_t;
+
+/**
+ * @brief Profiled function.
+ */
+typedef struct {
+    const char *pcName;
+    uint32_t u32Addr;               /*!< Function address, tells whether it runs from QSPI */
+    uint32_t u32Calls;
+    uint32_t u32Cycles;             /*!< Accumulated CPU cycles */
+    uint32_t u32Max;                /*!< Longest single call */
+    uint32_t u32Base;               /*!< Average cycles at the last snapshot, 0 when none */
+} stc_xip_prof_entry_t;
+
+int32_t XIP_StructInit(stc_xip_init_t *pstcXipInit);
+int32_t XIP_Init(const stc_xip_init_t *pstcXipInit);
+int32_t XIP_Calibrate(uint32_t u32Offset, uint32_t u32Size);
+uint32_t XIP_Measure(uint32_t u32Offset, uint32_t u32Size);
+
+void XIP_Prof_Init(void);
+uint8_t XIP_Prof_Add(const char *pcName, const void *pvFunc);
+void XIP_Prof_Record(uint8_t u8Id, uint32_t u32Cycles);
+void XIP_Prof_Snapshot(void);
+void XIP_Prof_Report(void);
+
+/**
+ * @brief  Start timing a profiled section: u32T = XIP_Prof_Begin(); ... XIP_Prof_End(u8Id, u32T);
+ */
+__STATIC_INLINE uint32_t XIP_Prof_Begin(void) {
+    return DWT->CYCCNT;
+}
+
+__STATIC_INLINE void XIP_Prof_End(uint8_t u8Id, uint32_t u32Start) {
+    XIP_Prof_Record(u8Id, DWT->CYCCNT - u32Start);
+}
+
+#endif
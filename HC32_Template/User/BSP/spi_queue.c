@@ -0,0 +1,370 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : spi_queue.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					SPI_TransReceive/SPI_Trans write one frame and spin on SPI_FLAG_RX_BUF_FULL
+					(or TX_BUF_EMPTY) for every frame. Here each segment is moved by two DMA
+					channels triggered by the SPI itself: SPTI feeds DR from the Tx buffer (or
+					a fixed 0xFF), SPRI drains DR into the Rx buffer (or a fixed sink). Enabling
+					the SPI raises the first SPTI, so a segment starts with SPI_Cmd and ends
+					with the Rx channel's TC interrupt, i.e. when the last frame has been
+					clocked in. SPIQ_IrqHandler then starts the next segment of the same
+					transaction, or releases the chip select, switches CFG2 to the mode, baud
+					rate and width of the next queued device and asserts its chip select.
+					The SPI must be set up by the caller with SPI_Init as master, full duplex,
+					3-wire (SS pins unused) and SPI_1_FRAME.
+  * Function List:
+  *		SPIQ_Init
+  *		SPIQ_DevInit
+  *		SPIQ_Submit
+  *		SPIQ_IsBusy
+  *		SPIQ_IrqHandler
+  *		SPIQ_GetStats
+  **********************************************************
+ */
+
+#include "spi_queue.h"
+#include <string.h>
+
+#define SPIQ_CFG2_MASK              (SPI_CFG2_CPHA | SPI_CFG2_CPOL | SPI_CFG2_MBR | SPI_CFG2_DSIZE)
+#define SPIQ_CFG2_NONE              (0xFFFFFFFFUL)
+
+/* The AOS driver is not part of this library copy, the trigger selections are written directly */
+#define SPIQ_SET_TRIGGER(reg, src)  MODIFY_REG32((reg), AOS_DMA_TRGSELRC_TRGSEL, (uint32_t)(src))
+
+/* Source of the frames of a segment without Tx buffer, and sink of a segment without Rx buffer */
+static const uint16_t u16SpiqDummyTx = 0xFFFFU;
+static uint16_t u16SpiqSink;
+
+/**
+ * @brief  Rx/Tx request events of an SPI unit.
+ */
+static int32_t SPIQ_GetEvent(const CM_SPI_TypeDef *SPIx, en_event_src_t *penRx, en_event_src_t *penTx) {
+    if (SPIx == CM_SPI1) {
+        *penRx = EVT_SRC_SPI1_SPRI;
+        *penTx = EVT_SRC_SPI1_SPTI;
+    } else if (SPIx == CM_SPI2) {
+        *penRx = EVT_SRC_SPI2_SPRI;
+        *penTx = EVT_SRC_SPI2_SPTI;
+    } else if (SPIx == CM_SPI3) {
+        *penRx = EVT_SRC_SPI3_SPRI;
+        *penTx = EVT_SRC_SPI3_SPTI;
+    } else if (SPIx == CM_SPI4) {
+        *penRx = EVT_SRC_SPI4_SPRI;
+        *penTx = EVT_SRC_SPI4_SPTI;
+    } else if (SPIx == CM_SPI5) {
+        *penRx = EVT_SRC_SPI5_SPRI;
+        *penTx = EVT_SRC_SPI5_SPTI;
+    } else if (SPIx == CM_SPI6) {
+        *penRx = EVT_SRC_SPI6_SPRI;
+        *penTx = EVT_SRC_SPI6_SPTI;
+    } else {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    return LL_OK;
+}
+
+/**
+ * @brief  Start segment u16SegIdx of the running transaction; the chip select is already active.
+ */
+static void SPIQ_StartSeg(stc_spiq_bus_t *pstcBus) {
+    const stc_spiq_trans_t *pstcTrans = pstcBus->pstcHead;
+    const stc_spiq_seg_t *pstcSeg = &pstcTrans->pstcSeg[pstcTrans->u16SegIdx];
+    CM_DMA_TypeDef *DMAx = pstcBus->DMAx;
+    uint32_t u32DR = (uint32_t)&pstcBus->SPIx->DR;
+    stc_dma_init_t stcInit;
+
+    SPI_Cmd(pstcBus->SPIx, DISABLE);
+    DMA_ClearTransCompleteStatus(DMAx, ((DMA_FLAG_TC_CH0 | DMA_FLAG_BTC_CH0) << pstcBus->u8RxCh) |
+                                       ((DMA_FLAG_TC_CH0 | DMA_FLAG_BTC_CH0) << pstcBus->u8TxCh));
+
+    stcInit.u32DataWidth = (pstcTrans->pstcDev->u32DataWidth == SPI_DATA_SIZE_16BIT) ? DMA_DATAWIDTH_16BIT :
+                                                                                     DMA_DATAWIDTH_8BIT;
+    stcInit.u32BlockSize = 1UL;
+    stcInit.u32TransCount = pstcSeg->u32Len;
+
+    /* Rx first: it must be waiting before the first frame comes in */
+    stcInit.u32IntEn = DMA_INT_ENABLE;
+    stcInit.u32SrcAddr = u32DR;
+    stcInit.u32SrcAddrInc = DMA_SRC_ADDR_FIX;
+    stcInit.u32DestAddr = (pstcSeg->pvRx != NULL) ? (uint32_t)pstcSeg->pvRx : (uint32_t)&u16SpiqSink;
+    stcInit.u32DestAddrInc = (pstcSeg->pvRx != NULL) ? DMA_DEST_ADDR_INC : DMA_DEST_ADDR_FIX;
+    (void)DMA_Init(DMAx, pstcBus->u8RxCh, &stcInit);
+
+    stcInit.u32IntEn = DMA_INT_DISABLE;
+    stcInit.u32SrcAddr = (pstcSeg->pvTx != NULL) ? (uint32_t)pstcSeg->pvTx : (uint32_t)&u16SpiqDummyTx;
+    stcInit.u32SrcAddrInc = (pstcSeg->pvTx != NULL) ? DMA_SRC_ADDR_INC : DMA_SRC_ADDR_FIX;
+    stcInit.u32DestAddr = u32DR;
+    stcInit.u32DestAddrInc = DMA_DEST_ADDR_FIX;
+    (void)DMA_Init(DMAx, pstcBus->u8TxCh, &stcInit);
+
+    (void)DMA_ChCmd(DMAx, pstcBus->u8RxCh, ENABLE);
+    (void)DMA_ChCmd(DMAx, pstcBus->u8TxCh, ENABLE);
+
+    pstcBus->stcStats.u32Segments++;
+
+    /* Tx buffer is empty: enabling the SPI raises SPTI and the Tx channel moves the first frame */
+    SPI_Cmd(pstcBus->SPIx, ENABLE);
+}
+
+/**
+ * @brief  Switch to the device of the transaction at the head of the queue and start its first segment.
+ */
+static void SPIQ_StartTrans(stc_spiq_bus_t *pstcBus) {
+    stc_spiq_trans_t *pstcTrans = pstcBus->pstcHead;
+    const stc_spiq_dev_t *pstcDev = pstcTrans->pstcDev;
+    uint32_t u32Cfg2 = pstcDev->u32Mode | pstcDev->u32BaudRatePrescaler | pstcDev->u32DataWidth;
+
+    /* CFG2 may only change while the SPI is disabled; it is disabled between segments anyway */
+    if (u32Cfg2 != pstcBus->u32Cfg2) {
+        SPI_Cmd(pstcBus->SPIx, DISABLE);
+        MODIFY_REG32(pstcBus->SPIx->CFG2, SPIQ_CFG2_MASK, u32Cfg2);
+        pstcBus->u32Cfg2 = u32Cfg2;
+        pstcBus->stcStats.u32ModeSwitch++;
+    }
+
+    pstcTrans->u8State = SPIQ_STATE_ACTIVE;
+    pstcTrans->u16SegIdx = 0U;
+
+    pstcBus->u32Start = DWT->CYCCNT;
+    GPIO_ResetPins(pstcDev->u8CsPort, pstcDev->u16CsPin);
+
+    SPIQ_StartSeg(pstcBus);
+}
+
+/**
+ * @brief  End the running transaction, start the next queued one, then report the result.
+ */
+static void SPIQ_Finish(stc_spiq_bus_t *pstcBus, int32_t i32Result) {
+    stc_spiq_trans_t *pstcTrans = pstcBus->pstcHead;
+
+    GPIO_SetPins(pstcTrans->pstcDev->u8CsPort, pstcTrans->pstcDev->u16CsPin);
+    pstcBus->stcStats.u64BusyCycles += DWT->CYCCNT - pstcBus->u32Start;
+
+    if (i32Result == LL_OK) {
+        pstcBus->stcStats.u32Trans++;
+        pstcTrans->u8State = SPIQ_STATE_DONE;
+    } else {
+        pstcBus->stcStats.u32Errors++;
+        pstcTrans->u8State = SPIQ_STATE_ERROR;
+    }
+
+    pstcBus->pstcHead = pstcTrans->pstcNext;
+    pstcTrans->pstcNext = NULL;
+
+    if (pstcBus->pstcHead == NULL) {
+        pstcBus->pstcTail = NULL;
+    }
+
+    pstcBus->u32QueueLen--;
+
+    /* Keep the bus busy first; a transaction submitted from the callback queues behind */
+    if (pstcBus->pstcHead != NULL) {
+        SPIQ_StartTrans(pstcBus);
+    }
+
+    if (pstcTrans->pfnDone != NULL) {
+        pstcTrans->pfnDone(pstcTrans, i32Result);
+    }
+}
+
+/**
+ * @brief  Attach the queue to an SPI unit and two channels of one DMA unit.
+ * @param  [in] pstcBus                 Bus handle.
+ * @param  [in] SPIx                    SPI unit, already initialized by SPI_Init (see file description).
+ * @param  [in] DMAx                    CM_DMA1 or CM_DMA2.
+ * @param  [in] u8TxCh                  DMA channel feeding DR.
+ * @param  [in] u8RxCh                  DMA channel draining DR.
+ * @retval int32_t:
+ *           - LL_OK:                   No errors occurred.
+ *           - LL_ERR_INVD_PARAM:       Parameter error.
+ * @note   The caller registers SPIQ_IrqHandler for INT_SRC_DMAx_TC<u8RxCh> and INT_SRC_DMAx_ERR.
+ */
+int32_t SPIQ_Init(stc_spiq_bus_t *pstcBus, CM_SPI_TypeDef *SPIx, CM_DMA_TypeDef *DMAx, uint8_t u8TxCh, uint8_t u8RxCh) {
+    __IO uint32_t *TRGSELx;
+    en_event_src_t enRx;
+    en_event_src_t enTx;
+
+    if ((pstcBus == NULL) || ((DMAx != CM_DMA1) && (DMAx != CM_DMA2)) ||
+        (u8TxCh > DMA_CH7) || (u8RxCh > DMA_CH7) || (u8TxCh == u8RxCh)) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    if (SPIQ_GetEvent(SPIx, &enRx, &enTx) != LL_OK) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    FCG_Fcg0PeriphClockCmd(((DMAx == CM_DMA1) ? FCG0_PERIPH_DMA1 : FCG0_PERIPH_DMA2) | FCG0_PERIPH_AOS, ENABLE);
+
+    (void)memset(pstcBus, 0, sizeof(stc_spiq_bus_t));
+    pstcBus->SPIx = SPIx;
+    pstcBus->DMAx = DMAx;
+    pstcBus->u8TxCh = u8TxCh;
+    pstcBus->u8RxCh = u8RxCh;
+    pstcBus->u32Cfg2 = SPIQ_CFG2_NONE;
+
+    SPI_Cmd(SPIx, DISABLE);
+    (void)DMA_ChCmd(DMAx, u8TxCh, DISABLE);
+    (void)DMA_ChCmd(DMAx, u8RxCh, DISABLE);
+
+    TRGSELx = (DMAx == CM_DMA1) ? &CM_AOS->DMA1_TRGSEL0 : &CM_AOS->DMA2_TRGSEL0;
+    SPIQ_SET_TRIGGER(TRGSELx[u8TxCh], enTx);
+    SPIQ_SET_TRIGGER(TRGSELx[u8RxCh], enRx);
+
+    /* One frame per block: only the Rx channel's transfer-complete interrupt is used */
+    DMA_TransCompleteIntCmd(DMAx, (DMA_INT_BTC_CH0 << u8TxCh) | (DMA_INT_BTC_CH0 << u8RxCh) |
+                                  (DMA_INT_TC_CH0 << u8TxCh), DISABLE);
+    DMA_TransCompleteIntCmd(DMAx, DMA_INT_TC_CH0 << u8RxCh, ENABLE);
+    DMA_ErrIntCmd(DMAx, ((DMA_INT_TRANS_ERR_CH0 | DMA_INT_REQ_ERR_CH0) << u8TxCh) |
+                        ((DMA_INT_TRANS_ERR_CH0 | DMA_INT_REQ_ERR_CH0) << u8RxCh), ENABLE);
+    DMA_Cmd(DMAx, ENABLE);
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    return LL_OK;
+}
+
+/**
+ * @brief  Configure the chip select pin of a device as an output, inactive (high).
+ * @param  [in] pstcDev                 Device.
+ * @retval None
+ */
+void SPIQ_DevInit(const stc_spiq_dev_t *pstcDev) {
+    stc_gpio_init_t stcGpioInit;
+
+    (void)GPIO_StructInit(&stcGpioInit);
+    stcGpioInit.u16PinState = PIN_STAT_SET;
+    stcGpioInit.u16PinDir = PIN_DIR_OUT;
+    (void)GPIO_Init(pstcDev->u8CsPort, pstcDev->u16CsPin, &stcGpioInit);
+}
+
+/**
+ * @brief  Queue a transaction; it starts at once if the bus is idle.
+ * @param  [in] pstcBus                 Bus handle.
+ * @param  [in] pstcTrans               Transaction; it and its segments must stay valid until pfnDone.
+ * @retval int32_t:
+ *           - LL_OK:                   Started or queued.
+ *           - LL_ERR_INVD_PARAM:       No device/segments, a segment length out of range, or already queued.
+ * @note   May be called from the completion callback.
+ */
+int32_t SPIQ_Submit(stc_spiq_bus_t *pstcBus, stc_spiq_trans_t *pstcTrans) {
+    uint32_t u32Primask;
+    uint16_t i;
+
+    if ((pstcTrans == NULL) || (pstcTrans->pstcDev == NULL) || (pstcTrans->pstcSeg == NULL) ||
+        (pstcTrans->u16SegNum == 0U)) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    if ((pstcTrans->u8State == SPIQ_STATE_QUEUED) || (pstcTrans->u8State == SPIQ_STATE_ACTIVE)) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    for (i = 0U; i < pstcTrans->u16SegNum; i++) {
+        if ((pstcTrans->pstcSeg[i].u32Len == 0UL) || (pstcTrans->pstcSeg[i].u32Len > SPIQ_SEG_LEN_MAX)) {
+            return LL_ERR_INVD_PARAM;
+        }
+    }
+
+    pstcTrans->u8State = SPIQ_STATE_QUEUED;
+    pstcTrans->pstcNext = NULL;
+
+    u32Primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (pstcBus->pstcTail != NULL) {
+        pstcBus->pstcTail->pstcNext = pstcTrans;
+    } else {
+        pstcBus->pstcHead = pstcTrans;
+    }
+
+    pstcBus->pstcTail = pstcTrans;
+    pstcBus->u32QueueLen++;
+
+    if (pstcBus->u32QueueLen > pstcBus->stcStats.u32QueueMax) {
+        pstcBus->stcStats.u32QueueMax = pstcBus->u32QueueLen;
+    }
+
+    if (pstcBus->pstcHead == pstcTrans) {
+        SPIQ_StartTrans(pstcBus);
+    }
+
+    __set_PRIMASK(u32Primask);
+
+    return LL_OK;
+}
+
+/**
+ * @brief  Check whether the bus still has transactions running or queued.
+ * @param  [in] pstcBus                 Bus handle.
+ * @retval An @ref en_flag_status_t enumeration value.
+ */
+en_flag_status_t SPIQ_IsBusy(const stc_spiq_bus_t *pstcBus) {
+    return (pstcBus->pstcHead != NULL) ? SET : RESET;
+}
+
+/**
+ * @brief  Segment completion and error handling, called from the DMA TC and ERR interrupt callbacks.
+ * @param  [in] pstcBus                 Bus handle.
+ * @retval None
+ */
+void SPIQ_IrqHandler(stc_spiq_bus_t *pstcBus) {
+    CM_DMA_TypeDef *DMAx = pstcBus->DMAx;
+    stc_spiq_trans_t *pstcTrans = pstcBus->pstcHead;
+    uint32_t u32ErrFlag = ((DMA_FLAG_TRANS_ERR_CH0 | DMA_FLAG_REQ_ERR_CH0) << pstcBus->u8TxCh) |
+                          ((DMA_FLAG_TRANS_ERR_CH0 | DMA_FLAG_REQ_ERR_CH0) << pstcBus->u8RxCh);
+
+    if (DMA_GetErrStatus(DMAx, u32ErrFlag) == SET) {
+        DMA_ClearErrStatus(DMAx, u32ErrFlag);
+        SPI_Cmd(pstcBus->SPIx, DISABLE);
+        (void)DMA_ChCmd(DMAx, pstcBus->u8TxCh, DISABLE);
+        (void)DMA_ChCmd(DMAx, pstcBus->u8RxCh, DISABLE);
+
+        if (pstcTrans != NULL) {
+            SPIQ_Finish(pstcBus, LL_ERR);
+        }
+
+        return;
+    }
+
+    if (DMA_GetTransCompleteStatus(DMAx, DMA_FLAG_TC_CH0 << pstcBus->u8RxCh) == SET) {
+        DMA_ClearTransCompleteStatus(DMAx, (DMA_FLAG_TC_CH0 | DMA_FLAG_BTC_CH0) << pstcBus->u8RxCh);
+
+        if (pstcTrans == NULL) {
+            return;
+        }
+
+        pstcBus->stcStats.u32Frames += pstcTrans->pstcSeg[pstcTrans->u16SegIdx].u32Len;
+        pstcTrans->u16SegIdx++;
+
+        if (pstcTrans->u16SegIdx < pstcTrans->u16SegNum) {
+            SPIQ_StartSeg(pstcBus);
+        } else {
+            SPI_Cmd(pstcBus->SPIx, DISABLE);
+            SPIQ_Finish(pstcBus, LL_OK);
+        }
+    }
+}
+
+/**
+ * @brief  Read the bus statistics.
+ * @param  [in] pstcBus                 Bus handle.
+ * @param  [out] pstcStats              Statistics.
+ * @retval None
+ */
+void SPIQ_GetStats(const stc_spiq_bus_t *pstcBus, stc_spiq_stats_t *pstcStats) {
+    *pstcStats = pstcBus->stcStats;
+}
@@ -0,0 +1,113 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : spi_queue.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : SPI transaction queue: several devices share one bus, each transaction carries its
+  *				   chip select and mode, segments run by DMA and the completion interrupt starts the next
+  * Function List:
+  *		SPIQ_Init
+  *		SPIQ_DevInit
+  *		SPIQ_Submit
+  *		SPIQ_IsBusy
+  *		SPIQ_IrqHandler
+  *		SPIQ_GetStats
+  ******************************************************
+**/
+
+#ifndef __SPI_QUEUE_H_
+#define __SPI_QUEUE_H_
+
+#include "hc32_ll.h"
+
+#define SPIQ_SEG_LEN_MAX            (65535UL)   /*!< DTCTL.CNT, frames per segment */
+
+/* Transaction state */
+#define SPIQ_STATE_IDLE             (0U)
+#define SPIQ_STATE_QUEUED           (1U)
+#define SPIQ_STATE_ACTIVE           (2U)
+#define SPIQ_STATE_DONE             (3U)
+#define SPIQ_STATE_ERROR            (4U)
+
+/**
+ * @brief Device on the bus.
+ */
+typedef struct {
+    uint8_t  u8CsPort;              /*!< @ref GPIO_Port_Source, chip select driven as a GPIO */
+    uint16_t u16CsPin;              /*!< @ref GPIO_Pins_Define */
+    uint32_t u32Mode;               /*!< @ref SPI_Mode_Define, SPI_MD_0 ~ SPI_MD_3 */
+    uint32_t u32BaudRatePrescaler;  /*!< @ref SPI_Baud_Rate_Prescaler_Define */
+    uint32_t u32DataWidth;          /*!< SPI_DATA_SIZE_8BIT or SPI_DATA_SIZE_16BIT */
+} stc_spiq_dev_t;
+
+/**
+ * @brief One segment of a transaction; the chip select stays active between segments.
+ */
+typedef struct {
+    const void *pvTx;               /*!< NULL: send 0xFF */
+    void *pvRx;                     /*!< NULL: received data discarded */
+    uint32_t u32Len;                /*!< Frames, 1 ~ SPIQ_SEG_LEN_MAX */
+} stc_spiq_seg_t;
+
+typedef struct stc_spiq_trans stc_spiq_trans_t;
+
+/**
+ * @brief Transaction, owned by the queue from SPIQ_Submit until pfnDone.
+ */
+struct stc_spiq_trans {
+    const stc_spiq_dev_t *pstcDev;
+    const stc_spiq_seg_t *pstcSeg;
+    uint16_t u16SegNum;
+    void (*pfnDone)(stc_spiq_trans_t *pstcTrans, int32_t i32Result);   /*!< Called from SPIQ_IrqHandler */
+    void *pvArg;
+
+    /* Maintained by the queue */
+    __IO uint8_t u8State;
+    uint16_t u16SegIdx;
+    stc_spiq_trans_t *pstcNext;
+};
+
+/**
+ * @brief Bus statistics.
+ */
+typedef struct {
+    uint32_t u32Trans;              /*!< Transactions completed */
+    uint32_t u32Segments;           /*!< Segments started */
+    uint32_t u32Frames;             /*!< Frames of completed segments */
+    uint32_t u32ModeSwitch;         /*!< Mode/baud rate/width changes between transactions */
+    uint32_t u32Errors;             /*!< DMA transfer or request errors */
+    uint32_t u32QueueMax;           /*!< Longest queue seen, including the running transaction */
+    uint64_t u64BusyCycles;         /*!< Core cycles from chip select active to inactive */
+} stc_spiq_stats_t;
+
+/**
+ * @brief One SPI bus with its Tx and Rx DMA channels.
+ */
+typedef struct {
+    CM_SPI_TypeDef *SPIx;
+    CM_DMA_TypeDef *DMAx;
+    uint8_t  u8TxCh;
+    uint8_t  u8RxCh;
+    uint32_t u32Cfg2;               /*!< CFG2 mode bits of the last device */
+    stc_spiq_trans_t *pstcHead;     /*!< Running transaction, then the waiting ones */
+    stc_spiq_trans_t *pstcTail;
+    uint32_t u32QueueLen;
+    uint32_t u32Start;
+    stc_spiq_stats_t stcStats;
+} stc_spiq_bus_t;
+
+int32_t SPIQ_Init(stc_spiq_bus_t *pstcBus, CM_SPI_TypeDef *SPIx, CM_DMA_TypeDef *DMAx, uint8_t u8TxCh, uint8_t u8RxCh);
+void SPIQ_DevInit(const stc_spiq_dev_t *pstcDev);
+int32_t SPIQ_Submit(stc_spiq_bus_t *pstcBus, stc_spiq_trans_t *pstcTrans);
+en_flag_status_t SPIQ_IsBusy(const stc_spiq_bus_t *pstcBus);
+void SPIQ_IrqHandler(stc_spiq_bus_t *pstcBus);
+void SPIQ_GetStats(const stc_spiq_bus_t *pstcBus, stc_spiq_stats_t *pstcStats);
+
+#endif
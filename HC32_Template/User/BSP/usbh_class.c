@@ -0,0 +1,975 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : usbh_class.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					Mass storage, Bulk-Only transport: a SCSI command is three URBs, CBW ->
+					data -> CSW, and the completion callback of each (USB interrupt) submits
+					the next one, so the main loop is not involved between phases. A STALLed
+					data phase is cleared and followed by the CSW; a bad CSW or phase error
+					goes through BOT reset recovery. After attach: INQUIRY, TEST UNIT READY
+					(REQUEST SENSE and a retry every 100ms while not ready), READ CAPACITY(10).
+					Sequential reads use two read-ahead buffers of UMS_RA_BLOCKS blocks, one
+					READ(10) fills one buffer. A buffer state is only changed by its owner
+					(interrupt FREE->READING->FULL, application FULL->FREE); releasing a
+					buffer pends the USB interrupt and pfnService starts the next READ(10)
+					right away, so one buffer is being read while the application works on
+					the other. UMS_Read/UMS_Write are single asynchronous requests and go
+					before the read-ahead.
+					HID: the interrupt IN endpoint of the interface is polled by the core at
+					bInterval after SET_IDLE(0); every report goes to the callback and the
+					URB is submitted again at once, so the application does not affect the
+					polling interval.
+  * Function List:
+  *		UMS_IsReady
+  *		UMS_GetInfo
+  *		UMS_Read
+  *		UMS_Write
+  *		UMS_GetStatus
+  *		UMS_StreamOpen
+  *		UMS_StreamRead
+  *		UMS_StreamDone
+  *		UMS_StreamIsEnd
+  *		UMS_StreamClose
+  *		UMS_GetStats
+  *		UMS_Bench
+  *		UHD_SetCallback
+  *		UHD_IsReady
+  *		UHD_GetProtocol
+  *		UHD_GetReports
+  **********************************************************
+ */
+
+#include "usbh_class.h"
+
+#define UMS_CBW_SIG                 (0x43425355UL)  /* "USBC" */
+#define UMS_CSW_SIG                 (0x53425355UL)  /* "USBS" */
+#define UMS_CBW_LEN                 (31UL)
+#define UMS_CSW_LEN                 (13UL)
+
+#define UHC_REQ_CLEAR_FEATURE       (1U)
+
+/* Who issued the running command */
+#define UMS_OWN_INIT                (0U)
+#define UMS_OWN_USER                (1U)
+#define UMS_OWN_STREAM              (2U)
+
+/* Initialization step */
+#define UMS_INIT_INQUIRY            (0U)
+#define UMS_INIT_TUR                (1U)
+#define UMS_INIT_SENSE              (2U)
+#define UMS_INIT_WAIT               (3U)
+#define UMS_INIT_CAPACITY           (4U)
+#define UMS_INIT_DONE               (5U)
+#define UMS_INIT_FAIL               (6U)
+
+/* Endpoint 0 request step */
+#define UMS_CTRL_CLEAR_CSW          (0U)    /* Data phase STALL: clear, then read the CSW */
+#define UMS_CTRL_RESET              (1U)    /* Recovery: BOT reset */
+#define UMS_CTRL_RESET_IN           (2U)    /* Recovery: clear the IN endpoint */
+#define UMS_CTRL_RESET_OUT          (3U)    /* Recovery: clear the OUT endpoint */
+
+/* Read-ahead buffer state */
+#define UMS_BUF_FREE                (0U)    /* Held by the interrupt */
+#define UMS_BUF_READING             (1U)
+#define UMS_BUF_FULL                (2U)    /* Handed to the application */
+
+typedef struct {
+    stc_uhc_pipe_t stcIn;
+    stc_uhc_pipe_t stcOut;
+    stc_uhc_urb_t stcCbw;
+    stc_uhc_urb_t stcData;
+    stc_uhc_urb_t stcCsw;
+    stc_uhc_urb_t stcCtrl;
+    uint32_t au32Cbw[32UL / 4UL];
+    uint32_t au32Csw[16UL / 4UL];
+    uint32_t au32Tmp[36UL / 4UL];   /* INQUIRY/REQUEST SENSE/READ CAPACITY data */
+
+    uint8_t  u8Intf;
+    uint8_t  u8Found;               /* Interface taken */
+    uint8_t  u8Gone;                /* Device removed, nothing is submitted any more */
+    uint8_t  u8Busy;                /* A command is running */
+    uint8_t  u8Owner;
+    uint8_t  u8CtrlStep;
+    uint8_t  u8CswRetry;
+    uint8_t  u8Init;
+    uint8_t  u8Tries;
+    uint8_t  u8Starving;
+    uint16_t u16Wait;               /* Frames left to wait during initialization */
+    uint16_t u16LastFrame;
+    uint32_t u32Tag;
+    uint32_t u32CmdBlocks;
+    __IO uint8_t u8Ready;
+
+    /* UMS_Read/UMS_Write */
+    __IO uint8_t u8ReqPend;
+    __IO uint8_t u8Status;
+    uint8_t  u8ReqWrite;
+    uint32_t u32ReqLba;
+    uint32_t u32ReqCount;
+    uint8_t  *pu8ReqBuf;
+
+    /* Read-ahead */
+    __IO uint8_t u8StreamOn;
+    __IO uint8_t u8StreamErr;
+    __IO uint8_t au8BufState[2];
+    uint32_t au32BufLen[2];
+    uint8_t  u8App;                 /* Buffer the application takes next */
+    uint8_t  u8Usb;                 /* Buffer the interrupt fills next */
+    __IO uint32_t u32Left;          /* Blocks not requested yet */
+    uint32_t u32NextLba;
+
+    stc_ums_info_t stcInfo;
+    stc_ums_stats_t stcStats;
+
+    uint32_t au32Buf[2][UMS_RA_BLOCKS * UMS_BLOCK_MAX / 4UL];
+} stc_ums_dev_t;
+
+typedef struct {
+    stc_uhc_pipe_t stcIn;
+    stc_uhc_urb_t stcUrb;
+    stc_uhc_urb_t stcCtrl;
+    uint32_t au32Buf[UHD_REPORT_MAX / 4UL];
+    uint8_t  u8Intf;
+    uint8_t  u8Protocol;
+    __IO uint8_t u8Ready;
+    __IO uint32_t u32Reports;
+    func_uhd_report_t pfnReport;
+} stc_uhd_dev_t;
+
+static stc_ums_dev_t stcUms;
+static stc_uhd_dev_t stcUhd;
+
+static void UMS_Next(void);
+
+static void UMS_Put32(uint8_t *pu8Buf, uint32_t u32Val) {
+    pu8Buf[0] = (uint8_t)(u32Val >> 24);
+    pu8Buf[1] = (uint8_t)(u32Val >> 16);
+    pu8Buf[2] = (uint8_t)(u32Val >> 8);
+    pu8Buf[3] = (uint8_t)u32Val;
+}
+
+static uint32_t UMS_Get32(const uint8_t *pu8Buf) {
+    return ((uint32_t)pu8Buf[0] << 24) | ((uint32_t)pu8Buf[1] << 16) | ((uint32_t)pu8Buf[2] << 8) | pu8Buf[3];
+}
+
+/**
+ * @brief  Copy an INQUIRY ASCII field without its trailing spaces.
+ */
+static void UMS_Ascii(char *pcDst, const uint8_t *pu8Src, uint32_t u32Len) {
+    uint32_t i;
+
+    for (i = 0UL; i < u32Len; i++) {
+        pcDst[i] = (char)pu8Src[i];
+    }
+
+    for (pcDst[u32Len] = '\0'; (u32Len > 0UL) && (pcDst[u32Len - 1UL] == ' '); u32Len--) {
+        pcDst[u32Len - 1UL] = '\0';
+    }
+}
+
+/**
+ * @brief  Command finished: hand the result to its owner, then start the next command.
+ */
+static void UMS_CmdDone(uint32_t u32Ok) {
+    const uint8_t *pu8Tmp = (const uint8_t *)stcUms.au32Tmp;
+    uint32_t i;
+
+    stcUms.u8Busy = 0U;
+
+    if (u32Ok != 0UL) {
+        stcUms.stcStats.u32Commands++;
+    } else {
+        stcUms.stcStats.u32Errors++;
+    }
+
+    switch (stcUms.u8Owner) {
+        case UMS_OWN_INIT:
+            switch (stcUms.u8Init) {
+                case UMS_INIT_INQUIRY:
+                    if (u32Ok != 0UL) {
+                        UMS_Ascii(stcUms.stcInfo.acVendor, &pu8Tmp[8], 8UL);
+                        UMS_Ascii(stcUms.stcInfo.acProduct, &pu8Tmp[16], 16UL);
+                    }
+
+                    stcUms.u8Init = UMS_INIT_TUR;
+                    break;
+
+                case UMS_INIT_TUR:
+                    stcUms.u8Init = (u32Ok != 0UL) ? UMS_INIT_CAPACITY : UMS_INIT_SENSE;
+                    break;
+
+                case UMS_INIT_SENSE:
+                    stcUms.u16Wait = 100U;
+                    stcUms.u8Init = (++stcUms.u8Tries >= UMS_TUR_TRIES) ? UMS_INIT_FAIL : UMS_INIT_WAIT;
+                    break;
+
+                case UMS_INIT_CAPACITY:
+                    stcUms.stcInfo.u32Blocks = UMS_Get32(&pu8Tmp[0]) + 1UL;
+                    stcUms.stcInfo.u32BlockSize = UMS_Get32(&pu8Tmp[4]);
+
+                    if ((u32Ok == 0UL) || (stcUms.stcInfo.u32BlockSize == 0UL) ||
+                        (stcUms.stcInfo.u32BlockSize > UMS_BLOCK_MAX)) {
+                        stcUms.u8Init = UMS_INIT_FAIL;
+                    } else {
+                        stcUms.u8Init = UMS_INIT_DONE;
+                        stcUms.u8Ready = 1U;
+                    }
+                    break;
+
+                default:
+                    break;
+            }
+            break;
+
+        case UMS_OWN_USER:
+            if (u32Ok != 0UL) {
+                if (stcUms.u8ReqWrite != 0U) {
+                    stcUms.stcStats.u32WriteBlocks += stcUms.u32CmdBlocks;
+                } else {
+                    stcUms.stcStats.u32ReadBlocks += stcUms.u32CmdBlocks;
+                }
+            }
+
+            stcUms.u8Status = (u32Ok != 0UL) ? UMS_ST_OK : UMS_ST_FAIL;
+            break;
+
+        default:
+            i = stcUms.u8Usb;
+
+            if (u32Ok != 0UL) {
+                stcUms.stcStats.u32ReadBlocks += stcUms.u32CmdBlocks;
+                stcUms.au32BufLen[i] = stcUms.u32CmdBlocks * stcUms.stcInfo.u32BlockSize;
+                __DMB();
+                stcUms.au8BufState[i] = UMS_BUF_FULL;
+                stcUms.u8Usb = (uint8_t)(i ^ 1UL);
+            } else {
+                stcUms.au8BufState[i] = UMS_BUF_FREE;
+                stcUms.u8StreamErr = 1U;
+            }
+            break;
+    }
+
+    UMS_Next();
+}
+
+static void UMS_Submit(stc_uhc_urb_t *pstcUrb) {
+    if (UHC_Submit(pstcUrb) != LL_OK) {
+        stcUms.u8Gone = 1U;
+        UMS_CmdDone(0UL);
+    }
+}
+
+/**
+ * @brief  A URB ended by removal or cancellation stops the command; returns 0 then.
+ */
+static uint32_t UMS_Alive(const stc_uhc_urb_t *pstcUrb) {
+    if ((pstcUrb->u8Result == UHC_RES_NODEV) || (pstcUrb->u8Result == UHC_RES_CANCEL)) {
+        stcUms.u8Gone = 1U;
+        UMS_CmdDone(0UL);
+        return 0UL;
+    }
+
+    return 1UL;
+}
+
+static void UMS_ClearHalt(stc_uhc_pipe_t *pstcPipe, uint8_t u8Step) {
+    stcUms.u8CtrlStep = u8Step;
+    pstcPipe->u8Toggle = 0U;
+
+    if (UHC_Control(&stcUms.stcCtrl, 0x02U, UHC_REQ_CLEAR_FEATURE, 0U, pstcPipe->u8Ep, NULL, 0U) != LL_OK) {
+        stcUms.u8Gone = 1U;
+        UMS_CmdDone(0UL);
+    }
+}
+
+/**
+ * @brief  Reset recovery: BOT reset, clear both endpoints, the command fails.
+ */
+static void UMS_Recover(void) {
+    stcUms.stcStats.u32Resets++;
+    stcUms.u8CtrlStep = UMS_CTRL_RESET;
+
+    if (UHC_Control(&stcUms.stcCtrl, 0x21U, 0xFFU, 0U, stcUms.u8Intf, NULL, 0U) != LL_OK) {
+        stcUms.u8Gone = 1U;
+        UMS_CmdDone(0UL);
+    }
+}
+
+static void UMS_CtrlDone(stc_uhc_urb_t *pstcUrb) {
+    if (UMS_Alive(pstcUrb) == 0UL) {
+        return;
+    }
+
+    switch (stcUms.u8CtrlStep) {
+        case UMS_CTRL_CLEAR_CSW:
+            if (pstcUrb->u8Result == UHC_RES_OK) {
+                UMS_Submit(&stcUms.stcCsw);
+            } else {
+                UMS_Recover();
+            }
+            break;
+
+        case UMS_CTRL_RESET:
+            UMS_ClearHalt(&stcUms.stcIn, UMS_CTRL_RESET_IN);
+            break;
+
+        case UMS_CTRL_RESET_IN:
+            UMS_ClearHalt(&stcUms.stcOut, UMS_CTRL_RESET_OUT);
+            break;
+
+        default:
+            UMS_CmdDone(0UL);
+            break;
+    }
+}
+
+static void UMS_CbwDone(stc_uhc_urb_t *pstcUrb) {
+    if (UMS_Alive(pstcUrb) == 0UL) {
+        return;
+    }
+
+    if (pstcUrb->u8Result != UHC_RES_OK) {
+        UMS_Recover();
+    } else if (stcUms.stcData.u32Len != 0UL) {
+        UMS_Submit(&stcUms.stcData);
+    } else {
+        UMS_Submit(&stcUms.stcCsw);
+    }
+}
+
+static void UMS_DataDone(stc_uhc_urb_t *pstcUrb) {
+    if (UMS_Alive(pstcUrb) == 0UL) {
+        return;
+    }
+
+    if (pstcUrb->u8Result == UHC_RES_OK) {
+        UMS_Submit(&stcUms.stcCsw);
+    } else if (pstcUrb->u8Result == UHC_RES_STALL) {
+        UMS_ClearHalt(pstcUrb->pstcPipe, UMS_CTRL_CLEAR_CSW);
+    } else {
+        UMS_Recover();
+    }
+}
+
+static void UMS_CswDone(stc_uhc_urb_t *pstcUrb) {
+    const uint8_t *pu8Csw = (const uint8_t *)stcUms.au32Csw;
+
+    if (UMS_Alive(pstcUrb) == 0UL) {
+        return;
+    }
+
+    /* CSW STALLed: clear it and read once more */
+    if ((pstcUrb->u8Result == UHC_RES_STALL) && (stcUms.u8CswRetry == 0U)) {
+        stcUms.u8CswRetry = 1U;
+        UMS_ClearHalt(&stcUms.stcIn, UMS_CTRL_CLEAR_CSW);
+        return;
+    }
+
+    if ((pstcUrb->u8Result != UHC_RES_OK) || (pstcUrb->u32Actual != UMS_CSW_LEN) ||
+        (stcUms.au32Csw[0] != UMS_CSW_SIG) || (stcUms.au32Csw[1] != stcUms.u32Tag) || (pu8Csw[12] > 1U)) {
+        UMS_Recover();
+        return;
+    }
+
+    /* Status 1 is a failed command; a read or write with residue counts as failed too */
+    UMS_CmdDone(((pu8Csw[12] == 0U) && ((stcUms.stcData.u32Len == 0UL) || (stcUms.au32Csw[2] == 0UL))) ? 1UL : 0UL);
+}
+
+/**
+ * @brief  Start a SCSI command on LUN 0.
+ */
+static void UMS_Command(const uint8_t *pu8Cb, uint32_t u32CbLen, uint8_t *pu8Buf, uint32_t u32Len,
+                        uint32_t u32In, uint8_t u8Owner) {
+    uint8_t *pu8Cbw = (uint8_t *)stcUms.au32Cbw;
+    uint32_t i;
+
+    stcUms.u8Busy = 1U;
+    stcUms.u8Owner = u8Owner;
+    stcUms.u8CswRetry = 0U;
+
+    for (i = 0UL; i < (sizeof(stcUms.au32Cbw) / 4UL); i++) {
+        stcUms.au32Cbw[i] = 0UL;
+    }
+
+    stcUms.au32Cbw[0] = UMS_CBW_SIG;
+    stcUms.au32Cbw[1] = ++stcUms.u32Tag;
+    stcUms.au32Cbw[2] = u32Len;
+    pu8Cbw[12] = (u32In != 0UL) ? 0x80U : 0x00U;
+    pu8Cbw[13] = 0U;
+    pu8Cbw[14] = (uint8_t)u32CbLen;
+
+    for (i = 0UL; i < u32CbLen; i++) {
+        pu8Cbw[15UL + i] = pu8Cb[i];
+    }
+
+    stcUms.stcCbw.pstcPipe = &stcUms.stcOut;
+    stcUms.stcCbw.pu8Buf = pu8Cbw;
+    stcUms.stcCbw.u32Len = UMS_CBW_LEN;
+    stcUms.stcData.pstcPipe = (u32In != 0UL) ? &stcUms.stcIn : &stcUms.stcOut;
+    stcUms.stcData.pu8Buf = pu8Buf;
+    stcUms.stcData.u32Len = u32Len;
+
+    UMS_Submit(&stcUms.stcCbw);
+}
+
+/**
+ * @brief  READ(10)/WRITE(10).
+ */
+static void UMS_ReadWrite(uint32_t u32Write, uint32_t u32Lba, uint32_t u32Count, uint8_t *pu8Buf, uint8_t u8Owner) {
+    uint8_t au8Cb[10] = {0U};
+
+    au8Cb[0] = (u32Write != 0UL) ? 0x2AU : 0x28U;
+    UMS_Put32(&au8Cb[2], u32Lba);
+    au8Cb[7] = (uint8_t)(u32Count >> 8);
+    au8Cb[8] = (uint8_t)u32Count;
+
+    stcUms.u32CmdBlocks = u32Count;
+    UMS_Command(au8Cb, 10UL, pu8Buf, u32Count * stcUms.stcInfo.u32BlockSize, (u32Write == 0UL) ? 1UL : 0UL, u8Owner);
+}
+
+/**
+ * @brief  Pick the next command while the bus is free: initialization, single request, read-ahead.
+ */
+static void UMS_Next(void) {
+    uint8_t au8Cb[10] = {0U};
+    uint32_t u32Blocks;
+
+    if ((stcUms.u8Found == 0U) || (stcUms.u8Gone != 0U) || (stcUms.u8Busy != 0U)) {
+        return;
+    }
+
+    if (stcUms.u8Init != UMS_INIT_DONE) {
+        if (stcUms.u8Init == UMS_INIT_WAIT) {
+            if (stcUms.u16Wait != 0U) {
+                return;
+            }
+
+            stcUms.u8Init = UMS_INIT_TUR;
+        }
+
+        switch (stcUms.u8Init) {
+            case UMS_INIT_INQUIRY:
+                au8Cb[0] = 0x12U;
+                au8Cb[4] = 36U;
+                UMS_Command(au8Cb, 6UL, (uint8_t *)stcUms.au32Tmp, 36UL, 1UL, UMS_OWN_INIT);
+                break;
+
+            case UMS_INIT_TUR:
+                UMS_Command(au8Cb, 6UL, NULL, 0UL, 0UL, UMS_OWN_INIT);
+                break;
+
+            case UMS_INIT_SENSE:
+                au8Cb[0] = 0x03U;
+                au8Cb[4] = 18U;
+                UMS_Command(au8Cb, 6UL, (uint8_t *)stcUms.au32Tmp, 18UL, 1UL, UMS_OWN_INIT);
+                break;
+
+            case UMS_INIT_CAPACITY:
+                au8Cb[0] = 0x25U;
+                UMS_Command(au8Cb, 10UL, (uint8_t *)stcUms.au32Tmp, 8UL, 1UL, UMS_OWN_INIT);
+                break;
+
+            default:
+                break;
+        }
+        return;
+    }
+
+    if (stcUms.u8ReqPend != 0U) {
+        stcUms.u8ReqPend = 0U;
+        UMS_ReadWrite(stcUms.u8ReqWrite, stcUms.u32ReqLba, stcUms.u32ReqCount, stcUms.pu8ReqBuf, UMS_OWN_USER);
+        return;
+    }
+
+    if ((stcUms.u8StreamOn == 0U) || (stcUms.u8StreamErr != 0U) || (stcUms.u32Left == 0UL)) {
+        return;
+    }
+
+    /* Both buffers are with the application */
+    if (stcUms.au8BufState[stcUms.u8Usb] != UMS_BUF_FREE) {
+        if (stcUms.u8Starving == 0U) {
+            stcUms.u8Starving = 1U;
+            stcUms.stcStats.u32Starved++;
+        }
+        return;
+    }
+
+    stcUms.u8Starving = 0U;
+
+    u32Blocks = UMS_RA_BLOCKS * UMS_BLOCK_MAX / stcUms.stcInfo.u32BlockSize;
+
+    if (u32Blocks > stcUms.u32Left) {
+        u32Blocks = stcUms.u32Left;
+    }
+
+    stcUms.au8BufState[stcUms.u8Usb] = UMS_BUF_READING;
+    stcUms.u32Left -= u32Blocks;
+    stcUms.u32NextLba += u32Blocks;
+    UMS_ReadWrite(0UL, stcUms.u32NextLba - u32Blocks, u32Blocks, (uint8_t *)stcUms.au32Buf[stcUms.u8Usb], UMS_OWN_STREAM);
+}
+
+static uint32_t UMS_Probe(const uint8_t *pu8Intf, uint32_t u32Len) {
+    const uint8_t *pu8In;
+    const uint8_t *pu8Out;
+
+    /* Mass storage, SCSI transparent command set, Bulk-Only */
+    if ((pu8Intf[5] != 0x08U) || (pu8Intf[6] != 0x06U) || (pu8Intf[7] != 0x50U)) {
+        return 0UL;
+    }
+
+    pu8In = UHC_FindEp(pu8Intf, u32Len, UHC_EP_BULK, UHC_EP_IN);
+    pu8Out = UHC_FindEp(pu8Intf, u32Len, UHC_EP_BULK, UHC_EP_OUT);
+
+    if ((pu8In == NULL) || (pu8Out == NULL) ||
+        (UHC_PipeInit(&stcUms.stcIn, pu8In) != LL_OK) || (UHC_PipeInit(&stcUms.stcOut, pu8Out) != LL_OK)) {
+        return 0UL;
+    }
+
+    stcUms.u8Intf = pu8Intf[2];
+    stcUms.u8Found = 1U;
+
+    return 1UL;
+}
+
+static void UMS_Start(void) {
+    stcUms.stcCbw.pfnDone = UMS_CbwDone;
+    stcUms.stcData.pfnDone = UMS_DataDone;
+    stcUms.stcCsw.pstcPipe = &stcUms.stcIn;
+    stcUms.stcCsw.pu8Buf = (uint8_t *)stcUms.au32Csw;
+    stcUms.stcCsw.u32Len = UMS_CSW_LEN;
+    stcUms.stcCsw.pfnDone = UMS_CswDone;
+    stcUms.stcCtrl.pfnDone = UMS_CtrlDone;
+
+    stcUms.u8Gone = 0U;
+    stcUms.u8Busy = 0U;
+    stcUms.u8Init = UMS_INIT_INQUIRY;
+    stcUms.u8Tries = 0U;
+    stcUms.u16Wait = 0U;
+    stcUms.stcInfo.acVendor[0] = '\0';
+    stcUms.stcInfo.acProduct[0] = '\0';
+    stcUms.u8ReqPend = 0U;
+    stcUms.u8StreamOn = 0U;
+    stcUms.au8BufState[0] = UMS_BUF_FREE;
+    stcUms.au8BufState[1] = UMS_BUF_FREE;
+
+    UHC_Wake();
+}
+
+static void UMS_Stop(void) {
+    stcUms.u8Ready = 0U;
+    stcUms.u8Found = 0U;
+    stcUms.u8Busy = 0U;
+    stcUms.u8ReqPend = 0U;
+    stcUms.u8StreamOn = 0U;
+    stcUms.au8BufState[0] = UMS_BUF_FREE;
+    stcUms.au8BufState[1] = UMS_BUF_FREE;
+
+    if (stcUms.u8Status == UMS_ST_BUSY) {
+        stcUms.u8Status = UMS_ST_FAIL;
+    }
+}
+
+/**
+ * @brief  End of the USB interrupt: count initialization wait frames, start a command once the
+ *         application has freed a buffer or queued a request.
+ */
+static void UMS_Service(void) {
+    uint32_t u32Frame;
+
+    if (stcUms.u8Found == 0U) {
+        return;
+    }
+
+    u32Frame = UHC_Frame();
+
+    if ((stcUms.u16Wait != 0U) && (u32Frame != stcUms.u16LastFrame)) {
+        stcUms.u16Wait--;
+    }
+
+    stcUms.u16LastFrame = (uint16_t)u32Frame;
+
+    UMS_Next();
+}
+
+const stc_uhc_class_t stcUmsClass = {UMS_Probe, UMS_Start, NULL, UMS_Stop, UMS_Service};
+
+/**
+ * @brief  Check whether a mass storage device has passed initialization.
+ * @param  None
+ * @retval An @ref en_flag_status_t enumeration value.
+ */
+en_flag_status_t UMS_IsReady(void) {
+    return (stcUms.u8Ready != 0U) ? SET : RESET;
+}
+
+/**
+ * @brief  Capacity and INQUIRY strings.
+ * @param  [out] pstcInfo               Information.
+ * @retval None
+ */
+void UMS_GetInfo(stc_ums_info_t *pstcInfo) {
+    *pstcInfo = stcUms.stcInfo;
+}
+
+static int32_t UMS_Request(uint8_t u8Write, uint32_t u32Lba, uint32_t u32Count, uint8_t *pu8Buf) {
+    if ((u32Count == 0UL) || (u32Count > 0xFFFFUL) || (pu8Buf == NULL)) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    if (stcUms.u8Ready == 0U) {
+        return LL_ERR_NOT_RDY;
+    }
+
+    if (stcUms.u8Status == UMS_ST_BUSY) {
+        return LL_ERR_BUSY;
+    }
+
+    stcUms.u8ReqWrite = u8Write;
+    stcUms.u32ReqLba = u32Lba;
+    stcUms.u32ReqCount = u32Count;
+    stcUms.pu8ReqBuf = pu8Buf;
+    stcUms.u8Status = UMS_ST_BUSY;
+    __DMB();
+    stcUms.u8ReqPend = 1U;
+
+    UHC_Wake();
+
+    return LL_OK;
+}
+
+/**
+ * @brief  Start reading blocks; UMS_GetStatus tells when it has finished.
+ * @param  [in] u32Lba                  First block.
+ * @param  [in] u32Count                Blocks, 1 ~ 65535.
+ * @param  [in] pu8Buf                  Destination, untouched by the caller until finished.
+ * @retval int32_t:
+ *           - LL_OK:                   Started.
+ *           - LL_ERR_INVD_PARAM:       Count out of range or no buffer.
+ *           - LL_ERR_NOT_RDY:          No device ready.
+ *           - LL_ERR_BUSY:             The previous request has not finished.
+ */
+int32_t UMS_Read(uint32_t u32Lba, uint32_t u32Count, uint8_t *pu8Buf) {
+    return UMS_Request(0U, u32Lba, u32Count, pu8Buf);
+}
+
+/**
+ * @brief  Start writing blocks; UMS_GetStatus tells when it has finished.
+ * @param  [in] u32Lba                  First block.
+ * @param  [in] u32Count                Blocks, 1 ~ 65535.
+ * @param  [in] pu8Buf                  Source, unchanged by the caller until finished.
+ * @retval int32_t:                     See UMS_Read.
+ */
+int32_t UMS_Write(uint32_t u32Lba, uint32_t u32Count, const uint8_t *pu8Buf) {
+    return UMS_Request(1U, u32Lba, u32Count, (uint8_t *)pu8Buf);
+}
+
+/**
+ * @brief  State of the last UMS_Read/UMS_Write.
+ * @param  None
+ * @retval UMS_ST_IDLE/BUSY/OK/FAIL.
+ */
+uint8_t UMS_GetStatus(void) {
+    return stcUms.u8Status;
+}
+
+/**
+ * @brief  Start reading u32Blocks blocks from u32Lba ahead into the two read-ahead buffers.
+ * @param  [in] u32Lba                  First block.
+ * @param  [in] u32Blocks               Blocks.
+ * @retval int32_t:
+ *           - LL_OK:                   Started.
+ *           - LL_ERR_INVD_PARAM:       u32Blocks is 0.
+ *           - LL_ERR_NOT_RDY:          No device ready.
+ *           - LL_ERR_BUSY:             A READ(10) of the previous stream is still running.
+ */
+int32_t UMS_StreamOpen(uint32_t u32Lba, uint32_t u32Blocks) {
+    if (u32Blocks == 0UL) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    if (stcUms.u8Ready == 0U) {
+        return LL_ERR_NOT_RDY;
+    }
+
+    stcUms.u8StreamOn = 0U;
+    __DMB();
+
+    if ((stcUms.au8BufState[0] == UMS_BUF_READING) || (stcUms.au8BufState[1] == UMS_BUF_READING)) {
+        return LL_ERR_BUSY;
+    }
+
+    stcUms.au8BufState[0] = UMS_BUF_FREE;
+    stcUms.au8BufState[1] = UMS_BUF_FREE;
+    stcUms.u8App = 0U;
+    stcUms.u8Usb = 0U;
+    stcUms.u32NextLba = u32Lba;
+    stcUms.u32Left = u32Blocks;
+    stcUms.u8StreamErr = 0U;
+    stcUms.u8Starving = 0U;
+    __DMB();
+    stcUms.u8StreamOn = 1U;
+
+    UHC_Wake();
+
+    return LL_OK;
+}
+
+/**
+ * @brief  Take the oldest filled read-ahead buffer.
+ * @param  [out] ppu8Data               Buffer, valid until UMS_StreamDone.
+ * @retval Bytes in the buffer, 0 if none is filled yet.
+ */
+uint32_t UMS_StreamRead(const uint8_t **ppu8Data) {
+    if ((stcUms.u8StreamOn == 0U) || (stcUms.au8BufState[stcUms.u8App] != UMS_BUF_FULL)) {
+        return 0UL;
+    }
+
+    *ppu8Data = (const uint8_t *)stcUms.au32Buf[stcUms.u8App];
+
+    return stcUms.au32BufLen[stcUms.u8App];
+}
+
+/**
+ * @brief  Give the buffer from UMS_StreamRead back; the read-ahead continues into it.
+ * @param  None
+ * @retval None
+ */
+void UMS_StreamDone(void) {
+    if (stcUms.au8BufState[stcUms.u8App] != UMS_BUF_FULL) {
+        return;
+    }
+
+    __DMB();
+    stcUms.au8BufState[stcUms.u8App] = UMS_BUF_FREE;
+    stcUms.u8App ^= 1U;
+
+    UHC_Wake();
+}
+
+/**
+ * @brief  Check whether all blocks have been handed to the application, or the stream failed.
+ * @param  None
+ * @retval An @ref en_flag_status_t enumeration value.
+ */
+en_flag_status_t UMS_StreamIsEnd(void) {
+    if ((stcUms.u8StreamOn == 0U) || (stcUms.u8StreamErr != 0U) || (stcUms.u8Ready == 0U)) {
+        return SET;
+    }
+
+    return ((stcUms.u32Left == 0UL) && (stcUms.au8BufState[0] == UMS_BUF_FREE) &&
+            (stcUms.au8BufState[1] == UMS_BUF_FREE)) ? SET : RESET;
+}
+
+/**
+ * @brief  Stop the read-ahead.
+ * @param  None
+ * @retval None
+ */
+void UMS_StreamClose(void) {
+    stcUms.u8StreamOn = 0U;
+}
+
+/**
+ * @brief  Read the mass storage statistics.
+ * @param  [out] pstcStats              Statistics.
+ * @retval None
+ */
+void UMS_GetStats(stc_ums_stats_t *pstcStats) {
+    *pstcStats = stcUms.stcStats;
+}
+
+/**
+ * @brief  Stream u32Blocks blocks and time it.
+ * @param  [in] u32Lba                  First block.
+ * @param  [in] u32Blocks               Blocks.
+ * @param  [out] pstcResult             Throughput and interrupt load.
+ * @retval int32_t:
+ *           - LL_OK:                   No errors occurred.
+ *           - LL_ERR:                  A read failed or the device was removed.
+ *           - LL_ERR_TIMEOUT:          No buffer for one second.
+ *           - Others:                  See UMS_StreamOpen.
+ */
+int32_t UMS_Bench(uint32_t u32Lba, uint32_t u32Blocks, stc_ums_bench_t *pstcResult) {
+    stc_uhc_stats_t stcS0;
+    stc_uhc_stats_t stcS1;
+    const uint8_t *pu8Data;
+    uint64_t u64Cycles = 0ULL;
+    uint32_t u32Bytes = 0UL;
+    uint32_t u32Len;
+    uint32_t u32T0;
+    uint32_t u32T1;
+    uint32_t u32Last;
+    int32_t i32Ret;
+
+    i32Ret = UMS_StreamOpen(u32Lba, u32Blocks);
+
+    if (i32Ret != LL_OK) {
+        return i32Ret;
+    }
+
+    UHC_GetStats(&stcS0);
+
+    u32T0 = DWT->CYCCNT;
+    u32Last = u32T0;
+
+    while (UMS_StreamIsEnd() == RESET) {
+        u32T1 = DWT->CYCCNT;
+        u64Cycles += u32T1 - u32T0;
+        u32T0 = u32T1;
+
+        u32Len = UMS_StreamRead(&pu8Data);
+
+        if (u32Len != 0UL) {
+            u32Bytes += u32Len;
+            UMS_StreamDone();
+            u32Last = u32T1;
+        } else if ((u32T1 - u32Last) > SystemCoreClock) {
+            UMS_StreamClose();
+            return LL_ERR_TIMEOUT;
+        } else {
+        }
+    }
+
+    u64Cycles += DWT->CYCCNT - u32T0;
+    UHC_GetStats(&stcS1);
+
+    if ((stcUms.u8StreamErr != 0U) || (stcUms.u8Ready == 0U)) {
+        UMS_StreamClose();
+        return LL_ERR;
+    }
+
+    UMS_StreamClose();
+
+    pstcResult->u32Bytes = u32Bytes;
+    pstcResult->u32Cycles = (u64Cycles > 0xFFFFFFFFULL) ? 0xFFFFFFFFUL : (uint32_t)u64Cycles;
+    pstcResult->u32Bps = (u64Cycles != 0ULL) ? (uint32_t)((uint64_t)u32Bytes * SystemCoreClock / u64Cycles) : 0UL;
+    pstcResult->u32CpuPermille = (u64Cycles != 0ULL) ?
+                                 (uint32_t)((stcS1.u64IrqCycles - stcS0.u64IrqCycles) * 1000ULL / u64Cycles) : 0UL;
+
+    return LL_OK;
+}
+
+static void UHD_Arm(void) {
+    stcUhd.stcUrb.pstcPipe = &stcUhd.stcIn;
+    stcUhd.stcUrb.pu8Buf = (uint8_t *)stcUhd.au32Buf;
+    stcUhd.stcUrb.u32Len = (stcUhd.stcIn.u16Mps > UHD_REPORT_MAX) ? UHD_REPORT_MAX : stcUhd.stcIn.u16Mps;
+
+    stcUhd.u8Ready = (UHC_Submit(&stcUhd.stcUrb) == LL_OK) ? 1U : 0U;
+}
+
+static void UHD_CtrlDone(stc_uhc_urb_t *pstcUrb) {
+    /* SET_IDLE is optional (STALL) */
+    if ((pstcUrb->u8Result == UHC_RES_NODEV) || (pstcUrb->u8Result == UHC_RES_CANCEL)) {
+        return;
+    }
+
+    stcUhd.stcIn.u8Toggle = 0U;
+    UHD_Arm();
+}
+
+static void UHD_ReportDone(stc_uhc_urb_t *pstcUrb) {
+    switch (pstcUrb->u8Result) {
+        case UHC_RES_OK:
+            stcUhd.u32Reports++;
+
+            if (stcUhd.pfnReport != NULL) {
+                stcUhd.pfnReport((const uint8_t *)stcUhd.au32Buf, pstcUrb->u32Actual);
+            }
+
+            UHD_Arm();
+            break;
+
+        case UHC_RES_STALL:
+            stcUhd.u8Ready = (UHC_Control(&stcUhd.stcCtrl, 0x02U, UHC_REQ_CLEAR_FEATURE, 0U, stcUhd.stcIn.u8Ep,
+                                          NULL, 0U) == LL_OK) ? 1U : 0U;
+            break;
+
+        case UHC_RES_ERROR:
+            UHD_Arm();
+            break;
+
+        default:
+            stcUhd.u8Ready = 0U;
+            break;
+    }
+}
+
+static uint32_t UHD_Probe(const uint8_t *pu8Intf, uint32_t u32Len) {
+    const uint8_t *pu8In;
+
+    if (pu8Intf[5] != 0x03U) {
+        return 0UL;
+    }
+
+    pu8In = UHC_FindEp(pu8Intf, u32Len, UHC_EP_INT, UHC_EP_IN);
+
+    if ((pu8In == NULL) || (UHC_PipeInit(&stcUhd.stcIn, pu8In) != LL_OK)) {
+        return 0UL;
+    }
+
+    stcUhd.u8Intf = pu8Intf[2];
+    stcUhd.u8Protocol = (pu8Intf[6] == 0x01U) ? pu8Intf[7] : UHD_PROTO_NONE;    /* Boot interface subclass */
+
+    return 1UL;
+}
+
+static void UHD_Start(void) {
+    stcUhd.stcUrb.pfnDone = UHD_ReportDone;
+    stcUhd.stcCtrl.pfnDone = UHD_CtrlDone;
+
+    /* SET_IDLE(0): reports only when they change */
+    (void)UHC_Control(&stcUhd.stcCtrl, 0x21U, 0x0AU, 0U, stcUhd.u8Intf, NULL, 0U);
+}
+
+static void UHD_Stop(void) {
+    stcUhd.u8Ready = 0U;
+}
+
+const stc_uhc_class_t stcUhdClass = {UHD_Probe, UHD_Start, NULL, UHD_Stop, NULL};
+
+/**
+ * @brief  Set the report callback, called from UHC_IrqHandler.
+ * @param  [in] pfnReport               Callback, NULL to only count reports.
+ * @retval None
+ */
+void UHD_SetCallback(func_uhd_report_t pfnReport) {
+    stcUhd.pfnReport = pfnReport;
+}
+
+/**
+ * @brief  Check whether a HID device is being polled.
+ * @param  None
+ * @retval An @ref en_flag_status_t enumeration value.
+ */
+en_flag_status_t UHD_IsReady(void) {
+    return (stcUhd.u8Ready != 0U) ? SET : RESET;
+}
+
+/**
+ * @brief  Boot protocol of the HID interface.
+ * @param  None
+ * @retval UHD_PROTO_NONE/KEYBOARD/MOUSE.
+ */
+uint8_t UHD_GetProtocol(void) {
+    return stcUhd.u8Protocol;
+}
+
+/**
+ * @brief  Reports received.
+ * @param  None
+ * @retval Count.
+ */
+uint32_t UHD_GetReports(void) {
+    return stcUhd.u32Reports;
+}
@@ -0,0 +1,112 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : usbh_class.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : Mass storage (BOT/SCSI) and HID class drivers on usbh_core: sequential reads through two
+  *				   multi-block read-ahead buffers with the command phases chained in the USB interrupt
+  * Function List:
+  *		UMS_IsReady
+  *		UMS_GetInfo
+  *		UMS_Read
+  *		UMS_Write
+  *		UMS_GetStatus
+  *		UMS_StreamOpen
+  *		UMS_StreamRead
+  *		UMS_StreamDone
+  *		UMS_StreamIsEnd
+  *		UMS_StreamClose
+  *		UMS_GetStats
+  *		UMS_Bench
+  *		UHD_SetCallback
+  *		UHD_IsReady
+  *		UHD_GetProtocol
+  *		UHD_GetReports
+  ******************************************************
+**/
+
+#ifndef __USBH_CLASS_H_
+#define __USBH_CLASS_H_
+
+#include "usbh_core.h"
+
+#define UMS_BLOCK_MAX               (512UL)     /*!< Largest block size supported */
+#define UMS_RA_BLOCKS               (16UL)      /*!< Blocks per read-ahead buffer, two buffers */
+#define UMS_TUR_TRIES               (50U)       /*!< TEST UNIT READY tries, 100ms apart */
+
+/* State of UMS_Read/UMS_Write */
+#define UMS_ST_IDLE                 (0U)
+#define UMS_ST_BUSY                 (1U)
+#define UMS_ST_OK                   (2U)
+#define UMS_ST_FAIL                 (3U)
+
+#define UHD_REPORT_MAX              (64UL)
+
+/* HID boot protocol */
+#define UHD_PROTO_NONE              (0U)
+#define UHD_PROTO_KEYBOARD          (1U)
+#define UHD_PROTO_MOUSE             (2U)
+
+/**
+ * @brief Medium capacity and INQUIRY strings.
+ */
+typedef struct {
+    uint32_t u32Blocks;
+    uint32_t u32BlockSize;
+    char acVendor[9];
+    char acProduct[17];
+} stc_ums_info_t;
+
+/**
+ * @brief Mass storage statistics.
+ */
+typedef struct {
+    uint32_t u32Commands;           /*!< SCSI commands completed */
+    uint32_t u32ReadBlocks;
+    uint32_t u32WriteBlocks;
+    uint32_t u32Errors;             /*!< Failed commands */
+    uint32_t u32Resets;             /*!< BOT reset recoveries */
+    uint32_t u32Starved;            /*!< Both read-ahead buffers held by the application, bus idle */
+} stc_ums_stats_t;
+
+/**
+ * @brief Result of UMS_Bench.
+ */
+typedef struct {
+    uint32_t u32Bytes;
+    uint32_t u32Cycles;             /*!< Core cycles from open to the last buffer */
+    uint32_t u32Bps;                /*!< Bytes per second */
+    uint32_t u32CpuPermille;        /*!< Share of the cycles spent in UHC_IrqHandler, 1/1000 */
+} stc_ums_bench_t;
+
+typedef void (*func_uhd_report_t)(const uint8_t *pu8Report, uint32_t u32Len);
+
+extern const stc_uhc_class_t stcUmsClass;   /*!< Register with UHC_RegisterClass */
+extern const stc_uhc_class_t stcUhdClass;
+
+en_flag_status_t UMS_IsReady(void);
+void UMS_GetInfo(stc_ums_info_t *pstcInfo);
+int32_t UMS_Read(uint32_t u32Lba, uint32_t u32Count, uint8_t *pu8Buf);
+int32_t UMS_Write(uint32_t u32Lba, uint32_t u32Count, const uint8_t *pu8Buf);
+uint8_t UMS_GetStatus(void);
+int32_t UMS_StreamOpen(uint32_t u32Lba, uint32_t u32Blocks);
+uint32_t UMS_StreamRead(const uint8_t **ppu8Data);
+void UMS_StreamDone(void);
+en_flag_status_t UMS_StreamIsEnd(void);
+void UMS_StreamClose(void);
+void UMS_GetStats(stc_ums_stats_t *pstcStats);
+int32_t UMS_Bench(uint32_t u32Lba, uint32_t u32Blocks, stc_ums_bench_t *pstcResult);
+
+void UHD_SetCallback(func_uhd_report_t pfnReport);
+en_flag_status_t UHD_IsReady(void);
+uint8_t UHD_GetProtocol(void);
+uint32_t UHD_GetReports(void);
+
+#endif
@@ -0,0 +1,1637 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : usbh_core.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					USBFS host in slave (FIFO) mode. Every pipe owns one host channel, so the
+					core schedules the pipes itself: a channel transfer covers as many packets
+					of the URB as fit (IN: up to UHC_PKT_MAX, OUT: what the Tx FIFO and its
+					request queue can take), IN packets are copied out of the Rx FIFO as they
+					arrive and a bulk/control IN NAK just re-enables the channel. The channel
+					interrupts then advance the URB: next chunk, next control stage, or
+					completion. Interrupt pipes wait in a list until their bInterval frame and
+					are started for the next (odd/even) frame; an OUT pipe that finds no FIFO
+					space waits in the same list for the Tx FIFO empty interrupt.
+					NAKed OUT, STALL and errors halt the channel and are handled on CHH, so
+					the toggle (HCTSIZ.DPID) and the acknowledged packets are read back from
+					a stopped channel. Lists shared with the application are only changed
+					with the USB interrupt disabled in the NVIC, never with global masking.
+					Debounce, port reset and enumeration run step by step from UHC_Task
+					with an endpoint 0 URB, then each interface goes to a class driver.
+					The LL USB driver is disabled in hc32f4xx_conf.h and needs the USB
+					middleware's usb_app_conf.h, so the core registers are driven directly.
+					With UHC_DMA_ENABLE the internal DMA moves the data between the FIFOs
+					and HCDMA instead: no Rx FIFO interrupt, no Tx FIFO space checks, the
+					core retries NAKed bulk/control transactions itself and only CHH is
+					unmasked, HCINT then tells how the transfer ended and HCTSIZ how much
+					came in. The DMA needs word addresses and writes whole IN packets, so
+					an unaligned buffer, or the last packet of an IN URB that does not
+					fill it, goes through a small per-channel bounce buffer; the core has
+					no data cache, nothing else is needed to hand a buffer over.
+  * Function List:
+  *		UHC_Init
+  *		UHC_RegisterClass
+  *		UHC_Task
+  *		UHC_State
+  *		UHC_DevDesc
+  *		UHC_FindEp
+  *		UHC_PipeInit
+  *		UHC_Submit
+  *		UHC_Control
+  *		UHC_Cancel
+  *		UHC_Wake
+  *		UHC_Frame
+  *		UHC_IrqHandler
+  *		UHC_GetStats
+  **********************************************************
+ */
+
+#include "usbh_core.h"
+#include <string.h>
+
+/* Host channel registers, 0x20 apart from HCCHAR0 */
+typedef struct {
+    __IO uint32_t HCCHAR;
+    uint32_t RESERVED0;
+    __IO uint32_t HCINT;
+    __IO uint32_t HCINTMSK;
+    __IO uint32_t HCTSIZ;
+    __IO uint32_t HCDMA;
+    uint32_t RESERVED1[2];
+} stc_uhc_ch_t;
+
+#define UHC_CH(n)                   ((stc_uhc_ch_t *)((uint32_t)&CM_USBFS->HCCHAR0 + ((uint32_t)(n) * 0x20UL)))
+#define UHC_FIFO(n)                 ((__IO uint32_t *)(CM_USBFS_BASE + 0x1000UL + ((uint32_t)(n) * 0x1000UL)))
+
+#if (UHC_DMA_ENABLE == DDL_ON)
+#define UHC_HCINT_MASK              (USBFS_HCINTMSK_CHHM | USBFS_HCINTMSK_AHBERRM)
+#define UHC_GINT_MASK               (USBFS_GINTMSK_HPRTIM | USBFS_GINTMSK_HCIM | USBFS_GINTMSK_DISCIM)
+#else
+#define UHC_HCINT_MASK              (USBFS_HCINTMSK_XFRCM | USBFS_HCINTMSK_CHHM | USBFS_HCINTMSK_STALLM | \
+                                     USBFS_HCINTMSK_NAKM | USBFS_HCINTMSK_TXERRM | USBFS_HCINTMSK_BBERRM | \
+                                     USBFS_HCINTMSK_FRMORM | USBFS_HCINTMSK_DTERRM)
+#define UHC_GINT_MASK               (USBFS_GINTMSK_RXFNEM | USBFS_GINTMSK_HPRTIM | USBFS_GINTMSK_HCIM | \
+                                     USBFS_GINTMSK_DISCIM)
+#endif
+#define UHC_HBSTLEN_INCR8           (5UL)
+#define UHC_HPRT_W1C                (USBFS_HPRT_PENA | USBFS_HPRT_PCDET | USBFS_HPRT_PENCHNG)
+
+#define UHC_DPID_DATA0              (0UL)
+#define UHC_DPID_DATA1              (2UL)
+#define UHC_DPID_SETUP              (3UL)
+
+#define UHC_PKTSTS_IN_DATA          (2UL)
+#define UHC_PSPD_LS                 (2UL)
+#define UHC_FSLSPCS_48MHZ           (1UL)
+#define UHC_FSLSPCS_6MHZ            (2UL)
+
+/* Control transfer stage */
+#define UHC_STAGE_SETUP             (0U)
+#define UHC_STAGE_DATA              (1U)
+#define UHC_STAGE_STATUS            (2U)
+
+/* Pipe state */
+#define UHC_PIPE_IDLE               (0U)        /*!< No URB */
+#define UHC_PIPE_WAIT               (1U)        /*!< In the waiting list */
+#define UHC_PIPE_BUSY               (2U)        /*!< Channel enabled */
+#define UHC_PIPE_HALT               (3U)        /*!< Channel disable requested, waiting for CHH */
+
+/* Why a channel stopped */
+#define UHC_HALT_DONE               (0U)
+#define UHC_HALT_NAK                (1U)
+#define UHC_HALT_ERR                (2U)
+#define UHC_HALT_TOGGLE             (3U)
+#define UHC_HALT_STALL              (4U)
+#define UHC_HALT_CANCEL             (5U)
+
+/* UHC_Task step */
+#define UHC_STEP_IDLE               (0U)
+#define UHC_STEP_DEBOUNCE           (1U)
+#define UHC_STEP_RESET              (2U)
+#define UHC_STEP_RESET_WAIT         (3U)
+#define UHC_STEP_RECOVER            (4U)
+#define UHC_STEP_DEV8               (5U)
+#define UHC_STEP_ADDR               (6U)
+#define UHC_STEP_ADDR_WAIT          (7U)
+#define UHC_STEP_DEV18              (8U)
+#define UHC_STEP_CFG9               (9U)
+#define UHC_STEP_CFG                (10U)
+#define UHC_STEP_SETCFG             (11U)
+#define UHC_STEP_READY              (12U)
+#define UHC_STEP_ERROR              (13U)
+
+#define UHC_ENUM_TRIES              (3U)
+#define UHC_ENUM_TIMEOUT            (500UL)     /*!< ms, one enumeration request */
+
+#define UHC_REQ_GET_DESCRIPTOR      (6U)
+#define UHC_REQ_SET_ADDRESS         (5U)
+#define UHC_REQ_SET_CONFIGURATION   (9U)
+#define UHC_DESC_DEVICE             (1U)
+#define UHC_DESC_CONFIG             (2U)
+#define UHC_DESC_INTERFACE          (4U)
+#define UHC_DESC_ENDPOINT           (5U)
+
+static IRQn_Type enUhcIRQn;
+static stc_uhc_pipe_t stcUhcEp0;
+static stc_uhc_urb_t stcUhcEnumUrb;
+static uint32_t au32UhcDevDesc[20UL / 4UL];
+static uint32_t au32UhcCfg[UHC_CFG_MAX / 4UL];
+static uint32_t u32UhcCfgLen;
+
+static const stc_uhc_class_t *apstcUhcClass[UHC_CLASS_MAX];
+static uint8_t au8UhcBound[UHC_CLASS_MAX];
+static uint32_t u32UhcClassNum;
+
+static stc_uhc_pipe_t *apstcUhcCh[UHC_CH_NUM];     /* Pipe of each channel */
+#if (UHC_DMA_ENABLE == DDL_ON)
+static uint32_t au32UhcBounce[UHC_CH_NUM][UHC_DMA_BOUNCE / 4UL];
+#endif
+static uint32_t u32UhcChUsed;
+static stc_uhc_pipe_t *pstcUhcWait;                 /* Pipes with a URB that is not on its channel yet */
+
+static uint8_t u8UhcLowSpeed;
+static __IO uint8_t u8UhcAttached;                  /* Port enabled, channels may run */
+static __IO uint8_t u8UhcIrqActive;
+static __IO uint8_t u8UhcState;
+static uint8_t u8UhcStep;
+static uint8_t u8UhcTries;
+static uint32_t u32UhcT0;
+static stc_uhc_stats_t stcUhcStats;
+
+static uint32_t UHC_Ms(uint32_t u32T0) {
+    return (DWT->CYCCNT - u32T0) / (SystemCoreClock / 1000UL);
+}
+
+/**
+ * @brief  Disable only the USB interrupt; returns whether it was enabled.
+ */
+static uint32_t UHC_Lock(void) {
+    uint32_t u32En = NVIC_GetEnableIRQ(enUhcIRQn);
+
+    NVIC_DisableIRQ(enUhcIRQn);
+    __DSB();
+    __ISB();
+
+    return u32En;
+}
+
+static void UHC_Unlock(uint32_t u32En) {
+    if (u32En != 0UL) {
+        NVIC_EnableIRQ(enUhcIRQn);
+    }
+}
+
+/**
+ * @brief  Modify HPRT without writing 1 to its write-1-to-clear bits (PENA would disable the port).
+ */
+static void UHC_SetHprt(uint32_t u32Clr, uint32_t u32Set) {
+    CM_USBFS->HPRT = (CM_USBFS->HPRT & ~(UHC_HPRT_W1C | u32Clr)) | u32Set;
+}
+
+static void UHC_FifoFlush(void) {
+    uint32_t u32Count;
+
+    CM_USBFS->GRSTCTL = USBFS_GRSTCTL_TXFFLSH | (0x10UL << USBFS_GRSTCTL_TXFNUM_POS);
+
+    for (u32Count = 0UL; ((CM_USBFS->GRSTCTL & USBFS_GRSTCTL_TXFFLSH) != 0UL) && (u32Count < 100000UL); u32Count++) {
+    }
+
+    CM_USBFS->GRSTCTL = USBFS_GRSTCTL_RXFFLSH;
+
+    for (u32Count = 0UL; ((CM_USBFS->GRSTCTL & USBFS_GRSTCTL_RXFFLSH) != 0UL) && (u32Count < 100000UL); u32Count++) {
+    }
+}
+
+#if (UHC_DMA_ENABLE == DDL_OFF)
+/**
+ * @brief  Push u32Len bytes into the Tx FIFO of a channel; an unaligned source is assembled into words.
+ */
+static void UHC_FifoWrite(uint32_t u32Ch, const uint8_t *pu8Src, uint32_t u32Len) {
+    __IO uint32_t *FIFOx = UHC_FIFO(u32Ch);
+    const uint32_t *pu32Src;
+    uint32_t u32Word;
+    uint32_t i;
+
+    if (((uint32_t)pu8Src & 3UL) == 0UL) {
+        pu32Src = (const uint32_t *)pu8Src;
+
+        for (; u32Len >= 16UL; u32Len -= 16UL, pu32Src += 4) {
+            *FIFOx = pu32Src[0];
+            *FIFOx = pu32Src[1];
+            *FIFOx = pu32Src[2];
+            *FIFOx = pu32Src[3];
+        }
+
+        for (; u32Len >= 4UL; u32Len -= 4UL) {
+            *FIFOx = *pu32Src++;
+        }
+
+        pu8Src = (const uint8_t *)pu32Src;
+    } else {
+        for (; u32Len >= 4UL; u32Len -= 4UL, pu8Src += 4) {
+            *FIFOx = (uint32_t)pu8Src[0] | ((uint32_t)pu8Src[1] << 8) |
+                     ((uint32_t)pu8Src[2] << 16) | ((uint32_t)pu8Src[3] << 24);
+        }
+    }
+
+    if (u32Len > 0UL) {
+        for (u32Word = 0UL, i = 0UL; i < u32Len; i++) {
+            u32Word |= (uint32_t)pu8Src[i] << (i * 8UL);
+        }
+
+        *FIFOx = u32Word;
+    }
+}
+
+/**
+ * @brief  Pop a u32Count byte packet from the Rx FIFO, keeping its first u32Len bytes.
+ */
+static void UHC_FifoRead(uint8_t *pu8Dst, uint32_t u32Len, uint32_t u32Count) {
+    __IO uint32_t *FIFOx = UHC_FIFO(0UL);
+    uint32_t u32Words = (u32Count + 3UL) / 4UL;
+    uint32_t *pu32Dst;
+    uint32_t u32Word;
+
+    if (((uint32_t)pu8Dst & 3UL) == 0UL) {
+        pu32Dst = (uint32_t *)pu8Dst;
+
+        for (; u32Len >= 16UL; u32Len -= 16UL, u32Words -= 4UL, pu32Dst += 4) {
+            pu32Dst[0] = *FIFOx;
+            pu32Dst[1] = *FIFOx;
+            pu32Dst[2] = *FIFOx;
+            pu32Dst[3] = *FIFOx;
+        }
+
+        for (; u32Len >= 4UL; u32Len -= 4UL, u32Words--) {
+            *pu32Dst++ = *FIFOx;
+        }
+
+        pu8Dst = (uint8_t *)pu32Dst;
+    } else {
+        for (; u32Len >= 4UL; u32Len -= 4UL, u32Words--, pu8Dst += 4) {
+            u32Word = *FIFOx;
+            pu8Dst[0] = (uint8_t)u32Word;
+            pu8Dst[1] = (uint8_t)(u32Word >> 8);
+            pu8Dst[2] = (uint8_t)(u32Word >> 16);
+            pu8Dst[3] = (uint8_t)(u32Word >> 24);
+        }
+    }
+
+    if (u32Len > 0UL) {
+        u32Word = *FIFOx;
+        u32Words--;
+
+        for (; u32Len > 0UL; u32Len--, u32Word >>= 8) {
+            *pu8Dst++ = (uint8_t)u32Word;
+        }
+    }
+
+    /* Bytes beyond the URB buffer are dropped */
+    for (; u32Words > 0UL; u32Words--) {
+        (void)*FIFOx;
+    }
+}
+#endif
+
+static uint32_t UHC_IsIn(const stc_uhc_urb_t *pstcUrb) {
+    if (pstcUrb->pstcPipe->u8Type == UHC_EP_CTRL) {
+        return pstcUrb->au8Setup[0] & 0x80U;
+    }
+
+    return pstcUrb->pstcPipe->u8Ep & 0x80U;
+}
+
+static uint32_t UHC_Due(const stc_uhc_pipe_t *pstcPipe, uint32_t u32Frame) {
+    return (((u32Frame - pstcPipe->u16NextFrame) & UHC_FRAME_MASK) < ((UHC_FRAME_MASK + 1UL) / 2UL)) ? 1UL : 0UL;
+}
+
+/**
+ * @brief  Next poll of an interrupt pipe; more than one interval behind restarts from the current frame.
+ */
+static void UHC_NextPoll(stc_uhc_pipe_t *pstcPipe) {
+    uint32_t u32Frame = CM_USBFS->HFNUM & UHC_FRAME_MASK;
+
+    pstcPipe->u16NextFrame = (uint16_t)((pstcPipe->u16NextFrame + pstcPipe->u8Interval) & UHC_FRAME_MASK);
+
+    if (UHC_Due(pstcPipe, u32Frame) != 0UL) {
+        pstcPipe->u16NextFrame = (uint16_t)((u32Frame + pstcPipe->u8Interval) & UHC_FRAME_MASK);
+    }
+}
+
+static void UHC_WaitAdd(stc_uhc_pipe_t *pstcPipe) {
+    if (pstcPipe->u8State != UHC_PIPE_WAIT) {
+        pstcPipe->u8State = UHC_PIPE_WAIT;
+        pstcPipe->pstcNext = pstcUhcWait;
+        pstcUhcWait = pstcPipe;
+    }
+}
+
+static void UHC_WaitRemove(stc_uhc_pipe_t *pstcPipe) {
+    stc_uhc_pipe_t **ppstcPipe;
+
+    for (ppstcPipe = &pstcUhcWait; *ppstcPipe != NULL; ppstcPipe = &(*ppstcPipe)->pstcNext) {
+        if (*ppstcPipe == pstcPipe) {
+            *ppstcPipe = pstcPipe->pstcNext;
+            break;
+        }
+    }
+
+    pstcPipe->pstcNext = NULL;
+}
+
+/**
+ * @brief  Start the next channel transfer of the head URB; returns 0 if an OUT finds no Tx FIFO space.
+ *         With the DMA the buffer goes to HCDMA, through the bounce buffer if needed.
+ */
+static uint32_t UHC_Xfer(stc_uhc_pipe_t *pstcPipe) {
+    stc_uhc_urb_t *pstcUrb = pstcPipe->pstcHead;
+    stc_uhc_ch_t *CHx = UHC_CH(pstcPipe->u8Ch);
+    const uint8_t *pu8Data = NULL;
+    uint32_t u32Mps = pstcPipe->u16Mps;
+    uint32_t u32In;
+    uint32_t u32Len = 0UL;
+    uint32_t u32Pid = UHC_DPID_DATA1;
+    uint32_t u32Pkts;
+    uint32_t u32Max;
+#if (UHC_DMA_ENABLE == DDL_OFF)
+    uint32_t u32Sts;
+#endif
+    uint32_t u32Char;
+
+    if ((pstcPipe->u8Type == UHC_EP_CTRL) && (pstcUrb->u8Stage == UHC_STAGE_SETUP)) {
+        u32In = 0UL;
+        u32Len = 8UL;
+        u32Pid = UHC_DPID_SETUP;
+        pu8Data = pstcUrb->au8Setup;
+    } else if ((pstcPipe->u8Type == UHC_EP_CTRL) && (pstcUrb->u8Stage == UHC_STAGE_STATUS)) {
+        /* Opposite to the data stage, IN without one */
+        u32In = ((pstcUrb->u32Len != 0UL) && ((pstcUrb->au8Setup[0] & 0x80U) != 0U)) ? 0UL : 1UL;
+    } else {
+        u32In = UHC_IsIn(pstcUrb);
+        u32Len = pstcUrb->u32Len - pstcUrb->u32Actual;
+        u32Pid = (pstcPipe->u8Toggle != 0U) ? UHC_DPID_DATA1 : UHC_DPID_DATA0;
+        pu8Data = pstcUrb->pu8Buf + pstcUrb->u32Actual;
+    }
+
+    u32Pkts = (u32Len + u32Mps - 1UL) / u32Mps;
+
+    if (u32Pkts == 0UL) {
+        u32Pkts = 1UL;
+    } else if (u32Pkts > UHC_PKT_MAX) {
+        u32Pkts = UHC_PKT_MAX;
+        u32Len = u32Pkts * u32Mps;
+    } else {
+    }
+
+#if (UHC_DMA_ENABLE == DDL_ON)
+    /* The DMA takes the Tx FIFO space as it frees up; an IN chunk is whole packets, so a direct one
+       stops at the last packet that fits the URB buffer and the rest goes through the bounce buffer */
+    if ((u32In != 0UL) && (u32Len > 0UL) && ((u32Pkts * u32Mps) > u32Len) && (u32Len >= u32Mps)) {
+        u32Pkts = u32Len / u32Mps;
+    }
+
+    u32Max = (u32In != 0UL) ? (u32Pkts * u32Mps) : u32Len;
+    pstcPipe->u8Bounce = ((u32Len > 0UL) && ((((uint32_t)pu8Data & 3UL) != 0UL) || (u32Max > u32Len))) ? 1U : 0U;
+
+    if (pstcPipe->u8Bounce != 0U) {
+        if (u32Pkts > (UHC_DMA_BOUNCE / u32Mps)) {
+            u32Pkts = UHC_DMA_BOUNCE / u32Mps;
+        }
+
+        if (u32Len > (u32Pkts * u32Mps)) {
+            u32Len = u32Pkts * u32Mps;
+        }
+
+        if (u32In == 0UL) {
+            (void)memcpy(au32UhcBounce[pstcPipe->u8Ch], pu8Data, u32Len);
+        }
+
+        stcUhcStats.u32Bounce++;
+    }
+
+    /* The status stage has no buffer, a zero length IN still needs a valid address */
+    if ((pstcPipe->u8Bounce != 0U) || (pu8Data == NULL)) {
+        pu8Data = (const uint8_t *)au32UhcBounce[pstcPipe->u8Ch];
+    }
+
+    if (u32In != 0UL) {
+        u32Len = u32Pkts * u32Mps;
+    }
+#else
+    if (u32In != 0UL) {
+        u32Len = u32Pkts * u32Mps;
+    } else {
+        /* Whole packets that fit into the Tx FIFO and its request queue */
+        u32Sts = (pstcPipe->u8Type == UHC_EP_INT) ? CM_USBFS->HPTXSTS : CM_USBFS->HNPTXSTS;
+        u32Max = ((u32Sts & USBFS_HNPTXSTS_NPTXFSAV) * 4UL) / u32Mps;
+
+        if (u32Max > ((u32Sts & USBFS_HNPTXSTS_NPTQXSAV) >> USBFS_HNPTXSTS_NPTQXSAV_POS)) {
+            u32Max = (u32Sts & USBFS_HNPTXSTS_NPTQXSAV) >> USBFS_HNPTXSTS_NPTQXSAV_POS;
+        }
+
+        if (u32Len == 0UL) {
+            if ((u32Sts & USBFS_HNPTXSTS_NPTQXSAV) == 0UL) {
+                stcUhcStats.u32FifoWait++;
+                return 0UL;
+            }
+        } else if (u32Pkts > u32Max) {
+            if (u32Max == 0UL) {
+                stcUhcStats.u32FifoWait++;
+                return 0UL;
+            }
+
+            u32Pkts = u32Max;
+            u32Len = u32Pkts * u32Mps;
+        } else {
+        }
+    }
+#endif
+
+    pstcPipe->u16Pkts = (uint16_t)u32Pkts;
+    pstcPipe->u32XferLen = u32Len;
+    pstcPipe->u32RxLen = 0UL;
+    pstcPipe->u8State = UHC_PIPE_BUSY;
+
+    CHx->HCINT = 0xFFFFFFFFUL;
+    CHx->HCINTMSK = UHC_HCINT_MASK;
+    CHx->HCTSIZ = (u32Len << USBFS_HCTSIZ_XFRSIZ_POS) | (u32Pkts << USBFS_HCTSIZ_PKTCNT_POS) |
+                  (u32Pid << USBFS_HCTSIZ_DPID_POS);
+#if (UHC_DMA_ENABLE == DDL_ON)
+    CHx->HCDMA = (uint32_t)pu8Data;
+#endif
+
+    u32Char = (u32Mps << USBFS_HCCHAR_MPSIZ_POS) |
+              (((uint32_t)pstcPipe->u8Ep & 0x0FUL) << USBFS_HCCHAR_EPNUM_POS) |
+              (u32In << USBFS_HCCHAR_EPDIR_POS) |
+              ((uint32_t)pstcPipe->u8Type << USBFS_HCCHAR_EPTYP_POS) |
+              ((uint32_t)pstcPipe->u8Addr << USBFS_HCCHAR_DAD_POS) |
+              USBFS_HCCHAR_CHENA;
+
+    if (u8UhcLowSpeed != 0U) {
+        u32Char |= USBFS_HCCHAR_LSDEV;
+    }
+
+    /* A periodic channel runs in the frame selected by ODDFRM: the next one */
+    if (pstcPipe->u8Type == UHC_EP_INT) {
+        u32Char |= ((CM_USBFS->HFNUM + 1UL) & 1UL) << USBFS_HCCHAR_ODDFRM_POS;
+        stcUhcStats.u32Polls++;
+    }
+
+    CHx->HCCHAR = u32Char;
+
+#if (UHC_DMA_ENABLE == DDL_OFF)
+    if ((u32In == 0UL) && (u32Len > 0UL)) {
+        UHC_FifoWrite(pstcPipe->u8Ch, pu8Data, u32Len);
+    }
+#endif
+
+    stcUhcStats.u32Xfers++;
+
+    return 1UL;
+}
+
+/**
+ * @brief  Continue the head URB of a pipe: interrupt pipes wait for their frame, others start at once.
+ */
+static void UHC_Resume(stc_uhc_pipe_t *pstcPipe) {
+    if ((u8UhcAttached == 0U) || (pstcPipe->u8Type == UHC_EP_INT) || (UHC_Xfer(pstcPipe) == 0UL)) {
+        UHC_WaitAdd(pstcPipe);
+    }
+}
+
+/**
+ * @brief  Take a URB off the head of its pipe and end it; the next one is started before the callback.
+ */
+static void UHC_Finish(stc_uhc_urb_t *pstcUrb, uint8_t u8Res) {
+    stc_uhc_pipe_t *pstcPipe = pstcUrb->pstcPipe;
+
+    pstcPipe->pstcHead = pstcUrb->pstcNext;
+    pstcPipe->u8State = UHC_PIPE_IDLE;
+
+    if (pstcPipe->pstcHead == NULL) {
+        pstcPipe->pstcTail = NULL;
+    } else {
+        UHC_Resume(pstcPipe);
+    }
+
+    pstcUrb->pstcNext = NULL;
+    pstcUrb->u8Result = (pstcUrb->u8Cancel != 0U) ? UHC_RES_CANCEL : u8Res;
+    pstcUrb->u8State = UHC_URB_DONE;
+
+    if ((pstcUrb->u8Cancel == 0U) && (pstcUrb->pfnDone != NULL)) {
+        pstcUrb->pfnDone(pstcUrb);
+    }
+}
+
+/**
+ * @brief  Stop all channels and end every queued URB.
+ */
+static void UHC_Flush(uint8_t u8Res) {
+    stc_uhc_pipe_t *pstcPipe;
+    uint32_t i;
+
+    for (i = 0UL; i < UHC_CH_NUM; i++) {
+        UHC_CH(i)->HCINTMSK = 0UL;
+        UHC_CH(i)->HCCHAR = USBFS_HCCHAR_CHDIS;
+        UHC_CH(i)->HCINT = 0xFFFFFFFFUL;
+    }
+
+    for (i = 0UL; i < UHC_CH_NUM; i++) {
+        pstcPipe = apstcUhcCh[i];
+
+        while ((pstcPipe != NULL) && (pstcPipe->pstcHead != NULL)) {
+            UHC_Finish(pstcPipe->pstcHead, u8Res);
+        }
+    }
+
+    for (i = 0UL; i < UHC_CH_NUM; i++) {
+        if (apstcUhcCh[i] != NULL) {
+            apstcUhcCh[i]->u8State = UHC_PIPE_IDLE;
+            apstcUhcCh[i]->pstcNext = NULL;
+        }
+    }
+
+    pstcUhcWait = NULL;
+    CM_USBFS->GINTMSK &= ~(USBFS_GINTMSK_NPTXFEM | USBFS_GINTMSK_PTXFEM);
+    UHC_FifoFlush();
+}
+
+#if (UHC_DMA_ENABLE == DDL_ON)
+/**
+ * @brief  Account what the DMA wrote for a stopped IN channel (HCTSIZ.XFRSIZ counts down per byte),
+ *         copying it out of the bounce buffer.
+ */
+static void UHC_DmaRx(stc_uhc_pipe_t *pstcPipe, stc_uhc_urb_t *pstcUrb, uint32_t u32Tsiz) {
+    uint32_t u32Count = pstcPipe->u32XferLen - ((u32Tsiz & USBFS_HCTSIZ_XFRSIZ) >> USBFS_HCTSIZ_XFRSIZ_POS);
+    uint32_t u32Len = pstcUrb->u32Len - pstcUrb->u32Actual;
+
+    if (u32Len > u32Count) {
+        u32Len = u32Count;
+    }
+
+    if ((pstcPipe->u8Bounce != 0U) && (u32Len > 0UL)) {
+        (void)memcpy(pstcUrb->pu8Buf + pstcUrb->u32Actual, au32UhcBounce[pstcPipe->u8Ch], u32Len);
+    }
+
+    pstcUrb->u32Actual += u32Len;
+    pstcPipe->u32RxLen = u32Count;
+    stcUhcStats.u32Bytes += u32Len;
+}
+
+/**
+ * @brief  Why a DMA channel halted, from its HCINT.
+ */
+static uint8_t UHC_DmaWhy(uint32_t u32Int) {
+    if ((u32Int & USBFS_HCINT_XFRC) != 0UL) {
+        return UHC_HALT_DONE;
+    }
+
+    if ((u32Int & USBFS_HCINT_STALL) != 0UL) {
+        return UHC_HALT_STALL;
+    }
+
+    if ((u32Int & USBFS_HCINT_DTERR) != 0UL) {
+        stcUhcStats.u32Errors++;
+        return UHC_HALT_TOGGLE;
+    }
+
+    /* HCINT accumulates: an error after NAKs must still count towards UHC_RETRY */
+    if ((u32Int & (USBFS_HCINT_TXERR | USBFS_HCINT_BBERR | USBFS_HCINT_FRMOR)) != 0UL) {
+        stcUhcStats.u32Errors++;
+        return UHC_HALT_ERR;
+    }
+
+    if ((u32Int & USBFS_HCINT_NAK) != 0UL) {
+        stcUhcStats.u32Naks++;
+        return UHC_HALT_NAK;
+    }
+
+    stcUhcStats.u32Errors++;
+
+    return UHC_HALT_ERR;
+}
+#endif
+
+/**
+ * @brief  The channel of a pipe has stopped: account acknowledged data and toggle, then continue.
+ */
+static void UHC_Stopped(stc_uhc_pipe_t *pstcPipe, uint8_t u8Why) {
+    stc_uhc_urb_t *pstcUrb = pstcPipe->pstcHead;
+    const stc_uhc_ch_t *CHx = UHC_CH(pstcPipe->u8Ch);
+    uint32_t u32Tsiz = CHx->HCTSIZ;
+    uint32_t u32In = CHx->HCCHAR & USBFS_HCCHAR_EPDIR;
+    uint32_t u32Acked;
+    uint32_t u32More;
+
+    pstcPipe->u8State = UHC_PIPE_IDLE;
+
+    if (pstcUrb == NULL) {
+        return;
+    }
+
+    if ((pstcUrb->u8Cancel != 0U) || (u8Why == UHC_HALT_CANCEL)) {
+        UHC_Finish(pstcUrb, UHC_RES_CANCEL);
+        return;
+    }
+
+    if (pstcUrb->u8Stage == UHC_STAGE_SETUP) {
+        if (u8Why == UHC_HALT_DONE) {
+            pstcUrb->u8Errors = 0U;
+            pstcPipe->u8Toggle = 1U;
+            pstcUrb->u8Stage = (pstcUrb->u32Len != 0UL) ? UHC_STAGE_DATA : UHC_STAGE_STATUS;
+            UHC_Resume(pstcPipe);
+            return;
+        }
+    } else if (pstcUrb->u8Stage == UHC_STAGE_STATUS) {
+        if (u8Why == UHC_HALT_DONE) {
+            UHC_Finish(pstcUrb, UHC_RES_OK);
+            return;
+        }
+    } else {
+        /* Data: IN bytes were copied as they arrived (DMA: are counted now), OUT counts the acknowledged packets */
+        pstcPipe->u8Toggle = (((u32Tsiz & USBFS_HCTSIZ_DPID) >> USBFS_HCTSIZ_DPID_POS) == UHC_DPID_DATA1) ? 1U : 0U;
+
+#if (UHC_DMA_ENABLE == DDL_ON)
+        if (u32In != 0UL) {
+            UHC_DmaRx(pstcPipe, pstcUrb, u32Tsiz);
+        }
+#endif
+
+        if (u32In == 0UL) {
+            u32Acked = (pstcPipe->u16Pkts - ((u32Tsiz & USBFS_HCTSIZ_PKTCNT) >> USBFS_HCTSIZ_PKTCNT_POS)) * pstcPipe->u16Mps;
+
+            if (u32Acked > pstcPipe->u32XferLen) {
+                u32Acked = pstcPipe->u32XferLen;
+            }
+
+            pstcUrb->u32Actual += u32Acked;
+            stcUhcStats.u32Bytes += u32Acked;
+
+            /* Every packet acknowledged before the halt took effect */
+            if ((u32Tsiz & USBFS_HCTSIZ_PKTCNT) == 0UL) {
+                u8Why = UHC_HALT_DONE;
+            }
+        }
+
+        if (u8Why == UHC_HALT_DONE) {
+            pstcUrb->u8Errors = 0U;
+
+            if (pstcPipe->u8Type == UHC_EP_INT) {
+                UHC_NextPoll(pstcPipe);
+            }
+
+            /* A short packet ends the transfer */
+            u32More = (u32In == 0UL) || (pstcPipe->u32RxLen == pstcPipe->u32XferLen);
+
+            if ((u32More != 0UL) && (pstcUrb->u32Actual < pstcUrb->u32Len)) {
+                UHC_Resume(pstcPipe);
+            } else if (pstcPipe->u8Type == UHC_EP_CTRL) {
+                pstcUrb->u8Stage = UHC_STAGE_STATUS;
+                pstcPipe->u8Toggle = 1U;
+                UHC_Resume(pstcPipe);
+            } else {
+                UHC_Finish(pstcUrb, UHC_RES_OK);
+            }
+
+            return;
+        }
+    }
+
+    switch (u8Why) {
+        case UHC_HALT_NAK:
+            if (pstcPipe->u8Type == UHC_EP_INT) {
+                UHC_NextPoll(pstcPipe);
+            }
+
+            UHC_Resume(pstcPipe);
+            break;
+
+        case UHC_HALT_STALL:
+            UHC_Finish(pstcUrb, UHC_RES_STALL);
+            break;
+
+        case UHC_HALT_TOGGLE:
+            /* The device repeated a packet it had already sent; it is dropped, try again */
+            UHC_Resume(pstcPipe);
+            break;
+
+        default:
+            if (++pstcUrb->u8Errors > UHC_RETRY) {
+                UHC_Finish(pstcUrb, UHC_RES_ERROR);
+            } else {
+                if (pstcPipe->u8Type == UHC_EP_INT) {
+                    UHC_NextPoll(pstcPipe);
+                }
+
+                UHC_Resume(pstcPipe);
+            }
+            break;
+    }
+}
+
+/**
+ * @brief  Stop the channel of a pipe; still enabled means halting it and finishing on CHH.
+ */
+static void UHC_Stop(stc_uhc_pipe_t *pstcPipe, uint8_t u8Why) {
+    stc_uhc_ch_t *CHx = UHC_CH(pstcPipe->u8Ch);
+
+    if ((CHx->HCCHAR & USBFS_HCCHAR_CHENA) != 0UL) {
+        pstcPipe->u8Halt = u8Why;
+        pstcPipe->u8State = UHC_PIPE_HALT;
+        CHx->HCCHAR |= USBFS_HCCHAR_CHENA | USBFS_HCCHAR_CHDIS;
+    } else {
+        UHC_Stopped(pstcPipe, u8Why);
+    }
+}
+
+static void UHC_ChIrq(uint32_t u32Ch) {
+    stc_uhc_ch_t *CHx = UHC_CH(u32Ch);
+    stc_uhc_pipe_t *pstcPipe = apstcUhcCh[u32Ch];
+#if (UHC_DMA_ENABLE == DDL_ON)
+    /* Only CHH and AHBERR interrupt, the other flags tell how the transfer ended */
+    uint32_t u32Int = CHx->HCINT;
+#else
+    uint32_t u32Int = CHx->HCINT & CHx->HCINTMSK;
+#endif
+
+    CHx->HCINT = u32Int;
+
+    if (pstcPipe == NULL) {
+        return;
+    }
+
+    if (pstcPipe->u8State == UHC_PIPE_HALT) {
+        if ((u32Int & USBFS_HCINT_CHH) != 0UL) {
+            UHC_Stopped(pstcPipe, pstcPipe->u8Halt);
+        }
+
+        return;
+    }
+
+    if (pstcPipe->u8State != UHC_PIPE_BUSY) {
+        return;
+    }
+
+#if (UHC_DMA_ENABLE == DDL_ON)
+    if ((u32Int & USBFS_HCINT_CHH) != 0UL) {
+        UHC_Stopped(pstcPipe, ((u32Int & USBFS_HCINT_AHBERR) != 0UL) ? UHC_HALT_ERR : UHC_DmaWhy(u32Int));
+    } else if ((u32Int & USBFS_HCINT_AHBERR) != 0UL) {
+        stcUhcStats.u32Errors++;
+        UHC_Stop(pstcPipe, UHC_HALT_ERR);
+    } else {
+    }
+#else
+    if ((u32Int & USBFS_HCINT_XFRC) != 0UL) {
+        UHC_Stop(pstcPipe, UHC_HALT_DONE);
+    } else if ((u32Int & USBFS_HCINT_STALL) != 0UL) {
+        UHC_Stop(pstcPipe, UHC_HALT_STALL);
+    } else if ((u32Int & USBFS_HCINT_DTERR) != 0UL) {
+        stcUhcStats.u32Errors++;
+        UHC_Stop(pstcPipe, UHC_HALT_TOGGLE);
+    } else if ((u32Int & (USBFS_HCINT_TXERR | USBFS_HCINT_BBERR | USBFS_HCINT_FRMOR)) != 0UL) {
+        stcUhcStats.u32Errors++;
+        UHC_Stop(pstcPipe, UHC_HALT_ERR);
+    } else if ((u32Int & USBFS_HCINT_NAK) != 0UL) {
+        stcUhcStats.u32Naks++;
+
+        if ((pstcPipe->u8Type != UHC_EP_INT) && ((CHx->HCCHAR & USBFS_HCCHAR_EPDIR) != 0UL)) {
+            /* Bulk/control IN: ask again */
+            CHx->HCCHAR = (CHx->HCCHAR & ~USBFS_HCCHAR_CHDIS) | USBFS_HCCHAR_CHENA;
+        } else {
+            UHC_Stop(pstcPipe, UHC_HALT_NAK);
+        }
+    } else if ((u32Int & USBFS_HCINT_CHH) != 0UL) {
+        UHC_Stopped(pstcPipe, UHC_HALT_ERR);
+    } else {
+    }
+#endif
+}
+
+#if (UHC_DMA_ENABLE == DDL_OFF)
+/**
+ * @brief  Drain the Rx FIFO into the buffers of the running IN transfers.
+ */
+static void UHC_RxIrq(void) {
+    stc_uhc_pipe_t *pstcPipe;
+    stc_uhc_urb_t *pstcUrb;
+    stc_uhc_ch_t *CHx;
+    uint32_t u32Sts;
+    uint32_t u32Ch;
+    uint32_t u32Count;
+    uint32_t u32Len;
+
+    while ((CM_USBFS->GINTSTS & USBFS_GINTSTS_RXFNE) != 0UL) {
+        u32Sts = CM_USBFS->GRXSTSP;
+        u32Ch = u32Sts & USBFS_GRXSTSP_CHNUM_EPNUM;
+        u32Count = (u32Sts & USBFS_GRXSTSP_BCNT) >> USBFS_GRXSTSP_BCNT_POS;
+
+        if ((((u32Sts & USBFS_GRXSTSP_PKTSTS) >> USBFS_GRXSTSP_PKTSTS_POS) != UHC_PKTSTS_IN_DATA) || (u32Count == 0UL)) {
+            continue;
+        }
+
+        pstcPipe = (u32Ch < UHC_CH_NUM) ? apstcUhcCh[u32Ch] : NULL;
+
+        /* A halting channel may still have packets in the FIFO; they count, the toggle has moved on */
+        if ((pstcPipe == NULL) || (pstcPipe->pstcHead == NULL) || (pstcPipe->pstcHead->u8Cancel != 0U) ||
+            ((pstcPipe->u8State != UHC_PIPE_BUSY) && (pstcPipe->u8State != UHC_PIPE_HALT))) {
+            UHC_FifoRead(NULL, 0UL, u32Count);
+            continue;
+        }
+
+        pstcUrb = pstcPipe->pstcHead;
+        u32Len = pstcUrb->u32Len - pstcUrb->u32Actual;
+
+        if (u32Len > u32Count) {
+            u32Len = u32Count;
+        }
+
+        UHC_FifoRead(pstcUrb->pu8Buf + pstcUrb->u32Actual, u32Len, u32Count);
+        pstcUrb->u32Actual += u32Len;
+        pstcPipe->u32RxLen += u32Count;
+        stcUhcStats.u32Bytes += u32Len;
+
+        /* Full packet and more expected: the channel must be enabled again */
+        CHx = UHC_CH(u32Ch);
+
+        if ((pstcPipe->u8State == UHC_PIPE_BUSY) && (u32Count == pstcPipe->u16Mps) &&
+            ((CHx->HCTSIZ & USBFS_HCTSIZ_PKTCNT) != 0UL)) {
+            CHx->HCCHAR = (CHx->HCCHAR & ~USBFS_HCCHAR_CHDIS) | USBFS_HCCHAR_CHENA;
+        }
+    }
+}
+#endif
+
+/**
+ * @brief  Start waiting pipes: due interrupt pipes, and OUT pipes once there is Tx FIFO space.
+ */
+static void UHC_Kick(void) {
+    stc_uhc_pipe_t **ppstcPipe = &pstcUhcWait;
+    stc_uhc_pipe_t *pstcPipe;
+    uint32_t u32Frame;
+    uint32_t u32Msk = 0UL;
+
+    if (u8UhcAttached == 0U) {
+        return;
+    }
+
+    u32Frame = CM_USBFS->HFNUM & UHC_FRAME_MASK;
+
+    while ((pstcPipe = *ppstcPipe) != NULL) {
+        if ((pstcPipe->u8Type == UHC_EP_INT) && (UHC_Due(pstcPipe, u32Frame) == 0UL)) {
+            ppstcPipe = &pstcPipe->pstcNext;
+            continue;
+        }
+
+        /* Unlink first: UHC_Xfer marks the pipe busy */
+        *ppstcPipe = pstcPipe->pstcNext;
+        pstcPipe->pstcNext = NULL;
+        pstcPipe->u8State = UHC_PIPE_IDLE;
+
+        if (UHC_Xfer(pstcPipe) == 0UL) {
+            u32Msk |= (pstcPipe->u8Type == UHC_EP_INT) ? USBFS_GINTMSK_PTXFEM : USBFS_GINTMSK_NPTXFEM;
+            pstcPipe->u8State = UHC_PIPE_WAIT;
+            pstcPipe->pstcNext = *ppstcPipe;
+            *ppstcPipe = pstcPipe;
+            ppstcPipe = &pstcPipe->pstcNext;
+        }
+    }
+
+    MODIFY_REG32(CM_USBFS->GINTMSK, USBFS_GINTMSK_NPTXFEM | USBFS_GINTMSK_PTXFEM, u32Msk);
+}
+
+static void UHC_PortReset(void) {
+    UHC_SetHprt(0UL, USBFS_HPRT_PRST);
+    u32UhcT0 = DWT->CYCCNT;
+    u8UhcStep = UHC_STEP_RESET;
+}
+
+/**
+ * @brief  Reset the port again; after UHC_ENUM_TRIES give up and wait for removal.
+ */
+static void UHC_EnumFail(void) {
+    uint32_t u32En = UHC_Lock();
+
+    u8UhcAttached = 0U;
+    UHC_Flush(UHC_RES_CANCEL);
+    CM_USBFS->GINTMSK &= ~USBFS_GINTMSK_SOFM;
+    UHC_Unlock(u32En);
+
+    stcUhcEnumUrb.u8State = UHC_URB_IDLE;
+
+    if (++u8UhcTries >= UHC_ENUM_TRIES) {
+        u8UhcState = UHC_DEV_ERROR;
+        u8UhcStep = UHC_STEP_ERROR;
+        return;
+    }
+
+    UHC_PortReset();
+}
+
+/**
+ * @brief  Enumeration control transfer: submitted on the first call, returns 1 once it has succeeded.
+ */
+static uint32_t UHC_EnumXfer(uint8_t u8Type, uint8_t u8Request, uint16_t u16Value, uint16_t u16Index,
+                             void *pvBuf, uint16_t u16Len) {
+    stc_uhc_urb_t *pstcUrb = &stcUhcEnumUrb;
+
+    if (pstcUrb->u8State == UHC_URB_IDLE) {
+        pstcUrb->pfnDone = NULL;
+        u32UhcT0 = DWT->CYCCNT;
+
+        if (UHC_Control(pstcUrb, u8Type, u8Request, u16Value, u16Index, (uint8_t *)pvBuf, u16Len) != LL_OK) {
+            UHC_EnumFail();
+        }
+
+        return 0UL;
+    }
+
+    if (pstcUrb->u8State != UHC_URB_DONE) {
+        if (UHC_Ms(u32UhcT0) > UHC_ENUM_TIMEOUT) {
+            UHC_EnumFail();
+        }
+
+        return 0UL;
+    }
+
+    pstcUrb->u8State = UHC_URB_IDLE;
+
+    if (pstcUrb->u8Result != UHC_RES_OK) {
+        UHC_EnumFail();
+        return 0UL;
+    }
+
+    return 1UL;
+}
+
+/**
+ * @brief  Hand each interface (alternate setting 0) of the configuration to the first class that takes it.
+ */
+static void UHC_Bind(void) {
+    const uint8_t *pu8Cfg = (const uint8_t *)au32UhcCfg;
+    uint32_t u32Off = pu8Cfg[0];
+    uint32_t u32End;
+    uint32_t i;
+
+    for (i = 0UL; i < UHC_CLASS_MAX; i++) {
+        au8UhcBound[i] = 0U;
+    }
+
+    /* Channels 1 and up go to the class pipes */
+    for (i = 1UL; i < UHC_CH_NUM; i++) {
+        apstcUhcCh[i] = NULL;
+    }
+
+    u32UhcChUsed = 1UL;
+
+    while (((u32Off + 2UL) <= u32UhcCfgLen) && (pu8Cfg[u32Off] >= 2U)) {
+        if ((pu8Cfg[u32Off + 1UL] != UHC_DESC_INTERFACE) || (pu8Cfg[u32Off + 3UL] != 0U)) {
+            u32Off += pu8Cfg[u32Off];
+            continue;
+        }
+
+        for (u32End = u32Off + pu8Cfg[u32Off];
+             ((u32End + 2UL) <= u32UhcCfgLen) && (pu8Cfg[u32End] >= 2U) && (pu8Cfg[u32End + 1UL] != UHC_DESC_INTERFACE);
+             u32End += pu8Cfg[u32End]) {
+        }
+
+        if (u32End > u32UhcCfgLen) {
+            u32End = u32UhcCfgLen;
+        }
+
+        for (i = 0UL; i < u32UhcClassNum; i++) {
+            if ((au8UhcBound[i] == 0U) && (apstcUhcClass[i]->pfnProbe(pu8Cfg + u32Off, u32End - u32Off) != 0UL)) {
+                au8UhcBound[i] = 1U;
+                break;
+            }
+        }
+
+        u32Off = u32End;
+    }
+}
+
+static void UHC_Detach(void) {
+    uint32_t u32En = UHC_Lock();
+    uint32_t i;
+
+    u8UhcAttached = 0U;
+    UHC_Flush(UHC_RES_NODEV);
+    CM_USBFS->GINTMSK &= ~USBFS_GINTMSK_SOFM;
+    UHC_Unlock(u32En);
+
+    UHC_SetHprt(USBFS_HPRT_PRST, 0UL);
+
+    if (u8UhcState == UHC_DEV_READY) {
+        for (i = 0UL; i < u32UhcClassNum; i++) {
+            if ((au8UhcBound[i] != 0U) && (apstcUhcClass[i]->pfnStop != NULL)) {
+                apstcUhcClass[i]->pfnStop();
+            }
+        }
+    }
+
+    for (i = 0UL; i < UHC_CLASS_MAX; i++) {
+        au8UhcBound[i] = 0U;
+    }
+
+    stcUhcEnumUrb.u8State = UHC_URB_IDLE;
+    u8UhcState = UHC_DEV_DETACHED;
+    u8UhcStep = UHC_STEP_IDLE;
+}
+
+/**
+ * @brief  Reset the USBFS core into host mode, split the FIFO RAM and power the port.
+ * @param  [in] enIRQn                  IRQ the caller registers UHC_IrqHandler on.
+ * @retval int32_t:
+ *           - LL_OK:                   No errors occurred.
+ *           - LL_ERR_TIMEOUT:          The core did not finish its soft reset.
+ * @note   The caller selects the 48MHz USB clock, sets up the DP/DM (and DRVVBUS) pins, registers
+ *         UHC_IrqHandler for INT_SRC_USBFS_GLB on enIRQn and enables it in the NVIC.
+ *         Blocks about 50ms for the forced host mode to take effect.
+ */
+int32_t UHC_Init(IRQn_Type enIRQn) {
+    uint32_t u32Count;
+    uint32_t i;
+
+    enUhcIRQn = enIRQn;
+    pstcUhcWait = NULL;
+    u8UhcAttached = 0U;
+    u8UhcIrqActive = 0U;
+    u8UhcState = UHC_DEV_DETACHED;
+    u8UhcStep = UHC_STEP_IDLE;
+    u32UhcClassNum = 0UL;
+    stcUhcEnumUrb.u8State = UHC_URB_IDLE;
+    (void)memset(&stcUhcStats, 0, sizeof(stcUhcStats));
+
+    (void)memset(apstcUhcCh, 0, sizeof(apstcUhcCh));
+    apstcUhcCh[0] = &stcUhcEp0;
+    stcUhcEp0.u8Ch = 0U;
+    u32UhcChUsed = 1UL;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    FCG_Fcg1PeriphClockCmd(FCG1_PERIPH_USBFS, ENABLE);
+
+    CM_USBFS->GAHBCFG = 0UL;
+    CM_USBFS->GINTMSK = 0UL;
+    CM_USBFS->GUSBCFG |= USBFS_GUSBCFG_PHYSEL;
+
+    for (u32Count = 0UL; (CM_USBFS->GRSTCTL & USBFS_GRSTCTL_AHBIDL) == 0UL; u32Count++) {
+        if (u32Count > 100000UL) {
+            return LL_ERR_TIMEOUT;
+        }
+    }
+
+    CM_USBFS->GRSTCTL = USBFS_GRSTCTL_CSRST;
+
+    for (u32Count = 0UL; (CM_USBFS->GRSTCTL & USBFS_GRSTCTL_CSRST) != 0UL; u32Count++) {
+        if (u32Count > 100000UL) {
+            return LL_ERR_TIMEOUT;
+        }
+    }
+
+    DDL_DelayUS(3UL);
+
+    MODIFY_REG32(CM_USBFS->GUSBCFG, USBFS_GUSBCFG_FHMOD | USBFS_GUSBCFG_FDMOD, USBFS_GUSBCFG_FHMOD);
+    DDL_DelayMS(50UL);
+
+    CM_USBFS->GCCTL = 0UL;
+    MODIFY_REG32(CM_USBFS->HCFG, USBFS_HCFG_FSLSPCS | USBFS_HCFG_FSLSS, UHC_FSLSPCS_48MHZ);
+    CM_USBFS->HFIR = 48000UL;
+
+    CM_USBFS->GRXFSIZ = UHC_RXFIFO_WORDS;
+    CM_USBFS->HNPTXFSIZ = (UHC_NPTXFIFO_WORDS << 16) | UHC_RXFIFO_WORDS;
+    CM_USBFS->HPTXFSIZ = (UHC_PTXFIFO_WORDS << 16) | (UHC_RXFIFO_WORDS + UHC_NPTXFIFO_WORDS);
+    UHC_FifoFlush();
+
+    for (i = 0UL; i < UHC_CH_NUM; i++) {
+        UHC_CH(i)->HCINTMSK = 0UL;
+        UHC_CH(i)->HCINT = 0xFFFFFFFFUL;
+    }
+
+    CM_USBFS->HAINTMSK = (1UL << UHC_CH_NUM) - 1UL;
+    CM_USBFS->GINTSTS = 0xFFFFFFFFUL;
+    CM_USBFS->GINTMSK = UHC_GINT_MASK;
+
+    UHC_SetHprt(0UL, USBFS_HPRT_PWPR);
+#if (UHC_DMA_ENABLE == DDL_ON)
+    CM_USBFS->GAHBCFG = USBFS_GAHBCFG_GINTMSK | USBFS_GAHBCFG_DMAEN | (UHC_HBSTLEN_INCR8 << USBFS_GAHBCFG_HBSTLEN_POS);
+#else
+    CM_USBFS->GAHBCFG = USBFS_GAHBCFG_GINTMSK;
+#endif
+
+    return LL_OK;
+}
+
+/**
+ * @brief  Register a class driver, after UHC_Init and before a device is attached.
+ * @param  [in] pstcClass               Class driver.
+ * @retval None
+ */
+void UHC_RegisterClass(const stc_uhc_class_t *pstcClass) {
+    if (u32UhcClassNum < UHC_CLASS_MAX) {
+        apstcUhcClass[u32UhcClassNum++] = pstcClass;
+    }
+}
+
+/**
+ * @brief  Connection, reset and enumeration state machine; call from the main loop, never blocks.
+ * @param  None
+ * @retval None
+ */
+void UHC_Task(void) {
+    uint32_t u32Hprt = CM_USBFS->HPRT;
+    uint8_t *pu8Dev = (uint8_t *)au32UhcDevDesc;
+    uint8_t *pu8Cfg = (uint8_t *)au32UhcCfg;
+    uint32_t u32Ls;
+    uint32_t i;
+
+    if ((u8UhcStep != UHC_STEP_IDLE) &&
+        (((u32Hprt & USBFS_HPRT_PCSTS) == 0UL) ||
+         ((u8UhcStep > UHC_STEP_RECOVER) && (u8UhcStep != UHC_STEP_ERROR) && (u8UhcAttached == 0U)))) {
+        UHC_Detach();
+        return;
+    }
+
+    switch (u8UhcStep) {
+        case UHC_STEP_IDLE:
+            if ((u32Hprt & USBFS_HPRT_PCSTS) != 0UL) {
+                u8UhcTries = 0U;
+                u32UhcT0 = DWT->CYCCNT;
+                u8UhcState = UHC_DEV_ENUM;
+                u8UhcStep = UHC_STEP_DEBOUNCE;
+            }
+            break;
+
+        case UHC_STEP_DEBOUNCE:
+            if (UHC_Ms(u32UhcT0) >= 100UL) {
+                UHC_PortReset();
+            }
+            break;
+
+        case UHC_STEP_RESET:
+            if (UHC_Ms(u32UhcT0) >= 15UL) {
+                UHC_SetHprt(USBFS_HPRT_PRST, 0UL);
+                u32UhcT0 = DWT->CYCCNT;
+                u8UhcStep = UHC_STEP_RESET_WAIT;
+            }
+            break;
+
+        case UHC_STEP_RESET_WAIT:
+            if ((u32Hprt & USBFS_HPRT_PENA) == 0UL) {
+                if (UHC_Ms(u32UhcT0) > 100UL) {
+                    UHC_EnumFail();
+                }
+                break;
+            }
+
+            /* The PHY clock follows the device speed; a change needs another reset */
+            u32Ls = (((u32Hprt & USBFS_HPRT_PSPD) >> USBFS_HPRT_PSPD_POS) == UHC_PSPD_LS) ? 1UL : 0UL;
+
+            if ((CM_USBFS->HCFG & USBFS_HCFG_FSLSPCS) != ((u32Ls != 0UL) ? UHC_FSLSPCS_6MHZ : UHC_FSLSPCS_48MHZ)) {
+                MODIFY_REG32(CM_USBFS->HCFG, USBFS_HCFG_FSLSPCS, (u32Ls != 0UL) ? UHC_FSLSPCS_6MHZ : UHC_FSLSPCS_48MHZ);
+                CM_USBFS->HFIR = (u32Ls != 0UL) ? 6000UL : 48000UL;
+                UHC_PortReset();
+                break;
+            }
+
+            u8UhcLowSpeed = (uint8_t)u32Ls;
+            u32UhcT0 = DWT->CYCCNT;
+            u8UhcStep = UHC_STEP_RECOVER;
+            break;
+
+        case UHC_STEP_RECOVER:
+            /* 20ms after the reset */
+            if (UHC_Ms(u32UhcT0) < 20UL) {
+                break;
+            }
+
+            stcUhcEp0.u8Addr = 0U;
+            stcUhcEp0.u8Ep = 0U;
+            stcUhcEp0.u8Type = UHC_EP_CTRL;
+            stcUhcEp0.u8Interval = 0U;
+            stcUhcEp0.u16Mps = 8U;
+            stcUhcEp0.u8Ch = 0U;
+            stcUhcEp0.u8Toggle = 0U;
+            stcUhcEp0.u8State = UHC_PIPE_IDLE;
+            stcUhcEp0.pstcHead = NULL;
+            stcUhcEp0.pstcTail = NULL;
+            stcUhcEp0.pstcNext = NULL;
+
+            CM_USBFS->GINTSTS = USBFS_GINTSTS_SOF;
+            CM_USBFS->GINTMSK |= USBFS_GINTMSK_SOFM;
+            u8UhcAttached = 1U;
+            u8UhcStep = UHC_STEP_DEV8;
+            break;
+
+        case UHC_STEP_DEV8:
+            if (UHC_EnumXfer(0x80U, UHC_REQ_GET_DESCRIPTOR, UHC_DESC_DEVICE << 8, 0U, pu8Dev, 8U) == 0UL) {
+                break;
+            }
+
+            if ((pu8Dev[7] != 8U) && (pu8Dev[7] != 16U) && (pu8Dev[7] != 32U) && (pu8Dev[7] != 64U)) {
+                UHC_EnumFail();
+                break;
+            }
+
+            stcUhcEp0.u16Mps = pu8Dev[7];
+            u8UhcStep = UHC_STEP_ADDR;
+            break;
+
+        case UHC_STEP_ADDR:
+            if (UHC_EnumXfer(0x00U, UHC_REQ_SET_ADDRESS, UHC_DEV_ADDR, 0U, NULL, 0U) == 0UL) {
+                break;
+            }
+
+            u32UhcT0 = DWT->CYCCNT;
+            u8UhcStep = UHC_STEP_ADDR_WAIT;
+            break;
+
+        case UHC_STEP_ADDR_WAIT:
+            if (UHC_Ms(u32UhcT0) < 2UL) {
+                break;
+            }
+
+            stcUhcEp0.u8Addr = UHC_DEV_ADDR;
+            u8UhcStep = UHC_STEP_DEV18;
+            break;
+
+        case UHC_STEP_DEV18:
+            if (UHC_EnumXfer(0x80U, UHC_REQ_GET_DESCRIPTOR, UHC_DESC_DEVICE << 8, 0U, pu8Dev, 18U) == 0UL) {
+                break;
+            }
+
+            u8UhcStep = UHC_STEP_CFG9;
+            break;
+
+        case UHC_STEP_CFG9:
+            if (UHC_EnumXfer(0x80U, UHC_REQ_GET_DESCRIPTOR, UHC_DESC_CONFIG << 8, 0U, pu8Cfg, 9U) == 0UL) {
+                break;
+            }
+
+            u32UhcCfgLen = (uint32_t)pu8Cfg[2] | ((uint32_t)pu8Cfg[3] << 8);
+
+            if (u32UhcCfgLen > UHC_CFG_MAX) {
+                u32UhcCfgLen = UHC_CFG_MAX;
+            }
+
+            u8UhcStep = UHC_STEP_CFG;
+            break;
+
+        case UHC_STEP_CFG:
+            if (UHC_EnumXfer(0x80U, UHC_REQ_GET_DESCRIPTOR, UHC_DESC_CONFIG << 8, 0U, pu8Cfg, (uint16_t)u32UhcCfgLen) == 0UL) {
+                break;
+            }
+
+            UHC_Bind();
+            u8UhcStep = UHC_STEP_SETCFG;
+            break;
+
+        case UHC_STEP_SETCFG:
+            if (UHC_EnumXfer(0x00U, UHC_REQ_SET_CONFIGURATION, pu8Cfg[5], 0U, NULL, 0U) == 0UL) {
+                break;
+            }
+
+            for (i = 0UL; i < u32UhcClassNum; i++) {
+                if ((au8UhcBound[i] != 0U) && (apstcUhcClass[i]->pfnStart != NULL)) {
+                    apstcUhcClass[i]->pfnStart();
+                }
+            }
+
+            u8UhcState = UHC_DEV_READY;
+            u8UhcStep = UHC_STEP_READY;
+            break;
+
+        case UHC_STEP_READY:
+            for (i = 0UL; i < u32UhcClassNum; i++) {
+                if ((au8UhcBound[i] != 0U) && (apstcUhcClass[i]->pfnTask != NULL)) {
+                    apstcUhcClass[i]->pfnTask();
+                }
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief  Device state.
+ * @param  None
+ * @retval UHC_DEV_DETACHED/ENUM/READY/ERROR.
+ */
+uint8_t UHC_State(void) {
+    return u8UhcState;
+}
+
+/**
+ * @brief  Device descriptor, valid once enumeration has passed it.
+ * @param  None
+ * @retval 18-byte device descriptor.
+ */
+const uint8_t *UHC_DevDesc(void) {
+    return (const uint8_t *)au32UhcDevDesc;
+}
+
+/**
+ * @brief  Find an endpoint descriptor of a given type and direction among the descriptors of an interface.
+ * @param  [in] pu8Intf                 Interface descriptor, as passed to pfnProbe.
+ * @param  [in] u32Len                  Bytes up to the next interface, as passed to pfnProbe.
+ * @param  [in] u8Type                  UHC_EP_BULK or UHC_EP_INT.
+ * @param  [in] u8Dir                   UHC_EP_IN or UHC_EP_OUT.
+ * @retval Endpoint descriptor, NULL if there is none.
+ */
+const uint8_t *UHC_FindEp(const uint8_t *pu8Intf, uint32_t u32Len, uint8_t u8Type, uint8_t u8Dir) {
+    uint32_t u32Off;
+
+    for (u32Off = pu8Intf[0]; ((u32Off + 2UL) <= u32Len) && (pu8Intf[u32Off] >= 2U); u32Off += pu8Intf[u32Off]) {
+        if ((pu8Intf[u32Off + 1UL] == UHC_DESC_ENDPOINT) && (pu8Intf[u32Off] >= 7U) && ((u32Off + 7UL) <= u32Len) &&
+            ((pu8Intf[u32Off + 3UL] & 0x03U) == u8Type) && ((pu8Intf[u32Off + 2UL] & 0x80U) == u8Dir)) {
+            return pu8Intf + u32Off;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief  Set up a pipe from an endpoint descriptor and give it a host channel.
+ * @param  [in] pstcPipe                Pipe.
+ * @param  [in] pu8EpDesc               Endpoint descriptor.
+ * @retval int32_t:
+ *           - LL_OK:                   No errors occurred.
+ *           - LL_ERR_BUF_FULL:         All UHC_CH_NUM channels are in use.
+ * @note   Call from pfnProbe; the channels are handed out again for every device.
+ */
+int32_t UHC_PipeInit(stc_uhc_pipe_t *pstcPipe, const uint8_t *pu8EpDesc) {
+    if (u32UhcChUsed >= UHC_CH_NUM) {
+        return LL_ERR_BUF_FULL;
+    }
+
+    pstcPipe->u8Addr = UHC_DEV_ADDR;
+    pstcPipe->u8Ep = pu8EpDesc[2];
+    pstcPipe->u8Type = pu8EpDesc[3] & 0x03U;
+    pstcPipe->u16Mps = ((uint16_t)pu8EpDesc[4] | ((uint16_t)pu8EpDesc[5] << 8)) & 0x7FFU;
+    pstcPipe->u8Interval = (pu8EpDesc[6] != 0U) ? pu8EpDesc[6] : 1U;
+    pstcPipe->u8Ch = (uint8_t)u32UhcChUsed;
+    pstcPipe->u8Toggle = 0U;
+    pstcPipe->u8State = UHC_PIPE_IDLE;
+    pstcPipe->u16NextFrame = 0U;
+    pstcPipe->pstcHead = NULL;
+    pstcPipe->pstcTail = NULL;
+    pstcPipe->pstcNext = NULL;
+
+    apstcUhcCh[u32UhcChUsed++] = pstcPipe;
+
+    return LL_OK;
+}
+
+/**
+ * @brief  Queue a URB on its pipe; pfnDone is called when it ends.
+ * @param  [in] pstcUrb                 URB with pstcPipe, pu8Buf and u32Len set.
+ * @retval int32_t:
+ *           - LL_OK:                   Queued.
+ *           - LL_ERR_INVD_PARAM:       No pipe or buffer, or already queued.
+ *           - LL_ERR_NOT_RDY:          No device attached.
+ * @note   May be called from pfnDone.
+ */
+int32_t UHC_Submit(stc_uhc_urb_t *pstcUrb) {
+    stc_uhc_pipe_t *pstcPipe = pstcUrb->pstcPipe;
+    uint32_t u32Frame;
+    uint32_t u32En;
+
+    if ((pstcPipe == NULL) || (pstcPipe->u16Mps == 0U) || ((pstcUrb->u32Len != 0UL) && (pstcUrb->pu8Buf == NULL)) ||
+        (pstcUrb->u8State == UHC_URB_QUEUED)) {
+        return LL_ERR_INVD_PARAM;
+    }
+
+    if (u8UhcAttached == 0U) {
+        return LL_ERR_NOT_RDY;
+    }
+
+    pstcUrb->u8Stage = (pstcPipe->u8Type == UHC_EP_CTRL) ? UHC_STAGE_SETUP : UHC_STAGE_DATA;
+    pstcUrb->u8Result = UHC_RES_OK;
+    pstcUrb->u8Errors = 0U;
+    pstcUrb->u8Cancel = 0U;
+    pstcUrb->u32Actual = 0UL;
+    pstcUrb->pstcNext = NULL;
+    pstcUrb->u8State = UHC_URB_QUEUED;
+
+    u32En = UHC_Lock();
+
+    if (pstcPipe->pstcTail != NULL) {
+        pstcPipe->pstcTail->pstcNext = pstcUrb;
+    } else {
+        pstcPipe->pstcHead = pstcUrb;
+    }
+
+    pstcPipe->pstcTail = pstcUrb;
+
+    if (pstcPipe->u8State == UHC_PIPE_IDLE) {
+        /* A stopped interrupt pipe does not make up for missed polls, it starts from the current frame */
+        if (pstcPipe->u8Type == UHC_EP_INT) {
+            u32Frame = CM_USBFS->HFNUM & UHC_FRAME_MASK;
+
+            if (((pstcPipe->u16NextFrame - u32Frame) & UHC_FRAME_MASK) > pstcPipe->u8Interval) {
+                pstcPipe->u16NextFrame = (uint16_t)u32Frame;
+            }
+        }
+
+        UHC_WaitAdd(pstcPipe);
+    }
+
+    UHC_Unlock(u32En);
+
+    if (u8UhcIrqActive == 0U) {
+        NVIC_SetPendingIRQ(enUhcIRQn);
+    }
+
+    return LL_OK;
+}
+
+/**
+ * @brief  Fill in the SETUP packet and queue a control transfer on endpoint 0.
+ * @param  [in] pstcUrb                 URB; pfnDone and pvArg are kept.
+ * @param  [in] u8Type                  bmRequestType.
+ * @param  [in] u8Request               bRequest.
+ * @param  [in] u16Value                wValue.
+ * @param  [in] u16Index                wIndex.
+ * @param  [in] pu8Buf                  Data stage buffer, NULL without data stage.
+ * @param  [in] u16Len                  wLength.
+ * @retval int32_t:                     See UHC_Submit.
+ */
+int32_t UHC_Control(stc_uhc_urb_t *pstcUrb, uint8_t u8Type, uint8_t u8Request, uint16_t u16Value,
+                    uint16_t u16Index, uint8_t *pu8Buf, uint16_t u16Len) {
+    pstcUrb->pstcPipe = &stcUhcEp0;
+    pstcUrb->au8Setup[0] = u8Type;
+    pstcUrb->au8Setup[1] = u8Request;
+    pstcUrb->au8Setup[2] = (uint8_t)u16Value;
+    pstcUrb->au8Setup[3] = (uint8_t)(u16Value >> 8);
+    pstcUrb->au8Setup[4] = (uint8_t)u16Index;
+    pstcUrb->au8Setup[5] = (uint8_t)(u16Index >> 8);
+    pstcUrb->au8Setup[6] = (uint8_t)u16Len;
+    pstcUrb->au8Setup[7] = (uint8_t)(u16Len >> 8);
+    pstcUrb->pu8Buf = pu8Buf;
+    pstcUrb->u32Len = u16Len;
+
+    return UHC_Submit(pstcUrb);
+}
+
+/**
+ * @brief  Cancel a URB without calling pfnDone.
+ * @param  [in] pstcUrb                 URB.
+ * @retval None
+ * @note   A URB whose channel is running ends (u8State UHC_URB_DONE) once the channel has halted.
+ */
+void UHC_Cancel(stc_uhc_urb_t *pstcUrb) {
+    stc_uhc_pipe_t *pstcPipe = pstcUrb->pstcPipe;
+    stc_uhc_urb_t **ppstcUrb;
+    uint32_t u32En = UHC_Lock();
+
+    if (pstcUrb->u8State == UHC_URB_QUEUED) {
+        pstcUrb->u8Cancel = 1U;
+
+        if ((pstcPipe->pstcHead == pstcUrb) && (pstcPipe->u8State == UHC_PIPE_BUSY)) {
+            UHC_Stop(pstcPipe, UHC_HALT_CANCEL);
+        } else if ((pstcPipe->pstcHead != pstcUrb) || (pstcPipe->u8State != UHC_PIPE_HALT)) {
+            for (ppstcUrb = &pstcPipe->pstcHead; (*ppstcUrb != NULL) && (*ppstcUrb != pstcUrb); ppstcUrb = &(*ppstcUrb)->pstcNext) {
+            }
+
+            if (*ppstcUrb != NULL) {
+                *ppstcUrb = pstcUrb->pstcNext;
+            }
+
+            for (pstcPipe->pstcTail = pstcPipe->pstcHead;
+                 (pstcPipe->pstcTail != NULL) && (pstcPipe->pstcTail->pstcNext != NULL);
+                 pstcPipe->pstcTail = pstcPipe->pstcTail->pstcNext) {
+            }
+
+            if ((pstcPipe->pstcHead == NULL) && (pstcPipe->u8State == UHC_PIPE_WAIT)) {
+                UHC_WaitRemove(pstcPipe);
+                pstcPipe->u8State = UHC_PIPE_IDLE;
+            }
+
+            pstcUrb->pstcNext = NULL;
+            pstcUrb->u8Result = UHC_RES_CANCEL;
+            pstcUrb->u8State = UHC_URB_DONE;
+        } else {
+            /* Halting for another reason: UHC_Stopped sees u8Cancel */
+        }
+    }
+
+    UHC_Unlock(u32En);
+}
+
+/**
+ * @brief  Pend the USB interrupt so that the pfnService of the classes runs.
+ * @param  None
+ * @retval None
+ */
+void UHC_Wake(void) {
+    NVIC_SetPendingIRQ(enUhcIRQn);
+}
+
+/**
+ * @brief  Current frame number.
+ * @param  None
+ * @retval 0 ~ UHC_FRAME_MASK.
+ */
+uint32_t UHC_Frame(void) {
+    return CM_USBFS->HFNUM & UHC_FRAME_MASK;
+}
+
+/**
+ * @brief  USBFS interrupt: port, Rx FIFO, channels and SOF, then class service and waiting pipes.
+ * @param  None
+ * @retval None
+ */
+void UHC_IrqHandler(void) {
+    uint32_t u32T0 = DWT->CYCCNT;
+    uint32_t u32Sts = CM_USBFS->GINTSTS & CM_USBFS->GINTMSK;
+    uint32_t u32Hprt;
+    uint32_t u32Haint;
+    uint32_t i;
+
+    u8UhcIrqActive = 1U;
+
+    /* Removal ends all URBs, UHC_Task notifies the classes */
+    if ((u32Sts & USBFS_GINTSTS_HPRTINT) != 0UL) {
+        u32Hprt = CM_USBFS->HPRT;
+        CM_USBFS->HPRT = u32Hprt & ~USBFS_HPRT_PENA;
+
+        if (((u32Hprt & USBFS_HPRT_PENCHNG) != 0UL) && ((u32Hprt & USBFS_HPRT_PENA) == 0UL) && (u8UhcAttached != 0U)) {
+            u8UhcAttached = 0U;
+            UHC_Flush(UHC_RES_NODEV);
+        }
+    }
+
+    if ((u32Sts & USBFS_GINTSTS_DISCINT) != 0UL) {
+        CM_USBFS->GINTSTS = USBFS_GINTSTS_DISCINT;
+
+        if (u8UhcAttached != 0U) {
+            u8UhcAttached = 0U;
+            UHC_Flush(UHC_RES_NODEV);
+        }
+    }
+
+#if (UHC_DMA_ENABLE == DDL_OFF)
+    if ((u32Sts & USBFS_GINTSTS_RXFNE) != 0UL) {
+        UHC_RxIrq();
+    }
+#endif
+
+    if ((u32Sts & USBFS_GINTSTS_HCINT) != 0UL) {
+        u32Haint = CM_USBFS->HAINT & ((1UL << UHC_CH_NUM) - 1UL);
+
+        for (i = 0UL; u32Haint != 0UL; i++, u32Haint >>= 1) {
+            if ((u32Haint & 1UL) != 0UL) {
+                UHC_ChIrq(i);
+            }
+        }
+    }
+
+    if ((u32Sts & USBFS_GINTSTS_SOF) != 0UL) {
+        CM_USBFS->GINTSTS = USBFS_GINTSTS_SOF;
+    }
+
+    if (u8UhcState == UHC_DEV_READY) {
+        for (i = 0UL; i < u32UhcClassNum; i++) {
+            if ((au8UhcBound[i] != 0U) && (apstcUhcClass[i]->pfnService != NULL)) {
+                apstcUhcClass[i]->pfnService();
+            }
+        }
+    }
+
+    UHC_Kick();
+
+    u8UhcIrqActive = 0U;
+
+    u32T0 = DWT->CYCCNT - u32T0;
+    stcUhcStats.u32IrqCount++;
+    stcUhcStats.u64IrqCycles += u32T0;
+
+    if (u32T0 > stcUhcStats.u32IrqMaxCycles) {
+        stcUhcStats.u32IrqMaxCycles = u32T0;
+    }
+}
+
+/**
+ * @brief  Read the host statistics.
+ * @param  [out] pstcStats              Statistics.
+ * @retval None
+ */
+void UHC_GetStats(stc_uhc_stats_t *pstcStats) {
+    uint32_t u32En = UHC_Lock();
+
+    *pstcStats = stcUhcStats;
+    UHC_Unlock(u32En);
+}
@@ -0,0 +1,174 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : usbh_core.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : USBFS host core: one host channel per pipe, URB queues per pipe, interrupt pipes started
+  *				   on their bInterval frame; port reset, enumeration and class binding run from UHC_Task
+  * Function List:
+  *		UHC_Init
+  *		UHC_RegisterClass
+  *		UHC_Task
+  *		UHC_State
+  *		UHC_DevDesc
+  *		UHC_FindEp
+  *		UHC_PipeInit
+  *		UHC_Submit
+  *		UHC_Control
+  *		UHC_Cancel
+  *		UHC_Wake
+  *		UHC_Frame
+  *		UHC_IrqHandler
+  *		UHC_GetStats
+  ******************************************************
+**/
+
+#ifndef __USBH_CORE_H_
+#define __USBH_CORE_H_
+
+#include "hc32_ll.h"
+
+#define UHC_DEV_ADDR                (1U)        /*!< Address of the only device, no hub support */
+#define UHC_CFG_MAX                 (256UL)     /*!< Longest configuration descriptor kept */
+#define UHC_CLASS_MAX               (2UL)
+#define UHC_CH_NUM                  (8UL)       /*!< Host channels used, channel 0 is endpoint 0 */
+#define UHC_RETRY                   (3U)        /*!< Transaction error retries before UHC_RES_ERROR */
+#define UHC_PKT_MAX                 (256UL)     /*!< Packets per channel transfer, longer URBs are split */
+#define UHC_DMA_ENABLE              (DDL_ON)    /*!< Internal DMA moves the channel data, DDL_OFF for FIFO copies */
+#define UHC_DMA_BOUNCE              (64UL)      /*!< Bytes per channel for DMA to unaligned buffers, >= 64 */
+
+/* FIFO RAM split in words: Rx, non-periodic Tx, periodic Tx */
+#define UHC_RXFIFO_WORDS            (128UL)
+#define UHC_NPTXFIFO_WORDS          (96UL)
+#define UHC_PTXFIFO_WORDS           (64UL)
+
+#define UHC_FRAME_MASK              (0x3FFFUL)
+
+/* Endpoint type, same as bmAttributes of the endpoint descriptor */
+#define UHC_EP_CTRL                 (0U)
+#define UHC_EP_BULK                 (2U)
+#define UHC_EP_INT                  (3U)
+
+#define UHC_EP_IN                   (0x80U)
+#define UHC_EP_OUT                  (0x00U)
+
+/* URB state */
+#define UHC_URB_IDLE                (0U)
+#define UHC_URB_QUEUED              (1U)
+#define UHC_URB_DONE                (2U)
+
+/* URB result */
+#define UHC_RES_OK                  (0U)
+#define UHC_RES_STALL               (1U)
+#define UHC_RES_ERROR               (2U)
+#define UHC_RES_NODEV               (3U)        /*!< Device removed */
+#define UHC_RES_CANCEL              (4U)
+
+/* Device state */
+#define UHC_DEV_DETACHED            (0U)
+#define UHC_DEV_ENUM                (1U)        /*!< Port reset and enumeration */
+#define UHC_DEV_READY               (2U)        /*!< Configured, class drivers running */
+#define UHC_DEV_ERROR               (3U)        /*!< Enumeration failed, waiting for removal */
+
+typedef struct stc_uhc_urb stc_uhc_urb_t;
+typedef struct stc_uhc_pipe stc_uhc_pipe_t;
+
+/**
+ * @brief Pipe to one endpoint of the device, initialized by UHC_PipeInit.
+ */
+struct stc_uhc_pipe {
+    uint8_t  u8Addr;                /*!< Device address */
+    uint8_t  u8Ep;                  /*!< Endpoint address, bit7 set for IN */
+    uint8_t  u8Type;                /*!< UHC_EP_CTRL/BULK/INT */
+    uint8_t  u8Interval;            /*!< Polling interval of an interrupt endpoint, frames */
+    uint16_t u16Mps;
+    uint8_t  u8Ch;                  /*!< Host channel */
+
+    /* Maintained by the core */
+    uint8_t  u8Toggle;              /*!< DATA0/DATA1 of the next packet, reset to 0 after clearing a halt */
+    uint8_t  u8State;
+    uint8_t  u8Halt;                /*!< Why the channel is being halted */
+    uint8_t  u8Bounce;              /*!< The running DMA transfer uses the bounce buffer of the channel */
+    uint16_t u16NextFrame;          /*!< Next polling frame of an interrupt endpoint */
+    uint16_t u16Pkts;               /*!< Packets of the running channel transfer */
+    uint32_t u32XferLen;            /*!< Bytes of the running channel transfer */
+    uint32_t u32RxLen;              /*!< Bytes received by the running IN transfer */
+    stc_uhc_urb_t *pstcHead;        /*!< URBs of this pipe, run in submission order */
+    stc_uhc_urb_t *pstcTail;
+    stc_uhc_pipe_t *pstcNext;       /*!< Waiting list link */
+};
+
+/**
+ * @brief Transfer request, owned by the core from UHC_Submit until pfnDone.
+ */
+struct stc_uhc_urb {
+    stc_uhc_pipe_t *pstcPipe;
+    uint8_t  *pu8Buf;
+    uint32_t u32Len;
+    uint8_t  au8Setup[8];           /*!< SETUP packet of a control transfer, filled in by UHC_Control */
+    void (*pfnDone)(stc_uhc_urb_t *pstcUrb);    /*!< Called from UHC_IrqHandler, may submit again */
+    void *pvArg;
+
+    /* Maintained by the core */
+    __IO uint8_t u8State;
+    uint8_t  u8Result;
+    uint8_t  u8Stage;
+    uint8_t  u8Errors;
+    __IO uint8_t u8Cancel;
+    uint32_t u32Actual;             /*!< Bytes transferred */
+    stc_uhc_urb_t *pstcNext;
+};
+
+/**
+ * @brief Class driver; pfnProbe/Start/Task/Stop run from UHC_Task, pfnService at the end of UHC_IrqHandler.
+ */
+typedef struct {
+    uint32_t (*pfnProbe)(const uint8_t *pu8Intf, uint32_t u32Len);    /*!< Interface descriptor and the
+                                                                          u32Len bytes up to the next one;
+                                                                          returns 1 to take it */
+    void (*pfnStart)(void);         /*!< After SET_CONFIGURATION */
+    void (*pfnTask)(void);
+    void (*pfnStop)(void);          /*!< Device removed, all its URBs already ended with UHC_RES_NODEV */
+    void (*pfnService)(void);
+} stc_uhc_class_t;
+
+/**
+ * @brief Host statistics.
+ */
+typedef struct {
+    uint32_t u32Xfers;              /*!< Channel transfers started */
+    uint32_t u32Naks;               /*!< With DMA only periodic NAKs, the core retries bulk/control ones */
+    uint32_t u32Errors;             /*!< Transaction, babble, toggle and frame overrun errors */
+    uint32_t u32Bytes;              /*!< Data stage bytes */
+    uint32_t u32Polls;              /*!< Interrupt endpoint polls */
+    uint32_t u32FifoWait;           /*!< OUT transfers that waited for Tx FIFO space */
+    uint32_t u32Bounce;             /*!< DMA transfers through a bounce buffer */
+    uint32_t u32IrqCount;
+    uint32_t u32IrqMaxCycles;
+    uint64_t u64IrqCycles;
+} stc_uhc_stats_t;
+
+int32_t UHC_Init(IRQn_Type enIRQn);
+void UHC_RegisterClass(const stc_uhc_class_t *pstcClass);
+void UHC_Task(void);
+uint8_t UHC_State(void);
+const uint8_t *UHC_DevDesc(void);
+const uint8_t *UHC_FindEp(const uint8_t *pu8Intf, uint32_t u32Len, uint8_t u8Type, uint8_t u8Dir);
+int32_t UHC_PipeInit(stc_uhc_pipe_t *pstcPipe, const uint8_t *pu8EpDesc);
+int32_t UHC_Submit(stc_uhc_urb_t *pstcUrb);
+int32_t UHC_Control(stc_uhc_urb_t *pstcUrb, uint8_t u8Type, uint8_t u8Request, uint16_t u16Value,
+                    uint16_t u16Index, uint8_t *pu8Buf, uint16_t u16Len);
+void UHC_Cancel(stc_uhc_urb_t *pstcUrb);
+void UHC_Wake(void);
+uint32_t UHC_Frame(void);
+void UHC_IrqHandler(void);
+void UHC_GetStats(stc_uhc_stats_t *pstcStats);
+
+#endif
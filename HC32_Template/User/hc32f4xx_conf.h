@@ -52,7 +52,7 @@ extern "C"
 #define LL_PRINT_ENABLE                             (DDL_OFF)
 
 #define LL_ADC_ENABLE                               (DDL_OFF)
-#define LL_AES_ENABLE                               (DDL_OFF)
+#define LL_AES_ENABLE                               (DDL_ON)
 #define LL_AOS_ENABLE                               (DDL_OFF)
 #define LL_CAN_ENABLE                               (DDL_OFF)
 #define LL_CLK_ENABLE                               (DDL_ON)
@@ -61,7 +61,7 @@ extern "C"
 #define LL_CTC_ENABLE                               (DDL_OFF)
 #define LL_DAC_ENABLE                               (DDL_OFF)
 #define LL_DCU_ENABLE                               (DDL_OFF)
-#define LL_DMA_ENABLE                               (DDL_OFF)
+#define LL_DMA_ENABLE                               (DDL_ON)
 #define LL_DMC_ENABLE                               (DDL_OFF)
 #define LL_DVP_ENABLE                               (DDL_OFF)
 #define LL_EFM_ENABLE                               (DDL_ON)
@@ -72,7 +72,7 @@ extern "C"
 #define LL_FCM_ENABLE                               (DDL_OFF)
 #define LL_FMAC_ENABLE                              (DDL_OFF)
 #define LL_GPIO_ENABLE                              (DDL_ON)
-#define LL_HASH_ENABLE                              (DDL_OFF)
+#define LL_HASH_ENABLE                              (DDL_ON)
 #define LL_HRPWM_ENABLE                             (DDL_OFF)
 #define LL_I2C_ENABLE                               (DDL_OFF)
 #define LL_I2S_ENABLE                               (DDL_OFF)
@@ -81,15 +81,15 @@ extern "C"
 #define LL_KEYSCAN_ENABLE                           (DDL_ON)
 #define LL_MAU_ENABLE                               (DDL_OFF)
 #define LL_MPU_ENABLE                               (DDL_OFF)
-#define LL_NFC_ENABLE                               (DDL_OFF)
+#define LL_NFC_ENABLE                               (DDL_ON)
 #define LL_OTS_ENABLE                               (DDL_OFF)
 #define LL_PWC_ENABLE                               (DDL_ON)
-#define LL_QSPI_ENABLE                              (DDL_OFF)
+#define LL_QSPI_ENABLE                              (DDL_ON)
 #define LL_RMU_ENABLE                               (DDL_OFF)
 #define LL_RTC_ENABLE                               (DDL_OFF)
 #define LL_SDIOC_ENABLE                             (DDL_OFF)
 #define LL_SMC_ENABLE                               (DDL_OFF)
-#define LL_SPI_ENABLE                               (DDL_OFF)
+#define LL_SPI_ENABLE                               (DDL_ON)
 #define LL_SRAM_ENABLE                              (DDL_OFF)
 #define LL_SWDT_ENABLE                              (DDL_OFF)
 #define LL_TMR0_ENABLE                              (DDL_OFF)
@@ -0,0 +1,378 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : adc_acq.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					ADC1/2/3三重交替模式以最高速率转换同一通道,
+					DMA2以双缓冲模式把ADC公共数据寄存器(CDR)写入两个乒乓缓冲区,
+					每写满一个缓冲区产生一次传输完成中断, 直接把缓冲区交给回调(零拷贝),
+					可选在中断中用SIMD(__UADD16)原地求平均抽取.
+  * Function List:
+  *		ADC_Acq_StructInit
+  *		ADC_Acq_Init
+  *		ADC_Acq_Start
+  *		ADC_Acq_Stop
+  *		ADC_Acq_ReleaseBlock
+  *		ADC_Acq_GetStats
+  *		ADC_Acq_ResetStats
+  *		ADC_ACQ_DMA_IRQHandler
+  *		ADC_IRQHandler
+  **********************************************************
+ */
+
+#include "adc_acq.h"
+
+typedef struct {
+    uint32_t *Buffer[2];
+    uint16_t BlockWords;
+    uint8_t  Decimation;
+    uint8_t  Shift;                 //log2(Decimation)
+    uint8_t  AutoRelease;
+    volatile uint8_t Owned[2];      //1: 缓冲区在使用者手中
+    volatile uint8_t Running;
+    ADC_Acq_Callback Callback;
+} ADC_Acq_Handle;
+
+static ADC_Acq_Handle acq;
+static ADC_Acq_Stats acq_stats;
+
+//求 2 的整数次幂的指数, 不是 2 的幂返回 0xFF
+static uint8_t ADC_Acq_Log2(uint8_t n) {
+    uint8_t shift = 0;
+
+    if(n == 0 || (n & (n - 1)) != 0) return 0xFF;
+
+    while((1u << shift) != n) shift++;
+
+    return shift;
+}
+
+//原地求平均抽取
+//每个32位字含两个相邻采样, 用 __UADD16 同时累加两个半字,
+//group 个字累加完后两个半字相加即 decim 个采样之和.
+//输出写在缓冲区开头, 写指针(2字节/点)永远落后于读指针(2*decim字节/点), 可以原地进行
+static uint32_t ADC_Acq_Decimate(uint32_t *buf, uint16_t words, uint8_t decim, uint8_t shift) {
+    const uint32_t *in = buf;
+    uint16_t *out = (uint16_t *)buf;
+    uint32_t group = decim >> 1;
+    uint32_t n = words / group;
+    uint32_t i, k, acc, sum;
+
+    for(i = 0; i < n; i++) {
+        acc = *in++;
+
+        for(k = 1; k < group; k++) {
+            acc = __UADD16(acc, *in++);
+        }
+
+        sum = (acc & 0xFFFF) + (acc >> 16);
+        out[i] = (uint16_t)(sum >> shift);
+    }
+
+    return n;
+}
+
+//把写满的缓冲区交给使用者
+static void ADC_Acq_Deliver(uint8_t index) {
+    uint32_t *buf = acq.Buffer[index];
+    uint32_t raw = (uint32_t)acq.BlockWords * ADC_ACQ_SAMPLES_PER_WORD;
+    uint32_t samples = raw;
+
+    //上一轮交出去的同一缓冲区还没归还, DMA已经把它覆盖, 这一块丢弃
+    if(acq.Owned[index]) {
+        acq_stats.DroppedBlocks++;
+        acq_stats.DroppedSamples += raw;
+        return;
+    }
+
+    if(acq.Decimation > 1) {
+        samples = ADC_Acq_Decimate(buf, acq.BlockWords, acq.Decimation, acq.Shift);
+    }
+
+    acq.Owned[index] = 1;
+    acq_stats.Blocks++;
+    acq_stats.Samples += raw;
+
+    acq.Callback((const uint16_t *)buf, samples, index);
+
+    if(acq.AutoRelease) acq.Owned[index] = 0;
+}
+
+//关闭ADC和DMA数据流, 等待数据流真正停止
+static void ADC_Acq_Halt(void) {
+    ADC_Cmd(ADC1, DISABLE);
+    ADC_Cmd(ADC2, DISABLE);
+    ADC_Cmd(ADC3, DISABLE);
+
+    DMA_Cmd(ADC_ACQ_DMA_STREAM, DISABLE);
+
+    while(DMA_GetCmdStatus(ADC_ACQ_DMA_STREAM) != DISABLE);
+}
+
+//从缓冲区0开始重新启动DMA和三个ADC
+static void ADC_Acq_Launch(void) {
+    DMA_ClearITPendingBit(ADC_ACQ_DMA_STREAM, ADC_ACQ_DMA_IT_TCIF | ADC_ACQ_DMA_IT_TEIF |
+                          ADC_ACQ_DMA_IT_FEIF | ADC_ACQ_DMA_IT_DMEIF);
+    ADC_ACQ_DMA_STREAM->CR &= ~DMA_SxCR_CT;
+    DMA_SetCurrDataCounter(ADC_ACQ_DMA_STREAM, acq.BlockWords);
+    DMA_Cmd(ADC_ACQ_DMA_STREAM, ENABLE);
+
+    ADC_ClearFlag(ADC1, ADC_FLAG_OVR);
+    ADC_ClearFlag(ADC2, ADC_FLAG_OVR);
+    ADC_ClearFlag(ADC3, ADC_FLAG_OVR);
+
+    //多重ADC模式下溢出后DMA请求被屏蔽, 需重写DMA模式位才能恢复
+    ADC->CCR &= ~ADC_CCR_DMA;
+    ADC->CCR |= ADC_DMAAccessMode_2;
+    ADC_MultiModeDMARequestAfterLastTransferCmd(ENABLE);
+
+    ADC_Cmd(ADC1, ENABLE);
+    ADC_Cmd(ADC2, ENABLE);
+    ADC_Cmd(ADC3, ENABLE);
+
+    //三重模式下只需启动主ADC(ADC1), ADC2/ADC3按采样间隔自动跟随
+    ADC_SoftwareStartConv(ADC1);
+}
+
+static void ADC_Acq_Restart(void) {
+    ADC_Acq_Halt();
+    acq.Owned[0] = 0;
+    acq.Owned[1] = 0;
+    acq_stats.Restarts++;
+    ADC_Acq_Launch();
+}
+
+//按最高采样率填充缺省值
+//168MHz主频下APB2=84MHz, 4分频得ADCCLK=21MHz, 5周期间隔交替后约4.2MSPS
+void ADC_Acq_StructInit(ADC_Acq_InitTypeDef *ADC_Acq_InitStruct) {
+    ADC_Acq_InitStruct->GPIOx = GPIOA;
+    ADC_Acq_InitStruct->GPIO_Pin = GPIO_Pin_0;
+    ADC_Acq_InitStruct->RCC_AHB1Periph = RCC_AHB1Periph_GPIOA;
+    ADC_Acq_InitStruct->ADC_Channel = ADC_Channel_0;
+    ADC_Acq_InitStruct->ADC_SampleTime = ADC_SampleTime_3Cycles;
+    ADC_Acq_InitStruct->ADC_Prescaler = ADC_Prescaler_Div4;
+    ADC_Acq_InitStruct->ADC_TwoSamplingDelay = ADC_TwoSamplingDelay_5Cycles;
+    ADC_Acq_InitStruct->Buffer0 = 0;
+    ADC_Acq_InitStruct->Buffer1 = 0;
+    ADC_Acq_InitStruct->BlockWords = 0;
+    ADC_Acq_InitStruct->Decimation = 1;
+    ADC_Acq_InitStruct->AutoRelease = 1;
+    ADC_Acq_InitStruct->Callback = 0;
+    ADC_Acq_InitStruct->NVIC_PreemptionPriority = 0;
+    ADC_Acq_InitStruct->NVIC_SubPriority = 0;
+}
+
+//初始化采集引擎, 完成后调用 ADC_Acq_Start 开始采集
+//返回ERROR: 缓冲区/回调为空, 或抽取因子不是 1~32 之间2的幂, 或块长度不是抽取组长的整数倍
+ErrorStatus ADC_Acq_Init(ADC_Acq_InitTypeDef *ADC_Acq_InitStruct) {
+    GPIO_InitTypeDef GPIO_InitStructure;
+    ADC_CommonInitTypeDef ADC_CommonInitStructure;
+    ADC_InitTypeDef ADC_InitStructure;
+    DMA_InitTypeDef DMA_InitStructure;
+    NVIC_InitTypeDef NVIC_InitStructure;
+    uint8_t shift;
+
+    shift = ADC_Acq_Log2(ADC_Acq_InitStruct->Decimation);
+
+    if(ADC_Acq_InitStruct->Buffer0 == 0 || ADC_Acq_InitStruct->Buffer1 == 0 ||
+            ADC_Acq_InitStruct->Callback == 0 || ADC_Acq_InitStruct->BlockWords == 0 ||
+            shift == 0xFF || ADC_Acq_InitStruct->Decimation > ADC_ACQ_DECIMATION_MAX) {
+        return ERROR;
+    }
+
+    if(ADC_Acq_InitStruct->Decimation > 1 &&
+            (ADC_Acq_InitStruct->BlockWords % (ADC_Acq_InitStruct->Decimation >> 1)) != 0) {
+        return ERROR;
+    }
+
+    acq.Buffer[0] = ADC_Acq_InitStruct->Buffer0;
+    acq.Buffer[1] = ADC_Acq_InitStruct->Buffer1;
+    acq.BlockWords = ADC_Acq_InitStruct->BlockWords;
+    acq.Decimation = ADC_Acq_InitStruct->Decimation;
+    acq.Shift = shift;
+    acq.AutoRelease = ADC_Acq_InitStruct->AutoRelease;
+    acq.Callback = ADC_Acq_InitStruct->Callback;
+    acq.Owned[0] = 0;
+    acq.Owned[1] = 0;
+    acq.Running = 0;
+
+    RCC_AHB1PeriphClockCmd(ADC_Acq_InitStruct->RCC_AHB1Periph | RCC_AHB1Periph_DMA2, ENABLE);
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_ADC1 | RCC_APB2Periph_ADC2 | RCC_APB2Periph_ADC3, ENABLE);
+
+    GPIO_InitStructure.GPIO_Pin = ADC_Acq_InitStruct->GPIO_Pin;
+    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AN;
+    GPIO_InitStructure.GPIO_PuPd = GPIO_PuPd_NOPULL;
+    GPIO_Init(ADC_Acq_InitStruct->GPIOx, &GPIO_InitStructure);
+
+    //DMA: ADC->CDR -> Buffer0/Buffer1 双缓冲循环, 32位字, 块长为4的倍数时4字突发减少总线仲裁次数
+    DMA_DeInit(ADC_ACQ_DMA_STREAM);
+
+    while(DMA_GetCmdStatus(ADC_ACQ_DMA_STREAM) != DISABLE);
+
+    DMA_InitStructure.DMA_Channel = ADC_ACQ_DMA_CHANNEL;
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&ADC->CDR;
+    DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)acq.Buffer[0];
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralToMemory;
+    DMA_InitStructure.DMA_BufferSize = acq.BlockWords;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Word;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Word;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_VeryHigh;
+    DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Enable;
+    DMA_InitStructure.DMA_FIFOThreshold = DMA_FIFOThreshold_Full;
+    //双缓冲循环模式下突发要求块长为突发长度的整数倍, 否则退回单次传输
+    DMA_InitStructure.DMA_MemoryBurst = ((acq.BlockWords & 3U) == 0) ? DMA_MemoryBurst_INC4 : DMA_MemoryBurst_Single;
+    DMA_InitStructure.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+    DMA_Init(ADC_ACQ_DMA_STREAM, &DMA_InitStructure);
+
+    DMA_DoubleBufferModeConfig(ADC_ACQ_DMA_STREAM, (uint32_t)acq.Buffer[1], DMA_Memory_0);
+    DMA_DoubleBufferModeCmd(ADC_ACQ_DMA_STREAM, ENABLE);
+    DMA_ITConfig(ADC_ACQ_DMA_STREAM, DMA_IT_TC | DMA_IT_TE | DMA_IT_FE | DMA_IT_DME, ENABLE);
+
+    //ADC: 三重交替, DMA模式2(每次请求搬运两个半字)
+    ADC_DeInit();
+    ADC_CommonInitStructure.ADC_Mode = ADC_TripleMode_Interl;
+    ADC_CommonInitStructure.ADC_Prescaler = ADC_Acq_InitStruct->ADC_Prescaler;
+    ADC_CommonInitStructure.ADC_DMAAccessMode = ADC_DMAAccessMode_2;
+    ADC_CommonInitStructure.ADC_TwoSamplingDelay = ADC_Acq_InitStruct->ADC_TwoSamplingDelay;
+    ADC_CommonInit(&ADC_CommonInitStructure);
+
+    ADC_InitStructure.ADC_Resolution = ADC_Resolution_12b;
+    ADC_InitStructure.ADC_ScanConvMode = DISABLE;
+    ADC_InitStructure.ADC_ContinuousConvMode = ENABLE;
+    ADC_InitStructure.ADC_ExternalTrigConvEdge = ADC_ExternalTrigConvEdge_None;
+    ADC_InitStructure.ADC_ExternalTrigConv = ADC_ExternalTrigConv_T1_CC1;
+    ADC_InitStructure.ADC_DataAlign = ADC_DataAlign_Right;
+    ADC_InitStructure.ADC_NbrOfConversion = 1;
+    ADC_Init(ADC1, &ADC_InitStructure);
+    ADC_Init(ADC2, &ADC_InitStructure);
+    ADC_Init(ADC3, &ADC_InitStructure);
+
+    ADC_RegularChannelConfig(ADC1, ADC_Acq_InitStruct->ADC_Channel, 1, ADC_Acq_InitStruct->ADC_SampleTime);
+    ADC_RegularChannelConfig(ADC2, ADC_Acq_InitStruct->ADC_Channel, 1, ADC_Acq_InitStruct->ADC_SampleTime);
+    ADC_RegularChannelConfig(ADC3, ADC_Acq_InitStruct->ADC_Channel, 1, ADC_Acq_InitStruct->ADC_SampleTime);
+
+    ADC_ITConfig(ADC1, ADC_IT_OVR, ENABLE);
+    ADC_ITConfig(ADC2, ADC_IT_OVR, ENABLE);
+    ADC_ITConfig(ADC3, ADC_IT_OVR, ENABLE);
+
+    NVIC_InitStructure.NVIC_IRQChannel = ADC_ACQ_DMA_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = ADC_Acq_InitStruct->NVIC_PreemptionPriority;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = ADC_Acq_InitStruct->NVIC_SubPriority;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+
+    NVIC_InitStructure.NVIC_IRQChannel = ADC_IRQn;
+    NVIC_Init(&NVIC_InitStructure);
+
+    ADC_Acq_ResetStats();
+
+    return SUCCESS;
+}
+
+//启动连续采集
+void ADC_Acq_Start(void) {
+    acq.Owned[0] = 0;
+    acq.Owned[1] = 0;
+    acq.Running = 1;
+    ADC_Acq_Launch();
+}
+
+//停止采集, 返回后不会再有回调
+void ADC_Acq_Stop(void) {
+    acq.Running = 0;
+    ADC_Acq_Halt();
+}
+
+//归还缓冲区, 可在回调中或回调返回后的任意上下文调用
+void ADC_Acq_ReleaseBlock(uint8_t index) {
+    if(index < 2) acq.Owned[index] = 0;
+}
+
+void ADC_Acq_GetStats(ADC_Acq_Stats *stats) {
+    NVIC_DisableIRQ(ADC_ACQ_DMA_IRQn);
+    NVIC_DisableIRQ(ADC_IRQn);
+    *stats = acq_stats;
+    NVIC_EnableIRQ(ADC_IRQn);
+    NVIC_EnableIRQ(ADC_ACQ_DMA_IRQn);
+}
+
+void ADC_Acq_ResetStats(void) {
+    NVIC_DisableIRQ(ADC_ACQ_DMA_IRQn);
+    NVIC_DisableIRQ(ADC_IRQn);
+    acq_stats.Blocks = 0;
+    acq_stats.Samples = 0;
+    acq_stats.DroppedBlocks = 0;
+    acq_stats.DroppedSamples = 0;
+    acq_stats.AdcOverrun = 0;
+    acq_stats.DmaError = 0;
+    acq_stats.Restarts = 0;
+    NVIC_EnableIRQ(ADC_IRQn);
+    NVIC_EnableIRQ(ADC_ACQ_DMA_IRQn);
+}
+
+//DMA中断: 双缓冲模式下每写满一个缓冲区产生一次TC, 此时CT已指向另一个缓冲区
+void ADC_ACQ_DMA_IRQHandler(void) {
+    uint8_t index;
+
+    if(DMA_GetITStatus(ADC_ACQ_DMA_STREAM, ADC_ACQ_DMA_IT_TEIF) != RESET ||
+            DMA_GetITStatus(ADC_ACQ_DMA_STREAM, ADC_ACQ_DMA_IT_DMEIF) != RESET) {
+        //传输错误会自动关闭数据流, 只能整体重启
+        DMA_ClearITPendingBit(ADC_ACQ_DMA_STREAM, ADC_ACQ_DMA_IT_TEIF | ADC_ACQ_DMA_IT_DMEIF);
+        acq_stats.DmaError++;
+
+        if(acq.Running) ADC_Acq_Restart();
+
+        return;
+    }
+
+    if(DMA_GetITStatus(ADC_ACQ_DMA_STREAM, ADC_ACQ_DMA_IT_FEIF) != RESET) {
+        //FIFO错误不停止数据流, 只计数
+        DMA_ClearITPendingBit(ADC_ACQ_DMA_STREAM, ADC_ACQ_DMA_IT_FEIF);
+        acq_stats.DmaError++;
+    }
+
+    if(DMA_GetITStatus(ADC_ACQ_DMA_STREAM, ADC_ACQ_DMA_IT_TCIF) != RESET) {
+        DMA_ClearITPendingBit(ADC_ACQ_DMA_STREAM, ADC_ACQ_DMA_IT_TCIF);
+        index = (DMA_GetCurrentMemoryTarget(ADC_ACQ_DMA_STREAM) == 0) ? 1 : 0;
+        ADC_Acq_Deliver(index);
+    }
+}
+
+//ADC1/2/3共用中断: 只处理溢出, DMA没能及时取走CDR中的数据, 采样已丢失, 重启采集
+void ADC_IRQHandler(void) {
+    uint8_t ovr = 0;
+
+    if(ADC_GetITStatus(ADC1, ADC_IT_OVR) != RESET) {
+        ADC_ClearITPendingBit(ADC1, ADC_IT_OVR);
+        ovr = 1;
+    }
+
+    if(ADC_GetITStatus(ADC2, ADC_IT_OVR) != RESET) {
+        ADC_ClearITPendingBit(ADC2, ADC_IT_OVR);
+        ovr = 1;
+    }
+
+    if(ADC_GetITStatus(ADC3, ADC_IT_OVR) != RESET) {
+        ADC_ClearITPendingBit(ADC3, ADC_IT_OVR);
+        ovr = 1;
+    }
+
+    if(ovr) {
+        acq_stats.AdcOverrun++;
+
+        if(acq.Running) ADC_Acq_Restart();
+    }
+}
@@ -0,0 +1,90 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : adc_acq.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : ADC1/2/3三重交替采样 + DMA双缓冲(乒乓)采集引擎
+  * Function List:
+  *		ADC_Acq_StructInit
+  *		ADC_Acq_Init
+  *		ADC_Acq_Start
+  *		ADC_Acq_Stop
+  *		ADC_Acq_ReleaseBlock
+  *		ADC_Acq_GetStats
+  *		ADC_Acq_ResetStats
+  ******************************************************
+**/
+
+#ifndef __ADC_ACQ_H_
+#define __ADC_ACQ_H_
+
+#include "stm32f4xx_conf.h"
+
+//ADC公共数据寄存器只能由DMA2的Stream0或Stream4(通道0)搬运
+//中断服务函数直接在adc_acq.c中实现,如需更换数据流请同时修改以下所有宏
+#define ADC_ACQ_DMA_STREAM          DMA2_Stream0
+#define ADC_ACQ_DMA_CHANNEL         DMA_Channel_0
+#define ADC_ACQ_DMA_IRQn            DMA2_Stream0_IRQn
+#define ADC_ACQ_DMA_IRQHandler      DMA2_Stream0_IRQHandler
+#define ADC_ACQ_DMA_IT_TCIF         DMA_IT_TCIF0
+#define ADC_ACQ_DMA_IT_TEIF         DMA_IT_TEIF0
+#define ADC_ACQ_DMA_IT_FEIF         DMA_IT_FEIF0
+#define ADC_ACQ_DMA_IT_DMEIF        DMA_IT_DMEIF0
+
+//DMA模式2下每次请求搬运一个32位字,包含两个按时间先后排列的12位采样(低半字在前)
+#define ADC_ACQ_SAMPLES_PER_WORD    2
+//抽取因子上限: 每个半字累加 32/2=16 个12位采样, 16*4095 < 65536, __UADD16 不会溢出
+#define ADC_ACQ_DECIMATION_MAX      32
+
+//数据块回调, 在DMA中断中执行
+//block:   数据块首地址(指向乒乓缓冲区本身, 不拷贝; 开启抽取时为原地抽取后的结果)
+//samples: 数据块中有效采样数
+//index:   乒乓缓冲区编号 0/1, 关闭 AutoRelease 时需用它调用 ADC_Acq_ReleaseBlock
+typedef void (*ADC_Acq_Callback)(const uint16_t *block, uint32_t samples, uint8_t index);
+
+typedef struct {
+    GPIO_TypeDef *GPIOx;            //模拟输入引脚所在端口
+    uint16_t GPIO_Pin;              //模拟输入引脚
+    uint32_t RCC_AHB1Periph;        //端口时钟
+    uint8_t  ADC_Channel;           //ADC_Channel_x, 三个ADC交替转换同一通道
+    uint8_t  ADC_SampleTime;        //ADC_SampleTime_xCycles, 最高速率用 ADC_SampleTime_3Cycles
+    uint32_t ADC_Prescaler;         //ADC_Prescaler_DivX, ADCCLK 不得超过 36MHz
+    uint32_t ADC_TwoSamplingDelay;  //相邻两个ADC采样间隔, 最高速率用 ADC_TwoSamplingDelay_5Cycles
+
+    uint32_t *Buffer0;              //乒乓缓冲区0, 4字节对齐
+    uint32_t *Buffer1;              //乒乓缓冲区1, 4字节对齐
+    uint16_t BlockWords;            //每个缓冲区的字数(采样数 = BlockWords * 2), 需为 Decimation/2 的整数倍, 为4的倍数时DMA使用4字突发
+
+    uint8_t  Decimation;            //1: 不抽取; 2/4/8/16/32: 求平均抽取
+    uint8_t  AutoRelease;           //1: 回调返回即归还缓冲区; 0: 由使用者调用 ADC_Acq_ReleaseBlock 归还
+    ADC_Acq_Callback Callback;
+    uint8_t  NVIC_PreemptionPriority;
+    uint8_t  NVIC_SubPriority;
+} ADC_Acq_InitTypeDef;
+
+typedef struct {
+    uint32_t Blocks;                //已交给回调的数据块数
+    uint32_t Samples;               //已交给回调的原始采样数
+    uint32_t DroppedBlocks;         //缓冲区仍被使用者占用而丢弃的数据块数
+    uint32_t DroppedSamples;        //丢弃的原始采样数
+    uint32_t AdcOverrun;            //ADC OVR(DMA未及时取走数据)次数
+    uint32_t DmaError;              //DMA 传输/FIFO/直接模式错误次数
+    uint32_t Restarts;              //出错后自动重启次数
+} ADC_Acq_Stats;
+
+void ADC_Acq_StructInit(ADC_Acq_InitTypeDef *ADC_Acq_InitStruct); // 按最高采样率的缺省值填充结构体
+ErrorStatus ADC_Acq_Init(ADC_Acq_InitTypeDef *ADC_Acq_InitStruct); // 配置GPIO/ADC1~3/DMA, 参数非法返回 ERROR
+void ADC_Acq_Start(void); // 启动连续采集
+void ADC_Acq_Stop(void); // 停止采集
+void ADC_Acq_ReleaseBlock(uint8_t index); // 归还乒乓缓冲区(AutoRelease=0 时使用)
+void ADC_Acq_GetStats(ADC_Acq_Stats *stats); // 读取统计计数
+void ADC_Acq_ResetStats(void); // 清零统计计数
+
+#endif
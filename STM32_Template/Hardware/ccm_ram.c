@@ -0,0 +1,200 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : ccm_ram.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					CCM与SRAM的对比测试. 同一段控制环代码(查表 + 积分 + 状态更新,
+					每通道每轮六次读两次写)分别操作SRAM1和CCM中的一份状态, 各测一次
+					空闲和一次DMA2内存到内存连续搬运SRAM1的情况, 用DWT周期计数器计时.
+					状态在SRAM1时CPU的D总线要和DMA在总线矩阵上轮流占用SRAM1,
+					DMA越忙控制环越慢; 状态在CCM时两者互不相干, CcmDMA 应与 CcmIdle 基本相同.
+					DMA每搬完一块在中断中立即重新启动, 中断本身的开销两种情况相同.
+					CCM_IsrStackInit 把线程模式切到PSP(沿用SRAM中的启动栈),
+					MSP 改指CCM中的独立栈: 中断压栈和中断内的局部变量不再和DMA争用SRAM,
+					线程模式的局部变量仍在SRAM, 可以交给DMA.
+  * Function List:
+  *		CCM_IsrStackInit
+  *		CCM_Bench
+  *		CCM_BENCH_DMA_IRQHandler
+  **********************************************************
+ */
+
+#include "ccm_ram.h"
+
+#if defined(STM32F40_41xxx) || defined(STM32F427_437xx) || defined(STM32F429_439xx) || defined(STM32F469_479xx)
+
+#define CCM_LOOP_CH         16
+
+typedef struct {
+    uint32_t x[CCM_LOOP_CH];        //各通道状态
+    uint32_t acc[CCM_LOOP_CH];      //积分项
+    int16_t  lut[256];              //非线性校正表
+} CCM_Loop;
+
+static CCM_Loop sram_loop;
+CCM_BSS static CCM_Loop ccm_loop;
+
+//DMA缓冲区必须在SRAM
+static uint32_t dma_src[CCM_BENCH_DMA_WORDS];
+static uint32_t dma_dst[CCM_BENCH_DMA_WORDS];
+static volatile uint8_t dma_run;
+static volatile uint32_t dma_words;
+
+CCM_BSS static uint64_t ccm_isr_stack[CCM_ISR_STACK_SIZE / 8];	//8字节对齐, 满足AAPCS栈对齐
+
+static void CCM_LoopReset(CCM_Loop *s) {
+    uint32_t i;
+
+    for(i = 0; i < CCM_LOOP_CH; i++) {
+        s->x[i] = i << 20;
+        s->acc[i] = 0;
+    }
+
+    for(i = 0; i < 256; i++)
+        s->lut[i] = (int16_t)(((int32_t)(i * i) - 128 * 128) >> 4);
+}
+
+//volatile 保证每次都真正访问内存, 而不是把状态留在寄存器里
+static void CCM_Kernel(volatile CCM_Loop *s, uint32_t rounds) {
+    uint32_t r, ch;
+    int32_t e;
+
+    for(r = 0; r < rounds; r++) {
+        for(ch = 0; ch < CCM_LOOP_CH; ch++) {
+            e = s->lut[s->x[ch] >> 24];
+            s->acc[ch] += (uint32_t)e - (s->acc[ch] >> 6);
+            s->x[ch] += (s->acc[ch] << 4) + (r ^ ch);
+        }
+    }
+}
+
+static void CCM_DMAStart(void) {
+    DMA_ClearITPendingBit(CCM_BENCH_DMA_STREAM, CCM_BENCH_DMA_IT_TCIF);
+    DMA_SetCurrDataCounter(CCM_BENCH_DMA_STREAM, CCM_BENCH_DMA_WORDS);
+    DMA_Cmd(CCM_BENCH_DMA_STREAM, ENABLE);
+}
+
+static void CCM_DMAInit(void) {
+    DMA_InitTypeDef DMA_InitStructure;
+    NVIC_InitTypeDef NVIC_InitStructure;
+
+    RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA2, ENABLE);
+
+    DMA_DeInit(CCM_BENCH_DMA_STREAM);
+
+    while(DMA_GetCmdStatus(CCM_BENCH_DMA_STREAM) != DISABLE);
+
+    //内存到内存: 外设地址是源
+    DMA_InitStructure.DMA_Channel = CCM_BENCH_DMA_CHANNEL;
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)dma_src;
+    DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)dma_dst;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_MemoryToMemory;
+    DMA_InitStructure.DMA_BufferSize = CCM_BENCH_DMA_WORDS;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Enable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Word;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Word;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+    DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Enable;
+    DMA_InitStructure.DMA_FIFOThreshold = DMA_FIFOThreshold_Full;
+    DMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_INC4;
+    DMA_InitStructure.DMA_PeripheralBurst = DMA_PeripheralBurst_INC4;
+    DMA_Init(CCM_BENCH_DMA_STREAM, &DMA_InitStructure);
+    DMA_ITConfig(CCM_BENCH_DMA_STREAM, DMA_IT_TC, ENABLE);
+
+    NVIC_InitStructure.NVIC_IRQChannel = CCM_BENCH_DMA_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 3;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 3;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+}
+
+static uint32_t CCM_Run(CCM_Loop *s, uint32_t rounds, uint8_t dma) {
+    uint32_t start, cycles;
+
+    CCM_LoopReset(s);
+    dma_words = 0;
+
+    if(dma) {
+        dma_run = 1;
+        CCM_DMAStart();
+    }
+
+    start = DWT->CYCCNT;
+    CCM_Kernel(s, rounds);
+    cycles = DWT->CYCCNT - start;
+
+    //不再重启, 等最后一块搬完
+    dma_run = 0;
+
+    while(DMA_GetCmdStatus(CCM_BENCH_DMA_STREAM) != DISABLE);
+
+    return cycles;
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	CCM_IsrStackInit()
+* 功能说明:	中断改用CCM中的独立栈: 线程模式切到PSP继续使用SRAM中的启动栈, MSP指向CCM
+* 输    入: 无
+* 输    出: 无
+* 注意事项: 在 main 开头、使能任何中断之前调用一次; 切换前后SP的值相同, 当前函数的栈帧不受影响
+******************************************************************************************************************************************/
+void CCM_IsrStackInit(void) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+
+    __set_PSP(__get_MSP());
+    __set_CONTROL(__get_CONTROL() | CONTROL_SPSEL_Msk);
+    __ISB();
+
+    __set_MSP((uint32_t)&ccm_isr_stack[CCM_ISR_STACK_SIZE / 8]);
+
+    if(primask == 0) __enable_irq();
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	CCM_Bench()
+* 功能说明:	分别测量控制环状态在SRAM1和CCM中, 有无DMA搬运SRAM1时的执行周期
+* 输    入: uint32_t rounds				控制环执行轮数
+*			CCM_BenchResult *result		测试结果
+* 输    出: 无
+* 注意事项: 会占用 CCM_BENCH_DMA_STREAM 并改写其中断配置
+******************************************************************************************************************************************/
+void CCM_Bench(uint32_t rounds, CCM_BenchResult *result) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    CCM_DMA_CHECK(dma_src);
+    CCM_DMA_CHECK(dma_dst);
+    CCM_DMAInit();
+
+    result->SramIdle = CCM_Run(&sram_loop, rounds, 0);
+    result->SramDMA = CCM_Run(&sram_loop, rounds, 1);
+    result->DMAWords[0] = dma_words;
+    result->CcmIdle = CCM_Run(&ccm_loop, rounds, 0);
+    result->CcmDMA = CCM_Run(&ccm_loop, rounds, 1);
+    result->DMAWords[1] = dma_words;
+}
+
+void CCM_BENCH_DMA_IRQHandler(void) {
+    if(DMA_GetITStatus(CCM_BENCH_DMA_STREAM, CCM_BENCH_DMA_IT_TCIF) != RESET) {
+        DMA_ClearITPendingBit(CCM_BENCH_DMA_STREAM, CCM_BENCH_DMA_IT_TCIF);
+        dma_words += CCM_BENCH_DMA_WORDS;
+
+        if(dma_run) CCM_DMAStart();
+    }
+}
+
+#endif
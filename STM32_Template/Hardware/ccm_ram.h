@@ -0,0 +1,85 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : ccm_ram.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 64KB CCM数据RAM的变量放置(配合 Project/Template_ccm.sct)、CCM中的中断栈,
+  *				   以及CPU与DMA争用SRAM的对比测试
+  * Function List:
+  *		CCM_IsrStackInit
+  *		CCM_Bench
+  *		CCM_BENCH_DMA_IRQHandler
+  ******************************************************
+**/
+
+#ifndef __CCM_RAM_H_
+#define __CCM_RAM_H_
+
+#include "stm32f4xx_conf.h"
+
+//CCM只接在Cortex-M4的D总线上: DMA、以太网、USB都访问不到, 也不能执行代码, 没有位带.
+//正因为总线矩阵上没有别的主机, CPU访问CCM时不会被DMA搬运SRAM拖慢.
+//
+//放置规则:
+//  CCM_DATA  有初值的变量和查找表(正弦表、CRC表、校准曲线), 由 __main 从Flash复制
+//  CCM_BSS   控制环状态: PID积分项、滤波器历史、观测器状态, 由 __main 清零
+//  栈        启动文件的 STACK 段(main 和各驱动的局部变量)留在SRAM, 局部变量也可以作DMA缓冲区.
+//            main 开头调用 CCM_IsrStackInit 后线程模式改用PSP(仍是这段SRAM栈),
+//            MSP 指向CCM中 CCM_ISR_STACK_SIZE 字节的独立栈, 只有中断使用
+//  DMA缓冲区 普通全局/静态/局部变量(SRAM1/SRAM2)或 mem_pool 的 MEM_BULK,
+//            不能加 CCM_xxx, 也不能在中断里用局部变量(中断栈在CCM), 可用 CCM_DMA_CHECK 检查
+//没有CCM的型号(F401/F410/F411/F412/F413/F446)上 CCM_DATA/CCM_BSS 为空, 变量留在SRAM.
+#if defined(STM32F40_41xxx) || defined(STM32F427_437xx) || defined(STM32F429_439xx) || defined(STM32F469_479xx)
+
+#define CCM_SIZE                    0x10000
+#define CCM_ISR_STACK_SIZE          0x800       //中断栈字节数, 8的倍数, 按最深的中断嵌套估算
+
+#if defined(__CC_ARM)
+#define CCM_DATA                    __attribute__((section(".data.ccm")))
+#define CCM_BSS                     __attribute__((section(".bss.ccm"), zero_init))
+#else
+#define CCM_DATA                    __attribute__((section(".data.ccm")))
+#define CCM_BSS                     __attribute__((section(".bss.ccm")))	//AC6/GCC 以 .bss 开头的段就是ZI段
+#endif
+
+#define CCM_ADDR(p)                 (((uint32_t)(p) - CCMDATARAM_BASE) < CCM_SIZE)
+#define CCM_DMA_CHECK(p)            assert_param(!CCM_ADDR(p))
+
+//对比测试用的内存到内存DMA, 中断服务函数在ccm_ram.c中实现
+#define CCM_BENCH_DMA_STREAM        DMA2_Stream3
+#define CCM_BENCH_DMA_CHANNEL       DMA_Channel_0
+#define CCM_BENCH_DMA_IRQn          DMA2_Stream3_IRQn
+#define CCM_BENCH_DMA_IRQHandler    DMA2_Stream3_IRQHandler
+#define CCM_BENCH_DMA_IT_TCIF       DMA_IT_TCIF3
+
+#define CCM_BENCH_DMA_WORDS         4096	//每次搬运16KB, 源和目的都在SRAM1
+
+typedef struct {
+    uint32_t SramIdle;          //状态在SRAM, 无DMA, 周期数
+    uint32_t SramDMA;           //状态在SRAM, DMA同时搬运SRAM1
+    uint32_t CcmIdle;           //状态在CCM, 无DMA
+    uint32_t CcmDMA;            //状态在CCM, DMA同时搬运SRAM1
+    uint32_t DMAWords[2];       //两次DMA测试期间DMA搬运的字数: [0]状态在SRAM [1]状态在CCM
+} CCM_BenchResult;
+
+void CCM_IsrStackInit(void); // 中断改用CCM中的独立栈, 在 main 开头、使能中断前调用一次
+void CCM_Bench(uint32_t rounds, CCM_BenchResult *result); // 用同一段控制环代码分别测四种情况, rounds 一般取 10000
+
+#else
+
+#define CCM_DATA
+#define CCM_BSS
+#define CCM_ADDR(p)                 0
+#define CCM_DMA_CHECK(p)            ((void)0)
+#define CCM_IsrStackInit()          ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,702 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : crypto_stream.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					库里的 CRYP_AES_xxx / HASH_SHA1 等函数每次调用都重新装载密钥(解密还要重新做
+					密钥准备), 并且逐字写FIFO、轮询BUSY. 这里改成上下文式的 Init/Update/Final:
+					  1. 密钥、IV和GCM中间状态留在外设里, 连续调用同一个上下文时不再重新初始化;
+					     其他上下文插入使用时用 CRYP_SaveContext/HASH_SaveContext 换出, 再次使用时换回.
+					  2. 大块数据用DMA2: CRYP的IN/OUT两个数据流同时工作, 输入和输出重叠;
+					     HASH开启MDMAT, 多次DMA之间不自动开始最终计算.
+					  3. Update 启动DMA后立即返回, 调用者可以准备下一块数据, 下一次调用前自动等待.
+  * Function List:
+  *		Crypto_Stream_StructInit
+  *		Crypto_Stream_Init
+  *		AES_Stream_Init
+  *		AES_Stream_Aad
+  *		AES_Stream_Update
+  *		AES_Stream_Final
+  *		AES_Stream_Wait
+  *		HASH_Stream_Init
+  *		HASH_Stream_Update
+  *		HASH_Stream_Final
+  *		HASH_Stream_Wait
+  *		CRYPTO_OUT_DMA_IRQHandler
+  *		CRYPTO_HASH_DMA_IRQHandler
+  **********************************************************
+ */
+
+#include "crypto_stream.h"
+#include <string.h>
+
+#if defined(STM32F40_41xxx) || defined(STM32F427_437xx) || defined(STM32F429_439xx) || defined(STM32F469_479xx)
+
+#define AES_PHASE_HEADER            1
+#define AES_PHASE_PAYLOAD           2
+
+static AES_Stream_Ctx *aes_owner;               //当前占用CRYP外设的上下文
+static HASH_Stream_Ctx *hash_owner;             //当前占用HASH外设的上下文
+static AES_Stream_Ctx *volatile aes_pending;    //DMA进行中的上下文
+static HASH_Stream_Ctx *volatile hash_pending;
+static volatile uint8_t aes_dma_error;
+static volatile uint8_t hash_dma_error;
+static Crypto_Callback crypto_callback;
+
+static uint32_t Crypto_BE32(const uint8_t *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+//数据类型为8位, 硬件自己交换字节, 这里按小端整字读写(地址可以不对齐)
+static uint32_t Crypto_Load32(const uint8_t *p) {
+    uint32_t w;
+
+    memcpy(&w, p, 4);
+    return w;
+}
+
+static void Crypto_Store32(uint8_t *p, uint32_t w) {
+    memcpy(p, &w, 4);
+}
+
+static void Crypto_DMAStart(DMA_Stream_TypeDef *stream, uint32_t periph, const void *mem,
+                            uint32_t words, uint32_t dir, uint32_t burst, uint8_t it) {
+    DMA_InitTypeDef DMA_InitStructure;
+
+    DMA_DeInit(stream);
+
+    while(DMA_GetCmdStatus(stream) != DISABLE);
+
+    DMA_InitStructure.DMA_Channel = CRYPTO_DMA_CHANNEL;
+    DMA_InitStructure.DMA_PeripheralBaseAddr = periph;
+    DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)mem;
+    DMA_InitStructure.DMA_DIR = dir;
+    DMA_InitStructure.DMA_BufferSize = words;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Word;
+    //缓冲区不是4字节对齐时按字节访问内存, 由DMA FIFO拼成整字
+    DMA_InitStructure.DMA_MemoryDataSize = ((uint32_t)mem & 3) ? DMA_MemoryDataSize_Byte : DMA_MemoryDataSize_Word;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+    DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Enable;
+    DMA_InitStructure.DMA_FIFOThreshold = DMA_FIFOThreshold_Full;
+    DMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+    DMA_InitStructure.DMA_PeripheralBurst = burst;
+    DMA_Init(stream, &DMA_InitStructure);
+
+    if(it) DMA_ITConfig(stream, DMA_IT_TC | DMA_IT_TE, ENABLE);
+
+    DMA_Cmd(stream, ENABLE);
+}
+
+void Crypto_Stream_StructInit(Crypto_Stream_InitTypeDef *Crypto_InitStruct) {
+    Crypto_InitStruct->Callback = 0;
+    Crypto_InitStruct->NVIC_PreemptionPriority = 1;
+    Crypto_InitStruct->NVIC_SubPriority = 0;
+}
+
+void Crypto_Stream_Init(Crypto_Stream_InitTypeDef *Crypto_InitStruct) {
+    NVIC_InitTypeDef NVIC_InitStructure;
+
+    RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA2, ENABLE);
+    RCC_AHB2PeriphClockCmd(RCC_AHB2Periph_CRYP | RCC_AHB2Periph_HASH, ENABLE);
+
+    crypto_callback = Crypto_InitStruct->Callback;
+    aes_owner = 0;
+    hash_owner = 0;
+    aes_pending = 0;
+    hash_pending = 0;
+
+    NVIC_InitStructure.NVIC_IRQChannel = CRYPTO_OUT_DMA_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = Crypto_InitStruct->NVIC_PreemptionPriority;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = Crypto_InitStruct->NVIC_SubPriority;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+    NVIC_InitStructure.NVIC_IRQChannel = CRYPTO_HASH_DMA_IRQn;
+    NVIC_Init(&NVIC_InitStructure);
+}
+
+/*************************************** AES ***************************************/
+
+static ErrorStatus AES_WaitFlag(uint8_t flag, FlagStatus state) {
+    uint32_t counter = 0;
+
+    while(CRYP_GetFlagStatus(flag) != state) {
+        if(++counter == CRYPTO_TIMEOUT) return ERROR;
+    }
+
+    return SUCCESS;
+}
+
+//等到输入FIFO空且内核空闲
+static ErrorStatus AES_WaitIdle(void) {
+    if(AES_WaitFlag(CRYP_FLAG_IFEM, SET) != SUCCESS) return ERROR;
+
+    return AES_WaitFlag(CRYP_FLAG_BUSY, RESET);
+}
+
+//ECB/CBC解密需要先由加密密钥推出解密密钥
+static ErrorStatus AES_KeyPrepare(AES_Stream_Ctx *ctx) {
+    uint32_t cr = CRYP->CR & ~CRYP_CR_CRYPEN;
+    ErrorStatus status;
+
+    CRYP->CR = (cr & ~CRYP_CR_ALGOMODE) | CRYP_AlgoMode_AES_Key;
+    CRYP_KeyInit(&ctx->Key);
+    CRYP_Cmd(ENABLE);
+    status = AES_WaitFlag(CRYP_FLAG_BUSY, RESET);
+    CRYP->CR = cr;
+
+    return status;
+}
+
+//让 ctx 占用CRYP外设, 必要时换出当前上下文并换入 ctx 保存的状态
+static ErrorStatus AES_Acquire(AES_Stream_Ctx *ctx) {
+    if(aes_owner == ctx) return SUCCESS;
+
+    if(aes_owner != 0) {
+        if(CRYP_SaveContext(&aes_owner->Hw, &aes_owner->Key) != SUCCESS) return ERROR;
+
+        aes_owner->Saved = 1;
+    }
+
+    aes_owner = ctx;
+
+    if(ctx->Saved) {
+        ctx->Saved = 0;
+        CRYP_FIFOFlush();
+        CRYP_RestoreContext(&ctx->Hw);
+        CRYP_Cmd(DISABLE);
+
+        //保存的是原始密钥, 解密时换入后要重新做密钥准备
+        if(ctx->Dir == CRYP_AlgoDir_Decrypt &&
+                (ctx->Mode == CRYP_AlgoMode_AES_ECB || ctx->Mode == CRYP_AlgoMode_AES_CBC)) {
+            return AES_KeyPrepare(ctx);
+        }
+    }
+
+    return SUCCESS;
+}
+
+//GCM从头部阶段切换到有效负载阶段
+static ErrorStatus AES_EnterPayload(AES_Stream_Ctx *ctx) {
+    if(ctx->Mode != CRYP_AlgoMode_AES_GCM || ctx->Phase == AES_PHASE_PAYLOAD) return SUCCESS;
+
+    if(AES_WaitIdle() != SUCCESS) return ERROR;
+
+    CRYP_Cmd(DISABLE);
+    CRYP_PhaseConfig(CRYP_Phase_Payload);
+    ctx->Phase = AES_PHASE_PAYLOAD;
+
+    return SUCCESS;
+}
+
+//CPU逐块处理, 用于小块数据和不满16字节的末块
+static ErrorStatus AES_ProcessCpu(const uint8_t *in, uint8_t *out, uint32_t len) {
+    uint32_t i;
+
+    CRYP_Cmd(ENABLE);
+
+    for(; len >= 16; len -= 16) {
+        for(i = 0; i < 16; i += 4) CRYP_DataIn(Crypto_Load32(in + i));
+
+        if(AES_WaitFlag(CRYP_FLAG_OFNE, SET) != SUCCESS) return ERROR;
+
+        for(i = 0; i < 16; i += 4) Crypto_Store32(out + i, CRYP_DataOut());
+
+        in += 16;
+        out += 16;
+    }
+
+    return SUCCESS;
+}
+
+/**
+  * 简介:  初始化AES流上下文并装载密钥/IV。
+  * 参数:  Mode: CRYP_AlgoMode_AES_ECB/CBC/CTR/GCM (GCM仅F437/439/479)
+  *        Dir: CRYP_AlgoDir_Encrypt/CRYP_AlgoDir_Decrypt
+  *        Keysize: 128/192/256
+  *        IV: CBC/CTR为16字节, GCM为12字节(计数器从2开始), ECB忽略
+  * 返回值: SUCCESS/ERROR
+  */
+ErrorStatus AES_Stream_Init(AES_Stream_Ctx *ctx, uint32_t Mode, uint32_t Dir,
+                            const uint8_t *Key, uint16_t Keysize, const uint8_t *IV) {
+    CRYP_InitTypeDef CRYP_InitStructure;
+    CRYP_IVInitTypeDef CRYP_IVInitStructure;
+    uint32_t *keyreg;
+    uint32_t i;
+
+    if(Mode != CRYP_AlgoMode_AES_ECB && Mode != CRYP_AlgoMode_AES_CBC &&
+            Mode != CRYP_AlgoMode_AES_CTR && Mode != CRYP_AlgoMode_AES_GCM) {
+        return ERROR;
+    }
+
+    switch(Keysize) {
+        case 128:
+            CRYP_InitStructure.CRYP_KeySize = CRYP_KeySize_128b;
+            break;
+
+        case 192:
+            CRYP_InitStructure.CRYP_KeySize = CRYP_KeySize_192b;
+            break;
+
+        case 256:
+            CRYP_InitStructure.CRYP_KeySize = CRYP_KeySize_256b;
+            break;
+
+        default:
+            return ERROR;
+    }
+
+    if(AES_Stream_Wait() != SUCCESS) return ERROR;
+
+    //密钥右对齐存放: 128位用 Key2/Key3, 192位用 Key1~Key3, 256位用 Key0~Key3
+    CRYP_KeyStructInit(&ctx->Key);
+    keyreg = &ctx->Key.CRYP_Key0Left + (8 - Keysize / 32);
+
+    for(i = 0; i < Keysize / 32; i++) keyreg[i] = Crypto_BE32(Key + 4 * i);
+
+    ctx->Mode = Mode;
+    ctx->Dir = Dir;
+    ctx->AadLen = 0;
+    ctx->PayloadLen = 0;
+    ctx->Phase = AES_PHASE_PAYLOAD;
+    ctx->AadDone = 0;
+    ctx->Saved = 0;
+
+    if(AES_Acquire(ctx) != SUCCESS) return ERROR;
+
+    CRYP_Cmd(DISABLE);
+    CRYP_FIFOFlush();
+    CRYP_InitStructure.CRYP_AlgoDir = Dir;
+    CRYP_InitStructure.CRYP_AlgoMode = Mode;
+    CRYP_InitStructure.CRYP_DataType = CRYP_DataType_8b;
+    CRYP_Init(&CRYP_InitStructure);
+    CRYP_KeyInit(&ctx->Key);
+
+    if(Mode != CRYP_AlgoMode_AES_ECB) {
+        CRYP_IVInitStructure.CRYP_IV0Left = Crypto_BE32(IV);
+        CRYP_IVInitStructure.CRYP_IV0Right = Crypto_BE32(IV + 4);
+        CRYP_IVInitStructure.CRYP_IV1Left = Crypto_BE32(IV + 8);
+        CRYP_IVInitStructure.CRYP_IV1Right = (Mode == CRYP_AlgoMode_AES_GCM) ? 2 : Crypto_BE32(IV + 12);
+        CRYP_IVInit(&CRYP_IVInitStructure);
+    }
+
+    if(Dir == CRYP_AlgoDir_Decrypt && (Mode == CRYP_AlgoMode_AES_ECB || Mode == CRYP_AlgoMode_AES_CBC)) {
+        return AES_KeyPrepare(ctx);
+    }
+
+    if(Mode == CRYP_AlgoMode_AES_GCM) {
+        uint32_t counter = 0;
+
+        //初始阶段计算哈希子密钥, 完成后CRYPEN自动清零
+        CRYP_PhaseConfig(CRYP_Phase_Init);
+        CRYP_Cmd(ENABLE);
+
+        while(CRYP_GetCmdStatus() == ENABLE) {
+            if(++counter == CRYPTO_TIMEOUT) return ERROR;
+        }
+
+        //直接进入头部阶段, 这样被换出时保存的不会是初始阶段
+        CRYP_PhaseConfig(CRYP_Phase_Header);
+        ctx->Phase = AES_PHASE_HEADER;
+    }
+
+    return SUCCESS;
+}
+
+/**
+  * 简介:  输入GCM附加认证数据(AAD)。
+  * 注意:   可多次调用, 除最后一次外长度必须是16的整数倍; 必须在 AES_Stream_Update 之前。
+  * 返回值: SUCCESS/ERROR
+  */
+ErrorStatus AES_Stream_Aad(AES_Stream_Ctx *ctx, const uint8_t *Aad, uint32_t Len) {
+    uint8_t block[16];
+    const uint8_t *p;
+    uint32_t n, i;
+
+    if(ctx->Mode != CRYP_AlgoMode_AES_GCM || ctx->Phase != AES_PHASE_HEADER || ctx->AadDone) return ERROR;
+
+    if(AES_Stream_Wait() != SUCCESS || AES_Acquire(ctx) != SUCCESS) return ERROR;
+
+    CRYP_Cmd(ENABLE);
+    ctx->AadLen += Len;
+
+    while(Len) {
+        n = Len < 16 ? Len : 16;
+        p = Aad;
+
+        if(n < 16) {
+            //最后一块补零, 与GHASH的填充规则一致
+            memset(block, 0, sizeof(block));
+            memcpy(block, Aad, n);
+            p = block;
+            ctx->AadDone = 1;
+        }
+
+        if(AES_WaitFlag(CRYP_FLAG_IFEM, SET) != SUCCESS) return ERROR;
+
+        for(i = 0; i < 16; i += 4) CRYP_DataIn(Crypto_Load32(p + i));
+
+        Aad += n;
+        Len -= n;
+    }
+
+    return SUCCESS;
+}
+
+/**
+  * 简介:  加解密一段数据, 长度必须是16的整数倍。
+  * 注意:   长度 >= CRYPTO_DMA_MIN 时启动DMA后立即返回, In/Out 在传输完成前必须保持有效;
+  *         下一次调用或 AES_Stream_Wait 会等待其完成。
+  * 返回值: SUCCESS/ERROR
+  */
+ErrorStatus AES_Stream_Update(AES_Stream_Ctx *ctx, const uint8_t *In, uint8_t *Out, uint32_t Len) {
+    if(Len & 15) return ERROR;
+
+    if(AES_Stream_Wait() != SUCCESS || AES_Acquire(ctx) != SUCCESS) return ERROR;
+
+    if(AES_EnterPayload(ctx) != SUCCESS) return ERROR;
+
+    ctx->PayloadLen += Len;
+
+    if(Len < CRYPTO_DMA_MIN) return AES_ProcessCpu(In, Out, Len);
+
+    //先开输出DMA再开输入DMA, 两个方向同时传输
+    aes_pending = ctx;
+    Crypto_DMAStart(CRYPTO_OUT_DMA_STREAM, (uint32_t)&CRYP->DOUT, Out, Len / 4,
+                    DMA_DIR_PeripheralToMemory, DMA_PeripheralBurst_INC4, 1);
+    Crypto_DMAStart(CRYPTO_IN_DMA_STREAM, (uint32_t)&CRYP->DR, In, Len / 4,
+                    DMA_DIR_MemoryToPeripheral, DMA_PeripheralBurst_INC4, 0);
+    CRYP_Cmd(ENABLE);
+    CRYP_DMACmd(CRYP_DMAReq_DataIN | CRYP_DMAReq_DataOUT, ENABLE);
+
+    return SUCCESS;
+}
+
+/**
+  * 简介:  处理剩余数据并结束本次运算, GCM同时输出认证标签。
+  * 注意:   CTR和GCM解密的末块可以不满16字节; ECB/CBC必须是整块;
+  *         GCM加密的末块必须是整块(F4的CRYP不能排除填充字节对TAG的影响)。
+  *         GCM解密时由调用者比较 Tag 与收到的标签。
+  * 参数:  Tag: GCM输出16字节标签, 其他模式可为空
+  * 返回值: SUCCESS/ERROR
+  */
+ErrorStatus AES_Stream_Final(AES_Stream_Ctx *ctx, const uint8_t *In, uint8_t *Out, uint32_t Len, uint8_t Tag[16]) {
+    uint8_t block[16];
+    uint32_t full = Len & ~15u;
+    uint32_t rem = Len & 15u;
+    uint64_t bits;
+    uint32_t i;
+    ErrorStatus status = SUCCESS;
+
+    if(rem && ctx->Mode != CRYP_AlgoMode_AES_CTR &&
+            !(ctx->Mode == CRYP_AlgoMode_AES_GCM && ctx->Dir == CRYP_AlgoDir_Decrypt)) {
+        return ERROR;
+    }
+
+    if(full) status = AES_Stream_Update(ctx, In, Out, full);
+
+    if(status == SUCCESS) status = AES_Stream_Wait();
+
+    if(status == SUCCESS) status = AES_Acquire(ctx);
+
+    if(status == SUCCESS && rem) {
+        memset(block, 0, sizeof(block));
+        memcpy(block, In + full, rem);
+        status = AES_EnterPayload(ctx);
+
+        if(status == SUCCESS) status = AES_ProcessCpu(block, block, 16);
+
+        memcpy(Out + full, block, rem);
+        ctx->PayloadLen += rem;
+    }
+
+    if(status == SUCCESS && ctx->Mode == CRYP_AlgoMode_AES_GCM) {
+        status = AES_WaitIdle();
+
+        if(status == SUCCESS) {
+            CRYP_Cmd(DISABLE);
+            CRYP_PhaseConfig(CRYP_Phase_Final);
+            CRYP_Cmd(ENABLE);
+
+            //写入头部和有效负载的位长度
+            bits = (uint64_t)ctx->AadLen * 8;
+            CRYP_DataIn(__REV(bits >> 32));
+            CRYP_DataIn(__REV(bits));
+            bits = (uint64_t)ctx->PayloadLen * 8;
+            CRYP_DataIn(__REV(bits >> 32));
+            CRYP_DataIn(__REV(bits));
+
+            status = AES_WaitFlag(CRYP_FLAG_OFNE, SET);
+        }
+
+        if(status == SUCCESS) {
+            for(i = 0; i < 16; i += 4) Crypto_Store32(Tag + i, CRYP_DataOut());
+        }
+    }
+
+    //上下文结束, 不必再保存
+    CRYP_Cmd(DISABLE);
+
+    if(aes_owner == ctx) aes_owner = 0;
+
+    return status;
+}
+
+ErrorStatus AES_Stream_Wait(void) {
+    uint32_t counter = 0;
+
+    while(aes_pending != 0) {
+        if(++counter == CRYPTO_TIMEOUT) return ERROR;
+    }
+
+    if(aes_dma_error) {
+        aes_dma_error = 0;
+        return ERROR;
+    }
+
+    return SUCCESS;
+}
+
+/*************************************** HASH ***************************************/
+
+static ErrorStatus HASH_WaitIdle(void) {
+    uint32_t counter = 0;
+
+    while(HASH_GetFlagStatus(HASH_FLAG_BUSY) != RESET || HASH_GetFlagStatus(HASH_FLAG_DMAS) != RESET) {
+        if(++counter == CRYPTO_TIMEOUT) return ERROR;
+    }
+
+    return SUCCESS;
+}
+
+static ErrorStatus HASH_Acquire(HASH_Stream_Ctx *ctx) {
+    if(hash_owner == ctx) return SUCCESS;
+
+    if(HASH_WaitIdle() != SUCCESS) return ERROR;
+
+    if(hash_owner != 0) {
+        HASH_SaveContext(&hash_owner->Hw);
+        hash_owner->Saved = 1;
+    }
+
+    hash_owner = ctx;
+
+    if(ctx->Saved) {
+        ctx->Saved = 0;
+        HASH_RestoreContext(&ctx->Hw);
+    }
+
+    return SUCCESS;
+}
+
+//CPU写入数据, 最后不满一个字的部分补零, 不越界读
+static void HASH_Write(const uint8_t *p, uint32_t len) {
+    uint32_t w;
+
+    for(; len >= 4; len -= 4, p += 4) HASH_DataIn(Crypto_Load32(p));
+
+    if(len) {
+        w = 0;
+        memcpy(&w, p, len);
+        HASH_DataIn(w);
+    }
+}
+
+//写入消息最后一段并计算摘要
+static ErrorStatus HASH_Digest(const uint8_t *p, uint32_t len) {
+    HASH_SetLastWordValidBitsNbr(8 * (len % 4));
+    HASH_Write(p, len);
+    HASH_StartDigest();
+
+    return HASH_WaitIdle();
+}
+
+/**
+  * 简介:  初始化HASH流上下文。
+  * 参数:  Algo: HASH_AlgoSelection_SHA1/MD5 (SHA224/SHA256仅F437/439/479)
+  *        Key: HMAC密钥, 为空时做普通HASH; 该缓冲区在 HASH_Stream_Final 之前必须保持有效
+  * 返回值: SUCCESS/ERROR
+  */
+ErrorStatus HASH_Stream_Init(HASH_Stream_Ctx *ctx, uint32_t Algo, const uint8_t *Key, uint32_t KeyLen) {
+    HASH_InitTypeDef HASH_InitStructure;
+
+    if(HASH_Stream_Wait() != SUCCESS) return ERROR;
+
+    ctx->Algo = Algo;
+    ctx->Mode = Key ? HASH_AlgoMode_HMAC : HASH_AlgoMode_HASH;
+    ctx->Key = Key;
+    ctx->KeyLen = KeyLen;
+    ctx->TailLen = 0;
+    ctx->Saved = 0;
+
+    if(HASH_Acquire(ctx) != SUCCESS) return ERROR;
+
+    HASH_InitStructure.HASH_AlgoSelection = Algo;
+    HASH_InitStructure.HASH_AlgoMode = ctx->Mode;
+    HASH_InitStructure.HASH_DataType = HASH_DataType_8b;
+    HASH_InitStructure.HASH_HMACKeyType = (KeyLen > 64) ? HASH_HMACKeyType_LongKey : HASH_HMACKeyType_ShortKey;
+    HASH_Init(&HASH_InitStructure);
+    //多次DMA传输, 每次结束时不自动开始最终计算
+    HASH_AutoStartDigest(DISABLE);
+
+    //HMAC第一步: 输入密钥
+    if(ctx->Mode == HASH_AlgoMode_HMAC) return HASH_Digest(Key, KeyLen);
+
+    return SUCCESS;
+}
+
+/**
+  * 简介:  输入一段消息。
+  * 注意:   凑满64字节的整块部分写入外设(足够大时用DMA, 启动后立即返回, Data 在传输完成前
+  *         必须保持有效), 不满一块的部分拷贝到上下文里留到下次或 Final。
+  * 返回值: SUCCESS/ERROR
+  */
+ErrorStatus HASH_Stream_Update(HASH_Stream_Ctx *ctx, const uint8_t *Data, uint32_t Len) {
+    uint32_t n, blocks;
+
+    if(HASH_Stream_Wait() != SUCCESS || HASH_Acquire(ctx) != SUCCESS) return ERROR;
+
+    if(ctx->TailLen) {
+        n = 64 - ctx->TailLen;
+
+        if(n > Len) n = Len;
+
+        memcpy(ctx->Tail + ctx->TailLen, Data, n);
+        ctx->TailLen += n;
+        Data += n;
+        Len -= n;
+
+        if(ctx->TailLen < 64) return SUCCESS;
+
+        HASH_Write(ctx->Tail, 64);
+        ctx->TailLen = 0;
+    }
+
+    blocks = Len & ~63u;
+    memcpy(ctx->Tail, Data + blocks, Len - blocks);
+    ctx->TailLen = Len - blocks;
+
+    if(blocks < CRYPTO_DMA_MIN) {
+        HASH_Write(Data, blocks);
+        return SUCCESS;
+    }
+
+    hash_pending = ctx;
+    Crypto_DMAStart(CRYPTO_HASH_DMA_STREAM, (uint32_t)&HASH->DIN, Data, blocks / 4,
+                    DMA_DIR_MemoryToPeripheral, DMA_PeripheralBurst_Single, 1);
+    HASH_DMACmd(ENABLE);
+
+    return SUCCESS;
+}
+
+/**
+  * 简介:  结束消息并读出摘要。
+  * 参数:  Digest: MD5 16字节, SHA1 20字节, SHA224 28字节, SHA256 32字节
+  * 返回值: SUCCESS/ERROR
+  */
+ErrorStatus HASH_Stream_Final(HASH_Stream_Ctx *ctx, uint8_t *Digest) {
+    HASH_MsgDigest HASH_MessageDigest;
+    ErrorStatus status;
+    uint32_t words, i;
+
+    if(HASH_Stream_Wait() != SUCCESS || HASH_Acquire(ctx) != SUCCESS) return ERROR;
+
+    status = HASH_Digest(ctx->Tail, ctx->TailLen);
+
+    //HMAC最后一步: 再输入一次密钥
+    if(status == SUCCESS && ctx->Mode == HASH_AlgoMode_HMAC) status = HASH_Digest(ctx->Key, ctx->KeyLen);
+
+    if(status == SUCCESS) {
+        switch(ctx->Algo) {
+            case HASH_AlgoSelection_MD5:
+                words = 4;
+                break;
+
+            case HASH_AlgoSelection_SHA224:
+                words = 7;
+                break;
+
+            case HASH_AlgoSelection_SHA256:
+                words = 8;
+                break;
+
+            default:
+                words = 5;
+                break;
+        }
+
+        HASH_GetDigest(&HASH_MessageDigest);
+
+        for(i = 0; i < words; i++) Crypto_Store32(Digest + 4 * i, __REV(HASH_MessageDigest.Data[i]));
+    }
+
+    if(hash_owner == ctx) hash_owner = 0;
+
+    return status;
+}
+
+ErrorStatus HASH_Stream_Wait(void) {
+    uint32_t counter = 0;
+
+    while(hash_pending != 0) {
+        if(++counter == CRYPTO_TIMEOUT) return ERROR;
+    }
+
+    if(hash_dma_error) {
+        hash_dma_error = 0;
+        return ERROR;
+    }
+
+    return SUCCESS;
+}
+
+//CRYP输出DMA完成即整段数据处理完毕
+void CRYPTO_OUT_DMA_IRQHandler(void) {
+    AES_Stream_Ctx *ctx = aes_pending;
+
+    if(DMA_GetITStatus(CRYPTO_OUT_DMA_STREAM, CRYPTO_OUT_DMA_IT_TE) != RESET) {
+        DMA_ClearITPendingBit(CRYPTO_OUT_DMA_STREAM, CRYPTO_OUT_DMA_IT_TE);
+        DMA_Cmd(CRYPTO_IN_DMA_STREAM, DISABLE);
+        aes_dma_error = 1;
+    } else if(DMA_GetITStatus(CRYPTO_OUT_DMA_STREAM, CRYPTO_OUT_DMA_IT_TC) != RESET) {
+        DMA_ClearITPendingBit(CRYPTO_OUT_DMA_STREAM, CRYPTO_OUT_DMA_IT_TC);
+    } else {
+        return;
+    }
+
+    CRYP_DMACmd(CRYP_DMAReq_DataIN | CRYP_DMAReq_DataOUT, DISABLE);
+    aes_pending = 0;
+
+    if(crypto_callback) crypto_callback(ctx);
+}
+
+void CRYPTO_HASH_DMA_IRQHandler(void) {
+    HASH_Stream_Ctx *ctx = hash_pending;
+
+    if(DMA_GetITStatus(CRYPTO_HASH_DMA_STREAM, CRYPTO_HASH_DMA_IT_TE) != RESET) {
+        DMA_ClearITPendingBit(CRYPTO_HASH_DMA_STREAM, CRYPTO_HASH_DMA_IT_TE);
+        hash_dma_error = 1;
+    } else if(DMA_GetITStatus(CRYPTO_HASH_DMA_STREAM, CRYPTO_HASH_DMA_IT_TC) != RESET) {
+        DMA_ClearITPendingBit(CRYPTO_HASH_DMA_STREAM, CRYPTO_HASH_DMA_IT_TC);
+    } else {
+        return;
+    }
+
+    hash_pending = 0;
+
+    if(crypto_callback) crypto_callback(ctx);
+}
+
+#endif /* STM32F40_41xxx || STM32F427_437xx || STM32F429_439xx || STM32F469_479xx */
@@ -0,0 +1,105 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : crypto_stream.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : CRYP(AES)/HASH 上下文式流处理接口, 大块数据用DMA收发
+  *				   (仅带CRYP/HASH的型号: STM32F415/417/437/439/479)
+  * Function List:
+  *		Crypto_Stream_StructInit
+  *		Crypto_Stream_Init
+  *		AES_Stream_Init
+  *		AES_Stream_Aad
+  *		AES_Stream_Update
+  *		AES_Stream_Final
+  *		AES_Stream_Wait
+  *		HASH_Stream_Init
+  *		HASH_Stream_Update
+  *		HASH_Stream_Final
+  *		HASH_Stream_Wait
+  ******************************************************
+**/
+
+#ifndef __CRYPTO_STREAM_H_
+#define __CRYPTO_STREAM_H_
+
+#include "stm32f4xx_conf.h"
+
+#if defined(STM32F40_41xxx) || defined(STM32F427_437xx) || defined(STM32F429_439xx) || defined(STM32F469_479xx)
+
+//DMA2通道2: Stream6=CRYP_IN, Stream5=CRYP_OUT, Stream7=HASH_IN
+#define CRYPTO_IN_DMA_STREAM        DMA2_Stream6
+#define CRYPTO_OUT_DMA_STREAM       DMA2_Stream5
+#define CRYPTO_OUT_DMA_IRQn         DMA2_Stream5_IRQn
+#define CRYPTO_OUT_DMA_IRQHandler   DMA2_Stream5_IRQHandler
+#define CRYPTO_OUT_DMA_IT_TC        DMA_IT_TCIF5
+#define CRYPTO_OUT_DMA_IT_TE        DMA_IT_TEIF5
+#define CRYPTO_HASH_DMA_STREAM      DMA2_Stream7
+#define CRYPTO_HASH_DMA_IRQn        DMA2_Stream7_IRQn
+#define CRYPTO_HASH_DMA_IRQHandler  DMA2_Stream7_IRQHandler
+#define CRYPTO_HASH_DMA_IT_TC       DMA_IT_TCIF7
+#define CRYPTO_HASH_DMA_IT_TE       DMA_IT_TEIF7
+#define CRYPTO_DMA_CHANNEL          DMA_Channel_2
+
+#define CRYPTO_DMA_MIN              128         //小于该字节数的数据块由CPU直接读写FIFO
+#define CRYPTO_TIMEOUT              0x01000000  //等待忙标志/DMA完成的循环次数
+
+//DMA传输完成回调, 在DMA中断中执行, ctx 为发起传输的上下文
+typedef void (*Crypto_Callback)(void *ctx);
+
+typedef struct {
+    Crypto_Callback Callback;
+    uint8_t  NVIC_PreemptionPriority;
+    uint8_t  NVIC_SubPriority;
+} Crypto_Stream_InitTypeDef;
+
+//AES流上下文, 密钥/IV/GCM中间状态都保存在这里, 多个上下文可以交替使用
+typedef struct {
+    uint32_t Mode;                  //CRYP_AlgoMode_AES_ECB/CBC/CTR/GCM
+    uint32_t Dir;                   //CRYP_AlgoDir_Encrypt/Decrypt
+    CRYP_KeyInitTypeDef Key;
+    CRYP_Context Hw;                //被其他上下文抢占时保存的硬件状态
+    uint32_t AadLen;                //GCM附加数据字节数
+    uint32_t PayloadLen;            //GCM有效负载字节数
+    uint8_t  Phase;                 //GCM当前阶段
+    uint8_t  AadDone;               //附加数据最后一块不满16字节后不能再追加
+    uint8_t  Saved;                 //Hw 中是否有有效的保存状态
+} AES_Stream_Ctx;
+
+//HASH流上下文
+typedef struct {
+    uint32_t Algo;                  //HASH_AlgoSelection_SHA1/SHA224/SHA256/MD5
+    uint32_t Mode;                  //HASH_AlgoMode_HASH/HMAC
+    const uint8_t *Key;             //HMAC密钥, Final 时还要再输入一次, 需保持有效
+    uint32_t KeyLen;
+    HASH_Context Hw;
+    uint8_t  Tail[64];              //不满一个块(64字节)的剩余数据
+    uint8_t  TailLen;
+    uint8_t  Saved;
+} HASH_Stream_Ctx;
+
+void Crypto_Stream_StructInit(Crypto_Stream_InitTypeDef *Crypto_InitStruct); // 缺省无回调, 抢占优先级1
+void Crypto_Stream_Init(Crypto_Stream_InitTypeDef *Crypto_InitStruct); // 打开CRYP/HASH/DMA2时钟并配置中断
+
+ErrorStatus AES_Stream_Init(AES_Stream_Ctx *ctx, uint32_t Mode, uint32_t Dir,
+                            const uint8_t *Key, uint16_t Keysize, const uint8_t *IV); // 装载密钥和IV(GCM为12字节IV), 解密时只做一次密钥准备
+ErrorStatus AES_Stream_Aad(AES_Stream_Ctx *ctx, const uint8_t *Aad, uint32_t Len); // GCM附加数据, 须在 AES_Stream_Update 之前
+ErrorStatus AES_Stream_Update(AES_Stream_Ctx *ctx, const uint8_t *In, uint8_t *Out, uint32_t Len); // 处理16字节整数倍数据, 大块用DMA异步处理
+ErrorStatus AES_Stream_Final(AES_Stream_Ctx *ctx, const uint8_t *In, uint8_t *Out, uint32_t Len, uint8_t Tag[16]); // 处理剩余数据(CTR可不满16字节), GCM输出TAG
+ErrorStatus AES_Stream_Wait(void); // 等待AES的DMA传输完成
+
+ErrorStatus HASH_Stream_Init(HASH_Stream_Ctx *ctx, uint32_t Algo, const uint8_t *Key, uint32_t KeyLen); // Key为空则为普通HASH, 否则为HMAC
+ErrorStatus HASH_Stream_Update(HASH_Stream_Ctx *ctx, const uint8_t *Data, uint32_t Len); // 输入数据, 整块部分用DMA异步输入
+ErrorStatus HASH_Stream_Final(HASH_Stream_Ctx *ctx, uint8_t *Digest); // 输出摘要, 长度由算法决定(16/20/28/32字节)
+ErrorStatus HASH_Stream_Wait(void); // 等待HASH的DMA传输完成
+
+#endif /* STM32F40_41xxx || STM32F427_437xx || STM32F429_439xx || STM32F469_479xx */
+
+#endif
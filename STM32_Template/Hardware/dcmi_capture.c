@@ -0,0 +1,279 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : dcmi_capture.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					三个帧缓冲分别处于三种状态: DMA正在写, 最新完成(等待取走), 使用者
+					正在读. 每帧结束(DCMI FRAME中断, 处于场消隐期间)时停下DMA, 检查
+					长度, 把刚写完的缓冲和"最新完成"交换, 再让DMA去写换出来的那个.
+					使用者用 LDREX/STREX 把自己手中的缓冲和"最新完成"交换, 双方都不
+					需要等待对方, 也不会读到正在写的帧:
+					  - 使用者处理慢: 中间的帧被新帧覆盖, 计入 Dropped, 延迟不超过一帧
+					  - 使用者处理快: 没有新帧时 DCMI_Cap_Acquire 返回0
+					JPEG模式下帧长度从DMA剩余计数得到, 超出缓冲区的帧丢弃.
+  * Function List:
+  *		DCMI_Cap_StructInit
+  *		DCMI_Cap_Init
+  *		DCMI_Cap_Start
+  *		DCMI_Cap_Stop
+  *		DCMI_Cap_Snapshot
+  *		DCMI_Cap_Acquire
+  *		DCMI_Cap_GetStats
+  *		DCMI_IRQHandler
+  **********************************************************
+ */
+
+#include "dcmi_capture.h"
+
+#if defined(STM32F40_41xxx) || defined(STM32F427_437xx) || defined(STM32F429_439xx) || \
+    defined(STM32F446xx) || defined(STM32F469_479xx)
+
+#define DCMI_CAP_FRESH          0x80    //"最新完成"中的帧还没被取走
+#define DCMI_CAP_INDEX          0x03
+
+typedef struct {
+    DCMI_Cap_Frame Frame[DCMI_CAP_BUF_NUM];
+    uint32_t BufSize;
+    uint8_t  Jpeg;
+    uint8_t  Snapshot;
+    uint8_t  Write;                 //DMA正在写的缓冲, 只有中断修改
+    uint8_t  Read;                  //使用者手中的缓冲, 只有使用者修改
+    volatile uint32_t Latest;       //最新完成的缓冲 | DCMI_CAP_FRESH, 双方交换
+    volatile uint8_t Bad;           //本帧发生过溢出/同步错误
+    volatile uint8_t Running;
+    uint32_t Seq;
+} DCMI_Cap_Handle;
+
+static DCMI_Cap_Handle cap;
+static DCMI_Cap_Stats cap_stats;
+
+//让DMA从头写 cap.Write 指向的缓冲
+static void DCMI_Cap_Arm(void) {
+    DMA_ClearFlag(DCMI_CAP_DMA_STREAM, DCMI_CAP_DMA_FLAGS);
+    DCMI_CAP_DMA_STREAM->M0AR = (uint32_t)cap.Frame[cap.Write].Data;
+    DMA_SetCurrDataCounter(DCMI_CAP_DMA_STREAM, cap.BufSize / 4);
+    DMA_Cmd(DCMI_CAP_DMA_STREAM, ENABLE);
+    cap.Bad = 0;
+}
+
+//停下DMA(同时把FIFO中剩余的数据写入存储器), 返回本帧写入的字节数
+static uint32_t DCMI_Cap_Halt(void) {
+    DMA_Cmd(DCMI_CAP_DMA_STREAM, DISABLE);
+
+    while(DMA_GetCmdStatus(DCMI_CAP_DMA_STREAM) != DISABLE);
+
+    return cap.BufSize - DMA_GetCurrDataCounter(DCMI_CAP_DMA_STREAM) * 4;
+}
+
+//一帧结束: 检查后与"最新完成"交换, 被换下的未取走帧计为丢弃
+static void DCMI_Cap_FrameDone(void) {
+    uint32_t len = DCMI_Cap_Halt();
+    uint32_t old;
+
+    if(cap.Bad || len == 0 || (cap.Jpeg ? len == cap.BufSize : len != cap.BufSize)) {
+        cap_stats.Errors++;
+    } else {
+        cap.Frame[cap.Write].Length = len;
+        cap.Frame[cap.Write].Seq = ++cap.Seq;
+
+        old = cap.Latest;
+        cap.Latest = cap.Write | DCMI_CAP_FRESH;
+        cap.Write = old & DCMI_CAP_INDEX;
+        cap_stats.Frames++;
+
+        if(old & DCMI_CAP_FRESH) cap_stats.Dropped++;
+    }
+
+    if(cap.Snapshot) cap.Running = 0;
+    else DCMI_Cap_Arm();
+}
+
+void DCMI_Cap_StructInit(DCMI_Cap_InitTypeDef *DCMI_Cap_InitStruct) {
+    uint8_t i;
+
+    for(i = 0; i < DCMI_CAP_BUF_NUM; i++) DCMI_Cap_InitStruct->Buffer[i] = 0;
+
+    DCMI_Cap_InitStruct->BufSize = 0;
+    DCMI_Cap_InitStruct->PCKPolarity = DCMI_PCKPolarity_Rising;
+    DCMI_Cap_InitStruct->VSPolarity = DCMI_VSPolarity_Low;
+    DCMI_Cap_InitStruct->HSPolarity = DCMI_HSPolarity_Low;
+    DCMI_Cap_InitStruct->CaptureRate = DCMI_CaptureRate_All_Frame;
+    DCMI_Cap_InitStruct->Jpeg = 0;
+    DCMI_Cap_InitStruct->Snapshot = 0;
+    DCMI_Cap_InitStruct->CropX = 0;
+    DCMI_Cap_InitStruct->CropY = 0;
+    DCMI_Cap_InitStruct->CropW = 0;
+    DCMI_Cap_InitStruct->CropH = 0;
+    DCMI_Cap_InitStruct->BytesPerPixel = 2;
+    DCMI_Cap_InitStruct->NVIC_PreemptionPriority = 1;
+    DCMI_Cap_InitStruct->NVIC_SubPriority = 0;
+}
+
+ErrorStatus DCMI_Cap_Init(DCMI_Cap_InitTypeDef *DCMI_Cap_InitStruct) {
+    DCMI_InitTypeDef DCMI_InitStructure;
+    DCMI_CROPInitTypeDef DCMI_CROPInitStructure;
+    DMA_InitTypeDef DMA_InitStructure;
+    NVIC_InitTypeDef NVIC_InitStructure;
+    uint32_t size = DCMI_Cap_InitStruct->BufSize;
+    uint8_t i;
+
+    if(size == 0 || (size & 3) != 0 || size > DCMI_CAP_BUF_MAX) return ERROR;
+
+    for(i = 0; i < DCMI_CAP_BUF_NUM; i++) {
+        if(DCMI_Cap_InitStruct->Buffer[i] == 0 || ((uint32_t)DCMI_Cap_InitStruct->Buffer[i] & 3) != 0) return ERROR;
+
+        cap.Frame[i].Data = DCMI_Cap_InitStruct->Buffer[i];
+        cap.Frame[i].Length = 0;
+        cap.Frame[i].Seq = 0;
+    }
+
+    if(DCMI_Cap_InitStruct->CropW != 0 &&
+            (DCMI_Cap_InitStruct->CropH == 0 || DCMI_Cap_InitStruct->BytesPerPixel == 0 ||
+             (uint32_t)DCMI_Cap_InitStruct->CropW * DCMI_Cap_InitStruct->BytesPerPixel > 0x4000 ||
+             DCMI_Cap_InitStruct->CropH > 0x4000)) return ERROR;
+
+    cap.BufSize = size;
+    cap.Jpeg = DCMI_Cap_InitStruct->Jpeg;
+    cap.Snapshot = DCMI_Cap_InitStruct->Snapshot;
+    cap.Write = 0;
+    cap.Latest = 1;
+    cap.Read = 2;
+    cap.Running = 0;
+    cap.Seq = 0;
+    cap_stats.Frames = 0;
+    cap_stats.Dropped = 0;
+    cap_stats.Errors = 0;
+    cap_stats.Overruns = 0;
+
+    RCC_AHB2PeriphClockCmd(RCC_AHB2Periph_DCMI, ENABLE);
+    RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA2, ENABLE);
+
+    DCMI_DeInit();
+    DCMI_InitStructure.DCMI_CaptureMode = cap.Snapshot ? DCMI_CaptureMode_SnapShot : DCMI_CaptureMode_Continuous;
+    DCMI_InitStructure.DCMI_SynchroMode = DCMI_SynchroMode_Hardware;
+    DCMI_InitStructure.DCMI_PCKPolarity = DCMI_Cap_InitStruct->PCKPolarity;
+    DCMI_InitStructure.DCMI_VSPolarity = DCMI_Cap_InitStruct->VSPolarity;
+    DCMI_InitStructure.DCMI_HSPolarity = DCMI_Cap_InitStruct->HSPolarity;
+    DCMI_InitStructure.DCMI_CaptureRate = DCMI_Cap_InitStruct->CaptureRate;
+    DCMI_InitStructure.DCMI_ExtendedDataMode = DCMI_ExtendedDataMode_8b;
+    DCMI_Init(&DCMI_InitStructure);
+
+    //裁剪窗口以像素时钟计数, 水平方向要乘以每像素字节数
+    if(DCMI_Cap_InitStruct->CropW != 0) {
+        DCMI_CROPInitStructure.DCMI_VerticalStartLine = DCMI_Cap_InitStruct->CropY;
+        DCMI_CROPInitStructure.DCMI_HorizontalOffsetCount = DCMI_Cap_InitStruct->CropX * DCMI_Cap_InitStruct->BytesPerPixel;
+        DCMI_CROPInitStructure.DCMI_VerticalLineCount = DCMI_Cap_InitStruct->CropH - 1;
+        DCMI_CROPInitStructure.DCMI_CaptureCount = DCMI_Cap_InitStruct->CropW * DCMI_Cap_InitStruct->BytesPerPixel - 1;
+        DCMI_CROPConfig(&DCMI_CROPInitStructure);
+        DCMI_CROPCmd(ENABLE);
+    }
+
+    DCMI_JPEGCmd(cap.Jpeg ? ENABLE : DISABLE);
+
+    DMA_DeInit(DCMI_CAP_DMA_STREAM);
+
+    while(DMA_GetCmdStatus(DCMI_CAP_DMA_STREAM) != DISABLE);
+
+    DMA_InitStructure.DMA_Channel = DCMI_CAP_DMA_CHANNEL;
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&DCMI->DR;
+    DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)cap.Frame[0].Data;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralToMemory;
+    DMA_InitStructure.DMA_BufferSize = size / 4;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Word;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Word;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+    DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Enable;
+    DMA_InitStructure.DMA_FIFOThreshold = DMA_FIFOThreshold_Full;
+    DMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+    DMA_InitStructure.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+    DMA_Init(DCMI_CAP_DMA_STREAM, &DMA_InitStructure);
+
+    DCMI_ClearITPendingBit(DCMI_IT_FRAME | DCMI_IT_OVF | DCMI_IT_ERR);
+    DCMI_ITConfig(DCMI_IT_FRAME | DCMI_IT_OVF | DCMI_IT_ERR, ENABLE);
+
+    NVIC_InitStructure.NVIC_IRQChannel = DCMI_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = DCMI_Cap_InitStruct->NVIC_PreemptionPriority;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = DCMI_Cap_InitStruct->NVIC_SubPriority;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+
+    DCMI_Cmd(ENABLE);
+
+    return SUCCESS;
+}
+
+void DCMI_Cap_Start(void) {
+    if(cap.Running) return;
+
+    cap.Running = 1;
+    DCMI_Cap_Arm();
+    DCMI_CaptureCmd(ENABLE);
+}
+
+void DCMI_Cap_Stop(void) {
+    DCMI_CaptureCmd(DISABLE);
+    NVIC_DisableIRQ(DCMI_IRQn);
+    DCMI_Cap_Halt();
+    cap.Running = 0;
+    NVIC_EnableIRQ(DCMI_IRQn);
+}
+
+//快照模式下DCMI采完一帧自动清除 CAPTURE 位, 每次都要重新使能
+void DCMI_Cap_Snapshot(void) {
+    DCMI_Cap_Start();
+}
+
+const DCMI_Cap_Frame *DCMI_Cap_Acquire(void) {
+    uint32_t latest;
+
+    if((cap.Latest & DCMI_CAP_FRESH) == 0) return 0;
+
+    //中断在 LDREX/STREX 之间发生时 STREX 失败, 重新读取
+    do {
+        latest = __LDREXW(&cap.Latest);
+    } while(__STREXW(cap.Read, &cap.Latest) != 0);
+
+    cap.Read = latest & DCMI_CAP_INDEX;
+
+    return &cap.Frame[cap.Read];
+}
+
+void DCMI_Cap_GetStats(DCMI_Cap_Stats *stats) {
+    NVIC_DisableIRQ(DCMI_IRQn);
+    *stats = cap_stats;
+    NVIC_EnableIRQ(DCMI_IRQn);
+}
+
+void DCMI_IRQHandler(void) {
+    if(DCMI_GetITStatus(DCMI_IT_OVF) != RESET) {
+        DCMI_ClearITPendingBit(DCMI_IT_OVF);
+        cap_stats.Overruns++;
+        cap.Bad = 1;
+    }
+
+    if(DCMI_GetITStatus(DCMI_IT_ERR) != RESET) {
+        DCMI_ClearITPendingBit(DCMI_IT_ERR);
+        cap.Bad = 1;
+    }
+
+    if(DCMI_GetITStatus(DCMI_IT_FRAME) != RESET) {
+        DCMI_ClearITPendingBit(DCMI_IT_FRAME);
+
+        if(cap.Running) DCMI_Cap_FrameDone();
+    }
+}
+
+#endif /* STM32F40_41xxx || STM32F427_437xx || STM32F429_439xx || STM32F446xx || STM32F469_479xx */
@@ -0,0 +1,85 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : dcmi_capture.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : DCMI摄像头采集, DMA写三缓冲, 使用者总是取到最新的完整帧
+  * Function List:
+  *		DCMI_Cap_StructInit
+  *		DCMI_Cap_Init
+  *		DCMI_Cap_Start
+  *		DCMI_Cap_Stop
+  *		DCMI_Cap_Snapshot
+  *		DCMI_Cap_Acquire
+  *		DCMI_Cap_GetStats
+  ******************************************************
+**/
+
+#ifndef __DCMI_CAPTURE_H_
+#define __DCMI_CAPTURE_H_
+
+#include "stm32f4xx_conf.h"
+
+#if defined(STM32F40_41xxx) || defined(STM32F427_437xx) || defined(STM32F429_439xx) || \
+    defined(STM32F446xx) || defined(STM32F469_479xx)
+
+//DCMI只能由DMA2的Stream1或Stream7(通道1)搬运
+#define DCMI_CAP_DMA_STREAM         DMA2_Stream1
+#define DCMI_CAP_DMA_CHANNEL        DMA_Channel_1
+#define DCMI_CAP_DMA_FLAGS          (DMA_FLAG_TCIF1 | DMA_FLAG_HTIF1 | DMA_FLAG_TEIF1 | DMA_FLAG_DMEIF1 | DMA_FLAG_FEIF1)
+
+#define DCMI_CAP_BUF_NUM            3
+#define DCMI_CAP_BUF_MAX            (65535u * 4)    //DMA一次最多搬运65535个字
+
+typedef struct {
+    uint8_t *Data;                  //帧数据, 指向三缓冲之一
+    uint32_t Length;                //有效字节数, JPEG时为实际长度
+    uint32_t Seq;                   //帧序号, 相邻两次取到的序号差减1即丢掉的帧数
+} DCMI_Cap_Frame;
+
+typedef struct {
+    uint8_t *Buffer[DCMI_CAP_BUF_NUM]; //三个帧缓冲, 4字节对齐, 可在SRAM或SDRAM
+    uint32_t BufSize;               //每个缓冲区字节数, 4的倍数, 不超过 DCMI_CAP_BUF_MAX; 非JPEG时须等于一帧(裁剪后)的字节数
+
+    uint16_t PCKPolarity;           //DCMI_PCKPolarity_xxx
+    uint16_t VSPolarity;            //DCMI_VSPolarity_xxx
+    uint16_t HSPolarity;            //DCMI_HSPolarity_xxx
+    uint16_t CaptureRate;           //DCMI_CaptureRate_xxx, 硬件丢帧降低帧率
+    uint8_t  Jpeg;                  //1: 摄像头输出JPEG, 帧长度不固定
+    uint8_t  Snapshot;              //1: 每次 DCMI_Cap_Snapshot 只采一帧; 0: 连续采集
+
+    uint16_t CropX;                 //裁剪窗口, 单位为像素; CropW=0 不裁剪
+    uint16_t CropY;
+    uint16_t CropW;
+    uint16_t CropH;
+    uint8_t  BytesPerPixel;         //每像素占几个像素时钟(RGB565/YUV422为2), 用于换算裁剪窗口
+
+    uint8_t  NVIC_PreemptionPriority;
+    uint8_t  NVIC_SubPriority;
+} DCMI_Cap_InitTypeDef;
+
+typedef struct {
+    uint32_t Frames;                //已交给使用者的完整帧数
+    uint32_t Dropped;               //使用者还没来得及取就被更新的帧覆盖的帧数
+    uint32_t Errors;                //长度不对/JPEG超出缓冲区/同步错误而丢弃的帧数
+    uint32_t Overruns;              //DCMI FIFO溢出(DMA来不及搬运)次数
+} DCMI_Cap_Stats;
+
+void DCMI_Cap_StructInit(DCMI_Cap_InitTypeDef *DCMI_Cap_InitStruct); // 填充缺省值: 连续采集, 不裁剪, 全帧率
+ErrorStatus DCMI_Cap_Init(DCMI_Cap_InitTypeDef *DCMI_Cap_InitStruct); // 配置DCMI/DMA/中断, 参数非法返回 ERROR; GPIO和摄像头寄存器由调用者配置
+void DCMI_Cap_Start(void); // 开始连续采集
+void DCMI_Cap_Stop(void); // 停止采集
+void DCMI_Cap_Snapshot(void); // 快照模式下采集一帧, 结果同样用 DCMI_Cap_Acquire 取
+const DCMI_Cap_Frame *DCMI_Cap_Acquire(void); // 取最新的完整帧, 没有新帧返回0; 取到的帧在下一次成功取帧之前不会被覆盖
+void DCMI_Cap_GetStats(DCMI_Cap_Stats *stats); // 读取统计计数
+
+#endif /* STM32F40_41xxx || STM32F427_437xx || STM32F429_439xx || STM32F446xx || STM32F469_479xx */
+
+#endif
@@ -0,0 +1,383 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : dfsdm_mic.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					PDM麦克风 -> DFSDM通道 -> Sinc(CIC)硬件抽取 -> DMA循环缓冲 -> 去直流 -> FIR抽取 -> 回调
+					每个麦克风独占一个滤波器和一个DMA数据流, 除Filter0外的滤波器都打开RSYNC,
+					由Filter0的软件启动同时启动, 因此各麦克风的第n个采样是同一时刻的.
+					只有所有麦克风的同一个半缓冲区都写满后才处理并交付一帧.
+					CKOUT和DATIN引脚的复用功能由使用者在调用 DFSDM_Mic_Init 前配置.
+  * Function List:
+  *		DFSDM_Mic_StructInit
+  *		DFSDM_Mic_Init
+  *		DFSDM_Mic_Start
+  *		DFSDM_Mic_Stop
+  *		DFSDM_Mic_IRQHandler
+  *		DFSDM_Mic_GetStats
+  **********************************************************
+ */
+
+#include "dfsdm_mic.h"
+#include <string.h>
+
+#if defined(STM32F412xG) || defined(STM32F413_423xx)
+
+typedef struct {
+    int32_t x1;                         //去直流: 上一个输入
+    int32_t y1;                         //去直流: 上一个输出
+    //FIR工作区: 前 FirTaps-1 个为上一块留下的历史, 后面接本块去直流后的数据
+    int32_t work[DFSDM_MIC_FIR_TAPS_MAX - 1 + DFSDM_MIC_BLOCK_MAX];
+    int32_t out[DFSDM_MIC_BLOCK_MAX];
+} DFSDM_Mic_State;
+
+typedef struct {
+    DFSDM_Mic_InitTypeDef cfg;
+    DFSDM_Mic_State state[DFSDM_MIC_MAX];
+    const int32_t *frame[DFSDM_MIC_MAX];
+    volatile uint8_t ready[2];          //每个半缓冲区已写满的麦克风位图
+    uint8_t all;                        //所有麦克风的位图
+} DFSDM_Mic_Handle;
+
+static DFSDM_Mic_Handle mic;
+static DFSDM_Mic_Stats mic_stats;
+
+//DMA_IT_xxIFn 按数据流编号排列, 用于由数据流地址查找中断标志
+static const uint32_t DFSDM_Mic_DMA_TC[8] = {
+    DMA_IT_TCIF0, DMA_IT_TCIF1, DMA_IT_TCIF2, DMA_IT_TCIF3,
+    DMA_IT_TCIF4, DMA_IT_TCIF5, DMA_IT_TCIF6, DMA_IT_TCIF7
+};
+static const uint32_t DFSDM_Mic_DMA_HT[8] = {
+    DMA_IT_HTIF0, DMA_IT_HTIF1, DMA_IT_HTIF2, DMA_IT_HTIF3,
+    DMA_IT_HTIF4, DMA_IT_HTIF5, DMA_IT_HTIF6, DMA_IT_HTIF7
+};
+static const uint32_t DFSDM_Mic_DMA_TE[8] = {
+    DMA_IT_TEIF0, DMA_IT_TEIF1, DMA_IT_TEIF2, DMA_IT_TEIF3,
+    DMA_IT_TEIF4, DMA_IT_TEIF5, DMA_IT_TEIF6, DMA_IT_TEIF7
+};
+
+//数据流寄存器从控制器基址+0x10开始, 每个数据流0x18字节
+static uint8_t DFSDM_Mic_StreamIndex(DMA_Stream_TypeDef *DMAy_Streamx) {
+    return (uint8_t)((((uint32_t)DMAy_Streamx & 0xFF) - 0x10) / 0x18);
+}
+
+static void DFSDM_Mic_Enable(FunctionalState NewState) {
+#if defined(STM32F412xG)
+    DFSDM_Command(NewState);
+#else
+    DFSDM_Cmd(mic.cfg.Instance, NewState);
+#endif
+}
+
+static void DFSDM_Mic_ClkOut(uint32_t divider) {
+#if defined(STM32F412xG)
+    DFSDM_ConfigClkOutputSource(DFSDM_ClkOutSource_SysClock);
+    DFSDM_ConfigClkOutputDivider(divider);
+#else
+    DFSDM_ConfigClkOutputSource(mic.cfg.Instance, DFSDM_ClkOutSource_SysClock);
+    DFSDM_ConfigClkOutputDivider(mic.cfg.Instance, divider);
+#endif
+}
+
+//一个麦克风半缓冲区的后级处理, 返回输出采样数
+//RDATAR格式: [31:8]为24位有符号数据, [7:0]为通道号和状态, 算术右移8位得到数据
+static uint32_t DFSDM_Mic_Process(uint8_t m, const int32_t *raw) {
+    DFSDM_Mic_State *st = &mic.state[m];
+    uint32_t n = mic.cfg.BlockSamples;
+    uint32_t taps = mic.cfg.FirTaps;
+    int32_t *x = &st->work[taps ? taps - 1 : 0];
+    int32_t alpha = mic.cfg.DcAlpha;
+    int32_t in, y;
+    uint32_t i, k, out;
+    int64_t acc;
+    const int16_t *h;
+    const int32_t *p;
+
+    //去直流: y[n] = x[n] - x[n-1] + a*y[n-1]
+    if(alpha) {
+        for(i = 0; i < n; i++) {
+            in = raw[i] >> 8;
+            y = in - st->x1 + (int32_t)(((int64_t)alpha * st->y1) >> 15);
+            st->x1 = in;
+            st->y1 = y;
+            x[i] = y;
+        }
+    } else {
+        for(i = 0; i < n; i++) x[i] = raw[i] >> 8;
+    }
+
+    if(taps == 0) {
+        mic.frame[m] = x;
+        return n;
+    }
+
+    //抽取FIR, 只计算需要输出的点; 系数按 h[0] 对应最新采样排列
+    out = 0;
+
+    for(i = mic.cfg.FirDecimation - 1; i < n; i += mic.cfg.FirDecimation) {
+        acc = 0;
+        h = mic.cfg.FirCoeffs;
+        p = &x[i];
+
+        for(k = 0; k < taps; k++) {
+            acc += (int64_t)(*p--) * (*h++);
+        }
+
+        st->out[out++] = (int32_t)(acc >> 15);
+    }
+
+    //保留最后 taps-1 个输入作为下一块的历史
+    for(k = 0; k < taps - 1; k++) {
+        st->work[k] = x[n - (taps - 1) + k];
+    }
+
+    mic.frame[m] = st->out;
+    return out;
+}
+
+//所有麦克风同一半缓冲区到齐, 逐个处理并交付
+static void DFSDM_Mic_Deliver(uint8_t half) {
+    uint32_t block = mic.cfg.BlockSamples;
+    uint32_t samples = 0;
+    uint8_t m;
+
+    for(m = 0; m < mic.cfg.Mics; m++) {
+        samples = DFSDM_Mic_Process(m, &mic.cfg.DMA_Buffer[(2 * m + half) * block]);
+    }
+
+    mic_stats.Frames++;
+    mic.cfg.Callback(mic.frame, mic.cfg.Mics, samples);
+}
+
+//缺省配置: Sinc4, FOSR=64, 去直流开启, 不用FIR
+//系统时钟100MHz时 CKOUT=100M/40=2.5MHz, Sinc4 64倍抽取后约39kHz
+void DFSDM_Mic_StructInit(DFSDM_Mic_InitTypeDef *DFSDM_Mic_InitStruct) {
+    DFSDM_Mic_InitStruct->Instance = 1;
+    DFSDM_Mic_InitStruct->Mics = 0;
+    DFSDM_Mic_InitStruct->Mic = 0;
+    DFSDM_Mic_InitStruct->ClkOutDivider = 40;
+    DFSDM_Mic_InitStruct->SincOrder = DFSDM_SincOrder_Sinc4;
+    DFSDM_Mic_InitStruct->FilterOversampling = 64;
+    DFSDM_Mic_InitStruct->DataRightShift = 0;
+    DFSDM_Mic_InitStruct->DMA_Buffer = 0;
+    DFSDM_Mic_InitStruct->BlockSamples = 0;
+    DFSDM_Mic_InitStruct->DcAlpha = 32604;
+    DFSDM_Mic_InitStruct->FirCoeffs = 0;
+    DFSDM_Mic_InitStruct->FirTaps = 0;
+    DFSDM_Mic_InitStruct->FirDecimation = 1;
+    DFSDM_Mic_InitStruct->Callback = 0;
+    DFSDM_Mic_InitStruct->NVIC_PreemptionPriority = 0;
+    DFSDM_Mic_InitStruct->NVIC_SubPriority = 0;
+}
+
+ErrorStatus DFSDM_Mic_Init(DFSDM_Mic_InitTypeDef *DFSDM_Mic_InitStruct) {
+    DFSDM_TransceiverInitTypeDef DFSDM_TransceiverInitStructure;
+    DFSDM_FilterInitTypeDef DFSDM_FilterInitStructure;
+    DMA_InitTypeDef DMA_InitStructure;
+    NVIC_InitTypeDef NVIC_InitStructure;
+    const DFSDM_Mic_TypeDef *m;
+    uint8_t i;
+
+    if(DFSDM_Mic_InitStruct->Mics == 0 || DFSDM_Mic_InitStruct->Mics > DFSDM_MIC_MAX ||
+            DFSDM_Mic_InitStruct->Mic == 0 || DFSDM_Mic_InitStruct->DMA_Buffer == 0 ||
+            DFSDM_Mic_InitStruct->Callback == 0 || DFSDM_Mic_InitStruct->BlockSamples == 0 ||
+            DFSDM_Mic_InitStruct->BlockSamples > DFSDM_MIC_BLOCK_MAX ||
+            DFSDM_Mic_InitStruct->FirTaps > DFSDM_MIC_FIR_TAPS_MAX ||
+            DFSDM_Mic_InitStruct->FirDecimation == 0 ||
+            (DFSDM_Mic_InitStruct->BlockSamples % DFSDM_Mic_InitStruct->FirDecimation) != 0) {
+        return ERROR;
+    }
+
+    if(DFSDM_Mic_InitStruct->FirTaps != 0 && DFSDM_Mic_InitStruct->FirCoeffs == 0) return ERROR;
+
+    if(DFSDM_Mic_InitStruct->FirTaps == 0 && DFSDM_Mic_InitStruct->FirDecimation != 1) return ERROR;
+
+#if defined(STM32F412xG)
+
+    if(DFSDM_Mic_InitStruct->Instance != 1) return ERROR;
+
+#endif
+
+    if(DFSDM_Mic_InitStruct->Instance == 1 && DFSDM_Mic_InitStruct->Mics > DFSDM_MIC_DFSDM1_MAX) return ERROR;
+
+    mic.cfg = *DFSDM_Mic_InitStruct;
+    mic.ready[0] = 0;
+    mic.ready[1] = 0;
+    mic.all = (uint8_t)((1u << mic.cfg.Mics) - 1);
+
+    for(i = 0; i < mic.cfg.Mics; i++) {
+        mic.state[i].x1 = 0;
+        mic.state[i].y1 = 0;
+        memset(mic.state[i].work, 0, sizeof(mic.state[i].work));
+    }
+
+    RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA2, ENABLE);
+#if defined(STM32F412xG)
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_DFSDM1, ENABLE);
+#else
+    RCC_APB2PeriphClockCmd(mic.cfg.Instance == 1 ? RCC_APB2Periph_DFSDM1 : RCC_APB2Periph_DFSDM2, ENABLE);
+#endif
+
+    DFSDM_Mic_Enable(DISABLE);
+    DFSDM_Mic_ClkOut(mic.cfg.ClkOutDivider);
+
+    DFSDM_FilterInitStructure.DFSDM_SincOrder = mic.cfg.SincOrder;
+    DFSDM_FilterInitStructure.DFSDM_FilterOversamplingRatio = mic.cfg.FilterOversampling;
+    DFSDM_FilterInitStructure.DFSDM_IntegratorOversamplingRatio = 1;
+
+    for(i = 0; i < mic.cfg.Mics; i++) {
+        m = &mic.cfg.Mic[i];
+
+        //串行通道: SPI接口, 时钟取自内部CKOUT, 24位数据右移对齐
+        DFSDM_TransceiverStructInit(&DFSDM_TransceiverInitStructure);
+        DFSDM_TransceiverInitStructure.DFSDM_Interface = m->Interface;
+        DFSDM_TransceiverInitStructure.DFSDM_Clock = DFSDM_Clock_Internal;
+        DFSDM_TransceiverInitStructure.DFSDM_Input = DFSDM_Input_External;
+        DFSDM_TransceiverInitStructure.DFSDM_Redirection = m->Redirection;
+        DFSDM_TransceiverInitStructure.DFSDM_PackingMode = DFSDM_PackingMode_Standard;
+        DFSDM_TransceiverInitStructure.DFSDM_DataRightShift = mic.cfg.DataRightShift;
+        DFSDM_TransceiverInitStructure.DFSDM_Offset = 0;
+        DFSDM_TransceiverInitStructure.DFSDM_CLKAbsenceDetector = DFSDM_CLKAbsenceDetector_Disable;
+        DFSDM_TransceiverInitStructure.DFSDM_ShortCircuitDetector = DFSDM_ShortCircuitDetector_Disable;
+        DFSDM_TransceiverInit(m->Channel, &DFSDM_TransceiverInitStructure);
+
+        //滤波器: 常规组连续转换同一通道(快速模式), 结果由DMA读走
+        DFSDM_FilterCmd(m->Filter, DISABLE);
+        DFSDM_FilterInit(m->Filter, &DFSDM_FilterInitStructure);
+        DFSDM_SelectRegularChannel(m->Filter, m->RegularChannel);
+        DFSDM_RegularContinuousModeCmd(m->Filter, ENABLE);
+        DFSDM_FastModeCmd(m->Filter, ENABLE);
+        DFSDM_DMATransferConfig(m->Filter, DFSDM_DMAConversionMode_Regular, ENABLE);
+
+        //除第一个外都跟随 Filter0 的软件启动, 保证各麦克风采样对齐
+        if(i != 0) DFSDM_SynchronousFilter0RegularStart(m->Filter);
+
+        //DMA: RDATAR -> 本麦克风的双半缓冲区, 循环模式
+        DMA_DeInit(m->DMA_Stream);
+
+        while(DMA_GetCmdStatus(m->DMA_Stream) != DISABLE);
+
+        DMA_InitStructure.DMA_Channel = m->DMA_Channel;
+        DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&m->Filter->FLTRDATAR;
+        DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)&mic.cfg.DMA_Buffer[2 * i * mic.cfg.BlockSamples];
+        DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralToMemory;
+        DMA_InitStructure.DMA_BufferSize = 2 * mic.cfg.BlockSamples;
+        DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+        DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+        DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Word;
+        DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Word;
+        DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+        DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+        DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Disable;
+        DMA_InitStructure.DMA_FIFOThreshold = DMA_FIFOThreshold_HalfFull;
+        DMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+        DMA_InitStructure.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+        DMA_Init(m->DMA_Stream, &DMA_InitStructure);
+        DMA_ITConfig(m->DMA_Stream, DMA_IT_HT | DMA_IT_TC | DMA_IT_TE, ENABLE);
+
+        NVIC_InitStructure.NVIC_IRQChannel = m->DMA_IRQn;
+        NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = mic.cfg.NVIC_PreemptionPriority;
+        NVIC_InitStructure.NVIC_IRQChannelSubPriority = mic.cfg.NVIC_SubPriority;
+        NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+        NVIC_Init(&NVIC_InitStructure);
+    }
+
+    mic_stats.Frames = 0;
+    mic_stats.Overrun = 0;
+    mic_stats.Misaligned = 0;
+    mic_stats.DmaError = 0;
+
+    return SUCCESS;
+}
+
+//先打开所有DMA/通道/滤波器, 最后软件启动Filter0, RSYNC的滤波器同时开始转换
+void DFSDM_Mic_Start(void) {
+    uint8_t i;
+
+    mic.ready[0] = 0;
+    mic.ready[1] = 0;
+
+    for(i = 0; i < mic.cfg.Mics; i++) {
+        DMA_Cmd(mic.cfg.Mic[i].DMA_Stream, ENABLE);
+        DFSDM_ChannelCmd(mic.cfg.Mic[i].Channel, ENABLE);
+    }
+
+    DFSDM_Mic_Enable(ENABLE);
+
+    for(i = 0; i < mic.cfg.Mics; i++) {
+        DFSDM_ClearFlag(mic.cfg.Mic[i].Filter, DFSDM_CLEARF_ROVR);
+        DFSDM_FilterCmd(mic.cfg.Mic[i].Filter, ENABLE);
+    }
+
+    DFSDM_StartSoftwareRegularConversion(mic.cfg.Mic[0].Filter);
+}
+
+void DFSDM_Mic_Stop(void) {
+    uint8_t i;
+
+    for(i = 0; i < mic.cfg.Mics; i++) {
+        DFSDM_FilterCmd(mic.cfg.Mic[i].Filter, DISABLE);
+        DFSDM_ChannelCmd(mic.cfg.Mic[i].Channel, DISABLE);
+        DMA_Cmd(mic.cfg.Mic[i].DMA_Stream, DISABLE);
+    }
+
+    DFSDM_Mic_Enable(DISABLE);
+}
+
+//DMA半满/全满: 记录该麦克风的半缓冲区已写满, 所有麦克风到齐后交付一帧
+//某个麦克风同一半缓冲区再次到达而其他麦克风还没到, 说明它们已经错开, 计入 Misaligned
+void DFSDM_Mic_IRQHandler(DMA_Stream_TypeDef *DMAy_Streamx) {
+    uint8_t s = DFSDM_Mic_StreamIndex(DMAy_Streamx);
+    uint8_t half, bit = 0, i;
+
+    for(i = 0; i < mic.cfg.Mics; i++) {
+        if(mic.cfg.Mic[i].DMA_Stream == DMAy_Streamx) {
+            bit = (uint8_t)(1u << i);
+
+            if(DFSDM_GetFlagStatus(mic.cfg.Mic[i].Filter, DFSDM_FLAG_ROVR) != RESET) {
+                DFSDM_ClearFlag(mic.cfg.Mic[i].Filter, DFSDM_CLEARF_ROVR);
+                mic_stats.Overrun++;
+            }
+
+            break;
+        }
+    }
+
+    if(DMA_GetITStatus(DMAy_Streamx, DFSDM_Mic_DMA_TE[s]) != RESET) {
+        DMA_ClearITPendingBit(DMAy_Streamx, DFSDM_Mic_DMA_TE[s]);
+        mic_stats.DmaError++;
+    }
+
+    for(half = 0; half < 2; half++) {
+        uint32_t it = half ? DFSDM_Mic_DMA_TC[s] : DFSDM_Mic_DMA_HT[s];
+
+        if(DMA_GetITStatus(DMAy_Streamx, it) == RESET) continue;
+
+        DMA_ClearITPendingBit(DMAy_Streamx, it);
+
+        if(mic.ready[half] & bit) mic_stats.Misaligned++;
+
+        mic.ready[half] |= bit;
+
+        if(mic.ready[half] == mic.all) {
+            mic.ready[half] = 0;
+            DFSDM_Mic_Deliver(half);
+        }
+    }
+}
+
+void DFSDM_Mic_GetStats(DFSDM_Mic_Stats *stats) {
+    *stats = mic_stats;
+}
+
+#endif /* STM32F412xG || STM32F413_423xx */
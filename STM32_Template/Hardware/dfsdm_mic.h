@@ -0,0 +1,93 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : dfsdm_mic.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : DFSDM数字麦克风阵列采集(仅STM32F412xG/STM32F413_423xx)
+  * Function List:
+  *		DFSDM_Mic_StructInit
+  *		DFSDM_Mic_Init
+  *		DFSDM_Mic_Start
+  *		DFSDM_Mic_Stop
+  *		DFSDM_Mic_IRQHandler
+  *		DFSDM_Mic_GetStats
+  ******************************************************
+**/
+
+#ifndef __DFSDM_MIC_H_
+#define __DFSDM_MIC_H_
+
+#include "stm32f4xx_conf.h"
+
+#if defined(STM32F412xG) || defined(STM32F413_423xx)
+
+#define DFSDM_MIC_MAX               4       //每个麦克风占用一个滤波器, DFSDM2最多4个
+#define DFSDM_MIC_DFSDM1_MAX        2       //DFSDM1只有2个滤波器(F412只有DFSDM1)
+#define DFSDM_MIC_BLOCK_MAX         256     //每半缓冲区最多采样数(Sinc抽取后)
+#define DFSDM_MIC_FIR_TAPS_MAX      64
+
+//一个麦克风的硬件连接
+//两个麦克风共用一根数据线时(L/R), 一个用上升沿采样, 另一个用下降沿采样且开启重定向
+typedef struct {
+    DFSDM_Channel_TypeDef *Channel;     //DFSDMx_Channely
+    uint32_t Interface;                 //DFSDM_Interface_SPI_RisingEdge / DFSDM_Interface_SPI_FallingEdge
+    uint32_t Redirection;               //DFSDM_Redirection_Enabled: 数据取自通道 y+1 的引脚
+    uint32_t RegularChannel;            //DFSDM_RegularChannely, 与 Channel 对应
+    DFSDM_Filter_TypeDef *Filter;       //DFSDMx_Filterz, 第一个麦克风的滤波器必须是 Filter0
+    DMA_Stream_TypeDef *DMA_Stream;     //对应滤波器的DMA2数据流
+    uint32_t DMA_Channel;               //DMA_Channel_x
+    IRQn_Type DMA_IRQn;                 //数据流中断号, 中断函数中调用 DFSDM_Mic_IRQHandler
+} DFSDM_Mic_TypeDef;
+
+//一帧回调, 在最后一个完成的DMA中断中执行
+//frame[i]: 第i个麦克风的输出(24位有符号数, 与其他麦克风同一时刻对齐)
+//samples:  每个麦克风的采样数
+typedef void (*DFSDM_Mic_Callback)(const int32_t *const *frame, uint8_t mics, uint32_t samples);
+
+typedef struct {
+    uint8_t  Instance;                  //1: DFSDM1, 2: DFSDM2(仅F413)
+    uint8_t  Mics;                      //麦克风个数 1~DFSDM_MIC_MAX, DFSDM1 最多 DFSDM_MIC_DFSDM1_MAX
+    const DFSDM_Mic_TypeDef *Mic;       //麦克风表, Mics 项
+
+    uint32_t ClkOutDivider;             //CKOUT = 系统时钟 / ClkOutDivider, 需为 2~256
+    uint32_t SincOrder;                 //DFSDM_SincOrder_Sinc3/Sinc4/Sinc5 (硬件CIC)
+    uint32_t FilterOversampling;        //Sinc抽取倍数 FOSR, 1~1024
+    uint32_t DataRightShift;            //把 FOSR^order 位宽移回24位以内
+
+    int32_t  *DMA_Buffer;               //Mics * 2 * BlockSamples 个字, 每个麦克风一段
+    uint16_t BlockSamples;              //每半缓冲区采样数, <= DFSDM_MIC_BLOCK_MAX
+
+    int16_t  DcAlpha;                   //去直流一阶高通系数(Q15), 0: 关闭, 典型值 32604(0.995)
+    const int16_t *FirCoeffs;           //后级FIR系数(Q15), 0: 关闭
+    uint8_t  FirTaps;                   //FIR阶数, <= DFSDM_MIC_FIR_TAPS_MAX
+    uint8_t  FirDecimation;             //FIR后抽取倍数, 需整除 BlockSamples
+
+    DFSDM_Mic_Callback Callback;
+    uint8_t  NVIC_PreemptionPriority;
+    uint8_t  NVIC_SubPriority;
+} DFSDM_Mic_InitTypeDef;
+
+typedef struct {
+    uint32_t Frames;                    //已交付的帧数
+    uint32_t Overrun;                   //滤波器ROVR(DMA未及时读走数据)次数
+    uint32_t Misaligned;                //某个滤波器领先其他滤波器一个半缓冲区以上的次数
+    uint32_t DmaError;                  //DMA传输错误次数
+} DFSDM_Mic_Stats;
+
+void DFSDM_Mic_StructInit(DFSDM_Mic_InitTypeDef *DFSDM_Mic_InitStruct); // 缺省: Sinc4, FOSR=64, 去直流开启, 不用FIR
+ErrorStatus DFSDM_Mic_Init(DFSDM_Mic_InitTypeDef *DFSDM_Mic_InitStruct); // 配置通道/滤波器/DMA, 参数非法返回 ERROR
+void DFSDM_Mic_Start(void); // 所有滤波器同步启动
+void DFSDM_Mic_Stop(void); // 停止采集
+void DFSDM_Mic_IRQHandler(DMA_Stream_TypeDef *DMAy_Streamx); // 在麦克风所用DMA数据流的中断函数中调用
+void DFSDM_Mic_GetStats(DFSDM_Mic_Stats *stats); // 读取统计计数
+
+#endif /* STM32F412xG || STM32F413_423xx */
+
+#endif
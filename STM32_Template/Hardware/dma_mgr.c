@@ -0,0 +1,639 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : dma_mgr.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					每个请求源在F4上只能走固定的一两个 DMA数据流+通道 组合(参考手册请求映射表),
+					映射表集中在本文件中, 使用者只给出请求源. 提交时在被管理的候选数据流中选一个空闲的,
+					有多个时优先选映射表中能服务的请求源最少的数据流, 把通用的数据流留给别的外设.
+					没有空闲数据流时挂入排队链表, 某个数据流结束时在其中断中按提交顺序取出
+					第一个能用该数据流的传输立即启动, 然后再调用刚结束传输的回调.
+					占用时间用DWT周期计数器记录, 按统计窗口计算每个数据流的占用率.
+					只支持普通模式(非循环、非双缓冲)传输.
+  * Function List:
+  *		DMA_Mgr_Init
+  *		DMA_Mgr_XferInit
+  *		DMA_Mgr_Submit
+  *		DMA_Mgr_Cancel
+  *		DMA_Mgr_GetStats
+  *		DMA_Mgr_GetQueueStats
+  *		DMA_Mgr_ResetStats
+  *		DMAx_StreamN_IRQHandler
+  **********************************************************
+ */
+
+#include "dma_mgr.h"
+
+#define DMA_MGR_NONE        0xFF
+#define DMA_MGR_OWNED(s)    ((DMA_MGR_STREAM_MASK >> (s)) & 1u)
+
+//LISR/HISR 中每个数据流标志的起始位, 数据流 n 对应 [n % 4]
+#define DMA_MGR_FEIF        0x01u
+#define DMA_MGR_DMEIF       0x04u
+#define DMA_MGR_TEIF        0x08u
+#define DMA_MGR_TCIF        0x20u
+#define DMA_MGR_ALLIF       0x3Du
+static const uint8_t mgr_flag_shift[4] = {0, 6, 16, 22};
+
+typedef struct {
+    uint8_t Req;
+    uint8_t Stream;                 //DMA_MGR_STREAM(dma, n)
+    uint8_t Channel;
+} DMA_Mgr_Map;
+
+//RM0090 表 42/43, 内存到内存单独处理
+static const DMA_Mgr_Map mgr_map[] = {
+    //DMA1
+    {DMA_REQ_SPI3_RX,   DMA_MGR_STREAM(1, 0), 0}, {DMA_REQ_SPI3_RX,   DMA_MGR_STREAM(1, 2), 0},
+    {DMA_REQ_SPI2_RX,   DMA_MGR_STREAM(1, 3), 0}, {DMA_REQ_SPI2_TX,   DMA_MGR_STREAM(1, 4), 0},
+    {DMA_REQ_SPI3_TX,   DMA_MGR_STREAM(1, 5), 0}, {DMA_REQ_SPI3_TX,   DMA_MGR_STREAM(1, 7), 0},
+    {DMA_REQ_I2C1_RX,   DMA_MGR_STREAM(1, 0), 1}, {DMA_REQ_TIM7_UP,   DMA_MGR_STREAM(1, 2), 1},
+    {DMA_REQ_TIM7_UP,   DMA_MGR_STREAM(1, 4), 1}, {DMA_REQ_I2C1_RX,   DMA_MGR_STREAM(1, 5), 1},
+    {DMA_REQ_I2C1_TX,   DMA_MGR_STREAM(1, 6), 1}, {DMA_REQ_I2C1_TX,   DMA_MGR_STREAM(1, 7), 1},
+    {DMA_REQ_TIM4_UP,   DMA_MGR_STREAM(1, 6), 2},
+    {DMA_REQ_TIM2_UP,   DMA_MGR_STREAM(1, 1), 3}, {DMA_REQ_I2C3_RX,   DMA_MGR_STREAM(1, 2), 3},
+    {DMA_REQ_I2C3_TX,   DMA_MGR_STREAM(1, 4), 3}, {DMA_REQ_TIM2_UP,   DMA_MGR_STREAM(1, 7), 3},
+    {DMA_REQ_UART5_RX,  DMA_MGR_STREAM(1, 0), 4}, {DMA_REQ_USART3_RX, DMA_MGR_STREAM(1, 1), 4},
+    {DMA_REQ_UART4_RX,  DMA_MGR_STREAM(1, 2), 4}, {DMA_REQ_USART3_TX, DMA_MGR_STREAM(1, 3), 4},
+    {DMA_REQ_UART4_TX,  DMA_MGR_STREAM(1, 4), 4}, {DMA_REQ_USART2_RX, DMA_MGR_STREAM(1, 5), 4},
+    {DMA_REQ_USART2_TX, DMA_MGR_STREAM(1, 6), 4}, {DMA_REQ_UART5_TX,  DMA_MGR_STREAM(1, 7), 4},
+    {DMA_REQ_UART8_TX,  DMA_MGR_STREAM(1, 0), 5}, {DMA_REQ_UART7_TX,  DMA_MGR_STREAM(1, 1), 5},
+    {DMA_REQ_TIM3_UP,   DMA_MGR_STREAM(1, 2), 5}, {DMA_REQ_UART7_RX,  DMA_MGR_STREAM(1, 3), 5},
+    {DMA_REQ_UART8_RX,  DMA_MGR_STREAM(1, 6), 5},
+    {DMA_REQ_TIM5_UP,   DMA_MGR_STREAM(1, 0), 6}, {DMA_REQ_TIM5_UP,   DMA_MGR_STREAM(1, 6), 6},
+    {DMA_REQ_TIM6_UP,   DMA_MGR_STREAM(1, 1), 7}, {DMA_REQ_I2C2_RX,   DMA_MGR_STREAM(1, 2), 7},
+    {DMA_REQ_I2C2_RX,   DMA_MGR_STREAM(1, 3), 7}, {DMA_REQ_USART3_TX, DMA_MGR_STREAM(1, 4), 7},
+    {DMA_REQ_DAC1,      DMA_MGR_STREAM(1, 5), 7}, {DMA_REQ_DAC2,      DMA_MGR_STREAM(1, 6), 7},
+    {DMA_REQ_I2C2_TX,   DMA_MGR_STREAM(1, 7), 7},
+    //DMA2
+    {DMA_REQ_ADC1,      DMA_MGR_STREAM(2, 0), 0}, {DMA_REQ_ADC1,      DMA_MGR_STREAM(2, 4), 0},
+    {DMA_REQ_DCMI,      DMA_MGR_STREAM(2, 1), 1}, {DMA_REQ_ADC2,      DMA_MGR_STREAM(2, 2), 1},
+    {DMA_REQ_ADC2,      DMA_MGR_STREAM(2, 3), 1}, {DMA_REQ_SPI6_TX,   DMA_MGR_STREAM(2, 5), 1},
+    {DMA_REQ_SPI6_RX,   DMA_MGR_STREAM(2, 6), 1}, {DMA_REQ_DCMI,      DMA_MGR_STREAM(2, 7), 1},
+    {DMA_REQ_ADC3,      DMA_MGR_STREAM(2, 0), 2}, {DMA_REQ_ADC3,      DMA_MGR_STREAM(2, 1), 2},
+    {DMA_REQ_SPI5_RX,   DMA_MGR_STREAM(2, 3), 2}, {DMA_REQ_SPI5_TX,   DMA_MGR_STREAM(2, 4), 2},
+    {DMA_REQ_SPI1_RX,   DMA_MGR_STREAM(2, 0), 3}, {DMA_REQ_SPI1_RX,   DMA_MGR_STREAM(2, 2), 3},
+    {DMA_REQ_SPI1_TX,   DMA_MGR_STREAM(2, 3), 3}, {DMA_REQ_SPI1_TX,   DMA_MGR_STREAM(2, 5), 3},
+    {DMA_REQ_SPI4_RX,   DMA_MGR_STREAM(2, 0), 4}, {DMA_REQ_SPI4_TX,   DMA_MGR_STREAM(2, 1), 4},
+    {DMA_REQ_USART1_RX, DMA_MGR_STREAM(2, 2), 4}, {DMA_REQ_SDIO,      DMA_MGR_STREAM(2, 3), 4},
+    {DMA_REQ_SPI4_RX,   DMA_MGR_STREAM(2, 4), 4}, {DMA_REQ_USART1_RX, DMA_MGR_STREAM(2, 5), 4},
+    {DMA_REQ_SDIO,      DMA_MGR_STREAM(2, 6), 4}, {DMA_REQ_USART1_TX, DMA_MGR_STREAM(2, 7), 4},
+    {DMA_REQ_USART6_RX, DMA_MGR_STREAM(2, 1), 5}, {DMA_REQ_USART6_RX, DMA_MGR_STREAM(2, 2), 5},
+    {DMA_REQ_SPI4_RX,   DMA_MGR_STREAM(2, 3), 5}, {DMA_REQ_SPI4_TX,   DMA_MGR_STREAM(2, 4), 5},
+    {DMA_REQ_USART6_TX, DMA_MGR_STREAM(2, 6), 5}, {DMA_REQ_USART6_TX, DMA_MGR_STREAM(2, 7), 5},
+    {DMA_REQ_TIM1_UP,   DMA_MGR_STREAM(2, 5), 6},
+    {DMA_REQ_TIM8_UP,   DMA_MGR_STREAM(2, 1), 7}, {DMA_REQ_SPI5_RX,   DMA_MGR_STREAM(2, 5), 7},
+    {DMA_REQ_SPI5_TX,   DMA_MGR_STREAM(2, 6), 7},
+};
+
+#define DMA_MGR_MAP_NUM     (sizeof(mgr_map) / sizeof(mgr_map[0]))
+
+static DMA_Stream_TypeDef * const mgr_stream[DMA_MGR_STREAM_NUM] = {
+    DMA1_Stream0, DMA1_Stream1, DMA1_Stream2, DMA1_Stream3, DMA1_Stream4, DMA1_Stream5, DMA1_Stream6, DMA1_Stream7,
+    DMA2_Stream0, DMA2_Stream1, DMA2_Stream2, DMA2_Stream3, DMA2_Stream4, DMA2_Stream5, DMA2_Stream6, DMA2_Stream7,
+};
+
+static const uint8_t mgr_irqn[DMA_MGR_STREAM_NUM] = {
+    DMA1_Stream0_IRQn, DMA1_Stream1_IRQn, DMA1_Stream2_IRQn, DMA1_Stream3_IRQn,
+    DMA1_Stream4_IRQn, DMA1_Stream5_IRQn, DMA1_Stream6_IRQn, DMA1_Stream7_IRQn,
+    DMA2_Stream0_IRQn, DMA2_Stream1_IRQn, DMA2_Stream2_IRQn, DMA2_Stream3_IRQn,
+    DMA2_Stream4_IRQn, DMA2_Stream5_IRQn, DMA2_Stream6_IRQn, DMA2_Stream7_IRQn,
+};
+
+static DMA_Mgr_Xfer *mgr_active[DMA_MGR_STREAM_NUM];
+static uint8_t mgr_demand[DMA_MGR_STREAM_NUM];		//映射表中能用该数据流的请求源个数
+static uint32_t mgr_start[DMA_MGR_STREAM_NUM];		//本次传输开始时的DWT计数
+static DMA_Mgr_Stats mgr_stats[DMA_MGR_STREAM_NUM];
+static uint32_t mgr_window;							//统计窗口开始时的DWT计数
+
+static DMA_Mgr_Xfer *mgr_head;
+static DMA_Mgr_Xfer *mgr_tail;
+static uint32_t mgr_queue_len;
+static DMA_Mgr_QueueStats mgr_qstats;
+
+//返回请求源 req 在数据流 s 上的通道号, 不能用返回 DMA_MGR_NONE
+static uint8_t DMA_Mgr_Channel(uint8_t req, uint8_t s) {
+    uint32_t i;
+
+    //内存到内存只有DMA2可以, 通道号无关
+    if(req == DMA_REQ_MEM2MEM) return s >= 8 ? 0 : DMA_MGR_NONE;
+
+    for(i = 0; i < DMA_MGR_MAP_NUM; i++) {
+        if(mgr_map[i].Req == req && mgr_map[i].Stream == s) return mgr_map[i].Channel;
+    }
+
+    return DMA_MGR_NONE;
+}
+
+//清除数据流 s 的全部中断标志
+static void DMA_Mgr_ClearFlags(uint8_t s) {
+    DMA_TypeDef *dma = s < 8 ? DMA1 : DMA2;
+    uint32_t mask = DMA_MGR_ALLIF << mgr_flag_shift[s & 3];
+
+    if((s & 7) < 4) dma->LIFCR = mask;
+    else dma->HIFCR = mask;
+}
+
+//读取数据流 s 的中断标志, 已移到低位
+static uint32_t DMA_Mgr_Flags(uint8_t s) {
+    DMA_TypeDef *dma = s < 8 ? DMA1 : DMA2;
+    uint32_t isr = (s & 7) < 4 ? dma->LISR : dma->HISR;
+
+    return (isr >> mgr_flag_shift[s & 3]) & DMA_MGR_ALLIF;
+}
+
+//传输占用的字节数
+static uint32_t DMA_Mgr_Bytes(const DMA_Mgr_Xfer *xfer) {
+    return (uint32_t)xfer->Count << (xfer->PeriphDataSize >> 11);
+}
+
+//在空闲的数据流 s 上启动 xfer, 调用时中断已关闭或在DMA中断中
+static void DMA_Mgr_Start(uint8_t s, DMA_Mgr_Xfer *xfer, uint8_t channel) {
+    DMA_Stream_TypeDef *stream = mgr_stream[s];
+    DMA_InitTypeDef DMA_InitStructure;
+    uint8_t m2m = xfer->Req == DMA_REQ_MEM2MEM;
+
+    mgr_active[s] = xfer;
+    xfer->Stream = s;
+    xfer->State = DMA_XFER_ACTIVE;
+
+    //取消后重新分配时数据流可能还没停下
+    DMA_Cmd(stream, DISABLE);
+
+    while(DMA_GetCmdStatus(stream) != DISABLE);
+
+    DMA_Mgr_ClearFlags(s);
+
+    DMA_StructInit(&DMA_InitStructure);
+    DMA_InitStructure.DMA_Channel = (uint32_t)channel << 25;
+    DMA_InitStructure.DMA_PeripheralBaseAddr = xfer->PeriphAddr;
+    DMA_InitStructure.DMA_Memory0BaseAddr = xfer->MemAddr;
+    DMA_InitStructure.DMA_DIR = m2m ? DMA_DIR_MemoryToMemory : xfer->DIR;
+    DMA_InitStructure.DMA_BufferSize = xfer->Count;
+    DMA_InitStructure.DMA_PeripheralInc = m2m ? DMA_PeripheralInc_Enable : DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = m2m ? DMA_MemoryInc_Enable : xfer->MemoryInc;
+    DMA_InitStructure.DMA_PeripheralDataSize = xfer->PeriphDataSize;
+    DMA_InitStructure.DMA_MemoryDataSize = xfer->MemoryDataSize;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+    DMA_InitStructure.DMA_Priority = xfer->Priority;
+    //内存到内存不能用直接模式; 单次传输(不突发)时FIFO阈值没有对齐限制
+    DMA_InitStructure.DMA_FIFOMode = (m2m || xfer->FIFOMode) ? DMA_FIFOMode_Enable : DMA_FIFOMode_Disable;
+    DMA_InitStructure.DMA_FIFOThreshold = DMA_FIFOThreshold_Full;
+    DMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+    DMA_InitStructure.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+    DMA_Init(stream, &DMA_InitStructure);
+
+    DMA_ITConfig(stream, DMA_IT_TC | DMA_IT_TE | DMA_IT_DME, ENABLE);
+
+    mgr_start[s] = DWT->CYCCNT;
+    DMA_Cmd(stream, ENABLE);
+}
+
+//数据流 s 的传输结束(或取消), 记入统计并释放数据流
+static DMA_Mgr_Xfer *DMA_Mgr_Release(uint8_t s, uint8_t state) {
+    DMA_Mgr_Xfer *xfer = mgr_active[s];
+
+    mgr_active[s] = 0;
+    mgr_stats[s].BusyCycles += DWT->CYCCNT - mgr_start[s];
+
+    if(state == DMA_XFER_DONE) {
+        mgr_stats[s].Transfers++;
+        mgr_stats[s].Bytes += DMA_Mgr_Bytes(xfer);
+    } else if(state == DMA_XFER_ERROR) {
+        mgr_stats[s].Errors++;
+    }
+
+    xfer->State = state;
+
+    return xfer;
+}
+
+//在刚空闲的数据流 s 上启动排队中第一个能用它的传输, 调用时中断已关闭或在DMA中断中
+static void DMA_Mgr_Dispatch(uint8_t s) {
+    DMA_Mgr_Xfer *prev = 0;
+    DMA_Mgr_Xfer *xfer;
+    uint8_t channel;
+
+    for(xfer = mgr_head; xfer != 0; prev = xfer, xfer = xfer->Next) {
+        channel = DMA_Mgr_Channel(xfer->Req, s);
+
+        if(channel == DMA_MGR_NONE) continue;
+
+        if(prev) prev->Next = xfer->Next;
+        else mgr_head = xfer->Next;
+
+        if(mgr_tail == xfer) mgr_tail = prev;
+
+        xfer->Next = 0;
+        mgr_queue_len--;
+
+        DMA_Mgr_Start(s, xfer, channel);
+        return;
+    }
+}
+
+//各数据流中断的公共部分
+static void DMA_Mgr_IRQ(uint8_t s) {
+    uint32_t flags = DMA_Mgr_Flags(s);
+    DMA_Mgr_Xfer *xfer;
+    uint8_t state;
+
+    DMA_Mgr_ClearFlags(s);
+
+    //FIFO错误只是提示(如FIFO模式下外设请求来不及), 不影响传输, 只清除
+    if(flags & (DMA_MGR_TEIF | DMA_MGR_DMEIF)) {
+        DMA_Cmd(mgr_stream[s], DISABLE);
+        state = DMA_XFER_ERROR;
+    } else if(flags & DMA_MGR_TCIF) {
+        state = DMA_XFER_DONE;
+    } else {
+        return;
+    }
+
+    if(mgr_active[s] == 0) return;
+
+    xfer = DMA_Mgr_Release(s, state);
+
+    //先让排队的传输用上数据流, 回调中新提交的传输排在它们后面
+    DMA_Mgr_Dispatch(s);
+
+    if(xfer->Callback) xfer->Callback(xfer);
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	DMA_Mgr_Init()
+* 功能说明:	打开DMA1/DMA2时钟, 使能 DMA_MGR_STREAM_MASK 中数据流的中断, 打开DWT周期计数器
+* 输    入: uint8_t NVIC_PreemptionPriority	抢占优先级
+*			uint8_t NVIC_SubPriority			子优先级
+* 输    出: 无
+* 注意事项: 所有被管理数据流的中断优先级相同, 它们之间不会互相嵌套
+******************************************************************************************************************************************/
+void DMA_Mgr_Init(uint8_t NVIC_PreemptionPriority, uint8_t NVIC_SubPriority) {
+    NVIC_InitTypeDef NVIC_InitStructure;
+    uint32_t i;
+    uint8_t s;
+
+    RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA1 | RCC_AHB1Periph_DMA2, ENABLE);
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    for(s = 0; s < DMA_MGR_STREAM_NUM; s++) {
+        mgr_active[s] = 0;
+        mgr_demand[s] = s >= 8 ? 1 : 0;	//DMA2的数据流都能做内存到内存
+    }
+
+    for(i = 0; i < DMA_MGR_MAP_NUM; i++) mgr_demand[mgr_map[i].Stream]++;
+
+    mgr_head = 0;
+    mgr_tail = 0;
+    mgr_queue_len = 0;
+    DMA_Mgr_ResetStats();
+
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = NVIC_PreemptionPriority;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = NVIC_SubPriority;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+
+    for(s = 0; s < DMA_MGR_STREAM_NUM; s++) {
+        if(!DMA_MGR_OWNED(s)) continue;
+
+        DMA_Cmd(mgr_stream[s], DISABLE);
+
+        while(DMA_GetCmdStatus(mgr_stream[s]) != DISABLE);
+
+        DMA_Mgr_ClearFlags(s);
+
+        NVIC_InitStructure.NVIC_IRQChannel = mgr_irqn[s];
+        NVIC_Init(&NVIC_InitStructure);
+    }
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	DMA_Mgr_XferInit()
+* 功能说明:	按内存到外设、字节宽度、内存递增、低优先级、直接模式填充传输描述
+* 输    入: DMA_Mgr_Xfer *xfer		传输描述
+* 输    出: 无
+* 注意事项: 地址、个数、请求源和回调仍需使用者填写
+******************************************************************************************************************************************/
+void DMA_Mgr_XferInit(DMA_Mgr_Xfer *xfer) {
+    xfer->Req = DMA_REQ_MEM2MEM;
+    xfer->PeriphAddr = 0;
+    xfer->MemAddr = 0;
+    xfer->Count = 0;
+    xfer->DIR = DMA_DIR_MemoryToPeripheral;
+    xfer->PeriphDataSize = DMA_PeripheralDataSize_Byte;
+    xfer->MemoryDataSize = DMA_MemoryDataSize_Byte;
+    xfer->MemoryInc = DMA_MemoryInc_Enable;
+    xfer->Priority = DMA_Priority_Low;
+    xfer->FIFOMode = 0;
+    xfer->Callback = 0;
+    xfer->Arg = 0;
+    xfer->State = DMA_XFER_IDLE;
+    xfer->Stream = DMA_MGR_NONE;
+    xfer->Next = 0;
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	DMA_Mgr_Submit()
+* 功能说明:	提交传输, 有空闲的候选数据流时立即启动, 否则排队
+* 输    入: DMA_Mgr_Xfer *xfer		传输描述
+* 输    出: int8_t		0 已启动, 1 已排队, -1 没有被管理的数据流能服务该请求源, 或参数错误
+* 注意事项: xfer 在回调之前不能释放或改动; 可以在任务和中断(含回调)中调用
+******************************************************************************************************************************************/
+int8_t DMA_Mgr_Submit(DMA_Mgr_Xfer *xfer) {
+    uint32_t primask;
+    uint8_t s, channel;
+    uint8_t best = DMA_MGR_NONE, best_channel = 0;
+    uint8_t owned = 0;
+
+    if(xfer->Req >= DMA_REQ_NUM || xfer->Count == 0) return -1;
+
+    if(xfer->State == DMA_XFER_QUEUED || xfer->State == DMA_XFER_ACTIVE) return -1;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    mgr_qstats.Submitted++;
+
+    for(s = 0; s < DMA_MGR_STREAM_NUM; s++) {
+        if(!DMA_MGR_OWNED(s)) continue;
+
+        channel = DMA_Mgr_Channel(xfer->Req, s);
+
+        if(channel == DMA_MGR_NONE) continue;
+
+        owned = 1;
+
+        if(mgr_active[s] != 0) continue;
+
+        if(best == DMA_MGR_NONE || mgr_demand[s] < mgr_demand[best]) {
+            best = s;
+            best_channel = channel;
+        }
+    }
+
+    if(!owned) {
+        mgr_qstats.Rejected++;
+        __set_PRIMASK(primask);
+        return -1;
+    }
+
+    if(best != DMA_MGR_NONE) {
+        DMA_Mgr_Start(best, xfer, best_channel);
+        __set_PRIMASK(primask);
+        return 0;
+    }
+
+    xfer->State = DMA_XFER_QUEUED;
+    xfer->Stream = DMA_MGR_NONE;
+    xfer->Next = 0;
+
+    if(mgr_tail) mgr_tail->Next = xfer;
+    else mgr_head = xfer;
+
+    mgr_tail = xfer;
+    mgr_queue_len++;
+    mgr_qstats.Queued++;
+
+    if(mgr_queue_len > mgr_qstats.QueueMax) mgr_qstats.QueueMax = mgr_queue_len;
+
+    __set_PRIMASK(primask);
+
+    return 1;
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	DMA_Mgr_Cancel()
+* 功能说明:	取消排队中或进行中的传输, 进行中的传输会停止数据流, 已搬运的数据保留
+* 输    入: DMA_Mgr_Xfer *xfer		传输描述
+* 输    出: int8_t		0 已取消, -1 传输不在排队或进行中
+* 注意事项: 不调用回调; 释放的数据流立即交给排队中的传输
+******************************************************************************************************************************************/
+int8_t DMA_Mgr_Cancel(DMA_Mgr_Xfer *xfer) {
+    uint32_t primask;
+    DMA_Mgr_Xfer *prev = 0;
+    DMA_Mgr_Xfer *p;
+    uint8_t s;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    if(xfer->State == DMA_XFER_QUEUED) {
+        for(p = mgr_head; p != 0 && p != xfer; prev = p, p = p->Next);
+
+        if(p != 0) {
+            if(prev) prev->Next = xfer->Next;
+            else mgr_head = xfer->Next;
+
+            if(mgr_tail == xfer) mgr_tail = prev;
+
+            xfer->Next = 0;
+            mgr_queue_len--;
+        }
+
+        xfer->State = DMA_XFER_CANCELLED;
+        __set_PRIMASK(primask);
+        return 0;
+    }
+
+    if(xfer->State == DMA_XFER_ACTIVE && xfer->Stream < DMA_MGR_STREAM_NUM && mgr_active[xfer->Stream] == xfer) {
+        s = xfer->Stream;
+
+        DMA_Cmd(mgr_stream[s], DISABLE);
+
+        while(DMA_GetCmdStatus(mgr_stream[s]) != DISABLE);
+
+        DMA_Mgr_ClearFlags(s);
+        NVIC_ClearPendingIRQ((IRQn_Type)mgr_irqn[s]);
+
+        DMA_Mgr_Release(s, DMA_XFER_CANCELLED);
+        DMA_Mgr_Dispatch(s);
+
+        __set_PRIMASK(primask);
+        return 0;
+    }
+
+    __set_PRIMASK(primask);
+
+    return -1;
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	DMA_Mgr_GetStats()
+* 功能说明:	读取数据流的统计, 并按当前统计窗口计算占用率
+* 输    入: uint8_t stream			数据流编号, DMA_MGR_STREAM(dma, n)
+*			DMA_Mgr_Stats *stats	统计结果
+* 输    出: 无
+* 注意事项: 进行中的传输已占用的时间计入 BusyCycles
+******************************************************************************************************************************************/
+void DMA_Mgr_GetStats(uint8_t stream, DMA_Mgr_Stats *stats) {
+    uint32_t primask;
+    uint32_t now;
+
+    if(stream >= DMA_MGR_STREAM_NUM) return;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    now = DWT->CYCCNT;
+    *stats = mgr_stats[stream];
+
+    if(mgr_active[stream] != 0) stats->BusyCycles += now - mgr_start[stream];
+
+    __set_PRIMASK(primask);
+
+    stats->WindowCycles = now - mgr_window;
+    stats->Usage = stats->WindowCycles ? (uint16_t)((uint64_t)stats->BusyCycles * 1000 / stats->WindowCycles) : 0;
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	DMA_Mgr_GetQueueStats()
+* 功能说明:	读取提交和排队统计
+* 输    入: DMA_Mgr_QueueStats *stats	统计结果
+* 输    出: 无
+* 注意事项: 无
+******************************************************************************************************************************************/
+void DMA_Mgr_GetQueueStats(DMA_Mgr_QueueStats *stats) {
+    *stats = mgr_qstats;
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	DMA_Mgr_ResetStats()
+* 功能说明:	清零所有统计, 从现在开始新的统计窗口
+* 输    入: 无
+* 输    出: 无
+* 注意事项: 无
+******************************************************************************************************************************************/
+void DMA_Mgr_ResetStats(void) {
+    uint32_t primask;
+    uint8_t s;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    mgr_window = DWT->CYCCNT;
+
+    for(s = 0; s < DMA_MGR_STREAM_NUM; s++) {
+        mgr_stats[s].Transfers = 0;
+        mgr_stats[s].Errors = 0;
+        mgr_stats[s].Bytes = 0;
+        mgr_stats[s].BusyCycles = 0;
+        mgr_stats[s].WindowCycles = 0;
+        mgr_stats[s].Usage = 0;
+
+        if(mgr_active[s] != 0) mgr_start[s] = mgr_window;
+    }
+
+    mgr_qstats.Submitted = 0;
+    mgr_qstats.Queued = 0;
+    mgr_qstats.QueueMax = mgr_queue_len;
+    mgr_qstats.Rejected = 0;
+
+    __set_PRIMASK(primask);
+}
+
+#if DMA_MGR_OWNED(0)
+void DMA1_Stream0_IRQHandler(void) {
+    DMA_Mgr_IRQ(0);
+}
+#endif
+
+#if DMA_MGR_OWNED(1)
+void DMA1_Stream1_IRQHandler(void) {
+    DMA_Mgr_IRQ(1);
+}
+#endif
+
+#if DMA_MGR_OWNED(2)
+void DMA1_Stream2_IRQHandler(void) {
+    DMA_Mgr_IRQ(2);
+}
+#endif
+
+#if DMA_MGR_OWNED(3)
+void DMA1_Stream3_IRQHandler(void) {
+    DMA_Mgr_IRQ(3);
+}
+#endif
+
+#if DMA_MGR_OWNED(4)
+void DMA1_Stream4_IRQHandler(void) {
+    DMA_Mgr_IRQ(4);
+}
+#endif
+
+#if DMA_MGR_OWNED(5)
+void DMA1_Stream5_IRQHandler(void) {
+    DMA_Mgr_IRQ(5);
+}
+#endif
+
+#if DMA_MGR_OWNED(6)
+void DMA1_Stream6_IRQHandler(void) {
+    DMA_Mgr_IRQ(6);
+}
+#endif
+
+#if DMA_MGR_OWNED(7)
+void DMA1_Stream7_IRQHandler(void) {
+    DMA_Mgr_IRQ(7);
+}
+#endif
+
+#if DMA_MGR_OWNED(8)
+void DMA2_Stream0_IRQHandler(void) {
+    DMA_Mgr_IRQ(8);
+}
+#endif
+
+#if DMA_MGR_OWNED(9)
+void DMA2_Stream1_IRQHandler(void) {
+    DMA_Mgr_IRQ(9);
+}
+#endif
+
+#if DMA_MGR_OWNED(10)
+void DMA2_Stream2_IRQHandler(void) {
+    DMA_Mgr_IRQ(10);
+}
+#endif
+
+#if DMA_MGR_OWNED(11)
+void DMA2_Stream3_IRQHandler(void) {
+    DMA_Mgr_IRQ(11);
+}
+#endif
+
+#if DMA_MGR_OWNED(12)
+void DMA2_Stream4_IRQHandler(void) {
+    DMA_Mgr_IRQ(12);
+}
+#endif
+
+#if DMA_MGR_OWNED(13)
+void DMA2_Stream5_IRQHandler(void) {
+    DMA_Mgr_IRQ(13);
+}
+#endif
+
+#if DMA_MGR_OWNED(14)
+void DMA2_Stream6_IRQHandler(void) {
+    DMA_Mgr_IRQ(14);
+}
+#endif
+
+#if DMA_MGR_OWNED(15)
+void DMA2_Stream7_IRQHandler(void) {
+    DMA_Mgr_IRQ(15);
+}
+#endif
@@ -0,0 +1,156 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : dma_mgr.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : DMA1/DMA2数据流管理: 按F4请求映射表动态分配数据流, 无空闲数据流时排队,
+  *				   在共用的中断层中完成回调, 统计每个数据流的占用率
+  * Function List:
+  *		DMA_Mgr_Init
+  *		DMA_Mgr_XferInit
+  *		DMA_Mgr_Submit
+  *		DMA_Mgr_Cancel
+  *		DMA_Mgr_GetStats
+  *		DMA_Mgr_GetQueueStats
+  *		DMA_Mgr_ResetStats
+  *		DMAx_StreamN_IRQHandler
+  ******************************************************
+**/
+
+#ifndef __DMA_MGR_H_
+#define __DMA_MGR_H_
+
+#include "stm32f4xx_conf.h"
+
+//数据流编号: 0~7 为 DMA1_Stream0~7, 8~15 为 DMA2_Stream0~7
+#define DMA_MGR_STREAM_NUM          16
+#define DMA_MGR_STREAM(dma, n)      (((dma) - 1) * 8 + (n))
+
+//由管理器分配的数据流, 第 n 位对应上面的编号n, 中断服务函数只为这些数据流生成.
+//已固定使用数据流的模块不受管理, 对应位必须为0, 否则中断服务函数重复定义:
+//  adc_acq DMA2_S0, dcmi_capture DMA2_S1, ccm_ram DMA2_S3, crypto_stream DMA2_S5/S6/S7,
+//  i2s_audio DMA1_S3/S4
+#ifndef DMA_MGR_STREAM_MASK
+#define DMA_MGR_STREAM_MASK         0x14E7	//DMA1_S0/S1/S2/S5/S6/S7, DMA2_S2/S4
+#endif
+
+//请求源, 与参考手册 DMA1/DMA2 请求映射表对应
+typedef enum {
+    DMA_REQ_MEM2MEM = 0,            //内存到内存, 只有DMA2能做
+    DMA_REQ_SPI1_RX,
+    DMA_REQ_SPI1_TX,
+    DMA_REQ_SPI2_RX,
+    DMA_REQ_SPI2_TX,
+    DMA_REQ_SPI3_RX,
+    DMA_REQ_SPI3_TX,
+    DMA_REQ_SPI4_RX,
+    DMA_REQ_SPI4_TX,
+    DMA_REQ_SPI5_RX,
+    DMA_REQ_SPI5_TX,
+    DMA_REQ_SPI6_RX,
+    DMA_REQ_SPI6_TX,
+    DMA_REQ_USART1_RX,
+    DMA_REQ_USART1_TX,
+    DMA_REQ_USART2_RX,
+    DMA_REQ_USART2_TX,
+    DMA_REQ_USART3_RX,
+    DMA_REQ_USART3_TX,
+    DMA_REQ_UART4_RX,
+    DMA_REQ_UART4_TX,
+    DMA_REQ_UART5_RX,
+    DMA_REQ_UART5_TX,
+    DMA_REQ_USART6_RX,
+    DMA_REQ_USART6_TX,
+    DMA_REQ_UART7_RX,
+    DMA_REQ_UART7_TX,
+    DMA_REQ_UART8_RX,
+    DMA_REQ_UART8_TX,
+    DMA_REQ_I2C1_RX,
+    DMA_REQ_I2C1_TX,
+    DMA_REQ_I2C2_RX,
+    DMA_REQ_I2C2_TX,
+    DMA_REQ_I2C3_RX,
+    DMA_REQ_I2C3_TX,
+    DMA_REQ_ADC1,
+    DMA_REQ_ADC2,
+    DMA_REQ_ADC3,
+    DMA_REQ_DAC1,
+    DMA_REQ_DAC2,
+    DMA_REQ_SDIO,
+    DMA_REQ_DCMI,
+    DMA_REQ_TIM1_UP,
+    DMA_REQ_TIM2_UP,
+    DMA_REQ_TIM3_UP,
+    DMA_REQ_TIM4_UP,
+    DMA_REQ_TIM5_UP,
+    DMA_REQ_TIM6_UP,
+    DMA_REQ_TIM7_UP,
+    DMA_REQ_TIM8_UP,
+    DMA_REQ_NUM
+} DMA_Mgr_Req;
+
+//传输状态
+#define DMA_XFER_IDLE               0
+#define DMA_XFER_QUEUED             1	//等待空闲数据流
+#define DMA_XFER_ACTIVE             2
+#define DMA_XFER_DONE               3
+#define DMA_XFER_ERROR              4	//传输错误/直接模式错误
+#define DMA_XFER_CANCELLED          5
+
+typedef struct DMA_Mgr_Xfer DMA_Mgr_Xfer;
+
+//传输结束(xfer->State 为 DONE 或 ERROR)时在DMA中断中调用, 回调中可以再次提交
+typedef void (*DMA_Mgr_Callback)(DMA_Mgr_Xfer *xfer);
+
+struct DMA_Mgr_Xfer {
+    DMA_Mgr_Req Req;
+    uint32_t PeriphAddr;            //外设数据寄存器地址; 内存到内存时为源地址
+    uint32_t MemAddr;               //内存地址; 内存到内存时为目的地址
+    uint16_t Count;                 //数据个数, 以外设数据宽度为单位
+    uint32_t DIR;                   //DMA_DIR_xxx
+    uint32_t PeriphDataSize;        //DMA_PeripheralDataSize_xxx
+    uint32_t MemoryDataSize;        //DMA_MemoryDataSize_xxx
+    uint32_t MemoryInc;             //DMA_MemoryInc_xxx, 内存到内存时源和目的都递增
+    uint32_t Priority;              //DMA_Priority_xxx
+    uint8_t  FIFOMode;              //1: 使用FIFO(内存到内存强制使用, 宽度不同时也需要)
+    DMA_Mgr_Callback Callback;
+    void *Arg;                      //供回调使用
+
+    //以下由管理器维护
+    volatile uint8_t State;
+    uint8_t  Stream;                //分配到的数据流编号, 0xFF 未分配
+    DMA_Mgr_Xfer *Next;             //排队链表
+};
+
+typedef struct {
+    uint32_t Transfers;             //完成的传输数
+    uint32_t Errors;
+    uint32_t Bytes;                 //完成的传输搬运的字节数
+    uint32_t BusyCycles;            //统计窗口内数据流被占用的CPU周期数
+    uint32_t WindowCycles;          //统计窗口长度(CPU周期), 不应超过 2^32 (168MHz下约25秒)
+    uint16_t Usage;                 //占用率, 千分比
+} DMA_Mgr_Stats;
+
+typedef struct {
+    uint32_t Submitted;
+    uint32_t Queued;                //提交时没有空闲数据流而排队的次数
+    uint32_t QueueMax;              //排队链表的最大长度
+    uint32_t Rejected;              //映射表中没有被管理的数据流可用
+} DMA_Mgr_QueueStats;
+
+void DMA_Mgr_Init(uint8_t NVIC_PreemptionPriority, uint8_t NVIC_SubPriority); // 打开DMA1/DMA2时钟, 使能被管理数据流的中断
+void DMA_Mgr_XferInit(DMA_Mgr_Xfer *xfer); // 按内存到外设、字节宽度、内存递增填充缺省值
+int8_t DMA_Mgr_Submit(DMA_Mgr_Xfer *xfer); // 提交传输: 0 已启动, 1 已排队, -1 没有可用的数据流或参数错误
+int8_t DMA_Mgr_Cancel(DMA_Mgr_Xfer *xfer); // 取消排队中或进行中的传输, 不调用回调; 0 成功, -1 已经结束
+void DMA_Mgr_GetStats(uint8_t stream, DMA_Mgr_Stats *stats); // 读取数据流 stream 的统计, 计算占用率
+void DMA_Mgr_GetQueueStats(DMA_Mgr_QueueStats *stats); // 读取排队统计
+void DMA_Mgr_ResetStats(void); // 清零统计, 开始新的统计窗口
+
+#endif
@@ -0,0 +1,466 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : gfx_compose.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					每帧流程:
+					  Gfx_BeginFrame -> Gfx_Invalidate(变化区域) -> Gfx_Fill/DrawImage/BlendImage -> Gfx_Present
+					绘图调用按本帧脏矩形裁剪成若干条命令放入队列, 由DMA2D传输完成中断
+					逐条启动, CPU不等待. Gfx_Present 后, LTDC行中断(最后一个有效行)
+					发现队列已空就切换层地址并请求垂直消隐重装, 重装完成中断里才真正
+					交换前后台.
+					两个缓冲交替使用, 新的后台缓冲比前台落后一帧: 本帧第一次绘图前先
+					把上一帧的脏矩形从前台拷到后台(本帧会整块重画的除外), 再只重画
+					本帧脏矩形. 应用须保证脏矩形内的内容每帧完整重画(先填背景).
+  * Function List:
+  *		Gfx_StructInit
+  *		Gfx_Init
+  *		Gfx_BeginFrame
+  *		Gfx_Invalidate
+  *		Gfx_Fill
+  *		Gfx_DrawImage
+  *		Gfx_BlendImage
+  *		Gfx_Present
+  *		Gfx_Wait
+  *		Gfx_GetBackBuffer
+  *		Gfx_GetStats
+  *		DMA2D_IRQHandler
+  *		LTDC_IRQHandler
+  **********************************************************
+ */
+
+#include "gfx_compose.h"
+
+#if defined(STM32F429_439xx) || defined(STM32F469_479xx)
+
+#define GFX_QUEUE_MASK              (GFX_QUEUE_LEN - 1)
+
+//换帧状态
+#define GFX_SWAP_IDLE               0
+#define GFX_SWAP_PENDING            1       //已提交, 等行中断
+#define GFX_SWAP_RELOAD             2       //已请求重装, 等重装完成中断
+
+typedef struct {
+    uint8_t *fb[2];
+    uint16_t width;
+    uint16_t height;
+    uint8_t  format;
+    LTDC_Layer_TypeDef *layer;
+    volatile uint8_t front;         //正在显示的缓冲下标
+    volatile uint8_t swap;
+    uint8_t  synced;                //本帧的前台->后台拷贝已入队
+    Gfx_Region cur;                 //本帧脏区域
+    Gfx_Region prev;                //上一帧脏区域, 新后台缓冲中这些地方是旧内容
+} Gfx_Handle;
+
+static Gfx_Handle gfx;
+static Gfx_Stats gfx_stats;
+
+//命令队列, 主循环写 wr, DMA2D中断写 rd
+static Gfx_Cmd queue[GFX_QUEUE_LEN];
+static volatile uint32_t queue_wr;
+static volatile uint32_t queue_rd;
+static volatile uint8_t dma2d_busy;
+
+static const uint32_t gfx_mode[4] = {DMA2D_R2M, DMA2D_M2M, DMA2D_M2M_PFC, DMA2D_M2M_BLEND};
+
+//R2M的输出颜色按输出格式的位宽给出
+static void Gfx_SetColor(DMA2D_InitTypeDef *init, uint32_t argb, uint8_t format) {
+    uint32_t a = argb >> 24, r = (argb >> 16) & 0xFF, g = (argb >> 8) & 0xFF, b = argb & 0xFF;
+
+    switch(format) {
+        case GFX_RGB565:
+            a = 0;
+            r >>= 3;
+            g >>= 2;
+            b >>= 3;
+            break;
+
+        case GFX_ARGB1555:
+            a >>= 7;
+            r >>= 3;
+            g >>= 3;
+            b >>= 3;
+            break;
+
+        case GFX_ARGB4444:
+            a >>= 4;
+            r >>= 4;
+            g >>= 4;
+            b >>= 4;
+            break;
+
+        case GFX_RGB888:
+            a = 0;
+            break;
+
+        default:
+            break;
+    }
+
+    init->DMA2D_OutputAlpha = a;
+    init->DMA2D_OutputRed = r;
+    init->DMA2D_OutputGreen = g;
+    init->DMA2D_OutputBlue = b;
+}
+
+//按命令配置并启动一次DMA2D传输, DMA2D_Init 会清掉中断使能, 所以每次重开
+static void Gfx_Start(const Gfx_Cmd *cmd) {
+    DMA2D_InitTypeDef DMA2D_InitStructure;
+    DMA2D_FG_InitTypeDef DMA2D_FG_InitStructure;
+    DMA2D_BG_InitTypeDef DMA2D_BG_InitStructure;
+
+    DMA2D_StructInit(&DMA2D_InitStructure);
+    DMA2D_InitStructure.DMA2D_Mode = gfx_mode[cmd->Op];
+    DMA2D_InitStructure.DMA2D_CMode = cmd->DstFormat;
+    DMA2D_InitStructure.DMA2D_OutputMemoryAdd = (uint32_t)cmd->Dst;
+    DMA2D_InitStructure.DMA2D_OutputOffset = cmd->DstStride - cmd->Width;
+    DMA2D_InitStructure.DMA2D_NumberOfLine = cmd->Height;
+    DMA2D_InitStructure.DMA2D_PixelPerLine = cmd->Width;
+
+    if(cmd->Op == GFX_OP_FILL) Gfx_SetColor(&DMA2D_InitStructure, cmd->Color, cmd->DstFormat);
+
+    DMA2D_Init(&DMA2D_InitStructure);
+
+    if(cmd->Op != GFX_OP_FILL) {
+        DMA2D_FG_StructInit(&DMA2D_FG_InitStructure);
+        DMA2D_FG_InitStructure.DMA2D_FGMA = (uint32_t)cmd->Src;
+        DMA2D_FG_InitStructure.DMA2D_FGO = cmd->SrcStride - cmd->Width;
+        DMA2D_FG_InitStructure.DMA2D_FGCM = cmd->SrcFormat;
+        DMA2D_FG_InitStructure.DMA2D_FGPFC_ALPHA_MODE = cmd->AlphaMode;
+        DMA2D_FG_InitStructure.DMA2D_FGPFC_ALPHA_VALUE = cmd->Alpha;
+        DMA2D_FG_InitStructure.DMA2D_FGC_RED = (cmd->Color >> 16) & 0xFF;
+        DMA2D_FG_InitStructure.DMA2D_FGC_GREEN = (cmd->Color >> 8) & 0xFF;
+        DMA2D_FG_InitStructure.DMA2D_FGC_BLUE = cmd->Color & 0xFF;
+        DMA2D_FGConfig(&DMA2D_FG_InitStructure);
+    }
+
+    //混合时背景就是目标区域本身
+    if(cmd->Op == GFX_OP_BLEND) {
+        DMA2D_BG_StructInit(&DMA2D_BG_InitStructure);
+        DMA2D_BG_InitStructure.DMA2D_BGMA = (uint32_t)cmd->Dst;
+        DMA2D_BG_InitStructure.DMA2D_BGO = cmd->DstStride - cmd->Width;
+        DMA2D_BG_InitStructure.DMA2D_BGCM = cmd->DstFormat;
+        DMA2D_BGConfig(&DMA2D_BG_InitStructure);
+    }
+
+    DMA2D_ITConfig(DMA2D_IT_TC | DMA2D_IT_TE | DMA2D_IT_CE, ENABLE);
+    DMA2D_StartTransfer();
+}
+
+//入队, 队列满时等中断腾出位置; DMA2D空闲则直接启动
+static void Gfx_Push(const Gfx_Cmd *cmd) {
+    uint32_t wr = queue_wr;
+
+    if(wr - queue_rd >= GFX_QUEUE_LEN) {
+        gfx_stats.QueueFull++;
+
+        while(wr - queue_rd >= GFX_QUEUE_LEN);
+    }
+
+    queue[wr & GFX_QUEUE_MASK] = *cmd;
+    __DMB();
+    queue_wr = wr + 1;
+
+    //中断在 queue_wr 更新之后发现还有命令会自己启动, 这里只在它已经停下时启动
+    if(dma2d_busy == 0) {
+        dma2d_busy = 1;
+        Gfx_Start(&queue[queue_rd & GFX_QUEUE_MASK]);
+    }
+}
+
+//上一帧改过的区域从前台拷到后台, 本帧会整块重画的跳过
+static void Gfx_Sync(void) {
+    Gfx_Region one;
+    Gfx_Cmd cmd;
+    uint8_t i;
+
+    gfx.synced = 1;
+
+    cmd.Op = GFX_OP_COPY;
+    cmd.SrcFormat = gfx.format;
+    cmd.DstFormat = gfx.format;
+    cmd.AlphaMode = GFX_ALPHA_NONE;
+    cmd.Alpha = 0xFF;
+    cmd.Color = 0;
+    cmd.Src = gfx.fb[gfx.front];
+    cmd.Dst = gfx.fb[gfx.front ^ 1];
+    cmd.SrcStride = gfx.width;
+    cmd.DstStride = gfx.width;
+    cmd.Width = gfx.width;
+    cmd.Height = gfx.height;
+    one.Count = 1;
+
+    for(i = 0; i < gfx.prev.Count; i++) {
+        if(Gfx_RegionContains(&gfx.cur, &gfx.prev.Rect[i])) continue;
+
+        one.Rect[0] = gfx.prev.Rect[i];
+        gfx_stats.SyncPixels += (uint32_t)(one.Rect[0].X1 - one.Rect[0].X0) * (uint32_t)(one.Rect[0].Y1 - one.Rect[0].Y0);
+        Gfx_RegionEmit(&one, &cmd, 0, 0, Gfx_Push);
+    }
+}
+
+//按本帧脏区域裁剪后入队
+static void Gfx_Draw(Gfx_Cmd *cmd, int16_t x, int16_t y) {
+    if(gfx.synced == 0) Gfx_Sync();
+
+    cmd->Dst = gfx.fb[gfx.front ^ 1];
+    cmd->DstFormat = gfx.format;
+    cmd->DstStride = gfx.width;
+    Gfx_RegionEmit(&gfx.cur, cmd, x, y, Gfx_Push);
+}
+
+static void Gfx_Image2Cmd(Gfx_Cmd *cmd, const Gfx_Image *img) {
+    cmd->SrcFormat = img->Format;
+    cmd->Src = img->Data;
+    cmd->SrcStride = img->Stride;
+    cmd->Width = img->Width;
+    cmd->Height = img->Height;
+}
+
+//缺省: 480x272 RGB565, 行中断放在常见4.3寸屏的最后一个有效行
+void Gfx_StructInit(Gfx_InitTypeDef *Gfx_InitStruct) {
+    Gfx_InitStruct->FrameBuffer[0] = 0;
+    Gfx_InitStruct->FrameBuffer[1] = 0;
+    Gfx_InitStruct->Width = 480;
+    Gfx_InitStruct->Height = 272;
+    Gfx_InitStruct->Format = GFX_RGB565;
+    Gfx_InitStruct->Layer = LTDC_Layer1;
+    Gfx_InitStruct->SwapLine = 283;
+    Gfx_InitStruct->NVIC_PreemptionPriority = 1;
+    Gfx_InitStruct->NVIC_SubPriority = 0;
+}
+
+//LTDC时序和层参数由应用配置好, 这里只接管层地址和换帧
+ErrorStatus Gfx_Init(Gfx_InitTypeDef *Gfx_InitStruct) {
+    NVIC_InitTypeDef NVIC_InitStructure;
+    Gfx_Region all;
+    Gfx_Cmd cmd;
+
+    if(Gfx_InitStruct->FrameBuffer[0] == 0 || Gfx_InitStruct->FrameBuffer[1] == 0 ||
+            Gfx_InitStruct->Width == 0 || Gfx_InitStruct->Height == 0 ||
+            Gfx_InitStruct->Format > GFX_ARGB4444)
+        return ERROR;
+
+    gfx.fb[0] = Gfx_InitStruct->FrameBuffer[0];
+    gfx.fb[1] = Gfx_InitStruct->FrameBuffer[1];
+    gfx.width = Gfx_InitStruct->Width;
+    gfx.height = Gfx_InitStruct->Height;
+    gfx.format = Gfx_InitStruct->Format;
+    gfx.layer = Gfx_InitStruct->Layer;
+    gfx.front = 0;
+    gfx.swap = GFX_SWAP_IDLE;
+    gfx.synced = 1;
+    Gfx_RegionClear(&gfx.cur);
+    Gfx_RegionClear(&gfx.prev);
+    queue_wr = 0;
+    queue_rd = 0;
+    dma2d_busy = 0;
+
+    RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA2D, ENABLE);
+    DMA2D_DeInit();
+
+    NVIC_InitStructure.NVIC_IRQChannel = DMA2D_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = Gfx_InitStruct->NVIC_PreemptionPriority;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = Gfx_InitStruct->NVIC_SubPriority;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+    NVIC_InitStructure.NVIC_IRQChannel = LTDC_IRQn;
+    NVIC_Init(&NVIC_InitStructure);
+
+    gfx_stats.Frames = 0;
+    gfx_stats.LateFrames = 0;
+    gfx_stats.Commands = 0;
+    gfx_stats.Pixels = 0;
+    gfx_stats.SyncPixels = 0;
+    gfx_stats.QueueFull = 0;
+    gfx_stats.Errors = 0;
+
+    //两个缓冲都清成黑色, 保证开始时内容一致
+    all.Count = 1;
+    all.Rect[0].X0 = 0;
+    all.Rect[0].Y0 = 0;
+    all.Rect[0].X1 = gfx.width;
+    all.Rect[0].Y1 = gfx.height;
+    cmd.Op = GFX_OP_FILL;
+    cmd.SrcFormat = gfx.format;
+    cmd.DstFormat = gfx.format;
+    cmd.AlphaMode = GFX_ALPHA_NONE;
+    cmd.Alpha = 0xFF;
+    cmd.Color = 0xFF000000;
+    cmd.Src = 0;
+    cmd.SrcStride = 0;
+    cmd.DstStride = gfx.width;
+    cmd.Width = gfx.width;
+    cmd.Height = gfx.height;
+    cmd.Dst = gfx.fb[0];
+    Gfx_RegionEmit(&all, &cmd, 0, 0, Gfx_Push);
+    cmd.Dst = gfx.fb[1];
+    Gfx_RegionEmit(&all, &cmd, 0, 0, Gfx_Push);
+
+    LTDC_LayerAddress(gfx.layer, (uint32_t)gfx.fb[0]);
+    LTDC_ReloadConfig(LTDC_IMReload);
+    LTDC_LIPConfig(Gfx_InitStruct->SwapLine);
+    LTDC_ClearITPendingBit(LTDC_IT_LI | LTDC_IT_RR);
+    LTDC_ITConfig(LTDC_IT_LI | LTDC_IT_RR, ENABLE);
+
+    return Gfx_Wait();
+}
+
+ErrorStatus Gfx_BeginFrame(void) {
+    uint32_t timeout = GFX_TIMEOUT;
+
+    while(gfx.swap != GFX_SWAP_IDLE) {
+        if(--timeout == 0) return ERROR;
+    }
+
+    Gfx_RegionClear(&gfx.cur);
+    gfx.synced = 0;
+
+    return SUCCESS;
+}
+
+void Gfx_Invalidate(const Gfx_Rect *r) {
+    Gfx_Rect screen;
+
+    screen.X0 = 0;
+    screen.Y0 = 0;
+    screen.X1 = gfx.width;
+    screen.Y1 = gfx.height;
+    Gfx_RegionAdd(&gfx.cur, r, &screen);
+}
+
+void Gfx_Fill(const Gfx_Rect *r, uint32_t Color) {
+    Gfx_Cmd cmd;
+
+    if(r->X1 <= r->X0 || r->Y1 <= r->Y0) return;
+
+    cmd.Op = GFX_OP_FILL;
+    cmd.SrcFormat = gfx.format;
+    cmd.AlphaMode = GFX_ALPHA_NONE;
+    cmd.Alpha = 0xFF;
+    cmd.Color = Color;
+    cmd.Src = 0;
+    cmd.SrcStride = 0;
+    cmd.Width = r->X1 - r->X0;
+    cmd.Height = r->Y1 - r->Y0;
+    Gfx_Draw(&cmd, r->X0, r->Y0);
+}
+
+void Gfx_DrawImage(const Gfx_Image *img, int16_t x, int16_t y) {
+    Gfx_Cmd cmd;
+
+    Gfx_Image2Cmd(&cmd, img);
+    cmd.Op = img->Format == gfx.format ? GFX_OP_COPY : GFX_OP_CONVERT;
+    cmd.AlphaMode = GFX_ALPHA_NONE;
+    cmd.Alpha = 0xFF;
+    cmd.Color = 0;
+    Gfx_Draw(&cmd, x, y);
+}
+
+void Gfx_BlendImage(const Gfx_Image *img, int16_t x, int16_t y, uint32_t Color, uint8_t Alpha) {
+    Gfx_Cmd cmd;
+
+    if(Alpha == 0) return;
+
+    Gfx_Image2Cmd(&cmd, img);
+    cmd.Op = GFX_OP_BLEND;
+    cmd.AlphaMode = Alpha == 0xFF ? GFX_ALPHA_NONE : GFX_ALPHA_COMBINE;
+    cmd.Alpha = Alpha;
+    cmd.Color = Color;
+    Gfx_Draw(&cmd, x, y);
+}
+
+//本帧没有任何变化时不换帧; 后台若还没同步, 上一帧的脏区域留到下一帧再拷
+void Gfx_Present(void) {
+    if(gfx.cur.Count == 0) {
+        if(gfx.synced) Gfx_RegionClear(&gfx.prev);
+
+        return;
+    }
+
+    if(gfx.synced == 0) Gfx_Sync();
+
+    gfx.prev = gfx.cur;
+    gfx.swap = GFX_SWAP_PENDING;
+}
+
+ErrorStatus Gfx_Wait(void) {
+    uint32_t timeout = GFX_TIMEOUT;
+
+    while(dma2d_busy) {
+        if(--timeout == 0) return ERROR;
+    }
+
+    return SUCCESS;
+}
+
+uint8_t *Gfx_GetBackBuffer(void) {
+    return gfx.fb[gfx.front ^ 1];
+}
+
+void Gfx_GetStats(Gfx_Stats *stats) {
+    *stats = gfx_stats;
+}
+
+void DMA2D_IRQHandler(void) {
+    const Gfx_Cmd *cmd = &queue[queue_rd & GFX_QUEUE_MASK];
+    uint32_t rd;
+
+    //出错的命令丢弃, 继续执行后面的
+    if(DMA2D_GetITStatus(DMA2D_IT_TE) != RESET || DMA2D_GetITStatus(DMA2D_IT_CE) != RESET) {
+        DMA2D_ClearITPendingBit(DMA2D_IT_TE | DMA2D_IT_CE);
+        gfx_stats.Errors++;
+    } else if(DMA2D_GetITStatus(DMA2D_IT_TC) != RESET) {
+        DMA2D_ClearITPendingBit(DMA2D_IT_TC);
+        gfx_stats.Commands++;
+        gfx_stats.Pixels += (uint32_t)cmd->Width * cmd->Height;
+    } else {
+        return;
+    }
+
+    rd = queue_rd + 1;
+    queue_rd = rd;
+
+    if(rd != queue_wr) Gfx_Start(&queue[rd & GFX_QUEUE_MASK]);
+    else dma2d_busy = 0;
+}
+
+//最后一个有效行: 画完了就切换地址, 在随后的垂直消隐重装; 重装完成后后台才可以再画
+void LTDC_IRQHandler(void) {
+    if(LTDC_GetITStatus(LTDC_IT_LI) != RESET) {
+        LTDC_ClearITPendingBit(LTDC_IT_LI);
+
+        if(gfx.swap == GFX_SWAP_PENDING) {
+            if(dma2d_busy) {
+                gfx_stats.LateFrames++;
+            } else {
+                LTDC_LayerAddress(gfx.layer, (uint32_t)gfx.fb[gfx.front ^ 1]);
+                LTDC_ReloadConfig(LTDC_VBReload);
+                gfx.swap = GFX_SWAP_RELOAD;
+            }
+        }
+    }
+
+    if(LTDC_GetITStatus(LTDC_IT_RR) != RESET) {
+        LTDC_ClearITPendingBit(LTDC_IT_RR);
+
+        if(gfx.swap == GFX_SWAP_RELOAD) {
+            gfx.front ^= 1;
+            gfx.swap = GFX_SWAP_IDLE;
+            gfx_stats.Frames++;
+        }
+    }
+}
+
+#endif /* STM32F429_439xx || STM32F469_479xx */
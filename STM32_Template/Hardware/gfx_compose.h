@@ -0,0 +1,85 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : gfx_compose.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : DMA2D命令队列 + LTDC双缓冲的脏矩形合成器
+  *				   (仅带LTDC的型号: STM32F429/439/469/479)
+  * Function List:
+  *		Gfx_StructInit
+  *		Gfx_Init
+  *		Gfx_BeginFrame
+  *		Gfx_Invalidate
+  *		Gfx_Fill
+  *		Gfx_DrawImage
+  *		Gfx_BlendImage
+  *		Gfx_Present
+  *		Gfx_Wait
+  *		Gfx_GetBackBuffer
+  *		Gfx_GetStats
+  ******************************************************
+**/
+
+#ifndef __GFX_COMPOSE_H_
+#define __GFX_COMPOSE_H_
+
+#include "stm32f4xx_conf.h"
+#include "gfx_soft.h"
+
+#if defined(STM32F429_439xx) || defined(STM32F469_479xx)
+
+#define GFX_QUEUE_LEN               64          //DMA2D命令队列长度, 2的幂
+#define GFX_TIMEOUT                 0x01000000  //等待队列/换帧的循环次数
+
+//图像, Data 指向左上角像素, Stride 为每行像素数
+typedef struct {
+    const uint8_t *Data;
+    uint16_t Width;
+    uint16_t Height;
+    uint16_t Stride;
+    uint8_t  Format;                //GFX_ARGB8888/RGB888/RGB565/ARGB1555/ARGB4444/A8
+} Gfx_Image;
+
+typedef struct {
+    uint8_t *FrameBuffer[2];        //两个帧缓冲, 开始时显示 FrameBuffer[0]
+    uint16_t Width;
+    uint16_t Height;
+    uint8_t  Format;                //帧缓冲格式, 与LTDC层的像素格式一致
+    LTDC_Layer_TypeDef *Layer;      //LTDC_Layer1/LTDC_Layer2, 层参数由应用先用LTDC_LayerInit配置
+    uint16_t SwapLine;              //行中断位置, 取最后一个有效行(AccumulatedActiveH), 换帧在随后的垂直消隐生效
+    uint8_t  NVIC_PreemptionPriority;
+    uint8_t  NVIC_SubPriority;
+} Gfx_InitTypeDef;
+
+typedef struct {
+    uint32_t Frames;                //已显示的帧数
+    uint32_t LateFrames;            //行中断到达时DMA2D还没画完, 推迟一帧显示的次数
+    uint32_t Commands;              //DMA2D执行的命令数
+    uint32_t Pixels;                //DMA2D输出的像素数
+    uint32_t SyncPixels;            //从前台拷回后台以保持两缓冲一致的像素数
+    uint32_t QueueFull;             //入队时队列满而等待的次数
+    uint32_t Errors;                //DMA2D传输/配置错误
+} Gfx_Stats;
+
+void Gfx_StructInit(Gfx_InitTypeDef *Gfx_InitStruct); // 缺省480x272 RGB565, Layer1, 抢占优先级1
+ErrorStatus Gfx_Init(Gfx_InitTypeDef *Gfx_InitStruct); // 清空两个帧缓冲, 开启DMA2D/LTDC中断, 显示 FrameBuffer[0]
+ErrorStatus Gfx_BeginFrame(void); // 等待上一帧换帧完成, 开始新的一帧
+void Gfx_Invalidate(const Gfx_Rect *r); // 标记本帧要重画的区域, 须在本帧所有绘图之前调用
+void Gfx_Fill(const Gfx_Rect *r, uint32_t Color); // 填充矩形, 颜色为ARGB8888
+void Gfx_DrawImage(const Gfx_Image *img, int16_t x, int16_t y); // 不透明贴图, 格式不同时自动转换
+void Gfx_BlendImage(const Gfx_Image *img, int16_t x, int16_t y, uint32_t Color, uint8_t Alpha); // 按像素alpha与整体Alpha混合, A8图像使用 Color
+void Gfx_Present(void); // 提交本帧, 画完后在下一个行中断换帧
+ErrorStatus Gfx_Wait(void); // 等待DMA2D队列执行完, 之后CPU才能直接访问后台缓冲
+uint8_t *Gfx_GetBackBuffer(void); // 当前后台缓冲
+void Gfx_GetStats(Gfx_Stats *stats); // 读取统计信息
+
+#endif /* STM32F429_439xx || STM32F469_479xx */
+
+#endif
@@ -0,0 +1,355 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : gfx_soft.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					绘图命令在这里生成和裁剪, 目标板上交给DMA2D执行, PC上交给
+					Gfx_SwExecute 执行. 两边走的是同一条命令流, 所以在PC上:
+					  1. 用整屏区域把一帧完整画一遍, 得到参考图像
+					  2. 用脏矩形区域只重画变化部分
+					  3. Gfx_SwCompare 比较两者
+					即可验证脏矩形跟踪和裁剪是否正确. 软件执行的像素格式扩展和
+					混合公式按DMA2D手册实现, 与硬件输出最多差1个LSB, 比较时给
+					tolerance = 1 即可直接比对板上读回的帧缓冲.
+  * Function List:
+  *		Gfx_BytesPerPixel
+  *		Gfx_RectIntersect
+  *		Gfx_RegionClear
+  *		Gfx_RegionAdd
+  *		Gfx_RegionContains
+  *		Gfx_RegionEmit
+  *		Gfx_SwExecute
+  *		Gfx_SwCompare
+  **********************************************************
+ */
+
+#include "gfx_soft.h"
+
+static uint32_t Gfx_RectArea(const Gfx_Rect *r) {
+    return (uint32_t)(r->X1 - r->X0) * (uint32_t)(r->Y1 - r->Y0);
+}
+
+static void Gfx_RectUnion(Gfx_Rect *out, const Gfx_Rect *a, const Gfx_Rect *b) {
+    out->X0 = a->X0 < b->X0 ? a->X0 : b->X0;
+    out->Y0 = a->Y0 < b->Y0 ? a->Y0 : b->Y0;
+    out->X1 = a->X1 > b->X1 ? a->X1 : b->X1;
+    out->Y1 = a->Y1 > b->Y1 ? a->Y1 : b->Y1;
+}
+
+//读一个像素并扩展为ARGB8888, 低位用高位填充, 与DMA2D的PFC相同
+static uint32_t Gfx_Load(const uint8_t *p, uint8_t format, uint32_t color) {
+    uint32_t v, a, r, g, b;
+
+    switch(format) {
+        case GFX_ARGB8888:
+            return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+
+        case GFX_RGB888:
+            return 0xFF000000 | p[0] | (p[1] << 8) | (p[2] << 16);
+
+        case GFX_RGB565:
+            v = p[0] | (p[1] << 8);
+            a = 0xFF;
+            r = (v >> 11) & 0x1F;
+            g = (v >> 5) & 0x3F;
+            b = v & 0x1F;
+            r = (r << 3) | (r >> 2);
+            g = (g << 2) | (g >> 4);
+            b = (b << 3) | (b >> 2);
+            break;
+
+        case GFX_ARGB1555:
+            v = p[0] | (p[1] << 8);
+            a = (v & 0x8000) ? 0xFF : 0x00;
+            r = (v >> 10) & 0x1F;
+            g = (v >> 5) & 0x1F;
+            b = v & 0x1F;
+            r = (r << 3) | (r >> 2);
+            g = (g << 3) | (g >> 2);
+            b = (b << 3) | (b >> 2);
+            break;
+
+        case GFX_ARGB4444:
+            v = p[0] | (p[1] << 8);
+            a = ((v >> 12) & 0x0F) * 17;
+            r = ((v >> 8) & 0x0F) * 17;
+            g = ((v >> 4) & 0x0F) * 17;
+            b = (v & 0x0F) * 17;
+            break;
+
+        default:    //GFX_A8
+            return (color & 0x00FFFFFF) | ((uint32_t)p[0] << 24);
+    }
+
+    return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+//ARGB8888 截位写成目标格式
+static void Gfx_Store(uint8_t *p, uint8_t format, uint32_t argb) {
+    uint32_t a = argb >> 24, r = (argb >> 16) & 0xFF, g = (argb >> 8) & 0xFF, b = argb & 0xFF;
+    uint32_t v;
+
+    switch(format) {
+        case GFX_ARGB8888:
+            p[3] = (uint8_t)a;
+
+        /* fall through */
+        case GFX_RGB888:
+            p[0] = (uint8_t)b;
+            p[1] = (uint8_t)g;
+            p[2] = (uint8_t)r;
+            return;
+
+        case GFX_RGB565:
+            v = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
+            break;
+
+        case GFX_ARGB1555:
+            v = ((a >> 7) << 15) | ((r >> 3) << 10) | ((g >> 3) << 5) | (b >> 3);
+            break;
+
+        default:    //GFX_ARGB4444
+            v = ((a >> 4) << 12) | ((r >> 4) << 8) | ((g >> 4) << 4) | (b >> 4);
+            break;
+    }
+
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static uint32_t Gfx_ApplyAlpha(uint32_t argb, const Gfx_Cmd *cmd) {
+    if(cmd->AlphaMode == GFX_ALPHA_REPLACE)
+        return (argb & 0x00FFFFFF) | ((uint32_t)cmd->Alpha << 24);
+
+    if(cmd->AlphaMode == GFX_ALPHA_COMBINE)
+        return (argb & 0x00FFFFFF) | (((argb >> 24) * cmd->Alpha / 255) << 24);
+
+    return argb;
+}
+
+//DMA2D混合公式: am = af*ab/255, ao = af + ab - am, C = (Cf*af + Cb*ab - Cb*am) / ao
+static uint32_t Gfx_Blend(uint32_t fg, uint32_t bg) {
+    uint32_t af = fg >> 24, ab = bg >> 24;
+    uint32_t am = af * ab / 255;
+    uint32_t ao = af + ab - am;
+    uint32_t out, sh, cf, cb;
+
+    if(ao == 0)
+        return 0;
+
+    out = ao << 24;
+
+    for(sh = 0; sh < 24; sh += 8) {
+        cf = (fg >> sh) & 0xFF;
+        cb = (bg >> sh) & 0xFF;
+        out |= ((cf * af + cb * ab - cb * am) / ao) << sh;
+    }
+
+    return out;
+}
+
+uint8_t Gfx_BytesPerPixel(uint8_t format) {
+    switch(format) {
+        case GFX_ARGB8888:
+            return 4;
+
+        case GFX_RGB888:
+            return 3;
+
+        case GFX_RGB565:
+        case GFX_ARGB1555:
+        case GFX_ARGB4444:
+            return 2;
+
+        case GFX_A8:
+            return 1;
+
+        default:
+            return 0;
+    }
+}
+
+uint8_t Gfx_RectIntersect(Gfx_Rect *out, const Gfx_Rect *a, const Gfx_Rect *b) {
+    out->X0 = a->X0 > b->X0 ? a->X0 : b->X0;
+    out->Y0 = a->Y0 > b->Y0 ? a->Y0 : b->Y0;
+    out->X1 = a->X1 < b->X1 ? a->X1 : b->X1;
+    out->Y1 = a->Y1 < b->Y1 ? a->Y1 : b->Y1;
+
+    return out->X0 < out->X1 && out->Y0 < out->Y1;
+}
+
+void Gfx_RegionClear(Gfx_Region *rg) {
+    rg->Count = 0;
+}
+
+void Gfx_RegionAdd(Gfx_Region *rg, const Gfx_Rect *r, const Gfx_Rect *bounds) {
+    Gfx_Rect n, u, t;
+    uint32_t cost, best;
+    uint8_t i, pick;
+
+    if(!Gfx_RectIntersect(&n, r, bounds))
+        return;
+
+    for(;;) {
+        //重叠的必须合并, 否则BLEND会在重叠处执行两次; 合并后多出的面积不超过1/4的也合并, 减少命令数
+        for(i = 0; i < rg->Count; i++) {
+            Gfx_RectUnion(&u, &n, &rg->Rect[i]);
+
+            if(Gfx_RectIntersect(&t, &n, &rg->Rect[i]) ||
+                    (Gfx_RectArea(&u) - Gfx_RectArea(&n) - Gfx_RectArea(&rg->Rect[i])) * 4 <=
+                    Gfx_RectArea(&n) + Gfx_RectArea(&rg->Rect[i]))
+                break;
+        }
+
+        if(i == rg->Count) {
+            if(rg->Count < GFX_DIRTY_MAX)
+                break;
+
+            //已满, 选并入后面积增加最少的一个
+            best = 0xFFFFFFFF;
+            pick = 0;
+
+            for(i = 0; i < rg->Count; i++) {
+                Gfx_RectUnion(&u, &n, &rg->Rect[i]);
+                cost = Gfx_RectArea(&u) - Gfx_RectArea(&rg->Rect[i]);
+
+                if(cost < best) {
+                    best = cost;
+                    pick = i;
+                }
+            }
+
+            i = pick;
+            Gfx_RectUnion(&u, &n, &rg->Rect[i]);
+        }
+
+        //变大后可能又与其他矩形重叠, 继续检查
+        n = u;
+        rg->Rect[i] = rg->Rect[--rg->Count];
+    }
+
+    rg->Rect[rg->Count++] = n;
+}
+
+uint8_t Gfx_RegionContains(const Gfx_Region *rg, const Gfx_Rect *r) {
+    uint8_t i;
+
+    for(i = 0; i < rg->Count; i++) {
+        if(r->X0 >= rg->Rect[i].X0 && r->Y0 >= rg->Rect[i].Y0 &&
+                r->X1 <= rg->Rect[i].X1 && r->Y1 <= rg->Rect[i].Y1)
+            return 1;
+    }
+
+    return 0;
+}
+
+//cmd 的 Dst 指向画布(0,0), Src 指向图像(0,0), Width/Height 为整幅图像尺寸
+uint32_t Gfx_RegionEmit(const Gfx_Region *rg, const Gfx_Cmd *cmd, int16_t x, int16_t y, Gfx_Sink sink) {
+    Gfx_Rect area, clip;
+    Gfx_Cmd c;
+    uint8_t sbpp = Gfx_BytesPerPixel(cmd->SrcFormat);
+    uint8_t dbpp = Gfx_BytesPerPixel(cmd->DstFormat);
+    uint32_t n = 0;
+    uint8_t i;
+
+    area.X0 = x;
+    area.Y0 = y;
+    area.X1 = (int16_t)(x + cmd->Width);
+    area.Y1 = (int16_t)(y + cmd->Height);
+
+    for(i = 0; i < rg->Count; i++) {
+        if(!Gfx_RectIntersect(&clip, &area, &rg->Rect[i]))
+            continue;
+
+        c = *cmd;
+        c.Dst = cmd->Dst + ((uint32_t)clip.Y0 * cmd->DstStride + (uint32_t)clip.X0) * dbpp;
+
+        if(cmd->Op != GFX_OP_FILL)
+            c.Src = cmd->Src + ((uint32_t)(clip.Y0 - y) * cmd->SrcStride + (uint32_t)(clip.X0 - x)) * sbpp;
+
+        c.Width = (uint16_t)(clip.X1 - clip.X0);
+        c.Height = (uint16_t)(clip.Y1 - clip.Y0);
+        sink(&c);
+        n++;
+    }
+
+    return n;
+}
+
+void Gfx_SwExecute(const Gfx_Cmd *cmd) {
+    uint8_t sbpp = Gfx_BytesPerPixel(cmd->SrcFormat);
+    uint8_t dbpp = Gfx_BytesPerPixel(cmd->DstFormat);
+    const uint8_t *s;
+    uint8_t *d;
+    uint32_t argb;
+    uint16_t x, y;
+    uint8_t k;
+
+    for(y = 0; y < cmd->Height; y++) {
+        s = cmd->Src + (uint32_t)y * cmd->SrcStride * sbpp;
+        d = cmd->Dst + (uint32_t)y * cmd->DstStride * dbpp;
+
+        for(x = 0; x < cmd->Width; x++, s += sbpp, d += dbpp) {
+            switch(cmd->Op) {
+                case GFX_OP_FILL:
+                    Gfx_Store(d, cmd->DstFormat, cmd->Color);
+                    break;
+
+                case GFX_OP_COPY:
+                    for(k = 0; k < dbpp; k++)
+                        d[k] = s[k];
+
+                    break;
+
+                case GFX_OP_CONVERT:
+                    argb = Gfx_ApplyAlpha(Gfx_Load(s, cmd->SrcFormat, cmd->Color), cmd);
+                    Gfx_Store(d, cmd->DstFormat, argb);
+                    break;
+
+                default:    //GFX_OP_BLEND
+                    argb = Gfx_ApplyAlpha(Gfx_Load(s, cmd->SrcFormat, cmd->Color), cmd);
+                    Gfx_Store(d, cmd->DstFormat, Gfx_Blend(argb, Gfx_Load(d, cmd->DstFormat, 0)));
+                    break;
+            }
+        }
+    }
+}
+
+uint32_t Gfx_SwCompare(const uint8_t *a, const uint8_t *b, uint16_t width, uint16_t height,
+                       uint16_t stride, uint8_t format, uint8_t tolerance) {
+    uint8_t bpp = Gfx_BytesPerPixel(format);
+    uint32_t off, pa, pb, da, db, diff, sh;
+    uint32_t bad = 0;
+    uint16_t x, y;
+
+    for(y = 0; y < height; y++) {
+        for(x = 0; x < width; x++) {
+            off = ((uint32_t)y * stride + x) * bpp;
+            pa = Gfx_Load(a + off, format, 0);
+            pb = Gfx_Load(b + off, format, 0);
+
+            for(sh = 0; sh < 32; sh += 8) {
+                da = (pa >> sh) & 0xFF;
+                db = (pb >> sh) & 0xFF;
+                diff = da > db ? da - db : db - da;
+
+                if(diff > tolerance) {
+                    bad++;
+                    break;
+                }
+            }
+        }
+    }
+
+    return bad;
+}
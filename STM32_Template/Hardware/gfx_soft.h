@@ -0,0 +1,98 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : gfx_soft.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 与硬件无关的图形部分: 绘图命令/脏矩形区域/软件参考光栅器,
+  *				   只依赖 stdint.h, 可以直接在PC上编译, 用来核对DMA2D的输出
+  * Function List:
+  *		Gfx_BytesPerPixel
+  *		Gfx_RectIntersect
+  *		Gfx_RegionClear
+  *		Gfx_RegionAdd
+  *		Gfx_RegionContains
+  *		Gfx_RegionEmit
+  *		Gfx_SwExecute
+  *		Gfx_SwCompare
+  ******************************************************
+**/
+
+#ifndef __GFX_SOFT_H_
+#define __GFX_SOFT_H_
+
+#include <stdint.h>
+
+//像素格式, 编码与DMA2D的CM字段一致, 可以直接写入寄存器
+#define GFX_ARGB8888                0
+#define GFX_RGB888                  1
+#define GFX_RGB565                  2
+#define GFX_ARGB1555                3
+#define GFX_ARGB4444                4
+#define GFX_A8                      9       //只作源格式, 颜色取命令中的 Color
+
+//命令类型, 对应DMA2D的 R2M/M2M/M2M_PFC/M2M_BLEND
+#define GFX_OP_FILL                 0
+#define GFX_OP_COPY                 1
+#define GFX_OP_CONVERT              2
+#define GFX_OP_BLEND                3
+
+//源图像alpha处理, 编码与DMA2D的AM字段一致
+#define GFX_ALPHA_NONE              0       //使用像素自身alpha
+#define GFX_ALPHA_REPLACE           1       //用 Alpha 替换
+#define GFX_ALPHA_COMBINE           2       //像素alpha * Alpha / 255
+
+#define GFX_DIRTY_MAX               16      //每帧最多保留的脏矩形数, 超出后合并
+
+//矩形, X1/Y1 不包含在内
+typedef struct {
+    int16_t X0;
+    int16_t Y0;
+    int16_t X1;
+    int16_t Y1;
+} Gfx_Rect;
+
+//互不重叠的脏矩形集合
+typedef struct {
+    Gfx_Rect Rect[GFX_DIRTY_MAX];
+    uint8_t  Count;
+} Gfx_Region;
+
+//一条绘图命令, 等价于一次DMA2D传输
+typedef struct {
+    uint8_t  Op;                    //GFX_OP_xxx
+    uint8_t  SrcFormat;             //COPY/CONVERT/BLEND 的源格式
+    uint8_t  DstFormat;
+    uint8_t  AlphaMode;             //GFX_ALPHA_xxx, 作用于源图像
+    uint8_t  Alpha;
+    uint32_t Color;                 //FILL的颜色或A8源的颜色, ARGB8888
+    const uint8_t *Src;             //源区域第一个像素
+    uint8_t  *Dst;                  //目标区域第一个像素, BLEND时同时是背景
+    uint16_t SrcStride;             //源每行像素数
+    uint16_t DstStride;             //目标每行像素数
+    uint16_t Width;
+    uint16_t Height;
+} Gfx_Cmd;
+
+//命令输出函数, 目标板上入DMA2D队列, PC上直接调用 Gfx_SwExecute
+typedef void (*Gfx_Sink)(const Gfx_Cmd *cmd);
+
+uint8_t Gfx_BytesPerPixel(uint8_t format); // 每像素字节数, 不支持的格式返回0
+uint8_t Gfx_RectIntersect(Gfx_Rect *out, const Gfx_Rect *a, const Gfx_Rect *b); // 求交集, 为空返回0
+
+void Gfx_RegionClear(Gfx_Region *rg); // 清空区域
+void Gfx_RegionAdd(Gfx_Region *rg, const Gfx_Rect *r, const Gfx_Rect *bounds); // 加入矩形, 重叠或合并代价小的矩形会合并, 保证互不重叠
+uint8_t Gfx_RegionContains(const Gfx_Region *rg, const Gfx_Rect *r); // r 完全落在某一个脏矩形内返回1
+uint32_t Gfx_RegionEmit(const Gfx_Region *rg, const Gfx_Cmd *cmd, int16_t x, int16_t y, Gfx_Sink sink); // 把放在(x,y)的命令按区域裁剪后逐条输出, 返回条数
+
+void Gfx_SwExecute(const Gfx_Cmd *cmd); // 软件执行一条命令, 运算方式与DMA2D相同
+uint32_t Gfx_SwCompare(const uint8_t *a, const uint8_t *b, uint16_t width, uint16_t height,
+                       uint16_t stride, uint8_t format, uint8_t tolerance); // 比较两幅图像, 返回有通道差值超过 tolerance 的像素数
+
+#endif
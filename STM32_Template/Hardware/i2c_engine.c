@@ -0,0 +1,515 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : i2c_engine.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					库函数只提供 I2C_GenerateSTART/I2C_Send7bitAddress/I2C_CheckEvent 等原始操作,
+					驱动在各阶段之间循环等待 I2C_CheckEvent, 400kHz下读一个寄存器CPU要等约100us.
+					这里事务排成队列, 由事件中断(SB/ADDR/BTF)推进: 起始->地址->写数据->重复起始->
+					地址->读数据->停止, 一个事务结束立即开始下一个, CPU只在中断中花几微秒.
+					数据阶段用 dma_mgr 分配的DMA数据流搬运: 写阶段DMA搬完后等BTF再发重复起始
+					或停止; 读阶段打开 I2C_DMALastTransferCmd, 最后一个字节自动回NACK, DMA完成
+					时发停止. DMA搬运期间关闭事件中断, 避免数据流排队时BTF反复进中断.
+					短于 I2CE_DMA_MIN 的数据阶段(以及分配不到数据流时)在事件中断中逐字节收发.
+					没有应答(AF)时发停止结束事务; 总线错误、仲裁丢失和超时时复位I2C,
+					用GPIO输出最多9个SCL脉冲释放被从机拉低的SDA, 再补一个停止条件.
+					I2C事件/错误中断和 dma_mgr 的中断应使用相同的抢占优先级.
+  * Function List:
+  *		I2CE_Init
+  *		I2CE_Submit
+  *		I2CE_SubmitBatch
+  *		I2CE_Poll
+  *		I2CE_Idle
+  *		I2CE_GetStats
+  *		I2CE_EV_IRQHandler
+  *		I2CE_ER_IRQHandler
+  **********************************************************
+ */
+
+#include "i2c_engine.h"
+
+//当前事务所处阶段
+#define I2CE_PH_WADDR       0       //起始条件和写地址
+#define I2CE_PH_WDATA       1
+#define I2CE_PH_RADDR       2       //(重复)起始条件和读地址
+#define I2CE_PH_RDATA       3
+
+#define I2CE_SR1_ERR        (I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_OVR | I2C_SR1_PECERR | I2C_SR1_TIMEOUT)
+
+static I2C_InitTypeDef i2ce_init;
+
+static I2CE_Trans *i2ce_head;       //正在执行的事务, 其后是等待的事务
+static I2CE_Trans *i2ce_tail;
+static uint32_t i2ce_depth;
+
+static volatile uint8_t i2ce_phase;
+static uint8_t  i2ce_dma;           //1: 当前数据阶段走DMA
+static uint16_t i2ce_idx;           //逐字节收发时已完成的字节数
+static uint32_t i2ce_start;         //事务开始时的DWT计数
+static uint32_t i2ce_timeout;       //CPU周期
+static DMA_Mgr_Xfer i2ce_xfer;
+static I2CE_Stats i2ce_stats;
+
+static void I2CE_DelayUs(uint32_t us) {
+    uint32_t start = DWT->CYCCNT;
+    uint32_t cycles = us * (SystemCoreClock / 1000000);
+
+    while(DWT->CYCCNT - start < cycles);
+}
+
+static void I2CE_PinConfig(GPIOMode_TypeDef mode) {
+    GPIO_InitTypeDef GPIO_InitStructure;
+
+    GPIO_InitStructure.GPIO_Pin = I2CE_SCL_PIN | I2CE_SDA_PIN;
+    GPIO_InitStructure.GPIO_Mode = mode;
+    GPIO_InitStructure.GPIO_OType = GPIO_OType_OD;
+    GPIO_InitStructure.GPIO_PuPd = GPIO_PuPd_UP;
+    GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+    GPIO_Init(I2CE_GPIO_PORT, &GPIO_InitStructure);
+}
+
+//复位I2C, 释放被从机拉住的SDA, 补一个停止条件后重新初始化
+static void I2CE_Recover(void) {
+    uint8_t i;
+
+    I2C_Cmd(I2CE_I2C, DISABLE);
+
+    GPIO_SetBits(I2CE_GPIO_PORT, I2CE_SCL_PIN | I2CE_SDA_PIN);
+    I2CE_PinConfig(GPIO_Mode_OUT);
+    I2CE_DelayUs(5);
+
+    //从机还在发送时每个SCL脉冲移出一位, 最多9个脉冲后它会在应答位松开SDA
+    for(i = 0; i < 9 && GPIO_ReadInputDataBit(I2CE_GPIO_PORT, I2CE_SDA_PIN) == Bit_RESET; i++) {
+        GPIO_ResetBits(I2CE_GPIO_PORT, I2CE_SCL_PIN);
+        I2CE_DelayUs(5);
+        GPIO_SetBits(I2CE_GPIO_PORT, I2CE_SCL_PIN);
+        I2CE_DelayUs(5);
+    }
+
+    //停止条件: SCL高时SDA由低变高
+    GPIO_ResetBits(I2CE_GPIO_PORT, I2CE_SCL_PIN);
+    I2CE_DelayUs(5);
+    GPIO_ResetBits(I2CE_GPIO_PORT, I2CE_SDA_PIN);
+    I2CE_DelayUs(5);
+    GPIO_SetBits(I2CE_GPIO_PORT, I2CE_SCL_PIN);
+    I2CE_DelayUs(5);
+    GPIO_SetBits(I2CE_GPIO_PORT, I2CE_SDA_PIN);
+    I2CE_DelayUs(5);
+
+    I2CE_PinConfig(GPIO_Mode_AF);
+
+    //BUSY等状态只能由软件复位清除
+    I2C_SoftwareResetCmd(I2CE_I2C, ENABLE);
+    I2C_SoftwareResetCmd(I2CE_I2C, DISABLE);
+    I2C_Init(I2CE_I2C, &i2ce_init);
+    I2C_Cmd(I2CE_I2C, ENABLE);
+
+    i2ce_stats.Recoveries++;
+}
+
+//关闭中断和DMA请求, 取消还没结束的数据流
+static void I2CE_Release(void) {
+    I2C_ITConfig(I2CE_I2C, I2C_IT_EVT | I2C_IT_BUF | I2C_IT_ERR, DISABLE);
+    I2C_DMACmd(I2CE_I2C, DISABLE);
+    I2C_DMALastTransferCmd(I2CE_I2C, DISABLE);
+    (void)DMA_Mgr_Cancel(&i2ce_xfer);
+}
+
+static void I2CE_Start(void);
+
+//结束队首事务, 开始下一个, 再调用回调
+static void I2CE_Finish(uint8_t result) {
+    I2CE_Trans *trans = i2ce_head;
+
+    I2CE_Release();
+
+    switch(result) {
+        case I2CE_OK:
+            i2ce_stats.Done++;
+            i2ce_stats.Bytes += trans->WLen + trans->RLen;
+            break;
+
+        case I2CE_NACK:
+            i2ce_stats.Nacks++;
+            break;
+
+        case I2CE_TIMEOUT:
+            i2ce_stats.Timeouts++;
+            break;
+
+        default:
+            i2ce_stats.Errors++;
+            break;
+    }
+
+    trans->Result = result;
+    trans->State = I2CE_DONE;
+
+    i2ce_head = trans->Next;
+    trans->Next = 0;
+
+    if(i2ce_head == 0) i2ce_tail = 0;
+
+    i2ce_depth--;
+
+    //先让总线继续工作, 回调中提交的事务排在后面
+    if(i2ce_head) I2CE_Start();
+
+    if(trans->Callback) trans->Callback(trans);
+}
+
+static void I2CE_Abort(uint8_t result) {
+    I2CE_Release();
+    I2CE_Recover();
+    I2CE_Finish(result);
+}
+
+//开始队首事务
+static void I2CE_Start(void) {
+    I2CE_Trans *trans = i2ce_head;
+    uint32_t n;
+
+    trans->State = I2CE_ACTIVE;
+    i2ce_phase = (trans->WLen != 0 || trans->RLen == 0) ? I2CE_PH_WADDR : I2CE_PH_RADDR;
+    i2ce_dma = 0;
+    i2ce_timeout = (trans->Timeout ? trans->Timeout : I2CE_TIMEOUT_US) * (SystemCoreClock / 1000000);
+    i2ce_start = DWT->CYCCNT;
+
+    //上一个事务的停止条件还没发完时不能发起始条件, 最多一个SCL周期
+    for(n = 10000; n != 0 && (I2CE_I2C->CR1 & I2C_CR1_STOP) != 0; n--);
+
+    I2C_AcknowledgeConfig(I2CE_I2C, ENABLE);
+    I2C_ITConfig(I2CE_I2C, I2C_IT_EVT | I2C_IT_ERR, ENABLE);
+    I2C_GenerateSTART(I2CE_I2C, ENABLE);
+}
+
+static void I2CE_DMADone(DMA_Mgr_Xfer *xfer);
+
+//为数据阶段申请DMA, 返回1表示走DMA
+static uint8_t I2CE_StartDMA(DMA_Mgr_Req req, uint32_t mem, uint16_t len, uint32_t dir) {
+    if(len < I2CE_DMA_MIN) return 0;
+
+    DMA_Mgr_XferInit(&i2ce_xfer);
+    i2ce_xfer.Req = req;
+    i2ce_xfer.PeriphAddr = (uint32_t)&I2CE_I2C->DR;
+    i2ce_xfer.MemAddr = mem;
+    i2ce_xfer.Count = len;
+    i2ce_xfer.DIR = dir;
+    i2ce_xfer.Priority = DMA_Priority_Medium;
+    i2ce_xfer.Callback = I2CE_DMADone;
+
+    if(DMA_Mgr_Submit(&i2ce_xfer) < 0) return 0;
+
+    i2ce_stats.DMAPhases++;
+
+    return 1;
+}
+
+//写地址已应答
+static void I2CE_WriteAddr(I2CE_Trans *trans) {
+    if(trans->WLen == 0) {
+        //只检查应答
+        (void)I2CE_I2C->SR2;
+        I2C_GenerateSTOP(I2CE_I2C, ENABLE);
+        I2CE_Finish(I2CE_OK);
+        return;
+    }
+
+    i2ce_phase = I2CE_PH_WDATA;
+    i2ce_idx = 0;
+    i2ce_dma = I2CE_StartDMA(I2CE_DMA_REQ_TX, (uint32_t)trans->WBuf, trans->WLen, DMA_DIR_MemoryToPeripheral);
+
+    if(i2ce_dma) {
+        I2C_DMACmd(I2CE_I2C, ENABLE);
+        I2C_ITConfig(I2CE_I2C, I2C_IT_EVT, DISABLE);
+    } else {
+        I2C_ITConfig(I2CE_I2C, I2C_IT_BUF, ENABLE);
+    }
+
+    //读SR1后读SR2清除ADDR
+    (void)I2CE_I2C->SR2;
+}
+
+//写阶段最后一个字节已移出(BTF)
+static void I2CE_WriteDone(I2CE_Trans *trans) {
+    I2C_DMACmd(I2CE_I2C, DISABLE);
+
+    if(trans->RLen != 0) {
+        i2ce_phase = I2CE_PH_RADDR;
+        I2C_GenerateSTART(I2CE_I2C, ENABLE);
+    } else {
+        I2C_GenerateSTOP(I2CE_I2C, ENABLE);
+        I2CE_Finish(I2CE_OK);
+    }
+}
+
+//读地址已应答
+static void I2CE_ReadAddr(I2CE_Trans *trans) {
+    i2ce_phase = I2CE_PH_RDATA;
+    i2ce_idx = 0;
+
+    if(trans->RLen == 1) {
+        //单字节: 清除ADDR前关闭应答, 清除后立即发停止
+        I2C_AcknowledgeConfig(I2CE_I2C, DISABLE);
+        (void)I2CE_I2C->SR2;
+        I2C_GenerateSTOP(I2CE_I2C, ENABLE);
+        I2C_ITConfig(I2CE_I2C, I2C_IT_BUF, ENABLE);
+        return;
+    }
+
+    I2C_AcknowledgeConfig(I2CE_I2C, ENABLE);
+    i2ce_dma = I2CE_StartDMA(I2CE_DMA_REQ_RX, (uint32_t)trans->RBuf, trans->RLen, DMA_DIR_PeripheralToMemory);
+
+    if(i2ce_dma) {
+        I2C_DMALastTransferCmd(I2CE_I2C, ENABLE);
+        I2C_DMACmd(I2CE_I2C, ENABLE);
+        I2C_ITConfig(I2CE_I2C, I2C_IT_EVT, DISABLE);
+    } else {
+        I2C_ITConfig(I2CE_I2C, I2C_IT_BUF, ENABLE);
+    }
+
+    (void)I2CE_I2C->SR2;
+}
+
+//数据阶段的DMA结束, 在DMA中断中调用
+static void I2CE_DMADone(DMA_Mgr_Xfer *xfer) {
+    if(i2ce_head == 0 || i2ce_dma == 0) return;
+
+    if(xfer->State != DMA_XFER_DONE) {
+        I2CE_Abort(I2CE_ERROR);
+        return;
+    }
+
+    if(i2ce_phase == I2CE_PH_WDATA) {
+        //最后一个字节可能还在DR中, 打开事件中断等BTF
+        I2C_ITConfig(I2CE_I2C, I2C_IT_EVT, ENABLE);
+    } else if(i2ce_phase == I2CE_PH_RDATA) {
+        I2C_GenerateSTOP(I2CE_I2C, ENABLE);
+        I2CE_Finish(I2CE_OK);
+    }
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	I2CE_Init()
+* 功能说明:	初始化I2C和引脚, 恢复总线, 使能事件和错误中断
+* 输    入: uint32_t ClockSpeed				SCL频率, 不超过400000
+*			uint8_t NVIC_PreemptionPriority	抢占优先级, 应与 DMA_Mgr_Init 的相同
+*			uint8_t NVIC_SubPriority			子优先级
+* 输    出: ErrorStatus		ClockSpeed 无效时返回 ERROR
+* 注意事项: 须先调用 DMA_Mgr_Init
+******************************************************************************************************************************************/
+ErrorStatus I2CE_Init(uint32_t ClockSpeed, uint8_t NVIC_PreemptionPriority, uint8_t NVIC_SubPriority) {
+    NVIC_InitTypeDef NVIC_InitStructure;
+
+    if(ClockSpeed == 0 || ClockSpeed > 400000) return ERROR;
+
+    RCC_AHB1PeriphClockCmd(I2CE_RCC_GPIO, ENABLE);
+    RCC_APB1PeriphClockCmd(I2CE_RCC_I2C, ENABLE);
+
+    GPIO_PinAFConfig(I2CE_GPIO_PORT, I2CE_SCL_PINSRC, I2CE_GPIO_AF);
+    GPIO_PinAFConfig(I2CE_GPIO_PORT, I2CE_SDA_PINSRC, I2CE_GPIO_AF);
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    I2C_StructInit(&i2ce_init);
+    i2ce_init.I2C_ClockSpeed = ClockSpeed;
+    i2ce_init.I2C_Mode = I2C_Mode_I2C;
+    i2ce_init.I2C_DutyCycle = I2C_DutyCycle_2;
+    i2ce_init.I2C_OwnAddress1 = 0;
+    i2ce_init.I2C_Ack = I2C_Ack_Enable;
+    i2ce_init.I2C_AcknowledgedAddress = I2C_AcknowledgedAddress_7bit;
+
+    i2ce_head = 0;
+    i2ce_tail = 0;
+    i2ce_depth = 0;
+    DMA_Mgr_XferInit(&i2ce_xfer);
+
+    i2ce_stats.Done = 0;
+    i2ce_stats.Nacks = 0;
+    i2ce_stats.Errors = 0;
+    i2ce_stats.Timeouts = 0;
+    i2ce_stats.Recoveries = 0;
+    i2ce_stats.Bytes = 0;
+    i2ce_stats.DMAPhases = 0;
+    i2ce_stats.QueueMax = 0;
+
+    I2CE_Recover();
+
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = NVIC_PreemptionPriority;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = NVIC_SubPriority;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_InitStructure.NVIC_IRQChannel = I2CE_EV_IRQn;
+    NVIC_Init(&NVIC_InitStructure);
+    NVIC_InitStructure.NVIC_IRQChannel = I2CE_ER_IRQn;
+    NVIC_Init(&NVIC_InitStructure);
+
+    return SUCCESS;
+}
+
+//检查事务参数
+static ErrorStatus I2CE_Check(const I2CE_Trans *trans) {
+    if((trans->WLen != 0 && trans->WBuf == 0) || (trans->RLen != 0 && trans->RBuf == 0)) return ERROR;
+
+    if(trans->State == I2CE_QUEUED || trans->State == I2CE_ACTIVE) return ERROR;
+
+    return SUCCESS;
+}
+
+//挂入队尾, 调用时中断已关闭
+static void I2CE_Enqueue(I2CE_Trans *trans) {
+    trans->State = I2CE_QUEUED;
+    trans->Next = 0;
+
+    if(i2ce_tail) i2ce_tail->Next = trans;
+    else i2ce_head = trans;
+
+    i2ce_tail = trans;
+    i2ce_depth++;
+
+    if(i2ce_depth > i2ce_stats.QueueMax) i2ce_stats.QueueMax = i2ce_depth;
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	I2CE_Submit()
+* 功能说明:	提交事务, 总线空闲时立即开始
+* 输    入: I2CE_Trans *trans		事务, 在回调之前不能释放或改动
+* 输    出: ErrorStatus		缓冲区为空或事务已在队列中返回 ERROR
+* 注意事项: 可以在任务和中断(含回调)中调用
+******************************************************************************************************************************************/
+ErrorStatus I2CE_Submit(I2CE_Trans *trans) {
+    return I2CE_SubmitBatch(trans, 1);
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	I2CE_SubmitBatch()
+* 功能说明:	一次提交一组事务, 按数组顺序背靠背执行
+* 输    入: I2CE_Trans *trans		事务数组
+*			uint16_t num			事务个数
+* 输    出: ErrorStatus		任一事务参数错误时返回 ERROR, 此时一个都不提交
+* 注意事项: 例如轮询传感器阵列时每个传感器一个事务, 每个事务有自己的回调
+******************************************************************************************************************************************/
+ErrorStatus I2CE_SubmitBatch(I2CE_Trans *trans, uint16_t num) {
+    uint32_t primask;
+    uint16_t i;
+    uint8_t idle;
+
+    for(i = 0; i < num; i++) {
+        if(I2CE_Check(&trans[i]) != SUCCESS) return ERROR;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    idle = i2ce_head == 0;
+
+    for(i = 0; i < num; i++) I2CE_Enqueue(&trans[i]);
+
+    if(idle && i2ce_head) I2CE_Start();
+
+    __set_PRIMASK(primask);
+
+    return SUCCESS;
+}
+
+/******************************************************************************************************************************************
+* 函数名称:	I2CE_Poll()
+* 功能说明:	检查正在执行的事务是否超时, 超时则复位I2C、恢复总线并以 I2CE_TIMEOUT 结束
+* 输    入: 无
+* 输    出: 无
+* 注意事项: 在主循环或定时器中断中周期调用; 超时事务的回调在本函数中(中断关闭时)调用
+******************************************************************************************************************************************/
+void I2CE_Poll(void) {
+    uint32_t primask;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    if(i2ce_head && i2ce_head->State == I2CE_ACTIVE && DWT->CYCCNT - i2ce_start > i2ce_timeout)
+        I2CE_Abort(I2CE_TIMEOUT);
+
+    __set_PRIMASK(primask);
+}
+
+uint8_t I2CE_Idle(void) {
+    return i2ce_head == 0 ? 1 : 0;
+}
+
+void I2CE_GetStats(I2CE_Stats *stats) {
+    *stats = i2ce_stats;
+}
+
+void I2CE_EV_IRQHandler(void) {
+    uint16_t sr1 = I2CE_I2C->SR1;
+    I2CE_Trans *trans = i2ce_head;
+
+    if(trans == 0) {
+        I2C_ITConfig(I2CE_I2C, I2C_IT_EVT | I2C_IT_BUF, DISABLE);
+        return;
+    }
+
+    if(sr1 & I2C_SR1_SB) {
+        I2C_Send7bitAddress(I2CE_I2C, trans->Addr << 1,
+                            i2ce_phase == I2CE_PH_RADDR ? I2C_Direction_Receiver : I2C_Direction_Transmitter);
+        return;
+    }
+
+    if(sr1 & I2C_SR1_ADDR) {
+        if(i2ce_phase == I2CE_PH_WADDR) I2CE_WriteAddr(trans);
+        else I2CE_ReadAddr(trans);
+
+        return;
+    }
+
+    if(i2ce_phase == I2CE_PH_WDATA) {
+        if(i2ce_dma == 0 && (sr1 & I2C_SR1_TXE) && i2ce_idx < trans->WLen) {
+            I2C_SendData(I2CE_I2C, trans->WBuf[i2ce_idx++]);
+
+            if(i2ce_idx == trans->WLen) I2C_ITConfig(I2CE_I2C, I2C_IT_BUF, DISABLE);
+
+            return;
+        }
+
+        if(sr1 & I2C_SR1_BTF) I2CE_WriteDone(trans);
+
+        return;
+    }
+
+    //逐字节接收: 读出倒数第二个字节后关应答并发停止, 要求中断延迟小于一个字节时间
+    if(i2ce_phase == I2CE_PH_RDATA && i2ce_dma == 0 && (sr1 & I2C_SR1_RXNE)) {
+        trans->RBuf[i2ce_idx++] = I2C_ReceiveData(I2CE_I2C);
+
+        if(trans->RLen - i2ce_idx == 1) {
+            I2C_AcknowledgeConfig(I2CE_I2C, DISABLE);
+            I2C_GenerateSTOP(I2CE_I2C, ENABLE);
+        }
+
+        if(i2ce_idx == trans->RLen) I2CE_Finish(I2CE_OK);
+    }
+}
+
+void I2CE_ER_IRQHandler(void) {
+    uint16_t sr1 = I2CE_I2C->SR1;
+
+    //错误标志写0清除
+    I2CE_I2C->SR1 = (uint16_t)~(sr1 & (I2CE_SR1_ERR | I2C_SR1_AF));
+
+    if(i2ce_head == 0) return;
+
+    if(sr1 & I2CE_SR1_ERR) {
+        I2CE_Abort(I2CE_ERROR);
+    } else if(sr1 & I2C_SR1_AF) {
+        I2C_GenerateSTOP(I2CE_I2C, ENABLE);
+        I2CE_Finish(I2CE_NACK);
+    }
+}
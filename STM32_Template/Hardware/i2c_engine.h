@@ -0,0 +1,107 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : i2c_engine.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 非阻塞I2C主机: 先写后读事务排队, 地址阶段由事件中断推进, 数据阶段走DMA,
+  *				   超时后复位外设并恢复总线, 完成时回调
+  * Function List:
+  *		I2CE_Init
+  *		I2CE_Submit
+  *		I2CE_SubmitBatch
+  *		I2CE_Poll
+  *		I2CE_Idle
+  *		I2CE_GetStats
+  *		I2CE_EV_IRQHandler
+  *		I2CE_ER_IRQHandler
+  ******************************************************
+**/
+
+#ifndef __I2C_ENGINE_H_
+#define __I2C_ENGINE_H_
+
+#include "stm32f4xx_conf.h"
+#include "dma_mgr.h"
+
+//I2C1: PB6=SCL, PB7=SDA
+#define I2CE_I2C                    I2C1
+#define I2CE_RCC_I2C                RCC_APB1Periph_I2C1
+#define I2CE_GPIO_PORT              GPIOB
+#define I2CE_RCC_GPIO               RCC_AHB1Periph_GPIOB
+#define I2CE_SCL_PIN                GPIO_Pin_6
+#define I2CE_SDA_PIN                GPIO_Pin_7
+#define I2CE_SCL_PINSRC             GPIO_PinSource6
+#define I2CE_SDA_PINSRC             GPIO_PinSource7
+#define I2CE_GPIO_AF                GPIO_AF_I2C1
+#define I2CE_EV_IRQn                I2C1_EV_IRQn
+#define I2CE_ER_IRQn                I2C1_ER_IRQn
+#define I2CE_EV_IRQHandler          I2C1_EV_IRQHandler
+#define I2CE_ER_IRQHandler          I2C1_ER_IRQHandler
+
+//数据阶段的DMA请求, 数据流由 dma_mgr 分配
+#define I2CE_DMA_REQ_TX             DMA_REQ_I2C1_TX
+#define I2CE_DMA_REQ_RX             DMA_REQ_I2C1_RX
+
+#define I2CE_TIMEOUT_US             10000   //事务未指定超时时间时使用
+#define I2CE_DMA_MIN                2       //数据阶段不少于这么多字节才用DMA, 更短的在事件中断中逐字节收发
+
+//事务结果
+#define I2CE_OK                     0
+#define I2CE_NACK                   1       //地址或数据没有应答
+#define I2CE_ERROR                  2       //总线错误/仲裁丢失/溢出/DMA错误, 已恢复总线
+#define I2CE_TIMEOUT                3       //超时, 已恢复总线
+
+//事务状态
+#define I2CE_IDLE                   0
+#define I2CE_QUEUED                 1
+#define I2CE_ACTIVE                 2
+#define I2CE_DONE                   3
+
+typedef struct I2CE_Trans I2CE_Trans;
+
+//事务结束时在中断中调用(超时时在调用 I2CE_Poll 的上下文中), 回调中可以再次提交
+typedef void (*I2CE_Callback)(I2CE_Trans *trans);
+
+//先写 WLen 字节, 再重复起始读 RLen 字节; 只写、只读, 两者都为0时只检查地址应答
+struct I2CE_Trans {
+    uint8_t  Addr;                  //7位从机地址, 不含读写位
+    const uint8_t *WBuf;
+    uint16_t WLen;
+    uint8_t  *RBuf;
+    uint16_t RLen;
+    uint32_t Timeout;               //微秒, 0 使用 I2CE_TIMEOUT_US
+    I2CE_Callback Callback;
+    void *Arg;
+
+    //以下由引擎维护
+    volatile uint8_t State;
+    volatile uint8_t Result;        //I2CE_OK 等
+    I2CE_Trans *Next;
+};
+
+typedef struct {
+    uint32_t Done;                  //成功的事务数
+    uint32_t Nacks;
+    uint32_t Errors;
+    uint32_t Timeouts;
+    uint32_t Recoveries;            //总线恢复次数(含初始化时一次)
+    uint32_t Bytes;                 //成功的事务收发的数据字节数
+    uint32_t DMAPhases;             //走DMA的数据阶段数
+    uint32_t QueueMax;              //队列中(含正在执行的)同时存在的最大事务数
+} I2CE_Stats;
+
+ErrorStatus I2CE_Init(uint32_t ClockSpeed, uint8_t NVIC_PreemptionPriority, uint8_t NVIC_SubPriority); // 初始化I2C和引脚并恢复总线; 须先调用 DMA_Mgr_Init
+ErrorStatus I2CE_Submit(I2CE_Trans *trans); // 提交事务, 总线空闲时立即开始; 参数错误或已在队列中返回 ERROR
+ErrorStatus I2CE_SubmitBatch(I2CE_Trans *trans, uint16_t num); // 一次提交一组事务, 按数组顺序执行; 任一参数错误时都不提交
+void I2CE_Poll(void); // 检查超时, 在主循环或定时器中断中周期调用
+uint8_t I2CE_Idle(void); // 队列中没有事务返回1
+void I2CE_GetStats(I2CE_Stats *stats); // 读取统计
+
+#endif
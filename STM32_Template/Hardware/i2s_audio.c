@@ -0,0 +1,434 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : i2s_audio.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					I2S2主发送 + I2S2ext从接收组成全双工, 收发各用一个DMA数据流循环传输,
+					每半个缓冲区(一个周期)中断一次:
+					  发送: 从播放FIFO取数填入刚发完的半缓冲区
+					  接收: 把刚收满的半缓冲区推入录音FIFO
+					应用层通过 Audio_Write/Audio_Read 按自己的节奏(USB/网络时钟)读写FIFO.
+					两端时钟不同步时FIFO水位会漂移, 开启 RateTracking 后用PI控制器根据水位
+					微调线性插值重采样的步长, 使水位稳定在 TargetFill 附近.
+  * Function List:
+  *		Audio_StructInit
+  *		Audio_Init
+  *		Audio_Start
+  *		Audio_Stop
+  *		Audio_Write
+  *		Audio_Read
+  *		Audio_GetStats
+  *		AUDIO_TX_DMA_IRQHandler
+  *		AUDIO_RX_DMA_IRQHandler
+  **********************************************************
+ */
+
+#include "i2s_audio.h"
+
+#define AUDIO_STEP_ONE              65536   //Q16, 1:1
+#define AUDIO_TRACK_KP              35      //比例系数, Q8: 水位偏差48帧约对应100ppm
+#define AUDIO_TRACK_KI              1       //积分系数, Q8
+#define AUDIO_TRACK_INTEG_MAX       ((AUDIO_RATE_ADJ_MAX << 8) / AUDIO_TRACK_KI)
+
+//单生产者单消费者环形FIFO, wr/rd 为自由运行计数, 差值即水位
+typedef struct {
+    Audio_Frame *buf;
+    uint32_t mask;
+    volatile uint32_t wr;
+    volatile uint32_t rd;
+} Audio_Fifo;
+
+//线性插值重采样状态
+typedef struct {
+    uint32_t phase;                 //Q16 小数相位
+    uint32_t step;                  //Q16 步长, 大于1时消耗输入更快
+    int32_t  integ;                 //PI积分项
+    Audio_Frame prev;               //录音方向上一个输入帧
+} Audio_Rate;
+
+typedef struct {
+    uint16_t period;
+    uint16_t target;
+    uint8_t  tracking;
+    volatile uint8_t primed;        //播放FIFO水位达到目标后才开始取数
+    Audio_Callback callback;
+} Audio_Handle;
+
+static Audio_Handle audio;
+static Audio_Fifo play;
+static Audio_Fifo capture;
+static Audio_Rate play_rate;
+static Audio_Rate capture_rate;
+static Audio_Stats audio_stats;
+
+static Audio_Frame tx_dma[2 * AUDIO_PERIOD_MAX];
+static Audio_Frame rx_dma[2 * AUDIO_PERIOD_MAX];
+
+//两个立体声帧之间线性插值, frac 为Q16, 降为Q15相乘避免溢出
+static Audio_Frame Audio_Lerp(Audio_Frame a, Audio_Frame b, uint32_t frac) {
+    int32_t l0 = (int16_t)(a & 0xFFFF);
+    int32_t r0 = (int16_t)(a >> 16);
+    int32_t l1 = (int16_t)(b & 0xFFFF);
+    int32_t r1 = (int16_t)(b >> 16);
+    int32_t f = (int32_t)(frac >> 1);
+    int32_t l = l0 + (((l1 - l0) * f) >> 15);
+    int32_t r = r0 + (((r1 - r0) * f) >> 15);
+
+    return (uint16_t)l | ((uint32_t)(uint16_t)r << 16);
+}
+
+//根据FIFO水位调整重采样步长, 水位偏高则加快消耗(步长变大)
+static void Audio_Track(Audio_Rate *rs, uint32_t fill) {
+    int32_t err = (int32_t)fill - (int32_t)audio.target;
+    int32_t adj;
+
+    rs->integ += err;
+
+    if(rs->integ > AUDIO_TRACK_INTEG_MAX) rs->integ = AUDIO_TRACK_INTEG_MAX;
+
+    if(rs->integ < -AUDIO_TRACK_INTEG_MAX) rs->integ = -AUDIO_TRACK_INTEG_MAX;
+
+    adj = (err * AUDIO_TRACK_KP + rs->integ * AUDIO_TRACK_KI) >> 8;
+
+    if(adj > AUDIO_RATE_ADJ_MAX) adj = AUDIO_RATE_ADJ_MAX;
+
+    if(adj < -AUDIO_RATE_ADJ_MAX) adj = -AUDIO_RATE_ADJ_MAX;
+
+    rs->step = (uint32_t)(AUDIO_STEP_ONE + adj);
+}
+
+//从播放FIFO重采样出 n 帧, 数据不够时补静音并重新等待水位
+static void Audio_Pull(Audio_Frame *out, uint32_t n) {
+    uint32_t rd = play.rd;
+    uint32_t wr = play.wr;
+    uint32_t i = 0;
+
+    if(!audio.primed) {
+        if(wr - rd < audio.target) {
+            for(i = 0; i < n; i++) out[i] = 0;
+
+            return;
+        }
+
+        audio.primed = 1;
+    }
+
+    if(play_rate.step == AUDIO_STEP_ONE && play_rate.phase == 0) {
+        //不需要重采样, 直接拷贝
+        for(; i < n && rd != wr; i++) out[i] = play.buf[rd++ & play.mask];
+    } else {
+        for(; i < n && wr - rd >= 2; i++) {
+            out[i] = Audio_Lerp(play.buf[rd & play.mask], play.buf[(rd + 1) & play.mask], play_rate.phase);
+            play_rate.phase += play_rate.step;
+            rd += play_rate.phase >> 16;
+            play_rate.phase &= 0xFFFF;
+        }
+    }
+
+    __DMB();
+    play.rd = rd;
+
+    if(i < n) {
+        audio_stats.PlayUnderrun++;
+        audio.primed = 0;
+
+        for(; i < n; i++) out[i] = 0;
+    }
+}
+
+//把 n 帧录音数据重采样后推入录音FIFO, FIFO满则丢弃
+static void Audio_Push(const Audio_Frame *in, uint32_t n) {
+    uint32_t wr = capture.wr;
+    uint32_t rd = capture.rd;
+    uint32_t size = capture.mask + 1;
+    uint32_t i;
+
+    if(capture_rate.step == AUDIO_STEP_ONE && capture_rate.phase == 0) {
+        for(i = 0; i < n; i++) {
+            if(wr - rd >= size) {
+                audio_stats.CaptureOverrun += n - i;
+                break;
+            }
+
+            capture.buf[wr++ & capture.mask] = in[i];
+        }
+
+        if(n) capture_rate.prev = in[n - 1];
+    } else {
+        for(i = 0; i < n; i++) {
+            while(capture_rate.phase < AUDIO_STEP_ONE) {
+                if(wr - rd >= size) {
+                    audio_stats.CaptureOverrun++;
+                } else {
+                    capture.buf[wr++ & capture.mask] = Audio_Lerp(capture_rate.prev, in[i], capture_rate.phase);
+                }
+
+                capture_rate.phase += capture_rate.step;
+            }
+
+            capture_rate.phase -= AUDIO_STEP_ONE;
+            capture_rate.prev = in[i];
+        }
+    }
+
+    __DMB();
+    capture.wr = wr;
+}
+
+static void Audio_TxPeriod(uint8_t half) {
+    Audio_Frame *out = &tx_dma[half * audio.period];
+
+    if(audio.tracking && audio.primed) Audio_Track(&play_rate, play.wr - play.rd);
+
+    Audio_Pull(out, audio.period);
+    audio_stats.Periods++;
+
+    if(audio.callback) audio.callback(out, 0, audio.period);
+}
+
+static void Audio_RxPeriod(uint8_t half) {
+    const Audio_Frame *in = &rx_dma[half * audio.period];
+
+    if(audio.callback) audio.callback(0, in, audio.period);
+
+    if(audio.tracking) Audio_Track(&capture_rate, capture.wr - capture.rd);
+
+    Audio_Push(in, audio.period);
+}
+
+static void Audio_DMAConfig(DMA_Stream_TypeDef *stream, uint32_t channel, uint32_t periph,
+                            Audio_Frame *buf, uint32_t dir) {
+    DMA_InitTypeDef DMA_InitStructure;
+
+    DMA_DeInit(stream);
+
+    while(DMA_GetCmdStatus(stream) != DISABLE);
+
+    //I2S数据寄存器16位, 一帧两个半字
+    DMA_InitStructure.DMA_Channel = channel;
+    DMA_InitStructure.DMA_PeripheralBaseAddr = periph;
+    DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)buf;
+    DMA_InitStructure.DMA_DIR = dir;
+    DMA_InitStructure.DMA_BufferSize = 2 * 2 * audio.period;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+    DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Disable;
+    DMA_InitStructure.DMA_FIFOThreshold = DMA_FIFOThreshold_1QuarterFull;
+    DMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+    DMA_InitStructure.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+    DMA_Init(stream, &DMA_InitStructure);
+    DMA_ITConfig(stream, DMA_IT_HT | DMA_IT_TC | DMA_IT_TE, ENABLE);
+}
+
+//缺省: 48kHz, 每周期48帧(1ms), 目标水位96帧, 总延迟约4ms
+void Audio_StructInit(Audio_InitTypeDef *Audio_InitStruct) {
+    Audio_InitStruct->AudioFreq = I2S_AudioFreq_48k;
+    Audio_InitStruct->PeriodFrames = 48;
+    Audio_InitStruct->TargetFill = 96;
+    Audio_InitStruct->RateTracking = 1;
+    Audio_InitStruct->PlayFifo = 0;
+    Audio_InitStruct->CaptureFifo = 0;
+    Audio_InitStruct->FifoFrames = 0;
+    Audio_InitStruct->Callback = 0;
+    Audio_InitStruct->NVIC_PreemptionPriority = 1;
+    Audio_InitStruct->NVIC_SubPriority = 0;
+}
+
+//I2S时钟(PLLI2S)由系统时钟初始化配置, 这里只选择I2S分频
+ErrorStatus Audio_Init(Audio_InitTypeDef *Audio_InitStruct) {
+    GPIO_InitTypeDef GPIO_InitStructure;
+    I2S_InitTypeDef I2S_InitStructure;
+    NVIC_InitTypeDef NVIC_InitStructure;
+    uint32_t i;
+
+    if(Audio_InitStruct->PlayFifo == 0 || Audio_InitStruct->CaptureFifo == 0 ||
+            Audio_InitStruct->PeriodFrames == 0 || Audio_InitStruct->PeriodFrames > AUDIO_PERIOD_MAX ||
+            (Audio_InitStruct->FifoFrames & (Audio_InitStruct->FifoFrames - 1)) != 0 ||
+            Audio_InitStruct->FifoFrames <= (uint32_t)Audio_InitStruct->TargetFill + 2 * Audio_InitStruct->PeriodFrames) {
+        return ERROR;
+    }
+
+    audio.period = Audio_InitStruct->PeriodFrames;
+    audio.target = Audio_InitStruct->TargetFill;
+    audio.tracking = Audio_InitStruct->RateTracking;
+    audio.callback = Audio_InitStruct->Callback;
+    audio.primed = 0;
+
+    play.buf = Audio_InitStruct->PlayFifo;
+    play.mask = Audio_InitStruct->FifoFrames - 1;
+    play.wr = 0;
+    play.rd = 0;
+    capture.buf = Audio_InitStruct->CaptureFifo;
+    capture.mask = Audio_InitStruct->FifoFrames - 1;
+    capture.wr = 0;
+    capture.rd = 0;
+
+    play_rate.phase = 0;
+    play_rate.step = AUDIO_STEP_ONE;
+    play_rate.integ = 0;
+    play_rate.prev = 0;
+    capture_rate = play_rate;
+
+    for(i = 0; i < 2 * AUDIO_PERIOD_MAX; i++) tx_dma[i] = 0;
+
+    RCC_AHB1PeriphClockCmd(AUDIO_RCC_GPIO | RCC_AHB1Periph_DMA1, ENABLE);
+    RCC_APB1PeriphClockCmd(RCC_APB1Periph_SPI2, ENABLE);
+
+    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF;
+    GPIO_InitStructure.GPIO_OType = GPIO_OType_PP;
+    GPIO_InitStructure.GPIO_PuPd = GPIO_PuPd_NOPULL;
+    GPIO_InitStructure.GPIO_Speed = GPIO_High_Speed;
+    GPIO_InitStructure.GPIO_Pin = AUDIO_WS_PIN | AUDIO_CK_PIN | AUDIO_EXTSD_PIN | AUDIO_SD_PIN;
+    GPIO_Init(AUDIO_GPIO_PORT, &GPIO_InitStructure);
+    GPIO_InitStructure.GPIO_Pin = AUDIO_MCK_PIN;
+    GPIO_Init(AUDIO_MCK_PORT, &GPIO_InitStructure);
+
+    GPIO_PinAFConfig(AUDIO_GPIO_PORT, GPIO_PinSource12, GPIO_AF_SPI2);
+    GPIO_PinAFConfig(AUDIO_GPIO_PORT, GPIO_PinSource13, GPIO_AF_SPI2);
+    GPIO_PinAFConfig(AUDIO_GPIO_PORT, GPIO_PinSource14, GPIO_AF_I2S2ext);
+    GPIO_PinAFConfig(AUDIO_GPIO_PORT, GPIO_PinSource15, GPIO_AF_SPI2);
+    GPIO_PinAFConfig(AUDIO_MCK_PORT, GPIO_PinSource6, GPIO_AF_SPI2);
+
+    SPI_I2S_DeInit(SPI2);
+    I2S_InitStructure.I2S_Mode = I2S_Mode_MasterTx;
+    I2S_InitStructure.I2S_Standard = I2S_Standard_Phillips;
+    I2S_InitStructure.I2S_DataFormat = I2S_DataFormat_16b;
+    I2S_InitStructure.I2S_MCLKOutput = I2S_MCLKOutput_Enable;
+    I2S_InitStructure.I2S_AudioFreq = Audio_InitStruct->AudioFreq;
+    I2S_InitStructure.I2S_CPOL = I2S_CPOL_Low;
+    I2S_Init(SPI2, &I2S_InitStructure);
+    //ext自动配置为与主机方向相反的从接收
+    I2S_FullDuplexConfig(I2S2ext, &I2S_InitStructure);
+
+    Audio_DMAConfig(AUDIO_TX_DMA_STREAM, AUDIO_TX_DMA_CHANNEL, (uint32_t)&SPI2->DR, tx_dma,
+                    DMA_DIR_MemoryToPeripheral);
+    Audio_DMAConfig(AUDIO_RX_DMA_STREAM, AUDIO_RX_DMA_CHANNEL, (uint32_t)&I2S2ext->DR, rx_dma,
+                    DMA_DIR_PeripheralToMemory);
+
+    SPI_I2S_DMACmd(SPI2, SPI_I2S_DMAReq_Tx, ENABLE);
+    SPI_I2S_DMACmd(I2S2ext, SPI_I2S_DMAReq_Rx, ENABLE);
+
+    NVIC_InitStructure.NVIC_IRQChannel = AUDIO_TX_DMA_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = Audio_InitStruct->NVIC_PreemptionPriority;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = Audio_InitStruct->NVIC_SubPriority;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+    NVIC_InitStructure.NVIC_IRQChannel = AUDIO_RX_DMA_IRQn;
+    NVIC_Init(&NVIC_InitStructure);
+
+    audio_stats.Periods = 0;
+    audio_stats.PlayUnderrun = 0;
+    audio_stats.PlayOverrun = 0;
+    audio_stats.CaptureOverrun = 0;
+    audio_stats.CaptureUnderrun = 0;
+    audio_stats.DmaError = 0;
+
+    return SUCCESS;
+}
+
+//先开DMA和从接收, 最后开主发送, 收发从同一个WS沿开始
+void Audio_Start(void) {
+    DMA_Cmd(AUDIO_TX_DMA_STREAM, ENABLE);
+    DMA_Cmd(AUDIO_RX_DMA_STREAM, ENABLE);
+    I2S_Cmd(I2S2ext, ENABLE);
+    I2S_Cmd(SPI2, ENABLE);
+}
+
+void Audio_Stop(void) {
+    I2S_Cmd(SPI2, DISABLE);
+    I2S_Cmd(I2S2ext, DISABLE);
+    DMA_Cmd(AUDIO_TX_DMA_STREAM, DISABLE);
+    DMA_Cmd(AUDIO_RX_DMA_STREAM, DISABLE);
+}
+
+//写入播放数据, FIFO剩余空间不足时只写入能放下的部分, 其余计入 PlayOverrun
+uint32_t Audio_Write(const Audio_Frame *frames, uint32_t n) {
+    uint32_t wr = play.wr;
+    uint32_t space = (play.mask + 1) - (wr - play.rd);
+    uint32_t i;
+
+    if(n > space) {
+        audio_stats.PlayOverrun += n - space;
+        n = space;
+    }
+
+    for(i = 0; i < n; i++) play.buf[(wr + i) & play.mask] = frames[i];
+
+    __DMB();
+    play.wr = wr + n;
+
+    return n;
+}
+
+//读出录音数据, 数据不足时只读出已有部分并计入 CaptureUnderrun
+uint32_t Audio_Read(Audio_Frame *frames, uint32_t n) {
+    uint32_t rd = capture.rd;
+    uint32_t avail = capture.wr - rd;
+    uint32_t i;
+
+    if(n > avail) {
+        audio_stats.CaptureUnderrun++;
+        n = avail;
+    }
+
+    for(i = 0; i < n; i++) frames[i] = capture.buf[(rd + i) & capture.mask];
+
+    __DMB();
+    capture.rd = rd + n;
+
+    return n;
+}
+
+void Audio_GetStats(Audio_Stats *stats) {
+    *stats = audio_stats;
+    stats->PlayRatePpm = ((int32_t)play_rate.step - AUDIO_STEP_ONE) * 1000000 / AUDIO_STEP_ONE;
+    stats->CaptureRatePpm = ((int32_t)capture_rate.step - AUDIO_STEP_ONE) * 1000000 / AUDIO_STEP_ONE;
+}
+
+void AUDIO_TX_DMA_IRQHandler(void) {
+    if(DMA_GetITStatus(AUDIO_TX_DMA_STREAM, AUDIO_TX_DMA_IT_TE) != RESET) {
+        DMA_ClearITPendingBit(AUDIO_TX_DMA_STREAM, AUDIO_TX_DMA_IT_TE);
+        audio_stats.DmaError++;
+    }
+
+    if(DMA_GetITStatus(AUDIO_TX_DMA_STREAM, AUDIO_TX_DMA_IT_HT) != RESET) {
+        DMA_ClearITPendingBit(AUDIO_TX_DMA_STREAM, AUDIO_TX_DMA_IT_HT);
+        Audio_TxPeriod(0);
+    }
+
+    if(DMA_GetITStatus(AUDIO_TX_DMA_STREAM, AUDIO_TX_DMA_IT_TC) != RESET) {
+        DMA_ClearITPendingBit(AUDIO_TX_DMA_STREAM, AUDIO_TX_DMA_IT_TC);
+        Audio_TxPeriod(1);
+    }
+}
+
+void AUDIO_RX_DMA_IRQHandler(void) {
+    if(DMA_GetITStatus(AUDIO_RX_DMA_STREAM, AUDIO_RX_DMA_IT_TE) != RESET) {
+        DMA_ClearITPendingBit(AUDIO_RX_DMA_STREAM, AUDIO_RX_DMA_IT_TE);
+        audio_stats.DmaError++;
+    }
+
+    if(DMA_GetITStatus(AUDIO_RX_DMA_STREAM, AUDIO_RX_DMA_IT_HT) != RESET) {
+        DMA_ClearITPendingBit(AUDIO_RX_DMA_STREAM, AUDIO_RX_DMA_IT_HT);
+        Audio_RxPeriod(0);
+    }
+
+    if(DMA_GetITStatus(AUDIO_RX_DMA_STREAM, AUDIO_RX_DMA_IT_TC) != RESET) {
+        DMA_ClearITPendingBit(AUDIO_RX_DMA_STREAM, AUDIO_RX_DMA_IT_TC);
+        Audio_RxPeriod(1);
+    }
+}
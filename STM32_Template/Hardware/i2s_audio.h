@@ -0,0 +1,98 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : i2s_audio.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : I2S2全双工(I2S2 + I2S2ext)音频流, DMA循环缓冲 + 异步采样率跟踪
+  * Function List:
+  *		Audio_StructInit
+  *		Audio_Init
+  *		Audio_Start
+  *		Audio_Stop
+  *		Audio_Write
+  *		Audio_Read
+  *		Audio_GetStats
+  ******************************************************
+**/
+
+#ifndef __I2S_AUDIO_H_
+#define __I2S_AUDIO_H_
+
+#include "stm32f4xx_conf.h"
+
+//I2S2: PB12=WS, PB13=CK, PB15=SD(发送), PB14=ext_SD(接收), PC6=MCK
+#define AUDIO_GPIO_PORT             GPIOB
+#define AUDIO_WS_PIN                GPIO_Pin_12
+#define AUDIO_CK_PIN                GPIO_Pin_13
+#define AUDIO_EXTSD_PIN             GPIO_Pin_14
+#define AUDIO_SD_PIN                GPIO_Pin_15
+#define AUDIO_MCK_PORT              GPIOC
+#define AUDIO_MCK_PIN               GPIO_Pin_6
+#define AUDIO_RCC_GPIO              (RCC_AHB1Periph_GPIOB | RCC_AHB1Periph_GPIOC)
+
+//SPI2_TX: DMA1_Stream4通道0, I2S2_EXT_RX: DMA1_Stream3通道3
+#define AUDIO_TX_DMA_STREAM         DMA1_Stream4
+#define AUDIO_TX_DMA_CHANNEL        DMA_Channel_0
+#define AUDIO_TX_DMA_IRQn           DMA1_Stream4_IRQn
+#define AUDIO_TX_DMA_IRQHandler     DMA1_Stream4_IRQHandler
+#define AUDIO_TX_DMA_IT_HT          DMA_IT_HTIF4
+#define AUDIO_TX_DMA_IT_TC          DMA_IT_TCIF4
+#define AUDIO_TX_DMA_IT_TE          DMA_IT_TEIF4
+#define AUDIO_RX_DMA_STREAM         DMA1_Stream3
+#define AUDIO_RX_DMA_CHANNEL        DMA_Channel_3
+#define AUDIO_RX_DMA_IRQn           DMA1_Stream3_IRQn
+#define AUDIO_RX_DMA_IRQHandler     DMA1_Stream3_IRQHandler
+#define AUDIO_RX_DMA_IT_HT          DMA_IT_HTIF3
+#define AUDIO_RX_DMA_IT_TC          DMA_IT_TCIF3
+#define AUDIO_RX_DMA_IT_TE          DMA_IT_TEIF3
+
+#define AUDIO_PERIOD_MAX            512     //DMA半缓冲区最大帧数
+#define AUDIO_RATE_ADJ_MAX          66      //最大频偏, Q16单位, 66/65536 约 1000ppm
+
+//音频帧: 16位立体声, 低半字为左声道, 高半字为右声道
+typedef uint32_t Audio_Frame;
+
+//DMA半缓冲区回调, 在DMA中断中执行, 可为空
+//tx: 刚填好即将发送的数据; rx: 刚收到的数据; frames: 帧数
+typedef void (*Audio_Callback)(Audio_Frame *tx, const Audio_Frame *rx, uint32_t frames);
+
+typedef struct {
+    uint32_t AudioFreq;             //I2S_AudioFreq_xxk
+    uint16_t PeriodFrames;          //DMA半缓冲区帧数, 决定中断间隔和最小延迟
+    uint16_t TargetFill;            //软件FIFO目标水位(帧), 延迟 = 2*PeriodFrames + TargetFill
+    uint8_t  RateTracking;          //1: 按FIFO水位自动跟踪外部时钟并重采样
+    Audio_Frame *PlayFifo;          //播放FIFO, FifoFrames 项
+    Audio_Frame *CaptureFifo;       //录音FIFO, FifoFrames 项
+    uint32_t FifoFrames;            //两个FIFO的容量, 2的幂, 需大于 TargetFill + 2*PeriodFrames
+    Audio_Callback Callback;
+    uint8_t  NVIC_PreemptionPriority;
+    uint8_t  NVIC_SubPriority;
+} Audio_InitTypeDef;
+
+typedef struct {
+    uint32_t Periods;               //DMA半缓冲区计数
+    uint32_t PlayUnderrun;          //播放FIFO不够, 补静音的次数
+    uint32_t PlayOverrun;           //Audio_Write 因FIFO满丢弃的帧数
+    uint32_t CaptureOverrun;        //录音FIFO满丢弃的帧数
+    uint32_t CaptureUnderrun;       //Audio_Read 读不够的次数
+    uint32_t DmaError;
+    int32_t  PlayRatePpm;           //播放侧当前重采样频偏
+    int32_t  CaptureRatePpm;        //录音侧当前重采样频偏
+} Audio_Stats;
+
+void Audio_StructInit(Audio_InitTypeDef *Audio_InitStruct); // 缺省48kHz, 每周期48帧(1ms), 目标水位96帧
+ErrorStatus Audio_Init(Audio_InitTypeDef *Audio_InitStruct); // 配置GPIO/I2S2/I2S2ext/DMA
+void Audio_Start(void); // 启动全双工传输
+void Audio_Stop(void); // 停止传输
+uint32_t Audio_Write(const Audio_Frame *frames, uint32_t n); // 写入播放数据, 返回实际写入帧数
+uint32_t Audio_Read(Audio_Frame *frames, uint32_t n); // 读出录音数据, 返回实际读出帧数
+void Audio_GetStats(Audio_Stats *stats); // 读取统计计数
+
+#endif
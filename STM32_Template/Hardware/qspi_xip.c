@@ -0,0 +1,344 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : qspi_xip.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					XIP的速度主要取决于每次取指要等多少个QSPI时钟:
+					  命令(8) + 地址 + 模式字节 + 虚拟周期 + 数据
+					1-4-4 读把地址也放到4线上; 连续读(模式字节0x20 + SIOO)之后
+					省掉8个时钟的命令; 双沿(DTR)让地址和数据再快一倍; 预取超时让
+					顺序取指不必每次重新发地址. 虚拟周期多一个少一个读出的数据都
+					会错位, 所以用单线0x0B读一段数据作参考, 逐个试出能读对的虚拟
+					周期和采样移位, 不依赖具体Flash型号的手册值.
+					另一半是找出哪些函数值得搬到内部RAM: 用DWT周期计数器统计登记
+					过的函数, 按累计耗时排序, 对位于QSPI中的前几名给出分散加载文件
+					的写法. 快照功能用于比较修改配置(或重新链接)前后的耗时.
+  * Function List:
+  *		XIP_StructInit
+  *		XIP_Init
+  *		XIP_Calibrate
+  *		XIP_Measure
+  *		XIP_Prof_Init
+  *		XIP_Prof_Add
+  *		XIP_Prof_Record
+  *		XIP_Prof_Snapshot
+  *		XIP_Prof_Report
+  **********************************************************
+ */
+
+#include "qspi_xip.h"
+#include <stdio.h>
+
+#if defined(STM32F412xG) || defined(STM32F413_423xx) || defined(STM32F446xx) || defined(STM32F469_479xx)
+
+#define XIP_SIZE                    ((uint32_t)0x10000000)
+#define XIP_CAL_MAX                 256     //校准时比较的最大字节数
+#define XIP_REF_PRESCALER           3       //参考读法至少4分频, 单线0x0B在此频率下都能可靠读出
+#define XIP_HOT_PERCENT             90      //建议放入RAM的函数覆盖QSPI中耗时的百分比
+
+static XIP_InitTypeDef xip;
+static XIP_Prof_Entry prof[XIP_PROF_MAX];
+static uint8_t prof_count;
+
+static void XIP_WaitIdle(void) {
+    while(QUADSPI->SR & QUADSPI_SR_BUSY);
+}
+
+//退出存储器映射模式, 之后才能改 CCR/LPTR
+static void XIP_Abort(void) {
+    QSPI_AbortRequest();
+
+    while(QUADSPI->CR & QUADSPI_CR_ABORT);
+
+    XIP_WaitIdle();
+}
+
+//单线发送0xFF: Flash若处于连续读状态, 模式位被清除, 重新等待命令
+static void XIP_ModeReset(void) {
+    QSPI_ComConfig_InitTypeDef com;
+
+    XIP_Abort();
+    QSPI_ComConfig_StructInit(&com);
+    com.QSPI_ComConfig_FMode = QSPI_ComConfig_FMode_Indirect_Write;
+    com.QSPI_ComConfig_IMode = QSPI_ComConfig_IMode_1Line;
+    com.QSPI_ComConfig_Ins = 0xFF;
+    QSPI_ClearFlag(QSPI_FLAG_TC);
+    QSPI_ComConfig_Init(&com);
+
+    while(QSPI_GetFlagStatus(QSPI_FLAG_TC) == RESET);
+
+    QSPI_ClearFlag(QSPI_FLAG_TC);
+    XIP_WaitIdle();
+}
+
+//按给定读法进入存储器映射模式
+static void XIP_Map(uint8_t mode, uint8_t dummy, uint8_t modeByte, uint8_t shift, uint8_t prescaler) {
+    QSPI_ComConfig_InitTypeDef com;
+    uint32_t cr;
+
+    XIP_Abort();
+
+    cr = QUADSPI->CR & ~(QUADSPI_CR_PRESCALER | QUADSPI_CR_SSHIFT | QUADSPI_CR_TCEN);
+    cr |= (uint32_t)prescaler << 24;
+
+    if(shift) cr |= QSPI_SShift_HalfCycleShift;
+
+    if(xip.Timeout && mode == xip.ReadMode) cr |= QUADSPI_CR_TCEN;
+
+    QUADSPI->CR = cr;
+    QSPI_MemoryMappedMode_SetTimeout(xip.Timeout);
+
+    QSPI_ComConfig_StructInit(&com);
+    com.QSPI_ComConfig_FMode = QSPI_ComConfig_FMode_Memory_Mapped;
+    com.QSPI_ComConfig_IMode = QSPI_ComConfig_IMode_1Line;
+    com.QSPI_ComConfig_ADSize = xip.FlashSize > 23 ? QSPI_ComConfig_ADSize_32bit : QSPI_ComConfig_ADSize_24bit;
+    com.QSPI_ComConfig_DummyCycles = dummy;
+
+    switch(mode) {
+        case XIP_READ_SINGLE:
+            com.QSPI_ComConfig_Ins = 0x0B;
+            com.QSPI_ComConfig_ADMode = QSPI_ComConfig_ADMode_1Line;
+            com.QSPI_ComConfig_DMode = QSPI_ComConfig_DMode_1Line;
+            break;
+
+        case XIP_READ_QUAD_OUT:
+            com.QSPI_ComConfig_Ins = 0x6B;
+            com.QSPI_ComConfig_ADMode = QSPI_ComConfig_ADMode_1Line;
+            com.QSPI_ComConfig_DMode = QSPI_ComConfig_DMode_4Line;
+            break;
+
+        default:
+            com.QSPI_ComConfig_Ins = mode == XIP_READ_QUAD_IO_DTR ? 0xED : 0xEB;
+            com.QSPI_ComConfig_ADMode = QSPI_ComConfig_ADMode_4Line;
+            com.QSPI_ComConfig_DMode = QSPI_ComConfig_DMode_4Line;
+            com.QSPI_ComConfig_ABMode = QSPI_ComConfig_ABMode_4Line;
+            com.QSPI_ComConfig_ABSize = QSPI_ComConfig_ABSize_8bit;
+
+            //模式字节使Flash进入连续读时, 以后的访问只发地址
+            if(modeByte != 0xFF) com.QSPI_ComConfig_SIOOMode = QSPI_ComConfig_SIOOMode_Enable;
+
+            if(mode == XIP_READ_QUAD_IO_DTR) {
+                com.QSPI_ComConfig_DDRMode = QSPI_ComConfig_DDRMode_Enable;
+                com.QSPI_ComConfig_DHHC = QSPI_ComConfig_DHHC_Enable;
+            }
+
+            QSPI_SetAlternateByte(modeByte);
+            break;
+    }
+
+    QSPI_ComConfig_Init(&com);
+}
+
+static void XIP_Read(uint32_t offset, uint8_t *buf, uint32_t size) {
+    const volatile uint8_t *src = (const volatile uint8_t *)(XIP_BASE + offset);
+    uint32_t i;
+
+    for(i = 0; i < size; i++) buf[i] = src[i];
+}
+
+static void XIP_DWT_Enable(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+void XIP_StructInit(XIP_InitTypeDef *XIP_InitStruct) {
+    XIP_InitStruct->Prescaler = 1;
+    XIP_InitStruct->FlashSize = 23;
+    XIP_InitStruct->ReadMode = XIP_READ_QUAD_IO;
+    XIP_InitStruct->DummyCycles = XIP_DUMMY_AUTO;
+    XIP_InitStruct->ModeByte = 0x20;
+    XIP_InitStruct->SampleShift = 1;
+    XIP_InitStruct->Timeout = 64;
+}
+
+ErrorStatus XIP_Init(XIP_InitTypeDef *XIP_InitStruct) {
+    QSPI_InitTypeDef QSPI_InitStruct;
+
+    if(XIP_InitStruct->ReadMode > XIP_READ_QUAD_IO_DTR || XIP_InitStruct->FlashSize > 31 ||
+            (XIP_InitStruct->DummyCycles != XIP_DUMMY_AUTO && XIP_InitStruct->DummyCycles > 31)) return ERROR;
+
+    xip = *XIP_InitStruct;
+
+    RCC_AHB3PeriphClockCmd(RCC_AHB3Periph_QSPI, ENABLE);
+
+    QSPI_Cmd(DISABLE);
+    QSPI_StructInit(&QSPI_InitStruct);
+    QSPI_InitStruct.QSPI_Prescaler = xip.Prescaler;
+    QSPI_InitStruct.QSPI_SShift = xip.SampleShift ? QSPI_SShift_HalfCycleShift : QSPI_SShift_NoShift;
+    QSPI_InitStruct.QSPI_CKMode = QSPI_CKMode_Mode0;
+    QSPI_InitStruct.QSPI_CSHTime = QSPI_CSHTime_2Cycle;
+    QSPI_InitStruct.QSPI_FSize = xip.FlashSize;
+    QSPI_InitStruct.QSPI_FSelect = QSPI_FSelect_1;
+    QSPI_InitStruct.QSPI_DFlash = QSPI_DFlash_Disable;
+    QSPI_Init(&QSPI_InitStruct);
+    QSPI_Cmd(ENABLE);
+
+    //上次复位前可能停在连续读状态
+    XIP_ModeReset();
+
+    if(xip.DummyCycles == XIP_DUMMY_AUTO) return XIP_Calibrate(0, XIP_CAL_MAX);
+
+    XIP_Map(xip.ReadMode, xip.DummyCycles, xip.ModeByte, xip.SampleShift, xip.Prescaler);
+
+    return SUCCESS;
+}
+
+ErrorStatus XIP_Calibrate(uint32_t offset, uint32_t size) {
+    uint8_t ref[XIP_CAL_MAX], buf[XIP_CAL_MAX];
+    uint8_t presc, shift, dummy, pass;
+    uint32_t i;
+
+    if(size == 0 || size > XIP_CAL_MAX) size = XIP_CAL_MAX;
+
+    XIP_ModeReset();
+
+    presc = xip.Prescaler < XIP_REF_PRESCALER ? XIP_REF_PRESCALER : xip.Prescaler;
+    XIP_Map(XIP_READ_SINGLE, 8, 0xFF, 0, presc);
+    XIP_Read(offset, ref, size);
+
+    //全是同一个值(如擦除后的0xFF)时任何虚拟周期都"读对", 没法校准
+    for(i = 1; i < size && ref[i] == ref[0]; i++);
+
+    if(i == size) return ERROR;
+
+    //先试给定的采样移位; 两种都试不出说明时钟太快或QE没置位
+    for(pass = 0; pass < 2; pass++) {
+        shift = pass ? !xip.SampleShift : xip.SampleShift;
+
+        for(dummy = 0; dummy < 32; dummy++) {
+            XIP_Map(xip.ReadMode, dummy, 0xFF, shift, xip.Prescaler);
+            XIP_Read(offset, buf, size);
+
+            for(i = 0; i < size && buf[i] == ref[i]; i++);
+
+            if(i == size) {
+                xip.DummyCycles = dummy;
+                xip.SampleShift = shift;
+                XIP_Map(xip.ReadMode, dummy, xip.ModeByte, shift, xip.Prescaler);
+                return SUCCESS;
+            }
+        }
+    }
+
+    //回到参考读法, 至少保证QSPI中的常量还能读
+    XIP_Map(XIP_READ_SINGLE, 8, 0xFF, 0, presc);
+
+    return ERROR;
+}
+
+uint32_t XIP_Measure(uint32_t offset, uint32_t size) {
+    const volatile uint32_t *src = (const volatile uint32_t *)(XIP_BASE + (offset & ~3U));
+    uint32_t start, i;
+
+    XIP_DWT_Enable();
+    start = DWT->CYCCNT;
+
+    for(i = 0; i < size / 4; i++) (void)src[i];
+
+    return DWT->CYCCNT - start;
+}
+
+void XIP_Prof_Init(void) {
+    XIP_DWT_Enable();
+    prof_count = 0;
+}
+
+uint8_t XIP_Prof_Add(const char *name, const void *fn) {
+    XIP_Prof_Entry *e;
+
+    if(prof_count >= XIP_PROF_MAX) return 0xFF;
+
+    e = &prof[prof_count];
+    e->Name = name;
+    e->Addr = (uint32_t)fn & ~1U;
+    e->Calls = 0;
+    e->Cycles = 0;
+    e->Max = 0;
+    e->Base = 0;
+
+    return prof_count++;
+}
+
+void XIP_Prof_Record(uint8_t id, uint32_t cycles) {
+    XIP_Prof_Entry *e;
+
+    if(id >= prof_count) return;
+
+    e = &prof[id];
+    e->Calls++;
+    e->Cycles += cycles;
+
+    if(cycles > e->Max) e->Max = cycles;
+}
+
+void XIP_Prof_Snapshot(void) {
+    uint8_t i;
+
+    for(i = 0; i < prof_count; i++) {
+        prof[i].Base = prof[i].Calls ? prof[i].Cycles / prof[i].Calls : 0;
+        prof[i].Calls = 0;
+        prof[i].Cycles = 0;
+        prof[i].Max = 0;
+    }
+}
+
+void XIP_Prof_Report(void) {
+    uint8_t order[XIP_PROF_MAX];
+    uint32_t total = 0, sum = 0, avg;
+    uint8_t i, j, t;
+    XIP_Prof_Entry *e;
+
+    for(i = 0; i < prof_count; i++) order[i] = i;
+
+    for(i = 1; i < prof_count; i++) {
+        t = order[i];
+
+        for(j = i; j > 0 && prof[order[j - 1]].Cycles < prof[t].Cycles; j--) order[j] = order[j - 1];
+
+        order[j] = t;
+    }
+
+    printf("XIP %s, dummy %u, shift %u, prescaler %u\r\n", xip.ReadMode == XIP_READ_QUAD_IO_DTR ? "1-4-4 DTR" :
+           xip.ReadMode == XIP_READ_QUAD_IO ? "1-4-4" : xip.ReadMode == XIP_READ_QUAD_OUT ? "1-1-4" : "1-1-1",
+           xip.DummyCycles, xip.SampleShift, xip.Prescaler);
+    printf("%-20s %-10s %8s %10s %8s %8s %8s\r\n", "function", "addr", "calls", "cycles", "avg", "base", "x100");
+
+    for(i = 0; i < prof_count; i++) {
+        e = &prof[order[i]];
+        avg = e->Calls ? e->Cycles / e->Calls : 0;
+        printf("%-20s 0x%08X %8u %10u %8u %8u %8u\r\n", e->Name, e->Addr, e->Calls, e->Cycles, avg, e->Base,
+               avg && e->Base ? e->Base * 100 / avg : 0);
+
+        if(e->Addr - XIP_BASE < XIP_SIZE) total += e->Cycles;
+    }
+
+    if(total == 0) return;
+
+    //按累计耗时从高到低, 取覆盖QSPI中大部分耗时的几个函数
+    printf("move to RAM (scatter file, RAM execution region):\r\n");
+
+    for(i = 0; i < prof_count && (uint64_t)sum * 100 < (uint64_t)total * XIP_HOT_PERCENT; i++) {
+        e = &prof[order[i]];
+
+        if(e->Addr - XIP_BASE >= XIP_SIZE || e->Cycles == 0) continue;
+
+        sum += e->Cycles;
+#if defined(__ARMCC_VERSION) && (__ARMCC_VERSION >= 6010050)
+        printf("    *.o (.text.%s)\r\n", e->Name);
+#else
+        printf("    *.o (i.%s)\r\n", e->Name);
+#endif
+    }
+}
+
+#endif /* STM32F412xG || STM32F413_423xx || STM32F446xx || STM32F469_479xx */
@@ -0,0 +1,92 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : qspi_xip.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : QSPI存储器映射(XIP)配置, 虚拟周期自动校准, 以及基于DWT的函数耗时统计,
+  *				   用统计结果决定哪些函数放到内部RAM执行
+  * Function List:
+  *		XIP_StructInit
+  *		XIP_Init
+  *		XIP_Calibrate
+  *		XIP_Measure
+  *		XIP_Prof_Init
+  *		XIP_Prof_Add
+  *		XIP_Prof_Record
+  *		XIP_Prof_Snapshot
+  *		XIP_Prof_Report
+  ******************************************************
+**/
+
+#ifndef __QSPI_XIP_H_
+#define __QSPI_XIP_H_
+
+#include "stm32f4xx_conf.h"
+
+#if defined(STM32F412xG) || defined(STM32F413_423xx) || defined(STM32F446xx) || defined(STM32F469_479xx)
+
+#define XIP_BASE                    ((uint32_t)0x90000000)
+
+//读命令, 都按W25Q/GD25Q系列的指令码
+#define XIP_READ_SINGLE             0   //0x0B, 1-1-1, 8个虚拟周期, 也是校准时的参考读法
+#define XIP_READ_QUAD_OUT           1   //0x6B, 1-1-4
+#define XIP_READ_QUAD_IO            2   //0xEB, 1-4-4, 地址后带模式字节
+#define XIP_READ_QUAD_IO_DTR        3   //0xED, 1-4-4 双沿, 地址后带模式字节
+
+#define XIP_DUMMY_AUTO              0xFF //由 XIP_Calibrate 确定虚拟周期数
+
+//函数放到内部RAM执行: 函数前加 XIP_RAMFUNC, 并在分散加载文件的RAM执行区加 *(.ramfunc),
+//启动时 __main 会把它从Flash复制到RAM
+#define XIP_RAMFUNC                 __attribute__((section(".ramfunc")))
+
+#define XIP_PROF_MAX                32
+
+typedef struct {
+    uint8_t  Prescaler;             //QSPI时钟 = HCLK / (Prescaler + 1)
+    uint8_t  FlashSize;             //Flash容量 = 2^(FlashSize + 1) 字节, W25Q128为23
+    uint8_t  ReadMode;              //XIP_READ_xxx
+    uint8_t  DummyCycles;           //读命令的虚拟周期数, XIP_DUMMY_AUTO 由校准确定
+    uint8_t  ModeByte;              //QUAD_IO时地址后的模式字节; 0x20(W25Q)使Flash进入连续读, 之后只发地址不发命令; 0xFF 不用连续读
+    uint8_t  SampleShift;           //1: 晚半个周期采样, 高频时常需要; 由校准确定时作为初值
+    uint16_t Timeout;               //预取超时, 单位QSPI时钟: 读完一次后保持片选并继续预取多久; 0 读完立即释放
+} XIP_InitTypeDef;
+
+typedef struct {
+    const char *Name;
+    uint32_t Addr;                  //函数地址, 用于判断是否在QSPI中执行
+    uint32_t Calls;
+    uint32_t Cycles;                //累计CPU周期
+    uint32_t Max;                   //单次最长
+    uint32_t Base;                  //快照时的平均周期, 0 表示没有快照
+} XIP_Prof_Entry;
+
+void XIP_StructInit(XIP_InitTypeDef *XIP_InitStruct); // 填充缺省值: 1-4-4读, 自动虚拟周期, 连续读
+ErrorStatus XIP_Init(XIP_InitTypeDef *XIP_InitStruct); // 配置QSPI并进入存储器映射; Flash的QE位须已置位, GPIO由调用者配置
+ErrorStatus XIP_Calibrate(uint32_t offset, uint32_t size); // 以单线读为参考, 找出读对数据的虚拟周期/采样移位; 本函数不能在QSPI中执行
+uint32_t XIP_Measure(uint32_t offset, uint32_t size); // 读 size 字节所用的CPU周期数, 用于比较不同配置
+
+void XIP_Prof_Init(void); // 打开DWT周期计数器, 清空统计表
+uint8_t XIP_Prof_Add(const char *name, const void *fn); // 登记一个函数, 返回编号; 表满返回 0xFF
+void XIP_Prof_Record(uint8_t id, uint32_t cycles); // 记录一次调用耗时
+void XIP_Prof_Snapshot(void); // 把当前平均耗时存为基准并清零计数, 之后的报告给出加速比
+void XIP_Prof_Report(void); // 按累计耗时排序打印, 并给出建议放入RAM的函数和分散加载文件写法
+
+//在被测函数里成对使用: uint32_t t = XIP_Prof_Begin(); ... XIP_Prof_End(id, t);
+__STATIC_INLINE uint32_t XIP_Prof_Begin(void) {
+    return DWT->CYCCNT;
+}
+
+__STATIC_INLINE void XIP_Prof_End(uint8_t id, uint32_t start) {
+    XIP_Prof_Record(id, DWT->CYCCNT - start);
+}
+
+#endif /* STM32F412xG || STM32F413_423xx || STM32F446xx || STM32F469_479xx */
+
+#endif
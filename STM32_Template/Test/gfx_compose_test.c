@@ -0,0 +1,445 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : gfx_compose_test.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					gfx_compose 脏矩形合成的PC测试. 按 gfx_compose.c 的流程(双缓冲,
+					本帧第一次绘图前把上一帧脏矩形从前台拷回后台, 绘图按本帧脏区域
+					裁剪)生成命令, 交给 Gfx_SwExecute 执行; 每帧同时用整屏区域把
+					整个场景重画一遍作参考, Gfx_SwCompare 逐像素比较, 不允许任何差别.
+					场景每帧都有填充、同格式拷贝、格式转换和三种混合(ARGB8888带整体
+					Alpha、ARGB4444、A8字形), 混合精灵彼此交叠并逐帧移动, 新旧位置的
+					脏矩形互相重叠; 每次绘图检查输出命令没有重复覆盖同一像素, 混合
+					执行两次就会与参考不同. 中间有一帧画面不变(不换帧), 有几帧的脏
+					矩形超过 GFX_DIRTY_MAX 要强制合并. 帧缓冲分别用 RGB565 和 ARGB8888.
+					在本目录下编译运行:
+					  gcc -O2 -Wall -I../Hardware gfx_compose_test.c ../Hardware/gfx_soft.c -o gfx_compose_test
+					  ./gfx_compose_test
+					全部通过返回0, 否则打印失败的检查并返回1.
+  * Function List:
+  *		main
+  **********************************************************
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "gfx_soft.h"
+
+#define SCR_W               160
+#define SCR_H               120
+#define FRAMES              24
+
+#define SPARK_NUM           20      //超过 GFX_DIRTY_MAX 的小脏矩形
+#define SPARK_FIRST         10
+#define SPARK_LAST          13
+#define FREEZE_FRAME        16      //与上一帧相同, 不换帧
+
+#define SPR_NUM             5
+
+typedef struct {
+    uint8_t *fb[2];
+    uint8_t front;
+    uint8_t synced;
+    Gfx_Region cur;
+    Gfx_Region prev;
+} Comp;
+
+static uint8_t fb_mem[2][SCR_W * SCR_H * 4];
+static uint8_t ref_mem[SCR_W * SCR_H * 4];
+static uint8_t cover[SCR_W * SCR_H];    //本次绘图每个像素被输出的次数
+
+static uint8_t img565[16 * 24 * 2];
+static uint8_t img8888[20 * 20 * 4];
+static uint8_t spr_a[32 * 32 * 4];      //ARGB8888, alpha 从中心向外递减
+static uint8_t spr_b[28 * 20 * 2];      //ARGB4444
+static uint8_t glyph[16 * 16];          //A8
+
+static Comp comp;
+static uint8_t fb_format;
+static uint8_t *cover_base;             //非NULL时统计输出到该缓冲的像素
+static uint32_t dirty_px, full_px, swaps;
+static int failed;
+
+#define CHECK(c)    do { if(!(c)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #c); failed = 1; } } while(0)
+
+static void make_images(void) {
+    uint32_t x, y, i, dx, dy, d;
+
+    for(i = 0; i < 16 * 24; i++) {
+        img565[i * 2] = (uint8_t)(i * 37);
+        img565[i * 2 + 1] = (uint8_t)(i * 11 + 5);
+    }
+
+    for(i = 0; i < 20 * 20; i++) {
+        img8888[i * 4] = (uint8_t)(i * 3);
+        img8888[i * 4 + 1] = (uint8_t)(i * 7);
+        img8888[i * 4 + 2] = (uint8_t)(255 - i);
+        img8888[i * 4 + 3] = (uint8_t)(i * 13);     //转换时按不透明处理, alpha 不应影响结果
+    }
+
+    for(y = 0; y < 32; y++) {
+        for(x = 0; x < 32; x++) {
+            dx = x > 15 ? x - 15 : 15 - x;
+            dy = y > 15 ? y - 15 : 15 - y;
+            d = dx * dx + dy * dy;
+            i = (y * 32 + x) * 4;
+            spr_a[i] = (uint8_t)(x * 8);
+            spr_a[i + 1] = (uint8_t)(y * 8);
+            spr_a[i + 2] = 0xC0;
+            spr_a[i + 3] = d >= 256 ? 0 : (uint8_t)(255 - d);
+        }
+    }
+
+    for(i = 0; i < 28 * 20; i++) {
+        spr_b[i * 2] = (uint8_t)(i * 29);
+        spr_b[i * 2 + 1] = (uint8_t)(((i % 16) << 4) | ((i * 5) & 0x0F));
+    }
+
+    for(y = 0; y < 16; y++) {
+        for(x = 0; x < 16; x++) glyph[y * 16 + x] = (x == y || x + y == 15 || x == 0 || y == 15) ? 0xFF : (uint8_t)(x * y);
+    }
+}
+
+//第 f 帧的动画时间, FREEZE_FRAME 与上一帧相同
+static int anim_time(int f) {
+    return f < FREEZE_FRAME ? f : f - 1;
+}
+
+//精灵 i 在第 f 帧的包围矩形, 部分移出屏幕边界
+static void sprite_rect(int i, int f, Gfx_Rect *r) {
+    static const int16_t size[SPR_NUM][2] = { {16, 24}, {20, 20}, {32, 32}, {28, 20}, {16, 16} };
+    int t = anim_time(f);
+
+    switch(i) {
+        case 0:
+            r->X0 = (int16_t)(t * 6 - 10);
+            r->Y0 = 10;
+            break;
+
+        case 1:
+            r->X0 = 120;
+            r->Y0 = (int16_t)(100 - t * 5);
+            break;
+
+        case 2:
+            r->X0 = (int16_t)(30 + t * 3);
+            r->Y0 = (int16_t)(40 + t);
+            break;
+
+        case 3:
+            r->X0 = (int16_t)(90 - t * 2);
+            r->Y0 = (int16_t)(50 + (t & 3));
+            break;
+
+        default:
+            r->X0 = (int16_t)(60 + t);
+            r->Y0 = (int16_t)(55 - t);
+            break;
+    }
+
+    r->X1 = (int16_t)(r->X0 + size[i][0]);
+    r->Y1 = (int16_t)(r->Y0 + size[i][1]);
+}
+
+static void spark_rect(int i, Gfx_Rect *r) {
+    r->X0 = (int16_t)((i * 37) % (SCR_W - 4));
+    r->Y0 = (int16_t)((i * 53) % (SCR_H - 4));
+    r->X1 = (int16_t)(r->X0 + 3);
+    r->Y1 = (int16_t)(r->Y0 + 3);
+}
+
+static uint8_t spark_on(int f) {
+    return f >= SPARK_FIRST && f <= SPARK_LAST;
+}
+
+static void image_cmd(Gfx_Cmd *cmd, uint8_t op, const uint8_t *data, uint8_t format, uint16_t w, uint16_t h) {
+    cmd->Op = op;
+    cmd->SrcFormat = format;
+    cmd->AlphaMode = GFX_ALPHA_NONE;
+    cmd->Alpha = 0xFF;
+    cmd->Color = 0;
+    cmd->Src = data;
+    cmd->SrcStride = w;
+    cmd->Width = w;
+    cmd->Height = h;
+}
+
+//与 Gfx_DrawImage 相同: 格式与帧缓冲相同时拷贝, 否则转换
+static void draw_image(void (*draw)(Gfx_Cmd *, int16_t, int16_t), const uint8_t *data, uint8_t format,
+                       uint16_t w, uint16_t h, const Gfx_Rect *at) {
+    Gfx_Cmd cmd;
+
+    image_cmd(&cmd, format == fb_format ? GFX_OP_COPY : GFX_OP_CONVERT, data, format, w, h);
+    draw(&cmd, at->X0, at->Y0);
+}
+
+//与 Gfx_BlendImage 相同
+static void blend_image(void (*draw)(Gfx_Cmd *, int16_t, int16_t), const uint8_t *data, uint8_t format,
+                        uint16_t w, uint16_t h, const Gfx_Rect *at, uint32_t color, uint8_t alpha) {
+    Gfx_Cmd cmd;
+
+    image_cmd(&cmd, GFX_OP_BLEND, data, format, w, h);
+    cmd.AlphaMode = alpha == 0xFF ? GFX_ALPHA_NONE : GFX_ALPHA_COMBINE;
+    cmd.Alpha = alpha;
+    cmd.Color = color;
+    draw(&cmd, at->X0, at->Y0);
+}
+
+static void fill(void (*draw)(Gfx_Cmd *, int16_t, int16_t), const Gfx_Rect *r, uint32_t color) {
+    Gfx_Cmd cmd;
+
+    cmd.Op = GFX_OP_FILL;
+    cmd.SrcFormat = fb_format;
+    cmd.AlphaMode = GFX_ALPHA_NONE;
+    cmd.Alpha = 0xFF;
+    cmd.Color = color;
+    cmd.Src = 0;
+    cmd.SrcStride = 0;
+    cmd.Width = (uint16_t)(r->X1 - r->X0);
+    cmd.Height = (uint16_t)(r->Y1 - r->Y0);
+    draw(&cmd, r->X0, r->Y0);
+}
+
+//整个场景, 由 draw 决定裁剪到哪个区域; 内容只取决于帧号
+static void draw_scene(void (*draw)(Gfx_Cmd *, int16_t, int16_t), int f) {
+    static const Gfx_Rect screen = { 0, 0, SCR_W, SCR_H };
+    static const Gfx_Rect panel = { 8, 70, 150, 112 };
+    Gfx_Rect r;
+    int i;
+
+    fill(draw, &screen, 0xFF203040);
+    fill(draw, &panel, 0xFF608050);
+
+    sprite_rect(0, f, &r);
+    draw_image(draw, img565, GFX_RGB565, 16, 24, &r);
+    sprite_rect(1, f, &r);
+    draw_image(draw, img8888, GFX_ARGB8888, 20, 20, &r);
+    sprite_rect(2, f, &r);
+    blend_image(draw, spr_a, GFX_ARGB8888, 32, 32, &r, 0, 200);
+    sprite_rect(3, f, &r);
+    blend_image(draw, spr_b, GFX_ARGB4444, 28, 20, &r, 0, 0xFF);
+    sprite_rect(4, f, &r);
+    blend_image(draw, glyph, GFX_A8, 16, 16, &r, 0x00FFE020, 0xC0);
+
+    if(spark_on(f)) {
+        for(i = 0; i < SPARK_NUM; i++) {
+            spark_rect(i, &r);
+            fill(draw, &r, 0xFF000000 | (uint32_t)(f * 0x102030 + i * 0x0F0F0F));
+        }
+    }
+}
+
+//区域内的矩形在屏幕内且两两不重叠
+static void check_region(const Gfx_Region *rg) {
+    Gfx_Rect t;
+    uint8_t i, j;
+
+    CHECK(rg->Count <= GFX_DIRTY_MAX);
+
+    for(i = 0; i < rg->Count; i++) {
+        CHECK(rg->Rect[i].X0 >= 0 && rg->Rect[i].Y0 >= 0 && rg->Rect[i].X1 <= SCR_W && rg->Rect[i].Y1 <= SCR_H);
+
+        for(j = i + 1; j < rg->Count; j++) CHECK(!Gfx_RectIntersect(&t, &rg->Rect[i], &rg->Rect[j]));
+    }
+}
+
+static void sink(const Gfx_Cmd *cmd) {
+    uint32_t bpp = Gfx_BytesPerPixel(cmd->DstFormat);
+    uint32_t off, x, y;
+
+    if(cover_base != NULL) {
+        off = (uint32_t)(cmd->Dst - cover_base) / bpp;
+
+        for(y = 0; y < cmd->Height; y++) {
+            for(x = 0; x < cmd->Width; x++) cover[off + y * SCR_W + x]++;
+        }
+
+        dirty_px += (uint32_t)cmd->Width * cmd->Height;
+    } else {
+        full_px += (uint32_t)cmd->Width * cmd->Height;
+    }
+
+    Gfx_SwExecute(cmd);
+}
+
+//一次 Gfx_RegionEmit, 统计输出覆盖, 同一像素不能输出两次
+static void emit_once(const Gfx_Region *rg, const Gfx_Cmd *cmd, int16_t x, int16_t y, uint8_t *base) {
+    uint32_t i;
+
+    memset(cover, 0, sizeof(cover));
+    cover_base = base;
+    Gfx_RegionEmit(rg, cmd, x, y, sink);
+    cover_base = NULL;
+
+    for(i = 0; i < SCR_W * SCR_H; i++) {
+        if(cover[i] > 1) {
+            CHECK(cover[i] <= 1);
+            break;
+        }
+    }
+}
+
+//以下与 gfx_compose.c 的 Gfx_Sync/Gfx_Draw/Gfx_BeginFrame/Gfx_Invalidate/Gfx_Present 相同, 只是命令直接执行
+static void comp_sync(void) {
+    Gfx_Region one;
+    Gfx_Cmd cmd;
+    uint8_t i;
+
+    comp.synced = 1;
+    image_cmd(&cmd, GFX_OP_COPY, comp.fb[comp.front], fb_format, SCR_W, SCR_H);
+    cmd.Dst = comp.fb[comp.front ^ 1];
+    cmd.DstFormat = fb_format;
+    cmd.DstStride = SCR_W;
+    one.Count = 1;
+
+    for(i = 0; i < comp.prev.Count; i++) {
+        if(Gfx_RegionContains(&comp.cur, &comp.prev.Rect[i])) continue;
+
+        one.Rect[0] = comp.prev.Rect[i];
+        emit_once(&one, &cmd, 0, 0, comp.fb[comp.front ^ 1]);
+    }
+}
+
+static void comp_draw(Gfx_Cmd *cmd, int16_t x, int16_t y) {
+    if(comp.synced == 0) comp_sync();
+
+    cmd->Dst = comp.fb[comp.front ^ 1];
+    cmd->DstFormat = fb_format;
+    cmd->DstStride = SCR_W;
+    emit_once(&comp.cur, cmd, x, y, comp.fb[comp.front ^ 1]);
+}
+
+static void comp_begin(void) {
+    Gfx_RegionClear(&comp.cur);
+    comp.synced = 0;
+}
+
+static void comp_invalidate(const Gfx_Rect *r) {
+    static const Gfx_Rect screen = { 0, 0, SCR_W, SCR_H };
+
+    Gfx_RegionAdd(&comp.cur, r, &screen);
+}
+
+//换帧立即生效
+static void comp_present(void) {
+    if(comp.cur.Count == 0) {
+        if(comp.synced) Gfx_RegionClear(&comp.prev);
+
+        return;
+    }
+
+    if(comp.synced == 0) comp_sync();
+
+    comp.prev = comp.cur;
+    comp.front ^= 1;
+    swaps++;
+}
+
+//参考: 每帧在整屏区域上重画全部内容
+static void ref_draw(Gfx_Cmd *cmd, int16_t x, int16_t y) {
+    Gfx_Region all;
+
+    all.Count = 1;
+    all.Rect[0].X0 = 0;
+    all.Rect[0].Y0 = 0;
+    all.Rect[0].X1 = SCR_W;
+    all.Rect[0].Y1 = SCR_H;
+    cmd->Dst = ref_mem;
+    cmd->DstFormat = fb_format;
+    cmd->DstStride = SCR_W;
+    Gfx_RegionEmit(&all, cmd, x, y, sink);
+}
+
+//本帧与上一帧有变化的地方: 移动精灵的新旧位置, 闪点出现/变色/消失的位置
+static void invalidate_changes(int f) {
+    static const Gfx_Rect screen = { 0, 0, SCR_W, SCR_H };
+    Gfx_Rect a, b;
+    int i;
+
+    if(f == 0) {
+        comp_invalidate(&screen);
+        return;
+    }
+
+    for(i = 0; i < SPR_NUM; i++) {
+        sprite_rect(i, f - 1, &a);
+        sprite_rect(i, f, &b);
+
+        if(memcmp(&a, &b, sizeof(a)) == 0) continue;
+
+        comp_invalidate(&a);
+        comp_invalidate(&b);
+    }
+
+    if(spark_on(f) || spark_on(f - 1)) {
+        for(i = 0; i < SPARK_NUM; i++) {
+            spark_rect(i, &a);
+            comp_invalidate(&a);
+        }
+    }
+}
+
+static void run_format(uint8_t format) {
+    uint32_t bpp = Gfx_BytesPerPixel(format);
+    uint32_t swaps0, bad;
+    int f;
+
+    fb_format = format;
+    comp.fb[0] = fb_mem[0];
+    comp.fb[1] = fb_mem[1];
+    comp.front = 0;
+    comp.synced = 1;
+    Gfx_RegionClear(&comp.cur);
+    Gfx_RegionClear(&comp.prev);
+    swaps = 0;
+    dirty_px = 0;
+    full_px = 0;
+
+    //两个缓冲开始时内容不同, 第0帧整屏重画后只靠同步拷贝保持一致
+    memset(fb_mem[0], 0x00, sizeof(fb_mem[0]));
+    memset(fb_mem[1], 0x5A, sizeof(fb_mem[1]));
+
+    for(f = 0; f < FRAMES; f++) {
+        swaps0 = swaps;
+        comp_begin();
+        invalidate_changes(f);
+        check_region(&comp.cur);
+
+        if(spark_on(f)) CHECK(comp.cur.Count <= GFX_DIRTY_MAX);
+
+        if(comp.cur.Count > 0) draw_scene(comp_draw, f);
+
+        comp_present();
+        CHECK((swaps != swaps0) == (f != FREEZE_FRAME));
+
+        draw_scene(ref_draw, f);
+        bad = Gfx_SwCompare(comp.fb[comp.front], ref_mem, SCR_W, SCR_H, SCR_W, format, 0);
+
+        if(bad != 0) printf("format %u frame %d: %u pixels differ\n", format, f, (unsigned)bad);
+
+        CHECK(bad == 0);
+        CHECK(memcmp(comp.fb[comp.front], ref_mem, SCR_W * SCR_H * bpp) == 0);
+    }
+
+    printf("format %u: %d frames, dirty path %u px, full redraw %u px\n", format, FRAMES,
+           (unsigned)dirty_px, (unsigned)full_px);
+}
+
+int main(void) {
+    make_images();
+    run_format(GFX_RGB565);
+    run_format(GFX_ARGB8888);
+
+    printf("%s\n", failed ? "gfx_compose_test: FAILED" : "gfx_compose_test: OK");
+    return failed;
+}
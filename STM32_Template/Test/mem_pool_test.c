@@ -0,0 +1,317 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : mem_pool_test.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					mem_pool 在PC上的单元测试和性能测试, 两块 malloc 出来的内存分别作
+					MEM_FAST 和 MEM_BULK 区域:
+					  1. 8000个64字节对象全部申请再全部释放, slab页除每级缓存的一页外
+					     全部回到页堆;
+					  2. 随机尺寸(含整页的大块)随机申请释放, 每个对象写满自己的标记,
+					     释放前检查没有被别的对象覆盖, 统计与影子表一致;
+					  3. 前两步之后 MEM_BULK|MEM_STRICT 一次申请整个区域要成功(先收回缓存的空页);
+					  4. 页边界上反复申请释放: 刚好占满一页后再申请释放一个对象,
+					     不能每次都从页堆取页、切页再归还, 耗时与普通申请释放相当;
+					  5. 与C库 malloc/free 对比每次申请+释放的平均耗时.
+					四份 mem_pool.c 相同, 换 -I 和源文件路径即可测试其它模板的副本:
+					  gcc -O2 -Wall -I../Hardware mem_pool_test.c ../Hardware/mem_pool.c -o mem_pool_test
+					  ./mem_pool_test
+					全部通过返回0, 否则打印失败的检查并返回1.
+  * Function List:
+  *		main
+  **********************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "mem_pool.h"
+
+#define FAST_SIZE           (256 * 1024)
+#define BULK_SIZE           (2 * 1024 * 1024)
+
+#define SMALL_NUM           8000
+#define RAND_SLOTS          1024
+#define RAND_ROUNDS         200000
+#define BENCH_ROUNDS        2000000
+
+typedef struct {
+    uint8_t *p;
+    uint32_t size;
+} Slot;
+
+static uint8_t fast_region, bulk_region;
+static int failed;
+
+#define CHECK(c)    do { if(!(c)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #c); failed = 1; } } while(0)
+
+static uint32_t rnd_state = 12345;
+
+static uint32_t rnd(void) {
+    rnd_state ^= rnd_state << 13;
+    rnd_state ^= rnd_state >> 17;
+    rnd_state ^= rnd_state << 5;
+    return rnd_state;
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+//区域内没有在用的内存: 除每级最多一页缓存的空slab页外, 所有页都在页堆中
+static void check_empty(uint8_t region) {
+    Mem_Stats st;
+    int i;
+
+    Mem_GetStats(region, &st);
+    CHECK(st.FreePages + st.SlabPages == st.Pages);
+    CHECK(st.SlabPages <= MEM_CLASS_NUM);
+    CHECK(st.InUse == 0);
+    CHECK(st.Allocs == st.Frees);
+
+    for(i = 0; i < MEM_CLASS_NUM; i++) CHECK(st.ClassInUse[i] == 0);
+}
+
+static void test_small(void) {
+    static uint8_t *obj[SMALL_NUM];
+    Mem_Stats st;
+    int i;
+
+    for(i = 0; i < SMALL_NUM; i++) {
+        obj[i] = Mem_Alloc(64, MEM_BULK | MEM_STRICT);
+        CHECK(obj[i] != NULL);
+        CHECK(((uintptr_t)obj[i] & 31) == 0);
+        memset(obj[i], (uint8_t)i, 64);
+    }
+
+    Mem_GetStats(bulk_region, &st);
+    CHECK(st.ClassInUse[2] == SMALL_NUM);
+    CHECK(st.SlabPages == (SMALL_NUM * 64 + MEM_PAGE_SIZE - 1) / MEM_PAGE_SIZE);
+
+    //先释放偶数再释放奇数, 页要等最后一个对象释放才归还
+    for(i = 0; i < SMALL_NUM; i += 2) Mem_Free(obj[i]);
+
+    Mem_GetStats(bulk_region, &st);
+    CHECK(st.SlabPages == (SMALL_NUM * 64 + MEM_PAGE_SIZE - 1) / MEM_PAGE_SIZE);
+
+    for(i = 1; i < SMALL_NUM; i += 2) {
+        CHECK(obj[i][0] == (uint8_t)i && obj[i][63] == (uint8_t)i);
+        Mem_Free(obj[i]);
+    }
+
+    check_empty(bulk_region);
+    Mem_GetStats(bulk_region, &st);
+    CHECK(st.SlabPages == 1);
+}
+
+static uint32_t rand_size(void) {
+    uint32_t r = rnd();
+
+    if((r & 15) == 0) return MEM_CLASS_MAX + 1 + (r >> 8) % (3 * MEM_PAGE_SIZE);	//1/16 是整页的大块
+
+    return 1 + (r >> 8) % MEM_CLASS_MAX;
+}
+
+static int slot_intact(const Slot *s, uint32_t tag) {
+    uint32_t i;
+
+    for(i = 0; i < s->size; i++) {
+        if(s->p[i] != (uint8_t)tag) return 0;
+    }
+
+    return 1;
+}
+
+static void test_random(void) {
+    static Slot slot[RAND_SLOTS];
+    uint32_t live = 0, in_use = 0;
+    uint32_t r, i, k, cls;
+    Mem_Stats st;
+
+    for(r = 0; r < RAND_ROUNDS; r++) {
+        k = rnd() % RAND_SLOTS;
+
+        if(slot[k].p != NULL) {
+            CHECK(slot_intact(&slot[k], k));
+            Mem_Free(slot[k].p);
+            slot[k].p = NULL;
+            live--;
+        } else {
+            slot[k].size = rand_size();
+            slot[k].p = Mem_Alloc(slot[k].size, MEM_BULK | MEM_STRICT);
+
+            if(slot[k].p != NULL) {
+                memset(slot[k].p, (uint8_t)k, slot[k].size);
+                live++;
+            }
+        }
+    }
+
+    Mem_GetStats(bulk_region, &st);
+
+    for(i = 0; i < RAND_SLOTS; i++) {
+        if(slot[i].p == NULL) continue;
+
+        if(slot[i].size <= MEM_CLASS_MAX) {
+            for(cls = 0; ((uint32_t)MEM_CLASS_MIN << cls) < slot[i].size; cls++);
+
+            in_use += MEM_CLASS_MIN << cls;
+        } else {
+            in_use += (slot[i].size + MEM_PAGE_SIZE - 1) / MEM_PAGE_SIZE * MEM_PAGE_SIZE;
+        }
+    }
+
+    CHECK(st.InUse == in_use);
+    CHECK(st.Allocs - st.Frees == live);
+
+    for(i = 0; i < RAND_SLOTS; i++) {
+        if(slot[i].p == NULL) continue;
+
+        CHECK(slot_intact(&slot[i], i));
+        Mem_Free(slot[i].p);
+        slot[i].p = NULL;
+    }
+
+    check_empty(bulk_region);
+}
+
+static void test_whole_region(void) {
+    Mem_Stats st;
+    void *p;
+
+    Mem_GetStats(bulk_region, &st);
+    CHECK(st.SlabPages != 0);
+    p = Mem_Alloc(st.Pages * MEM_PAGE_SIZE, MEM_BULK | MEM_STRICT);
+    CHECK(p != NULL);
+    Mem_Free(p);
+    check_empty(bulk_region);
+    Mem_GetStats(bulk_region, &st);
+    CHECK(st.FreePages == st.Pages);
+
+    //MEM_STRICT 不借用 MEM_FAST 区域
+    CHECK(Mem_Alloc(st.Pages * MEM_PAGE_SIZE + 1, MEM_BULK | MEM_STRICT) == NULL);
+}
+
+//每级 MEM_PAGE_SIZE/size 个对象刚好占满一页, 再多一个就要第二页
+static void test_thrash(void) {
+    static void *full[MEM_PAGE_SIZE / 16];
+    Mem_Stats st0, st;
+    double t0, t_edge, t_warm;
+    uint32_t size, num, i, cls;
+    void *p;
+
+    for(cls = 0; cls < MEM_CLASS_NUM; cls++) {
+        size = MEM_CLASS_MIN << cls;
+        num = MEM_PAGE_SIZE / size;
+
+        for(i = 0; i < num; i++) full[i] = Mem_Alloc(size, MEM_FAST | MEM_STRICT);
+
+        //第一次越过页边界从页堆取一页, 释放后这页留作缓存
+        Mem_Free(Mem_Alloc(size, MEM_FAST | MEM_STRICT));
+        Mem_GetStats(fast_region, &st0);
+        t0 = now_ns();
+
+        for(i = 0; i < BENCH_ROUNDS / 8; i++) {
+            p = Mem_Alloc(size, MEM_FAST | MEM_STRICT);
+            CHECK(p != NULL);
+            Mem_Free(p);
+        }
+
+        t_edge = now_ns() - t0;
+        Mem_GetStats(fast_region, &st);
+        //空页留在缓存中, 页堆和slab页数都不变
+        CHECK(st.FreePages == st0.FreePages);
+        CHECK(st.SlabPages == st0.SlabPages);
+
+        //对照: 同一级别, 页内还有空位时的申请释放
+        Mem_Free(full[0]);
+        t0 = now_ns();
+
+        for(i = 0; i < BENCH_ROUNDS / 8; i++) {
+            p = Mem_Alloc(size, MEM_FAST | MEM_STRICT);
+            Mem_Free(p);
+        }
+
+        t_warm = now_ns() - t0;
+
+        for(i = 1; i < num; i++) Mem_Free(full[i]);
+
+        printf("class %4u: page edge %.1f ns, inside a page %.1f ns\n", (unsigned)size,
+               t_edge / (BENCH_ROUNDS / 8), t_warm / (BENCH_ROUNDS / 8));
+        //随机顺序的调度抖动之外, 边界上不应比页内慢几倍
+        CHECK(t_edge < 4 * t_warm + 1e6);
+    }
+
+    check_empty(fast_region);
+}
+
+static void bench(void) {
+    static void *ring[64];
+    double t0, t_pool, t_libc;
+    uint32_t i, k;
+
+    memset(ring, 0, sizeof(ring));
+    t0 = now_ns();
+
+    for(i = 0; i < BENCH_ROUNDS; i++) {
+        k = i & 63;
+        Mem_Free(ring[k]);
+        ring[k] = Mem_Alloc(16 + (i * 7) % 240, MEM_FAST);
+    }
+
+    t_pool = now_ns() - t0;
+
+    for(k = 0; k < 64; k++) Mem_Free(ring[k]);
+
+    check_empty(fast_region);
+
+    memset(ring, 0, sizeof(ring));
+    t0 = now_ns();
+
+    for(i = 0; i < BENCH_ROUNDS; i++) {
+        k = i & 63;
+        free(ring[k]);
+        ring[k] = malloc(16 + (i * 7) % 240);
+    }
+
+    t_libc = now_ns() - t0;
+
+    for(k = 0; k < 64; k++) free(ring[k]);
+
+    printf("alloc+free: mem_pool %.1f ns, malloc %.1f ns\n", t_pool / BENCH_ROUNDS, t_libc / BENCH_ROUNDS);
+}
+
+int main(void) {
+    void *fast = malloc(FAST_SIZE);
+    void *bulk = malloc(BULK_SIZE);
+
+    fast_region = Mem_AddRegion(fast, FAST_SIZE, MEM_FAST);
+    bulk_region = Mem_AddRegion(bulk, BULK_SIZE, MEM_BULK);
+    CHECK(fast_region != 0xFF && bulk_region != 0xFF);
+
+    test_small();
+    test_random();
+    test_whole_region();
+    test_thrash();
+    bench();
+
+    printf("%s\n", failed ? "mem_pool_test: FAILED" : "mem_pool_test: OK");
+
+    free(fast);
+    free(bulk);
+    return failed;
+}
@@ -0,0 +1,196 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : dma2d_queue.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					库函数 DMA2D_PixelFill/Move/Convert/Blend 每次只能启动一个操作,
+					调用者要轮询 DMA2D_IsBusy. 这里把操作连同层参数一起放入环形队列,
+					DMA2D_Handler 在一次传输完成后立即启动下一条, CPU只在需要结果时
+					用栅栏等待. 队列只能在主循环中写入.
+  * Function List:
+  *		DMA2DQ_Init
+  *		DMA2DQ_Fill
+  *		DMA2DQ_Move
+  *		DMA2DQ_Convert
+  *		DMA2DQ_Blend
+  *		DMA2DQ_Fence
+  *		DMA2DQ_FenceDone
+  *		DMA2DQ_FenceWait
+  *		DMA2DQ_GetStats
+  *		DMA2D_Handler
+  **********************************************************
+ */
+
+#include "dma2d_queue.h"
+
+#define DMA2DQ_MASK		(DMA2DQ_LEN - 1)
+
+#define DMA2DQ_OP_FILL		0
+#define DMA2DQ_OP_MOVE		1
+#define DMA2DQ_OP_CONVERT	2
+#define DMA2DQ_OP_BLEND		3
+
+typedef struct {
+    uint8_t  op;
+    uint32_t color;
+    DMA2D_LayerSetting fg;
+    DMA2D_LayerSetting bg;
+    DMA2D_LayerSetting out;
+} DMA2DQ_Op;
+
+static DMA2DQ_Op ring[DMA2DQ_LEN];
+static volatile uint32_t ring_wr;		//主循环写, 同时是最后一个操作的栅栏
+static volatile uint32_t ring_rd;		//中断写, 同时是已完成的栅栏
+static volatile uint8_t dma2d_busy;
+static DMA2DQ_Stats dma2dq_stats;
+
+static void DMA2DQ_Start(DMA2DQ_Op * op) {
+    switch(op->op) {
+        case DMA2DQ_OP_FILL:
+            DMA2D_PixelFill(&op->out, op->color);
+            break;
+
+        case DMA2DQ_OP_MOVE:
+            DMA2D_PixelMove(&op->fg, &op->out);
+            break;
+
+        case DMA2DQ_OP_CONVERT:
+            DMA2D_PixelConvert(&op->fg, &op->out);
+            break;
+
+        default:
+            DMA2D_PixelBlend(&op->fg, &op->bg, &op->out);
+            break;
+    }
+}
+
+//取得一个空位, 队列满时等中断腾出位置
+static DMA2DQ_Op * DMA2DQ_Alloc(void) {
+    uint32_t wr = ring_wr;
+
+    if(wr - ring_rd >= DMA2DQ_LEN) {
+        dma2dq_stats.RingFull++;
+
+        while(wr - ring_rd >= DMA2DQ_LEN) __NOP();
+    }
+
+    return &ring[wr & DMA2DQ_MASK];
+}
+
+//提交 DMA2DQ_Alloc 取得的操作; 中断在 ring_wr 更新后发现还有操作会自己启动, 这里只在它已经停下时启动
+static DMA2DQ_Fence_t DMA2DQ_Commit(void) {
+    uint32_t wr = ring_wr + 1;
+
+    __DMB();
+    ring_wr = wr;
+    dma2dq_stats.Submitted++;
+
+    if(wr - ring_rd > dma2dq_stats.MaxDepth)
+        dma2dq_stats.MaxDepth = wr - ring_rd;
+
+    if(dma2d_busy == 0) {
+        dma2d_busy = 1;
+        DMA2DQ_Start(&ring[ring_rd & DMA2DQ_MASK]);
+    }
+
+    return wr;
+}
+
+void DMA2DQ_Init(uint16_t interval) {
+    DMA2D_InitStructure DMA2D_initStruct;
+
+    ring_wr = 0;
+    ring_rd = 0;
+    dma2d_busy = 0;
+    dma2dq_stats.Submitted = 0;
+    dma2dq_stats.Completed = 0;
+    dma2dq_stats.RingFull = 0;
+    dma2dq_stats.MaxDepth = 0;
+
+    DMA2D_initStruct.Interval = interval;
+    DMA2D_initStruct.IntEOTEn = 1;
+    DMA2D_Init(&DMA2D_initStruct);
+}
+
+DMA2DQ_Fence_t DMA2DQ_Fill(DMA2D_LayerSetting * outLayer, uint32_t color) {
+    DMA2DQ_Op * op = DMA2DQ_Alloc();
+
+    op->op = DMA2DQ_OP_FILL;
+    op->color = color;
+    op->out = *outLayer;
+
+    return DMA2DQ_Commit();
+}
+
+DMA2DQ_Fence_t DMA2DQ_Move(DMA2D_LayerSetting * fgLayer, DMA2D_LayerSetting * outLayer) {
+    DMA2DQ_Op * op = DMA2DQ_Alloc();
+
+    op->op = DMA2DQ_OP_MOVE;
+    op->fg = *fgLayer;
+    op->out = *outLayer;
+
+    return DMA2DQ_Commit();
+}
+
+DMA2DQ_Fence_t DMA2DQ_Convert(DMA2D_LayerSetting * fgLayer, DMA2D_LayerSetting * outLayer) {
+    DMA2DQ_Op * op = DMA2DQ_Alloc();
+
+    op->op = DMA2DQ_OP_CONVERT;
+    op->fg = *fgLayer;
+    op->out = *outLayer;
+
+    return DMA2DQ_Commit();
+}
+
+DMA2DQ_Fence_t DMA2DQ_Blend(DMA2D_LayerSetting * fgLayer, DMA2D_LayerSetting * bgLayer, DMA2D_LayerSetting * outLayer) {
+    DMA2DQ_Op * op = DMA2DQ_Alloc();
+
+    op->op = DMA2DQ_OP_BLEND;
+    op->fg = *fgLayer;
+    op->bg = *bgLayer;
+    op->out = *outLayer;
+
+    return DMA2DQ_Commit();
+}
+
+DMA2DQ_Fence_t DMA2DQ_Fence(void) {
+    return ring_wr;
+}
+
+//序号自由运行, 用有符号差值比较, 回绕后仍然正确
+uint32_t DMA2DQ_FenceDone(DMA2DQ_Fence_t fence) {
+    return (int32_t)(ring_rd - fence) >= 0 ? 1 : 0;
+}
+
+void DMA2DQ_FenceWait(DMA2DQ_Fence_t fence) {
+    while(DMA2DQ_FenceDone(fence) == 0) __NOP();
+}
+
+void DMA2DQ_GetStats(DMA2DQ_Stats * stats) {
+    *stats = dma2dq_stats;
+}
+
+void DMA2D_Handler(void) {
+    uint32_t rd;
+
+    if(DMA2D_INTStat() == 0) return;
+
+    DMA2D_INTClr();
+
+    rd = ring_rd + 1;
+    ring_rd = rd;
+    dma2dq_stats.Completed++;
+
+    if(rd != ring_wr) DMA2DQ_Start(&ring[rd & DMA2DQ_MASK]);
+    else dma2d_busy = 0;
+}
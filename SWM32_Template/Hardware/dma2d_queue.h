@@ -0,0 +1,54 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : dma2d_queue.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : SWM341 DMA2D异步操作环形队列, 由传输完成中断逐条启动, 用栅栏等待完成
+  * Function List:
+  *		DMA2DQ_Init
+  *		DMA2DQ_Fill
+  *		DMA2DQ_Move
+  *		DMA2DQ_Convert
+  *		DMA2DQ_Blend
+  *		DMA2DQ_Fence
+  *		DMA2DQ_FenceDone
+  *		DMA2DQ_FenceWait
+  *		DMA2DQ_GetStats
+  ******************************************************
+**/
+
+#ifndef __DMA2D_QUEUE_H_
+#define __DMA2D_QUEUE_H_
+
+#include "SWM341.h"
+
+#define DMA2DQ_LEN		32		//队列长度, 2的幂
+
+//栅栏: 操作的序号, 序号之前(含)的操作都完成后栅栏即完成
+typedef uint32_t DMA2DQ_Fence_t;
+
+typedef struct {
+    uint32_t Submitted;		//入队的操作数
+    uint32_t Completed;		//完成的操作数
+    uint32_t RingFull;		//入队时队列满而等待的次数
+    uint32_t MaxDepth;		//队列中同时等待的最大操作数
+} DMA2DQ_Stats;
+
+void DMA2DQ_Init(uint16_t interval);	// 初始化DMA2D并打开完成中断, interval 见 DMA2D_InitStructure.Interval
+DMA2DQ_Fence_t DMA2DQ_Fill(DMA2D_LayerSetting * outLayer, uint32_t color);	// 入队一次填充, 返回其栅栏
+DMA2DQ_Fence_t DMA2DQ_Move(DMA2D_LayerSetting * fgLayer, DMA2D_LayerSetting * outLayer);	// 入队一次搬运
+DMA2DQ_Fence_t DMA2DQ_Convert(DMA2D_LayerSetting * fgLayer, DMA2D_LayerSetting * outLayer);	// 入队一次格式转换
+DMA2DQ_Fence_t DMA2DQ_Blend(DMA2D_LayerSetting * fgLayer, DMA2D_LayerSetting * bgLayer, DMA2D_LayerSetting * outLayer);	// 入队一次混合
+DMA2DQ_Fence_t DMA2DQ_Fence(void);		// 最后一个已入队操作的栅栏
+uint32_t DMA2DQ_FenceDone(DMA2DQ_Fence_t fence);	// 栅栏已完成返回1
+void DMA2DQ_FenceWait(DMA2DQ_Fence_t fence);	// 等待栅栏完成
+void DMA2DQ_GetStats(DMA2DQ_Stats * stats);	// 读取统计信息
+
+#endif
@@ -0,0 +1,634 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : jpeg_stream.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					JFIF_Parse 逐字节解析文件头(DQT/DHT/SOF0/SOF1/DRI/SOS), 按
+					JPEG_Decode 要求的格式填好 jfif_info_t: 霍夫曼表展开成按码长
+					排列的码字/码长/符号. 数据可以一块一块送入, 不需要整个文件头
+					在内存中连续.
+					JPEGS_DecodeFile 用两个缓冲区轮流装码流: 解码器读完一个缓冲区
+					产生 EMPTY 中断, 中断里把另一个已装好的缓冲区送入; JPEGS_Poll
+					在主循环中把空出的缓冲区从SD卡读满. 读得不够快时中断只做标记,
+					由 JPEGS_Poll 读完后直接送入.
+					解码完成后可以直接显示(RGBAddr 就是LCD后台缓冲), 或者由
+					JPEGS_Poll 把输出交给DMA2D队列转换格式/搬到帧缓冲中的指定位置.
+  * Function List:
+  *		JFIF_ParserInit
+  *		JFIF_Parse
+  *		JPEGS_DecodeMem
+  *		JPEGS_DecodeFile
+  *		JPEGS_Poll
+  *		JPEGS_Fence
+  *		JPEGS_Info
+  *		JPEG_Handler
+  **********************************************************
+ */
+
+#include "jpeg_stream.h"
+#include <string.h>
+
+/* 解析器状态 */
+#define JFIF_S_SOI0			0
+#define JFIF_S_SOI1			1
+#define JFIF_S_MARK			2
+#define JFIF_S_CODE			3
+#define JFIF_S_LEN0			4
+#define JFIF_S_LEN1			5
+#define JFIF_S_BODY			6
+
+typedef struct {
+    JPEGS_InitStructure cfg;
+    jfif_info_t info;
+    JFIF_Parser parser;
+    volatile uint8_t state;
+    volatile uint8_t notify;		//中断已结束解码, 等 JPEGS_Poll 处理
+    volatile int32_t result;
+    volatile uint8_t cur;			//解码器正在读的缓冲区
+    volatile uint8_t ready[2];		//缓冲区已装好, 还没送入
+    volatile uint8_t starved;		//EMPTY中断时另一个缓冲区还没装好
+    uint8_t  last[2];
+    uint32_t len[2];
+    uint32_t remain;				//文件中还没读出的字节数
+    DMA2DQ_Fence_t fence;
+} JPEGS_Handle;
+
+static JPEGS_Handle jpegs;
+
+//按 BITS/HUFFVAL 生成规范霍夫曼码, 码字按码长从短到长排列
+static int32_t JFIF_Huffman(const uint8_t * bits, const uint8_t * huffval, uint16_t * word,
+                            uint8_t * len, uint8_t * val, uint32_t max) {
+    uint32_t code = 0, k = 0, l, i;
+
+    memset(word, 0, max * sizeof(uint16_t));
+    memset(len, 0, max);
+    memset(val, 0, max);
+
+    for(l = 1; l <= 16; l++) {
+        for(i = 0; i < bits[l - 1]; i++) {
+            if(code >= (1U << l)) return JFIF_ERR_FORMAT;
+
+            word[k] = code;
+            len[k] = l;
+            val[k] = huffval[k];
+            k++;
+            code++;
+        }
+
+        code <<= 1;
+    }
+
+    return JFIF_NEED_MORE;
+}
+
+static int32_t JFIF_DQT(jfif_info_t * info, const uint8_t * p, const uint8_t * end) {
+    uint8_t tq;
+
+    while(p < end) {
+        if(p[0] >> 4) return JFIF_ERR_UNSUPPORT;		//16位量化表
+
+        tq = p[0] & 0x0F;
+
+        if(tq >= JFIF_QTAB_MAX || end - p < 65) return JFIF_ERR_FORMAT;
+
+        memcpy(info->QTable[tq], p + 1, 64);
+
+        if(tq + 1 > info->QTableCnt) info->QTableCnt = tq + 1;
+
+        p += 65;
+    }
+
+    return JFIF_NEED_MORE;
+}
+
+static int32_t JFIF_DHT(jfif_info_t * info, const uint8_t * p, const uint8_t * end) {
+    uint32_t count, i;
+    uint8_t tc, th;
+    int32_t res;
+
+    while(p < end) {
+        if(end - p < 17) return JFIF_ERR_FORMAT;
+
+        tc = p[0] >> 4;
+        th = p[0] & 0x0F;
+
+        if(tc > 1) return JFIF_ERR_FORMAT;
+
+        if(th >= JFIF_HTAB_MAX) return JFIF_ERR_UNSUPPORT;
+
+        for(i = 0, count = 0; i < 16; i++) count += p[1 + i];
+
+        if((uint32_t)(end - p) < 17 + count) return JFIF_ERR_FORMAT;
+
+        if(tc == 0) {
+            if(count > 16) return JFIF_ERR_FORMAT;
+
+            res = JFIF_Huffman(p + 1, p + 17, info->HTable[th].DC.codeWord, info->HTable[th].DC.codeLen,
+                               info->HTable[th].DC.codeVal, 16);
+        } else {
+            if(count > 162) return JFIF_ERR_FORMAT;
+
+            res = JFIF_Huffman(p + 1, p + 17, info->HTable[th].AC.codeWord, info->HTable[th].AC.codeLen,
+                               info->HTable[th].AC.codeVal, 162);
+        }
+
+        if(res != JFIF_NEED_MORE) return res;
+
+        if(th + 1 > info->HTableCnt) info->HTableCnt = th + 1;
+
+        p += 17 + count;
+    }
+
+    return JFIF_NEED_MORE;
+}
+
+//解码器只支持8位YCbCr三分量, Y采样1x1/2x1/2x2, 色度1x1
+static int32_t JFIF_SOF(JFIF_Parser * parser, const uint8_t * p, uint32_t len) {
+    jfif_info_t * info = parser->info;
+    uint32_t i;
+
+    if(len < 6) return JFIF_ERR_FORMAT;
+
+    if(p[0] != 8) return JFIF_ERR_UNSUPPORT;
+
+    info->Height = (p[1] << 8) | p[2];
+    info->Width  = (p[3] << 8) | p[4];
+    info->CompCnt = p[5];
+
+    if(info->Height == 0 || info->Width == 0 || info->CompCnt != 3) return JFIF_ERR_UNSUPPORT;
+
+    if(len < 6 + 3 * 3) return JFIF_ERR_FORMAT;
+
+    for(i = 0; i < 3; i++) {
+        info->CompInfo[i].id = p[6 + 3 * i];
+        info->CompInfo[i].hfactor = p[7 + 3 * i] >> 4;
+        info->CompInfo[i].vfactor = p[7 + 3 * i] & 0x0F;
+        info->CompInfo[i].qtab_id = p[8 + 3 * i];
+
+        if(info->CompInfo[i].qtab_id >= JFIF_QTAB_MAX) return JFIF_ERR_FORMAT;
+    }
+
+    switch((info->CompInfo[0].hfactor << 4) | info->CompInfo[0].vfactor) {
+        case 0x11:
+        case 0x21:
+        case 0x22:
+            break;
+
+        default:
+            return JFIF_ERR_UNSUPPORT;
+    }
+
+    for(i = 1; i < 3; i++) {
+        if(info->CompInfo[i].hfactor != 1 || info->CompInfo[i].vfactor != 1) return JFIF_ERR_UNSUPPORT;
+    }
+
+    parser->gotSOF = 1;
+
+    return JFIF_NEED_MORE;
+}
+
+static int32_t JFIF_SOS(JFIF_Parser * parser, const uint8_t * p, uint32_t len) {
+    jfif_info_t * info = parser->info;
+    uint32_t ns, i, j;
+
+    if(parser->gotSOF == 0 || len < 1) return JFIF_ERR_FORMAT;
+
+    ns = p[0];
+
+    if(len < 1 + 2 * ns + 3) return JFIF_ERR_FORMAT;
+
+    if(ns != info->CompCnt) return JFIF_ERR_UNSUPPORT;		//不支持非交织扫描
+
+    for(i = 0; i < ns; i++) {
+        for(j = 0; j < info->CompCnt; j++) {
+            if(info->CompInfo[j].id == p[1 + 2 * i]) break;
+        }
+
+        if(j == info->CompCnt) return JFIF_ERR_FORMAT;
+
+        info->CompInfo[j].htab_id_dc = p[2 + 2 * i] >> 4;
+        info->CompInfo[j].htab_id_ac = p[2 + 2 * i] & 0x0F;
+
+        if(info->CompInfo[j].htab_id_dc >= JFIF_HTAB_MAX || info->CompInfo[j].htab_id_ac >= JFIF_HTAB_MAX)
+            return JFIF_ERR_UNSUPPORT;
+    }
+
+    //基线: Ss=0, Se=63, Ah=Al=0
+    if(p[1 + 2 * ns] != 0 || p[2 + 2 * ns] != 63 || p[3 + 2 * ns] != 0) return JFIF_ERR_UNSUPPORT;
+
+    if(info->QTableCnt == 0 || info->HTableCnt == 0) return JFIF_ERR_FORMAT;
+
+    return JFIF_DONE;
+}
+
+static int32_t JFIF_Segment(JFIF_Parser * parser) {
+    const uint8_t * p = parser->seg;
+
+    switch(parser->marker) {
+        case 0xDB:
+            return JFIF_DQT(parser->info, p, p + parser->seglen);
+
+        case 0xC4:
+            return JFIF_DHT(parser->info, p, p + parser->seglen);
+
+        case 0xC0:
+        case 0xC1:
+            return JFIF_SOF(parser, p, parser->seglen);
+
+        case 0xDD:
+            if(parser->seglen < 2) return JFIF_ERR_FORMAT;
+
+            parser->info->RstIntv = (p[0] << 8) | p[1];
+            return JFIF_NEED_MORE;
+
+        case 0xDA:
+            return JFIF_SOS(parser, p, parser->seglen);
+
+        default:	//APPn/COM 等直接跳过
+            return JFIF_NEED_MORE;
+    }
+}
+
+//1 需要保存解析, 0 跳过, <0 不支持的编码方式
+static int32_t JFIF_Keep(uint8_t marker) {
+    switch(marker) {
+        case 0xC0:
+        case 0xC1:
+        case 0xC4:
+        case 0xDA:
+        case 0xDB:
+        case 0xDD:
+            return 1;
+
+        case 0xC2:
+        case 0xC3:
+        case 0xC5:
+        case 0xC6:
+        case 0xC7:
+        case 0xC9:
+        case 0xCA:
+        case 0xCB:
+        case 0xCC:
+        case 0xCD:
+        case 0xCE:
+        case 0xCF:
+            return JFIF_ERR_UNSUPPORT;		//渐进/无损/分层/算术编码
+
+        default:
+            return 0;
+    }
+}
+
+void JFIF_ParserInit(JFIF_Parser * parser, jfif_info_t * info) {
+    memset(info, 0, sizeof(jfif_info_t));
+    parser->info = info;
+    parser->state = JFIF_S_SOI0;
+    parser->gotSOF = 0;
+    parser->offset = 0;
+}
+
+int32_t JFIF_Parse(JFIF_Parser * parser, const uint8_t * data, uint32_t len, uint32_t * used) {
+    int32_t res = JFIF_NEED_MORE;
+    uint32_t i = 0, n;
+    uint8_t c;
+
+    while(i < len && res == JFIF_NEED_MORE) {
+        c = data[i];
+
+        switch(parser->state) {
+            case JFIF_S_SOI0:
+            case JFIF_S_MARK:
+                if(c != 0xFF) {
+                    res = JFIF_ERR_FORMAT;
+                    break;
+                }
+
+                parser->state = parser->state == JFIF_S_SOI0 ? JFIF_S_SOI1 : JFIF_S_CODE;
+                i++;
+                break;
+
+            case JFIF_S_SOI1:
+                if(c != 0xD8) {
+                    res = JFIF_ERR_FORMAT;
+                    break;
+                }
+
+                parser->state = JFIF_S_MARK;
+                i++;
+                break;
+
+            case JFIF_S_CODE:
+                i++;
+
+                if(c == 0xFF) break;		//填充字节
+
+                if(c == 0xD8 || c == 0xD9) {
+                    res = JFIF_ERR_FORMAT;	//SOS之前出现SOI/EOI
+                } else if(c == 0x01 || (c >= 0xD0 && c <= 0xD7)) {
+                    parser->state = JFIF_S_MARK;	//没有长度字段的标记
+                } else {
+                    parser->marker = c;
+                    parser->state = JFIF_S_LEN0;
+                }
+
+                break;
+
+            case JFIF_S_LEN0:
+                parser->seglen = c << 8;
+                parser->state = JFIF_S_LEN1;
+                i++;
+                break;
+
+            case JFIF_S_LEN1:
+                parser->seglen |= c;
+                i++;
+                res = JFIF_Keep(parser->marker);
+
+                if(res < 0) break;
+
+                parser->keep = res;
+                res = JFIF_NEED_MORE;
+
+                if(parser->seglen < 2 || (parser->keep && parser->seglen - 2 > JFIF_SEG_MAX)) {
+                    res = parser->seglen < 2 ? JFIF_ERR_FORMAT : JFIF_ERR_UNSUPPORT;
+                    break;
+                }
+
+                parser->seglen -= 2;
+                parser->segpos = 0;
+                parser->state = JFIF_S_BODY;
+                break;
+
+            case JFIF_S_BODY:
+                n = parser->seglen - parser->segpos;
+
+                if(n > len - i) n = len - i;
+
+                if(parser->keep) memcpy(&parser->seg[parser->segpos], &data[i], n);
+
+                parser->segpos += n;
+                i += n;
+                break;
+        }
+
+        if(parser->state == JFIF_S_BODY && parser->segpos == parser->seglen && res == JFIF_NEED_MORE) {
+            parser->state = JFIF_S_MARK;
+
+            if(parser->keep) res = JFIF_Segment(parser);
+        }
+    }
+
+    parser->offset += i;
+    *used = i;
+
+    return res;
+}
+
+//jpeg_outset_t.format 对应的DMA2D格式, 不支持的返回 0xFF
+static uint8_t JPEGS_BlitFormat(uint8_t format) {
+    uint8_t bgr = (format & (1 << 5)) ? (1 << 4) : 0;
+
+    if(format & (1 << 6)) return 0xFF;
+
+    switch(format & 7) {
+        case JPEG_OUT_XRGB888:
+            return DMA2D_FMT_ARGB888 | bgr;
+
+        case JPEG_OUT_RGB888:
+            return DMA2D_FMT_RGB888 | bgr;
+
+        case JPEG_OUT_RGB565:
+            return DMA2D_FMT_RGB565 | bgr;
+
+        default:
+            return 0xFF;
+    }
+}
+
+static void JPEGS_Start(uint32_t lastbuf) {
+    JPEG_InitStructure JPEG_initStruct;
+
+    jpegs.notify = 0;
+    jpegs.result = JPEGS_OK;
+    jpegs.state = JPEGS_DECODING;
+
+    JPEG_initStruct.DoneIEn = 1;
+    JPEG_initStruct.ErrorIEn = 1;
+    JPEG_Init(JPEG, &JPEG_initStruct);
+    JPEG_INTClr(JPEG, JPEG_IT_EMPTY);
+
+    if(lastbuf) JPEG_INTDis(JPEG, JPEG_IT_EMPTY);
+    else JPEG_INTEn(JPEG, JPEG_IT_EMPTY);
+
+    JPEG_DecodeStream(JPEG, &jpegs.info, &jpegs.cfg.Out, lastbuf);
+}
+
+static int32_t JPEGS_Check(JPEGS_InitStructure * initStruct) {
+    if(jpegs.state == JPEGS_DECODING) return JPEGS_ERR_BUSY;
+
+    if(initStruct->BlitAddr && JPEGS_BlitFormat(initStruct->Out.format) == 0xFF) return JFIF_ERR_UNSUPPORT;
+
+    jpegs.cfg = *initStruct;
+    jpegs.state = JPEGS_IDLE;
+
+    return JPEGS_OK;
+}
+
+//从文件读满第k个缓冲区, 文件剩余不足一个缓冲区时只读剩余部分
+static int32_t JPEGS_Read(uint8_t k) {
+    uint32_t size = jpegs.remain < jpegs.cfg.BufSize ? jpegs.remain : jpegs.cfg.BufSize;
+
+    if(size == 0 || jpegs.cfg.Read(jpegs.cfg.Buffer[k], size) != size) return JPEGS_ERR_READ;
+
+    jpegs.remain -= size;
+    jpegs.len[k] = size;
+    jpegs.last[k] = jpegs.remain == 0;
+
+    return JPEGS_OK;
+}
+
+static void JPEGS_Feed(uint8_t k) {
+    jpegs.ready[k] = 0;
+    jpegs.cur = k;
+    JPEG_StreamFeed(JPEG, (uint32_t)jpegs.cfg.Buffer[k], jpegs.len[k], jpegs.last[k]);
+
+    if(jpegs.last[k]) JPEG_INTDis(JPEG, JPEG_IT_EMPTY);
+}
+
+int32_t JPEGS_DecodeMem(JPEGS_InitStructure * initStruct, uint32_t addr, uint32_t len) {
+    uint32_t used;
+    int32_t res;
+
+    res = JPEGS_Check(initStruct);
+
+    if(res != JPEGS_OK) return res;
+
+    JFIF_ParserInit(&jpegs.parser, &jpegs.info);
+    res = JFIF_Parse(&jpegs.parser, (const uint8_t *)addr, len, &used);
+
+    if(res < 0) return res;
+
+    if(res != JFIF_DONE || used >= len) return JFIF_ERR_FORMAT;
+
+    jpegs.info.CodeAddr = addr + used;
+    jpegs.info.CodeLen = len - used;
+    JPEGS_Start(1);
+
+    return JPEGS_OK;
+}
+
+int32_t JPEGS_DecodeFile(JPEGS_InitStructure * initStruct) {
+    uint32_t used;
+    int32_t res;
+
+    res = JPEGS_Check(initStruct);
+
+    if(res != JPEGS_OK) return res;
+
+    jpegs.remain = initStruct->FileSize;
+    JFIF_ParserInit(&jpegs.parser, &jpegs.info);
+
+    //文件头可能比缓冲区长, 反复读入同一个缓冲区直到SOS结束
+    do {
+        res = JPEGS_Read(0);
+
+        if(res != JPEGS_OK) return res;
+
+        res = JFIF_Parse(&jpegs.parser, jpegs.cfg.Buffer[0], jpegs.len[0], &used);
+    } while(res == JFIF_NEED_MORE);
+
+    if(res < 0) return res;
+
+    jpegs.info.CodeAddr = (uint32_t)jpegs.cfg.Buffer[0] + used;
+    jpegs.info.CodeLen = jpegs.len[0] - used;
+
+    if(jpegs.info.CodeLen == 0) {
+        res = JPEGS_Read(0);
+
+        if(res != JPEGS_OK) return res;
+
+        jpegs.info.CodeAddr = (uint32_t)jpegs.cfg.Buffer[0];
+        jpegs.info.CodeLen = jpegs.len[0];
+    }
+
+    //开始前先装好第二个缓冲区, 第一次EMPTY中断时可以立即接上
+    jpegs.cur = 0;
+    jpegs.ready[0] = 0;
+    jpegs.ready[1] = 0;
+    jpegs.starved = 0;
+
+    if(jpegs.last[0] == 0) {
+        res = JPEGS_Read(1);
+
+        if(res != JPEGS_OK) return res;
+
+        jpegs.ready[1] = 1;
+    }
+
+    JPEGS_Start(jpegs.last[0]);
+
+    return JPEGS_OK;
+}
+
+uint32_t JPEGS_Poll(void) {
+    uint32_t fg_fmt;
+    DMA2D_LayerSetting fg, out;
+    JPEGS_DoneFunc done;
+    uint8_t k;
+
+    if(jpegs.state == JPEGS_DECODING && jpegs.remain) {
+        k = jpegs.cur ^ 1;
+
+        //k 不在解码也没有待送入的数据, 说明已经空出来了
+        if(jpegs.ready[k] == 0) {
+            if(JPEGS_Read(k) != JPEGS_OK) {
+                JPEG->CR |= JPEG_CR_RESET_Msk;
+                jpegs.result = JPEGS_ERR_READ;
+                jpegs.state = JPEGS_ERROR;
+                jpegs.notify = 1;
+            } else {
+                //先置 ready 再查 starved: 中断在这之间发生会自己送入, 否则由这里送入
+                jpegs.ready[k] = 1;
+                __DMB();
+
+                if(jpegs.starved) {
+                    jpegs.starved = 0;
+                    JPEGS_Feed(k);
+                }
+            }
+        }
+    }
+
+    if(jpegs.notify) {
+        jpegs.notify = 0;
+
+        if(jpegs.result == JPEGS_OK && jpegs.cfg.BlitAddr) {
+            fg_fmt = JPEGS_BlitFormat(jpegs.cfg.Out.format);
+
+            fg.Address = jpegs.cfg.Out.RGBAddr;
+            fg.LineOffset = 0;
+            fg.ColorMode = fg_fmt;
+
+            out.Address = jpegs.cfg.BlitAddr;
+            out.LineOffset = jpegs.cfg.BlitStride - jpegs.info.Width;
+            out.ColorMode = jpegs.cfg.BlitFormat;
+            out.LineCount = jpegs.info.Height;
+            out.LinePixel = jpegs.info.Width;
+
+            if(fg_fmt == jpegs.cfg.BlitFormat) jpegs.fence = DMA2DQ_Move(&fg, &out);
+            else jpegs.fence = DMA2DQ_Convert(&fg, &out);
+        }
+
+        done = jpegs.cfg.Done;
+
+        if(done) done(jpegs.result);
+    }
+
+    return jpegs.state;
+}
+
+DMA2DQ_Fence_t JPEGS_Fence(void) {
+    return jpegs.fence;
+}
+
+jfif_info_t * JPEGS_Info(void) {
+    return &jpegs.info;
+}
+
+void JPEG_Handler(void) {
+    uint8_t k;
+
+    if(JPEG_INTStat(JPEG, JPEG_IT_ERROR)) {
+        JPEG_INTClr(JPEG, JPEG_IT_ERROR);
+        JPEG_INTDis(JPEG, JPEG_IT_EMPTY);
+        jpegs.result = JPEGS_ERR_DECODE;
+        jpegs.state = JPEGS_ERROR;
+        jpegs.notify = 1;
+        return;
+    }
+
+    if(JPEG_INTStat(JPEG, JPEG_IT_EMPTY)) {
+        JPEG_INTClr(JPEG, JPEG_IT_EMPTY);
+        k = jpegs.cur ^ 1;
+
+        if(jpegs.ready[k]) JPEGS_Feed(k);
+        else jpegs.starved = 1;
+    }
+
+    if(JPEG_INTStat(JPEG, JPEG_IT_DONE)) {
+        JPEG_INTClr(JPEG, JPEG_IT_DONE);
+        JPEG_INTDis(JPEG, JPEG_IT_EMPTY);
+        jpegs.state = JPEGS_DONE;
+        jpegs.notify = 1;
+    }
+}
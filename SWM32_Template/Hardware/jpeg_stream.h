@@ -0,0 +1,93 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : jpeg_stream.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : SWM341 JFIF文件头解析 + 码流分段送入的中断驱动JPEG解码
+  * Function List:
+  *		JFIF_ParserInit
+  *		JFIF_Parse
+  *		JPEGS_DecodeMem
+  *		JPEGS_DecodeFile
+  *		JPEGS_Poll
+  *		JPEGS_Fence
+  *		JPEGS_Info
+  ******************************************************
+**/
+
+#ifndef __JPEG_STREAM_H_
+#define __JPEG_STREAM_H_
+
+#include "SWM341.h"
+#include "dma2d_queue.h"
+
+#define JFIF_SEG_MAX		1024	//需要解析的段(DQT/DHT/SOF/SOS)的最大长度
+
+/* JFIF_Parse 返回值 */
+#define JFIF_NEED_MORE		0		//文件头还没结束, 继续送入数据
+#define JFIF_DONE			1		//SOS段已结束, 之后是熵编码数据
+#define JFIF_ERR_FORMAT		-1		//不是JPEG文件或段内容错误
+#define JFIF_ERR_UNSUPPORT	-2		//不是解码器支持的格式(渐进式/12位/灰度/采样因子)
+
+/* JPEGS_xxx 返回值和完成回调的参数, 另外也可能是上面的 JFIF_ERR_xxx */
+#define JPEGS_OK			0
+#define JPEGS_ERR_BUSY		-3		//上一张还在解码
+#define JPEGS_ERR_READ		-4		//读回调返回的字节数不对
+#define JPEGS_ERR_DECODE	-5		//解码器报错
+
+/* JPEGS_Poll 返回的状态 */
+#define JPEGS_IDLE			0
+#define JPEGS_DECODING		1
+#define JPEGS_DONE			2
+#define JPEGS_ERROR			3
+
+//增量式文件头解析器, 数据可以任意切分后多次送入
+typedef struct {
+    jfif_info_t * info;
+    uint8_t  state;
+    uint8_t  marker;
+    uint8_t  keep;				//当前段需要保存解析
+    uint8_t  gotSOF;
+    uint16_t seglen;			//当前段长度(不含长度字段)
+    uint16_t segpos;
+    uint32_t offset;			//从文件开头算起已处理的字节数
+    uint8_t  seg[JFIF_SEG_MAX];
+} JFIF_Parser;
+
+//从SD卡/文件读数据, 返回实际读到的字节数
+typedef uint32_t (*JPEGS_ReadFunc)(uint8_t * buf, uint32_t size);
+
+//解码结束回调, 在 JPEGS_Poll 中执行, result 为 JPEGS_OK 或错误码
+typedef void (*JPEGS_DoneFunc)(int32_t result);
+
+typedef struct {
+    jpeg_outset_t Out;			//解码输出; 图像宽度等于屏宽时 RGBAddr 可以直接给LCD后台缓冲
+    uint32_t BlitAddr;			//非0时解码完成后用DMA2D把RGB输出转换/搬运到这里(目标区域左上角)
+    uint16_t BlitStride;		//目标每行像素数
+    uint8_t  BlitFormat;		//目标格式 DMA2D_FMT_xxx
+    JPEGS_DoneFunc Done;
+
+    /* 只有 JPEGS_DecodeFile 使用 */
+    JPEGS_ReadFunc Read;
+    uint32_t FileSize;			//文件总字节数, 用来判断最后一个缓冲区
+    uint8_t * Buffer[2];		//码流乒乓缓冲区, 字对齐
+    uint32_t BufSize;			//每个缓冲区的字节数, 4的倍数
+} JPEGS_InitStructure;
+
+void JFIF_ParserInit(JFIF_Parser * parser, jfif_info_t * info);	// 清空 info 并准备解析
+int32_t JFIF_Parse(JFIF_Parser * parser, const uint8_t * data, uint32_t len, uint32_t * used);	// 送入一段数据, used 返回本次消耗的字节数
+
+int32_t JPEGS_DecodeMem(JPEGS_InitStructure * initStruct, uint32_t addr, uint32_t len);	// 解码可直接访问的整个文件(SFC映射/SDRAM), 不拷贝
+int32_t JPEGS_DecodeFile(JPEGS_InitStructure * initStruct);	// 边读边解码, 码流只占两个缓冲区
+uint32_t JPEGS_Poll(void);		// 在主循环中调用, 补充空出的缓冲区, 返回 JPEGS_IDLE/DECODING/DONE/ERROR
+DMA2DQ_Fence_t JPEGS_Fence(void);	// 最近一次 Blit 的栅栏
+jfif_info_t * JPEGS_Info(void);	// 当前图像信息, 宽高等
+
+#endif
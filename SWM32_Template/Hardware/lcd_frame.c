@@ -0,0 +1,91 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : lcd_frame.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					LCD以 IntEOTEn=1 初始化时不会自动重新开始, 每扫描完一帧进一次
+					LCD_Handler, 由这里决定下一帧显示哪个缓冲再调用 LCD_Start. 这样
+					换帧天然发生在两帧之间, 不会撕裂:
+					  主循环: Frame_Begin -> DMA2DQ_xxx 画后台 -> Frame_Present(栅栏)
+					  中断:   已提交且栅栏完成则切换地址, 然后 LCD_Start
+					Frame_Present 之后主循环不用等DMA2D, 可以去做别的事, 下一次
+					Frame_Begin 才等待换帧完成.
+  * Function List:
+  *		Frame_Init
+  *		Frame_Begin
+  *		Frame_Present
+  *		Frame_GetStats
+  *		LCD_Handler
+  **********************************************************
+ */
+
+#include "lcd_frame.h"
+
+typedef struct {
+    uint32_t fb[2];
+    volatile uint8_t front;			//正在扫描的缓冲下标
+    volatile uint8_t pending;		//后台已提交, 等待切换
+    DMA2DQ_Fence_t fence;
+} Frame_Handle;
+
+static Frame_Handle frame;
+static Frame_Stats frame_stats;
+
+void Frame_Init(uint32_t buf0, uint32_t buf1) {
+    frame.fb[0] = buf0;
+    frame.fb[1] = buf1;
+    frame.front = 0;
+    frame.pending = 0;
+    frame.fence = 0;
+    frame_stats.Scanned = 0;
+    frame_stats.Shown = 0;
+    frame_stats.Late = 0;
+
+    LCD->L[0].ADDR = buf0;
+    LCD_Start(LCD);
+}
+
+//换帧完成后后台缓冲不再被扫描, 可以开始画下一帧
+uint32_t Frame_Begin(void) {
+    while(frame.pending) __NOP();
+
+    return frame.fb[frame.front ^ 1];
+}
+
+void Frame_Present(DMA2DQ_Fence_t fence) {
+    frame.fence = fence;
+    __DMB();
+    frame.pending = 1;
+}
+
+void Frame_GetStats(Frame_Stats * stats) {
+    *stats = frame_stats;
+}
+
+void LCD_Handler(void) {
+    LCD_INTClr(LCD);
+    frame_stats.Scanned++;
+
+    if(frame.pending) {
+        if(DMA2DQ_FenceDone(frame.fence)) {
+            frame.front ^= 1;
+            LCD->L[0].ADDR = frame.fb[frame.front];
+            frame.pending = 0;
+            frame_stats.Shown++;
+        } else {
+            frame_stats.Late++;
+        }
+    }
+
+    LCD_Start(LCD);
+}
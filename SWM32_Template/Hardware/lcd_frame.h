@@ -0,0 +1,39 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : lcd_frame.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : SWM341 RGB屏双缓冲帧同步, 渲染第N+1帧与扫描第N帧重叠进行
+  * Function List:
+  *		Frame_Init
+  *		Frame_Begin
+  *		Frame_Present
+  *		Frame_GetStats
+  ******************************************************
+**/
+
+#ifndef __LCD_FRAME_H_
+#define __LCD_FRAME_H_
+
+#include "SWM341.h"
+#include "dma2d_queue.h"
+
+typedef struct {
+    uint32_t Scanned;		//LCD扫描完成的帧数
+    uint32_t Shown;			//切换显示的新帧数
+    uint32_t Late;			//新帧已提交但DMA2D还没画完, 重复显示旧帧的次数
+} Frame_Stats;
+
+void Frame_Init(uint32_t buf0, uint32_t buf1);	// LCD须已用 IntEOTEn=1, DataSource=buf0 初始化; 启动第一帧扫描
+uint32_t Frame_Begin(void);		// 等待后台缓冲空闲, 返回其地址
+void Frame_Present(DMA2DQ_Fence_t fence);	// 提交后台缓冲, fence 完成后在下一帧开始显示
+void Frame_GetStats(Frame_Stats * stats);	// 读取统计信息
+
+#endif
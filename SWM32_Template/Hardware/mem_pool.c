@@ -0,0 +1,353 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : mem_pool.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					C库只有一个堆, SDRAM_Init 之后也只能把它整个交给这个堆.
+					这里每个区域(内部SRAM、SDRAM)分成 MEM_PAGE_SIZE 的页, 页表放在
+					区域开头, 每页一项, 记录页所在连续段(run)的类型和长度:
+					  - 空闲段在首页和末页都记长度, 释放时前后相邻的空闲段O(1)合并;
+					  - 大于 MEM_CLASS_MAX 的申请取一段整页, 从上次分配处向后按段跳跃查找;
+					  - 小对象按2的幂分成 MEM_CLASS_NUM 个级别, 每级一条有空闲对象的页链表,
+					    链表空了才取一页切成同尺寸的对象, 分配和释放都是O(1).
+					每个slab页有自己的空闲链表, 表头和页内在用的对象数记在页表项里;
+					还有空闲对象的页按级别串成双向链表, 所以页满、页空时进出链表也是O(1).
+					页内对象全部释放后页归还页堆, 但每级留一页空页作缓存, 在页边界上
+					反复申请释放不会每次都重新切页; 页堆不够时先收回这些缓存页.
+					网络缓冲区、帧这类固定尺寸对象只要还有一个在用, 所在页就不动,
+					反复申请释放不产生碎片. 不可重入, 不能在中断中调用.
+  * Function List:
+  *		Mem_AddRegion
+  *		Mem_Alloc
+  *		Mem_Free
+  *		Mem_GetStats
+  **********************************************************
+ */
+
+#include <string.h>
+#include "mem_pool.h"
+
+//页表项: [31:28]类型 [27:24]级别 [23:0]段长(页)
+//slab页段长固定为1, [23:12]是页内空闲链表头(对象序号), [11:0]是页内在用的对象数
+#define MEM_T_FREE          0x00000000u
+#define MEM_T_SLAB          0x10000000u
+#define MEM_T_LARGE         0x20000000u
+#define MEM_T_CONT          0x30000000u		//大块的末页, 防止被当作空闲段的末页
+#define MEM_TYPE(e)         ((e) & 0xF0000000u)
+#define MEM_CLS(e)          (((e) >> 24) & 0x0Fu)
+#define MEM_LEN(e)          ((e) & 0x00FFFFFFu)
+#define MEM_RUN(e)          ((MEM_TYPE(e) == MEM_T_SLAB) ? 1 : MEM_LEN(e))
+#define MEM_HEAD(e)         (((e) >> 12) & 0xFFFu)
+#define MEM_LIVE(e)         ((e) & 0xFFFu)
+#define MEM_IDX_END         0xFFFu			//页内空闲链表结束, 页已满
+
+#define MEM_ALIGN           32
+#define MEM_NONE            0xFFFFFFFFu
+
+//slab页在本级别"有空闲对象的页"链表中的前后页号
+typedef struct {
+    uint32_t Prev;
+    uint32_t Next;
+} Mem_Link;
+
+typedef struct {
+    uint8_t * Base;             //第一页
+    uint32_t * Map;              //页表
+    Mem_Link * Link;             //每页一项, 只对slab页有效
+    uint32_t Pages;
+    uint32_t Hint;              //下次查找大块的起点, 总是某一段的首页
+    uint8_t  Kind;
+    uint32_t Part[MEM_CLASS_NUM];   //有空闲对象的slab页链表头
+    uint32_t Empty[MEM_CLASS_NUM];  //留作缓存的空页(也在 Part 链表中)
+    Mem_Stats Stats;
+} Mem_Region;
+
+static Mem_Region mem_region[MEM_REGION_MAX];
+static uint8_t mem_region_cnt;
+
+//把 [head, head+len) 记为一个空闲段
+static void Mem_SetFree(Mem_Region * r, uint32_t head, uint32_t len) {
+    r->Map[head] = MEM_T_FREE | len;
+    r->Map[head + len - 1] = MEM_T_FREE | len;
+}
+
+//从页堆取 n 页, 失败返回 MEM_NONE
+static uint32_t Mem_PageAlloc(Mem_Region * r, uint32_t n) {
+    uint32_t i = r->Hint;
+    uint32_t seen = 0;
+    uint32_t e, len;
+
+    if(n > r->Stats.FreePages) return MEM_NONE;
+
+    while(seen < r->Pages) {
+        e = r->Map[i];
+        len = MEM_RUN(e);
+
+        if((MEM_TYPE(e) == MEM_T_FREE) && (len >= n)) {
+            if(len > n) Mem_SetFree(r, i + n, len - n);
+
+            r->Map[i] = MEM_T_LARGE | n;
+
+            if(n > 1) r->Map[i + n - 1] = MEM_T_CONT | n;
+
+            r->Hint = (i + n < r->Pages) ? (i + n) : 0;
+            r->Stats.FreePages -= n;
+            return i;
+        }
+
+        seen += len;
+        i += len;
+
+        if(i >= r->Pages) i = 0;
+    }
+
+    return MEM_NONE;
+}
+
+//归还从 head 开始的 len 页, 与前后空闲段合并
+static void Mem_PageFree(Mem_Region * r, uint32_t head, uint32_t len) {
+    uint32_t e;
+
+    r->Stats.FreePages += len;
+
+    if(head + len < r->Pages) {
+        e = r->Map[head + len];
+
+        if(MEM_TYPE(e) == MEM_T_FREE) {
+            if(r->Hint == head + len) r->Hint = head;
+
+            len += MEM_LEN(e);
+        }
+    }
+
+    if(head > 0) {
+        e = r->Map[head - 1];
+
+        if(MEM_TYPE(e) == MEM_T_FREE) {
+            head -= MEM_LEN(e);
+            len += MEM_LEN(e);
+
+            if((r->Hint > head) && (r->Hint < head + len)) r->Hint = head;
+        }
+    }
+
+    Mem_SetFree(r, head, len);
+}
+
+//把slab页 page 挂到第 cls 级 Part 链表头
+static void Mem_PartPush(Mem_Region * r, uint32_t cls, uint32_t page) {
+    r->Link[page].Prev = MEM_NONE;
+    r->Link[page].Next = r->Part[cls];
+
+    if(r->Part[cls] != MEM_NONE) r->Link[r->Part[cls]].Prev = page;
+
+    r->Part[cls] = page;
+}
+
+static void Mem_PartUnlink(Mem_Region * r, uint32_t cls, uint32_t page) {
+    Mem_Link * l = &r->Link[page];
+
+    if(l->Prev != MEM_NONE) r->Link[l->Prev].Next = l->Next;
+    else r->Part[cls] = l->Next;
+
+    if(l->Next != MEM_NONE) r->Link[l->Next].Prev = l->Prev;
+}
+
+//第 cls 级的空页 page 归还页堆
+static void Mem_SlabRelease(Mem_Region * r, uint32_t cls, uint32_t page) {
+    Mem_PartUnlink(r, cls, page);
+    r->Stats.SlabPages--;
+    Mem_PageFree(r, page, 1);
+}
+
+//把各级别缓存的空页还给页堆, 返回还回的页数
+static uint32_t Mem_Reclaim(Mem_Region * r) {
+    uint32_t cls, n = 0;
+
+    for(cls = 0; cls < MEM_CLASS_NUM; cls++) {
+        if(r->Empty[cls] != MEM_NONE) {
+            Mem_SlabRelease(r, cls, r->Empty[cls]);
+            r->Empty[cls] = MEM_NONE;
+            n++;
+        }
+    }
+
+    return n;
+}
+
+//取 n 页, 页堆不够时收回缓存的空slab页再试一次
+static uint32_t Mem_PageGet(Mem_Region * r, uint32_t n) {
+    uint32_t page = Mem_PageAlloc(r, n);
+
+    if((page == MEM_NONE) && (Mem_Reclaim(r) != 0)) page = Mem_PageAlloc(r, n);
+
+    return page;
+}
+
+//取一页切成第 cls 级的对象: 每个空闲对象的第一个字是页内下一个空闲对象的序号
+static uint8_t Mem_Refill(Mem_Region * r, uint32_t cls) {
+    uint32_t size = MEM_CLASS_MIN << cls;
+    uint32_t num = MEM_PAGE_SIZE / size;
+    uint32_t page = Mem_PageGet(r, 1);
+    uint8_t * p;
+    uint32_t i;
+
+    if(page == MEM_NONE) return 0;
+
+    p = r->Base + page * MEM_PAGE_SIZE;
+
+    for(i = 0; i < num; i++) *(uint32_t *)(p + i * size) = (i + 1 < num) ? (i + 1) : MEM_IDX_END;
+
+    r->Map[page] = MEM_T_SLAB | (cls << 24);		//表头为0号对象, 没有在用对象
+    r->Stats.SlabPages++;
+    Mem_PartPush(r, cls, page);
+
+    return 1;
+}
+
+static void * Mem_RegionAlloc(Mem_Region * r, uint32_t size) {
+    uint32_t cls = 0;
+    uint32_t page, e, next;
+    uint8_t * p;
+
+    if(size <= MEM_CLASS_MAX) {
+        while(((uint32_t)MEM_CLASS_MIN << cls) < size) cls++;
+
+        if((r->Part[cls] == MEM_NONE) && (Mem_Refill(r, cls) == 0)) return NULL;
+
+        page = r->Part[cls];
+        e = r->Map[page];
+        p = r->Base + page * MEM_PAGE_SIZE + MEM_HEAD(e) * (MEM_CLASS_MIN << cls);
+        next = *(uint32_t *)p;
+        r->Map[page] = (e & 0xFF000000u) | (next << 12) | (MEM_LIVE(e) + 1);
+
+        if(r->Empty[cls] == page) r->Empty[cls] = MEM_NONE;
+
+        if(next == MEM_IDX_END) Mem_PartUnlink(r, cls, page);
+
+        r->Stats.ClassInUse[cls]++;
+        r->Stats.InUse += MEM_CLASS_MIN << cls;
+    } else {
+        page = Mem_PageGet(r, (size + MEM_PAGE_SIZE - 1) / MEM_PAGE_SIZE);
+
+        if(page == MEM_NONE) return NULL;
+
+        p = r->Base + page * MEM_PAGE_SIZE;
+        r->Stats.InUse += MEM_LEN(r->Map[page]) * MEM_PAGE_SIZE;
+    }
+
+    r->Stats.Allocs++;
+
+    if(r->Stats.InUse > r->Stats.Peak) r->Stats.Peak = r->Stats.InUse;
+
+    return p;
+}
+
+uint8_t Mem_AddRegion(void * base, uint32_t size, uint8_t kind) {
+    Mem_Region * r;
+    uintptr_t start = (uintptr_t)base;
+    uintptr_t first;
+    uint32_t cls;
+
+    if((mem_region_cnt >= MEM_REGION_MAX) || (size < MEM_PAGE_SIZE + 2 * MEM_ALIGN)) return 0xFF;
+
+    r = &mem_region[mem_region_cnt];
+    memset(r, 0, sizeof(Mem_Region));
+
+    //页表和链表每页 4+8 字节, 对齐留 2*MEM_ALIGN 余量
+    start = (start + 3) & ~(uintptr_t)3;
+    r->Pages = (uint32_t)((size - 2 * MEM_ALIGN) / (MEM_PAGE_SIZE + 4 + sizeof(Mem_Link)));
+    first = (start + r->Pages * (4 + sizeof(Mem_Link)) + MEM_ALIGN - 1) & ~(uintptr_t)(MEM_ALIGN - 1);
+    r->Map = (uint32_t *)start;
+    r->Link = (Mem_Link *)(start + r->Pages * 4);
+    r->Base = (uint8_t *)first;
+    r->Kind = kind & ~MEM_STRICT;
+    r->Stats.Pages = r->Pages;
+    r->Stats.FreePages = r->Pages;
+    Mem_SetFree(r, 0, r->Pages);
+
+    for(cls = 0; cls < MEM_CLASS_NUM; cls++) {
+        r->Part[cls] = MEM_NONE;
+        r->Empty[cls] = MEM_NONE;
+    }
+
+    return mem_region_cnt++;
+}
+
+void * Mem_Alloc(uint32_t size, uint8_t kind) {
+    uint8_t want = kind & ~MEM_STRICT;
+    uint8_t pass, i;
+    void * p;
+
+    if(size == 0) return NULL;
+
+    for(pass = 0; pass < ((kind & MEM_STRICT) ? 1 : 2); pass++) {
+        for(i = 0; i < mem_region_cnt; i++) {
+            if((mem_region[i].Kind == want) == (pass == 0)) {
+                p = Mem_RegionAlloc(&mem_region[i], size);
+
+                if(p != NULL) return p;
+
+                mem_region[i].Stats.Fails++;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+void Mem_Free(void * p) {
+    Mem_Region * r;
+    uint32_t page, e, cls, idx;
+    uint8_t i;
+
+    for(i = 0; i < mem_region_cnt; i++) {
+        r = &mem_region[i];
+
+        if(((uint8_t *)p >= r->Base) && ((uint8_t *)p < r->Base + r->Pages * MEM_PAGE_SIZE)) break;
+    }
+
+    if(i == mem_region_cnt) return;
+
+    page = (uint32_t)((uint8_t *)p - r->Base) / MEM_PAGE_SIZE;
+    e = r->Map[page];
+
+    if(MEM_TYPE(e) == MEM_T_SLAB) {
+        cls = MEM_CLS(e);
+        idx = (uint32_t)((uint8_t *)p - (r->Base + page * MEM_PAGE_SIZE)) / (MEM_CLASS_MIN << cls);
+        *(uint32_t *)p = MEM_HEAD(e);
+        r->Map[page] = (e & 0xFF000000u) | (idx << 12) | (MEM_LIVE(e) - 1);
+        r->Stats.ClassInUse[cls]--;
+        r->Stats.InUse -= MEM_CLASS_MIN << cls;
+
+        if(MEM_HEAD(e) == MEM_IDX_END) Mem_PartPush(r, cls, page);		//满页又有了空闲对象
+
+        //页空了: 每级留一页作缓存, 多出的归还页堆
+        if(MEM_LIVE(e) == 1) {
+            if(r->Empty[cls] == MEM_NONE) r->Empty[cls] = page;
+            else Mem_SlabRelease(r, cls, page);
+        }
+    } else if((MEM_TYPE(e) == MEM_T_LARGE) && ((uint8_t *)p == r->Base + page * MEM_PAGE_SIZE)) {
+        r->Stats.InUse -= MEM_LEN(e) * MEM_PAGE_SIZE;
+        Mem_PageFree(r, page, MEM_LEN(e));
+    } else {
+        return;
+    }
+
+    r->Stats.Frees++;
+}
+
+void Mem_GetStats(uint8_t region, Mem_Stats * stats) {
+    if(region < mem_region_cnt) *stats = mem_region[region].Stats;
+    else memset(stats, 0, sizeof(Mem_Stats));
+}
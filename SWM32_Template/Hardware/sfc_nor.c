@@ -0,0 +1,307 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : sfc_nor.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					库函数 SFC_Write 只能写同一页内字对齐的数据, 每次都等 SFC_SR_BUSY
+					清零才返回; SFC_Read 通过 volatile 指针逐字读取.
+					这里把写入的数据按页合并进页缓冲(与Flash一样按位与), 写满一页或写到
+					别的页时才提交, 零散的小写入因此合并成一次页编程. 已提交的页编程和
+					擦除放在队列里, 由 SFCN_Poll 查询完成后启动下一项, CPU不用等待.
+					读取先等Flash空闲, 短的或不对齐的用memcpy整块读, 长的用DMA.
+					队列只能在主循环中写入, SFCN_Poll 可以在定时器中断中调用.
+  * Function List:
+  *		SFCN_Init
+  *		SFCN_Write
+  *		SFCN_Flush
+  *		SFCN_Erase
+  *		SFCN_Poll
+  *		SFCN_Idle
+  *		SFCN_Sync
+  *		SFCN_Read
+  *		SFCN_ReadDMA
+  *		SFCN_ReadDone
+  *		SFCN_GetStats
+  **********************************************************
+ */
+
+#include <string.h>
+#include "sfc_nor.h"
+#include "SWM341_sfc.h"
+#include "SWM341_dma.h"
+
+#define SFCN_MASK			(SFCN_QUEUE_LEN - 1)
+#define SFCN_PAGE_WORDS		(SFCN_PAGE_SIZE / 4)
+
+#define SFCN_OP_PROG		0
+#define SFCN_OP_ERASE		1
+
+typedef struct {
+    uint8_t  op;
+    uint8_t  cmd;			//擦除命令码
+    uint8_t  first;			//页内要编程的第一个字
+    uint8_t  last;			//页内要编程的最后一个字
+    uint32_t addr;			//页地址或擦除地址
+    uint32_t data[SFCN_PAGE_WORDS];
+} SFCN_Op;
+
+static SFCN_Op ring[SFCN_QUEUE_LEN];
+static volatile uint32_t ring_wr;		//主循环写, 已提交的操作数
+static volatile uint32_t ring_rd;		//SFCN_Poll 写, 已完成的操作数
+static volatile uint8_t sfc_busy;		//Flash正在执行 ring[ring_rd]
+static volatile uint8_t dma_busy;		//DMA读取进行中, 不能启动编程
+static uint8_t page_open;				//ring[ring_wr] 是正在合并的页缓冲
+static uint32_t dma_ch;
+static SFCN_Stats sfcn_stats;
+
+//启动一项操作, 调用时中断已关闭.
+//页编程的数据通过AHB写入SFC的FIFO, 中途被中断打断导致FIFO取空会把一页拆成两次编程, 所以整页连续写入
+static void SFCN_Start(SFCN_Op * op) {
+    uint32_t i;
+
+    if(op->op == SFCN_OP_PROG) {
+        SFC->CFG |= (1 << SFC_CFG_WREN_Pos);
+
+        for(i = op->first; i <= op->last; i++)
+            *((volatile uint32_t *)(SFLASH_BASE + op->addr + i * 4)) = op->data[i];
+    } else {
+        SFC_EraseEx(op->addr, op->cmd, 0);
+    }
+}
+
+//Flash空闲且队列中还有操作时启动下一项, 调用时中断已关闭
+static void SFCN_Kick(void) {
+    if(sfc_busy || dma_busy || (ring_rd == ring_wr)) return;
+
+    sfc_busy = 1;
+    SFCN_Start(&ring[ring_rd & SFCN_MASK]);
+}
+
+//取得一个空位, 队列满时等已提交的操作完成
+static SFCN_Op * SFCN_Alloc(void) {
+    uint32_t wr = ring_wr;
+
+    if(wr - ring_rd >= SFCN_QUEUE_LEN) {
+        sfcn_stats.QueueFull++;
+
+        while(wr - ring_rd >= SFCN_QUEUE_LEN) SFCN_Poll();
+    }
+
+    return &ring[wr & SFCN_MASK];
+}
+
+//提交 ring[ring_wr], Flash空闲时立即启动
+static void SFCN_Commit(void) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    ring_wr = ring_wr + 1;
+    SFCN_Kick();
+    __set_PRIMASK(primask);
+}
+
+void SFCN_Init(uint32_t dma_chn) {
+    ring_wr = 0;
+    ring_rd = 0;
+    sfc_busy = 0;
+    dma_busy = 0;
+    page_open = 0;
+    dma_ch = dma_chn;
+    memset(&sfcn_stats, 0, sizeof(sfcn_stats));
+}
+
+void SFCN_Write(uint32_t addr, const void * data, uint32_t len) {
+    const uint8_t * src = (const uint8_t *)data;
+    SFCN_Op * op = &ring[ring_wr & SFCN_MASK];
+    uint32_t page, off, n, i;
+    uint8_t * dst;
+
+    sfcn_stats.Writes++;
+    sfcn_stats.Bytes += len;
+
+    while(len) {
+        page = addr & ~(SFCN_PAGE_SIZE - 1);
+        off = addr & (SFCN_PAGE_SIZE - 1);
+        n = SFCN_PAGE_SIZE - off;
+
+        if(n > len) n = len;
+
+        if(page_open && (op->addr != page)) {
+            SFCN_Flush();
+        }
+
+        if(page_open == 0) {
+            op = SFCN_Alloc();
+            op->op = SFCN_OP_PROG;
+            op->addr = page;
+            op->first = SFCN_PAGE_WORDS - 1;
+            op->last = 0;
+            memset(op->data, 0xFF, SFCN_PAGE_SIZE);
+            page_open = 1;
+        }
+
+        //与Flash编程一样只能把1改成0, 同一字节写两次的结果与直接编程两次相同
+        dst = (uint8_t *)op->data + off;
+
+        for(i = 0; i < n; i++)
+            dst[i] &= src[i];
+
+        if(op->first > off / 4) op->first = off / 4;
+
+        if(op->last < (off + n - 1) / 4) op->last = (off + n - 1) / 4;
+
+        if(off + n == SFCN_PAGE_SIZE) {
+            if(op->first == 0) sfcn_stats.FullPages++;
+
+            SFCN_Flush();
+        }
+
+        addr += n;
+        src += n;
+        len -= n;
+    }
+}
+
+void SFCN_Flush(void) {
+    if(page_open == 0) return;
+
+    page_open = 0;
+    sfcn_stats.Programs++;
+    SFCN_Commit();
+}
+
+void SFCN_Erase(uint32_t addr, uint8_t cmd) {
+    SFCN_Op * op;
+
+    SFCN_Flush();		//先于擦除写入的数据要先编程, 否则擦除后再编程进去
+
+    op = SFCN_Alloc();
+    op->op = SFCN_OP_ERASE;
+    op->cmd = cmd;
+    op->addr = addr;
+    sfcn_stats.Erases++;
+    SFCN_Commit();
+}
+
+//页编程由SFC硬件查询WIP, 看 SFC_SR_BUSY 即可; 擦除与库函数 SFC_EraseEx 一样读状态寄存器
+void SFCN_Poll(void) {
+    uint32_t primask = __get_PRIMASK();
+    SFCN_Op * op;
+
+    __disable_irq();
+
+    if(sfc_busy) {
+        op = &ring[ring_rd & SFCN_MASK];
+
+        if(op->op == SFCN_OP_PROG ? (SFC->SR & SFC_SR_BUSY_Msk) == 0 : SFC_FlashBusy() == 0) {
+            if(op->op == SFCN_OP_PROG) SFC->CFG &= ~SFC_CFG_WREN_Msk;
+
+            sfc_busy = 0;
+            ring_rd = ring_rd + 1;
+            SFCN_Kick();
+        }
+    }
+
+    __set_PRIMASK(primask);
+}
+
+uint32_t SFCN_Idle(void) {
+    return (ring_rd == ring_wr) ? 1 : 0;
+}
+
+void SFCN_Sync(void) {
+    SFCN_Flush();
+
+    while(SFCN_Idle() == 0) SFCN_Poll();
+}
+
+void SFCN_Read(uint32_t addr, void * buff, uint32_t len) {
+    SFCN_Op * op = &ring[ring_wr & SFCN_MASK];
+    uint8_t * dst = (uint8_t *)buff;
+    uint32_t start, end, i;
+
+    while(SFCN_ReadDone() == 0) __NOP();
+
+    while(SFCN_Idle() == 0) SFCN_Poll();	//编程或擦除期间Flash不能读
+
+    if((len >= SFCN_DMA_MIN) && (((addr | (uint32_t)buff | len) & 3) == 0)) {
+        SFCN_ReadDMA(addr, buff, len);
+
+        while(SFCN_ReadDone() == 0) __NOP();
+    } else {
+        memcpy(buff, (const void *)(SFLASH_BASE + addr), len);
+    }
+
+    //叠加页缓冲中还没编程的数据
+    if(page_open) {
+        start = (addr > op->addr) ? addr : op->addr;
+        end = ((addr + len) < (op->addr + SFCN_PAGE_SIZE)) ? (addr + len) : (op->addr + SFCN_PAGE_SIZE);
+
+        for(i = start; i < end; i++)
+            dst[i - addr] &= ((uint8_t *)op->data)[i - op->addr];
+    }
+}
+
+void SFCN_ReadDMA(uint32_t addr, void * buff, uint32_t len) {
+    DMA_InitStructure DMA_initStruct;
+    uint32_t primask;
+
+    while(SFCN_ReadDone() == 0) __NOP();
+
+    while(SFCN_Idle() == 0) SFCN_Poll();
+
+    if(len == 0) return;
+
+    //字对齐时按字搬运, 否则按字节; 一次最多 0x100000 个单位, 字对齐时够读4MB
+    DMA_initStruct.Mode = DMA_MODE_SINGLE;
+    DMA_initStruct.Unit = (((addr | (uint32_t)buff | len) & 3) == 0) ? DMA_UNIT_WORD : DMA_UNIT_BYTE;
+    DMA_initStruct.Count = (DMA_initStruct.Unit == DMA_UNIT_WORD) ? len / 4 : len;
+    DMA_initStruct.SrcAddr = SFLASH_BASE + addr;
+    DMA_initStruct.SrcAddrInc = 1;
+    DMA_initStruct.DstAddr = (uint32_t)buff;
+    DMA_initStruct.DstAddrInc = 1;
+    DMA_initStruct.Handshake = DMA_HS_NO;
+    DMA_initStruct.Priority = DMA_PRI_LOW;
+    DMA_initStruct.DoneIE = 0;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    dma_busy = 1;		//SFCN_Poll 在DMA读完前不启动新的编程
+    __set_PRIMASK(primask);
+
+    DMA_CH_Init(dma_ch, &DMA_initStruct);
+    DMA_CH_Open(dma_ch);
+    sfcn_stats.DMAReads++;
+}
+
+uint32_t SFCN_ReadDone(void) {
+    uint32_t primask;
+
+    if(dma_busy == 0) return 1;
+
+    if(DMA_CH_INTStat(dma_ch) == 0) return 0;
+
+    DMA_CH_INTClr(dma_ch);
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    dma_busy = 0;
+    SFCN_Kick();
+    __set_PRIMASK(primask);
+
+    return 1;
+}
+
+void SFCN_GetStats(SFCN_Stats * stats) {
+    *stats = sfcn_stats;
+}
@@ -0,0 +1,61 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : sfc_nor.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : SWM341 SFC外部NOR Flash驱动: 任意长度/对齐写入按页拆分并合并成整页,
+  *				   页编程和擦除异步完成, 大块读取走DMA
+  * Function List:
+  *		SFCN_Init
+  *		SFCN_Write
+  *		SFCN_Flush
+  *		SFCN_Erase
+  *		SFCN_Poll
+  *		SFCN_Idle
+  *		SFCN_Sync
+  *		SFCN_Read
+  *		SFCN_ReadDMA
+  *		SFCN_ReadDone
+  *		SFCN_GetStats
+  ******************************************************
+**/
+
+#ifndef __SFC_NOR_H_
+#define __SFC_NOR_H_
+
+#include "SWM341.h"
+
+#define SFCN_PAGE_SIZE		256		//Flash页大小, 一次页编程不能跨页
+#define SFCN_QUEUE_LEN		4		//等待编程/擦除的操作数, 2的幂, 每项占一页缓冲
+#define SFCN_DMA_MIN		64		//不少于这么多字节且字对齐的读取才用DMA, 更短的直接memcpy
+
+typedef struct {
+    uint32_t Writes;		//SFCN_Write 调用次数
+    uint32_t Bytes;			//写入的字节数
+    uint32_t Programs;		//实际发出的页编程次数, 与 Writes 之比即合并效果
+    uint32_t FullPages;		//写满整页的页编程次数
+    uint32_t Erases;		//擦除次数
+    uint32_t QueueFull;		//提交时队列满而等待的次数
+    uint32_t DMAReads;		//走DMA的读取次数
+} SFCN_Stats;
+
+void SFCN_Init(uint32_t dma_chn);	// SFC须已用 SFC_Init 初始化; dma_chn 为读取用的DMA通道
+void SFCN_Write(uint32_t addr, const void * data, uint32_t len);	// 任意地址和长度, 数据先合并进页缓冲, 满页或换页时提交编程
+void SFCN_Flush(void);				// 提交未写满的页缓冲, 不等待编程完成
+void SFCN_Erase(uint32_t addr, uint8_t cmd);	// 提交页缓冲后排队擦除, cmd 为 SFC_CMD_ERASE_xxx, addr 为 0xFFFFFFFF 时片擦
+void SFCN_Poll(void);				// 查询编程/擦除是否完成并启动下一项, 在定时器中断或主循环中周期调用
+uint32_t SFCN_Idle(void);			// 已提交的操作全部完成返回1
+void SFCN_Sync(void);				// 提交页缓冲并等待全部操作完成
+void SFCN_Read(uint32_t addr, void * buff, uint32_t len);	// 同步读取, 包含还在页缓冲中未编程的数据
+void SFCN_ReadDMA(uint32_t addr, void * buff, uint32_t len);	// 启动读取后立即返回, 用 SFCN_ReadDone 查询; 不包含页缓冲中的数据
+uint32_t SFCN_ReadDone(void);		// SFCN_ReadDMA 启动的读取已完成返回1
+void SFCN_GetStats(SFCN_Stats * stats);	// 读取统计信息
+
+#endif
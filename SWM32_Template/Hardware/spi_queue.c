@@ -0,0 +1,252 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : spi_queue.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					库函数 SPI_ReadWrite/SPI_WriteWithWait 每个数据都要CPU等待.
+					这里每一段由两个DMA通道搬运: 发送通道按SPI发送FIFO的握手把TxBuf(或固定的0xFF)
+					写入DATA, 接收通道把DATA读到RxBuf(或丢弃). 接收通道搬完最后一个数据时
+					整段已经移出移入完毕, 在其完成中断中启动同一事务的下一段, 或者释放片选,
+					按下一个事务的器件切换CPHA/CPOL/分频/字长后拉低其片选开始第一段.
+					事务可以在主循环和完成回调中提交.
+					DMA只有一个中断 DMA_Handler, 在本文件中实现; 其他模块只能查询方式使用DMA.
+  * Function List:
+  *		SPIQ_Init
+  *		SPIQ_DevInit
+  *		SPIQ_Submit
+  *		SPIQ_Idle
+  *		SPIQ_GetStats
+  *		DMA_Handler
+  **********************************************************
+ */
+
+#include "spi_queue.h"
+#include "SWM341_spi.h"
+#include "SWM341_dma.h"
+#include "SWM341_gpio.h"
+
+#define SPIQ_CTRL_MASK		(SPI_CTRL_CPHA_Msk | SPI_CTRL_CPOL_Msk | SPI_CTRL_SIZE_Msk | \
+                             SPI_CTRL_CLKDIV_Msk | SPI_CTRL_FAST_Msk | SPI_CTRL_NSYNC_Msk)
+#define SPIQ_CTRL_NONE		0xFFFFFFFF
+
+static SPI_TypeDef * spiq_spi;
+static uint32_t spiq_tx_chn;
+static uint32_t spiq_rx_chn;
+static uint8_t  spiq_tx_hs;
+static uint8_t  spiq_rx_hs;
+static uint32_t spiq_ctrl;				//上一个器件的CTRL时序位
+
+static SPIQ_Trans * spiq_head;			//正在执行的事务, 其后是等待的事务
+static SPIQ_Trans * spiq_tail;
+static uint32_t spiq_depth;
+static SPIQ_Stats spiq_stats;
+
+static const uint16_t spiq_dummy = 0xFFFF;
+static uint16_t spiq_sink;
+
+//SPIx 的发送/接收握手信号在通道 chn 上的取值, 不可用返回0
+static uint8_t SPIQ_Handshake(SPI_TypeDef * SPIx, uint32_t chn, uint32_t rx) {
+    if(SPIx == SPI0) {
+        if(rx) return (chn == DMA_CH1) ? DMA_CH1_SPI0RX : (chn == DMA_CH2) ? DMA_CH2_SPI0RX : 0;
+        else   return (chn == DMA_CH0) ? DMA_CH0_SPI0TX : (chn == DMA_CH3) ? DMA_CH3_SPI0TX : 0;
+    }
+
+    if(SPIx == SPI1) {
+        if(rx) return (chn == DMA_CH0) ? DMA_CH0_SPI1RX : (chn == DMA_CH3) ? DMA_CH3_SPI1RX : 0;
+        else   return (chn == DMA_CH1) ? DMA_CH1_SPI1TX : (chn == DMA_CH2) ? DMA_CH2_SPI1TX : 0;
+    }
+
+    return 0;
+}
+
+//器件对应的CTRL时序位, 与 SPI_Init 的计算相同
+static uint32_t SPIQ_Ctrl(const SPIQ_Device * dev) {
+    uint32_t fast = (dev->clkDiv == SPI_CLKDIV_2) ? 1 : 0;
+    uint32_t no_sync = (dev->clkDiv == SPI_CLKDIV_2 || dev->clkDiv == SPI_CLKDIV_4) ? 1 : 0;
+
+    return (dev->SampleEdge       << SPI_CTRL_CPHA_Pos)   |
+           (dev->IdleLevel        << SPI_CTRL_CPOL_Pos)   |
+           ((dev->WordSize - 1)   << SPI_CTRL_SIZE_Pos)   |
+           (fast                  << SPI_CTRL_FAST_Pos)   |
+           (no_sync               << SPI_CTRL_NSYNC_Pos)  |
+           ((dev->clkDiv & 7)     << SPI_CTRL_CLKDIV_Pos);
+}
+
+//启动正在执行事务的第 SegIdx 段, 片选已经有效
+static void SPIQ_StartSeg(void) {
+    const SPIQ_Trans * trans = spiq_head;
+    const SPIQ_Segment * seg = &trans->Seg[trans->SegIdx];
+    DMA_InitStructure DMA_initStruct;
+
+    DMA_initStruct.Mode = DMA_MODE_SINGLE;
+    DMA_initStruct.Unit = (trans->Dev->WordSize > 8) ? DMA_UNIT_HALFWORD : DMA_UNIT_BYTE;
+    DMA_initStruct.Count = seg->Count;
+    DMA_initStruct.Priority = DMA_PRI_HIGH;
+
+    //先开接收通道, 第一个数据移入时它必须已经在等待
+    DMA_initStruct.SrcAddr = (uint32_t)&spiq_spi->DATA;
+    DMA_initStruct.SrcAddrInc = 0;
+    DMA_initStruct.DstAddr = seg->RxBuf ? (uint32_t)seg->RxBuf : (uint32_t)&spiq_sink;
+    DMA_initStruct.DstAddrInc = seg->RxBuf ? 1 : 0;
+    DMA_initStruct.Handshake = spiq_rx_hs;
+    DMA_initStruct.DoneIE = 1;
+    DMA_CH_Init(spiq_rx_chn, &DMA_initStruct);
+
+    DMA_initStruct.SrcAddr = seg->TxBuf ? (uint32_t)seg->TxBuf : (uint32_t)&spiq_dummy;
+    DMA_initStruct.SrcAddrInc = seg->TxBuf ? 1 : 0;
+    DMA_initStruct.DstAddr = (uint32_t)&spiq_spi->DATA;
+    DMA_initStruct.DstAddrInc = 0;
+    DMA_initStruct.Handshake = spiq_tx_hs;
+    DMA_initStruct.DoneIE = 0;
+    DMA_CH_Init(spiq_tx_chn, &DMA_initStruct);
+
+    spiq_stats.Segments++;
+
+    DMA_CH_Open(spiq_rx_chn);
+    DMA_CH_Open(spiq_tx_chn);
+}
+
+//按队首事务的器件切换时序, 拉低片选, 启动第一段
+static void SPIQ_StartTrans(void) {
+    SPIQ_Trans * trans = spiq_head;
+    uint32_t ctrl = SPIQ_Ctrl(trans->Dev);
+
+    //时序位只能在SPI关闭时修改
+    if(ctrl != spiq_ctrl) {
+        SPI_Close(spiq_spi);
+        spiq_spi->CTRL = (spiq_spi->CTRL & ~SPIQ_CTRL_MASK) | ctrl;
+        SPI_Open(spiq_spi);
+        spiq_ctrl = ctrl;
+        spiq_stats.ModeSwitches++;
+    }
+
+    trans->State = SPIQ_ACTIVE;
+    trans->SegIdx = 0;
+
+    GPIO_AtomicClrBit(trans->Dev->CSPort, trans->Dev->CSPin);
+
+    SPIQ_StartSeg();
+}
+
+uint32_t SPIQ_Init(SPI_TypeDef * SPIx, uint32_t tx_chn, uint32_t rx_chn) {
+    uint8_t tx_hs = SPIQ_Handshake(SPIx, tx_chn, 0);
+    uint8_t rx_hs = SPIQ_Handshake(SPIx, rx_chn, 1);
+
+    if(tx_hs == 0 || rx_hs == 0) return 0;
+
+    spiq_spi = SPIx;
+    spiq_tx_chn = tx_chn;
+    spiq_rx_chn = rx_chn;
+    spiq_tx_hs = tx_hs;
+    spiq_rx_hs = rx_hs;
+    spiq_ctrl = SPIQ_CTRL_NONE;
+
+    spiq_head = 0;
+    spiq_tail = 0;
+    spiq_depth = 0;
+    spiq_stats.Transactions = 0;
+    spiq_stats.Segments = 0;
+    spiq_stats.Words = 0;
+    spiq_stats.ModeSwitches = 0;
+    spiq_stats.MaxDepth = 0;
+
+    DMA_CH_Close(tx_chn);
+    DMA_CH_Close(rx_chn);
+
+    //FIFO由DMA读写, 不再由CPU读写
+    SPI_Close(SPIx);
+    SPIx->CTRL |= SPI_CTRL_DMATXEN_Msk | SPI_CTRL_DMARXEN_Msk;
+    SPI_Open(SPIx);
+
+    return 1;
+}
+
+void SPIQ_DevInit(const SPIQ_Device * dev) {
+    GPIO_Init(dev->CSPort, dev->CSPin, 1, 0, 0, 0);
+    GPIO_AtomicSetBit(dev->CSPort, dev->CSPin);
+}
+
+uint32_t SPIQ_Submit(SPIQ_Trans * trans) {
+    uint32_t primask;
+    uint32_t i;
+
+    if(trans->Dev == 0 || trans->Seg == 0 || trans->SegNum == 0) return 0;
+
+    if(trans->State == SPIQ_QUEUED || trans->State == SPIQ_ACTIVE) return 0;
+
+    for(i = 0; i < trans->SegNum; i++) {
+        if(trans->Seg[i].Count == 0 || trans->Seg[i].Count > SPIQ_SEG_MAX) return 0;
+    }
+
+    trans->State = SPIQ_QUEUED;
+    trans->Next = 0;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    if(spiq_tail) spiq_tail->Next = trans;
+    else spiq_head = trans;
+
+    spiq_tail = trans;
+    spiq_depth++;
+
+    if(spiq_depth > spiq_stats.MaxDepth) spiq_stats.MaxDepth = spiq_depth;
+
+    if(spiq_head == trans) SPIQ_StartTrans();
+
+    __set_PRIMASK(primask);
+
+    return 1;
+}
+
+uint32_t SPIQ_Idle(void) {
+    return spiq_head == 0 ? 1 : 0;
+}
+
+void SPIQ_GetStats(SPIQ_Stats * stats) {
+    *stats = spiq_stats;
+}
+
+void DMA_Handler(void) {
+    SPIQ_Trans * trans = spiq_head;
+
+    if(DMA_CH_INTStat(spiq_rx_chn) == 0) return;
+
+    DMA_CH_INTClr(spiq_rx_chn);
+
+    if(trans == 0) return;
+
+    spiq_stats.Words += trans->Seg[trans->SegIdx].Count;
+    trans->SegIdx++;
+
+    if(trans->SegIdx < trans->SegNum) {
+        SPIQ_StartSeg();
+        return;
+    }
+
+    GPIO_AtomicSetBit(trans->Dev->CSPort, trans->Dev->CSPin);
+    spiq_stats.Transactions++;
+    trans->State = SPIQ_DONE;
+
+    spiq_head = trans->Next;
+    trans->Next = 0;
+
+    if(spiq_head == 0) spiq_tail = 0;
+
+    spiq_depth--;
+
+    //先让总线继续工作, 回调中提交的事务排在后面
+    if(spiq_head) SPIQ_StartTrans();
+
+    if(trans->Done) trans->Done(trans);
+}
@@ -0,0 +1,82 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : spi_queue.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : SWM341 SPI事务队列: 多个器件共用一条总线, 每个事务带自己的片选和时序,
+  *				   各段由DMA收发, 在DMA完成中断中切换片选和时序并启动下一段/下一个事务
+  * Function List:
+  *		SPIQ_Init
+  *		SPIQ_DevInit
+  *		SPIQ_Submit
+  *		SPIQ_Idle
+  *		SPIQ_GetStats
+  ******************************************************
+**/
+
+#ifndef __SPI_QUEUE_H_
+#define __SPI_QUEUE_H_
+
+#include "SWM341.h"
+
+#define SPIQ_SEG_MAX		0x100000	//每段最多的数据个数, DMA CR.LEN
+
+//事务状态
+#define SPIQ_IDLE			0
+#define SPIQ_QUEUED			1
+#define SPIQ_ACTIVE			2
+#define SPIQ_DONE			3
+
+typedef struct {
+    GPIO_TypeDef * CSPort;	//片选引脚, 低有效, 作为GPIO驱动
+    uint32_t CSPin;
+    uint8_t  SampleEdge;	//SPI_FIRST_EDGE、SPI_SECOND_EDGE
+    uint8_t  IdleLevel;		//SPI_LOW_LEVEL、SPI_HIGH_LEVEL
+    uint8_t  clkDiv;		//SPI_CLKDIV_2、SPI_CLKDIV_4、... ... 、SPI_CLKDIV_512
+    uint8_t  WordSize;		//4--16, 大于8时缓冲区按半字存放
+} SPIQ_Device;
+
+//事务中的一段, 段与段之间片选保持有效
+typedef struct {
+    const void * TxBuf;		//为0时发送0xFF
+    void * RxBuf;			//为0时丢弃收到的数据
+    uint32_t Count;			//数据个数, 1--SPIQ_SEG_MAX
+} SPIQ_Segment;
+
+typedef struct SPIQ_Trans SPIQ_Trans;
+
+struct SPIQ_Trans {
+    const SPIQ_Device * Dev;
+    const SPIQ_Segment * Seg;
+    uint16_t SegNum;
+    void (*Done)(SPIQ_Trans * trans);	//片选释放后在DMA中断中调用, 可以再次提交
+    void * Arg;
+
+    //以下由队列维护
+    volatile uint8_t State;
+    uint16_t SegIdx;
+    SPIQ_Trans * Next;
+};
+
+typedef struct {
+    uint32_t Transactions;	//完成的事务数
+    uint32_t Segments;		//启动的段数
+    uint32_t Words;			//完成的段收发的数据个数
+    uint32_t ModeSwitches;	//事务之间切换时序/速率/字长的次数
+    uint32_t MaxDepth;		//队列中(含正在执行的)同时存在的最大事务数
+} SPIQ_Stats;
+
+uint32_t SPIQ_Init(SPI_TypeDef * SPIx, uint32_t tx_chn, uint32_t rx_chn);	// SPIx须已用 SPI_Init 初始化为主机; 通道不能用于该SPI时返回0
+void SPIQ_DevInit(const SPIQ_Device * dev);	// 片选引脚配置为输出并置高
+uint32_t SPIQ_Submit(SPIQ_Trans * trans);	// 提交事务, 总线空闲时立即开始; 参数错误或已在队列中返回0
+uint32_t SPIQ_Idle(void);			// 队列中没有事务返回1
+void SPIQ_GetStats(SPIQ_Stats * stats);	// 读取统计信息
+
+#endif
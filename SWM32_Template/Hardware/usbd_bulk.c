@@ -0,0 +1,554 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : usbd_bulk.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					库函数 USBD_TxWrite/USBD_RxRead 每拷贝一个包都关全局中断, 以免主循环和
+					USB中断同时读写USB缓冲区. 这里只有USB中断读写USB缓冲区和端点寄存器:
+					每个批量端点有两块缓冲区, 每块的状态只由当前持有的一方修改
+					(发送: 应用 FREE->USB, 中断 USB->FREE; 接收: 中断 FREE->FULL, 应用 FULL->FREE),
+					应用交出缓冲区后挂起USB中断(NVIC_SetPendingIRQ), 由中断启动发送或恢复接收,
+					全程不需要关中断, 其他中断只会被USB中断本身按优先级推迟.
+					IN端点只在有包要发时打开端点中断, 空闲时主机轮询产生的NAK不进中断.
+					缓冲区按字对齐, 包在缓冲区中的偏移是包长的整数倍, 和USB缓冲区之间
+					只按字拷贝(4字展开), 没有半字/字节尾巴.
+					端点0的控制传输仍由库函数处理, 只在枚举和CDC类请求时发生.
+					USB_Handler 在本文件中实现.
+  * Function List:
+  *		UBK_Init
+  *		UBK_Ready
+  *		UBK_DTR
+  *		UBK_TxBuffer
+  *		UBK_TxCommit
+  *		UBK_TxBusy
+  *		UBK_Read
+  *		UBK_ReadDone
+  *		UBK_GetStats
+  *		UBK_Bench
+  *		USB_Handler
+  **********************************************************
+ */
+
+#include "usbd_bulk.h"
+
+#define UBK_CFG_LEN			98
+#define UBK_STR_LEN			(2 + 2 * 24)
+
+//缓冲区状态
+#define UBK_BUF_FREE		0		//发送: 应用持有; 接收: 中断持有
+#define UBK_BUF_USB			1		//发送: 已交给中断
+#define UBK_BUF_FULL		2		//接收: 已交给应用
+
+typedef struct {
+    uint8_t  Ep;
+
+    volatile uint8_t TxState[2];
+    uint32_t TxLen[2];
+    uint8_t  TxApp;			//应用下一块填写的缓冲区
+    uint8_t  TxUsb;			//中断正在发送的缓冲区
+    uint8_t  TxFlight;		//端点上有一个包未发出
+    uint32_t TxOff;			//已发出的字节数
+    uint32_t TxCur;			//在途的包长
+
+    volatile uint8_t RxState[2];
+    uint32_t RxLen[2];
+    uint8_t  RxApp;
+    uint8_t  RxUsb;
+    volatile uint8_t RxPaused;	//两块都在应用手中, 端点未准备接收
+
+    uint32_t TxBuf[2][UBK_BUF_SIZE / 4];
+    uint32_t RxBuf[2][UBK_BUF_SIZE / 4];
+} UBK_Port;
+
+static UBK_Port ubk_port[UBK_PORT_NUM];
+static volatile uint8_t ubk_cfg;
+static volatile uint8_t ubk_dtr;
+static UBK_Stats ubk_stats;
+
+static uint8_t ubk_line_coding[7] = {0x00, 0xC2, 0x01, 0x00, 0x00, 0x00, 0x08};	//115200 8N1
+
+static uint8_t ubk_dev_desc[18] = {
+    0x12, USB_DESC_DEVICE, 0x00, 0x02,
+    0xEF, 0x02, 0x01,								//Misc/IAD
+    64,
+    UBK_VID & 0xFF, UBK_VID >> 8,
+    UBK_PID & 0xFF, UBK_PID >> 8,
+    0x00, 0x01,
+    1, 2, 3, 1
+};
+
+static uint8_t ubk_cfg_desc[UBK_CFG_LEN] = {
+    0x09, USB_DESC_CONFIG, UBK_CFG_LEN, 0x00, 0x03, 0x01, 0x00, 0x80, 0x32,
+    //IAD: 接口0~1为CDC
+    0x08, 0x0B, 0x00, 0x02, USB_CDC_CTRL_CLASS, USB_CDC_ACM, 0x01, 0x00,
+    //接口0: CDC通信
+    0x09, USB_DESC_INTERFACE, 0x00, 0x00, 0x01, USB_CDC_CTRL_CLASS, USB_CDC_ACM, 0x01, 0x00,
+    0x05, 0x24, 0x00, 0x10, 0x01,					//Header
+    0x05, 0x24, 0x01, 0x00, 0x01,					//Call Management
+    0x04, 0x24, 0x02, 0x02,							//ACM
+    0x05, 0x24, 0x06, 0x00, 0x01,					//Union
+    0x07, USB_DESC_ENDPOINT, USB_EP_IN | UBK_CDC_CMD_EP, USB_EP_INT, UBK_CMD_MPS, 0x00, 0x10,
+    //接口1: CDC数据
+    0x09, USB_DESC_INTERFACE, 0x01, 0x00, 0x02, USB_CDC_DATA_CLASS, 0x00, 0x00, 0x00,
+    0x07, USB_DESC_ENDPOINT, USB_EP_OUT | UBK_CDC_EP, USB_EP_BULK, UBK_MPS, 0x00, 0x00,
+    0x07, USB_DESC_ENDPOINT, USB_EP_IN | UBK_CDC_EP, USB_EP_BULK, UBK_MPS, 0x00, 0x00,
+    //接口2: 厂商批量
+    0x09, USB_DESC_INTERFACE, 0x02, 0x00, 0x02, 0xFF, 0x00, 0x00, 0x04,
+    0x07, USB_DESC_ENDPOINT, USB_EP_OUT | UBK_VENDOR_EP, USB_EP_BULK, UBK_MPS, 0x00, 0x00,
+    0x07, USB_DESC_ENDPOINT, USB_EP_IN | UBK_VENDOR_EP, USB_EP_BULK, UBK_MPS, 0x00, 0x00
+};
+
+static uint8_t ubk_lang_desc[4] = {0x04, USB_DESC_STRING, 0x09, 0x04};
+static uint8_t ubk_str_desc[4][UBK_STR_LEN];
+static const char * const ubk_str_ascii[4] = {"txt1994", "SWM341 CDC + Bulk", "SWM341-0001", "SWM341 Bulk"};
+
+//USBD_GetDescriptor 对索引 0~5 都直接取用, 不能有空指针
+static uint8_t * ubk_strings[6] = {
+    ubk_lang_desc, ubk_str_desc[0], ubk_str_desc[1], ubk_str_desc[2], ubk_str_desc[3], ubk_str_desc[1]
+};
+
+//ASCII字符串转为UTF-16LE字符串描述符
+static void UBK_String(uint8_t * desc, const char * s) {
+    uint32_t n = 2;
+
+    while(*s && n < UBK_STR_LEN) {
+        desc[n++] = (uint8_t)*s++;
+        desc[n++] = 0;
+    }
+
+    desc[0] = n;
+    desc[1] = USB_DESC_STRING;
+}
+
+//按字拷贝, 两边都须字对齐
+static void UBK_Copy(volatile uint32_t * dst, const volatile uint32_t * src, uint32_t words) {
+    for(; words >= 4; words -= 4, dst += 4, src += 4) {
+        dst[0] = src[0];
+        dst[1] = src[1];
+        dst[2] = src[2];
+        dst[3] = src[3];
+    }
+
+    for(; words != 0; words--) *dst++ = *src++;
+}
+
+static void UBK_ClassRequest(USB_Setup_Packet_t * pSetup) {
+    switch(pSetup->bRequest) {
+        case 0x21:		//GET_LINE_CODING
+            USBD_PrepareCtrlIn(ubk_line_coding, sizeof(ubk_line_coding));
+            USBD_RxReady(0);
+            break;
+
+        case 0x20:		//SET_LINE_CODING
+            USBD_PrepareCtrlOut(ubk_line_coding, sizeof(ubk_line_coding));
+            USBD_TxWrite(0, 0, 0);
+            break;
+
+        case 0x22:		//SET_CONTROL_LINE_STATE
+            ubk_dtr = pSetup->wValue & 0x01;
+            USBD_TxWrite(0, 0, 0);
+            break;
+
+        case 0x23:		//SEND_BREAK
+            USBD_TxWrite(0, 0, 0);
+            break;
+
+        default:
+            USBD_Stall0();
+            break;
+    }
+}
+
+static void UBK_VendorRequest(USB_Setup_Packet_t * pSetup) {
+    (void)pSetup;
+
+    USBD_Stall0();
+}
+
+//发送当前缓冲区的下一个包, TxOff 已到末尾时发零长度包
+static void UBK_TxPacket(UBK_Port * p) {
+    uint32_t n = p->TxLen[p->TxUsb] - p->TxOff;
+
+    if(n > UBK_MPS) n = UBK_MPS;
+
+    USBD->INEP[p->Ep].TXCR = USBD_TXCR_FLUSHFF_Msk;
+    USBD->INEP[p->Ep].TXTRSZ = n;
+
+    if(n) UBK_Copy(USBD->TXBUF[p->Ep], &p->TxBuf[p->TxUsb][p->TxOff / 4], (n + 3) / 4);
+
+    USBD->INEP[p->Ep].TXCR = USBD_TXCR_FFRDY_Msk;
+
+    p->TxCur = n;
+    p->TxFlight = 1;
+    USBD->EPIE |= (1 << p->Ep);
+}
+
+//端点空闲且有已交出的缓冲区时开始发送, 否则关闭IN端点中断
+static void UBK_TxKick(UBK_Port * p) {
+    if(p->TxFlight) return;
+
+    if(p->TxState[p->TxUsb] == UBK_BUF_USB) {
+        p->TxOff = 0;
+        UBK_TxPacket(p);
+    } else {
+        USBD->EPIE &= ~(1 << p->Ep);
+    }
+}
+
+//IN端点中断: 包已发出则继续下一个包, 整块发完交还应用
+static void UBK_TxIRQ(UBK_Port * p) {
+    uint32_t sent = USBD_TxSuccess(p->Ep);
+
+    USBD_TxIntClr(p->Ep);
+
+    if(p->TxFlight == 0 || sent == 0) return;
+
+    p->TxFlight = 0;
+    p->TxOff += p->TxCur;
+    ubk_stats.Packets++;
+
+    //满包结束的一块后面补零长度包
+    if(p->TxOff < p->TxLen[p->TxUsb] || (p->TxCur == UBK_MPS && p->TxOff == p->TxLen[p->TxUsb])) {
+        UBK_TxPacket(p);
+        return;
+    }
+
+    ubk_stats.TxBytes += p->TxLen[p->TxUsb];
+    p->TxState[p->TxUsb] = UBK_BUF_FREE;
+    p->TxUsb ^= 1;
+
+    UBK_TxKick(p);
+}
+
+//OUT端点收到一个包: 追加到当前接收缓冲区, 收满或短包时交给应用
+static void UBK_RxIRQ(UBK_Port * p) {
+    uint32_t i = p->RxUsb;
+    uint32_t n = (USBD->RXSR & USBD_RXSR_TRSZ_Msk) >> USBD_RXSR_TRSZ_Pos;
+
+    if(USBD_RxSuccess() == 0) {
+        USBD_RxIntClr();
+        USBD_RxReady(p->Ep);
+        return;
+    }
+
+    if(n > UBK_MPS) n = UBK_MPS;
+
+    if(n) UBK_Copy(&p->RxBuf[i][p->RxLen[i] / 4], USBD->RXBUF, (n + 3) / 4);
+
+    USBD_RxIntClr();
+
+    p->RxLen[i] += n;
+    ubk_stats.RxBytes += n;
+    ubk_stats.Packets++;
+
+    //满包且还放得下下一个包时继续收
+    if(n == UBK_MPS && p->RxLen[i] + UBK_MPS <= UBK_BUF_SIZE) {
+        USBD_RxReady(p->Ep);
+        return;
+    }
+
+    //空缓冲区收到零长度包, 不交给应用
+    if(p->RxLen[i] == 0) {
+        USBD_RxReady(p->Ep);
+        return;
+    }
+
+    p->RxState[i] = UBK_BUF_FULL;
+    p->RxUsb = i ^ 1;
+
+    if(p->RxState[i ^ 1] == UBK_BUF_FREE) {
+        p->RxLen[i ^ 1] = 0;
+        USBD_RxReady(p->Ep);
+    } else {
+        p->RxPaused = 1;
+        ubk_stats.RxPauses++;
+    }
+}
+
+//应用交出发送缓冲区或释放接收缓冲区后, 在中断中启动发送/恢复接收
+static void UBK_Service(void) {
+    UBK_Port * p;
+    uint32_t n;
+
+    for(n = 0; n < UBK_PORT_NUM; n++) {
+        p = &ubk_port[n];
+
+        UBK_TxKick(p);
+
+        if(p->RxPaused && p->RxState[p->RxUsb] == UBK_BUF_FREE) {
+            p->RxPaused = 0;
+            p->RxLen[p->RxUsb] = 0;
+            USBD_RxReady(p->Ep);
+        }
+    }
+}
+
+//总线复位或配置后, 所有缓冲区回到初始状态
+static void UBK_PortReset(UBK_Port * p) {
+    p->TxState[0] = UBK_BUF_FREE;
+    p->TxState[1] = UBK_BUF_FREE;
+    p->TxApp = 0;
+    p->TxUsb = 0;
+    p->TxFlight = 0;
+    p->RxState[0] = UBK_BUF_FREE;
+    p->RxState[1] = UBK_BUF_FREE;
+    p->RxLen[0] = 0;
+    p->RxLen[1] = 0;
+    p->RxApp = 0;
+    p->RxUsb = 0;
+    p->RxPaused = 0;
+}
+
+void UBK_Init(uint32_t priority) {
+    uint32_t i;
+
+    for(i = 0; i < 4; i++) UBK_String(ubk_str_desc[i], ubk_str_ascii[i]);
+
+    ubk_port[UBK_PORT_CDC].Ep = UBK_CDC_EP;
+    ubk_port[UBK_PORT_VENDOR].Ep = UBK_VENDOR_EP;
+
+    for(i = 0; i < UBK_PORT_NUM; i++) UBK_PortReset(&ubk_port[i]);
+
+    ubk_cfg = 0;
+    ubk_dtr = 0;
+    ubk_stats.TxBytes = 0;
+    ubk_stats.RxBytes = 0;
+    ubk_stats.Packets = 0;
+    ubk_stats.RxPauses = 0;
+    ubk_stats.IrqCount = 0;
+    ubk_stats.IrqCycles = 0;
+    ubk_stats.IrqMaxCycles = 0;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    USBD_Info.Mode = USBD_MODE_DEV;
+    USBD_Info.Speed = USBD_SPEED_FS;
+    USBD_Info.CtrlPkSiz = 64;
+    USBD_Info.DescDevice = ubk_dev_desc;
+    USBD_Info.DescConfig = ubk_cfg_desc;
+    USBD_Info.DescString = ubk_strings;
+    USBD_Info.pClassRequest_Callback = UBK_ClassRequest;
+    USBD_Info.pVendorRequest_Callback = UBK_VendorRequest;
+    USBD_Info.DescBOS = 0;
+    USBD_Info.DescHIDOffset = 0;
+    USBD_Info.DescHIDReport = 0;
+    USBD_Info.DescOSString = 0;
+
+    USBD_Init();
+
+    //IN端点中断只在有包要发时打开
+    USBD->EPIE &= ~((1 << UBK_CDC_EP) | (1 << UBK_CDC_CMD_EP) | (1 << UBK_VENDOR_EP));
+
+    NVIC_SetPriority(USB_IRQn, priority);
+    USBD_Open();
+}
+
+uint32_t UBK_Ready(void) {
+    return ubk_cfg;
+}
+
+uint32_t UBK_DTR(void) {
+    return ubk_dtr;
+}
+
+uint8_t * UBK_TxBuffer(uint32_t port) {
+    UBK_Port * p;
+
+    if(port >= UBK_PORT_NUM || ubk_cfg == 0) return 0;
+
+    p = &ubk_port[port];
+
+    if(p->TxState[p->TxApp] != UBK_BUF_FREE) return 0;
+
+    return (uint8_t *)p->TxBuf[p->TxApp];
+}
+
+uint32_t UBK_TxCommit(uint32_t port, uint32_t len) {
+    UBK_Port * p;
+
+    if(port >= UBK_PORT_NUM || len > UBK_BUF_SIZE || ubk_cfg == 0) return 0;
+
+    p = &ubk_port[port];
+
+    if(p->TxState[p->TxApp] != UBK_BUF_FREE) return 0;
+
+    p->TxLen[p->TxApp] = len;
+    __DMB();
+    p->TxState[p->TxApp] = UBK_BUF_USB;
+    p->TxApp ^= 1;
+
+    NVIC_SetPendingIRQ(USB_IRQn);
+
+    return 1;
+}
+
+uint32_t UBK_TxBusy(uint32_t port) {
+    if(port >= UBK_PORT_NUM) return 0;
+
+    return (ubk_port[port].TxState[0] == UBK_BUF_USB || ubk_port[port].TxState[1] == UBK_BUF_USB) ? 1 : 0;
+}
+
+uint32_t UBK_Read(uint32_t port, const uint8_t ** data) {
+    UBK_Port * p;
+
+    if(port >= UBK_PORT_NUM) return 0;
+
+    p = &ubk_port[port];
+
+    if(p->RxState[p->RxApp] != UBK_BUF_FULL) return 0;
+
+    *data = (const uint8_t *)p->RxBuf[p->RxApp];
+
+    return p->RxLen[p->RxApp];
+}
+
+void UBK_ReadDone(uint32_t port) {
+    UBK_Port * p;
+
+    if(port >= UBK_PORT_NUM) return;
+
+    p = &ubk_port[port];
+
+    if(p->RxState[p->RxApp] != UBK_BUF_FULL) return;
+
+    __DMB();
+    p->RxState[p->RxApp] = UBK_BUF_FREE;
+    p->RxApp ^= 1;
+
+    if(p->RxPaused) NVIC_SetPendingIRQ(USB_IRQn);
+}
+
+void UBK_GetStats(UBK_Stats * stats) {
+    *stats = ubk_stats;
+}
+
+uint32_t UBK_Bench(uint32_t port, uint32_t total, UBK_BenchResult * result) {
+    UBK_Stats s0, s1;
+    uint64_t cycles = 0;
+    uint32_t sent = 0, n, t0, t1, last;
+    uint8_t * buf;
+
+    if(port >= UBK_PORT_NUM || ubk_cfg == 0) return 0;
+
+    while(UBK_TxBusy(port));
+
+    ubk_stats.IrqMaxCycles = 0;
+    UBK_GetStats(&s0);
+
+    t0 = DWT->CYCCNT;
+    last = t0;
+
+    while(sent < total || UBK_TxBusy(port)) {
+        t1 = DWT->CYCCNT;
+        cycles += t1 - t0;
+        t0 = t1;
+
+        buf = (sent < total) ? UBK_TxBuffer(port) : 0;
+
+        if(buf) {
+            n = (total - sent) > UBK_BUF_SIZE ? UBK_BUF_SIZE : total - sent;
+            UBK_TxCommit(port, n);
+            sent += n;
+            last = t1;
+        } else if(t1 - last > SystemCoreClock) {
+            return 0;
+        }
+    }
+
+    cycles += DWT->CYCCNT - t0;
+    UBK_GetStats(&s1);
+
+    result->Bytes = sent;
+    result->Cycles = cycles > 0xFFFFFFFF ? 0xFFFFFFFF : (uint32_t)cycles;
+    result->Bps = cycles ? (uint32_t)((uint64_t)sent * SystemCoreClock / cycles) : 0;
+    result->CpuPermille = cycles ? (uint32_t)((uint64_t)(s1.IrqCycles - s0.IrqCycles) * 1000 / cycles) : 0;
+    result->IrqMaxCycles = s1.IrqMaxCycles;
+
+    return 1;
+}
+
+void USB_Handler(void) {
+    uint32_t t0 = DWT->CYCCNT;
+    uint32_t devif = USBD->DEVIF;
+    uint32_t epif = USBD->EPIF;
+    uint32_t n, t;
+
+    if(devif & USBD_DEVIF_RST_Msk) {
+        USBD->DEVIF = USBD_DEVIF_RST_Msk;
+        ubk_cfg = 0;
+        ubk_dtr = 0;
+
+        for(n = 0; n < UBK_PORT_NUM; n++) UBK_PortReset(&ubk_port[n]);
+
+        USBD->EPIE &= ~((1 << UBK_CDC_EP) | (1 << UBK_CDC_CMD_EP) | (1 << UBK_VENDOR_EP));
+    }
+
+    //SET_CONFIGURATION 由硬件应答, 这里只准备批量OUT端点
+    if(devif & USBD_DEVIF_SETCFG_Msk) {
+        USBD->DEVIF = USBD_DEVIF_SETCFG_Msk;
+
+        for(n = 0; n < UBK_PORT_NUM; n++) {
+            UBK_PortReset(&ubk_port[n]);
+            USBD_RxReady(ubk_port[n].Ep);
+        }
+
+        ubk_cfg = 1;
+    }
+
+    if(devif & USBD_DEVIF_SETUP_Msk) {
+        USBD->DEVIF = USBD_DEVIF_SETUP_Msk;
+
+        if(USBD->SETUPSR & USBD_SETUPSR_DONE_Msk) {
+            USBD->SETUPSR = USBD_SETUPSR_DONE_Msk;
+            USBD_ProcessSetupPacket();
+        }
+    }
+
+    if(epif & USBD_EPIF_INEP0_Msk) {
+        if(USBD_TxSuccess(0)) USBD_CtrlIn();
+
+        USBD_TxIntClr(0);
+    }
+
+    if(epif & (1 << UBK_CDC_CMD_EP)) USBD_TxIntClr(UBK_CDC_CMD_EP);
+
+    for(n = 0; n < UBK_PORT_NUM; n++) {
+        if(epif & (1 << ubk_port[n].Ep)) UBK_TxIRQ(&ubk_port[n]);
+    }
+
+    //所有OUT端点共用一个接收缓冲区, 由 RXSR.EPNR 区分
+    if(epif & 0xFFFF0000) {
+        n = (USBD->RXSR & USBD_RXSR_EPNR_Msk) >> USBD_RXSR_EPNR_Pos;
+
+        if(n == 0) {
+            if(USBD_RxSuccess()) USBD_CtrlOut();
+
+            USBD_RxIntClr();
+        } else if(n == UBK_CDC_EP) {
+            UBK_RxIRQ(&ubk_port[UBK_PORT_CDC]);
+        } else if(n == UBK_VENDOR_EP) {
+            UBK_RxIRQ(&ubk_port[UBK_PORT_VENDOR]);
+        } else {
+            USBD_RxIntClr();
+        }
+    }
+
+    if(ubk_cfg) UBK_Service();
+
+    t = DWT->CYCCNT - t0;
+    ubk_stats.IrqCount++;
+    ubk_stats.IrqCycles += t;
+
+    if(t > ubk_stats.IrqMaxCycles) ubk_stats.IrqMaxCycles = t;
+}
@@ -0,0 +1,82 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : usbd_bulk.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : SWM341 USB设备CDC-ACM + 厂商批量接口: 每个端点两块收发缓冲区轮流使用,
+  *				   缓冲区归属由状态标志交接, 不关全局中断; 按字拷贝USB缓冲区, 统计中断最长占用时间
+  * Function List:
+  *		UBK_Init
+  *		UBK_Ready
+  *		UBK_DTR
+  *		UBK_TxBuffer
+  *		UBK_TxCommit
+  *		UBK_TxBusy
+  *		UBK_Read
+  *		UBK_ReadDone
+  *		UBK_GetStats
+  *		UBK_Bench
+  ******************************************************
+**/
+
+#ifndef __USBD_BULK_H_
+#define __USBD_BULK_H_
+
+#include "SWM341.h"
+
+#define UBK_VID				0xA91A
+#define UBK_PID				0x8341
+
+//端点号, IN/OUT 使用相同编号
+#define UBK_CDC_EP			1
+#define UBK_CDC_CMD_EP		2
+#define UBK_VENDOR_EP		3
+
+#define UBK_MPS				64
+#define UBK_CMD_MPS			8
+
+//每个端点两块缓冲区, 须为 UBK_MPS 的整数倍
+#define UBK_BUF_SIZE		512
+
+//端口
+#define UBK_PORT_CDC		0
+#define UBK_PORT_VENDOR		1
+#define UBK_PORT_NUM		2
+
+typedef struct {
+    uint32_t TxBytes;		//批量IN端点发出的字节数
+    uint32_t RxBytes;		//批量OUT端点收到的字节数
+    uint32_t Packets;		//批量端点收发的包数
+    uint32_t RxPauses;		//两块接收缓冲区都在应用手中, 端点暂停接收的次数
+    uint32_t IrqCount;		//USB中断次数
+    uint32_t IrqCycles;		//USB中断累计占用的CPU周期
+    uint32_t IrqMaxCycles;	//USB中断单次最长占用的CPU周期, 即给同级和低优先级中断增加的最坏延迟
+} UBK_Stats;
+
+typedef struct {
+    uint32_t Bytes;			//发送的总字节数
+    uint32_t Cycles;		//总耗时(CPU周期)
+    uint32_t Bps;			//吞吐量, 字节/秒
+    uint32_t CpuPermille;	//USB中断占用的CPU千分比
+    uint32_t IrqMaxCycles;	//测试期间USB中断单次最长占用的CPU周期
+} UBK_BenchResult;
+
+void UBK_Init(uint32_t priority);	// 初始化USB设备并连接, 48MHz USB时钟须已配置
+uint32_t UBK_Ready(void);			// 主机已配置设备返回1
+uint32_t UBK_DTR(void);				// CDC端口的DTR状态, 主机打开串口时为1
+uint8_t * UBK_TxBuffer(uint32_t port);	// 取一块空闲的发送缓冲区(UBK_BUF_SIZE字节), 两块都在发送中返回0
+uint32_t UBK_TxCommit(uint32_t port, uint32_t len);	// 把 UBK_TxBuffer 取得的缓冲区交给USB发送, 长度为包长整数倍时补零长度包
+uint32_t UBK_TxBusy(uint32_t port);	// 还有缓冲区未发送完返回1
+uint32_t UBK_Read(uint32_t port, const uint8_t ** data);	// 取最早收好的一块接收缓冲区, 返回字节数, 没有数据返回0
+void UBK_ReadDone(uint32_t port);	// 释放 UBK_Read 取得的缓冲区
+void UBK_GetStats(UBK_Stats * stats);	// 读取统计信息
+uint32_t UBK_Bench(uint32_t port, uint32_t total, UBK_BenchResult * result);	// 连续发送 total 字节并计时, 主机须持续读取; 超时返回0
+
+#endif
@@ -0,0 +1,759 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : usbh_class.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					U盘: Bulk-Only 传输, 每条SCSI命令为 CBW -> 数据 -> CSW 三个URB, 前一个的完成
+					回调(USB中断中)直接提交下一个, 命令之间没有主循环参与. 数据阶段STALL时清除端点
+					后读CSW, CSW错误或相位错误时做BOT复位恢复. 插入后依次 INQUIRY、TEST UNIT READY
+					(未就绪则 REQUEST SENSE 后隔100ms重试)、READ CAPACITY(10).
+					顺序读: 两块预读缓冲区各 UMS_RA_BLOCKS 个扇区, 一条 READ(10) 读满一块.
+					缓冲区状态只由持有方修改(中断 FREE->READING->FULL, 应用 FULL->FREE),
+					应用释放一块后挂起USB中断, 由 Service 立即开始读下一段, 应用处理一块时
+					另一块已经在读, 总线不等应用.
+					UMS_Read/UMS_Write 为单次异步读写, 优先于预读执行.
+					HID: 取接口中的中断IN端点, SET_IDLE(0) 后提交中断URB, 核心按 bInterval 轮询,
+					每收到一个报告回调应用并立即重新提交, 轮询间隔不受应用影响.
+  * Function List:
+  *		UMS_Ready
+  *		UMS_GetInfo
+  *		UMS_Read
+  *		UMS_Write
+  *		UMS_Status
+  *		UMS_StreamOpen
+  *		UMS_StreamRead
+  *		UMS_StreamDone
+  *		UMS_StreamEnd
+  *		UMS_StreamClose
+  *		UMS_GetStats
+  *		UMS_Bench
+  *		UHD_SetCallback
+  *		UHD_Ready
+  *		UHD_Protocol
+  *		UHD_Reports
+  **********************************************************
+ */
+
+#include "usbh_class.h"
+
+#define UMS_CBW_SIG			0x43425355		//"USBC"
+#define UMS_CSW_SIG			0x53425355		//"USBS"
+#define UMS_CBW_LEN			31
+#define UMS_CSW_LEN			13
+
+//命令的发起者
+#define UMS_OWN_INIT		0
+#define UMS_OWN_USER		1
+#define UMS_OWN_STREAM		2
+
+//初始化步骤
+#define UMS_INIT_INQUIRY	0
+#define UMS_INIT_TUR		1
+#define UMS_INIT_SENSE		2
+#define UMS_INIT_WAIT		3
+#define UMS_INIT_CAPACITY	4
+#define UMS_INIT_DONE		5
+#define UMS_INIT_FAIL		6
+
+//端点0请求步骤
+#define UMS_CTRL_CLEAR_CSW	0		//数据阶段STALL: 清除后读CSW
+#define UMS_CTRL_RESET		1		//复位恢复: BOT复位
+#define UMS_CTRL_RESET_IN	2		//复位恢复: 清除IN端点
+#define UMS_CTRL_RESET_OUT	3		//复位恢复: 清除OUT端点
+
+//预读缓冲区状态
+#define UMS_BUF_FREE		0		//中断持有
+#define UMS_BUF_READING		1
+#define UMS_BUF_FULL		2		//已交给应用
+
+typedef struct {
+    UHC_Pipe In;
+    UHC_Pipe Out;
+    UHC_Urb  Cbw;
+    UHC_Urb  Data;
+    UHC_Urb  Csw;
+    UHC_Urb  Ctrl;
+    uint32_t CbwBuf[32 / 4];
+    uint32_t CswBuf[16 / 4];
+    uint32_t Tmp[36 / 4];		//INQUIRY/REQUEST SENSE/READ CAPACITY 的数据
+
+    uint8_t  Intf;
+    uint8_t  Found;				//接口已接管
+    uint8_t  Gone;				//设备已拔出, 不再提交
+    uint8_t  Busy;				//有命令在执行
+    uint8_t  Owner;
+    uint8_t  CtrlStep;
+    uint8_t  CswRetry;
+    uint8_t  Init;
+    uint8_t  Tries;
+    uint8_t  Starving;
+    uint16_t Wait;				//初始化等待的帧数
+    uint16_t LastFrame;
+    uint32_t Tag;
+    uint32_t CmdBlocks;
+    volatile uint8_t Ready;
+
+    //UMS_Read/UMS_Write
+    volatile uint8_t ReqPend;
+    volatile uint8_t Status;
+    uint8_t  ReqWrite;
+    uint32_t ReqLba;
+    uint32_t ReqCount;
+    uint8_t * ReqBuf;
+
+    //预读
+    volatile uint8_t StreamOn;
+    volatile uint8_t StreamErr;
+    volatile uint8_t BufState[2];
+    uint32_t BufLen[2];
+    uint8_t  App;				//应用下一块取的缓冲区
+    uint8_t  Usb;				//中断下一块读的缓冲区
+    volatile uint32_t Left;		//还没开始读的扇区数
+    uint32_t NextLba;
+
+    UMS_Info Info;
+    UMS_Stats Stats;
+
+    uint32_t Buf[2][UMS_RA_BLOCKS * UMS_BLOCK_MAX / 4];
+} UMS_Dev;
+
+typedef struct {
+    UHC_Pipe In;
+    UHC_Urb  Urb;
+    UHC_Urb  Ctrl;
+    uint32_t Buf[UHD_REPORT_MAX / 4];
+    uint8_t  Intf;
+    uint8_t  Protocol;
+    volatile uint8_t Ready;
+    volatile uint32_t Reports;
+    UHD_ReportCallback Callback;
+} UHD_Dev;
+
+static UMS_Dev ums;
+static UHD_Dev uhd;
+
+static void UMS_Next(void);
+
+static void UMS_Put32(uint8_t * p, uint32_t v) {
+    p[0] = v >> 24;
+    p[1] = v >> 16;
+    p[2] = v >> 8;
+    p[3] = v;
+}
+
+static uint32_t UMS_Get32(const uint8_t * p) {
+    return ((uint32_t)p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+}
+
+//复制INQUIRY中的ASCII字段, 去掉尾部空格
+static void UMS_Ascii(char * dst, const uint8_t * src, uint32_t n) {
+    uint32_t i;
+
+    for(i = 0; i < n; i++) dst[i] = src[i];
+
+    for(dst[n] = 0; n && dst[n - 1] == ' '; n--) dst[n - 1] = 0;
+}
+
+//命令结束: 按发起者交付结果, 然后开始下一条
+static void UMS_CmdDone(uint32_t ok) {
+    uint8_t * tmp = (uint8_t *)ums.Tmp;
+    uint32_t i;
+
+    ums.Busy = 0;
+
+    if(ok) ums.Stats.Commands++;
+    else ums.Stats.Errors++;
+
+    switch(ums.Owner) {
+        case UMS_OWN_INIT:
+            switch(ums.Init) {
+                case UMS_INIT_INQUIRY:
+                    if(ok) {
+                        UMS_Ascii(ums.Info.Vendor, &tmp[8], 8);
+                        UMS_Ascii(ums.Info.Product, &tmp[16], 16);
+                    }
+
+                    ums.Init = UMS_INIT_TUR;
+                    break;
+
+                case UMS_INIT_TUR:
+                    ums.Init = ok ? UMS_INIT_CAPACITY : UMS_INIT_SENSE;
+                    break;
+
+                case UMS_INIT_SENSE:
+                    ums.Wait = 100;
+                    ums.Init = (++ums.Tries >= UMS_TUR_TRIES) ? UMS_INIT_FAIL : UMS_INIT_WAIT;
+                    break;
+
+                case UMS_INIT_CAPACITY:
+                    ums.Info.Blocks = UMS_Get32(&tmp[0]) + 1;
+                    ums.Info.BlockSize = UMS_Get32(&tmp[4]);
+
+                    if(ok == 0 || ums.Info.BlockSize == 0 || ums.Info.BlockSize > UMS_BLOCK_MAX) {
+                        ums.Init = UMS_INIT_FAIL;
+                    } else {
+                        ums.Init = UMS_INIT_DONE;
+                        ums.Ready = 1;
+                    }
+                    break;
+            }
+            break;
+
+        case UMS_OWN_USER:
+            if(ok) {
+                if(ums.ReqWrite) ums.Stats.WriteBlocks += ums.CmdBlocks;
+                else ums.Stats.ReadBlocks += ums.CmdBlocks;
+            }
+
+            ums.Status = ok ? UMS_ST_OK : UMS_ST_FAIL;
+            break;
+
+        case UMS_OWN_STREAM:
+            i = ums.Usb;
+
+            if(ok) {
+                ums.Stats.ReadBlocks += ums.CmdBlocks;
+                ums.BufLen[i] = ums.CmdBlocks * ums.Info.BlockSize;
+                __DMB();
+                ums.BufState[i] = UMS_BUF_FULL;
+                ums.Usb = i ^ 1;
+            } else {
+                ums.BufState[i] = UMS_BUF_FREE;
+                ums.StreamErr = 1;
+            }
+            break;
+    }
+
+    UMS_Next();
+}
+
+static void UMS_Submit(UHC_Urb * u) {
+    if(UHC_Submit(u) == 0) {
+        ums.Gone = 1;
+        UMS_CmdDone(0);
+    }
+}
+
+//拔出或取消的URB不再继续, 返回0
+static uint32_t UMS_Alive(UHC_Urb * u) {
+    if(u->Result == UHC_RES_NODEV || u->Result == UHC_RES_CANCEL) {
+        ums.Gone = 1;
+        UMS_CmdDone(0);
+        return 0;
+    }
+
+    return 1;
+}
+
+static void UMS_ClearHalt(UHC_Pipe * p, uint32_t step) {
+    ums.CtrlStep = step;
+    ums.Ctrl.Arg = p;
+    p->Toggle = 0;
+
+    if(UHC_Control(&ums.Ctrl, 0x02, USB_CLEAR_FEATURE, 0, p->Ep, 0, 0) == 0) {
+        ums.Gone = 1;
+        UMS_CmdDone(0);
+    }
+}
+
+//复位恢复: BOT复位, 清除两个端点的STALL, 命令失败
+static void UMS_Recover(void) {
+    ums.Stats.Resets++;
+    ums.CtrlStep = UMS_CTRL_RESET;
+
+    if(UHC_Control(&ums.Ctrl, 0x21, 0xFF, 0, ums.Intf, 0, 0) == 0) {
+        ums.Gone = 1;
+        UMS_CmdDone(0);
+    }
+}
+
+static void UMS_CtrlDone(UHC_Urb * u) {
+    if(UMS_Alive(u) == 0) return;
+
+    switch(ums.CtrlStep) {
+        case UMS_CTRL_CLEAR_CSW:
+            if(u->Result == UHC_RES_OK) UMS_Submit(&ums.Csw);
+            else UMS_Recover();
+            break;
+
+        case UMS_CTRL_RESET:
+            UMS_ClearHalt(&ums.In, UMS_CTRL_RESET_IN);
+            break;
+
+        case UMS_CTRL_RESET_IN:
+            UMS_ClearHalt(&ums.Out, UMS_CTRL_RESET_OUT);
+            break;
+
+        default:
+            UMS_CmdDone(0);
+            break;
+    }
+}
+
+static void UMS_CbwDone(UHC_Urb * u) {
+    if(UMS_Alive(u) == 0) return;
+
+    if(u->Result != UHC_RES_OK) UMS_Recover();
+    else if(ums.Data.Len) UMS_Submit(&ums.Data);
+    else UMS_Submit(&ums.Csw);
+}
+
+static void UMS_DataDone(UHC_Urb * u) {
+    if(UMS_Alive(u) == 0) return;
+
+    if(u->Result == UHC_RES_OK) UMS_Submit(&ums.Csw);
+    else if(u->Result == UHC_RES_STALL) UMS_ClearHalt(u->Pipe, UMS_CTRL_CLEAR_CSW);
+    else UMS_Recover();
+}
+
+static void UMS_CswDone(UHC_Urb * u) {
+    const uint8_t * csw = (const uint8_t *)ums.CswBuf;
+
+    if(UMS_Alive(u) == 0) return;
+
+    //CSW阶段STALL: 清除后再读一次
+    if(u->Result == UHC_RES_STALL && ums.CswRetry == 0) {
+        ums.CswRetry = 1;
+        UMS_ClearHalt(&ums.In, UMS_CTRL_CLEAR_CSW);
+        return;
+    }
+
+    if(u->Result != UHC_RES_OK || u->Actual != UMS_CSW_LEN || ums.CswBuf[0] != UMS_CSW_SIG ||
+       ums.CswBuf[1] != ums.Tag || csw[12] > 1) {
+        UMS_Recover();
+        return;
+    }
+
+    //状态1: 命令失败, 读扇区时余量不为0也按失败处理
+    UMS_CmdDone(csw[12] == 0 && (ums.Data.Len == 0 || ums.CswBuf[2] == 0));
+}
+
+//开始一条SCSI命令
+static void UMS_Command(const uint8_t * cb, uint32_t cblen, uint8_t * buf, uint32_t len, uint32_t in, uint32_t owner) {
+    uint8_t * cbw = (uint8_t *)ums.CbwBuf;
+    uint32_t i;
+
+    ums.Busy = 1;
+    ums.Owner = owner;
+    ums.CswRetry = 0;
+
+    for(i = 0; i < 8; i++) ums.CbwBuf[i] = 0;
+
+    ums.CbwBuf[0] = UMS_CBW_SIG;
+    ums.CbwBuf[1] = ++ums.Tag;
+    ums.CbwBuf[2] = len;
+    cbw[12] = in ? 0x80 : 0x00;
+    cbw[13] = 0;				//LUN 0
+    cbw[14] = cblen;
+
+    for(i = 0; i < cblen; i++) cbw[15 + i] = cb[i];
+
+    ums.Cbw.Pipe = &ums.Out;
+    ums.Cbw.Buf = cbw;
+    ums.Cbw.Len = UMS_CBW_LEN;
+    ums.Data.Pipe = in ? &ums.In : &ums.Out;
+    ums.Data.Buf = buf;
+    ums.Data.Len = len;
+
+    UMS_Submit(&ums.Cbw);
+}
+
+//READ(10)/WRITE(10)
+static void UMS_ReadWrite(uint32_t write, uint32_t lba, uint32_t count, uint8_t * buf, uint32_t owner) {
+    uint8_t cb[10] = {0};
+
+    cb[0] = write ? 0x2A : 0x28;
+    UMS_Put32(&cb[2], lba);
+    cb[7] = count >> 8;
+    cb[8] = count;
+
+    ums.CmdBlocks = count;
+    UMS_Command(cb, 10, buf, count * ums.Info.BlockSize, write == 0, owner);
+}
+
+//总线空闲时选下一条命令: 初始化, 然后单次读写, 最后预读
+static void UMS_Next(void) {
+    uint8_t cb[10] = {0};
+    uint32_t n;
+
+    if(ums.Found == 0 || ums.Gone || ums.Busy) return;
+
+    if(ums.Init != UMS_INIT_DONE) {
+        if(ums.Init == UMS_INIT_WAIT) {
+            if(ums.Wait) return;
+
+            ums.Init = UMS_INIT_TUR;
+        }
+
+        switch(ums.Init) {
+            case UMS_INIT_INQUIRY:
+                cb[0] = 0x12;
+                cb[4] = 36;
+                UMS_Command(cb, 6, (uint8_t *)ums.Tmp, 36, 1, UMS_OWN_INIT);
+                break;
+
+            case UMS_INIT_TUR:
+                UMS_Command(cb, 6, 0, 0, 0, UMS_OWN_INIT);
+                break;
+
+            case UMS_INIT_SENSE:
+                cb[0] = 0x03;
+                cb[4] = 18;
+                UMS_Command(cb, 6, (uint8_t *)ums.Tmp, 18, 1, UMS_OWN_INIT);
+                break;
+
+            case UMS_INIT_CAPACITY:
+                cb[0] = 0x25;
+                UMS_Command(cb, 10, (uint8_t *)ums.Tmp, 8, 1, UMS_OWN_INIT);
+                break;
+
+            default:
+                break;
+        }
+        return;
+    }
+
+    if(ums.ReqPend) {
+        ums.ReqPend = 0;
+        UMS_ReadWrite(ums.ReqWrite, ums.ReqLba, ums.ReqCount, ums.ReqBuf, UMS_OWN_USER);
+        return;
+    }
+
+    if(ums.StreamOn == 0 || ums.StreamErr || ums.Left == 0) return;
+
+    //两块都在应用手中
+    if(ums.BufState[ums.Usb] != UMS_BUF_FREE) {
+        if(ums.Starving == 0) {
+            ums.Starving = 1;
+            ums.Stats.Starved++;
+        }
+        return;
+    }
+
+    ums.Starving = 0;
+
+    n = UMS_RA_BLOCKS * UMS_BLOCK_MAX / ums.Info.BlockSize;
+
+    if(n > ums.Left) n = ums.Left;
+
+    ums.BufState[ums.Usb] = UMS_BUF_READING;
+    ums.Left -= n;
+    ums.NextLba += n;
+    UMS_ReadWrite(0, ums.NextLba - n, n, (uint8_t *)ums.Buf[ums.Usb], UMS_OWN_STREAM);
+}
+
+static uint32_t UMS_Probe(const uint8_t * intf, uint32_t len) {
+    const uint8_t * in, * out;
+
+    //大容量存储, SCSI透明命令集, Bulk-Only
+    if(intf[5] != 0x08 || intf[6] != 0x06 || intf[7] != 0x50) return 0;
+
+    in = UHC_FindEp(intf, len, UHC_EP_BULK, USB_EP_IN);
+    out = UHC_FindEp(intf, len, UHC_EP_BULK, USB_EP_OUT);
+
+    if(in == 0 || out == 0) return 0;
+
+    UHC_PipeInit(&ums.In, in);
+    UHC_PipeInit(&ums.Out, out);
+
+    ums.Intf = intf[2];
+    ums.Found = 1;
+
+    return 1;
+}
+
+static void UMS_Start(void) {
+    ums.Cbw.Done = UMS_CbwDone;
+    ums.Data.Done = UMS_DataDone;
+    ums.Csw.Pipe = &ums.In;
+    ums.Csw.Buf = (uint8_t *)ums.CswBuf;
+    ums.Csw.Len = UMS_CSW_LEN;
+    ums.Csw.Done = UMS_CswDone;
+    ums.Ctrl.Done = UMS_CtrlDone;
+
+    ums.Gone = 0;
+    ums.Busy = 0;
+    ums.Init = UMS_INIT_INQUIRY;
+    ums.Tries = 0;
+    ums.Wait = 0;
+    ums.Info.Vendor[0] = 0;
+    ums.Info.Product[0] = 0;
+    ums.ReqPend = 0;
+    ums.StreamOn = 0;
+    ums.BufState[0] = UMS_BUF_FREE;
+    ums.BufState[1] = UMS_BUF_FREE;
+
+    UHC_Wake();
+}
+
+static void UMS_Stop(void) {
+    ums.Ready = 0;
+    ums.Found = 0;
+    ums.Busy = 0;
+    ums.ReqPend = 0;
+    ums.StreamOn = 0;
+    ums.BufState[0] = UMS_BUF_FREE;
+    ums.BufState[1] = UMS_BUF_FREE;
+
+    if(ums.Status == UMS_ST_BUSY) ums.Status = UMS_ST_FAIL;
+}
+
+//USB中断末尾: 计初始化等待的帧数, 应用释放缓冲区或提交读写后开始下一条命令
+static void UMS_Service(void) {
+    uint32_t frame;
+
+    if(ums.Found == 0) return;
+
+    frame = UHC_Frame();
+
+    if(ums.Wait && frame != ums.LastFrame) ums.Wait--;
+
+    ums.LastFrame = frame;
+
+    UMS_Next();
+}
+
+const UHC_Class UMS_Class = {UMS_Probe, UMS_Start, 0, UMS_Stop, UMS_Service};
+
+uint32_t UMS_Ready(void) {
+    return ums.Ready;
+}
+
+void UMS_GetInfo(UMS_Info * info) {
+    *info = ums.Info;
+}
+
+uint32_t UMS_Read(uint32_t lba, uint32_t count, uint8_t * buf) {
+    if(ums.Ready == 0 || ums.Status == UMS_ST_BUSY || count == 0 || count > 0xFFFF || buf == 0) return 0;
+
+    ums.ReqWrite = 0;
+    ums.ReqLba = lba;
+    ums.ReqCount = count;
+    ums.ReqBuf = buf;
+    ums.Status = UMS_ST_BUSY;
+    __DMB();
+    ums.ReqPend = 1;
+
+    UHC_Wake();
+
+    return 1;
+}
+
+uint32_t UMS_Write(uint32_t lba, uint32_t count, const uint8_t * buf) {
+    if(ums.Ready == 0 || ums.Status == UMS_ST_BUSY || count == 0 || count > 0xFFFF || buf == 0) return 0;
+
+    ums.ReqWrite = 1;
+    ums.ReqLba = lba;
+    ums.ReqCount = count;
+    ums.ReqBuf = (uint8_t *)buf;
+    ums.Status = UMS_ST_BUSY;
+    __DMB();
+    ums.ReqPend = 1;
+
+    UHC_Wake();
+
+    return 1;
+}
+
+uint32_t UMS_Status(void) {
+    return ums.Status;
+}
+
+uint32_t UMS_StreamOpen(uint32_t lba, uint32_t blocks) {
+    if(ums.Ready == 0 || blocks == 0) return 0;
+
+    ums.StreamOn = 0;
+    __DMB();
+
+    //上一次预读的命令还在执行
+    if(ums.BufState[0] == UMS_BUF_READING || ums.BufState[1] == UMS_BUF_READING) return 0;
+
+    ums.BufState[0] = UMS_BUF_FREE;
+    ums.BufState[1] = UMS_BUF_FREE;
+    ums.App = 0;
+    ums.Usb = 0;
+    ums.NextLba = lba;
+    ums.Left = blocks;
+    ums.StreamErr = 0;
+    ums.Starving = 0;
+    __DMB();
+    ums.StreamOn = 1;
+
+    UHC_Wake();
+
+    return 1;
+}
+
+uint32_t UMS_StreamRead(const uint8_t ** data) {
+    if(ums.StreamOn == 0 || ums.BufState[ums.App] != UMS_BUF_FULL) return 0;
+
+    *data = (const uint8_t *)ums.Buf[ums.App];
+
+    return ums.BufLen[ums.App];
+}
+
+void UMS_StreamDone(void) {
+    if(ums.BufState[ums.App] != UMS_BUF_FULL) return;
+
+    __DMB();
+    ums.BufState[ums.App] = UMS_BUF_FREE;
+    ums.App ^= 1;
+
+    UHC_Wake();
+}
+
+uint32_t UMS_StreamEnd(void) {
+    if(ums.StreamOn == 0 || ums.StreamErr || ums.Ready == 0) return 1;
+
+    return (ums.Left == 0 && ums.BufState[0] == UMS_BUF_FREE && ums.BufState[1] == UMS_BUF_FREE) ? 1 : 0;
+}
+
+void UMS_StreamClose(void) {
+    ums.StreamOn = 0;
+}
+
+void UMS_GetStats(UMS_Stats * stats) {
+    *stats = ums.Stats;
+}
+
+uint32_t UMS_Bench(uint32_t lba, uint32_t blocks, UMS_BenchResult * result) {
+    UHC_Stats s0, s1;
+    const uint8_t * data;
+    uint64_t cycles = 0;
+    uint32_t bytes = 0, n, t0, t1, last;
+
+    if(UMS_StreamOpen(lba, blocks) == 0) return 0;
+
+    UHC_GetStats(&s0);
+
+    t0 = DWT->CYCCNT;
+    last = t0;
+
+    while(UMS_StreamEnd() == 0) {
+        t1 = DWT->CYCCNT;
+        cycles += t1 - t0;
+        t0 = t1;
+
+        n = UMS_StreamRead(&data);
+
+        if(n) {
+            bytes += n;
+            UMS_StreamDone();
+            last = t1;
+        } else if(t1 - last > SystemCoreClock) {
+            UMS_StreamClose();
+            return 0;
+        }
+    }
+
+    cycles += DWT->CYCCNT - t0;
+    UHC_GetStats(&s1);
+
+    if(ums.StreamErr || ums.Ready == 0) return 0;
+
+    UMS_StreamClose();
+
+    result->Bytes = bytes;
+    result->Cycles = cycles > 0xFFFFFFFF ? 0xFFFFFFFF : (uint32_t)cycles;
+    result->Bps = cycles ? (uint32_t)((uint64_t)bytes * SystemCoreClock / cycles) : 0;
+    result->CpuPermille = cycles ? (uint32_t)((uint64_t)(s1.IrqCycles - s0.IrqCycles) * 1000 / cycles) : 0;
+
+    return 1;
+}
+
+static void UHD_Arm(void) {
+    uhd.Urb.Pipe = &uhd.In;
+    uhd.Urb.Buf = (uint8_t *)uhd.Buf;
+    uhd.Urb.Len = uhd.In.Mps > UHD_REPORT_MAX ? UHD_REPORT_MAX : uhd.In.Mps;
+
+    uhd.Ready = UHC_Submit(&uhd.Urb);
+}
+
+static void UHD_CtrlDone(UHC_Urb * u) {
+    //SET_IDLE 可以不支持(STALL)
+    if(u->Result == UHC_RES_NODEV || u->Result == UHC_RES_CANCEL) return;
+
+    uhd.In.Toggle = 0;
+    UHD_Arm();
+}
+
+static void UHD_ReportDone(UHC_Urb * u) {
+    switch(u->Result) {
+        case UHC_RES_OK:
+            uhd.Reports++;
+
+            if(uhd.Callback) uhd.Callback((const uint8_t *)uhd.Buf, u->Actual);
+
+            UHD_Arm();
+            break;
+
+        case UHC_RES_STALL:
+            uhd.Ready = UHC_Control(&uhd.Ctrl, 0x02, USB_CLEAR_FEATURE, 0, uhd.In.Ep, 0, 0);
+            break;
+
+        case UHC_RES_ERROR:
+            UHD_Arm();
+            break;
+
+        default:
+            uhd.Ready = 0;
+            break;
+    }
+}
+
+static uint32_t UHD_Probe(const uint8_t * intf, uint32_t len) {
+    const uint8_t * in;
+
+    if(intf[5] != 0x03) return 0;
+
+    in = UHC_FindEp(intf, len, UHC_EP_INT, USB_EP_IN);
+
+    if(in == 0) return 0;
+
+    UHC_PipeInit(&uhd.In, in);
+
+    uhd.Intf = intf[2];
+    uhd.Protocol = (intf[6] == 0x01) ? intf[7] : UHD_PROTO_NONE;	//启动接口子类
+
+    return 1;
+}
+
+static void UHD_Start(void) {
+    uhd.Urb.Done = UHD_ReportDone;
+    uhd.Ctrl.Done = UHD_CtrlDone;
+
+    //SET_IDLE(0): 只在报告变化时应答数据
+    UHC_Control(&uhd.Ctrl, 0x21, 0x0A, 0, uhd.Intf, 0, 0);
+}
+
+static void UHD_Stop(void) {
+    uhd.Ready = 0;
+}
+
+const UHC_Class UHD_Class = {UHD_Probe, UHD_Start, 0, UHD_Stop, 0};
+
+void UHD_SetCallback(UHD_ReportCallback cb) {
+    uhd.Callback = cb;
+}
+
+uint32_t UHD_Ready(void) {
+    return uhd.Ready;
+}
+
+uint32_t UHD_Protocol(void) {
+    return uhd.Protocol;
+}
+
+uint32_t UHD_Reports(void) {
+    return uhd.Reports;
+}
@@ -0,0 +1,103 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : usbh_class.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : 基于usbh_core的U盘(BOT/SCSI)和HID类驱动: U盘顺序读用两块多扇区预读缓冲区轮流读,
+  *				   命令各阶段在USB中断中衔接; HID中断端点按 bInterval 轮询, 报告由回调交给应用
+  * Function List:
+  *		UMS_Ready
+  *		UMS_GetInfo
+  *		UMS_Read
+  *		UMS_Write
+  *		UMS_Status
+  *		UMS_StreamOpen
+  *		UMS_StreamRead
+  *		UMS_StreamDone
+  *		UMS_StreamEnd
+  *		UMS_StreamClose
+  *		UMS_GetStats
+  *		UMS_Bench
+  *		UHD_SetCallback
+  *		UHD_Ready
+  *		UHD_Protocol
+  *		UHD_Reports
+  ******************************************************
+**/
+
+#ifndef __USBH_CLASS_H_
+#define __USBH_CLASS_H_
+
+#include "usbh_core.h"
+
+#define UMS_BLOCK_MAX		512		//支持的最大扇区长度
+#define UMS_RA_BLOCKS		16		//每块预读缓冲区的扇区数, 两块共 2 * 16 * 512 字节
+#define UMS_TUR_TRIES		50		//等待介质就绪, 每次间隔100ms
+
+//UMS_Read/UMS_Write 的执行状态
+#define UMS_ST_IDLE			0
+#define UMS_ST_BUSY			1
+#define UMS_ST_OK			2
+#define UMS_ST_FAIL			3
+
+#define UHD_REPORT_MAX		64
+
+//HID启动协议
+#define UHD_PROTO_NONE		0
+#define UHD_PROTO_KEYBOARD	1
+#define UHD_PROTO_MOUSE		2
+
+typedef struct {
+    uint32_t Blocks;		//扇区数
+    uint32_t BlockSize;		//扇区长度
+    char Vendor[9];
+    char Product[17];
+} UMS_Info;
+
+typedef struct {
+    uint32_t Commands;		//完成的SCSI命令数
+    uint32_t ReadBlocks;
+    uint32_t WriteBlocks;
+    uint32_t Errors;		//失败的命令数
+    uint32_t Resets;		//BOT复位恢复次数
+    uint32_t Starved;		//两块预读缓冲区都在应用手中, 总线空等的次数
+} UMS_Stats;
+
+typedef struct {
+    uint32_t Bytes;			//读取的总字节数
+    uint32_t Cycles;		//总耗时(CPU周期)
+    uint32_t Bps;			//吞吐量, 字节/秒
+    uint32_t CpuPermille;	//USB中断占用的CPU千分比
+} UMS_BenchResult;
+
+typedef void (*UHD_ReportCallback)(const uint8_t * report, uint32_t len);
+
+extern const UHC_Class UMS_Class;	// 用 UHC_RegisterClass 注册
+extern const UHC_Class UHD_Class;
+
+uint32_t UMS_Ready(void);			// U盘已就绪返回1
+void UMS_GetInfo(UMS_Info * info);	// 容量和INQUIRY信息
+uint32_t UMS_Read(uint32_t lba, uint32_t count, uint8_t * buf);	// 开始读 count 个扇区, 完成前 buf 不能改动; 忙或未就绪返回0
+uint32_t UMS_Write(uint32_t lba, uint32_t count, const uint8_t * buf);	// 开始写 count 个扇区
+uint32_t UMS_Status(void);			// 上一次 UMS_Read/UMS_Write 的状态 UMS_ST_xxx
+uint32_t UMS_StreamOpen(uint32_t lba, uint32_t blocks);	// 从 lba 开始顺序预读 blocks 个扇区
+uint32_t UMS_StreamRead(const uint8_t ** data);	// 取最早读好的一块预读缓冲区, 返回字节数, 还没读好返回0
+void UMS_StreamDone(void);			// 释放 UMS_StreamRead 取得的缓冲区, 继续预读
+uint32_t UMS_StreamEnd(void);		// 全部扇区已交给应用或读出错返回1
+void UMS_StreamClose(void);			// 停止预读
+void UMS_GetStats(UMS_Stats * stats);	// 读取统计信息
+uint32_t UMS_Bench(uint32_t lba, uint32_t blocks, UMS_BenchResult * result);	// 顺序读 blocks 个扇区并计时; 出错或超时返回0
+
+void UHD_SetCallback(UHD_ReportCallback cb);	// 设置报告回调, 在USB中断中调用
+uint32_t UHD_Ready(void);			// HID设备在轮询中返回1
+uint32_t UHD_Protocol(void);		// 启动协议 UHD_PROTO_xxx
+uint32_t UHD_Reports(void);			// 收到的报告数
+
+#endif
@@ -0,0 +1,876 @@
+/**
+  ************************* Copyright **********************
+  *
+  *          (C) Copyright 2026,txt1994,China, GCU.
+  *                    All Rights Reserved
+  *
+  *                 https://github.com/txt1994
+  *			        email:linguangyuan88@gmail.com
+  *
+  * FileName     : usbh_core.c
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  :
+
+					SWM341 的USB主机一次只能发一个令牌(TOKEN), 库函数 USBH_SendInPacket 等
+					关全局中断发令牌, 再由调用者轮询 USBH_State 等应答, 轮询期间CPU被占住.
+					这里令牌全部在USB中断中发出: RXSTAT 中断处理上一个令牌的应答后立即发下一个,
+					SOF 中断开始新的一帧. 调度顺序:
+					1. 到期的中断端点(NextFrame 已到)先发, 每个 bInterval 轮询一次, NAK 也算一次;
+					2. 其余时间给控制/批量管道, 每个令牌之后轮到下一个管道, 一个管道持续NAK
+					   不会饿死其他管道, 只有一个管道时它连续占用总线;
+					3. 发令牌前按包长估计本帧剩余时间(FRAMERM), 不够则等下一帧 SOF.
+					每个管道的URB按提交顺序执行, 同一管道不会交错. 应用和中断共用的链表只在
+					关USB中断(NVIC)时修改, 不关全局中断.
+					连接去抖、端口复位和枚举(设备描述符、地址、配置描述符、SET_CONFIGURATION)
+					在 UHC_Task 中用端点0的URB逐步完成, 不阻塞; 枚举后按接口描述符交给注册的类驱动.
+					USB_Handler 在本文件中实现.
+  * Function List:
+  *		UHC_Init
+  *		UHC_RegisterClass
+  *		UHC_Task
+  *		UHC_State
+  *		UHC_DevDesc
+  *		UHC_FindEp
+  *		UHC_PipeInit
+  *		UHC_Submit
+  *		UHC_Control
+  *		UHC_Cancel
+  *		UHC_Wake
+  *		UHC_Frame
+  *		UHC_GetStats
+  *		UHC_IRQHandler
+  **********************************************************
+ */
+
+#include "usbh_core.h"
+
+#define UHC_TOKEN_SETUP		13
+#define UHC_TOKEN_OUT		1
+#define UHC_TOKEN_IN		9
+
+#define UHC_SPEED_LS		2
+#define UHC_SPEED_FS		3
+
+//控制传输阶段
+#define UHC_STAGE_SETUP		0
+#define UHC_STAGE_DATA		1
+#define UHC_STAGE_STATUS	2
+
+//UHC_Task 步骤
+#define UHC_STEP_IDLE		0
+#define UHC_STEP_DEBOUNCE	1
+#define UHC_STEP_RESET		2
+#define UHC_STEP_RECOVER	3
+#define UHC_STEP_DEV8		4
+#define UHC_STEP_ADDR		5
+#define UHC_STEP_ADDR_WAIT	6
+#define UHC_STEP_DEV18		7
+#define UHC_STEP_CFG9		8
+#define UHC_STEP_CFG		9
+#define UHC_STEP_SETCFG		10
+#define UHC_STEP_READY		11
+#define UHC_STEP_ERROR		12
+
+#define UHC_ENUM_TRIES		3
+#define UHC_ENUM_TIMEOUT	500		//ms, 单个枚举请求
+#define UHC_PORTSR_CHG		(USBH_PORTSR_CONNCHG_Msk | USBH_PORTSR_ENACHG_Msk | USBH_PORTSR_SUSPCHG_Msk | USBH_PORTSR_RSTCHG_Msk)
+
+static UHC_Pipe uhc_ep0;
+static UHC_Urb uhc_enum_urb;
+static uint32_t uhc_dev_desc[20 / 4];
+static uint32_t uhc_cfg[UHC_CFG_MAX / 4];
+static uint32_t uhc_cfg_len;
+
+static const UHC_Class * uhc_class[UHC_CLASS_MAX];
+static uint8_t uhc_bound[UHC_CLASS_MAX];
+static uint32_t uhc_class_num;
+
+static UHC_Pipe * uhc_np;			//有URB排队的控制/批量管道
+static UHC_Pipe * uhc_np_cur;		//下一个轮到的控制/批量管道
+static UHC_Pipe * uhc_per;			//有URB排队的中断管道
+static UHC_Urb * uhc_cur;			//令牌在途的URB
+static uint32_t uhc_cur_len;		//在途的OUT/SETUP包长
+
+static uint8_t uhc_speed;
+static volatile uint8_t uhc_attached;	//端口已使能, 可以发令牌
+static volatile uint8_t uhc_deferred;	//有令牌等待: 1 本帧剩余时间不够, 2 还在帧头
+static volatile uint8_t uhc_irq_active;
+static volatile uint8_t uhc_state;
+static uint8_t uhc_step;
+static uint8_t uhc_tries;
+static uint32_t uhc_t0;
+static UHC_Stats uhc_stats;
+
+static uint32_t UHC_Ms(uint32_t t0) {
+    return (DWT->CYCCNT - t0) / (SystemCoreClock / 1000);
+}
+
+//只关USB中断, 返回关之前是否打开
+static uint32_t UHC_Lock(void) {
+    uint32_t en = NVIC_GetEnableIRQ(USB_IRQn);
+
+    NVIC_DisableIRQ(USB_IRQn);
+    __DSB();
+    __ISB();
+
+    return en;
+}
+
+static void UHC_Unlock(uint32_t en) {
+    if(en) NVIC_EnableIRQ(USB_IRQn);
+}
+
+//一次事务占用的全速位时间: 数据按位填充 7/6 估计, 加令牌、握手和总线间隔; 低速乘8
+static uint32_t UHC_Bits(uint32_t len) {
+    uint32_t t = len * 28 / 3 + 120;
+
+    return uhc_speed == UHC_SPEED_LS ? t * 8 : t;
+}
+
+//写发送缓冲区, 源地址不对齐时按字节拼成字
+static void UHC_TxCopy(const uint8_t * src, uint32_t n) {
+    volatile uint32_t * dst = USBH->TXBUF;
+    const uint32_t * s;
+    uint32_t w, i;
+
+    if(((uint32_t)src & 3) == 0) {
+        s = (const uint32_t *)src;
+
+        for(; n >= 16; n -= 16, dst += 4, s += 4) {
+            dst[0] = s[0];
+            dst[1] = s[1];
+            dst[2] = s[2];
+            dst[3] = s[3];
+        }
+
+        for(; n >= 4; n -= 4) *dst++ = *s++;
+
+        src = (const uint8_t *)s;
+    } else {
+        for(; n >= 4; n -= 4, src += 4) *dst++ = src[0] | (src[1] << 8) | (src[2] << 16) | ((uint32_t)src[3] << 24);
+    }
+
+    if(n) {
+        for(w = 0, i = 0; i < n; i++) w |= (uint32_t)src[i] << (i * 8);
+
+        *dst = w;
+    }
+}
+
+//读接收缓冲区, 不写目的缓冲区之外的字节
+static void UHC_RxCopy(uint8_t * dst, uint32_t n) {
+    volatile uint32_t * src = USBH->RXBUF;
+    uint32_t * d;
+    uint32_t w;
+
+    if(((uint32_t)dst & 3) == 0) {
+        d = (uint32_t *)dst;
+
+        for(; n >= 16; n -= 16, d += 4, src += 4) {
+            d[0] = src[0];
+            d[1] = src[1];
+            d[2] = src[2];
+            d[3] = src[3];
+        }
+
+        for(; n >= 4; n -= 4) *d++ = *src++;
+
+        dst = (uint8_t *)d;
+    } else {
+        for(; n >= 4; n -= 4, dst += 4) {
+            w = *src++;
+            dst[0] = w;
+            dst[1] = w >> 8;
+            dst[2] = w >> 16;
+            dst[3] = w >> 24;
+        }
+    }
+
+    for(w = n ? *src : 0; n; n--, w >>= 8) *dst++ = w;
+}
+
+static void UHC_Link(UHC_Pipe * p) {
+    UHC_Pipe ** list = (p->Type == UHC_EP_INT) ? &uhc_per : &uhc_np;
+
+    p->Next = *list;
+    *list = p;
+    p->Linked = 1;
+}
+
+static void UHC_Unlink(UHC_Pipe * p) {
+    UHC_Pipe ** pp = (p->Type == UHC_EP_INT) ? &uhc_per : &uhc_np;
+
+    for(; *pp; pp = &(*pp)->Next) {
+        if(*pp == p) {
+            *pp = p->Next;
+            break;
+        }
+    }
+
+    if(uhc_np_cur == p) uhc_np_cur = p->Next;
+
+    p->Next = 0;
+    p->Linked = 0;
+}
+
+//URB从管道队首取下并结束, 被取消的不回调
+static void UHC_Finish(UHC_Urb * u, uint32_t res) {
+    UHC_Pipe * p = u->Pipe;
+
+    p->Head = u->Next;
+
+    if(p->Head == 0) {
+        p->Tail = 0;
+        UHC_Unlink(p);
+    }
+
+    u->Next = 0;
+    u->Result = u->Cancel ? UHC_RES_CANCEL : res;
+    u->State = UHC_URB_DONE;
+
+    if(u->Cancel == 0 && u->Done) u->Done(u);
+}
+
+//结束所有管道上的URB, 包括令牌在途的
+static void UHC_Flush(uint32_t res) {
+    uhc_cur = 0;
+    uhc_deferred = 0;
+
+    //管道在链表中时队列不空, 最后一个URB结束时管道移出链表
+    while(uhc_np) UHC_Finish(uhc_np->Head, res);
+
+    while(uhc_per) UHC_Finish(uhc_per->Head, res);
+
+    uhc_np_cur = 0;
+    USBH->CR = USBH_CR_FLUSHFF_Msk;
+}
+
+//中断端点的下一次轮询, 落后超过一个间隔时从下一帧重新开始
+static void UHC_NextPoll(UHC_Pipe * p) {
+    uint32_t frame = USBH->FRAMENR & UHC_FRAME_MASK;
+
+    p->NextFrame = (p->NextFrame + p->Interval) & UHC_FRAME_MASK;
+
+    if(((frame - p->NextFrame) & UHC_FRAME_MASK) < (UHC_FRAME_MASK + 1) / 2)
+        p->NextFrame = (frame + p->Interval) & UHC_FRAME_MASK;
+}
+
+static uint32_t UHC_IsIn(const UHC_Urb * u) {
+    return (u->Pipe->Type == UHC_EP_CTRL) ? (u->Setup[0] & 0x80) : (u->Pipe->Ep & 0x80);
+}
+
+//发出URB当前阶段的下一个令牌; 本帧剩余时间不够返回0
+static uint32_t UHC_Issue(UHC_Urb * u) {
+    UHC_Pipe * p = u->Pipe;
+    uint32_t type, n = 0, datax = 1, rm;
+
+    if(p->Type == UHC_EP_CTRL && u->Stage == UHC_STAGE_SETUP) {
+        type = UHC_TOKEN_SETUP;
+        n = 8;
+        datax = 0;
+    } else if(p->Type == UHC_EP_CTRL && u->Stage == UHC_STAGE_STATUS) {
+        //状态阶段和数据阶段方向相反, 没有数据阶段时为IN
+        type = (u->Len && (u->Setup[0] & 0x80)) ? UHC_TOKEN_OUT : UHC_TOKEN_IN;
+    } else {
+        type = UHC_IsIn(u) ? UHC_TOKEN_IN : UHC_TOKEN_OUT;
+        datax = p->Toggle;
+
+        if(type == UHC_TOKEN_OUT) {
+            n = u->Len - u->Actual;
+
+            if(n > p->Mps) n = p->Mps;
+        }
+    }
+
+    rm = USBH->FRAMERM;
+
+    if(rm >= UHC_FRAME_HEAD || rm <= UHC_Bits(type == UHC_TOKEN_IN ? p->Mps : n) + UHC_FRAME_TAIL) return 0;
+
+    if(type != UHC_TOKEN_IN) {
+        USBH->TXTRSZ = n;
+
+        if(type == UHC_TOKEN_SETUP) UHC_TxCopy(u->Setup, 8);
+        else if(n) UHC_TxCopy(u->Buf + u->Actual, n);
+    }
+
+    uhc_cur = u;
+    uhc_cur_len = n;
+
+    USBH->TOKEN = (p->Addr << USBH_TOKEN_ADDR_Pos) |
+                  ((p->Ep & 0x0F) << USBH_TOKEN_EPNR_Pos) |
+                  (type << USBH_TOKEN_TYPE_Pos) |
+                  (datax << USBH_TOKEN_DATAX_Pos) |
+                  (uhc_speed << USBH_TOKEN_SPEED_Pos) |
+                  ((type == UHC_TOKEN_IN ? p->Mps : n) << USBH_TOKEN_TRSZ_Pos);
+
+    uhc_stats.Tokens++;
+
+    return 1;
+}
+
+//总线空闲时发下一个令牌: 到期的中断端点优先, 然后控制/批量管道轮流
+static void UHC_Kick(void) {
+    UHC_Pipe * p;
+    uint32_t frame;
+
+    if(uhc_cur || uhc_attached == 0) return;
+
+    frame = USBH->FRAMENR & UHC_FRAME_MASK;
+
+    for(p = uhc_per; p; p = p->Next) {
+        if(((frame - p->NextFrame) & UHC_FRAME_MASK) < (UHC_FRAME_MASK + 1) / 2) break;
+    }
+
+    if(p) {
+        if(UHC_Issue(p->Head)) {
+            uhc_stats.Polls++;
+            return;
+        }
+    } else {
+        p = uhc_np_cur ? uhc_np_cur : uhc_np;
+
+        if(p == 0) return;
+
+        if(UHC_Issue(p->Head)) {
+            uhc_np_cur = p->Next;
+            return;
+        }
+
+        uhc_np_cur = p;
+    }
+
+    if(uhc_deferred == 0) uhc_stats.Deferred++;
+
+    uhc_deferred = (USBH->FRAMERM >= UHC_FRAME_HEAD) ? 2 : 1;
+}
+
+//处理在途令牌的应答
+static void UHC_Response(void) {
+    UHC_Urb * u = uhc_cur;
+    UHC_Pipe * p;
+    uint32_t resp = USBH->SR & USBH_SR_RESP_Msk;
+    uint32_t n, raw, more;
+
+    if(u == 0) return;
+
+    uhc_cur = 0;
+    p = u->Pipe;
+
+    if(u->Cancel) {
+        UHC_Finish(u, UHC_RES_CANCEL);
+        return;
+    }
+
+    switch(resp) {
+        case USBR_ACK:
+            u->Errors = 0;
+
+            if(p->Type == UHC_EP_CTRL && u->Stage == UHC_STAGE_SETUP) {
+                p->Toggle = 1;
+                u->Stage = u->Len ? UHC_STAGE_DATA : UHC_STAGE_STATUS;
+                break;
+            }
+
+            if(p->Type == UHC_EP_CTRL && u->Stage == UHC_STAGE_STATUS) {
+                UHC_Finish(u, UHC_RES_OK);
+                break;
+            }
+
+            if(UHC_IsIn(u)) {
+                raw = (USBH->SR & USBH_SR_TRSZ_Msk) >> USBH_SR_TRSZ_Pos;
+                n = (raw > u->Len - u->Actual) ? u->Len - u->Actual : raw;	//多出的部分丢弃
+
+                if(n) UHC_RxCopy(u->Buf + u->Actual, n);
+
+                more = (raw == p->Mps);		//短包结束传输
+            } else {
+                n = uhc_cur_len;
+                more = 1;
+            }
+
+            u->Actual += n;
+            p->Toggle ^= 1;
+            uhc_stats.Bytes += n;
+
+            if(p->Type == UHC_EP_INT) UHC_NextPoll(p);
+
+            if(more && u->Actual < u->Len) break;
+
+            if(p->Type == UHC_EP_CTRL) {
+                u->Stage = UHC_STAGE_STATUS;
+                p->Toggle = 1;
+            } else {
+                UHC_Finish(u, UHC_RES_OK);
+            }
+            break;
+
+        case USBR_NAK:
+            uhc_stats.Naks++;
+
+            if(p->Type == UHC_EP_INT) UHC_NextPoll(p);
+            break;
+
+        case USBR_STALL:
+            UHC_Finish(u, UHC_RES_STALL);
+            break;
+
+        case USBR_ERR_TOGGLE:
+            //设备没收到上次的ACK又重发了旧数据, 丢弃后重试
+            break;
+
+        default:
+            uhc_stats.Errors++;
+
+            if(++u->Errors > UHC_RETRY) {
+                UHC_Finish(u, UHC_RES_ERROR);
+            } else if(p->Type == UHC_EP_INT) {
+                UHC_NextPoll(p);
+            }
+            break;
+    }
+}
+
+//重新复位端口, 超过次数则放弃, 等待拔出
+static void UHC_EnumFail(void) {
+    uint32_t en = UHC_Lock();
+
+    uhc_attached = 0;
+    UHC_Flush(UHC_RES_CANCEL);
+    UHC_Unlock(en);
+
+    uhc_enum_urb.State = UHC_URB_IDLE;
+
+    if(++uhc_tries >= UHC_ENUM_TRIES) {
+        uhc_state = UHC_DEV_ERROR;
+        uhc_step = UHC_STEP_ERROR;
+        return;
+    }
+
+    USBH->PORTSR = USBH_PORTSR_RESET_Msk;
+    uhc_t0 = DWT->CYCCNT;
+    uhc_step = UHC_STEP_RESET;
+}
+
+//枚举用的控制传输: 第一次调用时提交, 成功完成返回1
+static uint32_t UHC_EnumXfer(uint8_t type, uint8_t request, uint16_t value, uint16_t index, void * buf, uint16_t len) {
+    UHC_Urb * u = &uhc_enum_urb;
+
+    if(u->State == UHC_URB_IDLE) {
+        u->Done = 0;
+        uhc_t0 = DWT->CYCCNT;
+
+        if(UHC_Control(u, type, request, value, index, (uint8_t *)buf, len) == 0) UHC_EnumFail();
+
+        return 0;
+    }
+
+    if(u->State != UHC_URB_DONE) {
+        if(UHC_Ms(uhc_t0) > UHC_ENUM_TIMEOUT) UHC_EnumFail();
+
+        return 0;
+    }
+
+    u->State = UHC_URB_IDLE;
+
+    if(u->Result != UHC_RES_OK) {
+        UHC_EnumFail();
+        return 0;
+    }
+
+    return 1;
+}
+
+//把配置描述符中的每个接口(备用设置0)交给第一个接管它的类驱动
+static void UHC_Bind(void) {
+    const uint8_t * cfg = (const uint8_t *)uhc_cfg;
+    uint32_t off = cfg[0], end, i;
+
+    for(i = 0; i < UHC_CLASS_MAX; i++) uhc_bound[i] = 0;
+
+    while(off + 2 <= uhc_cfg_len && cfg[off] >= 2) {
+        if(cfg[off + 1] != USB_DESC_INTERFACE || cfg[off + 3] != 0) {
+            off += cfg[off];
+            continue;
+        }
+
+        for(end = off + cfg[off]; end + 2 <= uhc_cfg_len && cfg[end] >= 2 && cfg[end + 1] != USB_DESC_INTERFACE; end += cfg[end]);
+
+        if(end > uhc_cfg_len) end = uhc_cfg_len;
+
+        for(i = 0; i < uhc_class_num; i++) {
+            if(uhc_bound[i] == 0 && uhc_class[i]->Probe(cfg + off, end - off)) {
+                uhc_bound[i] = 1;
+                break;
+            }
+        }
+
+        off = end;
+    }
+}
+
+static void UHC_Detach(void) {
+    uint32_t en = UHC_Lock(), i;
+
+    uhc_attached = 0;
+    UHC_Flush(UHC_RES_NODEV);
+    USBH->IE &= ~USBH_IE_SOF_Msk;
+    UHC_Unlock(en);
+
+    if(uhc_state == UHC_DEV_READY) {
+        for(i = 0; i < uhc_class_num; i++) {
+            if(uhc_bound[i] && uhc_class[i]->Stop) uhc_class[i]->Stop();
+        }
+    }
+
+    for(i = 0; i < UHC_CLASS_MAX; i++) uhc_bound[i] = 0;
+
+    uhc_enum_urb.State = UHC_URB_IDLE;
+    uhc_state = UHC_DEV_DETACHED;
+    uhc_step = UHC_STEP_IDLE;
+}
+
+void UHC_Init(uint32_t priority) {
+    uhc_np = 0;
+    uhc_np_cur = 0;
+    uhc_per = 0;
+    uhc_cur = 0;
+    uhc_attached = 0;
+    uhc_deferred = 0;
+    uhc_irq_active = 0;
+    uhc_state = UHC_DEV_DETACHED;
+    uhc_step = UHC_STEP_IDLE;
+    uhc_class_num = 0;
+    uhc_enum_urb.State = UHC_URB_IDLE;
+
+    uhc_stats.Tokens = 0;
+    uhc_stats.Naks = 0;
+    uhc_stats.Errors = 0;
+    uhc_stats.Bytes = 0;
+    uhc_stats.Polls = 0;
+    uhc_stats.Deferred = 0;
+    uhc_stats.IrqCount = 0;
+    uhc_stats.IrqCycles = 0;
+    uhc_stats.IrqMaxCycles = 0;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    USBH_HW_Init();
+
+    USBH->IF = 0xFFFFFFFF;
+    USBH->PORTSR = UHC_PORTSR_CHG;
+    USBH->IE = USBH_IE_RXSTAT_Msk | USBH_IE_PORT_Msk;
+
+    NVIC_SetPriority(USB_IRQn, priority);
+    NVIC_EnableIRQ(USB_IRQn);
+}
+
+void UHC_RegisterClass(const UHC_Class * cls) {
+    if(uhc_class_num < UHC_CLASS_MAX) uhc_class[uhc_class_num++] = cls;
+}
+
+void UHC_Task(void) {
+    uint32_t sr = USBH->PORTSR, i;
+    uint8_t * dev = (uint8_t *)uhc_dev_desc;
+    uint8_t * cfg = (uint8_t *)uhc_cfg;
+
+    if(uhc_step != UHC_STEP_IDLE &&
+       ((sr & USBH_PORTSR_CONN_Msk) == 0 || (uhc_step > UHC_STEP_RECOVER && uhc_step != UHC_STEP_ERROR && uhc_attached == 0))) {
+        UHC_Detach();
+        return;
+    }
+
+    //帧头被推迟的令牌, 帧尾推迟的由下一个SOF中断发出
+    if(uhc_deferred == 2 && USBH->FRAMERM < UHC_FRAME_HEAD) NVIC_SetPendingIRQ(USB_IRQn);
+
+    switch(uhc_step) {
+        case UHC_STEP_IDLE:
+            if(sr & USBH_PORTSR_CONN_Msk) {
+                uhc_tries = 0;
+                uhc_t0 = DWT->CYCCNT;
+                uhc_state = UHC_DEV_ENUM;
+                uhc_step = UHC_STEP_DEBOUNCE;
+            }
+            break;
+
+        case UHC_STEP_DEBOUNCE:
+            if(UHC_Ms(uhc_t0) >= 100) {
+                USBH->PORTSR = USBH_PORTSR_RESET_Msk;
+                uhc_t0 = DWT->CYCCNT;
+                uhc_step = UHC_STEP_RESET;
+            }
+            break;
+
+        case UHC_STEP_RESET:
+            if((sr & USBH_PORTSR_RESET_Msk) || (sr & USBH_PORTSR_ENA_Msk) == 0) {
+                if(UHC_Ms(uhc_t0) > 100) UHC_EnumFail();
+
+                break;
+            }
+
+            uhc_t0 = DWT->CYCCNT;
+            uhc_step = UHC_STEP_RECOVER;
+            break;
+
+        case UHC_STEP_RECOVER:
+            //复位结束后等20ms
+            if(UHC_Ms(uhc_t0) < 20) break;
+
+            uhc_speed = (sr & USBH_PORTSR_SPEED_Msk) ? UHC_SPEED_LS : UHC_SPEED_FS;
+
+            uhc_ep0.Addr = 0;
+            uhc_ep0.Ep = 0;
+            uhc_ep0.Type = UHC_EP_CTRL;
+            uhc_ep0.Interval = 0;
+            uhc_ep0.Mps = 8;
+            uhc_ep0.Toggle = 0;
+            uhc_ep0.Linked = 0;
+            uhc_ep0.Head = 0;
+            uhc_ep0.Tail = 0;
+            uhc_ep0.Next = 0;
+
+            USBH->CR = USBH_CR_FLUSHFF_Msk;
+            USBH->IE |= USBH_IE_SOF_Msk;
+            uhc_attached = 1;
+            uhc_step = UHC_STEP_DEV8;
+            break;
+
+        case UHC_STEP_DEV8:
+            if(UHC_EnumXfer(0x80, USB_GET_DESCRIPTOR, USB_DESC_DEVICE << 8, 0, dev, 8) == 0) break;
+
+            if(dev[7] != 8 && dev[7] != 16 && dev[7] != 32 && dev[7] != 64) {
+                UHC_EnumFail();
+                break;
+            }
+
+            uhc_ep0.Mps = dev[7];
+            uhc_step = UHC_STEP_ADDR;
+            break;
+
+        case UHC_STEP_ADDR:
+            if(UHC_EnumXfer(0x00, USB_SET_ADDRESS, UHC_DEV_ADDR, 0, 0, 0) == 0) break;
+
+            uhc_t0 = DWT->CYCCNT;
+            uhc_step = UHC_STEP_ADDR_WAIT;
+            break;
+
+        case UHC_STEP_ADDR_WAIT:
+            if(UHC_Ms(uhc_t0) < 2) break;
+
+            uhc_ep0.Addr = UHC_DEV_ADDR;
+            uhc_step = UHC_STEP_DEV18;
+            break;
+
+        case UHC_STEP_DEV18:
+            if(UHC_EnumXfer(0x80, USB_GET_DESCRIPTOR, USB_DESC_DEVICE << 8, 0, dev, 18) == 0) break;
+
+            uhc_step = UHC_STEP_CFG9;
+            break;
+
+        case UHC_STEP_CFG9:
+            if(UHC_EnumXfer(0x80, USB_GET_DESCRIPTOR, USB_DESC_CONFIG << 8, 0, cfg, 9) == 0) break;
+
+            uhc_cfg_len = cfg[2] | (cfg[3] << 8);
+
+            if(uhc_cfg_len > UHC_CFG_MAX) uhc_cfg_len = UHC_CFG_MAX;
+
+            uhc_step = UHC_STEP_CFG;
+            break;
+
+        case UHC_STEP_CFG:
+            if(UHC_EnumXfer(0x80, USB_GET_DESCRIPTOR, USB_DESC_CONFIG << 8, 0, cfg, uhc_cfg_len) == 0) break;
+
+            UHC_Bind();
+            uhc_step = UHC_STEP_SETCFG;
+            break;
+
+        case UHC_STEP_SETCFG:
+            if(UHC_EnumXfer(0x00, USB_SET_CONFIGURATION, cfg[5], 0, 0, 0) == 0) break;
+
+            for(i = 0; i < uhc_class_num; i++) {
+                if(uhc_bound[i] && uhc_class[i]->Start) uhc_class[i]->Start();
+            }
+
+            uhc_state = UHC_DEV_READY;
+            uhc_step = UHC_STEP_READY;
+            break;
+
+        case UHC_STEP_READY:
+            for(i = 0; i < uhc_class_num; i++) {
+                if(uhc_bound[i] && uhc_class[i]->Task) uhc_class[i]->Task();
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+uint32_t UHC_State(void) {
+    return uhc_state;
+}
+
+const uint8_t * UHC_DevDesc(void) {
+    return (const uint8_t *)uhc_dev_desc;
+}
+
+const uint8_t * UHC_FindEp(const uint8_t * intf, uint32_t len, uint8_t type, uint8_t dir) {
+    uint32_t off;
+
+    for(off = intf[0]; off + 2 <= len && intf[off] >= 2; off += intf[off]) {
+        if(intf[off + 1] == USB_DESC_ENDPOINT && intf[off] >= 7 && off + 7 <= len &&
+           (intf[off + 3] & 0x03) == type && (intf[off + 2] & 0x80) == dir) return intf + off;
+    }
+
+    return 0;
+}
+
+void UHC_PipeInit(UHC_Pipe * pipe, const uint8_t * ep_desc) {
+    pipe->Addr = UHC_DEV_ADDR;
+    pipe->Ep = ep_desc[2];
+    pipe->Type = ep_desc[3] & 0x03;
+    pipe->Mps = (ep_desc[4] | (ep_desc[5] << 8)) & 0x7FF;
+    pipe->Interval = ep_desc[6] ? ep_desc[6] : 1;
+    pipe->Toggle = 0;
+    pipe->Linked = 0;
+    pipe->NextFrame = 0;
+    pipe->Head = 0;
+    pipe->Tail = 0;
+    pipe->Next = 0;
+}
+
+uint32_t UHC_Submit(UHC_Urb * urb) {
+    UHC_Pipe * p = urb->Pipe;
+    uint32_t en, frame;
+
+    if(p == 0 || p->Mps == 0 || (urb->Len && urb->Buf == 0) || urb->State == UHC_URB_QUEUED || uhc_attached == 0) return 0;
+
+    urb->Stage = (p->Type == UHC_EP_CTRL) ? UHC_STAGE_SETUP : UHC_STAGE_DATA;
+    urb->Result = UHC_RES_OK;
+    urb->Errors = 0;
+    urb->Cancel = 0;
+    urb->Actual = 0;
+    urb->Next = 0;
+    urb->State = UHC_URB_QUEUED;
+
+    en = UHC_Lock();
+
+    if(p->Tail) p->Tail->Next = urb;
+    else p->Head = urb;
+
+    p->Tail = urb;
+
+    if(p->Linked == 0) {
+        //停过的中断端点不补错过的轮询, 从当前帧开始
+        if(p->Type == UHC_EP_INT) {
+            frame = USBH->FRAMENR & UHC_FRAME_MASK;
+
+            if(((p->NextFrame - frame) & UHC_FRAME_MASK) > p->Interval) p->NextFrame = frame;
+        }
+
+        UHC_Link(p);
+    }
+
+    UHC_Unlock(en);
+
+    if(uhc_irq_active == 0) NVIC_SetPendingIRQ(USB_IRQn);
+
+    return 1;
+}
+
+uint32_t UHC_Control(UHC_Urb * urb, uint8_t type, uint8_t request, uint16_t value, uint16_t index, uint8_t * buf, uint16_t len) {
+    urb->Pipe = &uhc_ep0;
+    urb->Setup[0] = type;
+    urb->Setup[1] = request;
+    urb->Setup[2] = value & 0xFF;
+    urb->Setup[3] = value >> 8;
+    urb->Setup[4] = index & 0xFF;
+    urb->Setup[5] = index >> 8;
+    urb->Setup[6] = len & 0xFF;
+    urb->Setup[7] = len >> 8;
+    urb->Buf = buf;
+    urb->Len = len;
+
+    return UHC_Submit(urb);
+}
+
+void UHC_Cancel(UHC_Urb * urb) {
+    UHC_Pipe * p = urb->Pipe;
+    UHC_Urb ** pp;
+    uint32_t en = UHC_Lock();
+
+    if(urb->State == UHC_URB_QUEUED) {
+        urb->Cancel = 1;
+
+        //令牌在途的由 UHC_Response 结束
+        if(urb != uhc_cur) {
+            for(pp = &p->Head; *pp && *pp != urb; pp = &(*pp)->Next);
+
+            if(*pp) *pp = urb->Next;
+
+            for(p->Tail = p->Head; p->Tail && p->Tail->Next; p->Tail = p->Tail->Next);
+
+            if(p->Head == 0 && p->Linked) UHC_Unlink(p);
+
+            urb->Next = 0;
+            urb->Result = UHC_RES_CANCEL;
+            urb->State = UHC_URB_DONE;
+        }
+    }
+
+    UHC_Unlock(en);
+}
+
+void UHC_Wake(void) {
+    NVIC_SetPendingIRQ(USB_IRQn);
+}
+
+uint32_t UHC_Frame(void) {
+    return USBH->FRAMENR & UHC_FRAME_MASK;
+}
+
+void UHC_GetStats(UHC_Stats * stats) {
+    *stats = uhc_stats;
+}
+
+void UHC_IRQHandler(void) {
+    uint32_t t0 = DWT->CYCCNT;
+    uint32_t flags = USBH->IF;
+    uint32_t sr, n, t;
+
+    USBH->IF = flags;
+    uhc_irq_active = 1;
+
+    //拔出: 结束所有URB, 由 UHC_Task 通知类驱动
+    if(flags & USBH_IF_PORT_Msk) {
+        sr = USBH->PORTSR;
+        USBH->PORTSR = sr & UHC_PORTSR_CHG;
+
+        if((sr & USBH_PORTSR_CONN_Msk) == 0 && uhc_attached) {
+            uhc_attached = 0;
+            UHC_Flush(UHC_RES_NODEV);
+        }
+    }
+
+    if(flags & USBH_IF_RXSTAT_Msk) UHC_Response();
+
+    if(flags & USBH_IF_SOF_Msk) uhc_deferred = 0;
+
+    if(uhc_state == UHC_DEV_READY) {
+        for(n = 0; n < uhc_class_num; n++) {
+            if(uhc_bound[n] && uhc_class[n]->Service) uhc_class[n]->Service();
+        }
+    }
+
+    UHC_Kick();
+
+    uhc_irq_active = 0;
+
+    t = DWT->CYCCNT - t0;
+    uhc_stats.IrqCount++;
+    uhc_stats.IrqCycles += t;
+
+    if(t > uhc_stats.IrqMaxCycles) uhc_stats.IrqMaxCycles = t;
+}
@@ -0,0 +1,147 @@
+/**
+  ************************ Copyright ***************
+  *           (C) Copyright 2026,txt1994,China, GCU.
+  *                  All Rights Reserved
+  *
+  *				https://github.com/txt1994
+  *				email:linguangyuan88@gmail.com
+  *
+  * FileName     : usbh_core.h
+  * Version      : v1.0
+  * Author       : txt1994
+  * Date         : 2026-10-19
+  * Description  : SWM341 USB主机核心: 端点管道 + URB队列, 中断端点按 bInterval 在帧开头轮询,
+  *				   控制/批量端点轮转占满帧内剩余时间; 主循环中完成连接、复位、枚举和类驱动绑定
+  * Function List:
+  *		UHC_Init
+  *		UHC_RegisterClass
+  *		UHC_Task
+  *		UHC_State
+  *		UHC_DevDesc
+  *		UHC_FindEp
+  *		UHC_PipeInit
+  *		UHC_Submit
+  *		UHC_Control
+  *		UHC_Cancel
+  *		UHC_Wake
+  *		UHC_Frame
+  *		UHC_GetStats
+  *		UHC_IRQHandler
+  ******************************************************
+**/
+
+#ifndef __USBH_CORE_H_
+#define __USBH_CORE_H_
+
+#include "SWM341.h"
+
+#define UHC_IRQHandler		USB_Handler		//和 usbd_bulk 不能同时链接
+
+#define UHC_DEV_ADDR		1		//唯一设备的地址, 不支持集线器
+#define UHC_CFG_MAX			256		//保存的配置描述符最大长度
+#define UHC_CLASS_MAX		2
+#define UHC_RETRY			3		//CRC/超时等错误重试次数, 超过后URB以 UHC_RES_ERROR 结束
+
+//FRAMERM 为本帧剩余的全速位时间(每帧11999), 令牌和数据包须在 UHC_FRAME_TAIL 之前结束.
+//库函数只在 10000 > FRAMERM > 2000 时发令牌; SOF中断时SOF已经发出, 这里帧头不设限,
+//若改为10000, 帧头被推迟的令牌由 UHC_Task 补发
+#define UHC_FRAME_HEAD		12000
+#define UHC_FRAME_TAIL		300
+#define UHC_FRAME_MASK		0x7FF
+
+//端点类型, 同端点描述符 bmAttributes
+#define UHC_EP_CTRL			0
+#define UHC_EP_BULK			2
+#define UHC_EP_INT			3
+
+//URB状态
+#define UHC_URB_IDLE		0
+#define UHC_URB_QUEUED		1
+#define UHC_URB_DONE		2
+
+//URB结果
+#define UHC_RES_OK			0
+#define UHC_RES_STALL		1
+#define UHC_RES_ERROR		2
+#define UHC_RES_NODEV		3		//设备已拔出
+#define UHC_RES_CANCEL		4
+
+//设备状态
+#define UHC_DEV_DETACHED	0
+#define UHC_DEV_ENUM		1		//复位和枚举中
+#define UHC_DEV_READY		2		//已配置, 类驱动在运行
+#define UHC_DEV_ERROR		3		//枚举失败, 等待拔出
+
+typedef struct UHC_Urb UHC_Urb;
+typedef struct UHC_Pipe UHC_Pipe;
+
+struct UHC_Pipe {
+    uint8_t  Addr;			//设备地址
+    uint8_t  Ep;			//端点地址, bit7为1表示IN
+    uint8_t  Type;			//UHC_EP_CTRL/BULK/INT
+    uint8_t  Interval;		//中断端点轮询间隔(帧)
+    uint16_t Mps;
+
+    //驱动维护
+    uint8_t  Toggle;		//下一个数据包用 DATA0/DATA1, 清除端点STALL后须置0
+    uint8_t  Linked;		//在调度链表中
+    uint16_t NextFrame;		//中断端点下次轮询的帧号
+    UHC_Urb * Head;			//本管道排队的URB, 按提交顺序执行
+    UHC_Urb * Tail;
+    UHC_Pipe * Next;
+};
+
+struct UHC_Urb {
+    UHC_Pipe * Pipe;
+    uint8_t  * Buf;
+    uint32_t Len;
+    uint8_t  Setup[8];		//控制传输的SETUP包, 由 UHC_Control 填写
+    void (*Done)(UHC_Urb * urb);	//在USB中断中调用, 可以再次提交
+    void * Arg;
+
+    //驱动维护
+    volatile uint8_t State;
+    uint8_t  Result;
+    uint8_t  Stage;
+    uint8_t  Errors;
+    volatile uint8_t Cancel;
+    uint32_t Actual;		//实际传输的字节数
+    UHC_Urb * Next;
+};
+
+//类驱动, Probe/Start/Task/Stop 在 UHC_Task 中调用, Service 在USB中断末尾调用
+typedef struct {
+    uint32_t (*Probe)(const uint8_t * intf, uint32_t len);	//intf 指向接口描述符, 到下一个接口之前共 len 字节; 接管返回1
+    void (*Start)(void);	//SET_CONFIGURATION 完成后
+    void (*Task)(void);
+    void (*Stop)(void);		//设备拔出, 此前所有URB已以 UHC_RES_NODEV 结束
+    void (*Service)(void);
+} UHC_Class;
+
+typedef struct {
+    uint32_t Tokens;		//发出的令牌数
+    uint32_t Naks;
+    uint32_t Errors;		//CRC/超时/PID等错误
+    uint32_t Bytes;			//数据阶段收发的字节数
+    uint32_t Polls;			//中断端点轮询次数
+    uint32_t Deferred;		//本帧剩余时间不够, 推迟到下一帧的次数
+    uint32_t IrqCount;
+    uint32_t IrqCycles;
+    uint32_t IrqMaxCycles;
+} UHC_Stats;
+
+void UHC_Init(uint32_t priority);	// 初始化主机并打开端口电源, 48MHz USB时钟须已配置
+void UHC_RegisterClass(const UHC_Class * cls);	// 注册类驱动, 在 UHC_Init 之后、设备插入之前调用
+void UHC_Task(void);				// 主循环中调用, 不阻塞
+uint32_t UHC_State(void);			// 设备状态 UHC_DEV_xxx
+const uint8_t * UHC_DevDesc(void);	// 设备描述符, 枚举完成前内容无效
+const uint8_t * UHC_FindEp(const uint8_t * intf, uint32_t len, uint8_t type, uint8_t dir);	// 在接口的描述符中找指定类型和方向(USB_EP_IN/OUT)的端点描述符, 没有返回0
+void UHC_PipeInit(UHC_Pipe * pipe, const uint8_t * ep_desc);	// 按端点描述符初始化管道
+uint32_t UHC_Submit(UHC_Urb * urb);	// 提交URB, 完成时调用 urb->Done; 参数错误或未连接返回0
+uint32_t UHC_Control(UHC_Urb * urb, uint8_t type, uint8_t request, uint16_t value, uint16_t index, uint8_t * buf, uint16_t len);	// 在端点0上提交控制传输
+void UHC_Cancel(UHC_Urb * urb);		// 取消URB, 不调用 Done; 令牌在途时等应答后结束
+void UHC_Wake(void);				// 挂起USB中断, 让类驱动的 Service 运行
+uint32_t UHC_Frame(void);			// 当前帧号
+void UHC_GetStats(UHC_Stats * stats);	// 读取统计信息
+
+#endif
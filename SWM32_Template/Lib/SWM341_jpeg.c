@@ -59,15 +59,15 @@ void JPEG_Init(JPEG_TypeDef * JPEGx, JPEG_InitStructure * initStruct) {
 
 
 /******************************************************************************************************************************************
-* 函数名称:	JPEG_Decode()
-* 功能说明: JPEG解码器解码
+* 函数名称:	JPEG_Config()
+* 功能说明: 按图像信息和输出设定配置解码器，装载量化表和霍夫曼表，不启动解码
 * 输    入: JPEG_TypeDef * JPEGx	指定要被设置的JPEG解码器，有效值包括JPEG
 *			jfif_info_t * jfif_info		要解码图像的信息
 *			jpeg_outset_t * jpeg_outset	解码输出设定
-* 输    出: 无
+* 输    出: uint32_t				1 配置完成    0 不支持的采样格式
 * 注意事项: 无
 ******************************************************************************************************************************************/
-void JPEG_Decode(JPEG_TypeDef * JPEGx, jfif_info_t * jfif_info, jpeg_outset_t * jpeg_outset) {
+static uint32_t JPEG_Config(JPEG_TypeDef * JPEGx, jfif_info_t * jfif_info, jpeg_outset_t * jpeg_outset) {
     int32_t i, j;
     uint8_t hxvx;
     uint8_t out_rgb = ((jpeg_outset->format & 7) > 1 ? 1 : 0);	// output rgb ?
@@ -86,7 +86,7 @@ void JPEG_Decode(JPEG_TypeDef * JPEGx, jfif_info_t * jfif_info, jpeg_outset_t *
             break;
 
         default:
-            return;
+            return 0;
     }
 
     JPEGx->CFG = (hxvx << JPEG_CFG_SRCFMT_Pos)  |
@@ -247,11 +247,67 @@ void JPEG_Decode(JPEG_TypeDef * JPEGx, jfif_info_t * jfif_info, jpeg_outset_t *
         }
     }
 
+    return 1;
+}
+
+
+/******************************************************************************************************************************************
+* 函数名称:	JPEG_Decode()
+* 功能说明: JPEG解码器解码
+* 输    入: JPEG_TypeDef * JPEGx	指定要被设置的JPEG解码器，有效值包括JPEG
+*			jfif_info_t * jfif_info		要解码图像的信息
+*			jpeg_outset_t * jpeg_outset	解码输出设定
+* 输    出: 无
+* 注意事项: 无
+******************************************************************************************************************************************/
+void JPEG_Decode(JPEG_TypeDef * JPEGx, jfif_info_t * jfif_info, jpeg_outset_t * jpeg_outset) {
+    if(JPEG_Config(JPEGx, jfif_info, jpeg_outset) == 0) return;
+
     JPEGx->CR = (1 << JPEG_CR_LASTBUF_Pos) |
                 (1 << JPEG_CR_START_Pos);
 }
 
 
+/******************************************************************************************************************************************
+* 函数名称:	JPEG_DecodeStream()
+* 功能说明: JPEG解码器分段解码，码流分多个缓冲区依次送入
+* 输    入: JPEG_TypeDef * JPEGx	指定要被设置的JPEG解码器，有效值包括JPEG
+*			jfif_info_t * jfif_info		要解码图像的信息，CodeAddr、CodeLen 为第一个缓冲区
+*			jpeg_outset_t * jpeg_outset	解码输出设定
+*			uint32_t lastbuf			1 第一个缓冲区就是最后一个缓冲区
+* 输    出: 无
+* 注意事项: 缓冲区用完后产生 JPEG_IT_EMPTY 中断，在中断中调用 JPEG_StreamFeed() 送入下一个缓冲区
+******************************************************************************************************************************************/
+void JPEG_DecodeStream(JPEG_TypeDef * JPEGx, jfif_info_t * jfif_info, jpeg_outset_t * jpeg_outset, uint32_t lastbuf) {
+    if(JPEG_Config(JPEGx, jfif_info, jpeg_outset) == 0) return;
+
+    JPEGx->CR = ((lastbuf ? 1 : 0)           << JPEG_CR_LASTBUF_Pos) |
+                ((jfif_info->RstIntv ? 1 : 0) << JPEG_CR_REINTRV_Pos) |
+                ((jfif_info->RstIntv ? jfif_info->RstIntv - 1 : 0) << JPEG_CR_CUCNT_Pos) |
+                (1 << JPEG_CR_START_Pos);
+}
+
+
+/******************************************************************************************************************************************
+* 函数名称:	JPEG_StreamFeed()
+* 功能说明: 分段解码时送入下一个码流缓冲区
+* 输    入: JPEG_TypeDef * JPEGx	指定要被设置的JPEG解码器，有效值包括JPEG
+*			uint32_t addr				码流缓冲区地址
+*			uint32_t len				码流缓冲区字节数
+*			uint32_t lastbuf			1 这是最后一个缓冲区
+* 输    出: 无
+* 注意事项: 无
+******************************************************************************************************************************************/
+void JPEG_StreamFeed(JPEG_TypeDef * JPEGx, uint32_t addr, uint32_t len, uint32_t lastbuf) {
+    JPEGx->CSBASE = addr;
+    JPEGx->CODLEN = len - 1;
+
+    JPEGx->CR = (JPEGx->CR & ~(JPEG_CR_LASTBUF_Msk | JPEG_CR_START_Msk)) |
+                ((lastbuf ? 1 : 0) << JPEG_CR_LASTBUF_Pos) |
+                (1 << JPEG_CR_RESTART_Pos);
+}
+
+
 /******************************************************************************************************************************************
 * 函数名称:	JPEG_DecodeBusy()
 * 功能说明: JPEG解码器忙查询
@@ -262,3 +318,52 @@ void JPEG_Decode(JPEG_TypeDef * JPEGx, jfif_info_t * jfif_info, jpeg_outset_t *
 uint32_t JPEG_DecodeBusy(JPEG_TypeDef * JPEGx) {
     return (JPEGx->SR & JPEG_SR_BUSY_Msk) ? 1 : 0;
 }
+
+
+/******************************************************************************************************************************************
+* 函数名称: JPEG_INTEn()
+* 功能说明:	中断使能
+* 输    入: JPEG_TypeDef * JPEGx	指定要被设置的JPEG解码器，有效值包括JPEG
+*			uint32_t it				interrupt type，有效值JPEG_IT_DONE、JPEG_IT_EMPTY、JPEG_IT_ERROR 及其"或"
+* 输    出: 无
+* 注意事项: 无
+******************************************************************************************************************************************/
+void JPEG_INTEn(JPEG_TypeDef * JPEGx, uint32_t it) {
+    JPEGx->IR = (JPEGx->IR & (JPEG_IT_DONE | JPEG_IT_EMPTY | JPEG_IT_ERROR)) | it;
+}
+
+/******************************************************************************************************************************************
+* 函数名称: JPEG_INTDis()
+* 功能说明:	中断禁止
+* 输    入: JPEG_TypeDef * JPEGx	指定要被设置的JPEG解码器，有效值包括JPEG
+*			uint32_t it				interrupt type，有效值JPEG_IT_DONE、JPEG_IT_EMPTY、JPEG_IT_ERROR 及其"或"
+* 输    出: 无
+* 注意事项: 无
+******************************************************************************************************************************************/
+void JPEG_INTDis(JPEG_TypeDef * JPEGx, uint32_t it) {
+    JPEGx->IR = (JPEGx->IR & (JPEG_IT_DONE | JPEG_IT_EMPTY | JPEG_IT_ERROR)) & ~it;
+}
+
+/******************************************************************************************************************************************
+* 函数名称: JPEG_INTClr()
+* 功能说明:	中断标志清除
+* 输    入: JPEG_TypeDef * JPEGx	指定要被设置的JPEG解码器，有效值包括JPEG
+*			uint32_t it				interrupt type，有效值JPEG_IT_DONE、JPEG_IT_EMPTY、JPEG_IT_ERROR 及其"或"
+* 输    出: 无
+* 注意事项: 无
+******************************************************************************************************************************************/
+void JPEG_INTClr(JPEG_TypeDef * JPEGx, uint32_t it) {
+    JPEGx->IR = (JPEGx->IR & (JPEG_IT_DONE | JPEG_IT_EMPTY | JPEG_IT_ERROR)) | (it << JPEG_IR_ICDONE_Pos);
+}
+
+/******************************************************************************************************************************************
+* 函数名称: JPEG_INTStat()
+* 功能说明:	中断状态查询
+* 输    入: JPEG_TypeDef * JPEGx	指定要被设置的JPEG解码器，有效值包括JPEG
+*			uint32_t it				interrupt type，有效值JPEG_IT_DONE、JPEG_IT_EMPTY、JPEG_IT_ERROR 及其"或"
+* 输    出: uint32_t				0 中断未发生    非0 中断已发生
+* 注意事项: 无
+******************************************************************************************************************************************/
+uint32_t JPEG_INTStat(JPEG_TypeDef * JPEGx, uint32_t it) {
+    return (JPEGx->IR >> JPEG_IR_IFDONE_Pos) & it;
+}
@@ -81,13 +81,28 @@ typedef struct {
 
     uint32_t CodeAddr;			// 待解码数据
     uint32_t CodeLen;
+
+    uint16_t RstIntv;			// 重启间隔（MCU个数），0 表示没有重启标记，只有 JPEG_DecodeStream() 使用
 } jfif_info_t;
 
 
+/* Interrupt Type */
+#define JPEG_IT_DONE		(1 << 0)	// 解码完成
+#define JPEG_IT_EMPTY		(1 << 2)	// 码流缓冲区已用完，等待下一个缓冲区
+#define JPEG_IT_ERROR		(1 << 3)	// 解码出错
+
+
 
 void JPEG_Init(JPEG_TypeDef * JPEGx, JPEG_InitStructure * initStruct);
 void JPEG_Decode(JPEG_TypeDef * JPEGx, jfif_info_t * jfif_info, jpeg_outset_t * jpeg_outset);
 uint32_t JPEG_DecodeBusy(JPEG_TypeDef * JPEGx);
+void JPEG_DecodeStream(JPEG_TypeDef * JPEGx, jfif_info_t * jfif_info, jpeg_outset_t * jpeg_outset, uint32_t lastbuf);
+void JPEG_StreamFeed(JPEG_TypeDef * JPEGx, uint32_t addr, uint32_t len, uint32_t lastbuf);
+
+void JPEG_INTEn(JPEG_TypeDef * JPEGx, uint32_t it);
+void JPEG_INTDis(JPEG_TypeDef * JPEGx, uint32_t it);
+void JPEG_INTClr(JPEG_TypeDef * JPEGx, uint32_t it);
+uint32_t JPEG_INTStat(JPEG_TypeDef * JPEGx, uint32_t it);
 
 
 #endif //__SWM341_JPEG_H__